@@ -7,6 +7,9 @@
 #include "../RHI/RHICore.h"
 #include "../Graphics/Graphics.h"
 #include "Time/Time.h"
+#include "Time/FrameStatistics.h"
+#include "Memory/FrameArena.h"
+#include "Memory/MemoryTracker.h"
 #include "Math/MathFunctions.h"
 
 using namespace Crystal;
@@ -41,13 +44,27 @@ namespace Crystal {
 		return *m_window;
 	}
 
-    [[noreturn]] int Application::Run() const {
+    int Application::Run() const {
 		while (true) {
             if(const auto code = Window::MessagePump()) {
                 return *code;
             }
-			HandleInput();
-			m_gfx->Render();
+			{
+				FrameStatistics::ScopedStage stage("Input");
+				HandleInput();
+			}
+			{
+				FrameStatistics::ScopedStage stage("Render");
+				m_gfx->Render();
+			}
+			FrameStatistics::Get().EndFrame();
+
+			//Everything allocated from the frame arenas is released here
+			FrameArena::NextFrame();
+
+			if constexpr (MemoryTracker::IsEnabled()) {
+				MemoryTracker::Get().OnFrameEnd();
+			}
 		}
 	}
 
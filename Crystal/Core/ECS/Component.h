@@ -4,6 +4,7 @@ namespace Crystal {
 	class Entity;
 	class AComponent {
 	public:
+		virtual ~AComponent() = default;
 		virtual void Update() noexcept = 0;
 
 		void Enable()  noexcept { m_enabled = true; }
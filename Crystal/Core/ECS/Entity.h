@@ -1,5 +1,6 @@
 #pragma once
 #include "../Logging/Logger.h"
+#include "../Memory/SlabAllocator.h"
 #include <memory>
 #include <algorithm>
 #include <execution>
@@ -15,7 +16,7 @@ namespace Crystal {
 				return;
 			}
 
-			auto component = std::make_unique<T>(std::forward<decltype(args)>(args)...);
+			auto component = MakePooled<T>(std::forward<decltype(args)>(args)...);
 
 			component->SetEntity(this);
 			component->Enable();
@@ -61,7 +62,7 @@ namespace Crystal {
 		[[nodiscard]] const std::string& GetName() const noexcept { return m_name; }
 		void SetName(std::string_view name)        noexcept { m_name = name; }
 	private:
-		std::vector<std::unique_ptr<AComponent>> m_components;
+		std::vector<PoolPtr<AComponent>> m_components;
 		std::string m_name{};
 	};
 }
\ No newline at end of file
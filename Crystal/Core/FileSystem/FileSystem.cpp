@@ -18,7 +18,7 @@ using namespace Crystal;
 namespace fs = std::filesystem;
 namespace ranges = std::ranges;
 
-constexpr bool FileSystem::IsEmpty(std::string_view str) noexcept {
+bool FileSystem::IsEmpty(std::string_view str) noexcept {
 	//First make sure the string is valid
 	if (IsEmptyOrWhiteSpace(str)) {
 		return false;
@@ -123,7 +123,7 @@ bool FileSystem::IsDirectory(std::string_view path) noexcept {
 	return false;
 }
 
-constexpr bool FileSystem::IsFile(std::string_view path) noexcept {
+bool FileSystem::IsFile(std::string_view path) noexcept {
 	if (path.empty()) {
 		return false;
 	}
@@ -138,7 +138,7 @@ constexpr bool FileSystem::IsFile(std::string_view path) noexcept {
 	return false;
 }
 
-constexpr bool FileSystem::CopyFile(std::string_view src, std::string_view dst) noexcept {
+bool FileSystem::CopyFile(std::string_view src, std::string_view dst) noexcept {
 	if (src == dst) [[unlikely]] {
 		return true;
 	}
@@ -164,7 +164,7 @@ std::string FileSystem::ReplaceExtension(std::string_view path, std::string_view
 	return fs::path(path).replace_extension(ext).string();
 }
 
-constexpr std::string FileSystem::GetDirectoryFromFilePath(std::string_view path) noexcept {
+std::string FileSystem::GetDirectoryFromFilePath(std::string_view path) noexcept {
 	const size_t lastIndex = path.find_last_of("\\/");
 
 	if (lastIndex != std::string::npos) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -7,7 +8,7 @@ namespace Crystal::FileSystem {
     using FileList = std::vector<std::string>;
     using DirectoryList = std::vector<std::string>;
 
-    [[nodiscard]] constexpr bool IsEmpty(std::string_view str) noexcept;
+    [[nodiscard]] bool IsEmpty(std::string_view str) noexcept;
     [[nodiscard]] std::string RemoveIllegalCharacters(std::string_view str) noexcept;
     [[nodiscard]] std::string ReplaceIllegalCharacters(std::string_view str, char c = '_') noexcept;
 
@@ -15,12 +16,12 @@ namespace Crystal::FileSystem {
     [[nodiscard]] bool Delete(std::string_view path) noexcept;
     [[nodiscard]] bool Exists(std::string_view path) noexcept;
     [[nodiscard]] bool IsDirectory(std::string_view path) noexcept;
-    [[nodiscard]] constexpr bool IsFile(std::string_view path) noexcept;
-    [[nodiscard]] constexpr bool CopyFile(std::string_view src, std::string_view dst) noexcept;
+    [[nodiscard]] bool IsFile(std::string_view path) noexcept;
+    [[nodiscard]] bool CopyFile(std::string_view src, std::string_view dst) noexcept;
     [[nodiscard]] bool HasParentPath(std::string_view path) noexcept;
 
     [[nodiscard]] std::string ReplaceExtension(std::string_view path, std::string_view ext) noexcept;
-    [[nodiscard]] constexpr std::string GetDirectoryFromFilePath(std::string_view path) noexcept;
+    [[nodiscard]] std::string GetDirectoryFromFilePath(std::string_view path) noexcept;
     [[nodiscard]] std::string GetFileNameFromFilePath(std::string_view path) noexcept;
     [[nodiscard]] std::string GetExtensionFromFilePath(std::string_view path) noexcept;
     [[nodiscard]] std::string GetWorkingDirectory() noexcept;
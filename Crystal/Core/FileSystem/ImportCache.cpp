@@ -0,0 +1,430 @@
+#include "ImportCache.h"
+#include "MappedFile.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Logging/Logger.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <thread>
+#include <type_traits>
+
+using namespace Crystal;
+
+namespace fs = std::filesystem;
+
+namespace impl {
+    constexpr uint32_t INDEX_MAGIC   = 0x58444943; //"CIDX"
+    constexpr uint32_t INDEX_VERSION = 2;
+
+    template<class T>
+    void WriteValue(std::ofstream& stream, const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void WriteString(std::ofstream& stream, std::string_view string) {
+        WriteValue(stream, static_cast<uint32_t>(string.size()));
+        stream.write(string.data(), static_cast<std::streamsize>(string.size()));
+    }
+
+    void WriteStamp(std::ofstream& stream, const FileStamp& stamp) {
+        WriteValue(stream, stamp.SizeInBytes);
+        WriteValue(stream, stamp.ModifiedTime);
+        WriteValue(stream, stamp.ContentHash);
+        WriteValue(stream, static_cast<uint8_t>(stamp.Exists));
+    }
+
+    template<class T>
+    [[nodiscard]] bool ReadValue(std::ifstream& stream, T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return static_cast<bool>(stream.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+
+    [[nodiscard]] bool ReadString(std::ifstream& stream, std::string& string) {
+        uint32_t length = 0;
+
+        if (!ReadValue(stream, length)) {
+            return false;
+        }
+
+        string.resize(length);
+        return static_cast<bool>(stream.read(string.data(), length));
+    }
+
+    [[nodiscard]] bool ReadStamp(std::ifstream& stream, FileStamp& stamp) {
+        uint8_t exists = 0;
+
+        const bool isRead =
+            ReadValue(stream, stamp.SizeInBytes) &&
+            ReadValue(stream, stamp.ModifiedTime) &&
+            ReadValue(stream, stamp.ContentHash) &&
+            ReadValue(stream, exists);
+
+        stamp.Exists = exists != 0;
+        return isRead;
+    }
+
+    [[nodiscard]] bool IsSameContent(const FileStamp& lhs, const FileStamp& rhs) noexcept {
+        return lhs.Exists == rhs.Exists && lhs.ContentHash == rhs.ContentHash;
+    }
+
+    //Importers resolve the files a source references next to it, e.g. the .mtl of an .obj or the buffers of a .gltf.
+    //Identical sources in two directories can import differently, so the directory is part of the key.
+    [[nodiscard]] uint64_t HashSourceDirectory(std::string_view sourcePath) {
+        std::error_code error;
+
+        auto path = fs::absolute(fs::path(sourcePath), error);
+
+        if (error) {
+            path = fs::path(sourcePath);
+        }
+
+        const auto directory = path.lexically_normal().parent_path().generic_string();
+        return HashBytes(std::as_bytes(std::span(directory)));
+    }
+}
+
+ImportCache::ImportCache(std::string_view directory, uint64_t maxSizeInBytes)
+    :
+    m_directory(directory),
+    m_maxSizeInBytes(maxSizeInBytes)
+{
+    std::error_code error;
+    fs::create_directories(m_directory, error);
+
+    if (!LoadIndex()) {
+        m_entries.clear();
+        m_stamps.clear();
+        m_sizeInBytes = 0;
+    }
+}
+
+ImportCache::~ImportCache() {
+    std::scoped_lock lock(m_mutex);
+
+    if (m_isDirty) {
+        SaveIndexLocked();
+    }
+}
+
+std::optional<uint64_t> ImportCache::ComputeKey(std::string_view sourcePath, uint64_t settingsHash) {
+    const auto stamp = GetFileStamp(std::string(sourcePath));
+
+    if (!stamp.Exists) {
+        return {};
+    }
+    const auto key = HashCombine(HashCombine(stamp.ContentHash, impl::HashSourceDirectory(sourcePath)), settingsHash);
+    return HashCombine(key, impl::INDEX_VERSION);
+}
+
+std::optional<std::string> ImportCache::Find(uint64_t key) {
+    std::vector<Dependency> dependencies;
+    uint64_t lastUsed = 0;
+    {
+        std::scoped_lock lock(m_mutex);
+
+        const auto it = m_entries.find(key);
+
+        if (it == m_entries.end()) {
+            m_numMisses++;
+            return {};
+        }
+
+        dependencies = it->second.Dependencies;
+        lastUsed     = it->second.LastUsed;
+    }
+
+    auto artifactPath = GetArtifactPath(key);
+
+    //Dependencies are checked without the lock, a changed one is hashed again and other imports must not wait for that
+    std::error_code error;
+    bool isValid = fs::is_regular_file(artifactPath, error);
+
+    for (const auto& [path, stamp] : dependencies) {
+        isValid = isValid && impl::IsSameContent(GetFileStamp(path), stamp);
+    }
+
+    std::scoped_lock lock(m_mutex);
+
+    const auto it = m_entries.find(key);
+
+    //Used or committed again in the meantime, the newer state is not removed based on what was checked here
+    if (it == m_entries.end() || (!isValid && it->second.LastUsed != lastUsed)) {
+        m_numMisses++;
+        return {};
+    }
+
+    if (!isValid) {
+        Remove(key);
+        m_numInvalidated++;
+        m_numMisses++;
+        return {};
+    }
+
+    it->second.LastUsed = ++m_useCounter;
+    m_isDirty           = true;
+    m_numHits++;
+
+    return artifactPath;
+}
+
+//Different for every call, the thread id also keeps callers of other caches on the same directory apart
+std::string ImportCache::GetStagingPath(uint64_t key) const {
+    const auto thread  = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    const auto counter = m_stagingCounter.fetch_add(1, std::memory_order_relaxed);
+
+    return std::format("{}.{:x}.{}.staging", GetArtifactPath(key), thread, counter);
+}
+
+std::optional<std::string> ImportCache::Commit(uint64_t key, std::string_view stagingPath, std::span<const std::string> dependencies) {
+    std::vector<Dependency> entryDependencies;
+    entryDependencies.reserve(dependencies.size());
+
+    for (const auto& path : dependencies) {
+        entryDependencies.push_back({ path, GetFileStamp(path) });
+    }
+
+    std::scoped_lock lock(m_mutex);
+
+    const auto artifactPath = GetArtifactPath(key);
+
+    std::error_code error;
+    const auto sizeInBytes = fs::file_size(stagingPath, error);
+
+    if (error) {
+        Logger::Warning("Import cache: nothing was staged for {}", artifactPath);
+        return {};
+    }
+
+    //A rename within one directory either fully happens or not at all, readers never see half an artifact
+    fs::rename(stagingPath, artifactPath, error);
+
+    if (error) {
+        Logger::Warning("Import cache: could not commit {}: {}", artifactPath, error.message());
+        return {};
+    }
+
+    if (const auto it = m_entries.find(key); it != m_entries.end()) {
+        m_sizeInBytes -= it->second.SizeInBytes;
+    }
+
+    m_entries[key] = Entry{
+        .SizeInBytes  = sizeInBytes,
+        .LastUsed     = ++m_useCounter,
+        .Dependencies = std::move(entryDependencies)
+    };
+    m_sizeInBytes += sizeInBytes;
+
+    //Rewriting the whole index on every commit would write it once per asset of a cold import
+    m_isDirty = true;
+
+    EvictToFit(key);
+
+    return artifactPath;
+}
+
+bool ImportCache::SaveIndex() {
+    std::scoped_lock lock(m_mutex);
+    return SaveIndexLocked();
+}
+
+ImportCacheStatistics ImportCache::GetStatistics() {
+    std::scoped_lock lock(m_mutex);
+
+    return {
+        .NumEntries     = static_cast<uint32_t>(m_entries.size()),
+        .SizeInBytes    = m_sizeInBytes,
+        .MaxSizeInBytes = m_maxSizeInBytes,
+        .NumHits        = m_numHits,
+        .NumMisses      = m_numMisses,
+        .NumInvalidated = m_numInvalidated,
+        .NumEvicted     = m_numEvicted
+    };
+}
+
+FileStamp ImportCache::GetFileStamp(const std::string& path) {
+    std::error_code error;
+
+    const auto sizeInBytes  = fs::file_size(path, error);
+    const auto modifiedTime = error ? fs::file_time_type{} : fs::last_write_time(path, error);
+
+    if (error) {
+        std::scoped_lock lock(m_mutex);
+        m_stamps.erase(path);
+        return {};
+    }
+
+    FileStamp stamp{
+        .SizeInBytes  = sizeInBytes,
+        .ModifiedTime = static_cast<int64_t>(modifiedTime.time_since_epoch().count()),
+        .Exists       = true
+    };
+
+    //Unchanged size and time are trusted, reading the file again would make every lookup as slow as a full hash
+    {
+        std::scoped_lock lock(m_mutex);
+
+        if (const auto it = m_stamps.find(path); it != m_stamps.end()) {
+            const auto& cached = it->second;
+
+            if (cached.Exists && cached.SizeInBytes == stamp.SizeInBytes && cached.ModifiedTime == stamp.ModifiedTime) {
+                return cached;
+            }
+        }
+    }
+
+    //Hashed without the lock, two threads may hash the same file at once and publish the same stamp
+    const auto file = MappedFile::Open(path);
+
+    if (!file) {
+        return {};
+    }
+
+    stamp.ContentHash = HashBytes(file->GetData());
+
+    std::scoped_lock lock(m_mutex);
+    m_stamps[path] = stamp;
+    m_isDirty      = true;
+
+    return stamp;
+}
+
+std::string ImportCache::GetArtifactPath(uint64_t key) const {
+    return (fs::path(m_directory) / std::format("{:016x}.bin", key)).string();
+}
+
+std::string ImportCache::GetIndexPath() const {
+    return (fs::path(m_directory) / "index.bin").string();
+}
+
+void ImportCache::Remove(uint64_t key) {
+    const auto it = m_entries.find(key);
+
+    if (it != m_entries.end()) {
+        std::error_code error;
+        fs::remove(GetArtifactPath(key), error);
+
+        m_sizeInBytes -= it->second.SizeInBytes;
+        m_entries.erase(it);
+        m_isDirty = true;
+    }
+}
+
+//Eviction is rare compared to lookups, a linear scan for the oldest entry keeps the index a plain hash map
+void ImportCache::EvictToFit(uint64_t keepKey) {
+    while (m_sizeInBytes > m_maxSizeInBytes && m_entries.size() > 1) {
+        const auto oldest = std::ranges::min_element(m_entries, {}, [keepKey](const auto& keyEntry) {
+            return keyEntry.first == keepKey ? UINT64_MAX : keyEntry.second.LastUsed;
+        });
+
+        Remove(oldest->first);
+        m_numEvicted++;
+    }
+}
+
+bool ImportCache::LoadIndex() {
+    std::ifstream stream(GetIndexPath(), std::ios::binary);
+
+    if (!stream) {
+        return true;
+    }
+
+    uint32_t magic      = 0;
+    uint32_t version    = 0;
+    uint32_t numEntries = 0;
+    uint32_t numStamps  = 0;
+
+    if (!impl::ReadValue(stream, magic) || !impl::ReadValue(stream, version) || magic != impl::INDEX_MAGIC || version != impl::INDEX_VERSION) {
+        return false;
+    }
+
+    if (!impl::ReadValue(stream, m_useCounter) || !impl::ReadValue(stream, numEntries)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < numEntries; i++) {
+        uint64_t key             = 0;
+        uint32_t numDependencies = 0;
+        Entry entry{};
+
+        if (!impl::ReadValue(stream, key) || !impl::ReadValue(stream, entry.SizeInBytes) || !impl::ReadValue(stream, entry.LastUsed) || !impl::ReadValue(stream, numDependencies)) {
+            return false;
+        }
+
+        entry.Dependencies.resize(numDependencies);
+
+        for (auto& [path, stamp] : entry.Dependencies) {
+            if (!impl::ReadString(stream, path) || !impl::ReadStamp(stream, stamp)) {
+                return false;
+            }
+        }
+
+        m_sizeInBytes += entry.SizeInBytes;
+        m_entries.emplace(key, std::move(entry));
+    }
+
+    if (!impl::ReadValue(stream, numStamps)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < numStamps; i++) {
+        std::string path;
+        FileStamp stamp;
+
+        if (!impl::ReadString(stream, path) || !impl::ReadStamp(stream, stamp)) {
+            return false;
+        }
+        m_stamps.emplace(std::move(path), stamp);
+    }
+    return true;
+}
+
+bool ImportCache::SaveIndexLocked() {
+    const auto indexPath     = GetIndexPath();
+    const auto temporaryPath = indexPath + ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+
+        impl::WriteValue(stream, impl::INDEX_MAGIC);
+        impl::WriteValue(stream, impl::INDEX_VERSION);
+        impl::WriteValue(stream, m_useCounter);
+        impl::WriteValue(stream, static_cast<uint32_t>(m_entries.size()));
+
+        for (const auto& [key, entry] : m_entries) {
+            impl::WriteValue(stream, key);
+            impl::WriteValue(stream, entry.SizeInBytes);
+            impl::WriteValue(stream, entry.LastUsed);
+            impl::WriteValue(stream, static_cast<uint32_t>(entry.Dependencies.size()));
+
+            for (const auto& [path, stamp] : entry.Dependencies) {
+                impl::WriteString(stream, path);
+                impl::WriteStamp(stream, stamp);
+            }
+        }
+
+        impl::WriteValue(stream, static_cast<uint32_t>(m_stamps.size()));
+
+        for (const auto& [path, stamp] : m_stamps) {
+            impl::WriteString(stream, path);
+            impl::WriteStamp(stream, stamp);
+        }
+
+        if (!stream.flush()) {
+            Logger::Warning("Import cache: could not write {}", temporaryPath);
+            return false;
+        }
+    }
+
+    std::error_code error;
+    fs::rename(temporaryPath, indexPath, error);
+
+    if (error) {
+        Logger::Warning("Import cache: could not replace {}: {}", indexPath, error.message());
+        return false;
+    }
+
+    m_isDirty = false;
+    return true;
+}
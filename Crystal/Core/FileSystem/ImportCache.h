@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/Memory/MemoryConstants.h"
+
+namespace Crystal {
+    //Last seen state of a file. The content is only hashed again once its size or modification time changes.
+    struct FileStamp {
+        uint64_t SizeInBytes{ 0 };
+        int64_t ModifiedTime{ 0 };
+        uint64_t ContentHash{ 0 };
+        bool Exists{ false };
+    };
+
+    struct ImportCacheStatistics {
+        uint32_t NumEntries;
+        uint64_t SizeInBytes;
+        uint64_t MaxSizeInBytes;
+
+        //Counted since the cache was opened
+        uint64_t NumHits;
+        uint64_t NumMisses;
+        uint64_t NumInvalidated;
+        uint64_t NumEvicted;
+    };
+
+    //Import results on disk, keyed by the content hash of the source, the directory it is in and the import settings.
+    //Every entry records the other files the import read, e.g. textures, and is dropped once one of them changes.
+    //The index is loaded once and looked up in memory. SaveIndex and the destructor write it to a temporary file and rename
+    //it over the old one, so a crash never leaves a torn index behind. Least recently used artifacts are evicted beyond the size limit.
+    //Source files are hashed outside the lock, so concurrent imports only wait on each other for the bookkeeping.
+    class ImportCache {
+    public:
+        static constexpr uint64_t DEFAULT_MAX_SIZE = MB(2048);
+
+        explicit ImportCache(std::string_view directory, uint64_t maxSizeInBytes = DEFAULT_MAX_SIZE);
+        ImportCache(const ImportCache&)            = delete;
+        ImportCache& operator=(const ImportCache&) = delete;
+        ~ImportCache();
+
+        //Everything that changes the output besides the source content has to go into the settings hash,
+        //e.g. import flags and the version of the cooked format. Empty when the source cannot be read.
+        [[nodiscard]] std::optional<uint64_t> ComputeKey(std::string_view sourcePath, uint64_t settingsHash);
+
+        //Path of the cached artifact, empty on a miss or when a dependency changed since it was stored
+        [[nodiscard]] std::optional<std::string> Find(uint64_t key);
+
+        //The importer writes the artifact here, Commit moves it into the cache in one rename. Every call returns a new
+        //path, so importers cooking the same asset at once never write into each other's file.
+        [[nodiscard]] std::string GetStagingPath(uint64_t key) const;
+        [[nodiscard]] std::optional<std::string> Commit(uint64_t key, std::string_view stagingPath, std::span<const std::string> dependencies);
+
+        //Commits only mark the index dirty, importers that want it on disk before the cache is destroyed call this
+        bool SaveIndex();
+
+        [[nodiscard]] ImportCacheStatistics GetStatistics();
+    private:
+        struct Dependency {
+            std::string Path;
+            FileStamp Stamp;
+        };
+
+        struct Entry {
+            uint64_t SizeInBytes;
+            uint64_t LastUsed;
+            std::vector<Dependency> Dependencies;
+        };
+
+        //Takes m_mutex itself, it must not be held by the caller
+        [[nodiscard]] FileStamp GetFileStamp(const std::string& path);
+        [[nodiscard]] std::string GetArtifactPath(uint64_t key) const;
+        [[nodiscard]] std::string GetIndexPath() const;
+
+        void Remove(uint64_t key);
+        void EvictToFit(uint64_t keepKey);
+        bool LoadIndex();
+        bool SaveIndexLocked();
+
+        std::mutex m_mutex;
+        std::string m_directory;
+        uint64_t m_maxSizeInBytes;
+        uint64_t m_sizeInBytes{ 0 };
+        uint64_t m_useCounter{ 0 };
+        mutable std::atomic<uint64_t> m_stagingCounter{ 0 };
+        bool m_isDirty{ false };
+
+        std::unordered_map<uint64_t, Entry> m_entries;
+        std::unordered_map<std::string, FileStamp> m_stamps;
+
+        uint64_t m_numHits{ 0 };
+        uint64_t m_numMisses{ 0 };
+        uint64_t m_numInvalidated{ 0 };
+        uint64_t m_numEvicted{ 0 };
+    };
+}
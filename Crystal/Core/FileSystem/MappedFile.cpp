@@ -0,0 +1,142 @@
+#include "MappedFile.h"
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace Crystal;
+
+#ifdef _WIN32
+std::optional<MappedFile> MappedFile::Open(std::string_view path) noexcept {
+    MappedFile mappedFile;
+
+    const auto file = CreateFileA(std::string(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE) [[unlikely]] {
+        return {};
+    }
+    mappedFile.m_file = file;
+
+    LARGE_INTEGER fileSize{};
+
+    if (!GetFileSizeEx(file, &fileSize)) [[unlikely]] {
+        return {};
+    }
+
+    //Empty files cannot be mapped, they are valid files with no data
+    if (fileSize.QuadPart == 0) {
+        return mappedFile;
+    }
+
+    mappedFile.m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (!mappedFile.m_mapping) [[unlikely]] {
+        return {};
+    }
+
+    mappedFile.m_data = static_cast<const std::byte*>(MapViewOfFile(mappedFile.m_mapping, FILE_MAP_READ, 0, 0, 0));
+    mappedFile.m_size = static_cast<size_t>(fileSize.QuadPart);
+
+    if (!mappedFile.m_data) [[unlikely]] {
+        return {};
+    }
+    return mappedFile;
+}
+
+void MappedFile::Close() noexcept {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+    }
+
+    if (m_file) {
+        CloseHandle(m_file);
+    }
+
+    m_data    = nullptr;
+    m_size    = 0;
+    m_mapping = nullptr;
+    m_file    = nullptr;
+}
+#else
+std::optional<MappedFile> MappedFile::Open(std::string_view path) noexcept {
+    MappedFile mappedFile;
+
+    const auto file = open(std::string(path).c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file < 0) [[unlikely]] {
+        return {};
+    }
+
+    struct stat fileStatus{};
+
+    if (fstat(file, &fileStatus) != 0 || !S_ISREG(fileStatus.st_mode)) [[unlikely]] {
+        close(file);
+        return {};
+    }
+
+    //The mapping keeps the file alive, the descriptor is not needed after mapping it
+    if (fileStatus.st_size > 0) {
+        const auto data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+        if (data == MAP_FAILED) [[unlikely]] {
+            close(file);
+            return {};
+        }
+
+        mappedFile.m_data = static_cast<const std::byte*>(data);
+        mappedFile.m_size = static_cast<size_t>(fileStatus.st_size);
+    }
+
+    close(file);
+    return mappedFile;
+}
+
+void MappedFile::Close() noexcept {
+    if (m_data) {
+        munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept
+    :
+    m_data(std::exchange(rhs.m_data, nullptr)),
+    m_size(std::exchange(rhs.m_size, 0))
+#ifdef _WIN32
+    ,
+    m_file(std::exchange(rhs.m_file, nullptr)),
+    m_mapping(std::exchange(rhs.m_mapping, nullptr))
+#endif
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+    if (this != &rhs) {
+        Close();
+
+        m_data = std::exchange(rhs.m_data, nullptr);
+        m_size = std::exchange(rhs.m_size, 0);
+#ifdef _WIN32
+        m_file    = std::exchange(rhs.m_file, nullptr);
+        m_mapping = std::exchange(rhs.m_mapping, nullptr);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    Close();
+}
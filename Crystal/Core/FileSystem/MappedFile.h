@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <string_view>
+
+namespace Crystal {
+    //Read only mapping of a whole file. Pages are loaded on first access and shared with the file cache,
+    //so data can be handed to the GPU uploads straight from the mapping.
+    class MappedFile {
+    public:
+        [[nodiscard]] static std::optional<MappedFile> Open(std::string_view path) noexcept;
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& rhs) noexcept;
+        MappedFile& operator=(MappedFile&& rhs) noexcept;
+        ~MappedFile();
+
+        [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return { m_data, m_size }; }
+        [[nodiscard]] size_t GetSize() const noexcept { return m_size; }
+    private:
+        MappedFile() = default;
+        void Close() noexcept;
+
+        const std::byte* m_data{ nullptr };
+        size_t m_size{ 0 };
+
+#ifdef _WIN32
+        void* m_file{ nullptr };
+        void* m_mapping{ nullptr };
+#endif
+    };
+}
@@ -0,0 +1,359 @@
+#include "PakFile.h"
+#include "Core/Lib/Compression.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Lib/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <type_traits>
+
+using namespace Crystal;
+
+static_assert(std::is_trivially_copyable_v<PakHeader> && std::is_trivially_copyable_v<PakEntry> && std::is_trivially_copyable_v<PakBlock>);
+
+namespace impl {
+    [[nodiscard]] constexpr uint64_t AlignPakData(uint64_t offset) noexcept {
+        return (offset + PakFormat::DATA_ALIGNMENT - 1) & ~uint64_t{ PakFormat::DATA_ALIGNMENT - 1 };
+    }
+
+    [[nodiscard]] constexpr bool IsRangeInPak(uint64_t offset, uint64_t sizeInBytes, uint64_t fileSize) noexcept {
+        return offset <= fileSize && sizeInBytes <= fileSize - offset;
+    }
+
+    //Rounded up without adding to the size, which may come from a corrupt table and be close to 2^64
+    [[nodiscard]] constexpr uint64_t GetNumPakBlocks(uint64_t size, uint32_t blockSize) noexcept {
+        return size / blockSize + (size % blockSize != 0 ? 1 : 0);
+    }
+
+    bool ReadPakSource(const std::string& path, std::vector<std::byte>& data) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+
+        if (!file) {
+            return false;
+        }
+
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return file.good() || data.empty();
+    }
+}
+
+std::string Crystal::NormalizePakPath(std::string_view path) {
+    while (path.starts_with("./") || path.starts_with(".\\") || path.starts_with('/') || path.starts_with('\\')) {
+        path.remove_prefix(path.starts_with('.') ? 2 : 1);
+    }
+
+    std::string normalized(path);
+
+    for (auto& c : normalized) {
+        c = c == '\\' ? '/' : static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+uint64_t Crystal::HashPakPath(std::string_view normalizedPath) noexcept {
+    return HashBytes(std::as_bytes(std::span(normalizedPath)));
+}
+
+std::optional<PakFile> PakFile::Open(std::string_view path) noexcept {
+    auto file = MappedFile::Open(path);
+
+    if (!file || file->GetSize() < sizeof(PakHeader)) [[unlikely]] {
+        return {};
+    }
+
+    PakFile pakFile(std::move(*file));
+
+    if (!pakFile.Validate()) [[unlikely]] {
+        return {};
+    }
+    return pakFile;
+}
+
+PakFile::PakFile(MappedFile&& file) noexcept
+    :
+    m_file(std::move(file)),
+    m_header(reinterpret_cast<const PakHeader*>(m_file.GetData().data()))
+{}
+
+//Every range handed out later is checked once here, lookups and reads trust the tables afterwards
+bool PakFile::Validate() const noexcept {
+    const auto& header  = *m_header;
+    const auto fileSize = m_file.GetSize();
+
+    if (header.Magic != PakFormat::MAGIC || header.Version != PakFormat::VERSION || header.BlockSize == 0) {
+        return false;
+    }
+
+    const bool tablesInFile =
+        header.EntryTableOffset % PakFormat::DATA_ALIGNMENT == 0 &&
+        header.BlockTableOffset % PakFormat::DATA_ALIGNMENT == 0 &&
+        impl::IsRangeInPak(header.EntryTableOffset, uint64_t{ header.NumEntries } * sizeof(PakEntry), fileSize) &&
+        impl::IsRangeInPak(header.BlockTableOffset, uint64_t{ header.NumBlocks } * sizeof(PakBlock), fileSize) &&
+        impl::IsRangeInPak(header.StringTableOffset, header.StringTableSize, fileSize);
+
+    if (!tablesInFile) {
+        return false;
+    }
+
+    const auto entries = GetEntries();
+    const auto blocks  = std::span(reinterpret_cast<const PakBlock*>(m_file.GetData().data() + header.BlockTableOffset), header.NumBlocks);
+
+    for (size_t i = 0; i < entries.size(); i++) {
+        const auto& entry = entries[i];
+
+        const bool isEntryValid =
+            (i == 0 || entries[i - 1].PathHash <= entry.PathHash) &&
+            uint64_t{ entry.PathOffset } + entry.PathLength <= header.StringTableSize &&
+            (IsCompressed(entry)
+                ? uint64_t{ entry.FirstBlock } + entry.NumBlocks <= header.NumBlocks && entry.NumBlocks == impl::GetNumPakBlocks(entry.Size, header.BlockSize) &&
+                  entry.Size <= uint64_t{ entry.NumBlocks } * header.BlockSize
+                : entry.StoredSize == entry.Size && impl::IsRangeInPak(entry.DataOffset, entry.Size, fileSize));
+
+        if (!isEntryValid) {
+            return false;
+        }
+
+        for (uint32_t block = 0; IsCompressed(entry) && block < entry.NumBlocks; block++) {
+            const auto& [offset, storedSize, reserved] = blocks[entry.FirstBlock + block];
+            const auto blockSize = std::min<uint64_t>(header.BlockSize, entry.Size - uint64_t{ block } * header.BlockSize);
+
+            if (storedSize > blockSize || !impl::IsRangeInPak(offset, storedSize, fileSize)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+std::span<const PakEntry> PakFile::GetEntries() const noexcept {
+    return { reinterpret_cast<const PakEntry*>(m_file.GetData().data() + m_header->EntryTableOffset), m_header->NumEntries };
+}
+
+std::string_view PakFile::GetPath(const PakEntry& entry) const noexcept {
+    return { reinterpret_cast<const char*>(m_file.GetData().data() + m_header->StringTableOffset + entry.PathOffset), entry.PathLength };
+}
+
+const PakEntry* PakFile::Find(std::string_view normalizedPath) const noexcept {
+    return Find(normalizedPath, HashPakPath(normalizedPath));
+}
+
+//Paths with the same hash are next to each other, they are told apart by comparing the paths
+const PakEntry* PakFile::Find(std::string_view normalizedPath, uint64_t pathHash) const noexcept {
+    const auto entries = GetEntries();
+
+    for (auto it = std::ranges::lower_bound(entries, pathHash, {}, &PakEntry::PathHash); it != entries.end() && it->PathHash == pathHash; ++it) {
+        if (GetPath(*it) == normalizedPath) {
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+std::span<const std::byte> PakFile::GetData(const PakEntry& entry) const noexcept {
+    return IsCompressed(entry) ? std::span<const std::byte>{} : m_file.GetData().subspan(entry.DataOffset, entry.Size);
+}
+
+std::span<const PakBlock> PakFile::GetBlocks(const PakEntry& entry) const noexcept {
+    const auto* blocks = reinterpret_cast<const PakBlock*>(m_file.GetData().data() + m_header->BlockTableOffset);
+    return { blocks + entry.FirstBlock, entry.NumBlocks };
+}
+
+bool PakFile::DecodeBlock(const PakEntry& entry, uint32_t block, std::span<std::byte> output) const noexcept {
+    const auto& [offset, storedSize, reserved] = GetBlocks(entry)[block];
+
+    const auto blockOffset = uint64_t{ block } * m_header->BlockSize;
+    const auto blockOutput = output.subspan(blockOffset, std::min<uint64_t>(m_header->BlockSize, entry.Size - blockOffset));
+    const auto stored      = m_file.GetData().subspan(offset, storedSize);
+
+    //Blocks that did not compress are stored as they are
+    if (storedSize == blockOutput.size()) {
+        std::memcpy(blockOutput.data(), stored.data(), stored.size());
+        return true;
+    }
+    return Crystal::DecompressBlock(stored, blockOutput);
+}
+
+bool PakFile::Decompress(const PakEntry& entry, std::span<std::byte> output, ThreadPool* threadPool) const {
+    if (!IsCompressed(entry) || output.size() != entry.Size) [[unlikely]] {
+        return false;
+    }
+
+    if (!threadPool || entry.NumBlocks == 1) {
+        for (uint32_t block = 0; block < entry.NumBlocks; block++) {
+            if (!DecodeBlock(entry, block, output)) [[unlikely]] {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::atomic<bool> isValid{ true };
+
+    threadPool->ParallelFor(entry.NumBlocks, [&](size_t block) {
+        if (!DecodeBlock(entry, static_cast<uint32_t>(block), output)) [[unlikely]] {
+            isValid.store(false, std::memory_order_relaxed);
+        }
+    });
+    return isValid.load(std::memory_order_relaxed);
+}
+
+PakWriter::PakWriter(uint32_t blockSize) noexcept
+    :
+    m_blockSize(blockSize)
+{}
+
+void PakWriter::AddFile(std::string_view path, std::vector<std::byte> data, bool compress) {
+    Add({ .Path = NormalizePakPath(path), .Data = std::move(data), .Compress = compress });
+}
+
+void PakWriter::AddLooseFile(std::string_view path, std::string_view sourcePath, bool compress) {
+    Add({ .Path = NormalizePakPath(path), .SourcePath = std::string(sourcePath), .Compress = compress });
+}
+
+void PakWriter::Add(PendingFile&& file) {
+    const auto [it, isNew] = m_fileIndices.try_emplace(file.Path, m_files.size());
+
+    if (isNew) {
+        m_files.push_back(std::move(file));
+    }
+    else {
+        m_files[it->second] = std::move(file);
+    }
+}
+
+//Data is written in path order so files of one directory stay close on disk, the tables follow it. The header is
+//written last, once every offset is known.
+bool PakWriter::Write(std::string_view path, ThreadPool* threadPool, PakWriterStatistics* statistics) const {
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+
+    if (!file) [[unlikely]] {
+        return false;
+    }
+
+    PakHeader header{
+        .Magic      = PakFormat::MAGIC,
+        .Version    = PakFormat::VERSION,
+        .NumEntries = static_cast<uint32_t>(m_files.size()),
+        .BlockSize  = m_blockSize
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    const auto pad = [&](uint64_t alignedOffset) {
+        constexpr std::array<char, PakFormat::DATA_ALIGNMENT> PADDING{};
+        file.write(PADDING.data(), static_cast<std::streamsize>(alignedOffset - static_cast<uint64_t>(file.tellp())));
+        return alignedOffset;
+    };
+
+    std::vector<uint32_t> order(m_files.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::ranges::sort(order, {}, [&](uint32_t file) -> const std::string& { return m_files[file].Path; });
+
+    std::vector<PakEntry> entries;
+    std::vector<PakBlock> blocks;
+    std::string strings;
+
+    std::vector<std::byte> sourceData;
+    std::vector<std::vector<std::byte>> compressedBlocks;
+    std::vector<size_t> compressedSizes;
+
+    for (const auto index : order) {
+        const auto& pendingFile = m_files[index];
+
+        if (!pendingFile.SourcePath.empty() && !impl::ReadPakSource(pendingFile.SourcePath, sourceData)) [[unlikely]] {
+            return false;
+        }
+
+        const auto data = pendingFile.SourcePath.empty() ? std::span<const std::byte>(pendingFile.Data) : std::span<const std::byte>(sourceData);
+
+        PakEntry entry{
+            .PathHash   = HashPakPath(pendingFile.Path),
+            .PathOffset = static_cast<uint32_t>(strings.size()),
+            .PathLength = static_cast<uint32_t>(pendingFile.Path.size()),
+            .DataOffset = pad(impl::AlignPakData(static_cast<uint64_t>(file.tellp()))),
+            .Size       = data.size(),
+            .StoredSize = data.size()
+        };
+
+        strings += pendingFile.Path;
+
+        //Blocks that do not shrink are kept as they are, the output is one byte short of the block to detect them
+        const auto numBlocks = pendingFile.Compress ? impl::GetNumPakBlocks(data.size(), m_blockSize) : 0;
+
+        compressedBlocks.resize(numBlocks);
+        compressedSizes.assign(numBlocks, 0);
+
+        const auto compressBlock = [&](size_t block) {
+            const auto input = data.subspan(block * m_blockSize, std::min<size_t>(m_blockSize, data.size() - block * m_blockSize));
+
+            compressedBlocks[block].resize(input.size() - 1);
+            compressedSizes[block] = CompressBlock(input, compressedBlocks[block]);
+
+            if (compressedSizes[block] == 0) {
+                compressedBlocks[block].assign(input.begin(), input.end());
+                compressedSizes[block] = input.size();
+            }
+        };
+
+        if (threadPool && numBlocks > 1) {
+            threadPool->ParallelFor(numBlocks, compressBlock);
+        }
+        else {
+            for (size_t block = 0; block < numBlocks; block++) {
+                compressBlock(block);
+            }
+        }
+
+        const auto storedSize = std::accumulate(compressedSizes.begin(), compressedSizes.end(), uint64_t{ 0 });
+
+        if (numBlocks > 0 && storedSize <= data.size() - data.size() / PakFormat::MIN_SAVINGS) {
+            entry.StoredSize = storedSize;
+            entry.FirstBlock = static_cast<uint32_t>(blocks.size());
+            entry.NumBlocks  = static_cast<uint32_t>(numBlocks);
+
+            for (size_t block = 0; block < numBlocks; block++) {
+                blocks.push_back({ .Offset = static_cast<uint64_t>(file.tellp()), .StoredSize = static_cast<uint32_t>(compressedSizes[block]) });
+                file.write(reinterpret_cast<const char*>(compressedBlocks[block].data()), static_cast<std::streamsize>(compressedSizes[block]));
+            }
+        }
+        else {
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        }
+
+        if (statistics) {
+            statistics->NumCompressed += entry.NumBlocks != 0;
+            statistics->Size          += entry.Size;
+            statistics->StoredSize    += entry.StoredSize;
+        }
+
+        entries.push_back(entry);
+    }
+
+    std::ranges::sort(entries, {}, &PakEntry::PathHash);
+
+    header.NumBlocks         = static_cast<uint32_t>(blocks.size());
+    header.BlockTableOffset  = pad(impl::AlignPakData(static_cast<uint64_t>(file.tellp())));
+    file.write(reinterpret_cast<const char*>(blocks.data()), static_cast<std::streamsize>(blocks.size() * sizeof(PakBlock)));
+
+    header.EntryTableOffset  = pad(impl::AlignPakData(static_cast<uint64_t>(file.tellp())));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(PakEntry)));
+
+    header.StringTableOffset = static_cast<uint64_t>(file.tellp());
+    header.StringTableSize   = strings.size();
+    file.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    if (statistics) {
+        statistics->NumEntries = header.NumEntries;
+    }
+    return file.good();
+}
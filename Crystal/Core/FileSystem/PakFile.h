@@ -0,0 +1,134 @@
+#pragma once
+#include "MappedFile.h"
+#include "Core/Memory/MemoryConstants.h"
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace Crystal {
+    class ThreadPool;
+
+    namespace PakFormat {
+        constexpr uint32_t MAGIC          = 0x4B415043; //"CPAK"
+        constexpr uint32_t VERSION        = 1;
+        constexpr uint32_t DATA_ALIGNMENT = 16;
+
+        //Compressed entries are split into blocks of this size that are decoded independently
+        constexpr uint32_t DEFAULT_BLOCK_SIZE = static_cast<uint32_t>(KB(256));
+
+        //Entries are only stored compressed when that saves at least 1 / MIN_SAVINGS of their size, everything else
+        //is mapped in place
+        constexpr uint64_t MIN_SAVINGS = 8;
+    }
+
+    //Offsets are in bytes from the start of the file
+    struct PakHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t NumEntries;
+        uint32_t NumBlocks;
+        uint32_t BlockSize;
+        uint32_t Reserved;
+
+        uint64_t EntryTableOffset;
+        uint64_t BlockTableOffset;
+        uint64_t StringTableOffset;
+        uint64_t StringTableSize;
+    };
+
+    //Entries are sorted by the hash of their normalized path. Entries without blocks are stored uncompressed at
+    //DataOffset, compressed ones own NumBlocks blocks starting at FirstBlock.
+    struct PakEntry {
+        uint64_t PathHash;
+        uint32_t PathOffset;
+        uint32_t PathLength;
+        uint64_t DataOffset;
+        uint64_t Size;
+        uint64_t StoredSize;
+        uint32_t FirstBlock;
+        uint32_t NumBlocks;
+    };
+
+    //Every block but the last of an entry holds BlockSize bytes. A block whose stored size equals that is stored as is.
+    struct PakBlock {
+        uint64_t Offset;
+        uint32_t StoredSize;
+        uint32_t Reserved;
+    };
+
+    //Forward slashes, lower case and no leading "./" or "/", archives and lookups agree on this form
+    [[nodiscard]] std::string NormalizePakPath(std::string_view path);
+    [[nodiscard]] uint64_t HashPakPath(std::string_view normalizedPath) noexcept;
+
+    //A packed archive mapped into memory. Opening validates the tables, entries are found by a binary search over the
+    //path hashes. Uncompressed entries are views into the mapping, compressed ones are decoded block by block.
+    class PakFile {
+    public:
+        [[nodiscard]] static std::optional<PakFile> Open(std::string_view path) noexcept;
+
+        [[nodiscard]] const PakHeader& GetHeader() const noexcept { return *m_header; }
+        [[nodiscard]] std::span<const PakEntry> GetEntries() const noexcept;
+        [[nodiscard]] std::string_view GetPath(const PakEntry& entry) const noexcept;
+
+        //The path has to be normalized, nullptr when the archive does not contain it
+        [[nodiscard]] const PakEntry* Find(std::string_view normalizedPath) const noexcept;
+        [[nodiscard]] const PakEntry* Find(std::string_view normalizedPath, uint64_t pathHash) const noexcept;
+
+        [[nodiscard]] static bool IsCompressed(const PakEntry& entry) noexcept { return entry.NumBlocks != 0; }
+
+        //Data of an uncompressed entry straight from the mapping, empty for compressed entries
+        [[nodiscard]] std::span<const std::byte> GetData(const PakEntry& entry) const noexcept;
+
+        //Decodes a compressed entry into output, which has to hold Size bytes. Blocks are spread over the thread
+        //pool when one is given. Fails when a block is corrupt.
+        [[nodiscard]] bool Decompress(const PakEntry& entry, std::span<std::byte> output, ThreadPool* threadPool = nullptr) const;
+    private:
+        explicit PakFile(MappedFile&& file) noexcept;
+
+        [[nodiscard]] bool Validate() const noexcept;
+        [[nodiscard]] std::span<const PakBlock> GetBlocks(const PakEntry& entry) const noexcept;
+        [[nodiscard]] bool DecodeBlock(const PakEntry& entry, uint32_t block, std::span<std::byte> output) const noexcept;
+
+        MappedFile m_file;
+        const PakHeader* m_header{ nullptr };
+    };
+
+    struct PakWriterStatistics {
+        uint32_t NumEntries{ 0 };
+        uint32_t NumCompressed{ 0 };
+        uint64_t Size{ 0 };
+        uint64_t StoredSize{ 0 };
+    };
+
+    //Collects files and writes them as an archive. Files added under a path that is already taken replace the earlier
+    //one. Entries are compressed one at a time, their blocks in parallel when a thread pool is given.
+    class PakWriter {
+    public:
+        explicit PakWriter(uint32_t blockSize = PakFormat::DEFAULT_BLOCK_SIZE) noexcept;
+
+        void AddFile(std::string_view path, std::vector<std::byte> data, bool compress = true);
+
+        //The file is read when the archive is written, so the writer never holds more than one of them
+        void AddLooseFile(std::string_view path, std::string_view sourcePath, bool compress = true);
+
+        [[nodiscard]] bool Write(std::string_view path, ThreadPool* threadPool = nullptr, PakWriterStatistics* statistics = nullptr) const;
+    private:
+        struct PendingFile {
+            std::string Path;
+            std::string SourcePath;
+            std::vector<std::byte> Data;
+            bool Compress;
+        };
+
+        void Add(PendingFile&& file);
+
+        uint32_t m_blockSize;
+        std::vector<PendingFile> m_files;
+        std::unordered_map<std::string, size_t> m_fileIndices;
+    };
+}
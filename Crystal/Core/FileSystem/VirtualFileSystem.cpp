@@ -0,0 +1,129 @@
+#include "VirtualFileSystem.h"
+#include "FileSystem.h"
+#include "Core/Logging/Logger.h"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace Crystal;
+
+VirtualFileSystem::VirtualFileSystem(std::string_view looseDirectory, bool looseOverrides, ThreadPool* threadPool)
+    :
+    m_looseDirectory(looseDirectory),
+    m_looseOverrides(looseOverrides),
+    m_threadPool(threadPool)
+{}
+
+bool VirtualFileSystem::Mount(std::string_view pakPath) {
+    auto pakFile = PakFile::Open(pakPath);
+
+    if (!pakFile) [[unlikely]] {
+        Logger::Warning("Failed to mount archive {}", pakPath);
+        return false;
+    }
+
+    auto pak = std::make_shared<const PakFile>(std::move(*pakFile));
+
+    std::unique_lock lock(m_mutex);
+    std::erase_if(m_mounts, [&](const MountedPak& mount) { return mount.Path == pakPath; });
+    m_mounts.push_back({ .Path = std::string(pakPath), .Pak = std::move(pak) });
+    return true;
+}
+
+bool VirtualFileSystem::Unmount(std::string_view pakPath) {
+    std::unique_lock lock(m_mutex);
+    return std::erase_if(m_mounts, [&](const MountedPak& mount) { return mount.Path == pakPath; }) != 0;
+}
+
+std::optional<VirtualFile> VirtualFileSystem::Open(std::string_view path) const {
+    if (m_looseOverrides) {
+        if (auto file = OpenLoose(path)) {
+            return file;
+        }
+        return OpenArchived(NormalizePakPath(path));
+    }
+
+    if (auto file = OpenArchived(NormalizePakPath(path))) {
+        return file;
+    }
+    return OpenLoose(path);
+}
+
+bool VirtualFileSystem::Exists(std::string_view path) const {
+    if (!m_looseDirectory.empty() && FileSystem::IsFile(FileSystem::Append(m_looseDirectory, path))) {
+        return true;
+    }
+
+    const auto normalizedPath = NormalizePakPath(path);
+    const auto pathHash       = HashPakPath(normalizedPath);
+
+    std::shared_lock lock(m_mutex);
+    return std::ranges::any_of(m_mounts, [&](const MountedPak& mount) { return mount.Pak->Find(normalizedPath, pathHash) != nullptr; });
+}
+
+size_t VirtualFileSystem::GetNumMounts() const {
+    std::shared_lock lock(m_mutex);
+    return m_mounts.size();
+}
+
+//A missing file fails in the open call, there is no separate existence check
+std::optional<VirtualFile> VirtualFileSystem::OpenLoose(std::string_view path) const {
+    if (m_looseDirectory.empty()) {
+        return {};
+    }
+
+    auto mappedFile = MappedFile::Open(FileSystem::Append(m_looseDirectory, path));
+
+    if (!mappedFile) {
+        return {};
+    }
+
+    VirtualFile file;
+    file.m_data    = mappedFile->GetData();
+    file.m_storage = std::move(*mappedFile);
+    file.m_source  = VirtualFileSource::Loose;
+    return file;
+}
+
+//The archive is looked up under the lock, decoding runs after it is released
+std::optional<VirtualFile> VirtualFileSystem::OpenArchived(std::string_view normalizedPath) const {
+    const auto pathHash = HashPakPath(normalizedPath);
+
+    std::shared_ptr<const PakFile> pak;
+    const PakEntry* entry = nullptr;
+
+    {
+        std::shared_lock lock(m_mutex);
+
+        for (auto it = m_mounts.rbegin(); it != m_mounts.rend() && !entry; ++it) {
+            if ((entry = it->Pak->Find(normalizedPath, pathHash))) {
+                pak = it->Pak;
+            }
+        }
+    }
+
+    if (!entry) {
+        return {};
+    }
+
+    VirtualFile file;
+    file.m_source = VirtualFileSource::Archive;
+
+    if (!PakFile::IsCompressed(*entry)) {
+        file.m_data    = pak->GetData(*entry);
+        file.m_storage = std::move(pak);
+        return file;
+    }
+
+    //Every byte is written by the decoder, clearing the buffer first would only cost time
+    auto data = std::make_unique_for_overwrite<std::byte[]>(entry->Size);
+
+    if (!pak->Decompress(*entry, { data.get(), entry->Size }, m_threadPool)) [[unlikely]] {
+        Logger::Error("Corrupt archive entry {}", normalizedPath);
+        return {};
+    }
+
+    file.m_data    = { data.get(), entry->Size };
+    file.m_storage = std::move(data);
+    return file;
+}
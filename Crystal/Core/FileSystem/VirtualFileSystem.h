@@ -0,0 +1,79 @@
+#pragma once
+#include "MappedFile.h"
+#include "PakFile.h"
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace Crystal {
+    class ThreadPool;
+
+    enum class VirtualFileSource : uint8_t {
+        Loose,
+        Archive
+    };
+
+    //Contents of a file opened through the virtual file system. Loose files and uncompressed archive entries are
+    //views into a mapping, compressed entries own their decoded data. The file keeps its archive alive, so it
+    //stays valid after an unmount.
+    class VirtualFile {
+    public:
+        [[nodiscard]] std::span<const std::byte> GetData() const noexcept { return m_data; }
+        [[nodiscard]] size_t GetSize() const noexcept { return m_data.size(); }
+        [[nodiscard]] VirtualFileSource GetSource() const noexcept { return m_source; }
+    private:
+        friend class VirtualFileSystem;
+
+        std::span<const std::byte> m_data;
+        std::variant<std::monostate, MappedFile, std::unique_ptr<std::byte[]>, std::shared_ptr<const PakFile>> m_storage;
+        VirtualFileSource m_source{ VirtualFileSource::Loose };
+    };
+
+    //Serves files from mounted archives and a loose directory. Archives mounted later take precedence over earlier
+    //ones. During development loose files override archive entries, so edited assets are picked up without
+    //rebuilding the archives, shipping builds only fall back to loose files that no archive contains.
+    class VirtualFileSystem {
+    public:
+#if defined(_DEBUG) || defined(CRYSTAL_LOOSE_FILE_OVERRIDES)
+        static constexpr bool DEFAULT_LOOSE_OVERRIDES = true;
+#else
+        static constexpr bool DEFAULT_LOOSE_OVERRIDES = false;
+#endif
+
+        //Loose files are looked up relative to looseDirectory, an empty directory disables them. Compressed entries
+        //are decoded on the thread pool when one is given.
+        explicit VirtualFileSystem(std::string_view looseDirectory, bool looseOverrides = DEFAULT_LOOSE_OVERRIDES, ThreadPool* threadPool = nullptr);
+        VirtualFileSystem(const VirtualFileSystem&)            = delete;
+        VirtualFileSystem& operator=(const VirtualFileSystem&) = delete;
+
+        //Mounting an archive again moves it to the top
+        bool Mount(std::string_view pakPath);
+        bool Unmount(std::string_view pakPath);
+
+        [[nodiscard]] std::optional<VirtualFile> Open(std::string_view path) const;
+        [[nodiscard]] bool Exists(std::string_view path) const;
+
+        [[nodiscard]] size_t GetNumMounts() const;
+    private:
+        struct MountedPak {
+            std::string Path;
+            std::shared_ptr<const PakFile> Pak;
+        };
+
+        [[nodiscard]] std::optional<VirtualFile> OpenLoose(std::string_view path) const;
+        [[nodiscard]] std::optional<VirtualFile> OpenArchived(std::string_view normalizedPath) const;
+
+        std::string m_looseDirectory;
+        bool m_looseOverrides;
+        ThreadPool* m_threadPool;
+
+        mutable std::shared_mutex m_mutex;
+        std::vector<MountedPak> m_mounts;
+    };
+}
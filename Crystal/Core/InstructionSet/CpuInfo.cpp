@@ -1,10 +1,18 @@
 #include "CpuInfo.h"
 #include <algorithm>
 
+#ifndef _WIN32
+#include <fstream>
+#include <set>
+#include <sys/utsname.h>
+#endif
+
 using namespace Crystal;
 
 CpuInfo::CpuInfo() noexcept {
+#ifdef _WIN32
     GetNativeSystemInfo(&m_sysInfo);
+#endif
 
     Info.BrandString          = GetBrandString();
     Info.Vendor               = GetVendor();
@@ -67,6 +75,11 @@ CpuInfo::CpuInfo() noexcept {
     };
 }
 
+#ifdef _WIN32
+std::string CpuInfo::GetArchitecture() const noexcept {
+    return m_architectures.at(m_sysInfo.wProcessorArchitecture);
+}
+
 uint32_t CpuInfo::GetNumberOfCores() noexcept {
     DWORD sizeInBytes{ 0 };
     auto numCores{ 0 };
@@ -88,3 +101,57 @@ uint32_t CpuInfo::GetNumberOfCores() noexcept {
     }
     return numCores;
 }
+#else
+std::string CpuInfo::GetArchitecture() const noexcept {
+    utsname name{};
+
+    if (uname(&name) != 0) [[unlikely]] {
+        return m_architectures.at(0xFFFF);
+    }
+
+    const std::string machine = name.machine;
+
+    if (machine == "x86_64") {
+        return m_architectures.at(9);
+    }
+    if (machine == "aarch64") {
+        return m_architectures.at(12);
+    }
+    if (machine.starts_with("arm")) {
+        return m_architectures.at(5);
+    }
+    if (machine.size() == 4 && machine.starts_with('i') && machine.ends_with("86")) {
+        return m_architectures.at(0);
+    }
+    return machine;
+}
+
+uint32_t CpuInfo::GetNumberOfCores() noexcept {
+    std::ifstream cpuInfo("/proc/cpuinfo");
+    std::set<std::pair<std::string, std::string>> cores;
+
+    std::string line;
+    std::string physicalId;
+
+    //Every logical processor lists the package and core it belongs to, count the unique pairs
+    while (std::getline(cpuInfo, line)) {
+        const auto separator = line.find(':');
+
+        if (separator == std::string::npos) {
+            continue;
+        }
+
+        const auto value = separator + 2 <= line.size() ? line.substr(separator + 2) : std::string{};
+
+        if (line.starts_with("physical id")) {
+            physicalId = value;
+        }
+        else if (line.starts_with("core id")) {
+            cores.emplace(physicalId, value);
+        }
+    }
+
+    //Not every kernel or architecture exposes the topology
+    return cores.empty() ? GetNumberOfLogicalProcessors() : static_cast<uint32_t>(cores.size());
+}
+#endif
@@ -1,5 +1,7 @@
 #pragma once
+#ifdef _WIN32
 #include "Platform/Windows/CrystalWindow.h"
+#endif
 #include "InstructionSet.h"
 #include <unordered_map>
 #include <thread>
@@ -22,12 +24,14 @@ namespace Crystal {
     private:
         [[nodiscard]] std::string GetBrandString()  const noexcept { return m_instructionSet.Brandstring(); }
         [[nodiscard]] std::string GetVendor()       const noexcept { return m_instructionSet.Vendor(); }
-        [[nodiscard]] std::string GetArchitecture() const noexcept { return m_architectures.at(m_sysInfo.wProcessorArchitecture); }
+        [[nodiscard]] std::string GetArchitecture() const noexcept;
 
         [[nodiscard]] static uint32_t GetNumberOfLogicalProcessors() noexcept { return std::thread::hardware_concurrency(); }
         [[nodiscard]] static uint32_t GetNumberOfCores() noexcept;
 
+#ifdef _WIN32
         SYSTEM_INFO m_sysInfo{};
+#endif
         InstructionSet m_instructionSet;
         std::unordered_map<int, std::string> m_architectures{
             {9, "x86-64"},
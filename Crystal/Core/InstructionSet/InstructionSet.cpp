@@ -1,18 +1,44 @@
 #include "InstructionSet.h"
+
+#ifdef _MSC_VER
 #include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
 
 using namespace Crystal;
 
+namespace impl {
+    //<cpuid.h> defines __cpuid as a macro with a different signature, so both compilers go through these
+    void cpuidex(Register32* registers, int function, int subfunction) noexcept {
+#ifdef _MSC_VER
+        __cpuidex(registers, function, subfunction);
+#else
+        uint32_t eax{}, ebx{}, ecx{}, edx{};
+        __cpuid_count(static_cast<uint32_t>(function), static_cast<uint32_t>(subfunction), eax, ebx, ecx, edx);
+
+        registers[0] = static_cast<Register32>(eax);
+        registers[1] = static_cast<Register32>(ebx);
+        registers[2] = static_cast<Register32>(ecx);
+        registers[3] = static_cast<Register32>(edx);
+#endif
+    }
+
+    void cpuid(Register32* registers, int function) noexcept {
+        cpuidex(registers, function, 0);
+    }
+}
+
 InstructionSet::InstructionSet() noexcept {
-    __cpuid(*m_cpuData.Data32().data(), 0);
+    impl::cpuid(*m_cpuData.Data32().data(), 0);
 
-    m_ids = m_cpuData.Regs32().EAX;
+    m_ids = static_cast<uint32_t>(m_cpuData.Regs32().EAX);
 
     //Capture the cpu vendor name
     m_vendor = CaptureVendor();
 
-    for (auto i = 0; i <= m_ids; ++i) {
-        __cpuidex(*m_cpuData.Data32().data(), i, 0);
+    for (uint32_t i = 0; i <= m_ids; ++i) {
+        impl::cpuidex(*m_cpuData.Data32().data(), static_cast<int>(i), 0);
         m_data.push_back(m_cpuData);
     }
 
@@ -35,14 +61,14 @@ InstructionSet::InstructionSet() noexcept {
         m_bitsetFlags[3] = m_data[7].Regs32().ECX;
     }
 
-    __cpuid(*m_cpuData.Data32().data(), 0x80000000);
-    m_exIds = m_cpuData.Regs32().EAX;
+    impl::cpuid(*m_cpuData.Data32().data(), 0x80000000);
+    m_exIds = static_cast<uint32_t>(m_cpuData.Regs32().EAX);
 
     //Capture the cpu BrandString 
     m_brandstring = CaptureBrandString();
 
-    for (auto i = 0x80000000; i <= m_exIds; ++i) {
-        __cpuidex(*m_cpuData.Data32().data(), i, 0);
+    for (uint32_t i = 0x80000000; i <= m_exIds; ++i) {
+        impl::cpuidex(*m_cpuData.Data32().data(), static_cast<int>(i), 0);
         m_extData.push_back(m_cpuData);
     }
 
@@ -63,7 +89,7 @@ std::string InstructionSet::CaptureVendor() const noexcept {
 }
 
 //Returns the 48 byte null terminated cpu brandString stored in EAX, EBX, ECX and EDX
-//by calling the __cpuid intrinsic with EAX set to 0x80000002, 0x80000003 and 0x80000004
+//by calling cpuid with EAX set to 0x80000002, 0x80000003 and 0x80000004
 std::string InstructionSet::CaptureBrandString() const noexcept {
     if (m_exIds < 0x80000004) [[unlikely]] {
         return "Unable to get CPU brand information";
@@ -73,11 +99,15 @@ std::string InstructionSet::CaptureBrandString() const noexcept {
     std::string brandString{};
 
     for (const auto funcId : cpuIDBrandStringCalls) {
-        __cpuid(*m_cpuData.Data32().data(), funcId);
+        impl::cpuid(*m_cpuData.Data32().data(), funcId);
         const auto& data8 = m_cpuData.Data8();
 
         brandString.append(*data8.data(), data8.size());
     }
 
+    //The string is padded with null characters, strip them so it prints and serializes cleanly
+    if (const auto end = brandString.find('\0'); end != std::string::npos) {
+        brandString.resize(end);
+    }
     return brandString;
 }
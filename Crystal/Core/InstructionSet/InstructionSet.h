@@ -1,6 +1,8 @@
 #pragma once
 #include <array>
+#include <bit>
 #include <bitset>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -142,8 +144,8 @@ namespace Crystal {
     	[[nodiscard]] std::string CaptureVendor()      const noexcept;
     	[[nodiscard]] std::string CaptureBrandString() const noexcept;
 
-        int m_ids{};
-        int m_exIds{};
+        uint32_t m_ids{};
+        uint32_t m_exIds{};
 
         bool m_isIntel{};
         bool m_isAMD{};
@@ -0,0 +1,32 @@
+#pragma once
+#include "InstructionSet.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CRYSTAL_SIMD_X64 1
+#include <immintrin.h>
+#else
+#define CRYSTAL_SIMD_X64 0
+#endif
+
+//Marks a function as allowed to use AVX2 without building the whole engine for it, callers check HasAvx2 first.
+//MSVC accepts the intrinsics in any function, GCC and Clang need the target per function.
+#if CRYSTAL_SIMD_X64 && (defined(__GNUC__) || defined(__clang__))
+#define CRYSTAL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CRYSTAL_TARGET_AVX2
+#endif
+
+namespace Crystal {
+    //Checked once, the operating system has to save the wide registers as well
+    [[nodiscard]] inline bool HasAvx2() noexcept {
+#if CRYSTAL_SIMD_X64
+        static const bool hasAvx2 = [] {
+            const InstructionSet instructionSet;
+            return instructionSet.AVX2() && instructionSet.OSXSAVE();
+        }();
+        return hasAvx2;
+#else
+        return false;
+#endif
+    }
+}
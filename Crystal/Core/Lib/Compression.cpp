@@ -0,0 +1,254 @@
+#include "Compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr size_t MIN_MATCH     = 4;
+    constexpr size_t LAST_LITERALS = 5;
+    //Matches have to start this far before the end, the last bytes are always literals
+    constexpr size_t MATCH_LIMIT   = 12;
+    constexpr size_t MAX_OFFSET    = 65535;
+    constexpr size_t COPY_CHUNK    = 16;
+
+    constexpr uint32_t HASH_BITS = 12;
+
+    [[nodiscard]] uint32_t ReadWord(const std::byte* data) noexcept {
+        uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    [[nodiscard]] uint32_t HashWord(uint32_t word) noexcept {
+        return (word * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    //Lengths beyond the 4 bits of the token continue in bytes of 255 ended by a smaller one
+    class SequenceWriter {
+    public:
+        explicit SequenceWriter(std::span<std::byte> output) noexcept
+            :
+            m_output(output)
+        {}
+
+        [[nodiscard]] bool Write(std::span<const std::byte> literals, size_t offset, size_t matchLength) noexcept {
+            const auto extraMatch = matchLength >= MIN_MATCH ? matchLength - MIN_MATCH : 0;
+            const auto token      = std::min<size_t>(literals.size(), 15) << 4 | std::min<size_t>(extraMatch, 15);
+
+            if (!Put(static_cast<std::byte>(token)) || !PutLength(literals.size()) || !Put(literals)) {
+                return false;
+            }
+
+            //The last sequence only has literals
+            if (matchLength == 0) {
+                return true;
+            }
+            return Put(static_cast<std::byte>(offset & 0xFF)) && Put(static_cast<std::byte>(offset >> 8)) && PutLength(extraMatch);
+        }
+
+        [[nodiscard]] size_t GetSize() const noexcept { return m_size; }
+    private:
+        [[nodiscard]] bool Put(std::byte value) noexcept {
+            if (m_size == m_output.size()) {
+                return false;
+            }
+            m_output[m_size++] = value;
+            return true;
+        }
+
+        [[nodiscard]] bool Put(std::span<const std::byte> bytes) noexcept {
+            if (bytes.size() > m_output.size() - m_size) {
+                return false;
+            }
+
+            if (!bytes.empty()) {
+                std::memcpy(m_output.data() + m_size, bytes.data(), bytes.size());
+            }
+            m_size += bytes.size();
+            return true;
+        }
+
+        [[nodiscard]] bool PutLength(size_t length) noexcept {
+            if (length < 15) {
+                return true;
+            }
+
+            for (length -= 15; length >= 255; length -= 255) {
+                if (!Put(std::byte{ 255 })) {
+                    return false;
+                }
+            }
+            return Put(static_cast<std::byte>(length));
+        }
+
+        std::span<std::byte> m_output;
+        size_t m_size{ 0 };
+    };
+
+    //Reads a length continued past the token, false when the input ends inside it
+    [[nodiscard]] bool ReadLength(const std::byte*& input, const std::byte* end, size_t& length) noexcept {
+        if (length < 15) {
+            return true;
+        }
+
+        for (;;) {
+            if (input == end) [[unlikely]] {
+                return false;
+            }
+
+            const auto value = std::to_integer<size_t>(*input++);
+            length += value;
+
+            if (value != 255) {
+                return true;
+            }
+        }
+    }
+}
+
+size_t Crystal::CompressBlock(std::span<const std::byte> input, std::span<std::byte> output) noexcept {
+    impl::SequenceWriter writer(output);
+
+    const auto* data = input.data();
+    const auto size  = input.size();
+
+    size_t anchor = 0;
+
+    if (size > impl::MATCH_LIMIT) {
+        //Positions are stored plus one, 0 marks an empty slot
+        std::array<uint32_t, 1 << impl::HASH_BITS> table{};
+
+        const auto matchEnd = size - impl::LAST_LITERALS;
+        size_t position     = 0;
+
+        while (position + impl::MATCH_LIMIT <= size) {
+            const auto word = impl::ReadWord(data + position);
+            const auto hash = impl::HashWord(word);
+            const auto slot = table[hash];
+
+            table[hash] = static_cast<uint32_t>(position + 1);
+
+            const bool isMatch = slot != 0 && position - (slot - 1) <= impl::MAX_OFFSET && impl::ReadWord(data + slot - 1) == word;
+
+            if (!isMatch) {
+                //Skips ahead faster the longer nothing matched, incompressible data is passed over quickly
+                position += 1 + ((position - anchor) >> 6);
+                continue;
+            }
+
+            auto reference = size_t{ slot - 1 };
+            auto start     = position;
+
+            //Extended backwards into the pending literals, then forwards up to the last literals
+            while (start > anchor && reference > 0 && data[start - 1] == data[reference - 1]) {
+                start--;
+                reference--;
+            }
+
+            auto end = position + impl::MIN_MATCH;
+
+            while (end < matchEnd && data[end] == data[reference + (end - start)]) {
+                end++;
+            }
+
+            if (!writer.Write(input.subspan(anchor, start - anchor), start - reference, end - start)) {
+                return 0;
+            }
+
+            anchor   = end;
+            position = end;
+
+            //The position just before the next search keeps runs matching
+            if (position + impl::MATCH_LIMIT <= size) {
+                table[impl::HashWord(impl::ReadWord(data + position - 2))] = static_cast<uint32_t>(position - 1);
+            }
+        }
+    }
+
+    if (!writer.Write(input.subspan(anchor), 0, 0)) {
+        return 0;
+    }
+    return writer.GetSize();
+}
+
+//Short literal runs and matches away from the end of the buffers are copied in fixed 16 byte chunks that may write past
+//their length, later sequences overwrite those bytes. Only the last bytes of a block take the exact paths.
+bool Crystal::DecompressBlock(std::span<const std::byte> input, std::span<std::byte> output) noexcept {
+    const auto* in       = input.data();
+    const auto* inEnd    = in + input.size();
+    auto* out            = output.data();
+    auto* const outBegin = output.data();
+    auto* const outEnd   = out + output.size();
+
+    while (in != inEnd) {
+        const auto token = std::to_integer<size_t>(*in++);
+
+        size_t literalLength = token >> 4;
+
+        if (literalLength < 15 && static_cast<size_t>(inEnd - in) >= impl::COPY_CHUNK && static_cast<size_t>(outEnd - out) >= impl::COPY_CHUNK) [[likely]] {
+            std::memcpy(out, in, impl::COPY_CHUNK);
+        }
+        else {
+            if (!impl::ReadLength(in, inEnd, literalLength) ||
+                literalLength > static_cast<size_t>(inEnd - in) ||
+                literalLength > static_cast<size_t>(outEnd - out)) [[unlikely]]
+            {
+                return false;
+            }
+
+            if (literalLength != 0) {
+                std::memcpy(out, in, literalLength);
+            }
+        }
+
+        in  += literalLength;
+        out += literalLength;
+
+        //The last sequence ends after its literals
+        if (in == inEnd) {
+            break;
+        }
+
+        if (inEnd - in < 2) [[unlikely]] {
+            return false;
+        }
+
+        const auto offset = std::to_integer<size_t>(in[0]) | std::to_integer<size_t>(in[1]) << 8;
+        in += 2;
+
+        size_t matchLength = token & 15;
+
+        if (!impl::ReadLength(in, inEnd, matchLength) || offset == 0 || offset > static_cast<size_t>(out - outBegin)) [[unlikely]] {
+            return false;
+        }
+
+        matchLength += impl::MIN_MATCH;
+
+        if (matchLength > static_cast<size_t>(outEnd - out)) [[unlikely]] {
+            return false;
+        }
+
+        const auto* match = out - offset;
+
+        if (offset >= impl::COPY_CHUNK && static_cast<size_t>(outEnd - out) >= matchLength + impl::COPY_CHUNK) [[likely]] {
+            for (size_t copied = 0; copied < matchLength; copied += impl::COPY_CHUNK) {
+                std::memcpy(out + copied, match + copied, impl::COPY_CHUNK);
+            }
+        }
+        else if (offset >= matchLength) {
+            std::memcpy(out, match, matchLength);
+        }
+        else {
+            //Overlapping matches repeat the last offset bytes, every copy doubles the repeated part
+            for (size_t copied = 0, distance = offset; copied < matchLength; copied += distance, distance *= 2) {
+                std::memcpy(out + copied, match, std::min(distance, matchLength - copied));
+            }
+        }
+        out += matchLength;
+    }
+    return out == outEnd;
+}
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+#include <span>
+
+namespace Crystal {
+    //Byte oriented LZ77 in the LZ4 block layout: a token with the literal and match length, the literals, a 16-bit
+    //offset and the remaining match length. Greedy matching through a hash of the next 4 bytes compresses at a few
+    //hundred MB/s, decoding is mostly copies and runs at memory speed.
+    [[nodiscard]] constexpr size_t GetMaxCompressedSize(size_t inputSize) noexcept {
+        return inputSize + inputSize / 255 + 16;
+    }
+
+    //Returns the compressed size, 0 when the result does not fit into output. An output smaller than the input
+    //rejects incompressible data early.
+    [[nodiscard]] size_t CompressBlock(std::span<const std::byte> input, std::span<std::byte> output) noexcept;
+
+    //Output has to be the size of the uncompressed block, fails on corrupt input instead of reading or writing out of
+    //bounds
+    [[nodiscard]] bool DecompressBlock(std::span<const std::byte> input, std::span<std::byte> output) noexcept;
+}
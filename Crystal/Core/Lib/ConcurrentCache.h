@@ -0,0 +1,136 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+namespace Crystal {
+    //Key-value cache split into independently locked shards, so lookups of unrelated keys do not contend on one mutex.
+    //Every key is loaded at most once at a time: the first caller runs the loader outside of the lock and callers asking
+    //for the same key meanwhile wait for its result. A loader that throws leaves nothing behind, all waiters rethrow.
+    //Values are handed out by copy, they are meant to be handles such as reference counted pointers.
+    template<class Key, class Value, class Hash = std::hash<Key>, size_t NUM_SHARDS = 16>
+    class ConcurrentCache {
+        static_assert(std::has_single_bit(NUM_SHARDS), "The shard count has to be a power of two");
+    public:
+        ConcurrentCache() = default;
+        ConcurrentCache(const ConcurrentCache&)            = delete;
+        ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+        template<class Loader>
+        [[nodiscard]] Value GetOrLoad(const Key& key, Loader&& loader) {
+            auto& shard = GetShard(key);
+
+            std::promise<Value> promise;
+            std::shared_future<Value> future;
+            uint64_t loadId = 0;
+            bool isLoader   = false;
+            {
+                std::scoped_lock lock(shard.Mutex);
+
+                auto [it, isInserted] = shard.Entries.try_emplace(key);
+
+                if (isInserted) {
+                    it->second = { promise.get_future().share(), ++shard.NumLoads };
+                    isLoader   = true;
+                }
+                future = it->second.Future;
+                loadId = it->second.LoadId;
+            }
+
+            if (isLoader) {
+                try {
+                    promise.set_value(std::invoke(std::forward<Loader>(loader)));
+                }
+                catch (...) {
+                    //Removed before the waiters are woken, so whoever asks next loads again. The key may have been erased
+                    //and loaded by someone else meanwhile, that newer entry stays.
+                    {
+                        std::scoped_lock lock(shard.Mutex);
+
+                        if (const auto it = shard.Entries.find(key); it != shard.Entries.end() && it->second.LoadId == loadId) {
+                            shard.Entries.erase(it);
+                        }
+                    }
+                    promise.set_exception(std::current_exception());
+                    throw;
+                }
+            }
+            return future.get();
+        }
+
+        //Only finished loads are returned, a key that is still loading counts as missing
+        [[nodiscard]] std::optional<Value> Find(const Key& key) const {
+            const auto& shard = GetShard(key);
+            std::scoped_lock lock(shard.Mutex);
+
+            const auto it = shard.Entries.find(key);
+
+            if (it == shard.Entries.end() || it->second.Future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return {};
+            }
+            return it->second.Future.get();
+        }
+
+        //Also true while the key is loading
+        [[nodiscard]] bool Contains(const Key& key) const {
+            const auto& shard = GetShard(key);
+            std::scoped_lock lock(shard.Mutex);
+            return shard.Entries.contains(key);
+        }
+
+        //Callers already waiting on the key still get its value, later ones load it again
+        bool Erase(const Key& key) {
+            auto& shard = GetShard(key);
+            std::scoped_lock lock(shard.Mutex);
+            return shard.Entries.erase(key) > 0;
+        }
+
+        void Clear() {
+            for (auto& shard : m_shards) {
+                std::scoped_lock lock(shard.Mutex);
+                shard.Entries.clear();
+            }
+        }
+
+        [[nodiscard]] size_t Size() const {
+            size_t size = 0;
+
+            for (const auto& shard : m_shards) {
+                std::scoped_lock lock(shard.Mutex);
+                size += shard.Entries.size();
+            }
+            return size;
+        }
+    private:
+        struct Entry {
+            std::shared_future<Value> Future;
+
+            //Tells the load that created the entry apart from later loads of the same key
+            uint64_t LoadId{ 0 };
+        };
+
+        struct alignas(64) Shard {
+            mutable std::mutex Mutex;
+            std::unordered_map<Key, Entry, Hash> Entries;
+            uint64_t NumLoads{ 0 };
+        };
+
+        //The high bits of the mixed hash pick the shard, the map itself uses the low bits
+        [[nodiscard]] static size_t GetShardIndex(const Key& key) noexcept {
+            const auto hash = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+            return static_cast<size_t>(hash >> 32) & (NUM_SHARDS - 1);
+        }
+
+        [[nodiscard]] Shard& GetShard(const Key& key) noexcept { return m_shards[GetShardIndex(key)]; }
+        [[nodiscard]] const Shard& GetShard(const Key& key) const noexcept { return m_shards[GetShardIndex(key)]; }
+
+        std::array<Shard, NUM_SHARDS> m_shards;
+    };
+}
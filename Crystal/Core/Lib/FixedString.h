@@ -1,4 +1,7 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <string_view>
 
 namespace Crystal::crylib {
 	template<size_t Length>
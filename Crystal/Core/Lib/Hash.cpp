@@ -0,0 +1,87 @@
+#include "Hash.h"
+#include <bit>
+#include <cstring>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+    [[nodiscard]] inline uint64_t Read64(const std::byte* data) noexcept {
+        uint64_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] inline uint32_t Read32(const std::byte* data) noexcept {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    [[nodiscard]] constexpr uint64_t Round(uint64_t accumulator, uint64_t lane) noexcept {
+        accumulator += lane * PRIME_2;
+        accumulator  = std::rotl(accumulator, 31);
+        return accumulator * PRIME_1;
+    }
+
+    [[nodiscard]] constexpr uint64_t MergeRound(uint64_t hash, uint64_t accumulator) noexcept {
+        hash ^= Round(0, accumulator);
+        return hash * PRIME_1 + PRIME_4;
+    }
+}
+
+//Reads little endian lanes, the result matches the reference XXH64 on the platforms the engine targets
+uint64_t Crystal::HashBytes(std::span<const std::byte> data, uint64_t seed) noexcept {
+    auto input       = data.data();
+    const auto end   = input + data.size();
+    uint64_t hash;
+
+    if (data.size() >= 32) {
+        uint64_t accumulators[4] = { seed + impl::PRIME_1 + impl::PRIME_2, seed + impl::PRIME_2, seed, seed - impl::PRIME_1 };
+
+        for (const auto limit = end - 32; input <= limit; input += 32) {
+            for (int lane = 0; lane < 4; lane++) {
+                accumulators[lane] = impl::Round(accumulators[lane], impl::Read64(input + lane * 8));
+            }
+        }
+
+        hash = std::rotl(accumulators[0], 1) + std::rotl(accumulators[1], 7) + std::rotl(accumulators[2], 12) + std::rotl(accumulators[3], 18);
+
+        for (const auto accumulator : accumulators) {
+            hash = impl::MergeRound(hash, accumulator);
+        }
+    }
+    else {
+        hash = seed + impl::PRIME_5;
+    }
+
+    hash += data.size();
+
+    for (; input + 8 <= end; input += 8) {
+        hash ^= impl::Round(0, impl::Read64(input));
+        hash  = std::rotl(hash, 27) * impl::PRIME_1 + impl::PRIME_4;
+    }
+
+    if (input + 4 <= end) {
+        hash ^= impl::Read32(input) * impl::PRIME_1;
+        hash  = std::rotl(hash, 23) * impl::PRIME_2 + impl::PRIME_3;
+        input += 4;
+    }
+
+    for (; input < end; input++) {
+        hash ^= static_cast<uint64_t>(*input) * impl::PRIME_5;
+        hash  = std::rotl(hash, 11) * impl::PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= impl::PRIME_2;
+    hash ^= hash >> 29;
+    hash *= impl::PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
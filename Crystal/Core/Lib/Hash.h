@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Crystal {
+    //64-bit xxHash of a byte range, fast enough to fingerprint whole asset files.
+    //Not cryptographic, only meant to detect changed content.
+    [[nodiscard]] uint64_t HashBytes(std::span<const std::byte> data, uint64_t seed = 0) noexcept;
+
+    //Mixes value into seed, the order of the combined values matters
+    [[nodiscard]] constexpr uint64_t HashCombine(uint64_t seed, uint64_t value) noexcept {
+        value *= 0x9E3779B97F4A7C15ull;
+        value ^= value >> 32;
+        return (seed ^ value) * 0xBF58476D1CE4E5B9ull + (seed >> 31);
+    }
+}
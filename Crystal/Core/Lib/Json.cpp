@@ -0,0 +1,485 @@
+#include "Json.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+using namespace Crystal;
+using namespace Crystal::Json;
+
+namespace impl {
+    const Value::Array emptyArray;
+    const Value::Object emptyObject;
+
+    //Deeper documents are rejected instead of overflowing the stack
+    constexpr uint32_t MAX_DEPTH = 256;
+
+    class Parser {
+    public:
+        explicit Parser(std::string_view text) noexcept : m_text(text) {}
+
+        std::optional<Value> ParseDocument(ParseError* error) {
+            auto value = ParseValue(0);
+
+            if (value) {
+                SkipWhiteSpace();
+
+                if (m_position != m_text.size()) {
+                    value.reset();
+                    Fail("Unexpected trailing characters");
+                }
+            }
+
+            if (!value && error) {
+                *error = ParseError{ .Message = m_error, .Offset = m_position };
+            }
+            return value;
+        }
+    private:
+        [[nodiscard]] bool AtEnd() const noexcept { return m_position >= m_text.size(); }
+        [[nodiscard]] char Peek()  const noexcept { return AtEnd() ? '\0' : m_text[m_position]; }
+
+        void SkipWhiteSpace() noexcept {
+            while (!AtEnd() && (Peek() == ' ' || Peek() == '\n' || Peek() == '\r' || Peek() == '\t')) {
+                m_position++;
+            }
+        }
+
+        bool Consume(char c) noexcept {
+            SkipWhiteSpace();
+
+            if (Peek() == c) {
+                m_position++;
+                return true;
+            }
+            return false;
+        }
+
+        bool ConsumeLiteral(std::string_view literal) noexcept {
+            if (m_text.substr(m_position, literal.size()) == literal) {
+                m_position += literal.size();
+                return true;
+            }
+            return false;
+        }
+
+        std::nullopt_t Fail(std::string_view message) {
+            if (m_error.empty()) {
+                m_error = message;
+            }
+            return std::nullopt;
+        }
+
+        std::optional<Value> ParseValue(uint32_t depth) {
+            if (depth > MAX_DEPTH) [[unlikely]] {
+                return Fail("Maximum nesting depth exceeded");
+            }
+
+            SkipWhiteSpace();
+
+            switch (Peek()) {
+            case '{': return ParseObject(depth);
+            case '[': return ParseArray(depth);
+            case '"': {
+                auto string = ParseString();
+                return string ? std::optional<Value>(std::move(*string)) : std::nullopt;
+            }
+            case 't':
+                return ConsumeLiteral("true") ? std::optional<Value>(true) : Fail("Invalid literal");
+            case 'f':
+                return ConsumeLiteral("false") ? std::optional<Value>(false) : Fail("Invalid literal");
+            case 'n':
+                return ConsumeLiteral("null") ? std::optional<Value>(nullptr) : Fail("Invalid literal");
+            default:
+                return ParseNumber();
+            }
+        }
+
+        std::optional<Value> ParseObject(uint32_t depth) {
+            m_position++;
+
+            Value::Object object;
+
+            if (Consume('}')) {
+                return object;
+            }
+
+            do {
+                SkipWhiteSpace();
+
+                if (Peek() != '"') {
+                    return Fail("Expected a member name");
+                }
+
+                auto key = ParseString();
+
+                if (!key) {
+                    return std::nullopt;
+                }
+
+                if (!Consume(':')) {
+                    return Fail("Expected ':'");
+                }
+
+                auto value = ParseValue(depth + 1);
+
+                if (!value) {
+                    return std::nullopt;
+                }
+                object.emplace_back(std::move(*key), std::move(*value));
+            } while (Consume(','));
+
+            if (!Consume('}')) {
+                return Fail("Expected ',' or '}'");
+            }
+            return object;
+        }
+
+        std::optional<Value> ParseArray(uint32_t depth) {
+            m_position++;
+
+            Value::Array array;
+
+            if (Consume(']')) {
+                return array;
+            }
+
+            do {
+                auto value = ParseValue(depth + 1);
+
+                if (!value) {
+                    return std::nullopt;
+                }
+                array.emplace_back(std::move(*value));
+            } while (Consume(','));
+
+            if (!Consume(']')) {
+                return Fail("Expected ',' or ']'");
+            }
+            return array;
+        }
+
+        std::optional<uint32_t> ParseHex4() noexcept {
+            if (m_position + 4 > m_text.size()) {
+                return std::nullopt;
+            }
+
+            uint32_t codePoint{};
+            const auto* begin = m_text.data() + m_position;
+            const auto result = std::from_chars(begin, begin + 4, codePoint, 16);
+
+            if (result.ec != std::errc{} || result.ptr != begin + 4) {
+                return std::nullopt;
+            }
+
+            m_position += 4;
+            return codePoint;
+        }
+
+        static void AppendUtf8(std::string& string, uint32_t codePoint) {
+            if (codePoint < 0x80) {
+                string.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800) {
+                string.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+                string.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else if (codePoint < 0x10000) {
+                string.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+                string.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                string.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+            else {
+                string.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+                string.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                string.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                string.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+
+        std::optional<std::string> ParseString() {
+            m_position++;
+
+            std::string string;
+
+            while (true) {
+                if (AtEnd()) {
+                    Fail("Unterminated string");
+                    return std::nullopt;
+                }
+
+                //Copy runs of plain characters in one go
+                const auto runEnd = m_text.find_first_of("\"\\", m_position);
+                const auto end    = runEnd == std::string_view::npos ? m_text.size() : runEnd;
+
+                string.append(m_text.substr(m_position, end - m_position));
+                m_position = end;
+
+                if (AtEnd()) {
+                    continue;
+                }
+
+                if (m_text[m_position++] == '"') {
+                    return string;
+                }
+
+                const auto escape = Peek();
+                m_position++;
+
+                switch (escape) {
+                case '"':  string.push_back('"');  break;
+                case '\\': string.push_back('\\'); break;
+                case '/':  string.push_back('/');  break;
+                case 'b':  string.push_back('\b'); break;
+                case 'f':  string.push_back('\f'); break;
+                case 'n':  string.push_back('\n'); break;
+                case 'r':  string.push_back('\r'); break;
+                case 't':  string.push_back('\t'); break;
+                case 'u': {
+                    auto codePoint = ParseHex4();
+
+                    if (!codePoint) {
+                        Fail("Invalid unicode escape");
+                        return std::nullopt;
+                    }
+
+                    //Combine surrogate pairs into a single code point
+                    if (*codePoint >= 0xD800 && *codePoint <= 0xDBFF && ConsumeLiteral("\\u")) {
+                        const auto low = ParseHex4();
+
+                        if (!low || *low < 0xDC00 || *low > 0xDFFF) {
+                            Fail("Invalid surrogate pair");
+                            return std::nullopt;
+                        }
+                        codePoint = 0x10000 + ((*codePoint - 0xD800) << 10) + (*low - 0xDC00);
+                    }
+
+                    AppendUtf8(string, *codePoint);
+                    break;
+                }
+                default:
+                    Fail("Invalid escape sequence");
+                    return std::nullopt;
+                }
+            }
+        }
+
+        std::optional<Value> ParseNumber() {
+            const auto begin = m_position;
+
+            if (Peek() == '-') {
+                m_position++;
+            }
+
+            while (!AtEnd() && std::string_view("0123456789.eE+-").find(Peek()) != std::string_view::npos) {
+                m_position++;
+            }
+
+            if (begin == m_position) {
+                return Fail("Unexpected character");
+            }
+
+            double value{};
+            const auto* first = m_text.data() + begin;
+            const auto* last  = m_text.data() + m_position;
+            const auto result = std::from_chars(first, last, value);
+
+            if (result.ec != std::errc{} || result.ptr != last) {
+                m_position = begin;
+                return Fail("Invalid number");
+            }
+            return value;
+        }
+
+        std::string_view m_text;
+        size_t m_position{ 0 };
+        std::string m_error;
+    };
+
+    void AppendEscaped(std::string& out, std::string_view string) {
+        out.push_back('"');
+
+        for (const auto c : string) {
+            switch (c) {
+            case '"':  out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\b': out.append("\\b");  break;
+            case '\f': out.append("\\f");  break;
+            case '\n': out.append("\\n");  break;
+            case '\r': out.append("\\r");  break;
+            case '\t': out.append("\\t");  break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    static constexpr std::string_view hex = "0123456789abcdef";
+
+                    out.append("\\u00");
+                    out.push_back(hex[(c >> 4) & 0xF]);
+                    out.push_back(hex[c & 0xF]);
+                }
+                else {
+                    out.push_back(c);
+                }
+            }
+        }
+        out.push_back('"');
+    }
+
+    void AppendNumber(std::string& out, double value) {
+        //JSON has no representation for these
+        if (!std::isfinite(value)) {
+            out.append("null");
+            return;
+        }
+
+        char buffer[32];
+
+        //Integers are written without a fraction as long as doubles can represent them exactly
+        const auto result = std::trunc(value) == value && std::abs(value) < 9007199254740992.0
+            ? std::to_chars(std::begin(buffer), std::end(buffer), static_cast<int64_t>(value))
+            : std::to_chars(std::begin(buffer), std::end(buffer), value);
+
+        out.append(buffer, result.ptr);
+    }
+
+    void AppendIndent(std::string& out, bool pretty, uint32_t depth) {
+        if (pretty) {
+            out.push_back('\n');
+            out.append(depth * 2, ' ');
+        }
+    }
+
+    void SerializeValue(std::string& out, const Value& value, bool pretty, uint32_t depth) {
+        if (value.IsNull()) {
+            out.append("null");
+        }
+        else if (value.IsBool()) {
+            out.append(value.AsBool() ? "true" : "false");
+        }
+        else if (value.IsNumber()) {
+            AppendNumber(out, value.AsNumber());
+        }
+        else if (value.IsString()) {
+            AppendEscaped(out, value.AsString());
+        }
+        else if (value.IsArray()) {
+            const auto& array = value.AsArray();
+
+            out.push_back('[');
+
+            for (size_t i = 0; i < array.size(); i++) {
+                if (i > 0) {
+                    out.push_back(',');
+                }
+                AppendIndent(out, pretty, depth + 1);
+                SerializeValue(out, array[i], pretty, depth + 1);
+            }
+
+            if (!array.empty()) {
+                AppendIndent(out, pretty, depth);
+            }
+            out.push_back(']');
+        }
+        else {
+            const auto& object = value.AsObject();
+
+            out.push_back('{');
+
+            for (size_t i = 0; i < object.size(); i++) {
+                if (i > 0) {
+                    out.push_back(',');
+                }
+                AppendIndent(out, pretty, depth + 1);
+                AppendEscaped(out, object[i].first);
+                out.append(pretty ? ": " : ":");
+                SerializeValue(out, object[i].second, pretty, depth + 1);
+            }
+
+            if (!object.empty()) {
+                AppendIndent(out, pretty, depth);
+            }
+            out.push_back('}');
+        }
+    }
+}
+
+bool Value::AsBool(bool fallback) const noexcept {
+    const auto* value = std::get_if<bool>(&m_value);
+    return value ? *value : fallback;
+}
+
+double Value::AsNumber(double fallback) const noexcept {
+    const auto* value = std::get_if<double>(&m_value);
+    return value ? *value : fallback;
+}
+
+int64_t Value::AsInt(int64_t fallback) const noexcept {
+    const auto* value = std::get_if<double>(&m_value);
+    return value ? static_cast<int64_t>(*value) : fallback;
+}
+
+std::string_view Value::AsString(std::string_view fallback) const noexcept {
+    const auto* value = std::get_if<std::string>(&m_value);
+    return value ? std::string_view(*value) : fallback;
+}
+
+const Value::Array& Value::AsArray() const noexcept {
+    const auto* value = std::get_if<Array>(&m_value);
+    return value ? *value : impl::emptyArray;
+}
+
+const Value::Object& Value::AsObject() const noexcept {
+    const auto* value = std::get_if<Object>(&m_value);
+    return value ? *value : impl::emptyObject;
+}
+
+const Value* Value::Find(std::string_view key) const noexcept {
+    const auto& object = AsObject();
+    const auto member  = std::ranges::find(object, key, [](const auto& pair) -> std::string_view { return pair.first; });
+
+    return member != object.end() ? &member->second : nullptr;
+}
+
+const Value* Value::At(size_t index) const noexcept {
+    const auto& array = AsArray();
+    return index < array.size() ? &array[index] : nullptr;
+}
+
+size_t Value::Size() const noexcept {
+    if (IsArray()) {
+        return AsArray().size();
+    }
+    return AsObject().size();
+}
+
+Value& Value::Set(std::string_view key, Value value) {
+    if (IsNull()) {
+        m_value = Object{};
+    }
+
+    auto& object = std::get<Object>(m_value);
+
+    for (auto& [name, member] : object) {
+        if (name == key) {
+            member = std::move(value);
+            return member;
+        }
+    }
+    return object.emplace_back(std::string(key), std::move(value)).second;
+}
+
+Value& Value::PushBack(Value value) {
+    if (IsNull()) {
+        m_value = Array{};
+    }
+    return std::get<Array>(m_value).emplace_back(std::move(value));
+}
+
+std::optional<Value> Json::Parse(std::string_view text, ParseError* error) {
+    return impl::Parser(text).ParseDocument(error);
+}
+
+std::string Json::Serialize(const Value& value, bool pretty) {
+    std::string out;
+    impl::SerializeValue(out, value, pretty, 0);
+    return out;
+}
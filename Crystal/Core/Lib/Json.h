@@ -0,0 +1,72 @@
+#pragma once
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace Crystal::Json {
+    //Minimal JSON document model. Objects keep their insertion order so serialized output is deterministic.
+    class Value {
+    public:
+        using Array  = std::vector<Value>;
+        using Object = std::vector<std::pair<std::string, Value>>;
+
+        Value() noexcept = default;
+        Value(std::nullptr_t) noexcept {}
+        Value(bool value) noexcept : m_value(value) {}
+        Value(double value) noexcept : m_value(value) {}
+        Value(std::integral auto value) noexcept : m_value(static_cast<double>(value)) {}
+        Value(std::string value) noexcept : m_value(std::move(value)) {}
+        Value(std::string_view value) : m_value(std::string(value)) {}
+        Value(const char* value) : m_value(std::string(value)) {}
+        Value(Array value) noexcept : m_value(std::move(value)) {}
+        Value(Object value) noexcept : m_value(std::move(value)) {}
+
+        [[nodiscard]] static Value MakeArray()  noexcept { return Array{}; }
+        [[nodiscard]] static Value MakeObject() noexcept { return Object{}; }
+
+        [[nodiscard]] bool IsNull()   const noexcept { return std::holds_alternative<std::monostate>(m_value); }
+        [[nodiscard]] bool IsBool()   const noexcept { return std::holds_alternative<bool>(m_value); }
+        [[nodiscard]] bool IsNumber() const noexcept { return std::holds_alternative<double>(m_value); }
+        [[nodiscard]] bool IsString() const noexcept { return std::holds_alternative<std::string>(m_value); }
+        [[nodiscard]] bool IsArray()  const noexcept { return std::holds_alternative<Array>(m_value); }
+        [[nodiscard]] bool IsObject() const noexcept { return std::holds_alternative<Object>(m_value); }
+
+        //Accessors return the fallback when the value holds a different type
+        [[nodiscard]] bool AsBool(bool fallback = false)        const noexcept;
+        [[nodiscard]] double AsNumber(double fallback = 0.0)    const noexcept;
+        [[nodiscard]] int64_t AsInt(int64_t fallback = 0)       const noexcept;
+        [[nodiscard]] std::string_view AsString(std::string_view fallback = {}) const noexcept;
+
+        [[nodiscard]] const Array& AsArray()   const noexcept;
+        [[nodiscard]] const Object& AsObject() const noexcept;
+
+        //Object member lookup, returns nullptr when this is not an object or the key does not exist
+        [[nodiscard]] const Value* Find(std::string_view key) const noexcept;
+
+        //Array element lookup, returns nullptr when out of range
+        [[nodiscard]] const Value* At(size_t index) const noexcept;
+
+        [[nodiscard]] size_t Size() const noexcept;
+
+        //Inserts or replaces a member, turns a null value into an object
+        Value& Set(std::string_view key, Value value);
+
+        //Appends an element, turns a null value into an array
+        Value& PushBack(Value value);
+    private:
+        std::variant<std::monostate, bool, double, std::string, Array, Object> m_value;
+    };
+
+    struct ParseError {
+        std::string Message;
+        size_t Offset{};
+    };
+
+    [[nodiscard]] std::optional<Value> Parse(std::string_view text, ParseError* error = nullptr);
+    [[nodiscard]] std::string Serialize(const Value& value, bool pretty = true);
+}
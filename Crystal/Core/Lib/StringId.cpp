@@ -0,0 +1,191 @@
+#include "StringId.h"
+#include "Core/Logging/Logger.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace Crystal;
+
+namespace impl {
+    struct StringEntry {
+        uint64_t Hash;
+        std::string_view String;
+    };
+
+    //Open addressing with linear probing, slots are only ever filled, never cleared
+    struct StringTableSlots {
+        explicit StringTableSlots(uint32_t capacity)
+            :
+            Mask(capacity - 1),
+            Slots(std::make_unique<std::atomic<const StringEntry*>[]>(capacity))
+        {}
+
+        [[nodiscard]] uint32_t Capacity() const noexcept { return Mask + 1; }
+
+        uint32_t Mask;
+        std::unique_ptr<std::atomic<const StringEntry*>[]> Slots;
+    };
+
+    //Readers never take a lock: they load the current slot array and probe it.
+    //Writers are serialized, they fill an empty slot with a fully built entry or publish a larger slot array.
+    //Replaced slot arrays and all entries live as long as the table, so a reader can never see freed memory.
+    class StringTable {
+    public:
+        static constexpr uint32_t INITIAL_CAPACITY = 1024;
+        static constexpr size_t CHUNK_SIZE         = 64 * 1024;
+
+        [[nodiscard]] static StringTable& Get() noexcept {
+            static StringTable table;
+            return table;
+        }
+
+        [[nodiscard]] const StringEntry* Find(uint64_t hash) const noexcept {
+            const auto* slots = m_slots.load(std::memory_order_acquire);
+
+            for (auto index = static_cast<uint32_t>(hash) & slots->Mask;; index = (index + 1) & slots->Mask) {
+                const auto* entry = slots->Slots[index].load(std::memory_order_acquire);
+
+                if (entry == nullptr || entry->Hash == hash) {
+                    return entry;
+                }
+            }
+        }
+
+        [[nodiscard]] StringId Intern(std::string_view string) {
+            const StringId id(string);
+
+            if (const auto* entry = Find(id.GetHash())) [[likely]] {
+                CheckCollision(*entry, string);
+                return id;
+            }
+
+            std::scoped_lock lock(m_mutex);
+
+            //Another thread may have interned it while this one waited for the lock
+            if (const auto* entry = Find(id.GetHash())) {
+                CheckCollision(*entry, string);
+                return id;
+            }
+
+            auto* slots = m_slots.load(std::memory_order_relaxed);
+
+            //Keep the load factor at or below one half so probe sequences stay short
+            if ((m_numStrings + 1) * 2 > slots->Capacity()) {
+                slots = Grow(*slots);
+            }
+
+            const auto& entry = m_entries.emplace_back(StringEntry{ .Hash = id.GetHash(), .String = Store(string) });
+            Insert(*slots, entry);
+
+            m_numStrings++;
+            return id;
+        }
+
+        [[nodiscard]] StringTableStatistics GetStatistics() const noexcept {
+            std::scoped_lock lock(m_mutex);
+
+            return {
+                .NumStrings    = m_numStrings,
+                .Capacity      = m_slots.load(std::memory_order_relaxed)->Capacity(),
+                .StringBytes   = m_stringBytes,
+                .NumCollisions = m_numCollisions.load(std::memory_order_relaxed)
+            };
+        }
+    private:
+        StringTable() {
+            m_slotHistory.push_back(std::make_unique<StringTableSlots>(INITIAL_CAPACITY));
+            m_slots.store(m_slotHistory.back().get(), std::memory_order_release);
+        }
+
+        void CheckCollision([[maybe_unused]] const StringEntry& entry, [[maybe_unused]] std::string_view string) noexcept {
+#ifdef _DEBUG
+            if (entry.String != string) [[unlikely]] {
+                m_numCollisions.fetch_add(1, std::memory_order_relaxed);
+
+                Logger::Error("StringId collision: \"{}\" and \"{}\" both hash to {:#018x}", entry.String, string, entry.Hash);
+                assert(false && "Two different strings have the same StringId");
+            }
+#endif
+        }
+
+        static void Insert(StringTableSlots& slots, const StringEntry& entry) noexcept {
+            auto index = static_cast<uint32_t>(entry.Hash) & slots.Mask;
+
+            while (slots.Slots[index].load(std::memory_order_relaxed) != nullptr) {
+                index = (index + 1) & slots.Mask;
+            }
+            slots.Slots[index].store(&entry, std::memory_order_release);
+        }
+
+        StringTableSlots* Grow(const StringTableSlots& slots) {
+            auto grown = std::make_unique<StringTableSlots>(slots.Capacity() * 2);
+
+            for (const auto& entry : m_entries) {
+                Insert(*grown, entry);
+            }
+
+            //Readers still probing the old array find everything that was in it before
+            m_slotHistory.push_back(std::move(grown));
+            m_slots.store(m_slotHistory.back().get(), std::memory_order_release);
+
+            return m_slotHistory.back().get();
+        }
+
+        //Copies the characters into chunks that are never freed, so the views handed out stay valid
+        std::string_view Store(std::string_view string) {
+            if (m_chunkOffset + string.size() > m_chunkSize) {
+                m_chunkSize   = std::max(CHUNK_SIZE, string.size());
+                m_chunkOffset = 0;
+                m_chunks.push_back(std::make_unique<char[]>(m_chunkSize));
+            }
+
+            auto* characters = m_chunks.back().get() + m_chunkOffset;
+            std::memcpy(characters, string.data(), string.size());
+
+            m_chunkOffset += string.size();
+            m_stringBytes += string.size();
+
+            return { characters, string.size() };
+        }
+
+        std::atomic<StringTableSlots*> m_slots{ nullptr };
+        std::vector<std::unique_ptr<StringTableSlots>> m_slotHistory;
+
+        //A deque never moves its elements when it grows at the back
+        std::deque<StringEntry> m_entries;
+
+        std::vector<std::unique_ptr<char[]>> m_chunks;
+        size_t m_chunkSize{ 0 };
+        size_t m_chunkOffset{ 0 };
+
+        uint32_t m_numStrings{ 0 };
+        size_t m_stringBytes{ 0 };
+        std::atomic<uint32_t> m_numCollisions{ 0 };
+
+        mutable std::mutex m_mutex;
+    };
+}
+
+StringId StringId::Intern(std::string_view string) {
+    return impl::StringTable::Get().Intern(string);
+}
+
+std::string_view StringId::GetString() const noexcept {
+    if (!IsValid()) {
+        return {};
+    }
+
+    if (const auto* entry = impl::StringTable::Get().Find(m_hash)) {
+        return entry->String;
+    }
+    return {};
+}
+
+StringTableStatistics Crystal::GetStringTableStatistics() noexcept {
+    return impl::StringTable::Get().GetStatistics();
+}
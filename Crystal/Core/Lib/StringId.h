@@ -0,0 +1,65 @@
+#pragma once
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace Crystal {
+    //64-bit FNV-1a, usable at compile time for string literals
+    [[nodiscard]] constexpr uint64_t HashString(std::string_view string) noexcept {
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        for (const auto character : string) {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 0x00000100000001B3ull;
+        }
+        return hash;
+    }
+
+    //Names a resource, cache entry or material by the hash of its string, comparing two ids is a single 64-bit compare.
+    //Ids of literals are computed at compile time, Intern also stores the string in a global table so it can be
+    //looked up again, e.g. for logging or to open the file an id names.
+    class StringId {
+    public:
+        constexpr StringId() noexcept = default;
+        constexpr explicit StringId(std::string_view string) noexcept : m_hash(HashString(string)) {}
+
+        //Interning a string twice returns the same id, debug builds report two strings with the same hash
+        [[nodiscard]] static StringId Intern(std::string_view string);
+
+        //Lock free, empty when the string was never interned
+        [[nodiscard]] std::string_view GetString() const noexcept;
+
+        [[nodiscard]] constexpr uint64_t GetHash() const noexcept { return m_hash; }
+        [[nodiscard]] constexpr bool IsValid() const noexcept { return m_hash != 0; }
+
+        [[nodiscard]] constexpr bool operator==(const StringId&) const noexcept  = default;
+        [[nodiscard]] constexpr auto operator<=>(const StringId&) const noexcept = default;
+    private:
+        uint64_t m_hash{ 0 };
+    };
+
+    struct StringTableStatistics {
+        uint32_t NumStrings;
+        uint32_t Capacity;
+        size_t StringBytes;
+
+        //Only counted in debug builds, release builds do not compare the strings
+        uint32_t NumCollisions;
+    };
+
+    [[nodiscard]] StringTableStatistics GetStringTableStatistics() noexcept;
+
+    namespace Literals {
+        [[nodiscard]] consteval StringId operator""_sid(const char* string, size_t length) noexcept {
+            return StringId(std::string_view(string, length));
+        }
+    }
+}
+
+//The id already is a well distributed hash
+template<>
+struct std::hash<Crystal::StringId> {
+    [[nodiscard]] size_t operator()(Crystal::StringId id) const noexcept { return static_cast<size_t>(id.GetHash()); }
+};
@@ -0,0 +1,117 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+using namespace Crystal;
+
+uint32_t ThreadPool::GetDefaultThreadCount() noexcept {
+    return std::max(std::thread::hardware_concurrency(), 2u) - 1;
+}
+
+ThreadPool::ThreadPool(uint32_t numThreads) {
+    m_workers.reserve(numThreads);
+
+    for (uint32_t i = 0; i < numThreads; i++) {
+        m_workers.emplace_back([this](std::stop_token stopToken) { WorkerLoop(stopToken); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    for (auto& worker : m_workers) {
+        worker.request_stop();
+    }
+    m_condition.notify_all();
+    m_workers.clear();
+}
+
+void ThreadPool::Enqueue(std::move_only_function<void()> task) {
+    {
+        std::scoped_lock lock(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+void ThreadPool::WorkerLoop(std::stop_token stopToken) {
+    while (true) {
+        std::move_only_function<void()> task;
+        {
+            std::unique_lock lock(m_mutex);
+
+            //Returns false only once a stop was requested and nothing is left to do
+            if (!m_condition.wait(lock, stopToken, [this] { return !m_tasks.empty(); })) {
+                return;
+            }
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+
+    //A few chunks per thread keep uneven work balanced without contending on the counter for every index
+    const auto numHelpers = std::min<size_t>(m_workers.size(), count - 1);
+    const auto chunkSize  = std::max<size_t>(count / ((numHelpers + 1) * 4), 1);
+
+    std::atomic<size_t> nextIndex{ 0 };
+    size_t numRunning{ numHelpers };
+    std::mutex runningMutex;
+    std::condition_variable helpersDone;
+    std::atomic<bool> failed{ false };
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    const auto run = [&] {
+        while (!failed.load(std::memory_order_relaxed)) {
+            const auto first = nextIndex.fetch_add(chunkSize, std::memory_order_relaxed);
+
+            if (first >= count) {
+                break;
+            }
+
+            try {
+                for (auto index = first; index < std::min(first + chunkSize, count); index++) {
+                    body(index);
+                }
+            }
+            catch (...) {
+                std::scoped_lock lock(exceptionMutex);
+
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    for (size_t i = 0; i < numHelpers; i++) {
+        Enqueue([&] {
+            run();
+
+            //Notified under the lock, the caller cannot return and destroy the state before this helper is done with it
+            std::scoped_lock lock(runningMutex);
+
+            if (--numRunning == 0) {
+                helpersDone.notify_one();
+            }
+        });
+    }
+
+    run();
+
+    //Helpers that never got to run still have to finish before the state on this stack goes away
+    {
+        std::unique_lock lock(runningMutex);
+        helpersDone.wait(lock, [&numRunning] { return numRunning == 0; });
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Crystal {
+    //Fixed set of worker threads sharing one task queue.
+    //Meant for coarse work such as importing assets, not for per-frame jobs with thousands of tiny tasks.
+    class ThreadPool {
+    public:
+        //Leaves one hardware thread for the caller, which takes part in ParallelFor
+        [[nodiscard]] static uint32_t GetDefaultThreadCount() noexcept;
+
+        explicit ThreadPool(uint32_t numThreads = GetDefaultThreadCount());
+        ThreadPool(const ThreadPool&)            = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        //Finishes the queued tasks before the workers are joined
+        ~ThreadPool();
+
+        template<class Function>
+        [[nodiscard]] std::future<std::invoke_result_t<Function>> Submit(Function&& function) {
+            std::packaged_task<std::invoke_result_t<Function>()> task(std::forward<Function>(function));
+            auto future = task.get_future();
+
+            Enqueue(std::move(task));
+            return future;
+        }
+
+        //Calls body(index) for every index in [0, count) and returns once all calls are done. The calling thread helps.
+        //Indices are handed out in chunks in no particular order, results have to be written by index to stay deterministic.
+        //The first exception thrown by the body is rethrown on the calling thread after the remaining indices were skipped.
+        void ParallelFor(size_t count, const std::function<void(size_t)>& body);
+
+        [[nodiscard]] uint32_t GetNumThreads() const noexcept { return static_cast<uint32_t>(m_workers.size()); }
+    private:
+        void Enqueue(std::move_only_function<void()> task);
+        void WorkerLoop(std::stop_token stopToken);
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::deque<std::move_only_function<void()>> m_tasks;
+
+        //Declared last so the workers are stopped and joined before the queue they use is destroyed
+        std::vector<std::jthread> m_workers;
+    };
+}
@@ -16,7 +16,7 @@ namespace Crystal {
 
 		void Push(T value) noexcept {
             std::scoped_lock lock(m_mutex);
-            m_queue.push();
+            m_queue.push(std::move(value));
         }
         [[nodiscard]] bool TryPop(T& value) noexcept {
             std::scoped_lock lock(m_mutex);
@@ -25,7 +25,7 @@ namespace Crystal {
                 return false;
             }
 
-            value = m_queue.front();
+            value = std::move(m_queue.front());
             m_queue.pop();
 
             return true;
@@ -41,6 +41,6 @@ namespace Crystal {
         }
 	private:
 		std::queue<T> m_queue;
-		std::mutex m_mutex;
+		mutable std::mutex m_mutex;
 	};
 }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "LogLevels.h"
 #include "Sink.h"
 #include "Core/Utils/LogUtils.h"
+#include "Core/Memory/MemoryTracker.h"
 
 namespace Crystal{
     namespace detail{
@@ -59,59 +60,60 @@ namespace Crystal{
             std::erase_if(Get().m_sinks, [](const auto& sink) { return typeid(*sink) == typeid(T); });
         }
 
-        static constexpr void SetDefaultTag(std::string_view newTag) noexcept { Get().m_tag = newTag; }
-        static constexpr std::string_view GetDefaultTag() noexcept { return Get().m_tag; }
+        static void SetDefaultTag(std::string_view newTag) noexcept { Get().m_tag = newTag; }
+        static std::string_view GetDefaultTag() noexcept { return Get().m_tag; }
 
-        constexpr void Log(LogLevel lvl, const detail::log_fmt& fmt, auto&&... args) const noexcept {
+        void Log(LogLevel lvl, const detail::log_fmt& fmt, auto&&... args) const noexcept {
             std::scoped_lock lock(m_loggingMutex);
+            ScopedMemoryTag memoryTag(MemoryTag::Logging);
 
-            const std::string message = std::format("{}{}", m_tag, std::vformat(fmt.msg, std::make_format_args(std::forward<decltype(args)>(args)...)));
+            const std::string message = std::format("{}{}", m_tag, std::vformat(fmt.msg, std::make_format_args(args...)));
 
             for (const auto& sink : m_sinks) {
                 sink->Emit(message, lvl, fmt.loc);
             }
         }
 
-        static constexpr void Info(detail::log_fmt fmt, auto&& args...) {
-            Get().Log(LogLevel::info, fmt, std::forward<decltype(args)>(args));
+        static void Info(detail::log_fmt fmt, auto&&... args) {
+            Get().Log(LogLevel::info, fmt, std::forward<decltype(args)>(args)...);
         }
 
-        static constexpr void Info(std::string_view msg, std::source_location loc = std::source_location::current()) {
+        static void Info(std::string_view msg, std::source_location loc = std::source_location::current()) {
             Info(detail::log_fmt{"{}", loc}, msg);
         }
 
-        static constexpr void Warning(detail::log_fmt fmt, auto&& args...) {
-            Get().Log(LogLevel::warning, fmt, std::forward<decltype(args)>(args));
+        static void Warning(detail::log_fmt fmt, auto&&... args) {
+            Get().Log(LogLevel::warning, fmt, std::forward<decltype(args)>(args)...);
         }
 
-        static constexpr void Warning(std::string_view msg,
+        static void Warning(std::string_view msg,
                                       std::source_location loc = std::source_location::current()) {
             Warning(detail::log_fmt{"{}", loc}, msg);
         }
 
-        static constexpr void Error(detail::log_fmt fmt, auto&& args...) {
-            Get().Log(LogLevel::error, fmt, std::forward<decltype(args)>(args));
+        static void Error(detail::log_fmt fmt, auto&&... args) {
+            Get().Log(LogLevel::error, fmt, std::forward<decltype(args)>(args)...);
         }
 
-        static constexpr void Error(std::string_view msg, std::source_location loc = std::source_location::current()) {
+        static void Error(std::string_view msg, std::source_location loc = std::source_location::current()) {
             Error(detail::log_fmt{"{}", loc}, msg);
         }
 
-        static constexpr void Debug(detail::log_fmt fmt, auto&& args...) {
+        static void Debug(detail::log_fmt fmt, auto&&... args) {
 #if _DEBUG
-            Get().Log(LogLevel::debug, fmt, std::forward<decltype(args)>(args));
+            Get().Log(LogLevel::debug, fmt, std::forward<decltype(args)>(args)...);
 #endif
         }
 
-        static constexpr void Debug(std::string_view msg, std::source_location loc = std::source_location::current()) {
+        static void Debug(std::string_view msg, std::source_location loc = std::source_location::current()) {
             Debug(detail::log_fmt{"{}", loc}, msg);
         }
 
-        static void Trace(detail::log_fmt fmt, auto&& args...) {
+        static void Trace(detail::log_fmt fmt, auto&&... args) {
             auto& logger = Get();
 
             logger.m_tag.append(std::format(" {}", log_utils::parse_log_tag(fmt.loc.file_name())));
-            logger.Log(LogLevel::trace, fmt, std::forward<decltype(args)>(args));
+            logger.Log(LogLevel::trace, fmt, std::forward<decltype(args)>(args)...);
         }
 
         static void Trace(std::string_view msg, std::source_location loc = std::source_location::current()) {
@@ -6,6 +6,7 @@
 namespace Crystal {
 	class ISink {
 	public:
+		virtual ~ISink() = default;
 		virtual void Emit(std::string_view message, LogLevel lvl, const std::source_location& loc = std::source_location::current()) noexcept = 0;
 	};
 }
@@ -23,7 +23,7 @@ namespace Crystal::Math {
     concept Number = (std::signed_integral<T> || std::floating_point<T>);
 
     template<typename T>
-    concept UnsignedNumber = std::unsigned_integral<T> && std::_Boolean_testable<T>;
+    concept UnsignedNumber = std::unsigned_integral<T>;
 
     struct MathConstants {
         static constexpr auto EPSILON    = std::numeric_limits<float>::epsilon();
@@ -0,0 +1,161 @@
+#include "Packing.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Crystal::Math {
+    namespace {
+        [[nodiscard]] float SignNotZero(float value) noexcept {
+            return value >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        [[nodiscard]] Vector3 NormalizeOr(const Vector3& vector, const Vector3& fallback) noexcept {
+            const auto length = std::sqrt(vector.x * vector.x + vector.y * vector.y + vector.z * vector.z);
+            return length > 1e-20f ? vector / length : fallback;
+        }
+
+    }
+
+    std::array<float, 2> EncodeOctahedral(const Vector3& direction) noexcept {
+        const auto sum = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+
+        if (sum == 0.0f) [[unlikely]] {
+            return { 0.0f, 0.0f };
+        }
+
+        const auto u = direction.x / sum;
+        const auto v = direction.y / sum;
+
+        if (direction.z >= 0.0f) {
+            return { u, v };
+        }
+        return { (1.0f - std::abs(v)) * SignNotZero(u), (1.0f - std::abs(u)) * SignNotZero(v) };
+    }
+
+    Vector3 DecodeOctahedral(float u, float v) noexcept {
+        const auto z = 1.0f - std::abs(u) - std::abs(v);
+
+        const Vector3 direction = z >= 0.0f
+            ? Vector3(u, v, z)
+            : Vector3((1.0f - std::abs(v)) * SignNotZero(u), (1.0f - std::abs(u)) * SignNotZero(v), z);
+
+        return NormalizeOr(direction, Vector3(0.0f, 0.0f, 1.0f));
+    }
+
+    std::array<int16_t, 2> PackOctahedral(const Vector3& direction) noexcept {
+        const auto [u, v] = EncodeOctahedral(direction);
+        const auto unit   = NormalizeOr(direction, Vector3(0.0f, 0.0f, 1.0f));
+
+        const std::array<float, 2> lower{ std::floor(u * 32767.0f), std::floor(v * 32767.0f) };
+
+        //Compared by distance, a dot product this close to 1 does not resolve the difference in float
+        std::array<int16_t, 2> best{};
+        float bestDistance = 5.0f;
+
+        for (uint32_t corner = 0; corner < 4; corner++) {
+            const auto qu = std::min(std::max(lower[0] + static_cast<float>(corner & 1), -32767.0f), 32767.0f);
+            const auto qv = std::min(std::max(lower[1] + static_cast<float>(corner >> 1), -32767.0f), 32767.0f);
+
+            const std::array<int16_t, 2> candidate{ static_cast<int16_t>(qu), static_cast<int16_t>(qv) };
+            const auto difference = UnpackOctahedral(candidate) - unit;
+            const auto distance   = Vector3::Dot(difference, difference);
+
+            if (distance < bestDistance) {
+                bestDistance = distance;
+                best         = candidate;
+            }
+        }
+        return best;
+    }
+
+    Vector3 UnpackOctahedral(std::array<int16_t, 2> packed) noexcept {
+        return DecodeOctahedral(UnpackSnorm16(packed[0]), UnpackSnorm16(packed[1]));
+    }
+
+    Vector3 OrthogonalizeTangent(const Vector3& normal, const Vector3& tangent) noexcept {
+        const auto projected = tangent - normal * Vector3::Dot(normal, tangent);
+        const auto length    = std::sqrt(Vector3::Dot(projected, projected));
+
+        //Vertices without texture coordinates have no tangent, any direction in the plane of the normal will do
+        if (length <= 1e-6f * std::sqrt(Vector3::Dot(tangent, tangent)) || length <= 1e-20f) {
+            const auto axis = std::abs(normal.x) < 0.9f ? Vector3(1.0f, 0.0f, 0.0f) : Vector3(0.0f, 1.0f, 0.0f);
+            return NormalizeOr(Vector3::Cross(axis, normal), Vector3(1.0f, 0.0f, 0.0f));
+        }
+        return projected / length;
+    }
+
+    std::array<int16_t, 4> PackTangentFrame(const Vector3& normal, const Vector3& tangent, const Vector3& bitangent) noexcept {
+        const auto n = NormalizeOr(normal, Vector3(0.0f, 0.0f, 1.0f));
+
+        const auto t = OrthogonalizeTangent(n, tangent);
+        const auto b = Vector3::Cross(n, t);
+
+        const auto handedness = Vector3::Dot(b, bitangent) < 0.0f ? -1.0f : 1.0f;
+
+        //Rotation matrix with t, b and n as its columns
+        const float m00 = t.x, m01 = b.x, m02 = n.x;
+        const float m10 = t.y, m11 = b.y, m12 = n.y;
+        const float m20 = t.z, m21 = b.z, m22 = n.z;
+
+        std::array<float, 4> q;
+        const auto trace = m00 + m11 + m22;
+
+        if (trace > 0.0f) {
+            const auto s = std::sqrt(trace + 1.0f) * 2.0f;
+            q = { (m21 - m12) / s, (m02 - m20) / s, (m10 - m01) / s, 0.25f * s };
+        }
+        else if (m00 > m11 && m00 > m22) {
+            const auto s = std::sqrt(1.0f + m00 - m11 - m22) * 2.0f;
+            q = { 0.25f * s, (m01 + m10) / s, (m02 + m20) / s, (m21 - m12) / s };
+        }
+        else if (m11 > m22) {
+            const auto s = std::sqrt(1.0f + m11 - m00 - m22) * 2.0f;
+            q = { (m01 + m10) / s, 0.25f * s, (m12 + m21) / s, (m02 - m20) / s };
+        }
+        else {
+            const auto s = std::sqrt(1.0f + m22 - m00 - m11) * 2.0f;
+            q = { (m02 + m20) / s, (m12 + m21) / s, 0.25f * s, (m10 - m01) / s };
+        }
+
+        const auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        const auto sign   = q[3] < 0.0f ? -1.0f : 1.0f;
+
+        for (auto& component : q) {
+            component *= sign / length;
+        }
+
+        //q and -q are the same rotation, so w can be made positive and carry the handedness instead
+        constexpr float MIN_W = 1.0f / 32767.0f;
+
+        if (q[3] < MIN_W) {
+            const auto scale = std::sqrt(1.0f - MIN_W * MIN_W) / std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2]);
+
+            q = { q[0] * scale, q[1] * scale, q[2] * scale, MIN_W };
+        }
+
+        return {
+            PackSnorm16(q[0] * handedness),
+            PackSnorm16(q[1] * handedness),
+            PackSnorm16(q[2] * handedness),
+            PackSnorm16(q[3] * handedness)
+        };
+    }
+
+    TangentFrame UnpackTangentFrame(std::array<int16_t, 4> packed) noexcept {
+        std::array<float, 4> q{ UnpackSnorm16(packed[0]), UnpackSnorm16(packed[1]), UnpackSnorm16(packed[2]), UnpackSnorm16(packed[3]) };
+
+        const auto handedness = q[3] < 0.0f ? -1.0f : 1.0f;
+        const auto length     = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+
+        for (auto& component : q) {
+            component /= length;
+        }
+
+        const auto [x, y, z, w] = q;
+
+        const Vector3 tangent(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+        const Vector3 normal(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y));
+
+        return { normal, tangent, Vector3::Cross(normal, tangent) * handedness };
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <cstdint>
+#include "Vector3.h"
+
+namespace Crystal::Math {
+    //IEEE 754 binary16 with round to nearest even, values past the largest half become infinity and NaN stays NaN
+    [[nodiscard]] constexpr uint16_t FloatToHalf(float value) noexcept {
+        const auto bits    = std::bit_cast<uint32_t>(value);
+        const auto sign    = static_cast<uint16_t>((bits >> 16) & 0x8000);
+        const auto absBits = bits & 0x7FFFFFFF;
+
+        if (absBits >= 0x7F800000) {
+            return sign | 0x7C00 | (absBits > 0x7F800000 ? 0x200 : 0);
+        }
+
+        //Everything from 65520 up rounds to infinity
+        if (absBits >= 0x477FF000) {
+            return sign | 0x7C00;
+        }
+
+        //Below the smallest normal half, the mantissa is shifted into a denormal
+        if (absBits < 0x38800000) {
+            const auto exponent = absBits >> 23;
+            const auto shift    = 126 - exponent;
+
+            if (exponent == 0 || shift > 24) {
+                return sign;
+            }
+
+            const auto mantissa  = (absBits & 0x7FFFFF) | 0x800000;
+            const auto remainder = mantissa & ((1u << shift) - 1);
+            const auto halfway   = 1u << (shift - 1);
+
+            auto denormal = mantissa >> shift;
+            denormal     += remainder > halfway || (remainder == halfway && (denormal & 1));
+
+            return sign | static_cast<uint16_t>(denormal);
+        }
+
+        const auto rounded = absBits + 0xFFF + ((absBits >> 13) & 1);
+        return sign | static_cast<uint16_t>((rounded - 0x38000000) >> 13);
+    }
+
+    [[nodiscard]] constexpr float HalfToFloat(uint16_t half) noexcept {
+        const auto sign     = static_cast<uint32_t>(half & 0x8000) << 16;
+        const auto exponent = static_cast<uint32_t>(half >> 10) & 0x1F;
+        const auto mantissa = static_cast<uint32_t>(half) & 0x3FF;
+
+        if (exponent == 0x1F) {
+            return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+        }
+
+        if (exponent == 0) {
+            const auto denormal = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+            return sign ? -denormal : denormal;
+        }
+        return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+    }
+
+    //Same conversions as the SNORM and UNORM DXGI formats, clamped and rounded to nearest
+    [[nodiscard]] constexpr int16_t PackSnorm16(float value) noexcept {
+        const auto clamped = value < -1.0f ? -1.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<int16_t>(clamped * 32767.0f + (clamped >= 0.0f ? 0.5f : -0.5f));
+    }
+
+    [[nodiscard]] constexpr float UnpackSnorm16(int16_t value) noexcept {
+        const auto unpacked = static_cast<float>(value) / 32767.0f;
+        return unpacked < -1.0f ? -1.0f : unpacked;
+    }
+
+    [[nodiscard]] constexpr uint16_t PackUnorm16(float value) noexcept {
+        const auto clamped = value < 0.0f ? 0.0f : (value > 1.0f ? 1.0f : value);
+        return static_cast<uint16_t>(clamped * 65535.0f + 0.5f);
+    }
+
+    [[nodiscard]] constexpr float UnpackUnorm16(uint16_t value) noexcept {
+        return static_cast<float>(value) / 65535.0f;
+    }
+
+    //Unit vector folded onto the octahedron and unwrapped into [-1, 1]^2, the lower half covers the corners
+    [[nodiscard]] std::array<float, 2> EncodeOctahedral(const Vector3& direction) noexcept;
+    [[nodiscard]] Vector3 DecodeOctahedral(float u, float v) noexcept;
+
+    //Quantized to two snorm16, out of the four nearest quantized points the one that decodes closest is kept
+    [[nodiscard]] std::array<int16_t, 2> PackOctahedral(const Vector3& direction) noexcept;
+    [[nodiscard]] Vector3 UnpackOctahedral(std::array<int16_t, 2> packed) noexcept;
+
+    //Tangent made orthogonal to the unit normal and normalized, any orthogonal direction when it is missing or parallel
+    [[nodiscard]] Vector3 OrthogonalizeTangent(const Vector3& normal, const Vector3& tangent) noexcept;
+
+    struct TangentFrame {
+        Vector3 Normal;
+        Vector3 Tangent;
+        Vector3 Bitangent;
+    };
+
+    //Tangent frame as a unit quaternion in four snorm16, the rotation taking x, y and z to tangent, normal x tangent
+    //and normal. The sign of w holds the handedness of the bitangent, w is kept at least one step away from 0 so the
+    //sign survives quantization. The tangent is orthogonalized against the normal and made up when it is missing.
+    [[nodiscard]] std::array<int16_t, 4> PackTangentFrame(const Vector3& normal, const Vector3& tangent, const Vector3& bitangent) noexcept;
+    [[nodiscard]] TangentFrame UnpackTangentFrame(std::array<int16_t, 4> packed) noexcept;
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <cmath>
+#include <cstdint>
 #include "MathFunctions.h"
 
 namespace Crystal::Math {
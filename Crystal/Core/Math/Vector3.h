@@ -11,7 +11,7 @@ namespace Crystal::Math {
     class Vector3 {
     public:
         constexpr Vector3() noexcept : x(0), y(0), z(0) {}
-        constexpr Vector3(float x, float y, float z) noexcept : x(x), y(y), z(0) {}
+        constexpr Vector3(float x, float y, float z) noexcept : x(x), y(y), z(z) {}
         constexpr Vector3(float v) noexcept : x(v), y(v), z(v) {}
         constexpr Vector3(const Vector3& rhs) noexcept {
             x = rhs.x;
@@ -176,7 +176,7 @@ namespace Crystal::Math {
             return {
                 v1.y * v2.z - v2.y * v1.z,
                 -(v1.x * v2.z - v2.x * v1.z),
-                v1.x * v2.y - v2.x * v2.y
+                v1.x * v2.y - v2.x * v1.y
             };
         }
         [[nodiscard]] static constexpr inline Vector3 Normalize(const Vector3& rhs)                     noexcept { return rhs.Normalized(); }
@@ -193,7 +193,7 @@ namespace Crystal::Math {
         float z;
     };
 
-    inline Vector3 operator*(float val, const Vector3& rhs) { return rhs * val; }
+    constexpr Vector3 operator*(float val, const Vector3& rhs) noexcept { return rhs * val; }
 
     static constexpr auto infinity = std::numeric_limits<float>::infinity();
 
@@ -0,0 +1,191 @@
+#include "BitmapRangeAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint64_t ALL_FREE = ~uint64_t{ 0 };
+
+    //Bits [first, first + count) of a word, count has to be in [1, 64]
+    [[nodiscard]] constexpr uint64_t BitRange(uint32_t first, uint32_t count) noexcept {
+        const auto bits = count == 64 ? ALL_FREE : (uint64_t{ 1 } << count) - 1;
+        return bits << first;
+    }
+
+    //Keeps only the bits that start a run of at least count set bits
+    [[nodiscard]] constexpr uint64_t RunStarts(uint64_t word, uint32_t count) noexcept {
+        uint32_t length = 1;
+
+        while (length < count && word != 0) {
+            const auto step = std::min(length, count - length);
+            word           &= word >> step;
+            length         += step;
+        }
+        return word;
+    }
+}
+
+BitmapRangeAllocator::BitmapRangeAllocator(uint32_t capacity)
+    :
+    m_capacity(capacity),
+    m_freeCount(capacity),
+    m_words((capacity + 63) / 64, impl::ALL_FREE),
+    m_summary((m_words.size() + 63) / 64, 0)
+{
+    if (const auto tail = capacity % 64) {
+        m_words.back() = impl::BitRange(0, tail);
+    }
+
+    for (uint32_t word = 0; word < m_words.size(); word++) {
+        if (m_words[word] != 0) {
+            m_summary[word / 64] |= uint64_t{ 1 } << (word % 64);
+        }
+    }
+}
+
+std::optional<uint32_t> BitmapRangeAllocator::Allocate(uint32_t count) noexcept {
+    if (count == 0 || count > m_freeCount) {
+        return {};
+    }
+
+    const auto offset = count == 1 ? FindSlot() : FindRange(count);
+
+    if (offset) {
+        MarkRange(*offset, count, false);
+        m_freeCount -= count;
+    }
+    return offset;
+}
+
+void BitmapRangeAllocator::Free(uint32_t offset, uint32_t count) noexcept {
+    assert(offset + count <= m_capacity && "Range is out of bounds");
+
+    MarkRange(offset, count, true);
+    m_freeCount += count;
+}
+
+void BitmapRangeAllocator::FreeDeferred(uint32_t offset, uint32_t count, uint64_t fenceValue) {
+    assert((m_deferred.empty() || m_deferred.back().FenceValue <= fenceValue) && "Fence values have to increase");
+
+    m_deferred.push_back({ .Offset = offset, .Count = count, .FenceValue = fenceValue });
+    m_deferredCount += count;
+}
+
+void BitmapRangeAllocator::ReleaseCompleted(uint64_t completedFenceValue) noexcept {
+    while (!m_deferred.empty() && m_deferred.front().FenceValue <= completedFenceValue) {
+        const auto [offset, count, fenceValue] = m_deferred.front();
+
+        Free(offset, count);
+        m_deferredCount -= count;
+        m_deferred.pop_front();
+    }
+}
+
+std::optional<uint32_t> BitmapRangeAllocator::FindSlot() const noexcept {
+    for (uint32_t summary = 0; summary < m_summary.size(); summary++) {
+        if (m_summary[summary] != 0) {
+            const auto word = summary * 64 + static_cast<uint32_t>(std::countr_zero(m_summary[summary]));
+            return word * 64 + static_cast<uint32_t>(std::countr_zero(m_words[word]));
+        }
+    }
+    return {};
+}
+
+//First fit over the slot bitmap, free runs are tracked across word boundaries
+std::optional<uint32_t> BitmapRangeAllocator::FindRange(uint32_t count) const noexcept {
+    uint32_t runStart  = 0;
+    uint32_t runLength = 0;
+
+    for (uint32_t index = 0; index < m_words.size(); index++) {
+        const auto word = m_words[index];
+        const auto base = index * 64;
+
+        if (word == impl::ALL_FREE) {
+            if (runLength == 0) {
+                runStart = base;
+            }
+
+            runLength += 64;
+        }
+        else if (word == 0) {
+            runLength = 0;
+            continue;
+        }
+        else {
+            //The run coming from the previous words may end in the low bits of this one
+            const auto trailing = static_cast<uint32_t>(std::countr_one(word));
+
+            if (runLength > 0 && runLength + trailing >= count) {
+                return runStart;
+            }
+
+            if (count <= 64) {
+                if (const auto starts = impl::RunStarts(word, count)) {
+                    return base + static_cast<uint32_t>(std::countr_zero(starts));
+                }
+            }
+
+            //Only the free bits at the top of the word can start a run that continues into the next one
+            runLength = static_cast<uint32_t>(std::countl_one(word));
+            runStart  = base + 64 - runLength;
+        }
+
+        if (runLength >= count) {
+            return runStart;
+        }
+    }
+    return {};
+}
+
+void BitmapRangeAllocator::MarkRange(uint32_t offset, uint32_t count, bool free) noexcept {
+    while (count > 0) {
+        const auto index = offset / 64;
+        const auto first = offset % 64;
+        const auto bits  = std::min(count, 64 - first);
+        const auto mask  = impl::BitRange(first, bits);
+
+        auto& word = m_words[index];
+
+        if (free) {
+            assert((word & mask) == 0 && "Slot is freed twice");
+            word |= mask;
+        }
+        else {
+            word &= ~mask;
+        }
+
+        const auto summaryBit = uint64_t{ 1 } << (index % 64);
+
+        if (word != 0) {
+            m_summary[index / 64] |= summaryBit;
+        }
+        else {
+            m_summary[index / 64] &= ~summaryBit;
+        }
+
+        offset += bits;
+        count  -= bits;
+    }
+}
+
+bool BitmapRangeAllocator::Validate() const noexcept {
+    uint32_t freeCount = 0;
+
+    for (uint32_t index = 0; index < m_words.size(); index++) {
+        const bool hasFree = (m_summary[index / 64] >> (index % 64)) & 1;
+
+        if (hasFree != (m_words[index] != 0)) {
+            return false;
+        }
+        freeCount += static_cast<uint32_t>(std::popcount(m_words[index]));
+    }
+
+    //Slots past the capacity must never look free
+    if (const auto tail = m_capacity % 64; tail != 0 && (m_words.back() & ~impl::BitRange(0, tail)) != 0) {
+        return false;
+    }
+    return freeCount == m_freeCount;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Crystal {
+    //Allocates ranges of consecutive slots, e.g. descriptors in a descriptor heap.
+    //Every slot is one bit, a summary bitmap on top tells which words still have free slots, so single slots are
+    //found without scanning full words. Freed ranges can be deferred until a fence value has been reached,
+    //which keeps slots the GPU may still read from being handed out again.
+    class BitmapRangeAllocator {
+    public:
+        explicit BitmapRangeAllocator(uint32_t capacity);
+
+        [[nodiscard]] std::optional<uint32_t> Allocate(uint32_t count = 1) noexcept;
+        void Free(uint32_t offset, uint32_t count = 1) noexcept;
+
+        //The range becomes available again once ReleaseCompleted is called with a value of at least fenceValue
+        void FreeDeferred(uint32_t offset, uint32_t count, uint64_t fenceValue);
+        void ReleaseCompleted(uint64_t completedFenceValue) noexcept;
+
+        [[nodiscard]] uint32_t GetCapacity()  const noexcept { return m_capacity; }
+        [[nodiscard]] uint32_t GetFreeCount() const noexcept { return m_freeCount; }
+        [[nodiscard]] uint32_t GetDeferredCount() const noexcept { return m_deferredCount; }
+        [[nodiscard]] bool IsFree(uint32_t slot) const noexcept { return (m_words[slot / 64] >> (slot % 64)) & 1; }
+
+        //Checks that the summary and the free count match the slot bitmap, meant for debugging and fuzzing
+        [[nodiscard]] bool Validate() const noexcept;
+    private:
+        struct DeferredRange {
+            uint32_t Offset;
+            uint32_t Count;
+            uint64_t FenceValue;
+        };
+
+        [[nodiscard]] std::optional<uint32_t> FindSlot() const noexcept;
+        [[nodiscard]] std::optional<uint32_t> FindRange(uint32_t count) const noexcept;
+        void MarkRange(uint32_t offset, uint32_t count, bool free) noexcept;
+
+        uint32_t m_capacity;
+        uint32_t m_freeCount;
+        uint32_t m_deferredCount{ 0 };
+
+        //A set bit is a free slot, bits past the capacity are never set
+        std::vector<uint64_t> m_words;
+
+        //A set bit means the word has at least one free slot
+        std::vector<uint64_t> m_summary;
+
+        std::deque<DeferredRange> m_deferred;
+    };
+}
@@ -0,0 +1,190 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <new>
+
+using namespace Crystal;
+
+namespace impl {
+    std::atomic_uint64_t frameIndex{ 0 };
+
+    constexpr size_t BLOCK_ALIGNMENT = 64;
+
+    [[nodiscard]] constexpr uintptr_t AlignUp(uintptr_t value, size_t alignment) noexcept {
+        return (value + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+    }
+}
+
+FrameArena::FrameArena(size_t blockSize)
+    :
+    m_frameIndex(impl::frameIndex.load(std::memory_order_acquire))
+{
+    //The block list only grows when the arena overflows, so it must not be the one allocating every frame
+    m_blocks.reserve(8);
+    m_blocks.emplace_back(AllocateBlock(blockSize));
+    m_blockAllocations++;
+}
+
+FrameArena::~FrameArena() {
+    for (const auto& block : m_blocks) {
+        FreeBlock(block);
+    }
+}
+
+FrameArena& FrameArena::ForCurrentThread() noexcept {
+    thread_local FrameArena arena;
+
+    arena.SyncWithFrame();
+    return arena;
+}
+
+void FrameArena::NextFrame() noexcept {
+    impl::frameIndex.fetch_add(1, std::memory_order_acq_rel);
+}
+
+uint64_t FrameArena::GetFrameIndex() noexcept {
+    return impl::frameIndex.load(std::memory_order_acquire);
+}
+
+void FrameArena::SyncWithFrame() noexcept {
+    const auto frameIndex = impl::frameIndex.load(std::memory_order_acquire);
+
+    if (m_frameIndex == frameIndex) [[likely]] {
+        return;
+    }
+
+    //A marker that is still alive means somebody still uses memory from the last frame, resetting would pull it away under them
+    if (m_activeMarkers == 0) {
+        Reset();
+    }
+    m_frameIndex = frameIndex;
+}
+
+void* FrameArena::AllocateSlow(size_t sizeInBytes, size_t alignment) {
+    UpdateHighWaterMark();
+
+    //Blocks left over from before a rewind are reused before new ones are allocated
+    if (m_currentBlock + 1 < m_blocks.size()) {
+        m_previousBlocksSize += m_blocks[m_currentBlock].Size;
+        m_currentBlock++;
+        m_offset = 0;
+
+        return Allocate(sizeInBytes, alignment);
+    }
+
+    const auto blockSize = std::max(m_blocks.back().Size, sizeInBytes + std::max(alignment, impl::BLOCK_ALIGNMENT));
+
+    m_blocks.emplace_back(AllocateBlock(blockSize));
+    m_blockAllocations++;
+
+    m_previousBlocksSize += m_blocks[m_currentBlock].Size;
+    m_currentBlock        = static_cast<uint32_t>(m_blocks.size() - 1);
+    m_offset              = 0;
+
+    return Allocate(sizeInBytes, alignment);
+}
+
+void FrameArena::Deallocate(void* ptr, size_t sizeInBytes) noexcept {
+    const auto& block  = m_blocks[m_currentBlock];
+    const auto address = static_cast<std::byte*>(ptr);
+
+    if (address + sizeInBytes == block.Data + m_offset) {
+        UpdateHighWaterMark();
+        m_offset = static_cast<size_t>(address - block.Data);
+    }
+}
+
+void FrameArena::Rewind(const FrameArenaMarker& marker) noexcept {
+    UpdateHighWaterMark();
+
+    assert(marker.Block < m_currentBlock || (marker.Block == m_currentBlock && marker.Offset <= m_offset));
+
+    m_currentBlock       = marker.Block;
+    m_offset             = marker.Offset;
+    m_previousBlocksSize = 0;
+
+    for (uint32_t i = 0; i < m_currentBlock; i++) {
+        m_previousBlocksSize += m_blocks[i].Size;
+    }
+}
+
+void FrameArena::Reset() noexcept {
+    UpdateHighWaterMark();
+
+    //Fold the overflow blocks into one block that fits the whole frame, the next frame with the same workload
+    //then runs without allocating. Once the limit is reached the overflow blocks are kept and reused instead.
+    if (m_blocks.size() > 1) {
+        const auto blockSize = std::min(std::bit_ceil(m_frameHighWaterMark), MAX_BLOCK_SIZE);
+
+        if (blockSize > m_blocks.front().Size) {
+            try {
+                const auto block = AllocateBlock(blockSize);
+
+                for (const auto& oldBlock : m_blocks) {
+                    FreeBlock(oldBlock);
+                }
+
+                m_blocks.clear();
+                m_blocks.emplace_back(block);
+                m_blockAllocations++;
+            }
+            catch (const std::bad_alloc&) {
+                //Keep the existing blocks, they still work, just not as efficiently
+            }
+        }
+    }
+
+    m_currentBlock       = 0;
+    m_offset             = 0;
+    m_previousBlocksSize = 0;
+    m_frameHighWaterMark = 0;
+}
+
+//The fast path only bumps the offset, the high water marks are updated whenever the offset is about to move back or to another block
+void FrameArena::UpdateHighWaterMark() noexcept {
+    m_frameHighWaterMark = std::max(m_frameHighWaterMark, GetUsedBytes());
+    m_highWaterMark      = std::max(m_highWaterMark, m_frameHighWaterMark);
+}
+
+size_t FrameArena::GetCapacity() const noexcept {
+    size_t capacity = 0;
+
+    for (const auto& block : m_blocks) {
+        capacity += block.Size;
+    }
+    return capacity;
+}
+
+FrameArena::Block FrameArena::AllocateBlock(size_t sizeInBytes) {
+    const auto size = impl::AlignUp(sizeInBytes, impl::BLOCK_ALIGNMENT);
+
+    return {
+        .Data = static_cast<std::byte*>(::operator new(size, std::align_val_t{ impl::BLOCK_ALIGNMENT })),
+        .Size = size
+    };
+}
+
+void FrameArena::FreeBlock(const Block& block) noexcept {
+    ::operator delete(block.Data, block.Size, std::align_val_t{ impl::BLOCK_ALIGNMENT });
+}
+
+void* FrameArena::Resource::do_allocate(size_t bytes, size_t alignment) {
+    return m_arena->Allocate(bytes, alignment);
+}
+
+void FrameArena::Resource::do_deallocate(void* ptr, size_t bytes, size_t) {
+    m_arena->Deallocate(ptr, bytes);
+}
+
+ScopedArenaMarker::ScopedArenaMarker(FrameArena& arena) noexcept
+    :
+    m_arena(arena),
+    m_marker(arena.GetMarker())
+{
+    m_arena.m_activeMarkers++;
+}
+
+ScopedArenaMarker::~ScopedArenaMarker() {
+    m_arena.Rewind(m_marker);
+    m_arena.m_activeMarkers--;
+}
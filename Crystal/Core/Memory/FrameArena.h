@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "MemoryConstants.h"
+
+namespace Crystal {
+    struct FrameArenaMarker {
+        uint32_t Block{};
+        size_t Offset{};
+    };
+
+    //Bump allocator for memory that only lives until the end of the current frame.
+    //Every thread has its own arena, so allocating never takes a lock. Allocations that do not fit into the current block
+    //spill into overflow blocks, on the next reset these are folded into one larger block so a steady workload ends up
+    //allocating from a single block without ever touching the global heap.
+    class FrameArena {
+    public:
+        static constexpr size_t DEFAULT_BLOCK_SIZE = KB(256);
+
+        //Blocks are not coalesced beyond this size, one off spikes such as a scene import should not pin memory forever
+        static constexpr size_t MAX_BLOCK_SIZE     = _16MB;
+
+        explicit FrameArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+        FrameArena(const FrameArena&)            = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+        ~FrameArena();
+
+        //The arena of the calling thread, reset lazily the first time it is used in a new frame
+        [[nodiscard]] static FrameArena& ForCurrentThread() noexcept;
+
+        //Ends the frame for the arenas of all threads. Memory handed out by any thread arena must not be used afterwards.
+        static void NextFrame() noexcept;
+        [[nodiscard]] static uint64_t GetFrameIndex() noexcept;
+
+        [[nodiscard]] void* Allocate(size_t sizeInBytes, size_t alignment = alignof(std::max_align_t)) {
+            assert(std::has_single_bit(alignment) && "Alignment has to be a power of two");
+
+            const auto& block  = m_blocks[m_currentBlock];
+            const auto base    = reinterpret_cast<uintptr_t>(block.Data);
+            const auto aligned = (base + m_offset + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            const auto end     = aligned - base + sizeInBytes;
+
+            if (end <= block.Size) [[likely]] {
+                m_offset = end;
+                return reinterpret_cast<void*>(aligned);
+            }
+            return AllocateSlow(sizeInBytes, alignment);
+        }
+
+        template<class T>
+        [[nodiscard]] T* Allocate(size_t count) {
+            return static_cast<T*>(Allocate(count * sizeof(T), alignof(T)));
+        }
+
+        //Only the most recent allocation is given back, everything else is released on rewind or reset
+        void Deallocate(void* ptr, size_t sizeInBytes) noexcept;
+
+        [[nodiscard]] FrameArenaMarker GetMarker() const noexcept { return { m_currentBlock, m_offset }; }
+        void Rewind(const FrameArenaMarker& marker) noexcept;
+        void Reset() noexcept;
+
+        //std::pmr adapter, e.g. FrameVector<T> values(FrameArena::ForCurrentThread().GetResource())
+        [[nodiscard]] std::pmr::memory_resource* GetResource() noexcept { return &m_resource; }
+
+        [[nodiscard]] size_t GetUsedBytes()     const noexcept { return m_previousBlocksSize + m_offset; }
+        [[nodiscard]] size_t GetCapacity()      const noexcept;
+        [[nodiscard]] size_t GetHighWaterMark() const noexcept { return std::max(m_highWaterMark, GetUsedBytes()); }
+
+        //Number of blocks that had to be allocated from the heap since the arena was created
+        [[nodiscard]] uint64_t GetBlockAllocationCount() const noexcept { return m_blockAllocations; }
+    private:
+        friend class ScopedArenaMarker;
+
+        class Resource final : public std::pmr::memory_resource {
+        public:
+            explicit Resource(FrameArena* arena) noexcept : m_arena(arena) {}
+        private:
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+            FrameArena* m_arena;
+        };
+
+        struct Block {
+            std::byte* Data{};
+            size_t Size{};
+        };
+
+        [[nodiscard]] void* AllocateSlow(size_t sizeInBytes, size_t alignment);
+        void SyncWithFrame() noexcept;
+        void UpdateHighWaterMark() noexcept;
+
+        [[nodiscard]] static Block AllocateBlock(size_t sizeInBytes);
+        static void FreeBlock(const Block& block) noexcept;
+
+        std::vector<Block> m_blocks;
+        uint32_t m_currentBlock{ 0 };
+        size_t m_offset{ 0 };
+        size_t m_previousBlocksSize{ 0 };
+
+        size_t m_highWaterMark{ 0 };
+        size_t m_frameHighWaterMark{ 0 };
+        uint64_t m_blockAllocations{ 0 };
+
+        uint64_t m_frameIndex{ 0 };
+        uint32_t m_activeMarkers{ 0 };
+
+        Resource m_resource{ this };
+    };
+
+    //Rewinds the arena to where it was on construction, for scratch memory that is only needed inside one scope
+    class ScopedArenaMarker {
+    public:
+        explicit ScopedArenaMarker(FrameArena& arena = FrameArena::ForCurrentThread()) noexcept;
+        ScopedArenaMarker(const ScopedArenaMarker&)            = delete;
+        ScopedArenaMarker& operator=(const ScopedArenaMarker&) = delete;
+        ~ScopedArenaMarker();
+
+        [[nodiscard]] FrameArena& GetArena() const noexcept { return m_arena; }
+        [[nodiscard]] std::pmr::memory_resource* GetResource() const noexcept { return m_arena.GetResource(); }
+    private:
+        FrameArena& m_arena;
+        FrameArenaMarker m_marker;
+    };
+
+    template<class T>
+    using FrameVector = std::pmr::vector<T>;
+}
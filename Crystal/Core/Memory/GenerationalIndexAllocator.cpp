@@ -0,0 +1,46 @@
+#include "GenerationalIndexAllocator.h"
+
+using namespace Crystal;
+
+GenerationalIndexAllocator::GenerationalIndexAllocator(uint32_t capacity)
+    :
+    m_indices(capacity),
+    m_generations(capacity, 0)
+{}
+
+std::optional<GenerationalIndex> GenerationalIndexAllocator::Allocate() noexcept {
+    const auto index = m_indices.Allocate();
+
+    if (!index) [[unlikely]] {
+        return {};
+    }
+
+    //Free slots have an even generation, so a live one is odd and never 0, even after wrapping around
+    const auto generation = ++m_generations[*index];
+
+    m_liveCount++;
+    return GenerationalIndex{ .Index = *index, .Generation = generation };
+}
+
+bool GenerationalIndexAllocator::Free(GenerationalIndex handle, uint64_t fenceValue) {
+    if (!IsAlive(handle)) [[unlikely]] {
+        return false;
+    }
+
+    m_generations[handle.Index]++;
+    m_liveCount--;
+
+    m_indices.FreeDeferred(handle.Index, 1, fenceValue);
+    return true;
+}
+
+void GenerationalIndexAllocator::ReleaseCompleted(uint64_t completedFenceValue) noexcept {
+    m_indices.ReleaseCompleted(completedFenceValue);
+}
+
+bool GenerationalIndexAllocator::IsAlive(GenerationalIndex handle) const noexcept {
+    return
+        (handle.Generation & 1) != 0 &&
+        handle.Index < m_generations.size() &&
+        m_generations[handle.Index] == handle.Generation;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "BitmapRangeAllocator.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Crystal {
+    //A stable index into a table, e.g. a descriptor in a bindless heap.
+    //The generation tells handles of a reused index apart, a handle with generation 0 is never valid.
+    struct GenerationalIndex {
+        uint32_t Index{ 0 };
+        uint32_t Generation{ 0 };
+
+        [[nodiscard]] constexpr bool IsValid() const noexcept { return Generation != 0; }
+        [[nodiscard]] constexpr bool operator==(const GenerationalIndex&) const noexcept = default;
+    };
+
+    //Hands out indices into a fixed size table without knowing what the table holds.
+    //Freeing a handle invalidates it right away, the index itself is only reused once the fence value the free was
+    //tagged with has been reached, so work still in flight keeps reading what it was recorded with.
+    class GenerationalIndexAllocator {
+    public:
+        explicit GenerationalIndexAllocator(uint32_t capacity);
+
+        [[nodiscard]] std::optional<GenerationalIndex> Allocate() noexcept;
+
+        //Returns false for handles that are stale or were never allocated
+        bool Free(GenerationalIndex handle, uint64_t fenceValue);
+        void ReleaseCompleted(uint64_t completedFenceValue) noexcept;
+
+        [[nodiscard]] bool IsAlive(GenerationalIndex handle) const noexcept;
+
+        [[nodiscard]] uint32_t GetCapacity() const noexcept { return m_indices.GetCapacity(); }
+        [[nodiscard]] uint32_t GetLiveCount() const noexcept { return m_liveCount; }
+        [[nodiscard]] uint32_t GetPendingCount() const noexcept { return m_indices.GetDeferredCount(); }
+    private:
+        BitmapRangeAllocator m_indices;
+
+        //Odd generations are live, even ones are free, so a freed handle never matches its slot again
+        std::vector<uint32_t> m_generations;
+        uint32_t m_liveCount{ 0 };
+    };
+}
@@ -0,0 +1,445 @@
+#include "MemoryTracker.h"
+#include "Core/Logging/Logger.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define CRYSTAL_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define CRYSTAL_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+using namespace Crystal;
+
+namespace impl {
+    //Trivial thread locals, they are usable from inside operator new before any constructor ran
+    thread_local MemoryTag currentTag      = MemoryTag::Untagged;
+    thread_local uint32_t shardIndex       = UINT32_MAX;
+
+    constexpr uint32_t MAX_CALL_SITE_PROBES = 16;
+}
+
+ScopedMemoryTag::ScopedMemoryTag(MemoryTag tag) noexcept
+    :
+    m_previous(impl::currentTag)
+{
+    impl::currentTag = tag;
+}
+
+ScopedMemoryTag::~ScopedMemoryTag() {
+    impl::currentTag = m_previous;
+}
+
+MemoryTag ScopedMemoryTag::Current() noexcept {
+    return impl::currentTag;
+}
+
+MemoryTracker& MemoryTracker::Get() noexcept {
+    //Constant initialized, so allocations made during static initialization can already be tracked
+    constinit static MemoryTracker memoryTracker;
+    return memoryTracker;
+}
+
+MemoryTracker::Shard& MemoryTracker::GetShard() noexcept {
+    if (impl::shardIndex == UINT32_MAX) [[unlikely]] {
+        impl::shardIndex = m_nextShard.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+    }
+    return m_shards[impl::shardIndex];
+}
+
+uint32_t MemoryTracker::FindCallSite(const void* address) noexcept {
+    const auto hash = (reinterpret_cast<uintptr_t>(address) >> 2) * 0x9E3779B97F4A7C15ull;
+
+    for (uint32_t probe = 0; probe < impl::MAX_CALL_SITE_PROBES; probe++) {
+        //Slot 0 is reserved for call sites that did not fit into the table
+        const auto index = static_cast<uint32_t>((hash >> 40) + probe) % (MAX_CALL_SITES - 1) + 1;
+        auto& slot       = m_callSites[index];
+
+        const void* current = slot.Address.load(std::memory_order_relaxed);
+
+        if (current == address) [[likely]] {
+            return index;
+        }
+
+        if (!current && slot.Address.compare_exchange_strong(current, address, std::memory_order_relaxed)) {
+            return index;
+        }
+
+        //Somebody else claimed the slot in the meantime, it might have been for the same call site
+        if (current == address) {
+            return index;
+        }
+    }
+    return 0;
+}
+
+void MemoryTracker::FlushPending(Shard& shard, uint32_t tag) noexcept {
+    const auto delta = shard.PendingBytes[tag].exchange(0, std::memory_order_relaxed);
+
+    if (delta == 0) {
+        return;
+    }
+
+    auto& tagData    = m_tags[tag];
+    const auto live  = tagData.LiveBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+    auto currentPeak = tagData.PeakBytes.load(std::memory_order_relaxed);
+
+    while (live > currentPeak && !tagData.PeakBytes.compare_exchange_weak(currentPeak, live, std::memory_order_relaxed)) {}
+}
+
+uint32_t MemoryTracker::OnAllocation(size_t sizeInBytes, MemoryTag tag, const void* callSite) noexcept {
+    const auto tagIndex = static_cast<uint32_t>(tag);
+    auto& shard         = GetShard();
+
+    shard.Allocations[tagIndex].fetch_add(1, std::memory_order_relaxed);
+    shard.Bytes[tagIndex].fetch_add(sizeInBytes, std::memory_order_relaxed);
+
+    const auto pending = shard.PendingBytes[tagIndex].fetch_add(static_cast<int64_t>(sizeInBytes), std::memory_order_relaxed) + static_cast<int64_t>(sizeInBytes);
+
+    if (pending >= FLUSH_THRESHOLD) {
+        FlushPending(shard, tagIndex);
+    }
+
+    const auto callSiteIndex = FindCallSite(callSite);
+    auto& site               = m_callSites[callSiteIndex];
+
+    site.Allocations.fetch_add(1, std::memory_order_relaxed);
+    site.Bytes.fetch_add(sizeInBytes, std::memory_order_relaxed);
+    site.LiveAllocations.fetch_add(1, std::memory_order_relaxed);
+    site.LiveBytes.fetch_add(static_cast<int64_t>(sizeInBytes), std::memory_order_relaxed);
+
+    return callSiteIndex;
+}
+
+void MemoryTracker::OnDeallocation(size_t sizeInBytes, MemoryTag tag, uint32_t callSite) noexcept {
+    const auto tagIndex = static_cast<uint32_t>(tag);
+    auto& shard         = GetShard();
+
+    shard.Deallocations[tagIndex].fetch_add(1, std::memory_order_relaxed);
+
+    const auto pending = shard.PendingBytes[tagIndex].fetch_sub(static_cast<int64_t>(sizeInBytes), std::memory_order_relaxed) - static_cast<int64_t>(sizeInBytes);
+
+    if (pending <= -FLUSH_THRESHOLD) {
+        FlushPending(shard, tagIndex);
+    }
+
+    auto& site = m_callSites[callSite % MAX_CALL_SITES];
+
+    site.LiveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    site.LiveBytes.fetch_sub(static_cast<int64_t>(sizeInBytes), std::memory_order_relaxed);
+}
+
+void MemoryTracker::SetBudget(MemoryTag tag, uint64_t budgetInBytes) noexcept {
+    auto& tagData = m_tags[static_cast<uint32_t>(tag)];
+
+    tagData.Budget.store(budgetInBytes, std::memory_order_relaxed);
+    tagData.OverBudget.store(false, std::memory_order_relaxed);
+}
+
+uint64_t MemoryTracker::SumAllocations(uint32_t tag) const noexcept {
+    uint64_t sum = 0;
+    for (const auto& shard : m_shards) {
+        sum += shard.Allocations[tag].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+uint64_t MemoryTracker::SumBytes(uint32_t tag) const noexcept {
+    uint64_t sum = 0;
+    for (const auto& shard : m_shards) {
+        sum += shard.Bytes[tag].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+uint64_t MemoryTracker::SumDeallocations(uint32_t tag) const noexcept {
+    uint64_t sum = 0;
+    for (const auto& shard : m_shards) {
+        sum += shard.Deallocations[tag].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void MemoryTracker::OnFrameEnd() noexcept {
+    const auto now = std::chrono::steady_clock::now();
+
+    //The first call has nothing to compare against, so rates only start with the second frame
+    const auto elapsedSeconds = m_lastFrameEnd.time_since_epoch().count() == 0
+        ? 0.0
+        : std::chrono::duration<double>(now - m_lastFrameEnd).count();
+
+    m_lastFrameEnd = now;
+
+    uint64_t totalAllocations = 0;
+
+    for (uint32_t tag = 0; tag < NUM_TAGS; tag++) {
+        for (auto& shard : m_shards) {
+            FlushPending(shard, tag);
+        }
+
+        auto& tagData          = m_tags[tag];
+        const auto allocations = SumAllocations(tag);
+        const auto bytes       = SumBytes(tag);
+
+        if (elapsedSeconds > 0.0) {
+            tagData.AllocationsPerSecond.store(static_cast<double>(allocations - tagData.LastAllocations) / elapsedSeconds, std::memory_order_relaxed);
+            tagData.BytesPerSecond.store(static_cast<double>(bytes - tagData.LastBytes) / elapsedSeconds, std::memory_order_relaxed);
+        }
+
+        tagData.LastAllocations = allocations;
+        tagData.LastBytes       = bytes;
+        totalAllocations += allocations;
+
+        const auto budget = tagData.Budget.load(std::memory_order_relaxed);
+        const auto live   = tagData.LiveBytes.load(std::memory_order_relaxed);
+
+        if (budget == 0) {
+            continue;
+        }
+
+        if (live > static_cast<int64_t>(budget)) {
+            if (!tagData.OverBudget.exchange(true, std::memory_order_relaxed)) {
+                Logger::Warning("Memory tag {} is over budget: {} bytes live, budget is {} bytes", ToString(static_cast<MemoryTag>(tag)), live, budget);
+            }
+        }
+        else {
+            tagData.OverBudget.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    const auto frameAllocations = totalAllocations - m_lastTotalAllocations;
+    m_lastTotalAllocations      = totalAllocations;
+
+    m_frameAllocations.store(frameAllocations, std::memory_order_relaxed);
+
+    if (frameAllocations > m_peakFrameAllocations.load(std::memory_order_relaxed)) {
+        m_peakFrameAllocations.store(frameAllocations, std::memory_order_relaxed);
+    }
+}
+
+MemoryTagStatistics MemoryTracker::GetTagStatistics(MemoryTag tag) const noexcept {
+    const auto tagIndex = static_cast<uint32_t>(tag);
+    const auto& tagData = m_tags[tagIndex];
+
+    //Include what has not been flushed yet to get the most accurate view
+    auto liveBytes = tagData.LiveBytes.load(std::memory_order_relaxed);
+    for (const auto& shard : m_shards) {
+        liveBytes += shard.PendingBytes[tagIndex].load(std::memory_order_relaxed);
+    }
+
+    const auto allocations = SumAllocations(tagIndex);
+
+    return MemoryTagStatistics{
+        .Tag                  = tag,
+        .LiveBytes            = liveBytes,
+        .PeakBytes            = std::max(liveBytes, tagData.PeakBytes.load(std::memory_order_relaxed)),
+        .LiveAllocations      = static_cast<int64_t>(allocations - SumDeallocations(tagIndex)),
+        .TotalAllocations     = allocations,
+        .TotalBytes           = SumBytes(tagIndex),
+        .AllocationsPerSecond = tagData.AllocationsPerSecond.load(std::memory_order_relaxed),
+        .BytesPerSecond       = tagData.BytesPerSecond.load(std::memory_order_relaxed),
+        .Budget               = tagData.Budget.load(std::memory_order_relaxed)
+    };
+}
+
+std::vector<MemoryTagStatistics> MemoryTracker::GetAllTagStatistics() const {
+    std::vector<MemoryTagStatistics> statistics;
+    statistics.reserve(NUM_TAGS);
+
+    for (uint32_t tag = 0; tag < NUM_TAGS; tag++) {
+        statistics.emplace_back(GetTagStatistics(static_cast<MemoryTag>(tag)));
+    }
+    return statistics;
+}
+
+std::vector<MemoryCallSite> MemoryTracker::GetTopCallSites(uint32_t maxCallSites, bool liveOnly) const {
+    std::vector<MemoryCallSite> callSites;
+
+    for (const auto& site : m_callSites) {
+        const auto allocations = site.Allocations.load(std::memory_order_relaxed);
+        const auto liveBytes   = site.LiveBytes.load(std::memory_order_relaxed);
+
+        if (allocations == 0 || (liveOnly && liveBytes <= 0)) {
+            continue;
+        }
+
+        callSites.emplace_back(MemoryCallSite{
+            .Address         = site.Address.load(std::memory_order_relaxed),
+            .Allocations     = allocations,
+            .Bytes           = site.Bytes.load(std::memory_order_relaxed),
+            .LiveAllocations = site.LiveAllocations.load(std::memory_order_relaxed),
+            .LiveBytes       = liveBytes
+        });
+    }
+
+    const auto count = std::min<size_t>(maxCallSites, callSites.size());
+
+    if (liveOnly) {
+        std::ranges::partial_sort(callSites, callSites.begin() + count, std::ranges::greater{}, &MemoryCallSite::LiveBytes);
+    }
+    else {
+        std::ranges::partial_sort(callSites, callSites.begin() + count, std::ranges::greater{}, &MemoryCallSite::Bytes);
+    }
+
+    callSites.resize(count);
+    return callSites;
+}
+
+uint64_t MemoryTracker::ReportLeaks(uint32_t maxCallSites) const {
+    uint64_t liveAllocations = 0;
+
+    for (const auto& tag : GetAllTagStatistics()) {
+        if (tag.LiveAllocations <= 0) {
+            continue;
+        }
+
+        liveAllocations += tag.LiveAllocations;
+        Logger::Warning("Memory tag {} still owns {} bytes in {} allocations", ToString(tag.Tag), tag.LiveBytes, tag.LiveAllocations);
+    }
+
+    if (liveAllocations == 0) {
+        return 0;
+    }
+
+    for (const auto& site : GetTopCallSites(maxCallSites, true)) {
+        if (site.Address) {
+            Logger::Warning("{} bytes in {} allocations from {}", site.LiveBytes, site.LiveAllocations, site.Address);
+        }
+        else {
+            Logger::Warning("{} bytes in {} allocations from call sites that did not fit into the table", site.LiveBytes, site.LiveAllocations);
+        }
+    }
+    return liveAllocations;
+}
+
+#ifdef CRYSTAL_MEMORY_TRACKING
+namespace impl {
+    struct AllocationHeader {
+        uint64_t Size;
+        uint32_t Offset;
+        uint16_t CallSite;
+        MemoryTag Tag;
+        uint8_t Magic;
+    };
+
+    static_assert(sizeof(AllocationHeader) == __STDCPP_DEFAULT_NEW_ALIGNMENT__, "The header has to keep the default new alignment intact");
+    static_assert(MemoryTracker::MAX_CALL_SITES <= UINT16_MAX + 1);
+
+    constexpr uint8_t HEADER_MAGIC = 0xC5;
+
+    [[nodiscard]] void* TrackedAllocate(size_t size, size_t alignment, const void* callSite) noexcept {
+        alignment = std::max<size_t>(alignment, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+
+        //malloc hands out memory aligned to the default new alignment, which leaves room for the header in front
+        //of the user block, bigger alignments need at most alignment bytes of padding
+        auto* base = static_cast<std::byte*>(std::malloc(size + alignment));
+
+        if (!base) [[unlikely]] {
+            return nullptr;
+        }
+
+        const auto address = (reinterpret_cast<uintptr_t>(base) + sizeof(AllocationHeader) + alignment - 1) & ~(alignment - 1);
+        auto* user         = reinterpret_cast<std::byte*>(address);
+        auto* header       = reinterpret_cast<AllocationHeader*>(user) - 1;
+
+        const auto tag = currentTag;
+
+        header->Size     = size;
+        header->Offset   = static_cast<uint32_t>(user - base);
+        header->Tag      = tag;
+        header->Magic    = HEADER_MAGIC;
+        header->CallSite = static_cast<uint16_t>(MemoryTracker::Get().OnAllocation(size, tag, callSite));
+
+        return user;
+    }
+
+    void TrackedFree(void* ptr) noexcept {
+        if (!ptr) {
+            return;
+        }
+
+        auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+
+        if (header->Magic != HEADER_MAGIC) [[unlikely]] {
+            //Memory that was not allocated through the tracker, abort instead of corrupting the heap
+            std::abort();
+        }
+
+        MemoryTracker::Get().OnDeallocation(header->Size, header->Tag, header->CallSite);
+
+        header->Magic = 0;
+        std::free(static_cast<std::byte*>(ptr) - header->Offset);
+    }
+
+    [[nodiscard]] void* TrackedAllocateOrThrow(size_t size, size_t alignment, const void* callSite) {
+        if (size == 0) {
+            size = 1;
+        }
+
+        while (true) {
+            if (auto* ptr = TrackedAllocate(size, alignment, callSite)) [[likely]] {
+                return ptr;
+            }
+
+            if (const auto handler = std::get_new_handler()) {
+                handler();
+            }
+            else {
+                throw std::bad_alloc();
+            }
+        }
+    }
+}
+
+//The nothrow overloads of the standard library forward to these
+void* operator new(size_t size) {
+    return impl::TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, CRYSTAL_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size) {
+    return impl::TrackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__, CRYSTAL_RETURN_ADDRESS());
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return impl::TrackedAllocateOrThrow(size, static_cast<size_t>(alignment), CRYSTAL_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return impl::TrackedAllocateOrThrow(size, static_cast<size_t>(alignment), CRYSTAL_RETURN_ADDRESS());
+}
+
+void operator delete(void* ptr) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept {
+    impl::TrackedFree(ptr);
+}
+#endif
@@ -0,0 +1,162 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Crystal {
+    //Every heap allocation made while a tag is active on the calling thread is charged to that tag.
+    enum class MemoryTag : uint8_t {
+        Untagged,
+        Scene,
+        Textures,
+        Descriptors,
+        Logging,
+        RHI,
+        Count
+    };
+
+    [[nodiscard]] constexpr std::string_view ToString(MemoryTag tag) noexcept {
+        switch (tag) {
+        case MemoryTag::Untagged:    return "Untagged";
+        case MemoryTag::Scene:       return "Scene";
+        case MemoryTag::Textures:    return "Textures";
+        case MemoryTag::Descriptors: return "Descriptors";
+        case MemoryTag::Logging:     return "Logging";
+        case MemoryTag::RHI:         return "RHI";
+        default:                     return "Unknown";
+        }
+    }
+
+    class ScopedMemoryTag {
+    public:
+        explicit ScopedMemoryTag(MemoryTag tag) noexcept;
+        ScopedMemoryTag(const ScopedMemoryTag&)            = delete;
+        ScopedMemoryTag& operator=(const ScopedMemoryTag&) = delete;
+        ~ScopedMemoryTag();
+
+        [[nodiscard]] static MemoryTag Current() noexcept;
+    private:
+        MemoryTag m_previous;
+    };
+
+    struct MemoryTagStatistics {
+        MemoryTag Tag{};
+        int64_t LiveBytes{};
+        int64_t PeakBytes{};
+        int64_t LiveAllocations{};
+        uint64_t TotalAllocations{};
+        uint64_t TotalBytes{};
+        double AllocationsPerSecond{};
+        double BytesPerSecond{};
+        uint64_t Budget{};
+    };
+
+    struct MemoryCallSite {
+        const void* Address{};
+        uint64_t Allocations{};
+        uint64_t Bytes{};
+        int64_t LiveAllocations{};
+        int64_t LiveBytes{};
+    };
+
+    //Opt-in allocation tracking, enabled by building with CRYSTAL_MEMORY_TRACKING.
+    //When enabled the global operator new/delete are replaced and every allocation carries a small header
+    //with its size, tag and call site. Counters are sharded per thread and folded into the per tag totals lazily,
+    //so live bytes and peaks are exact to within FLUSH_THRESHOLD bytes per shard between two OnFrameEnd calls.
+    class MemoryTracker {
+    public:
+        static constexpr uint32_t NUM_SHARDS       = 32;
+        static constexpr uint32_t NUM_TAGS         = static_cast<uint32_t>(MemoryTag::Count);
+        static constexpr uint32_t MAX_CALL_SITES   = 4096;
+        static constexpr int64_t  FLUSH_THRESHOLD  = 64 * 1024;
+
+        MemoryTracker(const MemoryTracker& rhs)            = delete;
+        MemoryTracker& operator=(const MemoryTracker& rhs) = delete;
+        MemoryTracker(MemoryTracker&& rhs)                 = delete;
+        MemoryTracker& operator=(MemoryTracker&& rhs)      = delete;
+
+        [[nodiscard]] static MemoryTracker& Get() noexcept;
+        [[nodiscard]] static constexpr bool IsEnabled() noexcept {
+#ifdef CRYSTAL_MEMORY_TRACKING
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        //Called by the allocation hooks, returns the call site slot the allocation was charged to
+        [[nodiscard]] uint32_t OnAllocation(size_t sizeInBytes, MemoryTag tag, const void* callSite) noexcept;
+        void OnDeallocation(size_t sizeInBytes, MemoryTag tag, uint32_t callSite) noexcept;
+
+        //Logs a warning the first time the live bytes of the tag exceed the budget, 0 disables the budget
+        void SetBudget(MemoryTag tag, uint64_t budgetInBytes) noexcept;
+
+        //Folds the shards into the per tag totals, updates rates and the per frame allocation count and checks budgets.
+        //Must be called from a single thread, typically the one that drives the frame loop.
+        void OnFrameEnd() noexcept;
+
+        [[nodiscard]] MemoryTagStatistics GetTagStatistics(MemoryTag tag) const noexcept;
+        [[nodiscard]] std::vector<MemoryTagStatistics> GetAllTagStatistics() const;
+        [[nodiscard]] std::vector<MemoryCallSite> GetTopCallSites(uint32_t maxCallSites, bool liveOnly = false) const;
+
+        [[nodiscard]] uint64_t GetFrameAllocationCount() const noexcept { return m_frameAllocations.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t GetPeakFrameAllocationCount() const noexcept { return m_peakFrameAllocations.load(std::memory_order_relaxed); }
+
+        //Logs every tag and call site that still owns memory, returns the number of live allocations
+        uint64_t ReportLeaks(uint32_t maxCallSites = 32) const;
+    private:
+        constexpr MemoryTracker() noexcept = default;
+
+        struct alignas(64) Shard {
+            std::array<std::atomic_uint64_t, NUM_TAGS> Allocations{};
+            std::array<std::atomic_uint64_t, NUM_TAGS> Bytes{};
+            std::array<std::atomic_uint64_t, NUM_TAGS> Deallocations{};
+            std::array<std::atomic_int64_t, NUM_TAGS> PendingBytes{};
+        };
+
+        struct Tag {
+            std::atomic_int64_t LiveBytes{ 0 };
+            std::atomic_int64_t PeakBytes{ 0 };
+            std::atomic_uint64_t Budget{ 0 };
+            std::atomic_bool OverBudget{ false };
+
+            //Only touched by OnFrameEnd
+            uint64_t LastAllocations{ 0 };
+            uint64_t LastBytes{ 0 };
+            std::atomic<double> AllocationsPerSecond{ 0.0 };
+            std::atomic<double> BytesPerSecond{ 0.0 };
+        };
+
+        struct CallSite {
+            std::atomic<const void*> Address{ nullptr };
+            std::atomic_uint64_t Allocations{ 0 };
+            std::atomic_uint64_t Bytes{ 0 };
+            std::atomic_int64_t LiveAllocations{ 0 };
+            std::atomic_int64_t LiveBytes{ 0 };
+        };
+
+        [[nodiscard]] Shard& GetShard() noexcept;
+        [[nodiscard]] uint32_t FindCallSite(const void* address) noexcept;
+        void FlushPending(Shard& shard, uint32_t tag) noexcept;
+
+        [[nodiscard]] uint64_t SumAllocations(uint32_t tag) const noexcept;
+        [[nodiscard]] uint64_t SumBytes(uint32_t tag) const noexcept;
+        [[nodiscard]] uint64_t SumDeallocations(uint32_t tag) const noexcept;
+
+        std::array<Shard, NUM_SHARDS> m_shards{};
+        std::array<Tag, NUM_TAGS> m_tags{};
+
+        //Slot 0 collects every allocation that did not fit into the table
+        std::array<CallSite, MAX_CALL_SITES> m_callSites{};
+
+        std::atomic_uint32_t m_nextShard{ 0 };
+        std::atomic_uint64_t m_frameAllocations{ 0 };
+        std::atomic_uint64_t m_peakFrameAllocations{ 0 };
+        uint64_t m_lastTotalAllocations{ 0 };
+        std::chrono::steady_clock::time_point m_lastFrameEnd{};
+    };
+}
@@ -0,0 +1,254 @@
+#include "ResidencyManager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace Crystal;
+
+ResidencyManager::ResidencyManager(uint64_t budgetInBytes, uint32_t capacity)
+    :
+    m_handles(capacity),
+    m_entries(capacity),
+    m_budgetInBytes(budgetInBytes)
+{}
+
+GenerationalIndex ResidencyManager::Register(std::span<const uint64_t> mipSizes, uint32_t minResidentMips, uint64_t frame) {
+    assert(!mipSizes.empty() && mipSizes.size() <= MAX_MIPS && "A resource needs between 1 and MAX_MIPS mips");
+
+    const auto handle = m_handles.Allocate();
+
+    if (!handle) [[unlikely]] {
+        return {};
+    }
+
+    auto& entry = m_entries[handle->Index];
+    entry       = Entry{
+        .Handle          = *handle,
+        .NumMips         = static_cast<uint32_t>(mipSizes.size()),
+        .MinResidentMips = std::clamp(minResidentMips, 1u, static_cast<uint32_t>(mipSizes.size())),
+        .ReferenceCount  = 1,
+        .LastUsedFrame   = frame
+    };
+    std::ranges::copy(mipSizes, entry.MipSizes.begin());
+
+    LinkAtTail(handle->Index);
+
+    m_residentBytes += GetResidentBytes(entry, 0);
+    m_numReferenced++;
+
+    return *handle;
+}
+
+void ResidencyManager::AddRef(GenerationalIndex handle) noexcept {
+    if (!m_handles.IsAlive(handle)) [[unlikely]] {
+        return;
+    }
+
+    if (m_entries[handle.Index].ReferenceCount++ == 0) {
+        m_numReferenced++;
+    }
+}
+
+void ResidencyManager::Release(GenerationalIndex handle) noexcept {
+    if (!m_handles.IsAlive(handle)) [[unlikely]] {
+        return;
+    }
+
+    auto& entry = m_entries[handle.Index];
+    assert(entry.ReferenceCount > 0 && "Resource is released more often than it was referenced");
+
+    //Unreferenced resources stay resident, they are only evicted once the budget runs out
+    if (--entry.ReferenceCount == 0) {
+        m_numReferenced--;
+    }
+}
+
+void ResidencyManager::Touch(GenerationalIndex handle, uint64_t frame, uint32_t mostDetailedMip) noexcept {
+    if (!m_handles.IsAlive(handle)) [[unlikely]] {
+        return;
+    }
+
+    auto& entry = m_entries[handle.Index];
+
+    entry.LastUsedFrame = std::max(entry.LastUsedFrame, frame);
+    entry.RequestedMip  = std::min(mostDetailedMip, entry.NumMips - 1);
+
+    if (m_tail != handle.Index) {
+        Unlink(handle.Index);
+        LinkAtTail(handle.Index);
+    }
+}
+
+std::vector<ResidencyAction> ResidencyManager::Update(uint64_t frame) {
+    std::vector<ResidencyAction> actions;
+
+    if (m_residentBytes > m_budgetInBytes) {
+        EvictUnreferenced(frame, actions);
+    }
+
+    if (m_residentBytes > m_budgetInBytes) {
+        DropMips(frame, actions);
+    }
+
+    //Nothing is restored in a frame that had to trim, it would only be dropped again
+    if (actions.empty()) {
+        RestoreMips(frame, actions);
+    }
+    return actions;
+}
+
+void ResidencyManager::EvictUnreferenced(uint64_t frame, std::vector<ResidencyAction>& actions) {
+    for (auto index = m_head; index != INVALID_INDEX && m_residentBytes > m_budgetInBytes;) {
+        auto& entry     = m_entries[index];
+        const auto next = entry.Next;
+
+        if (entry.ReferenceCount == 0 && !IsProtected(entry, frame)) {
+            const auto sizeInBytes = GetResidentBytes(entry, entry.FirstResidentMip);
+
+            actions.push_back({
+                .Handle           = entry.Handle,
+                .Type             = ResidencyActionType::Evict,
+                .FirstResidentMip = entry.NumMips,
+                .SizeInBytes      = sizeInBytes
+            });
+
+            m_residentBytes -= sizeInBytes;
+            m_evictedBytes  += sizeInBytes;
+
+            Unlink(index);
+            m_handles.Free(entry.Handle, 0);
+        }
+        index = next;
+    }
+
+    //Evicted handles were invalidated right away, the slots can be reused immediately
+    m_handles.ReleaseCompleted(0);
+}
+
+void ResidencyManager::DropMips(uint64_t frame, std::vector<ResidencyAction>& actions) {
+    for (auto index = m_head; index != INVALID_INDEX && m_residentBytes > m_budgetInBytes; index = m_entries[index].Next) {
+        auto& entry = m_entries[index];
+
+        //The list is ordered by use, every entry after a protected one was used even more recently
+        if (IsProtected(entry, frame)) {
+            break;
+        }
+
+        const auto lastDroppableMip = entry.NumMips - entry.MinResidentMips;
+        const auto firstMip         = entry.FirstResidentMip;
+
+        while (entry.FirstResidentMip < lastDroppableMip && m_residentBytes > m_budgetInBytes) {
+            m_residentBytes -= entry.MipSizes[entry.FirstResidentMip];
+            entry.FirstResidentMip++;
+        }
+
+        if (entry.FirstResidentMip != firstMip) {
+            const auto sizeInBytes = GetResidentBytes(entry, firstMip) - GetResidentBytes(entry, entry.FirstResidentMip);
+
+            actions.push_back({
+                .Handle           = entry.Handle,
+                .Type             = ResidencyActionType::DropMips,
+                .FirstResidentMip = entry.FirstResidentMip,
+                .SizeInBytes      = sizeInBytes
+            });
+            m_droppedMipBytes += sizeInBytes;
+        }
+    }
+}
+
+void ResidencyManager::RestoreMips(uint64_t frame, std::vector<ResidencyAction>& actions) {
+    //Most recently used first, those are the ones on screen right now
+    for (auto index = m_tail; index != INVALID_INDEX; index = m_entries[index].Previous) {
+        auto& entry = m_entries[index];
+
+        if (!IsProtected(entry, frame)) {
+            break;
+        }
+
+        if (entry.RequestedMip >= entry.FirstResidentMip) {
+            continue;
+        }
+
+        const auto sizeInBytes = GetResidentBytes(entry, entry.RequestedMip) - GetResidentBytes(entry, entry.FirstResidentMip);
+
+        if (m_residentBytes + sizeInBytes > m_budgetInBytes) {
+            continue;
+        }
+
+        entry.FirstResidentMip = entry.RequestedMip;
+
+        actions.push_back({
+            .Handle           = entry.Handle,
+            .Type             = ResidencyActionType::RestoreMips,
+            .FirstResidentMip = entry.FirstResidentMip,
+            .SizeInBytes      = sizeInBytes
+        });
+
+        m_residentBytes    += sizeInBytes;
+        m_restoredMipBytes += sizeInBytes;
+    }
+}
+
+uint32_t ResidencyManager::GetFirstResidentMip(GenerationalIndex handle) const noexcept {
+    return m_handles.IsAlive(handle) ? m_entries[handle.Index].FirstResidentMip : 0;
+}
+
+uint32_t ResidencyManager::GetReferenceCount(GenerationalIndex handle) const noexcept {
+    return m_handles.IsAlive(handle) ? m_entries[handle.Index].ReferenceCount : 0;
+}
+
+ResidencyStatistics ResidencyManager::GetStatistics() const noexcept {
+    return {
+        .BudgetInBytes    = m_budgetInBytes,
+        .ResidentBytes    = m_residentBytes,
+        .NumResources     = m_handles.GetLiveCount(),
+        .NumReferenced    = m_numReferenced,
+        .EvictedBytes     = m_evictedBytes,
+        .DroppedMipBytes  = m_droppedMipBytes,
+        .RestoredMipBytes = m_restoredMipBytes
+    };
+}
+
+uint64_t ResidencyManager::GetResidentBytes(const Entry& entry, uint32_t firstMip) noexcept {
+    return std::accumulate(entry.MipSizes.begin() + firstMip, entry.MipSizes.begin() + entry.NumMips, uint64_t{ 0 });
+}
+
+bool ResidencyManager::IsProtected(const Entry& entry, uint64_t frame) const noexcept {
+    return entry.LastUsedFrame + m_protectedFrames > frame;
+}
+
+void ResidencyManager::LinkAtTail(uint32_t index) noexcept {
+    auto& entry    = m_entries[index];
+    entry.Previous = m_tail;
+    entry.Next     = INVALID_INDEX;
+
+    if (m_tail != INVALID_INDEX) {
+        m_entries[m_tail].Next = index;
+    }
+    else {
+        m_head = index;
+    }
+    m_tail = index;
+}
+
+void ResidencyManager::Unlink(uint32_t index) noexcept {
+    auto& entry = m_entries[index];
+
+    if (entry.Previous != INVALID_INDEX) {
+        m_entries[entry.Previous].Next = entry.Next;
+    }
+    else {
+        m_head = entry.Next;
+    }
+
+    if (entry.Next != INVALID_INDEX) {
+        m_entries[entry.Next].Previous = entry.Previous;
+    }
+    else {
+        m_tail = entry.Previous;
+    }
+
+    entry.Previous = INVALID_INDEX;
+    entry.Next     = INVALID_INDEX;
+}
@@ -0,0 +1,117 @@
+#pragma once
+#include "GenerationalIndexAllocator.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    enum class ResidencyActionType : uint8_t {
+        //Mips in front of FirstResidentMip are released, the resource stays usable at a lower resolution
+        DropMips,
+        //Mips from FirstResidentMip on were asked for and fit into the budget again
+        RestoreMips,
+        //Nothing references the resource anymore, it is released and its handle is invalid
+        Evict
+    };
+
+    struct ResidencyAction {
+        GenerationalIndex Handle;
+        ResidencyActionType Type;
+        uint32_t FirstResidentMip;
+
+        //Freed by DropMips and Evict, needed by RestoreMips
+        uint64_t SizeInBytes;
+    };
+
+    struct ResidencyStatistics {
+        uint64_t BudgetInBytes;
+        uint64_t ResidentBytes;
+        uint32_t NumResources;
+        uint32_t NumReferenced;
+
+        //Totals since the manager was created
+        uint64_t EvictedBytes;
+        uint64_t DroppedMipBytes;
+        uint64_t RestoredMipBytes;
+    };
+
+    //Decides which textures, or which of their mips, stay in memory. It knows nothing about the graphics API:
+    //resources are registered with the size of every mip, the backend reports references and use, and Update
+    //returns what has to be released or loaded again to stay within the budget.
+    //Unreferenced resources are evicted first, least recently used first. After that referenced resources that were
+    //not used within the protected frames lose their largest mips, again least recently used first.
+    class ResidencyManager {
+    public:
+        static constexpr uint32_t MAX_MIPS                 = 16;
+        static constexpr uint32_t DEFAULT_CAPACITY         = 1 << 16;
+        static constexpr uint32_t DEFAULT_PROTECTED_FRAMES = 3;
+
+        explicit ResidencyManager(uint64_t budgetInBytes, uint32_t capacity = DEFAULT_CAPACITY);
+
+        //Mip 0 is the largest, all mips start out resident and the caller holds one reference.
+        //The last minResidentMips mips are never dropped, resources that can only be released as a whole pass the mip count.
+        [[nodiscard]] GenerationalIndex Register(std::span<const uint64_t> mipSizes, uint32_t minResidentMips, uint64_t frame);
+
+        void AddRef(GenerationalIndex handle) noexcept;
+        void Release(GenerationalIndex handle) noexcept;
+
+        //Marks the resource as used in this frame with mips from mostDetailedMip on
+        void Touch(GenerationalIndex handle, uint64_t frame, uint32_t mostDetailedMip = 0) noexcept;
+
+        //The actions have already been applied to the bookkeeping, the backend has to carry them out
+        [[nodiscard]] std::vector<ResidencyAction> Update(uint64_t frame);
+
+        void SetBudget(uint64_t budgetInBytes) noexcept { m_budgetInBytes = budgetInBytes; }
+
+        //Resources used within this many frames may still be read by the GPU and are never trimmed
+        void SetProtectedFrames(uint32_t numFrames) noexcept { m_protectedFrames = numFrames; }
+
+        [[nodiscard]] bool IsRegistered(GenerationalIndex handle) const noexcept { return m_handles.IsAlive(handle); }
+        [[nodiscard]] uint32_t GetFirstResidentMip(GenerationalIndex handle) const noexcept;
+        [[nodiscard]] uint32_t GetReferenceCount(GenerationalIndex handle) const noexcept;
+        [[nodiscard]] ResidencyStatistics GetStatistics() const noexcept;
+    private:
+        static constexpr uint32_t INVALID_INDEX = ~0u;
+
+        struct Entry {
+            GenerationalIndex Handle;
+            std::array<uint64_t, MAX_MIPS> MipSizes{};
+            uint32_t NumMips{};
+            uint32_t MinResidentMips{};
+            uint32_t FirstResidentMip{};
+            uint32_t RequestedMip{};
+            uint32_t ReferenceCount{};
+            uint64_t LastUsedFrame{};
+
+            //Least recently used list, the head has not been used for the longest time
+            uint32_t Previous{ INVALID_INDEX };
+            uint32_t Next{ INVALID_INDEX };
+        };
+
+        [[nodiscard]] static uint64_t GetResidentBytes(const Entry& entry, uint32_t firstMip) noexcept;
+        [[nodiscard]] bool IsProtected(const Entry& entry, uint64_t frame) const noexcept;
+
+        void LinkAtTail(uint32_t index) noexcept;
+        void Unlink(uint32_t index) noexcept;
+
+        void EvictUnreferenced(uint64_t frame, std::vector<ResidencyAction>& actions);
+        void DropMips(uint64_t frame, std::vector<ResidencyAction>& actions);
+        void RestoreMips(uint64_t frame, std::vector<ResidencyAction>& actions);
+
+        GenerationalIndexAllocator m_handles;
+        std::vector<Entry> m_entries;
+
+        uint32_t m_head{ INVALID_INDEX };
+        uint32_t m_tail{ INVALID_INDEX };
+
+        uint64_t m_budgetInBytes;
+        uint64_t m_residentBytes{ 0 };
+        uint32_t m_protectedFrames{ DEFAULT_PROTECTED_FRAMES };
+        uint32_t m_numReferenced{ 0 };
+
+        uint64_t m_evictedBytes{ 0 };
+        uint64_t m_droppedMipBytes{ 0 };
+        uint64_t m_restoredMipBytes{ 0 };
+    };
+}
@@ -0,0 +1,86 @@
+#include "RingAllocator.h"
+
+#include <bit>
+#include <cassert>
+
+using namespace Crystal;
+
+namespace impl {
+    [[nodiscard]] constexpr uint64_t AlignRingOffset(uint64_t value, uint64_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+RingAllocator::RingAllocator(uint64_t capacity) noexcept
+    :
+    m_capacity(capacity)
+{}
+
+std::optional<uint64_t> RingAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment) noexcept {
+    assert(std::has_single_bit(alignment) && "Alignment has to be a power of two");
+
+    if (m_usedBytes == 0) {
+        //Start over at the beginning, this keeps large allocations from failing just because the head is in the middle
+        m_head = 0;
+        m_tail = 0;
+    }
+    else if (m_usedBytes == m_capacity) {
+        return {};
+    }
+
+    auto offset = impl::AlignRingOffset(m_head, alignment);
+
+    if (m_head >= m_tail) {
+        //Free space is the end of the ring and the beginning up to the tail
+        if (offset + sizeInBytes > m_capacity) {
+            if (sizeInBytes > m_tail) {
+                return {};
+            }
+            offset = 0;
+        }
+    }
+    else if (offset + sizeInBytes > m_tail) {
+        return {};
+    }
+
+    //Skipped bytes at the end of the ring or in front of the range stay with the submission until it retires
+    const auto consumed = offset >= m_head ? offset + sizeInBytes - m_head : m_capacity - m_head + sizeInBytes;
+
+    m_head          = offset + sizeInBytes;
+    m_usedBytes    += consumed;
+    m_pendingBytes += consumed;
+
+    return offset;
+}
+
+void RingAllocator::Submit(uint64_t fenceValue) {
+    if (m_pendingBytes == 0) {
+        return;
+    }
+
+    assert((m_submissions.empty() || m_submissions.back().FenceValue <= fenceValue) && "Fence values have to increase");
+
+    m_submissions.push_back({ .FenceValue = fenceValue, .SizeInBytes = m_pendingBytes });
+    m_pendingBytes = 0;
+}
+
+void RingAllocator::Retire(uint64_t completedFenceValue) noexcept {
+    while (!m_submissions.empty() && m_submissions.front().FenceValue <= completedFenceValue) {
+        const auto sizeInBytes = m_submissions.front().SizeInBytes;
+
+        m_tail += sizeInBytes;
+        if (m_tail >= m_capacity) {
+            m_tail -= m_capacity;
+        }
+
+        m_usedBytes -= sizeInBytes;
+        m_submissions.pop_front();
+    }
+}
+
+std::optional<uint64_t> RingAllocator::GetOldestFenceValue() const noexcept {
+    if (m_submissions.empty()) {
+        return {};
+    }
+    return m_submissions.front().FenceValue;
+}
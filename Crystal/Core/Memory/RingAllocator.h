@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+namespace Crystal {
+    //Hands out ranges of a fixed size buffer in order and takes them back in the same order once the GPU is done with them.
+    //Ranges belong to the submission they were allocated for, they are retired when the fence value signalled after that
+    //submission has been reached. Fence values are plain numbers, any monotonically increasing counter works.
+    class RingAllocator {
+    public:
+        explicit RingAllocator(uint64_t capacity) noexcept;
+
+        //Returns the offset of the range, or nothing if the free part of the ring is too small
+        [[nodiscard]] std::optional<uint64_t> Allocate(uint64_t sizeInBytes, uint64_t alignment = 1) noexcept;
+
+        //Everything allocated since the last submission can be reused once the fence value has been reached
+        void Submit(uint64_t fenceValue);
+        void Retire(uint64_t completedFenceValue) noexcept;
+
+        //Fence value to wait for to free up the oldest submission
+        [[nodiscard]] std::optional<uint64_t> GetOldestFenceValue() const noexcept;
+
+        [[nodiscard]] uint64_t GetCapacity()  const noexcept { return m_capacity; }
+        [[nodiscard]] uint64_t GetUsedBytes() const noexcept { return m_usedBytes; }
+
+        //Bytes allocated since the last submission, including padding for alignment and for wrapping around
+        [[nodiscard]] uint64_t GetPendingBytes() const noexcept { return m_pendingBytes; }
+        [[nodiscard]] size_t GetSubmissionsInFlight() const noexcept { return m_submissions.size(); }
+    private:
+        struct Submission {
+            uint64_t FenceValue;
+            uint64_t SizeInBytes;
+        };
+
+        uint64_t m_capacity;
+
+        //Allocations are made at the head and retired from the tail
+        uint64_t m_head{ 0 };
+        uint64_t m_tail{ 0 };
+        uint64_t m_usedBytes{ 0 };
+        uint64_t m_pendingBytes{ 0 };
+
+        std::deque<Submission> m_submissions;
+    };
+}
@@ -0,0 +1,225 @@
+#include "SlabAllocator.h"
+#include "Core/Logging/Logger.h"
+
+#include <cassert>
+#include <cstring>
+#include <new>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr std::byte FREED_PATTERN{ 0xDD };
+    constexpr std::byte ALLOCATED_PATTERN{ 0xCD };
+    constexpr size_t PAGE_ALIGNMENT = 64;
+
+    void* AllocateFromHeap(size_t sizeInBytes, size_t alignment) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(sizeInBytes, std::align_val_t{ alignment });
+        }
+        return ::operator new(sizeInBytes);
+    }
+
+    void FreeToHeap(void* ptr, size_t sizeInBytes, size_t alignment) noexcept {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, sizeInBytes, std::align_val_t{ alignment });
+        }
+        else {
+            ::operator delete(ptr, sizeInBytes);
+        }
+    }
+}
+
+struct SlabAllocator::ThreadCache {
+    struct List {
+        FreeBlock* Head{ nullptr };
+        uint32_t Count{ 0 };
+    };
+
+    std::array<List, NUM_SIZE_CLASSES> Lists{};
+
+    //Blocks cached by a thread that exits go back to the shared lists
+    ~ThreadCache() {
+        auto& allocator = SlabAllocator::Get();
+
+        for (uint32_t sizeClass = 0; sizeClass < NUM_SIZE_CLASSES; sizeClass++) {
+            auto& list = Lists[sizeClass];
+
+            if (!list.Head) {
+                continue;
+            }
+
+            auto* last = list.Head;
+            while (last->Next) {
+                last = last->Next;
+            }
+
+            allocator.Release(sizeClass, list.Head, last, list.Count);
+            list = {};
+        }
+    }
+};
+
+SlabAllocator& SlabAllocator::Get() noexcept {
+    static SlabAllocator allocator;
+    return allocator;
+}
+
+SlabAllocator::~SlabAllocator() {
+    for (auto& sizeClass : m_sizeClasses) {
+        //Pooled objects that outlive the allocator would point into freed pages, leaking them is the lesser evil
+        if (sizeClass.BlocksOutstanding.load(std::memory_order_relaxed) > 0) {
+            continue;
+        }
+
+        for (const auto page : sizeClass.Pages) {
+            ::operator delete(page, PAGE_SIZE, std::align_val_t{ impl::PAGE_ALIGNMENT });
+        }
+    }
+}
+
+SlabAllocator::ThreadCache& SlabAllocator::GetThreadCache() noexcept {
+    thread_local ThreadCache cache;
+    return cache;
+}
+
+void* SlabAllocator::Allocate(size_t sizeInBytes, size_t alignment) {
+    if (!IsSlabSize(sizeInBytes, alignment)) [[unlikely]] {
+        return impl::AllocateFromHeap(sizeInBytes, alignment);
+    }
+
+    const auto sizeClass = GetSizeClass(sizeInBytes);
+    auto& list           = GetThreadCache().Lists[sizeClass];
+
+    if (!list.Head) [[unlikely]] {
+        list.Head = Refill(sizeClass, list.Count);
+    }
+
+    auto* block = list.Head;
+    list.Head   = block->Next;
+    list.Count--;
+
+    if constexpr (POISONING) {
+        const auto blockSize = SIZE_CLASSES[sizeClass];
+        const auto bytes     = reinterpret_cast<std::byte*>(block);
+
+        for (size_t i = sizeof(FreeBlock); i < blockSize; i++) {
+            if (bytes[i] != impl::FREED_PATTERN) {
+                Logger::Error("Slab block {} of size {} was written to after it was freed", static_cast<void*>(block), blockSize);
+                assert(false && "Use after free detected");
+                break;
+            }
+        }
+        std::memset(block, static_cast<int>(impl::ALLOCATED_PATTERN), blockSize);
+    }
+    return block;
+}
+
+void SlabAllocator::Free(void* ptr, size_t sizeInBytes, size_t alignment) noexcept {
+    if (!ptr) {
+        return;
+    }
+
+    if (!IsSlabSize(sizeInBytes, alignment)) [[unlikely]] {
+        impl::FreeToHeap(ptr, sizeInBytes, alignment);
+        return;
+    }
+
+    const auto sizeClass = GetSizeClass(sizeInBytes);
+    auto& list           = GetThreadCache().Lists[sizeClass];
+
+    if constexpr (POISONING) {
+        std::memset(ptr, static_cast<int>(impl::FREED_PATTERN), SIZE_CLASSES[sizeClass]);
+    }
+
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->Next = list.Head;
+    list.Head   = block;
+    list.Count++;
+
+    //Hand a batch back once the cache holds two, so memory freed by one thread can be reused by the others
+    if (list.Count >= 2 * BATCH_SIZE) [[unlikely]] {
+        auto* first = list.Head;
+        auto* last  = first;
+
+        for (uint32_t i = 1; i < BATCH_SIZE; i++) {
+            last = last->Next;
+        }
+
+        list.Head   = last->Next;
+        list.Count -= BATCH_SIZE;
+
+        last->Next = nullptr;
+        Release(sizeClass, first, last, BATCH_SIZE);
+    }
+}
+
+SlabAllocator::FreeBlock* SlabAllocator::Refill(uint32_t sizeClassIndex, uint32_t& count) {
+    auto& sizeClass = m_sizeClasses[sizeClassIndex];
+    std::scoped_lock lock(sizeClass.Mutex);
+
+    if (!sizeClass.FreeList) {
+        AllocatePage(sizeClass, SIZE_CLASSES[sizeClassIndex]);
+    }
+
+    auto* first = sizeClass.FreeList;
+    auto* last  = first;
+    count       = 1;
+
+    while (count < BATCH_SIZE && last->Next) {
+        last = last->Next;
+        count++;
+    }
+
+    sizeClass.FreeList = last->Next;
+    last->Next         = nullptr;
+
+    sizeClass.BlocksOutstanding.fetch_add(count, std::memory_order_relaxed);
+    return first;
+}
+
+void SlabAllocator::Release(uint32_t sizeClassIndex, FreeBlock* first, FreeBlock* last, uint32_t count) noexcept {
+    auto& sizeClass = m_sizeClasses[sizeClassIndex];
+    std::scoped_lock lock(sizeClass.Mutex);
+
+    last->Next         = sizeClass.FreeList;
+    sizeClass.FreeList = first;
+
+    sizeClass.BlocksOutstanding.fetch_sub(count, std::memory_order_relaxed);
+}
+
+void SlabAllocator::AllocatePage(SizeClass& sizeClass, uint32_t blockSize) {
+    auto* page = static_cast<std::byte*>(::operator new(PAGE_SIZE, std::align_val_t{ impl::PAGE_ALIGNMENT }));
+    sizeClass.Pages.push_back(page);
+
+    if constexpr (POISONING) {
+        std::memset(page, static_cast<int>(impl::FREED_PATTERN), PAGE_SIZE);
+    }
+
+    //Link the blocks in address order, consecutive allocations then end up next to each other
+    const auto numBlocks = PAGE_SIZE / blockSize;
+    FreeBlock* next      = sizeClass.FreeList;
+
+    for (size_t i = numBlocks; i-- > 0;) {
+        auto* block = reinterpret_cast<FreeBlock*>(page + i * blockSize);
+        block->Next = next;
+        next        = block;
+    }
+    sizeClass.FreeList = next;
+}
+
+std::vector<SlabClassStatistics> SlabAllocator::GetStatistics() const {
+    std::vector<SlabClassStatistics> statistics;
+    statistics.reserve(NUM_SIZE_CLASSES);
+
+    for (uint32_t i = 0; i < NUM_SIZE_CLASSES; i++) {
+        const auto& sizeClass = m_sizeClasses[i];
+        std::scoped_lock lock(sizeClass.Mutex);
+
+        statistics.push_back({
+            .BlockSize         = SIZE_CLASSES[i],
+            .Pages             = sizeClass.Pages.size(),
+            .BlocksOutstanding = sizeClass.BlocksOutstanding.load(std::memory_order_relaxed)
+        });
+    }
+    return statistics;
+}
@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryConstants.h"
+
+namespace Crystal {
+    struct SlabClassStatistics {
+        size_t BlockSize{};
+        size_t Pages{};
+
+        //Blocks handed out to threads, including the ones sitting in thread caches
+        size_t BlocksOutstanding{};
+    };
+
+    //Allocator for small fixed size objects. Every size class carves its own pages into equally sized blocks,
+    //so objects of one type end up next to each other instead of scattered across the heap.
+    //Threads allocate from and free into a private cache, the shared free list of a class is only locked to move
+    //a whole batch of blocks in or out of a cache. Requests larger than MAX_BLOCK_SIZE or with an alignment above
+    //MAX_ALIGNMENT fall back to the global heap.
+    class SlabAllocator {
+    public:
+        static constexpr size_t PAGE_SIZE      = _64KB;
+        static constexpr size_t MAX_BLOCK_SIZE = KB(1);
+        static constexpr size_t MAX_ALIGNMENT  = 16;
+        static constexpr uint32_t BATCH_SIZE   = 32;
+
+        static constexpr std::array<uint32_t, 20> SIZE_CLASSES{
+            16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512, 640, 768, 896, 1024
+        };
+        static constexpr uint32_t NUM_SIZE_CLASSES = static_cast<uint32_t>(SIZE_CLASSES.size());
+
+        //Freed blocks are filled with a pattern that is verified when the block is handed out again
+#if defined(_DEBUG) || defined(CRYSTAL_SLAB_POISONING)
+        static constexpr bool POISONING = true;
+#else
+        static constexpr bool POISONING = false;
+#endif
+
+        SlabAllocator(const SlabAllocator& rhs)            = delete;
+        SlabAllocator& operator=(const SlabAllocator& rhs) = delete;
+        SlabAllocator(SlabAllocator&& rhs)                 = delete;
+        SlabAllocator& operator=(SlabAllocator&& rhs)      = delete;
+
+        [[nodiscard]] static SlabAllocator& Get() noexcept;
+
+        [[nodiscard]] void* Allocate(size_t sizeInBytes, size_t alignment = alignof(std::max_align_t));
+
+        //The size has to match the size passed to Allocate
+        void Free(void* ptr, size_t sizeInBytes, size_t alignment = alignof(std::max_align_t)) noexcept;
+
+        [[nodiscard]] std::vector<SlabClassStatistics> GetStatistics() const;
+
+        [[nodiscard]] static constexpr bool IsSlabSize(size_t sizeInBytes, size_t alignment) noexcept {
+            return sizeInBytes <= MAX_BLOCK_SIZE && alignment <= MAX_ALIGNMENT;
+        }
+
+        [[nodiscard]] static constexpr uint32_t GetSizeClass(size_t sizeInBytes) noexcept {
+            return SIZE_CLASS_LOOKUP[(std::max<size_t>(sizeInBytes, 1) + 15) / 16];
+        }
+    private:
+        SlabAllocator() noexcept = default;
+        ~SlabAllocator();
+
+        struct FreeBlock {
+            FreeBlock* Next;
+        };
+
+        struct alignas(64) SizeClass {
+            mutable std::mutex Mutex;
+            FreeBlock* FreeList{ nullptr };
+            std::vector<void*> Pages;
+            std::atomic_size_t BlocksOutstanding{ 0 };
+        };
+
+        struct ThreadCache;
+        friend struct ThreadCache;
+
+        [[nodiscard]] static ThreadCache& GetThreadCache() noexcept;
+
+        [[nodiscard]] FreeBlock* Refill(uint32_t sizeClass, uint32_t& count);
+        void Release(uint32_t sizeClass, FreeBlock* first, FreeBlock* last, uint32_t count) noexcept;
+        void AllocatePage(SizeClass& sizeClass, uint32_t blockSize);
+
+        static constexpr auto SIZE_CLASS_LOOKUP = [] {
+            std::array<uint8_t, MAX_BLOCK_SIZE / 16 + 1> lookup{};
+            uint32_t sizeClass = 0;
+
+            for (uint32_t i = 0; i < lookup.size(); i++) {
+                while (SIZE_CLASSES[sizeClass] < i * 16) {
+                    sizeClass++;
+                }
+                lookup[i] = static_cast<uint8_t>(sizeClass);
+            }
+            return lookup;
+        }();
+
+        std::array<SizeClass, NUM_SIZE_CLASSES> m_sizeClasses;
+    };
+
+    //Destroys and frees objects created by MakePooled. Keeps the size of the allocated type,
+    //so a PoolPtr<Base> can own a Derived as long as Base has a virtual destructor.
+    template<class T>
+    struct SlabDeleter {
+        constexpr SlabDeleter() noexcept = default;
+
+        template<class U> requires std::convertible_to<U*, T*>
+        constexpr SlabDeleter(const SlabDeleter<U>& rhs) noexcept : Size(rhs.Size), Alignment(rhs.Alignment) {}
+
+        void operator()(T* ptr) const noexcept {
+            //The allocation starts at the most derived object, which differs from ptr for non primary bases
+            void* allocation;
+
+            if constexpr (std::is_polymorphic_v<T>) {
+                allocation = dynamic_cast<void*>(ptr);
+            }
+            else {
+                allocation = ptr;
+            }
+
+            std::destroy_at(ptr);
+            SlabAllocator::Get().Free(allocation, Size, Alignment);
+        }
+
+        uint32_t Size{ sizeof(T) };
+        uint32_t Alignment{ alignof(T) };
+    };
+
+    template<class T>
+    using PoolPtr = std::unique_ptr<T, SlabDeleter<T>>;
+
+    template<class T>
+    [[nodiscard]] PoolPtr<T> MakePooled(auto&&... args) {
+        void* memory = SlabAllocator::Get().Allocate(sizeof(T), alignof(T));
+
+        try {
+            return PoolPtr<T>(std::construct_at(static_cast<T*>(memory), std::forward<decltype(args)>(args)...));
+        }
+        catch (...) {
+            SlabAllocator::Get().Free(memory, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+}
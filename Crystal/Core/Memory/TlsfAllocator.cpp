@@ -0,0 +1,383 @@
+#include "TlsfAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+using namespace Crystal;
+
+namespace impl {
+    [[nodiscard]] constexpr uint64_t AlignOffset(uint64_t value, uint64_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity, uint64_t granularity)
+    :
+    m_capacity(capacity & ~(granularity - 1)),
+    m_granularity(granularity)
+{
+    assert(std::has_single_bit(granularity) && "Granularity has to be a power of two");
+    assert(m_capacity > 0 && "Capacity has to hold at least one granule");
+
+    Reset();
+}
+
+void TlsfAllocator::Reset() {
+    m_nodes.clear();
+    m_unusedNodes = NONE;
+    m_usedBytes   = 0;
+    m_allocations = 0;
+
+    m_firstLevelBitmap = 0;
+    m_secondLevelBitmaps.fill(0);
+
+    for (auto& lists : m_freeLists) {
+        lists.fill(NONE);
+    }
+
+    m_firstNode = CreateNode(0, m_capacity);
+    InsertFreeNode(m_firstNode);
+}
+
+//Sizes below SECOND_LEVEL_COUNT map to first level 0 one to one, everything above is split logarithmically
+TlsfAllocator::Bucket TlsfAllocator::MapRoundDown(uint64_t size) noexcept {
+    if (size < SECOND_LEVEL_COUNT) {
+        return { 0, static_cast<uint32_t>(size) };
+    }
+
+    const auto mostSignificantBit = static_cast<uint32_t>(std::bit_width(size) - 1);
+    const auto shift              = mostSignificantBit - SECOND_LEVEL_LOG2;
+
+    return {
+        .FirstLevel  = shift + 1,
+        .SecondLevel = static_cast<uint32_t>(size >> shift) - SECOND_LEVEL_COUNT
+    };
+}
+
+//Rounds up to the next bucket boundary, every block in the resulting bucket is at least as large as the size
+TlsfAllocator::Bucket TlsfAllocator::MapRoundUp(uint64_t size) noexcept {
+    if (size >= SECOND_LEVEL_COUNT) {
+        const auto shift = static_cast<uint32_t>(std::bit_width(size) - 1) - SECOND_LEVEL_LOG2;
+        size += (uint64_t{ 1 } << shift) - 1;
+    }
+    return MapRoundDown(size);
+}
+
+uint32_t TlsfAllocator::FindFreeNode(uint64_t size) const noexcept {
+    auto [firstLevel, secondLevel] = MapRoundUp(size);
+
+    if (firstLevel >= FIRST_LEVEL_COUNT) [[unlikely]] {
+        return NONE;
+    }
+
+    auto secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+
+    if (secondLevelMap == 0) {
+        const auto firstLevelMap = m_firstLevelBitmap & (~uint64_t{ 0 } << (firstLevel + 1));
+
+        if (firstLevelMap == 0) {
+            return NONE;
+        }
+
+        firstLevel     = static_cast<uint32_t>(std::countr_zero(firstLevelMap));
+        secondLevelMap = m_secondLevelBitmaps[firstLevel];
+    }
+
+    secondLevel = static_cast<uint32_t>(std::countr_zero(secondLevelMap));
+    return m_freeLists[firstLevel][secondLevel];
+}
+
+void TlsfAllocator::InsertFreeNode(uint32_t node) noexcept {
+    const auto [firstLevel, secondLevel] = MapRoundDown(m_nodes[node].Size);
+    auto& head = m_freeLists[firstLevel][secondLevel];
+
+    m_nodes[node].PreviousFree = NONE;
+    m_nodes[node].NextFree     = head;
+
+    if (head != NONE) {
+        m_nodes[head].PreviousFree = node;
+    }
+    head = node;
+
+    m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    m_firstLevelBitmap               |= uint64_t{ 1 } << firstLevel;
+}
+
+void TlsfAllocator::RemoveFreeNode(uint32_t node) noexcept {
+    const auto& current = m_nodes[node];
+
+    if (current.PreviousFree != NONE) {
+        m_nodes[current.PreviousFree].NextFree = current.NextFree;
+    }
+    else {
+        //The node is the head of its list
+        const auto [firstLevel, secondLevel] = MapRoundDown(current.Size);
+        auto& head = m_freeLists[firstLevel][secondLevel];
+        head       = current.NextFree;
+
+        if (head == NONE) {
+            m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+            if (m_secondLevelBitmaps[firstLevel] == 0) {
+                m_firstLevelBitmap &= ~(uint64_t{ 1 } << firstLevel);
+            }
+        }
+    }
+
+    if (current.NextFree != NONE) {
+        m_nodes[current.NextFree].PreviousFree = current.PreviousFree;
+    }
+}
+
+uint32_t TlsfAllocator::CreateNode(uint64_t offset, uint64_t size) {
+    uint32_t node;
+
+    if (m_unusedNodes != NONE) {
+        node          = m_unusedNodes;
+        m_unusedNodes = m_nodes[node].NextFree;
+    }
+    else {
+        node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    m_nodes[node] = Node{ .Offset = offset, .Size = size };
+    return node;
+}
+
+void TlsfAllocator::DestroyNode(uint32_t node) noexcept {
+    m_nodes[node] = Node{ .NextFree = m_unusedNodes };
+    m_unusedNodes = node;
+}
+
+uint32_t TlsfAllocator::Split(uint32_t node, uint64_t size) {
+    const auto remainder = CreateNode(m_nodes[node].Offset + size, m_nodes[node].Size - size);
+    const auto next      = m_nodes[node].NextPhysical;
+
+    m_nodes[remainder].PreviousPhysical = node;
+    m_nodes[remainder].NextPhysical     = next;
+
+    if (next != NONE) {
+        m_nodes[next].PreviousPhysical = remainder;
+    }
+
+    m_nodes[node].NextPhysical = remainder;
+    m_nodes[node].Size         = size;
+
+    return remainder;
+}
+
+void TlsfAllocator::MergeWithNext(uint32_t node) noexcept {
+    const auto next      = m_nodes[node].NextPhysical;
+    const auto afterNext = m_nodes[next].NextPhysical;
+
+    m_nodes[node].Size        += m_nodes[next].Size;
+    m_nodes[node].NextPhysical = afterNext;
+
+    if (afterNext != NONE) {
+        m_nodes[afterNext].PreviousPhysical = node;
+    }
+    DestroyNode(next);
+}
+
+std::optional<TlsfAllocation> TlsfAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment) {
+    assert(std::has_single_bit(alignment) && "Alignment has to be a power of two");
+
+    alignment       = std::max(alignment, m_granularity);
+    const auto size = impl::AlignOffset(std::max<uint64_t>(sizeInBytes, 1), m_granularity);
+
+    if (size > m_capacity) [[unlikely]] {
+        return {};
+    }
+
+    auto node = FindFreeNode(size);
+
+    //Blocks only start at multiples of the granularity, a larger alignment needs room for the padding in front
+    if (alignment > m_granularity && (node == NONE || (m_nodes[node].Offset & (alignment - 1)) != 0)) {
+        node = FindFreeNode(size + alignment - m_granularity);
+    }
+
+    if (node == NONE) {
+        return {};
+    }
+
+    //Splitting needs up to two new nodes, grow the node array up front so nothing throws once the lists are modified
+    if (m_nodes.capacity() - m_nodes.size() < 2) {
+        m_nodes.reserve(std::max<size_t>(m_nodes.size() * 2, 64));
+    }
+
+    RemoveFreeNode(node);
+
+    const auto offset  = m_nodes[node].Offset;
+    const auto padding = impl::AlignOffset(offset, alignment) - offset;
+
+    if (padding > 0) {
+        const auto aligned = Split(node, padding);
+        InsertFreeNode(node);
+        node = aligned;
+    }
+
+    if (m_nodes[node].Size > size) {
+        InsertFreeNode(Split(node, size));
+    }
+
+    m_nodes[node].Used = true;
+    m_usedBytes       += size;
+    m_allocations++;
+
+    return TlsfAllocation{ .Offset = m_nodes[node].Offset, .Size = size, .Node = node };
+}
+
+void TlsfAllocator::Free(const TlsfAllocation& allocation) noexcept {
+    auto node = allocation.Node;
+
+    assert(node < m_nodes.size() && m_nodes[node].Used && m_nodes[node].Offset == allocation.Offset && "Invalid or double freed allocation");
+
+    m_nodes[node].Used = false;
+    m_usedBytes       -= m_nodes[node].Size;
+    m_allocations--;
+
+    const auto next = m_nodes[node].NextPhysical;
+
+    if (next != NONE && !m_nodes[next].Used) {
+        RemoveFreeNode(next);
+        MergeWithNext(node);
+    }
+
+    const auto previous = m_nodes[node].PreviousPhysical;
+
+    if (previous != NONE && !m_nodes[previous].Used) {
+        RemoveFreeNode(previous);
+        MergeWithNext(previous);
+        node = previous;
+    }
+
+    InsertFreeNode(node);
+}
+
+TlsfStatistics TlsfAllocator::GetStatistics() const noexcept {
+    TlsfStatistics statistics{
+        .Capacity    = m_capacity,
+        .UsedBytes   = m_usedBytes,
+        .FreeBytes   = m_capacity - m_usedBytes,
+        .Allocations = m_allocations
+    };
+
+    for (auto node = m_firstNode; node != NONE; node = m_nodes[node].NextPhysical) {
+        if (!m_nodes[node].Used) {
+            statistics.FreeBlocks++;
+            statistics.LargestFreeBlock = std::max(statistics.LargestFreeBlock, m_nodes[node].Size);
+        }
+    }
+    return statistics;
+}
+
+std::vector<TlsfDefragmentationHint> TlsfAllocator::GetDefragmentationHints(size_t maxHints) const {
+    std::vector<TlsfDefragmentationHint> hints;
+
+    for (auto node = m_firstNode; node != NONE; node = m_nodes[node].NextPhysical) {
+        const auto& current = m_nodes[node];
+
+        if (!current.Used) {
+            continue;
+        }
+
+        uint64_t freeNeighbours = 0;
+
+        if (current.PreviousPhysical != NONE && !m_nodes[current.PreviousPhysical].Used) {
+            freeNeighbours += m_nodes[current.PreviousPhysical].Size;
+        }
+
+        if (current.NextPhysical != NONE && !m_nodes[current.NextPhysical].Used) {
+            freeNeighbours += m_nodes[current.NextPhysical].Size;
+        }
+
+        if (freeNeighbours > 0) {
+            hints.push_back({
+                .Allocation      = { .Offset = current.Offset, .Size = current.Size, .Node = node },
+                .MergedFreeBytes = freeNeighbours + current.Size
+            });
+        }
+    }
+
+    //Prefer moves that open up the most space, and among those the ones that copy the least
+    const auto count = std::min(maxHints, hints.size());
+
+    std::partial_sort(hints.begin(), hints.begin() + count, hints.end(), [](const auto& lhs, const auto& rhs) {
+        if (lhs.MergedFreeBytes != rhs.MergedFreeBytes) {
+            return lhs.MergedFreeBytes > rhs.MergedFreeBytes;
+        }
+        return lhs.Allocation.Size < rhs.Allocation.Size;
+    });
+
+    hints.resize(count);
+    return hints;
+}
+
+bool TlsfAllocator::Validate() const noexcept {
+    uint64_t expectedOffset = 0;
+    uint64_t usedBytes      = 0;
+    uint32_t allocations    = 0;
+    uint32_t freeBlocks     = 0;
+    auto previous           = NONE;
+
+    for (auto node = m_firstNode; node != NONE; node = m_nodes[node].NextPhysical) {
+        const auto& current = m_nodes[node];
+
+        if (current.Offset != expectedOffset || current.Size == 0 || current.PreviousPhysical != previous) {
+            return false;
+        }
+
+        if (current.Offset % m_granularity != 0 || current.Size % m_granularity != 0) {
+            return false;
+        }
+
+        if (current.Used) {
+            usedBytes += current.Size;
+            allocations++;
+        }
+        else {
+            //Two free neighbours should have been merged
+            if (previous != NONE && !m_nodes[previous].Used) {
+                return false;
+            }
+            freeBlocks++;
+        }
+
+        expectedOffset = current.Offset + current.Size;
+        previous       = node;
+    }
+
+    if (expectedOffset != m_capacity || usedBytes != m_usedBytes || allocations != m_allocations) {
+        return false;
+    }
+
+    //Every free block has to be in the list of its bucket, and the bitmaps have to match the lists
+    uint32_t listedBlocks = 0;
+
+    for (uint32_t firstLevel = 0; firstLevel < FIRST_LEVEL_COUNT; firstLevel++) {
+        for (uint32_t secondLevel = 0; secondLevel < SECOND_LEVEL_COUNT; secondLevel++) {
+            const auto head    = m_freeLists[firstLevel][secondLevel];
+            const bool flagged = (m_secondLevelBitmaps[firstLevel] >> secondLevel) & 1u;
+
+            if ((head != NONE) != flagged) {
+                return false;
+            }
+
+            for (auto node = head; node != NONE; node = m_nodes[node].NextFree) {
+                const auto bucket = MapRoundDown(m_nodes[node].Size);
+
+                if (m_nodes[node].Used || bucket.FirstLevel != firstLevel || bucket.SecondLevel != secondLevel) {
+                    return false;
+                }
+                listedBlocks++;
+            }
+        }
+
+        if (((m_firstLevelBitmap >> firstLevel) & 1u) != (m_secondLevelBitmaps[firstLevel] != 0)) {
+            return false;
+        }
+    }
+    return listedBlocks == freeBlocks;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace Crystal {
+    struct TlsfAllocation {
+        static constexpr uint32_t INVALID_NODE = std::numeric_limits<uint32_t>::max();
+
+        uint64_t Offset{};
+        uint64_t Size{};
+
+        //Handle of the block inside the allocator, needed to free the allocation again
+        uint32_t Node{ INVALID_NODE };
+
+        [[nodiscard]] bool IsValid() const noexcept { return Node != INVALID_NODE; }
+    };
+
+    struct TlsfStatistics {
+        uint64_t Capacity{};
+        uint64_t UsedBytes{};
+        uint64_t FreeBytes{};
+        uint64_t LargestFreeBlock{};
+        uint32_t Allocations{};
+        uint32_t FreeBlocks{};
+
+        //0 when all free space is one block, approaches 1 the more the free space is split into small pieces
+        [[nodiscard]] double Fragmentation() const noexcept {
+            return FreeBytes > 0 ? 1.0 - static_cast<double>(LargestFreeBlock) / static_cast<double>(FreeBytes) : 0.0;
+        }
+    };
+
+    //An allocation that sits between free space. Moving it elsewhere merges the surrounding free blocks into one.
+    struct TlsfDefragmentationHint {
+        TlsfAllocation Allocation;
+
+        //Size of the free block that is left behind once the allocation has moved
+        uint64_t MergedFreeBytes{};
+    };
+
+    //Two level segregated fit allocator for offsets into a range, e.g. a GPU heap.
+    //It never touches the memory it manages, all bookkeeping lives in a node array on the CPU side,
+    //so the same allocator can hand out ranges of a D3D12 heap, an upload buffer or anything else with offsets.
+    //Allocating and freeing are O(1): free blocks are kept in lists bucketed by size, two bitmaps tell which lists are not empty.
+    class TlsfAllocator {
+    public:
+        //Every first level bucket (a power of two) is split into this many linear second level buckets
+        static constexpr uint32_t SECOND_LEVEL_LOG2  = 5;
+        static constexpr uint32_t SECOND_LEVEL_COUNT = 1u << SECOND_LEVEL_LOG2;
+        static constexpr uint32_t FIRST_LEVEL_COUNT  = 64 - SECOND_LEVEL_LOG2 + 1;
+
+        //All sizes and offsets are multiples of the granularity, it has to be a power of two
+        explicit TlsfAllocator(uint64_t capacity, uint64_t granularity = 1);
+
+        [[nodiscard]] std::optional<TlsfAllocation> Allocate(uint64_t sizeInBytes, uint64_t alignment = 1);
+        void Free(const TlsfAllocation& allocation) noexcept;
+
+        //Frees every allocation, handles handed out before must not be freed afterwards
+        void Reset();
+
+        [[nodiscard]] uint64_t GetCapacity()    const noexcept { return m_capacity; }
+        [[nodiscard]] uint64_t GetGranularity() const noexcept { return m_granularity; }
+        [[nodiscard]] uint64_t GetUsedBytes()   const noexcept { return m_usedBytes; }
+        [[nodiscard]] uint32_t GetAllocationCount() const noexcept { return m_allocations; }
+        [[nodiscard]] bool IsEmpty() const noexcept { return m_allocations == 0; }
+
+        [[nodiscard]] TlsfStatistics GetStatistics() const noexcept;
+
+        //Allocations worth moving to reduce fragmentation, the ones that free up the largest contiguous range come first
+        [[nodiscard]] std::vector<TlsfDefragmentationHint> GetDefragmentationHints(size_t maxHints) const;
+
+        //Walks all blocks and checks the internal invariants, meant for debugging and benchmarks
+        [[nodiscard]] bool Validate() const noexcept;
+    private:
+        static constexpr uint32_t NONE = TlsfAllocation::INVALID_NODE;
+
+        struct Node {
+            uint64_t Offset{};
+            uint64_t Size{};
+
+            //Neighbours in address order
+            uint32_t PreviousPhysical{ NONE };
+            uint32_t NextPhysical{ NONE };
+
+            //Neighbours in the free list of the bucket, the next unused node while the node is not in use at all
+            uint32_t PreviousFree{ NONE };
+            uint32_t NextFree{ NONE };
+
+            bool Used{ false };
+        };
+
+        struct Bucket {
+            uint32_t FirstLevel;
+            uint32_t SecondLevel;
+        };
+
+        [[nodiscard]] static Bucket MapRoundDown(uint64_t size) noexcept;
+        [[nodiscard]] static Bucket MapRoundUp(uint64_t size) noexcept;
+
+        [[nodiscard]] uint32_t FindFreeNode(uint64_t size) const noexcept;
+        void InsertFreeNode(uint32_t node) noexcept;
+        void RemoveFreeNode(uint32_t node) noexcept;
+
+        [[nodiscard]] uint32_t CreateNode(uint64_t offset, uint64_t size);
+        void DestroyNode(uint32_t node) noexcept;
+
+        //Shrinks a node to the given size and returns the node created for the remainder
+        [[nodiscard]] uint32_t Split(uint32_t node, uint64_t size);
+        void MergeWithNext(uint32_t node) noexcept;
+
+        uint64_t m_capacity;
+        uint64_t m_granularity;
+        uint64_t m_usedBytes{ 0 };
+        uint32_t m_allocations{ 0 };
+
+        std::vector<Node> m_nodes;
+        uint32_t m_firstNode{ NONE };
+        uint32_t m_unusedNodes{ NONE };
+
+        uint64_t m_firstLevelBitmap{ 0 };
+        std::array<uint32_t, FIRST_LEVEL_COUNT> m_secondLevelBitmaps{};
+        std::array<std::array<uint32_t, SECOND_LEVEL_COUNT>, FIRST_LEVEL_COUNT> m_freeLists{};
+    };
+}
@@ -0,0 +1,270 @@
+#include "PerfCounters.h"
+#include "Core/InstructionSet/CpuInfo.h"
+#include "Core/Logging/Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <format>
+#include <mutex>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace Crystal;
+
+namespace impl {
+    std::atomic_bool perfCountersEnabled{ false };
+    std::once_flag unavailableWarning;
+
+    std::mutex regionMutex;
+    std::vector<PerfRegionStatistics> regions;
+
+#ifdef __linux__
+    struct CounterConfig {
+        uint32_t Type;
+        uint64_t Config;
+    };
+
+    constexpr std::array<CounterConfig, PerfCounterValues::NUM_COUNTERS> counterConfigs{ {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    } };
+
+    int OpenCounter(const CounterConfig& config, int groupFd) noexcept {
+        perf_event_attr attributes{};
+
+        attributes.size        = sizeof(perf_event_attr);
+        attributes.type        = config.Type;
+        attributes.config      = config.Config;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        //User space only, this keeps working with perf_event_paranoid set to 2
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv     = 1;
+
+        //Measure the calling thread on whatever cpu it runs on
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0));
+    }
+#endif
+}
+
+void PerfCounters::SetEnabled(bool enabled) noexcept {
+    impl::perfCountersEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool PerfCounters::IsEnabled() noexcept {
+    return impl::perfCountersEnabled.load(std::memory_order_relaxed);
+}
+
+PerfCounters& PerfCounters::ForCurrentThread() noexcept {
+    thread_local PerfCounters perfCounters;
+    return perfCounters;
+}
+
+PerfCounters::PerfCounters() noexcept {
+    m_fds.fill(-1);
+
+#ifdef __linux__
+    int firstError = 0;
+
+    //Virtual machines often lack some of the events, e.g. cycles, the first counter that opens leads the group
+    for (uint32_t i = 0; i < PerfCounterValues::NUM_COUNTERS; i++) {
+        m_fds[i] = impl::OpenCounter(impl::counterConfigs[i], m_groupFd);
+
+        if (m_fds[i] < 0) {
+            firstError = firstError == 0 ? errno : firstError;
+            continue;
+        }
+
+        m_opened[i] = true;
+
+        if (m_groupFd < 0) {
+            m_groupFd = m_fds[i];
+        }
+    }
+
+    if (m_groupFd < 0) {
+        m_unavailableReason = std::strerror(firstError);
+
+        if (firstError == EACCES || firstError == EPERM) {
+            m_unavailableReason += ", check /proc/sys/kernel/perf_event_paranoid";
+        }
+    }
+
+    if (m_groupFd >= 0) {
+        ioctl(m_groupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_groupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#else
+    m_unavailableReason = "hardware counters are only supported on Linux";
+#endif
+
+    if (!IsAvailable()) {
+        std::call_once(impl::unavailableWarning, [this] {
+            Logger::Warning("Hardware performance counters are unavailable: {}", m_unavailableReason);
+        });
+    }
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    //Close the members before the group leader
+    for (auto i = m_fds.rbegin(); i != m_fds.rend(); i++) {
+        if (*i >= 0) {
+            close(*i);
+        }
+    }
+#endif
+}
+
+std::optional<PerfCounterValues> PerfCounters::Read() const noexcept {
+    if (!IsAvailable()) {
+        return {};
+    }
+
+#ifdef __linux__
+    struct ReadFormat {
+        uint64_t NumCounters;
+        uint64_t TimeEnabled;
+        uint64_t TimeRunning;
+
+        struct {
+            uint64_t Value;
+            uint64_t Id;
+        } Counters[PerfCounterValues::NUM_COUNTERS];
+    } data{};
+
+    if (read(m_groupFd, &data, sizeof(data)) <= 0) [[unlikely]] {
+        return {};
+    }
+
+    //The group was not always on the pmu, extrapolate to the time it was enabled
+    const auto scale = data.TimeRunning > 0 && data.TimeRunning < data.TimeEnabled
+        ? static_cast<double>(data.TimeEnabled) / static_cast<double>(data.TimeRunning)
+        : 1.0;
+
+    PerfCounterValues values;
+    uint64_t index = 0;
+
+    //Values are reported in the order the counters were added to the group
+    for (uint32_t i = 0; i < PerfCounterValues::NUM_COUNTERS && index < data.NumCounters; i++) {
+        if (!m_opened[i]) {
+            continue;
+        }
+
+        values.Values[i] = static_cast<uint64_t>(static_cast<double>(data.Counters[index].Value) * scale);
+        values.Valid[i]  = true;
+        index++;
+    }
+    return values;
+#else
+    return {};
+#endif
+}
+
+ScopedPerfRegion::ScopedPerfRegion(std::string_view name) noexcept
+    :
+    m_name(name)
+{
+    if (PerfCounters::IsEnabled()) {
+        m_begin = PerfCounters::ForCurrentThread().Read();
+    }
+}
+
+ScopedPerfRegion::~ScopedPerfRegion() {
+    if (!m_begin) {
+        return;
+    }
+
+    const auto end = PerfCounters::ForCurrentThread().Read();
+
+    if (!end) [[unlikely]] {
+        return;
+    }
+
+    const auto delta = *end - *m_begin;
+
+    std::scoped_lock lock(impl::regionMutex);
+
+    auto region = std::ranges::find(impl::regions, m_name, &PerfRegionStatistics::Name);
+
+    if (region == impl::regions.end()) {
+        region = impl::regions.insert(impl::regions.end(), PerfRegionStatistics{ .Name = std::string(m_name) });
+    }
+
+    region->Calls++;
+    region->Totals += delta;
+}
+
+std::vector<PerfRegionStatistics> ScopedPerfRegion::GetStatistics() {
+    std::scoped_lock lock(impl::regionMutex);
+    return impl::regions;
+}
+
+void ScopedPerfRegion::ResetStatistics() noexcept {
+    std::scoped_lock lock(impl::regionMutex);
+    impl::regions.clear();
+}
+
+std::string Crystal::CreateCpuReportHeader() {
+    const CpuInfo cpuInfo;
+    const auto& info = cpuInfo.Info;
+
+    std::string header = std::format(
+        "CPU: {}\nVendor: {}\nArchitecture: {}\nCores: {} physical, {} logical\nFeatures:",
+        info.BrandString.c_str(),
+        info.Vendor,
+        info.Architecture,
+        info.NumCores,
+        info.NumLogicalProcessors);
+
+    //The features the math and ECS paths actually care about, in a stable order
+    static constexpr std::array features{ "SSE4.1", "SSE4.2", "AVX", "AVX2", "FMA", "F16C", "BMI2", "AVX512F" };
+
+    for (const auto feature : features) {
+        if (const auto it = info.InstructionSetFeatures.find(feature); it != info.InstructionSetFeatures.end() && it->second) {
+            header.append(" ").append(feature);
+        }
+    }
+
+    const auto& counters = PerfCounters::ForCurrentThread();
+
+    header.append(counters.IsAvailable()
+        ? "\nHardware counters: available\n"
+        : std::format("\nHardware counters: unavailable ({})\n", counters.GetUnavailableReason()));
+
+    return header;
+}
+
+std::string Crystal::CreatePerfReport() {
+    auto report = CreateCpuReportHeader();
+
+    report.append(std::format("\n{:<32} {:>10} {:>16} {:>16} {:>6} {:>14} {:>14}\n",
+        "Region", "Calls", "Cycles", "Instructions", "IPC", "LLC misses", "Branch misses"));
+
+    for (const auto& region : ScopedPerfRegion::GetStatistics()) {
+        const auto& totals = region.Totals;
+
+        const auto format = [&totals](PerfCounter counter) {
+            return totals.Has(counter) ? std::to_string(totals[counter]) : std::string("-");
+        };
+
+        report.append(std::format("{:<32} {:>10} {:>16} {:>16} {:>6.2f} {:>14} {:>14}\n",
+            region.Name,
+            region.Calls,
+            format(PerfCounter::Cycles),
+            format(PerfCounter::Instructions),
+            totals.InstructionsPerCycle(),
+            format(PerfCounter::CacheMisses),
+            format(PerfCounter::BranchMisses)));
+    }
+    return report;
+}
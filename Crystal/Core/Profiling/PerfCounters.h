@@ -0,0 +1,115 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crystal {
+    enum class PerfCounter : uint8_t {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        Count
+    };
+
+    [[nodiscard]] constexpr std::string_view ToString(PerfCounter counter) noexcept {
+        switch (counter) {
+        case PerfCounter::Cycles:       return "cycles";
+        case PerfCounter::Instructions: return "instructions";
+        case PerfCounter::CacheMisses:  return "llc-misses";
+        case PerfCounter::BranchMisses: return "branch-misses";
+        default:                        return "unknown";
+        }
+    }
+
+    struct PerfCounterValues {
+        static constexpr uint32_t NUM_COUNTERS = static_cast<uint32_t>(PerfCounter::Count);
+
+        std::array<uint64_t, NUM_COUNTERS> Values{};
+        std::array<bool, NUM_COUNTERS> Valid{};
+
+        [[nodiscard]] constexpr uint64_t operator[](PerfCounter counter) const noexcept { return Values[static_cast<uint32_t>(counter)]; }
+        [[nodiscard]] constexpr bool Has(PerfCounter counter) const noexcept { return Valid[static_cast<uint32_t>(counter)]; }
+
+        [[nodiscard]] constexpr double InstructionsPerCycle() const noexcept {
+            if (!Has(PerfCounter::Cycles) || !Has(PerfCounter::Instructions) || (*this)[PerfCounter::Cycles] == 0) {
+                return 0.0;
+            }
+            return static_cast<double>((*this)[PerfCounter::Instructions]) / static_cast<double>((*this)[PerfCounter::Cycles]);
+        }
+
+        [[nodiscard]] constexpr PerfCounterValues operator-(const PerfCounterValues& rhs) const noexcept {
+            PerfCounterValues result;
+
+            for (uint32_t i = 0; i < NUM_COUNTERS; i++) {
+                result.Valid[i]  = Valid[i] && rhs.Valid[i];
+                result.Values[i] = result.Valid[i] && Values[i] > rhs.Values[i] ? Values[i] - rhs.Values[i] : 0;
+            }
+            return result;
+        }
+
+        constexpr PerfCounterValues& operator+=(const PerfCounterValues& rhs) noexcept {
+            for (uint32_t i = 0; i < NUM_COUNTERS; i++) {
+                Values[i] += rhs.Values[i];
+                Valid[i]   = Valid[i] || rhs.Valid[i];
+            }
+            return *this;
+        }
+    };
+
+    //Hardware counters of the calling thread, opened as one perf_event group so all counters are scheduled together.
+    //Only implemented on Linux, everywhere else and when the kernel denies access the counters are simply unavailable.
+    class PerfCounters {
+    public:
+        PerfCounters(const PerfCounters& rhs)            = delete;
+        PerfCounters& operator=(const PerfCounters& rhs) = delete;
+        ~PerfCounters();
+
+        //Regions only read the counters while enabled, the counters of a thread are opened the first time it uses them
+        static void SetEnabled(bool enabled) noexcept;
+        [[nodiscard]] static bool IsEnabled() noexcept;
+
+        [[nodiscard]] static PerfCounters& ForCurrentThread() noexcept;
+
+        [[nodiscard]] bool IsAvailable() const noexcept { return m_groupFd >= 0; }
+        [[nodiscard]] std::string_view GetUnavailableReason() const noexcept { return m_unavailableReason; }
+
+        //Current counter values, scaled up when the kernel had to multiplex the group
+        [[nodiscard]] std::optional<PerfCounterValues> Read() const noexcept;
+    private:
+        PerfCounters() noexcept;
+
+        int m_groupFd{ -1 };
+        std::array<int, PerfCounterValues::NUM_COUNTERS> m_fds{};
+        std::array<bool, PerfCounterValues::NUM_COUNTERS> m_opened{};
+        std::string m_unavailableReason;
+    };
+
+    struct PerfRegionStatistics {
+        std::string Name;
+        uint64_t Calls{};
+        PerfCounterValues Totals;
+    };
+
+    //Accumulates the counter deltas of a named code region, for every thread that enters it
+    class ScopedPerfRegion {
+    public:
+        explicit ScopedPerfRegion(std::string_view name) noexcept;
+        ScopedPerfRegion(const ScopedPerfRegion&)            = delete;
+        ScopedPerfRegion& operator=(const ScopedPerfRegion&) = delete;
+        ~ScopedPerfRegion();
+
+        [[nodiscard]] static std::vector<PerfRegionStatistics> GetStatistics();
+        static void ResetStatistics() noexcept;
+    private:
+        std::string_view m_name;
+        std::optional<PerfCounterValues> m_begin;
+    };
+
+    //Plain text report of every region, prefixed by the CPU the numbers were measured on
+    [[nodiscard]] std::string CreatePerfReport();
+    [[nodiscard]] std::string CreateCpuReportHeader();
+}
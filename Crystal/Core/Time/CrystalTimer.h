@@ -61,11 +61,11 @@ namespace Crystal {
 
 		void reset() noexcept {
 			m_last    = Clock::now();
-			m_delta   = Clock::duration();
-			m_elapsed = Clock::duration();
+			m_delta   = typename Clock::duration();
+			m_elapsed = typename Clock::duration();
 		}
 		void reset_elapsed() noexcept {
-			m_elapsed = Clock::duration();
+			m_elapsed = typename Clock::duration();
 		}
 
 		template<
@@ -95,7 +95,7 @@ namespace Crystal {
 		}
 	private:
 		Clock::duration m_begin;
-		Clock::duration m_last;
+		typename Clock::time_point m_last;
 		Clock::duration m_delta{ 0 };
 		Clock::duration m_elapsed{ 0 };
 	};
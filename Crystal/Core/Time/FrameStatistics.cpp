@@ -0,0 +1,312 @@
+#include "FrameStatistics.h"
+#include "Core/Logging/Logger.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace Crystal;
+
+void FrameTimeHistogram::Record(uint64_t microseconds) noexcept {
+    m_buckets[BucketIndex(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    auto currentMax = m_max.load(std::memory_order_relaxed);
+    while (microseconds > currentMax && !m_max.compare_exchange_weak(currentMax, microseconds, std::memory_order_relaxed)) {}
+}
+
+void FrameTimeHistogram::Reset() noexcept {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+uint64_t FrameTimeHistogram::Percentile(double percentile) const noexcept {
+    const auto count = Count();
+
+    if (count == 0) {
+        return 0;
+    }
+
+    //The rank of the sample we are looking for, 1 based
+    const auto clamped = std::clamp(percentile, 0.0, 100.0);
+    const auto rank    = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * static_cast<double>(count))));
+
+    uint64_t accumulated = 0;
+
+    for (uint32_t i = 0; i < NUM_BUCKETS; i++) {
+        accumulated += m_buckets[i].load(std::memory_order_relaxed);
+
+        if (accumulated >= rank) {
+            //Report the highest value that is equivalent to this bucket, but never more than what was recorded
+            return std::min(BucketUpperBound(i), Max());
+        }
+    }
+    return Max();
+}
+
+double FrameTimeHistogram::Mean() const noexcept {
+    const auto count = Count();
+    return count > 0 ? static_cast<double>(m_sum.load(std::memory_order_relaxed)) / static_cast<double>(count) : 0.0;
+}
+
+FrameStatistics::ScopedStage::ScopedStage(std::string_view name) noexcept
+    :
+    m_stageId(FrameStatistics::Get().RegisterStage(name)),
+    m_begin(std::chrono::steady_clock::now())
+{}
+
+FrameStatistics::ScopedStage::ScopedStage(uint32_t stageId) noexcept
+    :
+    m_stageId(stageId),
+    m_begin(std::chrono::steady_clock::now())
+{}
+
+FrameStatistics::ScopedStage::~ScopedStage() {
+    if (m_stageId) {
+        const auto duration = std::chrono::steady_clock::now() - m_begin;
+        FrameStatistics::Get().RecordStage(*m_stageId, std::chrono::duration_cast<std::chrono::microseconds>(duration));
+    }
+}
+
+FrameStatistics::FrameStatistics() noexcept {
+    const auto frameStage = RegisterStage("Frame");
+    (void)frameStage;
+}
+
+std::optional<uint32_t> FrameStatistics::FindStage(std::string_view name) const noexcept {
+    const auto stageCount = m_stageCount.load(std::memory_order_acquire);
+
+    //Names are stored truncated, a longer name has to find the stage it registered
+    name = name.substr(0, MAX_NAME_LENGTH - 1);
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        if (m_stages[i].GetName() == name) {
+            return i;
+        }
+    }
+    return {};
+}
+
+std::optional<uint32_t> FrameStatistics::RegisterStage(std::string_view name) noexcept {
+    //Lock-free fast path for stages that already exist
+    if (const auto stageId = FindStage(name)) {
+        return stageId;
+    }
+
+    std::scoped_lock lock(m_registrationMutex);
+
+    //Another thread might have registered the stage while we were waiting for the lock
+    if (const auto stageId = FindStage(name)) {
+        return stageId;
+    }
+
+    const auto stageCount = m_stageCount.load(std::memory_order_relaxed);
+
+    if (stageCount == MAX_STAGES) [[unlikely]] {
+        Logger::Warning("Unable to register frame stage {}, the maximum number of stages ({}) has been reached", name, MAX_STAGES);
+        return {};
+    }
+
+    auto& stage = m_stages[stageCount];
+    std::ranges::copy(name.substr(0, MAX_NAME_LENGTH - 1), stage.Name.begin());
+
+    //Publish the stage after its name has been written
+    m_stageCount.store(stageCount + 1, std::memory_order_release);
+
+    return stageCount;
+}
+
+void FrameStatistics::RecordStage(uint32_t stageId, std::chrono::microseconds duration) noexcept {
+    if (stageId < GetStageCount()) [[likely]] {
+        m_stages[stageId].CurrentFrameMicroseconds.fetch_add(duration.count(), std::memory_order_relaxed);
+    }
+}
+
+void FrameStatistics::EndFrame() noexcept {
+    m_frameTimer.tick();
+
+    const auto frameIndex        = m_frameCount.load(std::memory_order_relaxed);
+    const auto frameMicroseconds = static_cast<uint64_t>(m_frameTimer.get_delta<double, std::micro>());
+
+    FrameRecord record{
+        .FrameIndex   = frameIndex,
+        .Microseconds = static_cast<uint32_t>(std::min<uint64_t>(frameMicroseconds, std::numeric_limits<uint32_t>::max()))
+    };
+
+    m_stages[FRAME_STAGE].CurrentFrameMicroseconds.store(frameMicroseconds, std::memory_order_relaxed);
+
+    const auto stageCount = GetStageCount();
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        const auto microseconds = m_stages[i].CurrentFrameMicroseconds.exchange(0, std::memory_order_relaxed);
+
+        //Stages that did not run this frame do not contribute to the distribution
+        if (microseconds > 0 || i == FRAME_STAGE) {
+            m_stages[i].Histogram.Record(microseconds);
+        }
+        record.StageMicroseconds[i] = static_cast<uint32_t>(std::min<uint64_t>(microseconds, std::numeric_limits<uint32_t>::max()));
+    }
+
+    //Publish the record to readers
+    PublishRecentFrame(record);
+    m_frameCount.store(frameIndex + 1, std::memory_order_release);
+
+    //The median moves slowly, so there is no need to walk the histogram every frame
+    if (frameIndex % 32 == 0) {
+        m_medianFrameMicroseconds = m_stages[FRAME_STAGE].Histogram.Percentile(50.0);
+    }
+
+    const auto spikeThreshold = std::max(
+        m_spikeMinimumMicroseconds.load(std::memory_order_relaxed),
+        static_cast<uint64_t>(static_cast<double>(m_medianFrameMicroseconds) * m_spikeFactor.load(std::memory_order_relaxed)));
+
+    //The first frame includes everything that happened before the frame loop started
+    if (frameIndex > 0 && frameMicroseconds > spikeThreshold) [[unlikely]] {
+        std::scoped_lock lock(m_spikeMutex);
+
+        m_spikes[m_spikeCount % MAX_SPIKES] = record;
+        m_spikeCount++;
+    }
+}
+
+void FrameStatistics::Reset() noexcept {
+    const auto stageCount = GetStageCount();
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        m_stages[i].CurrentFrameMicroseconds.store(0, std::memory_order_relaxed);
+        m_stages[i].Histogram.Reset();
+    }
+
+    {
+        std::scoped_lock lock(m_spikeMutex);
+        m_spikeCount = 0;
+    }
+
+    m_medianFrameMicroseconds = 0;
+    m_frameCount.store(0, std::memory_order_release);
+    m_frameTimer.reset();
+}
+
+void FrameStatistics::SetSpikeThreshold(float spikeFactor, std::chrono::microseconds minimum) noexcept {
+    m_spikeFactor.store(spikeFactor, std::memory_order_relaxed);
+    m_spikeMinimumMicroseconds.store(minimum.count(), std::memory_order_relaxed);
+}
+
+std::optional<FrameStageStatistics> FrameStatistics::GetStageStatistics(std::string_view name) const noexcept {
+    if (const auto stageId = FindStage(name)) {
+        return GetStageStatistics(*stageId);
+    }
+    return {};
+}
+
+std::optional<FrameStageStatistics> FrameStatistics::GetStageStatistics(uint32_t stageId) const noexcept {
+    if (stageId >= GetStageCount()) {
+        return {};
+    }
+
+    const auto& stage     = m_stages[stageId];
+    const auto& histogram = stage.Histogram;
+
+    return FrameStageStatistics{
+        .Name  = stage.GetName(),
+        .Count = histogram.Count(),
+        .Mean  = histogram.Mean(),
+        .P50   = histogram.Percentile(50.0),
+        .P95   = histogram.Percentile(95.0),
+        .P99   = histogram.Percentile(99.0),
+        .Max   = histogram.Max()
+    };
+}
+
+std::vector<FrameStageStatistics> FrameStatistics::GetAllStageStatistics() const {
+    std::vector<FrameStageStatistics> statistics;
+
+    const auto stageCount = GetStageCount();
+    statistics.reserve(stageCount);
+
+    for (uint32_t i = 0; i < stageCount; i++) {
+        statistics.emplace_back(*GetStageStatistics(i));
+    }
+    return statistics;
+}
+
+std::vector<FrameStatistics::FrameRecord> FrameStatistics::GetRecentFrames(uint32_t maxFrames) const {
+    const auto frameCount = GetFrameCount();
+    const auto numFrames  = std::min<uint64_t>({ frameCount, maxFrames, MAX_RECENT_FRAMES });
+
+    std::vector<FrameRecord> frames;
+    frames.reserve(numFrames);
+
+    //Frames the writer overwrote while we were copying are left out
+    for (auto i = frameCount - numFrames; i < frameCount; i++) {
+        if (const auto frame = ReadRecentFrame(i)) {
+            frames.push_back(*frame);
+        }
+    }
+    return frames;
+}
+
+void FrameStatistics::PublishRecentFrame(const FrameRecord& record) noexcept {
+    const auto words = std::bit_cast<std::array<uint32_t, RecentFrameSlot::NUM_WORDS>>(record);
+
+    auto& slot          = m_recentFrames[record.FrameIndex % MAX_RECENT_FRAMES];
+    const auto sequence = slot.Sequence.load(std::memory_order_relaxed);
+
+    //The odd sequence has to be visible before any of the words change
+    slot.Sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    for (size_t i = 0; i < words.size(); i++) {
+        slot.Words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.Sequence.store(sequence + 2, std::memory_order_release);
+}
+
+std::optional<FrameStatistics::FrameRecord> FrameStatistics::ReadRecentFrame(uint64_t frameIndex) const noexcept {
+    const auto& slot    = m_recentFrames[frameIndex % MAX_RECENT_FRAMES];
+    const auto sequence = slot.Sequence.load(std::memory_order_acquire);
+
+    if (sequence % 2 != 0) {
+        return {};
+    }
+
+    std::array<uint32_t, RecentFrameSlot::NUM_WORDS> words{};
+
+    for (size_t i = 0; i < words.size(); i++) {
+        words[i] = slot.Words[i].load(std::memory_order_relaxed);
+    }
+
+    //The words have to be read before the sequence is checked again
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (slot.Sequence.load(std::memory_order_relaxed) != sequence) {
+        return {};
+    }
+
+    const auto record = std::bit_cast<FrameRecord>(words);
+
+    //A newer frame may have been published into the slot before we got to it
+    if (record.FrameIndex != frameIndex) {
+        return {};
+    }
+    return record;
+}
+
+std::vector<FrameStatistics::FrameRecord> FrameStatistics::GetSpikes() const {
+    std::scoped_lock lock(m_spikeMutex);
+
+    const auto numSpikes = std::min<uint64_t>(m_spikeCount, MAX_SPIKES);
+
+    std::vector<FrameRecord> spikes;
+    spikes.reserve(numSpikes);
+
+    for (auto i = m_spikeCount - numSpikes; i < m_spikeCount; i++) {
+        spikes.push_back(m_spikes[i % MAX_SPIKES]);
+    }
+    return spikes;
+}
@@ -0,0 +1,189 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "CrystalTimer.h"
+
+namespace Crystal {
+    //HDR style histogram of durations in microseconds.
+    //Values are grouped into power of two buckets which are split into linear sub buckets,
+    //this bounds the relative error of every reported percentile to 1 / SUB_BUCKET_COUNT.
+    //Recording is lock-free and may happen from any thread.
+    class FrameTimeHistogram {
+    public:
+        static constexpr uint32_t SUB_BUCKET_BITS  = 5;
+        static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+        static constexpr uint32_t MAX_VALUE_BITS   = 36;
+        static constexpr uint32_t NUM_BUCKETS      = SUB_BUCKET_COUNT * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1);
+
+        FrameTimeHistogram() noexcept = default;
+        FrameTimeHistogram(const FrameTimeHistogram&)            = delete;
+        FrameTimeHistogram& operator=(const FrameTimeHistogram&) = delete;
+
+        void Record(uint64_t microseconds) noexcept;
+        void Reset() noexcept;
+
+        [[nodiscard]] uint64_t Percentile(double percentile) const noexcept;
+        [[nodiscard]] uint64_t Max()   const noexcept { return m_max.load(std::memory_order_relaxed); }
+        [[nodiscard]] uint64_t Count() const noexcept { return m_count.load(std::memory_order_relaxed); }
+        [[nodiscard]] double Mean() const noexcept;
+
+        [[nodiscard]] static constexpr uint32_t BucketIndex(uint64_t value) noexcept {
+            value = std::min(value, (uint64_t{ 1 } << MAX_VALUE_BITS) - 1);
+
+            //Values below SUB_BUCKET_COUNT are stored exactly
+            if (value < SUB_BUCKET_COUNT) {
+                return static_cast<uint32_t>(value);
+            }
+
+            const auto shift    = static_cast<uint32_t>(std::bit_width(value)) - 1 - SUB_BUCKET_BITS;
+            const auto mantissa = static_cast<uint32_t>(value >> shift) - SUB_BUCKET_COUNT;
+
+            return (shift + 1) * SUB_BUCKET_COUNT + mantissa;
+        }
+
+        [[nodiscard]] static constexpr uint64_t BucketLowerBound(uint32_t index) noexcept {
+            if (index < SUB_BUCKET_COUNT) {
+                return index;
+            }
+
+            const auto shift    = index / SUB_BUCKET_COUNT - 1;
+            const auto mantissa = uint64_t{ SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT };
+
+            return mantissa << shift;
+        }
+
+        [[nodiscard]] static constexpr uint64_t BucketUpperBound(uint32_t index) noexcept {
+            const auto shift = index < SUB_BUCKET_COUNT ? 0 : index / SUB_BUCKET_COUNT - 1;
+            return BucketLowerBound(index) + (uint64_t{ 1 } << shift) - 1;
+        }
+    private:
+        std::array<std::atomic_uint32_t, NUM_BUCKETS> m_buckets{};
+        std::atomic_uint64_t m_count{ 0 };
+        std::atomic_uint64_t m_sum{ 0 };
+        std::atomic_uint64_t m_max{ 0 };
+    };
+
+    struct FrameStageStatistics {
+        std::string_view Name;
+        uint64_t Count{};
+        double Mean{};
+        uint64_t P50{};
+        uint64_t P95{};
+        uint64_t P99{};
+        uint64_t Max{};
+    };
+
+    class FrameStatistics {
+    public:
+        static constexpr uint32_t MAX_STAGES        = 16;
+        static constexpr uint32_t MAX_RECENT_FRAMES = 256;
+        static constexpr uint32_t MAX_SPIKES        = 64;
+        static constexpr uint32_t MAX_NAME_LENGTH   = 32;
+
+        //Stage 0 always measures the whole frame, from one EndFrame() call to the next.
+        static constexpr uint32_t FRAME_STAGE = 0;
+
+        struct FrameRecord {
+            uint64_t FrameIndex{};
+            uint32_t Microseconds{};
+            std::array<uint32_t, MAX_STAGES> StageMicroseconds{};
+        };
+
+        class ScopedStage {
+        public:
+            explicit ScopedStage(std::string_view name) noexcept;
+            explicit ScopedStage(uint32_t stageId) noexcept;
+            ScopedStage(const ScopedStage&)            = delete;
+            ScopedStage& operator=(const ScopedStage&) = delete;
+            ~ScopedStage();
+        private:
+            std::optional<uint32_t> m_stageId;
+            std::chrono::steady_clock::time_point m_begin;
+        };
+
+        FrameStatistics(const FrameStatistics& rhs)            = delete;
+        FrameStatistics& operator=(const FrameStatistics& rhs) = delete;
+        FrameStatistics(FrameStatistics&& rhs)                 = delete;
+        FrameStatistics& operator=(FrameStatistics&& rhs)      = delete;
+
+        [[nodiscard]] static FrameStatistics& Get() noexcept {
+            static FrameStatistics frameStatistics;
+            return frameStatistics;
+        }
+
+        //Returns the id of the stage with the given name, registering it if it is not known yet.
+        //Returns an empty optional once MAX_STAGES stages exist. Names are truncated to MAX_NAME_LENGTH - 1 characters.
+        [[nodiscard]] std::optional<uint32_t> RegisterStage(std::string_view name) noexcept;
+        [[nodiscard]] std::optional<uint32_t> FindStage(std::string_view name) const noexcept;
+
+        void RecordStage(uint32_t stageId, std::chrono::microseconds duration) noexcept;
+
+        //EndFrame and Reset must be called from the thread that drives the frame loop.
+        void EndFrame() noexcept;
+        void Reset() noexcept;
+
+        //A frame is a spike when it takes longer than SpikeFactor times the current median frame time
+        //and longer than the absolute threshold. Spikes keep the per stage breakdown of the frame.
+        void SetSpikeThreshold(float spikeFactor, std::chrono::microseconds minimum) noexcept;
+
+        [[nodiscard]] uint64_t GetFrameCount() const noexcept { return m_frameCount.load(std::memory_order_acquire); }
+        [[nodiscard]] uint32_t GetStageCount() const noexcept { return m_stageCount.load(std::memory_order_acquire); }
+        [[nodiscard]] std::optional<FrameStageStatistics> GetStageStatistics(std::string_view name) const noexcept;
+        [[nodiscard]] std::optional<FrameStageStatistics> GetStageStatistics(uint32_t stageId) const noexcept;
+        [[nodiscard]] std::vector<FrameStageStatistics> GetAllStageStatistics() const;
+
+        //Copies up to maxFrames of the most recent frames, oldest first.
+        [[nodiscard]] std::vector<FrameRecord> GetRecentFrames(uint32_t maxFrames = MAX_RECENT_FRAMES) const;
+        [[nodiscard]] std::vector<FrameRecord> GetSpikes() const;
+    private:
+        FrameStatistics() noexcept;
+        ~FrameStatistics() = default;
+
+        struct Stage {
+            std::array<char, MAX_NAME_LENGTH> Name{};
+            std::atomic_uint64_t CurrentFrameMicroseconds{ 0 };
+            FrameTimeHistogram Histogram;
+
+            [[nodiscard]] std::string_view GetName() const noexcept { return Name.data(); }
+        };
+
+        //Slot of the single writer ring. The sequence is odd while the frame thread rewrites the record, readers
+        //copy the words and drop the copy when the sequence changed in between.
+        struct RecentFrameSlot {
+            static constexpr size_t NUM_WORDS = sizeof(FrameRecord) / sizeof(uint32_t);
+
+            std::atomic_uint64_t Sequence{ 0 };
+            std::array<std::atomic_uint32_t, NUM_WORDS> Words{};
+        };
+
+        void PublishRecentFrame(const FrameRecord& record) noexcept;
+        [[nodiscard]] std::optional<FrameRecord> ReadRecentFrame(uint64_t frameIndex) const noexcept;
+
+        std::array<RecentFrameSlot, MAX_RECENT_FRAMES> m_recentFrames{};
+        std::atomic_uint64_t m_frameCount{ 0 };
+
+        std::array<Stage, MAX_STAGES> m_stages;
+        std::atomic_uint32_t m_stageCount{ 0 };
+        std::mutex m_registrationMutex;
+
+        mutable std::mutex m_spikeMutex;
+        std::array<FrameRecord, MAX_SPIKES> m_spikes{};
+        uint64_t m_spikeCount{ 0 };
+
+        std::atomic<float> m_spikeFactor{ 2.0f };
+        std::atomic_uint64_t m_spikeMinimumMicroseconds{ 4000 };
+        uint64_t m_medianFrameMicroseconds{ 0 };
+
+        CrystalTimer<std::chrono::steady_clock> m_frameTimer;
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 #include <cstdlib>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 namespace Crystal{
 
@@ -31,14 +33,24 @@ namespace Crystal{
 
         std::string inline ToNarrow(std::wstring_view wide) noexcept {
             std::string narrow(wide.size() + 1, ' ');
+#ifdef _MSC_VER
             wcstombs_s(nullptr, narrow.data(), narrow.size(), wide.data(), static_cast<size_t>(-1));
+#else
+            const std::wstring terminated(wide);
+            std::wcstombs(narrow.data(), terminated.c_str(), narrow.size());
+#endif
 
             return narrow;
         }
 
         std::wstring inline ToWide(std::string_view narrow) noexcept {
             std::wstring wide(narrow.size() + 1, ' ');
+#ifdef _MSC_VER
             mbstowcs_s(nullptr, wide.data(), wide.size(), narrow.data(), static_cast<size_t>(-1));
+#else
+            const std::string terminated(narrow);
+            std::mbstowcs(wide.data(), terminated.c_str(), wide.size());
+#endif
 
             return wide;
         }
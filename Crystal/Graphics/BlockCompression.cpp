@@ -0,0 +1,1022 @@
+#include "BlockCompression.h"
+#include "Core/InstructionSet/Simd.h"
+#include "Core/Lib/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint32_t BLOCK_EXTENT     = 4;
+    constexpr uint32_t TEXELS_PER_BLOCK = 16;
+    constexpr uint32_t NUM_CHANNELS     = 4;
+
+    //Rows of blocks handed to one ParallelFor index
+    constexpr uint32_t BLOCK_ROWS_PER_TASK = 4;
+
+    constexpr uint32_t NUM_POWER_ITERATIONS = 8;
+    constexpr uint32_t NUM_REFINEMENTS      = 2;
+
+    //Interpolation weights of BC7's 4 bit indices, out of 64
+    constexpr std::array<uint32_t, 16> BC7_WEIGHTS{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    //Texels of one block split by channel. Values stay integers in floats, every error is exact and both code paths
+    //pick the same indices.
+    struct BlockTexels {
+        alignas(32) std::array<std::array<float, TEXELS_PER_BLOCK>, NUM_CHANNELS> Channels;
+    };
+
+    struct ChannelRange {
+        uint32_t First;
+        uint32_t Count;
+    };
+
+    constexpr ChannelRange RGB_CHANNELS { 0, 3 };
+    constexpr ChannelRange RGBA_CHANNELS{ 0, 4 };
+
+    using Endpoint = std::array<float, NUM_CHANNELS>;
+    using Indices  = std::array<uint8_t, TEXELS_PER_BLOCK>;
+
+    //Decoded colours a block can pick from, indexed by the code stored for a texel
+    struct Palette {
+        std::array<std::array<float, NUM_CHANNELS>, 16> Entries;
+        uint32_t Size;
+    };
+
+    //Nearest palette entry of every texel, ties go to the lower code. Returns the summed squared error.
+    float FindIndicesScalar(const BlockTexels& block, ChannelRange channels, const Palette& palette, Indices& indices) noexcept {
+        float totalError = 0.0f;
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            float bestError    = FLT_MAX;
+            uint32_t bestIndex = 0;
+
+            for (uint32_t entry = 0; entry < palette.Size; entry++) {
+                float error = 0.0f;
+
+                for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+                    const auto difference = block.Channels[channel][texel] - palette.Entries[entry][channel];
+                    error = error + difference * difference;
+                }
+
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = entry;
+                }
+            }
+
+            indices[texel] = static_cast<uint8_t>(bestIndex);
+            totalError += bestError;
+        }
+        return totalError;
+    }
+
+#if CRYSTAL_SIMD_X64
+    //Eight texels per register, every palette entry is compared against all of them at once
+    CRYSTAL_TARGET_AVX2 float FindIndicesAvx2(const BlockTexels& block, ChannelRange channels, const Palette& palette, Indices& indices) noexcept {
+        auto totalError = _mm256_setzero_ps();
+
+        for (uint32_t half = 0; half < 2; half++) {
+            __m256 texels[NUM_CHANNELS];
+
+            for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+                texels[channel] = _mm256_load_ps(&block.Channels[channel][half * 8]);
+            }
+
+            auto bestError = _mm256_set1_ps(FLT_MAX);
+            auto bestIndex = _mm256_setzero_si256();
+
+            for (uint32_t entry = 0; entry < palette.Size; entry++) {
+                auto error = _mm256_setzero_ps();
+
+                for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+                    const auto difference = _mm256_sub_ps(texels[channel], _mm256_set1_ps(palette.Entries[entry][channel]));
+                    error = _mm256_add_ps(error, _mm256_mul_ps(difference, difference));
+                }
+
+                const auto isBetter = _mm256_cmp_ps(error, bestError, _CMP_LT_OQ);
+                bestError = _mm256_blendv_ps(bestError, error, isBetter);
+                bestIndex = _mm256_blendv_epi8(bestIndex, _mm256_set1_epi32(static_cast<int32_t>(entry)), _mm256_castps_si256(isBetter));
+            }
+
+            totalError = _mm256_add_ps(totalError, bestError);
+
+            alignas(32) std::array<int32_t, 8> halfIndices;
+            _mm256_store_si256(reinterpret_cast<__m256i*>(halfIndices.data()), bestIndex);
+
+            for (uint32_t texel = 0; texel < 8; texel++) {
+                indices[half * 8 + texel] = static_cast<uint8_t>(halfIndices[texel]);
+            }
+        }
+
+        //Sums of integers below 2^24, the order of the additions does not matter
+        alignas(32) std::array<float, 8> errors;
+        _mm256_store_ps(errors.data(), totalError);
+
+        float sum = 0.0f;
+
+        for (const auto error : errors) {
+            sum += error;
+        }
+        return sum;
+    }
+#endif
+
+    struct EncodeContext {
+        BCQuality Quality;
+        bool UseAvx2;
+
+        float FindIndices(const BlockTexels& block, ChannelRange channels, const Palette& palette, Indices& indices) const noexcept {
+#if CRYSTAL_SIMD_X64
+            if (UseAvx2) {
+                return FindIndicesAvx2(block, channels, palette, indices);
+            }
+#endif
+            return FindIndicesScalar(block, channels, palette, indices);
+        }
+    };
+
+    //Texels past the edge of the image repeat the last row and column
+    void LoadBlock(std::span<const uint8_t> texels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, BlockTexels& block) noexcept {
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            const auto x = std::min(blockX * BLOCK_EXTENT + texel % BLOCK_EXTENT, width - 1);
+            const auto y = std::min(blockY * BLOCK_EXTENT + texel / BLOCK_EXTENT, height - 1);
+
+            const auto* source = &texels[(size_t{ y } * width + x) * NUM_CHANNELS];
+
+            for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+                block.Channels[channel][texel] = source[channel];
+            }
+        }
+    }
+
+    [[nodiscard]] float Clamp255(float value) noexcept {
+        return std::clamp(value, 0.0f, 255.0f);
+    }
+
+    //Round half up for values that cannot be negative, far cheaper than lround in the quantization loops
+    [[nodiscard]] uint32_t RoundToUnsigned(float value) noexcept {
+        return static_cast<uint32_t>(std::max(value, 0.0f) + 0.5f);
+    }
+
+    //Line through the block along its principal axis, clipped to the texels projected onto it
+    [[nodiscard]] std::pair<Endpoint, Endpoint> ComputePrincipalEndpoints(const BlockTexels& block, ChannelRange channels) noexcept {
+        Endpoint mean{};
+        Endpoint axis{};
+
+        for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+            const auto& values = block.Channels[channel];
+
+            for (const auto value : values) {
+                mean[channel] += value;
+            }
+            mean[channel] /= TEXELS_PER_BLOCK;
+
+            //The extent of the bounding box is a good first guess, the power iteration fixes the signs
+            const auto [min, max] = std::ranges::minmax(values);
+            axis[channel] = max - min;
+        }
+
+        std::array<Endpoint, NUM_CHANNELS> covariance{};
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            for (uint32_t i = channels.First; i < channels.First + channels.Count; i++) {
+                for (uint32_t j = channels.First; j < channels.First + channels.Count; j++) {
+                    covariance[i][j] += (block.Channels[i][texel] - mean[i]) * (block.Channels[j][texel] - mean[j]);
+                }
+            }
+        }
+
+        for (uint32_t iteration = 0; iteration < NUM_POWER_ITERATIONS; iteration++) {
+            Endpoint next{};
+            float largest = 0.0f;
+
+            for (uint32_t i = channels.First; i < channels.First + channels.Count; i++) {
+                for (uint32_t j = channels.First; j < channels.First + channels.Count; j++) {
+                    next[i] += covariance[i][j] * axis[j];
+                }
+                largest = std::max(largest, std::abs(next[i]));
+            }
+
+            if (largest == 0.0f) {
+                break;
+            }
+
+            for (auto& value : next) {
+                value /= largest;
+            }
+            axis = next;
+        }
+
+        float lengthSquared = 0.0f;
+
+        for (const auto value : axis) {
+            lengthSquared += value * value;
+        }
+
+        //A block of a single colour
+        if (lengthSquared == 0.0f) {
+            return { mean, mean };
+        }
+
+        for (auto& value : axis) {
+            value /= std::sqrt(lengthSquared);
+        }
+
+        float minProjection = FLT_MAX;
+        float maxProjection = -FLT_MAX;
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            float projection = 0.0f;
+
+            for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+                projection += (block.Channels[channel][texel] - mean[channel]) * axis[channel];
+            }
+            minProjection = std::min(minProjection, projection);
+            maxProjection = std::max(maxProjection, projection);
+        }
+
+        Endpoint start{};
+        Endpoint end{};
+
+        for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+            start[channel] = Clamp255(mean[channel] + axis[channel] * minProjection);
+            end[channel]   = Clamp255(mean[channel] + axis[channel] * maxProjection);
+        }
+        return { start, end };
+    }
+
+    //Least squares endpoints for fixed indices, weights[code] is how far the code lies from start towards end.
+    //Fails when every texel uses the same weight, the system has no unique solution then.
+    [[nodiscard]] bool FitEndpoints(
+        const BlockTexels& block,
+        ChannelRange channels,
+        const Indices& indices,
+        std::span<const float> weights,
+        Endpoint& start,
+        Endpoint& end) noexcept
+    {
+        float a = 0.0f;
+        float b = 0.0f;
+        float c = 0.0f;
+
+        Endpoint startSum{};
+        Endpoint endSum{};
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            const auto weight  = weights[indices[texel]];
+            const auto inverse = 1.0f - weight;
+
+            a += inverse * inverse;
+            b += inverse * weight;
+            c += weight * weight;
+
+            for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+                startSum[channel] += inverse * block.Channels[channel][texel];
+                endSum[channel]   += weight * block.Channels[channel][texel];
+            }
+        }
+
+        const auto determinant = a * c - b * b;
+
+        if (std::abs(determinant) < 1e-6f) {
+            return false;
+        }
+
+        for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+            start[channel] = Clamp255((c * startSum[channel] - b * endSum[channel]) / determinant);
+            end[channel]   = Clamp255((a * endSum[channel] - b * startSum[channel]) / determinant);
+        }
+        return true;
+    }
+
+    //BC1 colour: two RGB565 endpoints and 2 bit indices. Four colours when the first endpoint is larger, otherwise
+    //three and transparent black, which the encoder never picks since it stores opaque colour only.
+    struct ColorBlock {
+        uint16_t Color0{ 0 };
+        uint16_t Color1{ 0 };
+        Indices Codes{};
+        float Error{ FLT_MAX };
+    };
+
+    constexpr std::array<float, 4> FOUR_COLOR_WEIGHTS { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    constexpr std::array<float, 3> THREE_COLOR_WEIGHTS{ 0.0f, 1.0f, 0.5f };
+
+    [[nodiscard]] uint16_t QuantizeRGB565(const Endpoint& color) noexcept {
+        const auto r = RoundToUnsigned(Clamp255(color[0]) * 31.0f / 255.0f);
+        const auto g = RoundToUnsigned(Clamp255(color[1]) * 63.0f / 255.0f);
+        const auto b = RoundToUnsigned(Clamp255(color[2]) * 31.0f / 255.0f);
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    [[nodiscard]] std::array<int32_t, 3> ExpandRGB565(uint16_t color) noexcept {
+        const int32_t r = (color >> 11) & 31;
+        const int32_t g = (color >> 5) & 63;
+        const int32_t b = color & 31;
+        return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+    }
+
+    //Same integer interpolation as DecodeBlocks
+    [[nodiscard]] Palette MakeColorPalette(uint16_t color0, uint16_t color1, bool isFourColor) noexcept {
+        const auto start = ExpandRGB565(color0);
+        const auto end   = ExpandRGB565(color1);
+
+        Palette palette{};
+        palette.Size = isFourColor ? 4 : 3;
+
+        for (uint32_t channel = 0; channel < 3; channel++) {
+            const auto a = start[channel];
+            const auto b = end[channel];
+
+            palette.Entries[0][channel] = static_cast<float>(a);
+            palette.Entries[1][channel] = static_cast<float>(b);
+
+            if (isFourColor) {
+                palette.Entries[2][channel] = static_cast<float>((2 * a + b + 1) / 3);
+                palette.Entries[3][channel] = static_cast<float>((a + 2 * b + 1) / 3);
+            }
+            else {
+                palette.Entries[2][channel] = static_cast<float>((a + b + 1) / 2);
+            }
+        }
+        return palette;
+    }
+
+    //Orders the endpoints for the mode, equal endpoints decode as three colours and only ever use the first
+    [[nodiscard]] ColorBlock EvaluateColorBlock(const EncodeContext& context, const BlockTexels& block, uint16_t color0, uint16_t color1, bool isFourColor) noexcept {
+        if (isFourColor ? color0 < color1 : color0 > color1) {
+            std::swap(color0, color1);
+        }
+
+        ColorBlock colorBlock{ .Color0 = color0, .Color1 = color1 };
+        colorBlock.Error = context.FindIndices(block, RGB_CHANNELS, MakeColorPalette(color0, color1, isFourColor), colorBlock.Codes);
+
+        return colorBlock;
+    }
+
+    [[nodiscard]] bool IsFourColor(const ColorBlock& colorBlock) noexcept {
+        return colorBlock.Color0 > colorBlock.Color1;
+    }
+
+    [[nodiscard]] ColorBlock RefineColorBlock(const EncodeContext& context, const BlockTexels& block, ColorBlock best, bool isFourColor) noexcept {
+        for (uint32_t refinement = 0; refinement < NUM_REFINEMENTS; refinement++) {
+            Endpoint start{};
+            Endpoint end{};
+
+            const auto weights = isFourColor ? std::span<const float>(FOUR_COLOR_WEIGHTS) : std::span<const float>(THREE_COLOR_WEIGHTS);
+
+            if (!FitEndpoints(block, RGB_CHANNELS, best.Codes, weights, start, end)) {
+                break;
+            }
+
+            const auto candidate = EvaluateColorBlock(context, block, QuantizeRGB565(start), QuantizeRGB565(end), isFourColor);
+
+            if (candidate.Error >= best.Error) {
+                break;
+            }
+            best = candidate;
+        }
+        return best;
+    }
+
+    //Greedy search over the quantized endpoints, one step of one channel at a time
+    [[nodiscard]] ColorBlock SearchColorEndpoints(const EncodeContext& context, const BlockTexels& block, ColorBlock best) noexcept {
+        constexpr std::array<std::pair<uint32_t, uint32_t>, 3> FIELDS{ { { 11, 31 }, { 5, 63 }, { 0, 31 } } };
+
+        const bool isFourColor = IsFourColor(best) || best.Color0 == best.Color1;
+
+        for (bool isImproved = true; isImproved;) {
+            isImproved = false;
+
+            for (uint32_t endpoint = 0; endpoint < 2; endpoint++) {
+                for (const auto& [shift, mask] : FIELDS) {
+                    for (const int32_t step : { -1, 1 }) {
+                        std::array colors{ best.Color0, best.Color1 };
+
+                        const auto value = static_cast<int32_t>((colors[endpoint] >> shift) & mask) + step;
+
+                        if (value < 0 || value > static_cast<int32_t>(mask)) {
+                            continue;
+                        }
+
+                        colors[endpoint] = static_cast<uint16_t>((colors[endpoint] & ~(mask << shift)) | static_cast<uint32_t>(value) << shift);
+
+                        const auto candidate = EvaluateColorBlock(context, block, colors[0], colors[1], isFourColor);
+
+                        if (candidate.Error < best.Error) {
+                            best       = candidate;
+                            isImproved = true;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    [[nodiscard]] ColorBlock EncodeColorBlock(const EncodeContext& context, const BlockTexels& block, bool allowThreeColor) noexcept {
+        const auto [start, end] = ComputePrincipalEndpoints(block, RGB_CHANNELS);
+
+        auto best = EvaluateColorBlock(context, block, QuantizeRGB565(start), QuantizeRGB565(end), true);
+
+        if (context.Quality >= BCQuality::Normal) {
+            best = RefineColorBlock(context, block, best, true);
+        }
+
+        if (context.Quality >= BCQuality::High) {
+            best = SearchColorEndpoints(context, block, best);
+
+            //The midpoint of three colours fits some blocks better than the thirds of four
+            if (allowThreeColor) {
+                auto threeColor = EvaluateColorBlock(context, block, QuantizeRGB565(start), QuantizeRGB565(end), false);
+                threeColor      = RefineColorBlock(context, block, threeColor, false);
+
+                if (threeColor.Error < best.Error) {
+                    best = threeColor;
+                }
+            }
+        }
+        return best;
+    }
+
+    void WriteColorBlock(const ColorBlock& colorBlock, uint8_t* destination) noexcept {
+        uint32_t codes = 0;
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            codes |= uint32_t{ colorBlock.Codes[texel] } << (texel * 2);
+        }
+
+        std::memcpy(destination, &colorBlock.Color0, 2);
+        std::memcpy(destination + 2, &colorBlock.Color1, 2);
+        std::memcpy(destination + 4, &codes, 4);
+    }
+
+    //BC4 and the alpha of BC3: two 8 bit endpoints and 3 bit indices. Eight levels when the first endpoint is larger,
+    //otherwise six and exact 0 and 255.
+    struct ScalarBlock {
+        uint8_t Value0{ 0 };
+        uint8_t Value1{ 0 };
+        Indices Codes{};
+        float Error{ FLT_MAX };
+    };
+
+    constexpr std::array<float, 8> EIGHT_LEVEL_WEIGHTS{ 0.0f, 1.0f, 1.0f / 7, 2.0f / 7, 3.0f / 7, 4.0f / 7, 5.0f / 7, 6.0f / 7 };
+
+    [[nodiscard]] std::array<int32_t, 8> GetScalarLevels(int32_t value0, int32_t value1) noexcept {
+        std::array<int32_t, 8> levels{ value0, value1 };
+
+        if (value0 > value1) {
+            for (int32_t code = 2; code < 8; code++) {
+                levels[code] = ((8 - code) * value0 + (code - 1) * value1 + 3) / 7;
+            }
+        }
+        else {
+            for (int32_t code = 2; code < 6; code++) {
+                levels[code] = ((6 - code) * value0 + (code - 1) * value1 + 2) / 5;
+            }
+            levels[6] = 0;
+            levels[7] = 255;
+        }
+        return levels;
+    }
+
+    [[nodiscard]] ScalarBlock EvaluateScalarBlock(const EncodeContext& context, const BlockTexels& block, uint32_t channel, uint8_t value0, uint8_t value1) noexcept {
+        const auto levels = GetScalarLevels(value0, value1);
+
+        Palette palette{};
+        palette.Size = 8;
+
+        for (uint32_t code = 0; code < 8; code++) {
+            palette.Entries[code][channel] = static_cast<float>(levels[code]);
+        }
+
+        ScalarBlock scalarBlock{ .Value0 = value0, .Value1 = value1 };
+        scalarBlock.Error = context.FindIndices(block, { channel, 1 }, palette, scalarBlock.Codes);
+
+        return scalarBlock;
+    }
+
+    [[nodiscard]] uint8_t QuantizeScalar(float value) noexcept {
+        return static_cast<uint8_t>(RoundToUnsigned(Clamp255(value)));
+    }
+
+    [[nodiscard]] ScalarBlock EncodeScalarBlock(const EncodeContext& context, const BlockTexels& block, uint32_t channel) noexcept {
+        const auto& values = block.Channels[channel];
+        const auto [min, max] = std::ranges::minmax(values);
+
+        auto best = EvaluateScalarBlock(context, block, channel, QuantizeScalar(max), QuantizeScalar(min));
+
+        if (context.Quality >= BCQuality::Normal && best.Value0 > best.Value1) {
+            for (uint32_t refinement = 0; refinement < NUM_REFINEMENTS; refinement++) {
+                Endpoint start{};
+                Endpoint end{};
+
+                if (!FitEndpoints(block, { channel, 1 }, best.Codes, EIGHT_LEVEL_WEIGHTS, start, end)) {
+                    break;
+                }
+
+                auto value0 = QuantizeScalar(start[channel]);
+                auto value1 = QuantizeScalar(end[channel]);
+
+                if (value0 == value1) {
+                    break;
+                }
+
+                if (value0 < value1) {
+                    std::swap(value0, value1);
+                }
+
+                const auto candidate = EvaluateScalarBlock(context, block, channel, value0, value1);
+
+                if (candidate.Error >= best.Error) {
+                    break;
+                }
+                best = candidate;
+            }
+        }
+
+        if (context.Quality >= BCQuality::High) {
+            //Six levels spread over the values in between, 0 and 255 are matched exactly
+            float innerMin = 255.0f;
+            float innerMax = 0.0f;
+
+            for (const auto value : values) {
+                if (value > 0.0f && value < 255.0f) {
+                    innerMin = std::min(innerMin, value);
+                    innerMax = std::max(innerMax, value);
+                }
+            }
+
+            if (innerMin <= innerMax) {
+                const auto sixLevel = EvaluateScalarBlock(context, block, channel, QuantizeScalar(innerMin), QuantizeScalar(innerMax));
+
+                if (sixLevel.Error < best.Error) {
+                    best = sixLevel;
+                }
+            }
+
+            //One step of either endpoint at a time, the mode must not flip
+            for (bool isImproved = true; isImproved;) {
+                isImproved = false;
+
+                for (uint32_t endpoint = 0; endpoint < 2; endpoint++) {
+                    for (const int32_t step : { -1, 1 }) {
+                        std::array<int32_t, 2> endpoints{ best.Value0, best.Value1 };
+                        endpoints[endpoint] += step;
+
+                        if (endpoints[endpoint] < 0 || endpoints[endpoint] > 255 || (endpoints[0] > endpoints[1]) != (best.Value0 > best.Value1)) {
+                            continue;
+                        }
+
+                        const auto candidate = EvaluateScalarBlock(context, block, channel, static_cast<uint8_t>(endpoints[0]), static_cast<uint8_t>(endpoints[1]));
+
+                        if (candidate.Error < best.Error) {
+                            best       = candidate;
+                            isImproved = true;
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    void WriteScalarBlock(const ScalarBlock& scalarBlock, uint8_t* destination) noexcept {
+        uint64_t codes = 0;
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            codes |= uint64_t{ scalarBlock.Codes[texel] } << (texel * 3);
+        }
+
+        destination[0] = scalarBlock.Value0;
+        destination[1] = scalarBlock.Value1;
+
+        for (uint32_t byte = 0; byte < 6; byte++) {
+            destination[2 + byte] = static_cast<uint8_t>(codes >> (byte * 8));
+        }
+    }
+
+    //BC7 mode 6: RGBA endpoints of 7 bits each plus one shared lowest bit per endpoint, the p-bit
+    struct BC7Block {
+        std::array<std::array<uint8_t, NUM_CHANNELS>, 2> Values{};
+        std::array<uint8_t, 2> PBits{};
+        Indices Codes{};
+        float Error{ FLT_MAX };
+    };
+
+    constexpr std::array<float, 16> BC7_FIT_WEIGHTS = [] {
+        std::array<float, 16> weights{};
+
+        for (uint32_t code = 0; code < 16; code++) {
+            weights[code] = BC7_WEIGHTS[code] / 64.0f;
+        }
+        return weights;
+    }();
+
+    [[nodiscard]] std::array<uint8_t, NUM_CHANNELS> QuantizeBC7Endpoint(const Endpoint& endpoint, uint32_t pBit) noexcept {
+        std::array<uint8_t, NUM_CHANNELS> values{};
+
+        for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+            values[channel] = static_cast<uint8_t>(std::min(RoundToUnsigned((endpoint[channel] - pBit) / 2.0f), 127u));
+        }
+        return values;
+    }
+
+    //The p-bit that loses the least to rounding
+    [[nodiscard]] uint8_t ChooseBC7PBit(const Endpoint& endpoint) noexcept {
+        std::array<float, 2> errors{};
+
+        for (uint32_t pBit = 0; pBit < 2; pBit++) {
+            const auto values = QuantizeBC7Endpoint(endpoint, pBit);
+
+            for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+                const auto difference = static_cast<float>(values[channel] << 1 | pBit) - endpoint[channel];
+                errors[pBit] += difference * difference;
+            }
+        }
+        return errors[1] < errors[0] ? 1 : 0;
+    }
+
+    [[nodiscard]] BC7Block EvaluateBC7Block(const EncodeContext& context, const BlockTexels& block, BC7Block bc7Block) noexcept {
+        Palette palette{};
+        palette.Size = 16;
+
+        for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+            const auto a = uint32_t{ bc7Block.Values[0][channel] } << 1 | bc7Block.PBits[0];
+            const auto b = uint32_t{ bc7Block.Values[1][channel] } << 1 | bc7Block.PBits[1];
+
+            for (uint32_t code = 0; code < 16; code++) {
+                palette.Entries[code][channel] = static_cast<float>(((64 - BC7_WEIGHTS[code]) * a + BC7_WEIGHTS[code] * b + 32) >> 6);
+            }
+        }
+
+        bc7Block.Error = context.FindIndices(block, RGBA_CHANNELS, palette, bc7Block.Codes);
+        return bc7Block;
+    }
+
+    //Quantizes both endpoints, High tries every p-bit combination instead of rounding each endpoint on its own
+    [[nodiscard]] BC7Block QuantizeBC7Block(const EncodeContext& context, const BlockTexels& block, const Endpoint& start, const Endpoint& end) noexcept {
+        if (context.Quality < BCQuality::High) {
+            BC7Block bc7Block;
+            bc7Block.PBits  = { ChooseBC7PBit(start), ChooseBC7PBit(end) };
+            bc7Block.Values = { QuantizeBC7Endpoint(start, bc7Block.PBits[0]), QuantizeBC7Endpoint(end, bc7Block.PBits[1]) };
+
+            return EvaluateBC7Block(context, block, bc7Block);
+        }
+
+        BC7Block best;
+
+        for (uint8_t pBits = 0; pBits < 4; pBits++) {
+            BC7Block bc7Block;
+            bc7Block.PBits  = { static_cast<uint8_t>(pBits & 1), static_cast<uint8_t>(pBits >> 1) };
+            bc7Block.Values = { QuantizeBC7Endpoint(start, bc7Block.PBits[0]), QuantizeBC7Endpoint(end, bc7Block.PBits[1]) };
+
+            const auto candidate = EvaluateBC7Block(context, block, bc7Block);
+
+            if (candidate.Error < best.Error) {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    [[nodiscard]] BC7Block EncodeBC7Block(const EncodeContext& context, const BlockTexels& block) noexcept {
+        const auto [start, end] = ComputePrincipalEndpoints(block, RGBA_CHANNELS);
+
+        auto best = QuantizeBC7Block(context, block, start, end);
+
+        if (context.Quality >= BCQuality::Normal) {
+            for (uint32_t refinement = 0; refinement < NUM_REFINEMENTS; refinement++) {
+                Endpoint fittedStart{};
+                Endpoint fittedEnd{};
+
+                if (!FitEndpoints(block, RGBA_CHANNELS, best.Codes, BC7_FIT_WEIGHTS, fittedStart, fittedEnd)) {
+                    break;
+                }
+
+                const auto candidate = QuantizeBC7Block(context, block, fittedStart, fittedEnd);
+
+                if (candidate.Error >= best.Error) {
+                    break;
+                }
+                best = candidate;
+            }
+        }
+
+        if (context.Quality >= BCQuality::High) {
+            for (bool isImproved = true; isImproved;) {
+                isImproved = false;
+
+                for (uint32_t endpoint = 0; endpoint < 2; endpoint++) {
+                    for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+                        for (const int32_t step : { -1, 1 }) {
+                            const auto value = best.Values[endpoint][channel] + step;
+
+                            if (value < 0 || value > 127) {
+                                continue;
+                            }
+
+                            auto candidate = best;
+                            candidate.Values[endpoint][channel] = static_cast<uint8_t>(value);
+                            candidate = EvaluateBC7Block(context, block, candidate);
+
+                            if (candidate.Error < best.Error) {
+                                best       = candidate;
+                                isImproved = true;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return best;
+    }
+
+    //Fields are packed from the lowest bit of the first byte on
+    class BlockBitWriter {
+    public:
+        void Write(uint32_t value, uint32_t numBits) noexcept {
+            for (uint32_t bit = 0; bit < numBits; bit++, m_position++) {
+                m_bytes[m_position / 8] |= static_cast<uint8_t>(((value >> bit) & 1) << (m_position % 8));
+            }
+        }
+
+        [[nodiscard]] const std::array<uint8_t, 16>& GetBytes() const noexcept { return m_bytes; }
+    private:
+        std::array<uint8_t, 16> m_bytes{};
+        uint32_t m_position{ 0 };
+    };
+
+    class BlockBitReader {
+    public:
+        explicit BlockBitReader(const uint8_t* bytes) noexcept : m_bytes(bytes) {}
+
+        [[nodiscard]] uint32_t Read(uint32_t numBits) noexcept {
+            uint32_t value = 0;
+
+            for (uint32_t bit = 0; bit < numBits; bit++, m_position++) {
+                value |= uint32_t{ (m_bytes[m_position / 8] >> (m_position % 8)) & 1u } << bit;
+            }
+            return value;
+        }
+    private:
+        const uint8_t* m_bytes;
+        uint32_t m_position{ 0 };
+    };
+
+    void WriteBC7Block(BC7Block bc7Block, uint8_t* destination) noexcept {
+        //The highest bit of the first index is implied to be zero, the endpoints are swapped to make it so
+        if (bc7Block.Codes[0] >= 8) {
+            std::swap(bc7Block.Values[0], bc7Block.Values[1]);
+            std::swap(bc7Block.PBits[0], bc7Block.PBits[1]);
+
+            for (auto& code : bc7Block.Codes) {
+                code = static_cast<uint8_t>(15 - code);
+            }
+        }
+
+        BlockBitWriter writer;
+        writer.Write(1 << 6, 7);
+
+        for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+            writer.Write(bc7Block.Values[0][channel], 7);
+            writer.Write(bc7Block.Values[1][channel], 7);
+        }
+
+        writer.Write(bc7Block.PBits[0], 1);
+        writer.Write(bc7Block.PBits[1], 1);
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            writer.Write(bc7Block.Codes[texel], texel == 0 ? 3 : 4);
+        }
+
+        std::memcpy(destination, writer.GetBytes().data(), 16);
+    }
+
+    void EncodeBlock(const EncodeContext& context, BCFormat format, const BlockTexels& block, uint8_t* destination) noexcept {
+        switch (format) {
+        case BCFormat::BC1:
+            WriteColorBlock(EncodeColorBlock(context, block, true), destination);
+            break;
+        case BCFormat::BC3:
+            WriteScalarBlock(EncodeScalarBlock(context, block, 3), destination);
+            WriteColorBlock(EncodeColorBlock(context, block, false), destination + 8);
+            break;
+        case BCFormat::BC4:
+            WriteScalarBlock(EncodeScalarBlock(context, block, 0), destination);
+            break;
+        case BCFormat::BC5:
+            WriteScalarBlock(EncodeScalarBlock(context, block, 0), destination);
+            WriteScalarBlock(EncodeScalarBlock(context, block, 1), destination + 8);
+            break;
+        case BCFormat::BC7:
+            WriteBC7Block(EncodeBC7Block(context, block), destination);
+            break;
+        }
+    }
+
+    //Decoded texels of one block in RGBA order
+    using DecodedBlock = std::array<std::array<uint8_t, NUM_CHANNELS>, TEXELS_PER_BLOCK>;
+
+    void DecodeColorBlock(const uint8_t* source, bool isAlwaysFourColor, DecodedBlock& decoded) noexcept {
+        uint16_t color0;
+        uint16_t color1;
+        uint32_t codes;
+
+        std::memcpy(&color0, source, 2);
+        std::memcpy(&color1, source + 2, 2);
+        std::memcpy(&codes, source + 4, 4);
+
+        const bool isFourColor = isAlwaysFourColor || color0 > color1;
+        const auto palette     = MakeColorPalette(color0, color1, isFourColor);
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            const auto code = (codes >> (texel * 2)) & 3;
+
+            //Transparent black of the three colour mode
+            if (code == 3 && !isFourColor) {
+                decoded[texel] = { 0, 0, 0, 0 };
+                continue;
+            }
+
+            for (uint32_t channel = 0; channel < 3; channel++) {
+                decoded[texel][channel] = static_cast<uint8_t>(palette.Entries[code][channel]);
+            }
+            decoded[texel][3] = 255;
+        }
+    }
+
+    void DecodeScalarBlock(const uint8_t* source, uint32_t channel, DecodedBlock& decoded) noexcept {
+        const auto levels = GetScalarLevels(source[0], source[1]);
+
+        uint64_t codes = 0;
+
+        for (uint32_t byte = 0; byte < 6; byte++) {
+            codes |= uint64_t{ source[2 + byte] } << (byte * 8);
+        }
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            decoded[texel][channel] = static_cast<uint8_t>(levels[(codes >> (texel * 3)) & 7]);
+        }
+    }
+
+    void DecodeBC7Block(const uint8_t* source, DecodedBlock& decoded) noexcept {
+        if ((source[0] & 0x7F) != 1 << 6) {
+            decoded = {};
+            return;
+        }
+
+        BlockBitReader reader(source);
+        (void)reader.Read(7);
+
+        std::array<std::array<uint32_t, NUM_CHANNELS>, 2> endpoints{};
+
+        for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+            endpoints[0][channel] = reader.Read(7) << 1;
+            endpoints[1][channel] = reader.Read(7) << 1;
+        }
+
+        const auto pBit0 = reader.Read(1);
+        const auto pBit1 = reader.Read(1);
+
+        for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+            endpoints[0][channel] |= pBit0;
+            endpoints[1][channel] |= pBit1;
+        }
+
+        for (uint32_t texel = 0; texel < TEXELS_PER_BLOCK; texel++) {
+            const auto weight = BC7_WEIGHTS[reader.Read(texel == 0 ? 3 : 4)];
+
+            for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+                decoded[texel][channel] = static_cast<uint8_t>(((64 - weight) * endpoints[0][channel] + weight * endpoints[1][channel] + 32) >> 6);
+            }
+        }
+    }
+
+    [[nodiscard]] ChannelRange GetStoredChannels(BCFormat format) noexcept {
+        switch (format) {
+        case BCFormat::BC1: return RGB_CHANNELS;
+        case BCFormat::BC4: return { 0, 1 };
+        case BCFormat::BC5: return { 0, 2 };
+        default:            return RGBA_CHANNELS;
+        }
+    }
+}
+
+std::vector<uint8_t> Crystal::EncodeBlocks(
+    std::span<const uint8_t> texels,
+    uint32_t width,
+    uint32_t height,
+    const BCEncoderSettings& settings,
+    ThreadPool* threadPool)
+{
+    assert(texels.size() >= size_t{ width } * height * impl::NUM_CHANNELS && "Source image is smaller than its size");
+
+    const auto numBlocksX    = (width + impl::BLOCK_EXTENT - 1) / impl::BLOCK_EXTENT;
+    const auto numBlocksY    = (height + impl::BLOCK_EXTENT - 1) / impl::BLOCK_EXTENT;
+    const auto bytesPerBlock = GetBytesPerBlock(settings.Format);
+
+    std::vector<uint8_t> blocks(size_t{ numBlocksX } * numBlocksY * bytesPerBlock);
+
+    const impl::EncodeContext context{ settings.Quality, settings.AllowSimd && HasAvx2() };
+
+    const auto encodeRows = [&](uint32_t firstRow, uint32_t lastRow) {
+        impl::BlockTexels block;
+
+        for (uint32_t blockY = firstRow; blockY < lastRow; blockY++) {
+            for (uint32_t blockX = 0; blockX < numBlocksX; blockX++) {
+                impl::LoadBlock(texels, width, height, blockX, blockY, block);
+                impl::EncodeBlock(context, settings.Format, block, &blocks[(size_t{ blockY } * numBlocksX + blockX) * bytesPerBlock]);
+            }
+        }
+    };
+
+    const auto numTasks = (numBlocksY + impl::BLOCK_ROWS_PER_TASK - 1) / impl::BLOCK_ROWS_PER_TASK;
+
+    if (threadPool && numTasks > 1) {
+        threadPool->ParallelFor(numTasks, [&](size_t task) {
+            const auto firstRow = static_cast<uint32_t>(task) * impl::BLOCK_ROWS_PER_TASK;
+            encodeRows(firstRow, std::min(firstRow + impl::BLOCK_ROWS_PER_TASK, numBlocksY));
+        });
+    }
+    else {
+        encodeRows(0, numBlocksY);
+    }
+    return blocks;
+}
+
+std::vector<uint8_t> Crystal::DecodeBlocks(std::span<const uint8_t> blocks, uint32_t width, uint32_t height, BCFormat format) {
+    const auto numBlocksX    = (width + impl::BLOCK_EXTENT - 1) / impl::BLOCK_EXTENT;
+    const auto numBlocksY    = (height + impl::BLOCK_EXTENT - 1) / impl::BLOCK_EXTENT;
+    const auto bytesPerBlock = GetBytesPerBlock(format);
+
+    assert(blocks.size() >= size_t{ numBlocksX } * numBlocksY * bytesPerBlock && "Fewer blocks than the size needs");
+
+    std::vector<uint8_t> texels(size_t{ width } * height * impl::NUM_CHANNELS);
+
+    for (uint32_t blockY = 0; blockY < numBlocksY; blockY++) {
+        for (uint32_t blockX = 0; blockX < numBlocksX; blockX++) {
+            const auto* source = &blocks[(size_t{ blockY } * numBlocksX + blockX) * bytesPerBlock];
+
+            impl::DecodedBlock decoded;
+            decoded.fill({ 0, 0, 0, 255 });
+
+            switch (format) {
+            case BCFormat::BC1:
+                impl::DecodeColorBlock(source, false, decoded);
+                break;
+            case BCFormat::BC3:
+                impl::DecodeColorBlock(source + 8, true, decoded);
+                impl::DecodeScalarBlock(source, 3, decoded);
+                break;
+            case BCFormat::BC4:
+                impl::DecodeScalarBlock(source, 0, decoded);
+                break;
+            case BCFormat::BC5:
+                impl::DecodeScalarBlock(source, 0, decoded);
+                impl::DecodeScalarBlock(source + 8, 1, decoded);
+                break;
+            case BCFormat::BC7:
+                impl::DecodeBC7Block(source, decoded);
+                break;
+            }
+
+            for (uint32_t texel = 0; texel < impl::TEXELS_PER_BLOCK; texel++) {
+                const auto x = blockX * impl::BLOCK_EXTENT + texel % impl::BLOCK_EXTENT;
+                const auto y = blockY * impl::BLOCK_EXTENT + texel / impl::BLOCK_EXTENT;
+
+                if (x < width && y < height) {
+                    std::memcpy(&texels[(size_t{ y } * width + x) * impl::NUM_CHANNELS], decoded[texel].data(), impl::NUM_CHANNELS);
+                }
+            }
+        }
+    }
+    return texels;
+}
+
+double Crystal::ComputePSNR(std::span<const uint8_t> reference, std::span<const uint8_t> decoded, BCFormat format) noexcept {
+    const auto channels  = impl::GetStoredChannels(format);
+    const auto numTexels = std::min(reference.size(), decoded.size()) / impl::NUM_CHANNELS;
+
+    uint64_t squaredError = 0;
+
+    for (size_t texel = 0; texel < numTexels; texel++) {
+        for (uint32_t channel = channels.First; channel < channels.First + channels.Count; channel++) {
+            const auto difference = static_cast<int32_t>(reference[texel * impl::NUM_CHANNELS + channel]) - decoded[texel * impl::NUM_CHANNELS + channel];
+            squaredError += static_cast<uint64_t>(difference * difference);
+        }
+    }
+
+    if (squaredError == 0 || numTexels == 0) {
+        return INFINITY;
+    }
+
+    const auto meanSquaredError = static_cast<double>(squaredError) / (static_cast<double>(numTexels) * channels.Count);
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
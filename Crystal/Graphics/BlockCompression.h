@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    class ThreadPool;
+
+    enum class BCFormat : uint8_t {
+        //RGB at 4 bits per texel, alpha is dropped
+        BC1,
+        //BC1 colour with alpha stored like BC4 next to it
+        BC3,
+        //Red only, for single channel data such as roughness or height
+        BC4,
+        //Red and green stored like two BC4 blocks, for tangent space normals whose z is rebuilt in the shader
+        BC5,
+        //RGBA at 8 bits per texel, the encoder writes mode 6 blocks: 7 bit endpoints with a p-bit and 16 levels
+        BC7
+    };
+
+    //Higher presets start from the result of the lower ones, so they are never worse
+    enum class BCQuality : uint8_t {
+        //Endpoints along the principal axis of the block
+        Fast,
+        //Refines the endpoints by least squares for the chosen indices
+        Normal,
+        //Also searches the neighbouring quantized endpoints, every p-bit combination and BC1's three colour mode
+        High
+    };
+
+    struct BCEncoderSettings {
+        BCFormat Format{ BCFormat::BC7 };
+        BCQuality Quality{ BCQuality::Normal };
+
+        //Off runs the scalar path, which the vectorized one has to match bit for bit
+        bool AllowSimd{ true };
+    };
+
+    [[nodiscard]] constexpr uint32_t GetBytesPerBlock(BCFormat format) noexcept {
+        return format == BCFormat::BC1 || format == BCFormat::BC4 ? 8 : 16;
+    }
+
+    //DXGI_FORMAT of the UNORM variant, BC1, BC3 and BC7 have an sRGB one as well
+    [[nodiscard]] constexpr uint32_t GetDxgiFormat(BCFormat format) noexcept {
+        switch (format) {
+        case BCFormat::BC1: return 71;
+        case BCFormat::BC3: return 77;
+        case BCFormat::BC4: return 80;
+        case BCFormat::BC5: return 83;
+        case BCFormat::BC7: return 98;
+        }
+        return 0;
+    }
+
+    //Compresses RGBA8 texels into rows of 4x4 blocks. Blocks past the edge of the image repeat its last row and column.
+    //Rows of blocks are split across the thread pool when one is given. Uses AVX2 when the processor supports it.
+    [[nodiscard]] std::vector<uint8_t> EncodeBlocks(
+        std::span<const uint8_t> texels,
+        uint32_t width,
+        uint32_t height,
+        const BCEncoderSettings& settings = {},
+        ThreadPool* threadPool = nullptr);
+
+    //Back to RGBA8, channels the format does not store are 0 and alpha 255. BC7 blocks are only decoded in mode 6,
+    //the one the encoder writes, blocks of other modes come out as zero.
+    [[nodiscard]] std::vector<uint8_t> DecodeBlocks(std::span<const uint8_t> blocks, uint32_t width, uint32_t height, BCFormat format);
+
+    //Peak signal to noise ratio in dB over the channels the format stores, infinite for identical images
+    [[nodiscard]] double ComputePSNR(std::span<const uint8_t> reference, std::span<const uint8_t> decoded, BCFormat format) noexcept;
+}
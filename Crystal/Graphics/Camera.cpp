@@ -1,4 +1,5 @@
 #include "Camera.h"
+#include "MeshSimplifier.h"
 #include "../Core/Math/Vector3.cpp"
 
 using namespace Crystal;
@@ -41,6 +42,10 @@ float Camera::GetFov() const noexcept {
 	return m_fov;
 }
 
+float Camera::GetLodErrorScale(float viewportHeight) const noexcept {
+	return Crystal::GetLodErrorScale(m_fov, viewportHeight);
+}
+
 void Camera::UpdateViewMatrix() const noexcept {
 	const auto& translation = Matrix::CreateTranslation(Vector4::Negate(m_transform.GetPosition()));
 	const auto& rotation    = Matrix::Transpose(Matrix::CreateRotation(m_transform.GetRotation()));
@@ -22,6 +22,9 @@ namespace Crystal {
 
 		void SetFov(float vFov) noexcept;
 		[[nodiscard]] float GetFov() const noexcept;
+
+		//Pixels an object space error of 1 covers at a distance of 1, scales the errors of mesh levels of detail for SelectLod
+		[[nodiscard]] float GetLodErrorScale(float viewportHeight) const noexcept;
 	private:
 		void UpdateViewMatrix() const noexcept;
 
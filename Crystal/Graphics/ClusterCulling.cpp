@@ -0,0 +1,75 @@
+#include "ClusterCulling.h"
+
+#include <cmath>
+
+using namespace Crystal;
+
+namespace impl {
+    [[nodiscard]] std::array<float, 4> NormalizePlane(float a, float b, float c, float d) noexcept {
+        const auto length = std::sqrt(a * a + b * b + c * c);
+        return length > 0.0f ? std::array{ a / length, b / length, c / length, d / length } : std::array{ 0.0f, 0.0f, 0.0f, 0.0f };
+    }
+}
+
+//Clip space x, y and z are the dot products of a row vector with the matrix columns, each plane bounds one of them by w
+CullingFrustum Crystal::CreateCullingFrustum(const Math::Matrix& m, const Math::Vector3& cameraPosition) noexcept {
+    CullingFrustum frustum;
+
+    frustum.Planes = {
+        impl::NormalizePlane(m.m03 + m.m00, m.m13 + m.m10, m.m23 + m.m20, m.m33 + m.m30),
+        impl::NormalizePlane(m.m03 - m.m00, m.m13 - m.m10, m.m23 - m.m20, m.m33 - m.m30),
+        impl::NormalizePlane(m.m03 + m.m01, m.m13 + m.m11, m.m23 + m.m21, m.m33 + m.m31),
+        impl::NormalizePlane(m.m03 - m.m01, m.m13 - m.m11, m.m23 - m.m21, m.m33 - m.m31),
+        impl::NormalizePlane(m.m02, m.m12, m.m22, m.m32),
+        impl::NormalizePlane(m.m03 - m.m02, m.m13 - m.m12, m.m23 - m.m22, m.m33 - m.m32)
+    };
+
+    frustum.CameraPosition = { cameraPosition.x, cameraPosition.y, cameraPosition.z };
+    return frustum;
+}
+
+bool Crystal::IsOutsideFrustum(const MeshletBounds& bounds, const CullingFrustum& frustum) noexcept {
+    const auto& [x, y, z] = bounds.Center;
+
+    //All planes are evaluated, a branch per plane costs more than the arithmetic it would skip
+    bool isOutside = false;
+
+    for (const auto& [a, b, c, d] : frustum.Planes) {
+        isOutside |= a * x + b * y + c * z + d < -bounds.Radius;
+    }
+    return isOutside;
+}
+
+//The normals are within asin(ConeCutoff) of the axis, they face away from every point seen within acos(ConeCutoff)
+//of it. That holds for the whole sphere when dot(c - e, axis) - r >= ConeCutoff * (|c - e| + r).
+bool Crystal::IsBackFacing(const MeshletBounds& bounds, const std::array<float, 3>& cameraPosition) noexcept {
+    const auto dx = bounds.Center[0] - cameraPosition[0];
+    const auto dy = bounds.Center[1] - cameraPosition[1];
+    const auto dz = bounds.Center[2] - cameraPosition[2];
+
+    const auto distance  = std::sqrt(dx * dx + dy * dy + dz * dz);
+    const auto alongAxis = dx * bounds.ConeAxis[0] + dy * bounds.ConeAxis[1] + dz * bounds.ConeAxis[2];
+
+    return alongAxis - bounds.Radius >= bounds.ConeCutoff * (distance + bounds.Radius);
+}
+
+ClusterCullingStatistics Crystal::CullMeshlets(std::span<const MeshletBounds> bounds, const CullingFrustum& frustum, std::vector<uint32_t>& visible) {
+    ClusterCullingStatistics statistics;
+
+    visible.resize(bounds.size());
+
+    for (uint32_t meshlet = 0; meshlet < bounds.size(); meshlet++) {
+        const bool isOutside    = IsOutsideFrustum(bounds[meshlet], frustum);
+        const bool isBackFacing = !isOutside && IsBackFacing(bounds[meshlet], frustum.CameraPosition);
+
+        //Written unconditionally and kept by advancing the count, there is no branch on the result to mispredict
+        visible[statistics.NumVisible] = meshlet;
+
+        statistics.NumVisible        += !isOutside && !isBackFacing;
+        statistics.NumOutsideFrustum += isOutside;
+        statistics.NumBackFacing     += isBackFacing;
+    }
+
+    visible.resize(statistics.NumVisible);
+    return statistics;
+}
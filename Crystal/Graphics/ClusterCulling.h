@@ -0,0 +1,36 @@
+#pragma once
+#include "Meshlets.h"
+#include "Core/Math/Matrix.h"
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    //Frustum and camera in the space of the meshlet bounds, usually object space of the mesh
+    struct CullingFrustum {
+        //Left, right, bottom, top, near and far. Normals are unit length and face inwards, a point is inside a plane
+        //when dot(normal, point) + distance >= 0.
+        std::array<std::array<float, 4>, 6> Planes;
+        std::array<float, 3> CameraPosition;
+    };
+
+    struct ClusterCullingStatistics {
+        uint32_t NumVisible{ 0 };
+        uint32_t NumOutsideFrustum{ 0 };
+        uint32_t NumBackFacing{ 0 };
+    };
+
+    //Planes of a row vector world view projection matrix with a [0, 1] depth range, cameraPosition in the same space
+    [[nodiscard]] CullingFrustum CreateCullingFrustum(const Math::Matrix& worldViewProjection, const Math::Vector3& cameraPosition) noexcept;
+
+    //Bounding sphere entirely behind one of the planes
+    [[nodiscard]] bool IsOutsideFrustum(const MeshletBounds& bounds, const CullingFrustum& frustum) noexcept;
+
+    //Every point of the bounding sphere sees every normal of the cone from behind. Conservative, the sphere is
+    //used in place of the triangles so meshlets seen almost edge on are kept.
+    [[nodiscard]] bool IsBackFacing(const MeshletBounds& bounds, const std::array<float, 3>& cameraPosition) noexcept;
+
+    //Replaces the contents of visible with the indices of the meshlets that pass both tests, the frustum is tested first
+    ClusterCullingStatistics CullMeshlets(std::span<const MeshletBounds> bounds, const CullingFrustum& frustum, std::vector<uint32_t>& visible);
+}
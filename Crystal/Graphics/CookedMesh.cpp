@@ -0,0 +1,361 @@
+#include "CookedMesh.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+
+using namespace Crystal;
+
+static_assert(std::is_trivially_copyable_v<CookedMeshHeader> && sizeof(CookedMeshHeader) % CookedMeshFormat::BLOB_ALIGNMENT == 0);
+static_assert(std::is_trivially_copyable_v<CookedSubmesh> && std::is_trivially_copyable_v<CookedMaterial>);
+static_assert(std::is_trivially_copyable_v<Meshlet> && std::is_trivially_copyable_v<MeshletBounds> && std::is_trivially_copyable_v<MeshLod>);
+
+namespace impl {
+    [[nodiscard]] constexpr uint64_t AlignBlob(uint64_t offset) noexcept {
+        return (offset + CookedMeshFormat::BLOB_ALIGNMENT - 1) & ~uint64_t{ CookedMeshFormat::BLOB_ALIGNMENT - 1 };
+    }
+
+    [[nodiscard]] constexpr bool IsBlobInFile(uint64_t offset, uint64_t sizeInBytes, uint64_t fileSize) noexcept {
+        return offset % CookedMeshFormat::BLOB_ALIGNMENT == 0 && offset <= fileSize && sizeInBytes <= fileSize - offset;
+    }
+
+    [[nodiscard]] CookedBounds ComputeBounds(std::span<const std::byte> vertices, uint32_t vertexStride) noexcept {
+        constexpr auto MAX = std::numeric_limits<float>::max();
+
+        CookedBounds bounds{ { MAX, MAX, MAX }, { -MAX, -MAX, -MAX } };
+
+        for (size_t offset = 0; offset + vertexStride <= vertices.size(); offset += vertexStride) {
+            std::array<float, 3> position;
+            std::memcpy(position.data(), vertices.data() + offset, sizeof(position));
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                bounds.Min[axis] = std::min(bounds.Min[axis], position[axis]);
+                bounds.Max[axis] = std::max(bounds.Max[axis], position[axis]);
+            }
+        }
+        return bounds;
+    }
+
+    [[nodiscard]] CookedBounds MergeBounds(const CookedBounds& lhs, const CookedBounds& rhs) noexcept {
+        CookedBounds bounds;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            bounds.Min[axis] = std::min(lhs.Min[axis], rhs.Min[axis]);
+            bounds.Max[axis] = std::max(lhs.Max[axis], rhs.Max[axis]);
+        }
+        return bounds;
+    }
+}
+
+std::optional<CookedMesh> CookedMesh::Open(std::string_view path) noexcept {
+    auto file = MappedFile::Open(path);
+
+    if (!file || file->GetSize() < sizeof(CookedMeshHeader)) [[unlikely]] {
+        return {};
+    }
+
+    CookedMesh cookedMesh(std::move(*file));
+
+    if (!cookedMesh.Validate()) [[unlikely]] {
+        return {};
+    }
+    return cookedMesh;
+}
+
+CookedMesh::CookedMesh(MappedFile&& file) noexcept
+    :
+    m_file(std::move(file)),
+    m_header(reinterpret_cast<const CookedMeshHeader*>(m_file.GetData().data()))
+{}
+
+//Everything handed out later is checked once here, a truncated or stale file is rejected and cooked again
+bool CookedMesh::Validate() const noexcept {
+    const auto& header  = *m_header;
+    const auto fileSize = m_file.GetSize();
+
+    if (header.Magic != CookedMeshFormat::MAGIC || header.Version != CookedMeshFormat::VERSION || header.VertexStride == 0) {
+        return false;
+    }
+
+    const bool blobsInFile =
+        impl::IsBlobInFile(header.VertexDataOffset, header.VertexDataSize, fileSize) &&
+        impl::IsBlobInFile(header.IndexDataOffset, header.IndexDataSize, fileSize) &&
+        impl::IsBlobInFile(header.SubmeshTableOffset, uint64_t{ header.NumSubmeshes } * sizeof(CookedSubmesh), fileSize) &&
+        impl::IsBlobInFile(header.MaterialTableOffset, uint64_t{ header.NumMaterials } * sizeof(CookedMaterial), fileSize) &&
+        impl::IsBlobInFile(header.StringTableOffset, header.StringTableSize, fileSize) &&
+        impl::IsBlobInFile(header.MeshletTableOffset, uint64_t{ header.NumMeshlets } * sizeof(Meshlet), fileSize) &&
+        impl::IsBlobInFile(header.MeshletBoundsOffset, uint64_t{ header.NumMeshlets } * sizeof(MeshletBounds), fileSize) &&
+        impl::IsBlobInFile(header.MeshletVertexOffset, uint64_t{ header.NumMeshletVertices } * sizeof(uint32_t), fileSize) &&
+        impl::IsBlobInFile(header.MeshletTriangleOffset, header.MeshletTriangleSize, fileSize) &&
+        impl::IsBlobInFile(header.LodTableOffset, uint64_t{ header.NumLods } * sizeof(MeshLod), fileSize);
+
+    if (!blobsInFile || header.VertexDataSize % header.VertexStride != 0 || header.IndexDataSize % sizeof(uint32_t) != 0) {
+        return false;
+    }
+
+    const auto numVertices = header.VertexDataSize / header.VertexStride;
+    const auto numIndices  = header.IndexDataSize / sizeof(uint32_t);
+
+    //Meshlets are read by mesh shaders sized for the limits in the header, they may not exceed them
+    const auto meshlets = GetBlob<Meshlet>(header.MeshletTableOffset, uint64_t{ header.NumMeshlets } * sizeof(Meshlet));
+
+    for (const auto& meshlet : meshlets) {
+        const bool isInRange =
+            meshlet.NumVertices <= header.MaxMeshletVertices &&
+            meshlet.NumTriangles <= header.MaxMeshletTriangles &&
+            uint64_t{ meshlet.VertexOffset } + meshlet.NumVertices <= header.NumMeshletVertices &&
+            uint64_t{ meshlet.TriangleOffset } + uint64_t{ meshlet.NumTriangles } * 3 <= header.MeshletTriangleSize;
+
+        if (!isInRange) {
+            return false;
+        }
+    }
+
+    for (const auto& submesh : GetSubmeshes()) {
+        const bool isInRange =
+            uint64_t{ submesh.FirstVertex } + submesh.NumVertices <= numVertices &&
+            uint64_t{ submesh.FirstIndex } + submesh.NumIndices <= numIndices &&
+            (submesh.MaterialIndex < header.NumMaterials || submesh.MaterialIndex == CookedMeshFormat::NO_MATERIAL) &&
+            uint64_t{ submesh.FirstMeshlet } + submesh.NumMeshlets <= header.NumMeshlets &&
+            uint64_t{ submesh.FirstLod } + submesh.NumLods <= header.NumLods;
+
+        if (!isInRange) {
+            return false;
+        }
+
+        //Draws use FirstVertex as the base vertex, an index past the submesh would fetch another submesh or past the buffer
+        if (!std::ranges::all_of(GetIndices(submesh), [&](uint32_t index) { return index < submesh.NumVertices; })) {
+            return false;
+        }
+
+        //Local triangle indices pick one of the meshlet's vertices, which are indices into the submesh like the index buffer
+        for (const auto& meshlet : GetMeshlets(submesh)) {
+            const auto vertices  = GetMeshletVertices().subspan(meshlet.VertexOffset, meshlet.NumVertices);
+            const auto triangles = GetMeshletTriangles().subspan(meshlet.TriangleOffset, size_t{ meshlet.NumTriangles } * 3);
+
+            const bool isInSubmesh =
+                std::ranges::all_of(vertices, [&](uint32_t vertex) { return vertex < submesh.NumVertices; }) &&
+                std::ranges::all_of(triangles, [&](uint8_t vertex) { return vertex < meshlet.NumVertices; });
+
+            if (!isInSubmesh) {
+                return false;
+            }
+        }
+
+        for (const auto& lod : GetLods(submesh)) {
+            if (uint64_t{ lod.FirstIndex } + lod.NumIndices > submesh.NumIndices || lod.NumIndices % 3 != 0) {
+                return false;
+            }
+        }
+    }
+
+    const auto isStringInTable = [&](CookedString string) {
+        return uint64_t{ string.Offset } + string.Length <= header.StringTableSize;
+    };
+
+    for (const auto& material : GetMaterials()) {
+        if (!isStringInTable(material.Name) || !std::ranges::all_of(material.Textures, isStringInTable)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::span<const std::byte> CookedMesh::GetVertexData() const noexcept {
+    return GetBlob<std::byte>(m_header->VertexDataOffset, m_header->VertexDataSize);
+}
+
+std::span<const uint32_t> CookedMesh::GetIndices() const noexcept {
+    return GetBlob<uint32_t>(m_header->IndexDataOffset, m_header->IndexDataSize);
+}
+
+std::span<const CookedSubmesh> CookedMesh::GetSubmeshes() const noexcept {
+    return GetBlob<CookedSubmesh>(m_header->SubmeshTableOffset, uint64_t{ m_header->NumSubmeshes } * sizeof(CookedSubmesh));
+}
+
+std::span<const CookedMaterial> CookedMesh::GetMaterials() const noexcept {
+    return GetBlob<CookedMaterial>(m_header->MaterialTableOffset, uint64_t{ m_header->NumMaterials } * sizeof(CookedMaterial));
+}
+
+std::span<const std::byte> CookedMesh::GetVertexData(const CookedSubmesh& submesh) const noexcept {
+    return GetVertexData().subspan(size_t{ submesh.FirstVertex } * m_header->VertexStride, size_t{ submesh.NumVertices } * m_header->VertexStride);
+}
+
+std::span<const uint32_t> CookedMesh::GetIndices(const CookedSubmesh& submesh) const noexcept {
+    return GetIndices().subspan(submesh.FirstIndex, submesh.NumIndices);
+}
+
+std::span<const MeshLod> CookedMesh::GetLods(const CookedSubmesh& submesh) const noexcept {
+    const auto lods = GetBlob<MeshLod>(m_header->LodTableOffset, uint64_t{ m_header->NumLods } * sizeof(MeshLod));
+    return lods.subspan(submesh.FirstLod, submesh.NumLods);
+}
+
+std::span<const Meshlet> CookedMesh::GetMeshlets(const CookedSubmesh& submesh) const noexcept {
+    const auto meshlets = GetBlob<Meshlet>(m_header->MeshletTableOffset, uint64_t{ m_header->NumMeshlets } * sizeof(Meshlet));
+    return meshlets.subspan(submesh.FirstMeshlet, submesh.NumMeshlets);
+}
+
+std::span<const MeshletBounds> CookedMesh::GetMeshletBounds(const CookedSubmesh& submesh) const noexcept {
+    const auto bounds = GetBlob<MeshletBounds>(m_header->MeshletBoundsOffset, uint64_t{ m_header->NumMeshlets } * sizeof(MeshletBounds));
+    return bounds.subspan(submesh.FirstMeshlet, submesh.NumMeshlets);
+}
+
+std::span<const uint32_t> CookedMesh::GetMeshletVertices() const noexcept {
+    return GetBlob<uint32_t>(m_header->MeshletVertexOffset, uint64_t{ m_header->NumMeshletVertices } * sizeof(uint32_t));
+}
+
+std::span<const uint8_t> CookedMesh::GetMeshletTriangles() const noexcept {
+    return GetBlob<uint8_t>(m_header->MeshletTriangleOffset, m_header->MeshletTriangleSize);
+}
+
+std::string_view CookedMesh::GetString(CookedString string) const noexcept {
+    const auto strings = GetBlob<char>(m_header->StringTableOffset, m_header->StringTableSize);
+    return { strings.data() + string.Offset, string.Length };
+}
+
+CookedMeshWriter::CookedMeshWriter(uint32_t vertexStride, uint32_t vertexLayout) noexcept
+    :
+    m_vertexStride(vertexStride),
+    m_vertexLayout(vertexLayout)
+{}
+
+CookedString CookedMeshWriter::AddString(std::string_view string) {
+    const CookedString cookedString{ .Offset = static_cast<uint32_t>(m_strings.size()), .Length = static_cast<uint32_t>(string.size()) };
+
+    m_strings.append(string);
+    return cookedString;
+}
+
+uint32_t CookedMeshWriter::AddMaterial(const CookedMaterial& material) {
+    m_materials.push_back(material);
+    return static_cast<uint32_t>(m_materials.size() - 1);
+}
+
+uint32_t CookedMeshWriter::AddSubmesh(std::span<const std::byte> vertices, std::span<const uint32_t> indices, uint32_t materialIndex) {
+    return AddSubmesh(vertices, indices, materialIndex, impl::ComputeBounds(vertices, m_vertexStride));
+}
+
+uint32_t CookedMeshWriter::AddSubmesh(
+    std::span<const std::byte> vertices,
+    std::span<const uint32_t> indices,
+    uint32_t materialIndex,
+    const CookedBounds& bounds,
+    const MeshletData& meshlets,
+    const LodChain& lods)
+{
+    const auto firstMeshlet = static_cast<uint32_t>(m_meshlets.Meshlets.size());
+    const auto vertexBase   = static_cast<uint32_t>(m_meshlets.Vertices.size());
+    const auto triangleBase = static_cast<uint32_t>(m_meshlets.Triangles.size());
+
+    //Offsets are rebased onto the blobs of the file, vertex indices stay relative to the submesh
+    for (auto meshlet : meshlets.Meshlets) {
+        meshlet.VertexOffset   += vertexBase;
+        meshlet.TriangleOffset += triangleBase;
+
+        m_maxMeshletVertices  = std::max(m_maxMeshletVertices, meshlet.NumVertices);
+        m_maxMeshletTriangles = std::max(m_maxMeshletTriangles, meshlet.NumTriangles);
+        m_meshlets.Meshlets.push_back(meshlet);
+    }
+
+    m_meshlets.Bounds.insert(m_meshlets.Bounds.end(), meshlets.Bounds.begin(), meshlets.Bounds.end());
+    m_meshlets.Vertices.insert(m_meshlets.Vertices.end(), meshlets.Vertices.begin(), meshlets.Vertices.end());
+    m_meshlets.Triangles.insert(m_meshlets.Triangles.end(), meshlets.Triangles.begin(), meshlets.Triangles.end());
+
+    //The full detail mesh is the first level, the simplified ones follow it in the same index range
+    const auto firstLod = static_cast<uint32_t>(m_lods.size());
+    m_lods.push_back({ 0, static_cast<uint32_t>(indices.size()), 0.0f });
+
+    for (auto lod : lods.Levels) {
+        lod.FirstIndex += static_cast<uint32_t>(indices.size());
+        m_lods.push_back(lod);
+    }
+
+    m_submeshes.push_back({
+        .FirstVertex   = static_cast<uint32_t>(m_vertexData.size() / m_vertexStride),
+        .NumVertices   = static_cast<uint32_t>(vertices.size() / m_vertexStride),
+        .FirstIndex    = static_cast<uint32_t>(m_indices.size()),
+        .NumIndices    = static_cast<uint32_t>(indices.size() + lods.Indices.size()),
+        .MaterialIndex = materialIndex,
+        .FirstMeshlet  = firstMeshlet,
+        .NumMeshlets   = static_cast<uint32_t>(meshlets.Meshlets.size()),
+        .FirstLod      = firstLod,
+        .NumLods       = static_cast<uint32_t>(m_lods.size() - firstLod),
+        .Bounds        = bounds
+    });
+
+    m_vertexData.insert(m_vertexData.end(), vertices.begin(), vertices.end());
+    m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+    m_indices.insert(m_indices.end(), lods.Indices.begin(), lods.Indices.end());
+
+    return static_cast<uint32_t>(m_submeshes.size() - 1);
+}
+
+bool CookedMeshWriter::Write(std::string_view path) const {
+    CookedMeshHeader header{
+        .Magic        = CookedMeshFormat::MAGIC,
+        .Version      = CookedMeshFormat::VERSION,
+        .VertexStride = m_vertexStride,
+        .NumSubmeshes = static_cast<uint32_t>(m_submeshes.size()),
+        .NumMaterials = static_cast<uint32_t>(m_materials.size()),
+        .VertexLayout = m_vertexLayout
+    };
+
+    //Blobs follow the header in the order they are written below
+    header.VertexDataOffset    = sizeof(CookedMeshHeader);
+    header.VertexDataSize      = m_vertexData.size();
+    header.IndexDataOffset     = impl::AlignBlob(header.VertexDataOffset + header.VertexDataSize);
+    header.IndexDataSize       = m_indices.size() * sizeof(uint32_t);
+    header.SubmeshTableOffset  = impl::AlignBlob(header.IndexDataOffset + header.IndexDataSize);
+    header.MaterialTableOffset = impl::AlignBlob(header.SubmeshTableOffset + m_submeshes.size() * sizeof(CookedSubmesh));
+    header.StringTableOffset   = impl::AlignBlob(header.MaterialTableOffset + m_materials.size() * sizeof(CookedMaterial));
+    header.StringTableSize     = m_strings.size();
+
+    header.MeshletTableOffset    = impl::AlignBlob(header.StringTableOffset + header.StringTableSize);
+    header.MeshletBoundsOffset   = impl::AlignBlob(header.MeshletTableOffset + m_meshlets.Meshlets.size() * sizeof(Meshlet));
+    header.MeshletVertexOffset   = impl::AlignBlob(header.MeshletBoundsOffset + m_meshlets.Bounds.size() * sizeof(MeshletBounds));
+    header.MeshletTriangleOffset = impl::AlignBlob(header.MeshletVertexOffset + m_meshlets.Vertices.size() * sizeof(uint32_t));
+    header.NumMeshlets           = static_cast<uint32_t>(m_meshlets.Meshlets.size());
+    header.NumMeshletVertices    = static_cast<uint32_t>(m_meshlets.Vertices.size());
+    header.MeshletTriangleSize   = static_cast<uint32_t>(m_meshlets.Triangles.size());
+    header.MaxMeshletVertices    = static_cast<uint16_t>(m_maxMeshletVertices);
+    header.MaxMeshletTriangles   = static_cast<uint16_t>(m_maxMeshletTriangles);
+
+    header.LodTableOffset = impl::AlignBlob(header.MeshletTriangleOffset + header.MeshletTriangleSize);
+    header.NumLods        = static_cast<uint32_t>(m_lods.size());
+
+    header.Bounds = m_submeshes.empty() ? CookedBounds{} : m_submeshes.front().Bounds;
+
+    for (const auto& submesh : m_submeshes) {
+        header.Bounds = impl::MergeBounds(header.Bounds, submesh.Bounds);
+    }
+
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+
+    if (!file) [[unlikely]] {
+        return false;
+    }
+
+    const auto writeBlob = [&](uint64_t offset, const void* data, size_t sizeInBytes) {
+        constexpr std::array<char, CookedMeshFormat::BLOB_ALIGNMENT> PADDING{};
+
+        const auto position = static_cast<uint64_t>(file.tellp());
+        file.write(PADDING.data(), static_cast<std::streamsize>(offset - position));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(sizeInBytes));
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeBlob(header.VertexDataOffset, m_vertexData.data(), m_vertexData.size());
+    writeBlob(header.IndexDataOffset, m_indices.data(), header.IndexDataSize);
+    writeBlob(header.SubmeshTableOffset, m_submeshes.data(), m_submeshes.size() * sizeof(CookedSubmesh));
+    writeBlob(header.MaterialTableOffset, m_materials.data(), m_materials.size() * sizeof(CookedMaterial));
+    writeBlob(header.StringTableOffset, m_strings.data(), m_strings.size());
+    writeBlob(header.MeshletTableOffset, m_meshlets.Meshlets.data(), m_meshlets.Meshlets.size() * sizeof(Meshlet));
+    writeBlob(header.MeshletBoundsOffset, m_meshlets.Bounds.data(), m_meshlets.Bounds.size() * sizeof(MeshletBounds));
+    writeBlob(header.MeshletVertexOffset, m_meshlets.Vertices.data(), m_meshlets.Vertices.size() * sizeof(uint32_t));
+    writeBlob(header.MeshletTriangleOffset, m_meshlets.Triangles.data(), m_meshlets.Triangles.size());
+    writeBlob(header.LodTableOffset, m_lods.data(), m_lods.size() * sizeof(MeshLod));
+
+    return file.good();
+}
@@ -0,0 +1,176 @@
+#pragma once
+#include "Meshlets.h"
+#include "MeshSimplifier.h"
+#include "Core/FileSystem/MappedFile.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crystal {
+    namespace CookedMeshFormat {
+        constexpr uint32_t MAGIC          = 0x48534D43; //"CMSH"
+        constexpr uint32_t VERSION        = 4;
+        constexpr uint32_t BLOB_ALIGNMENT = 16;
+
+        //One slot per Material::TextureID
+        constexpr uint32_t NUM_TEXTURE_SLOTS = 8;
+        constexpr uint32_t NO_MATERIAL       = ~0u;
+    }
+
+    struct CookedBounds {
+        std::array<float, 3> Min;
+        std::array<float, 3> Max;
+    };
+
+    //Offsets are in bytes from the start of the file, every blob starts on BLOB_ALIGNMENT
+    struct CookedMeshHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t VertexStride;
+        uint32_t NumSubmeshes;
+        uint32_t NumMaterials;
+        //Crystal::VertexLayout of the vertex data, the container itself only relies on the stride
+        uint32_t VertexLayout;
+
+        uint64_t VertexDataOffset;
+        uint64_t VertexDataSize;
+        uint64_t IndexDataOffset;
+        uint64_t IndexDataSize;
+        uint64_t SubmeshTableOffset;
+        uint64_t MaterialTableOffset;
+        uint64_t StringTableOffset;
+        uint64_t StringTableSize;
+
+        //Meshlet and bounds tables have NumMeshlets entries, meshlet vertices are relative to the submesh's FirstVertex
+        uint64_t MeshletTableOffset;
+        uint64_t MeshletBoundsOffset;
+        uint64_t MeshletVertexOffset;
+        uint64_t MeshletTriangleOffset;
+        uint32_t NumMeshlets;
+        uint32_t NumMeshletVertices;
+        uint32_t MeshletTriangleSize;
+        uint16_t MaxMeshletVertices;
+        uint16_t MaxMeshletTriangles;
+
+        //MeshLod entries, their index ranges are relative to the submesh's FirstIndex
+        uint64_t LodTableOffset;
+        uint32_t NumLods;
+        uint32_t Reserved;
+
+        CookedBounds Bounds;
+    };
+
+    //Indices are relative to FirstVertex, draws pass it as the base vertex. The index range holds every level of
+    //detail, the full detail mesh comes first.
+    struct CookedSubmesh {
+        uint32_t FirstVertex;
+        uint32_t NumVertices;
+        uint32_t FirstIndex;
+        uint32_t NumIndices;
+        uint32_t MaterialIndex;
+        uint32_t FirstMeshlet;
+        uint32_t NumMeshlets;
+        uint32_t FirstLod;
+        uint32_t NumLods;
+        CookedBounds Bounds;
+    };
+
+    //Range in the string table, an empty string has length 0
+    struct CookedString {
+        uint32_t Offset{ 0 };
+        uint32_t Length{ 0 };
+    };
+
+    struct CookedMaterial {
+        CookedString Name;
+
+        //Paths are relative to the cooked file
+        std::array<CookedString, CookedMeshFormat::NUM_TEXTURE_SLOTS> Textures;
+        uint32_t SRGBTextureMask{ 0 };
+
+        std::array<float, 4> Diffuse    { 1.0f, 1.0f, 1.0f, 1.0f };
+        std::array<float, 4> Specular   { 1.0f, 1.0f, 1.0f, 1.0f };
+        std::array<float, 4> Emissive   { 0.0f, 0.0f, 0.0f, 1.0f };
+        std::array<float, 4> Ambient    { 0.0f, 0.0f, 0.0f, 1.0f };
+        std::array<float, 4> Reflectance{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+        float Opacity          { 1.0f   };
+        float SpecularPower    { 128.0f };
+        float IndexOfRefraction{ 0.0f   };
+        float BumpIntensity    { 1.0f   };
+    };
+
+    //A cooked mesh file mapped into memory. Opening only validates the tables, vertex and index data are handed out
+    //as views into the mapping and can be copied to upload memory directly.
+    class CookedMesh {
+    public:
+        [[nodiscard]] static std::optional<CookedMesh> Open(std::string_view path) noexcept;
+
+        [[nodiscard]] const CookedMeshHeader& GetHeader() const noexcept { return *m_header; }
+        [[nodiscard]] std::span<const std::byte> GetVertexData() const noexcept;
+        [[nodiscard]] std::span<const uint32_t> GetIndices() const noexcept;
+        [[nodiscard]] std::span<const CookedSubmesh> GetSubmeshes() const noexcept;
+        [[nodiscard]] std::span<const CookedMaterial> GetMaterials() const noexcept;
+
+        [[nodiscard]] std::span<const std::byte> GetVertexData(const CookedSubmesh& submesh) const noexcept;
+        [[nodiscard]] std::span<const uint32_t> GetIndices(const CookedSubmesh& submesh) const noexcept;
+        [[nodiscard]] std::span<const MeshLod> GetLods(const CookedSubmesh& submesh) const noexcept;
+
+        //Offsets of the meshlets index the meshlet vertex and triangle blobs of the whole file
+        [[nodiscard]] std::span<const Meshlet> GetMeshlets(const CookedSubmesh& submesh) const noexcept;
+        [[nodiscard]] std::span<const MeshletBounds> GetMeshletBounds(const CookedSubmesh& submesh) const noexcept;
+        [[nodiscard]] std::span<const uint32_t> GetMeshletVertices() const noexcept;
+        [[nodiscard]] std::span<const uint8_t> GetMeshletTriangles() const noexcept;
+        [[nodiscard]] std::string_view GetString(CookedString string) const noexcept;
+    private:
+        explicit CookedMesh(MappedFile&& file) noexcept;
+
+        [[nodiscard]] bool Validate() const noexcept;
+
+        template <class T>
+        [[nodiscard]] std::span<const T> GetBlob(uint64_t offset, uint64_t sizeInBytes) const noexcept {
+            return { reinterpret_cast<const T*>(m_file.GetData().data() + offset), static_cast<size_t>(sizeInBytes / sizeof(T)) };
+        }
+
+        MappedFile m_file;
+        const CookedMeshHeader* m_header{ nullptr };
+    };
+
+    //Collects submeshes with their meshlets and levels of detail and materials and writes them in the cooked layout.
+    //Unless the bounds are given, the first three floats of every vertex have to be its position, they are used to compute them.
+    class CookedMeshWriter {
+    public:
+        explicit CookedMeshWriter(uint32_t vertexStride, uint32_t vertexLayout = 0) noexcept;
+
+        [[nodiscard]] CookedString AddString(std::string_view string);
+        uint32_t AddMaterial(const CookedMaterial& material);
+        uint32_t AddSubmesh(std::span<const std::byte> vertices, std::span<const uint32_t> indices, uint32_t materialIndex);
+        uint32_t AddSubmesh(
+            std::span<const std::byte> vertices,
+            std::span<const uint32_t> indices,
+            uint32_t materialIndex,
+            const CookedBounds& bounds,
+            const MeshletData& meshlets = {},
+            const LodChain& lods = {});
+
+        [[nodiscard]] bool Write(std::string_view path) const;
+    private:
+        uint32_t m_vertexStride;
+        uint32_t m_vertexLayout;
+
+        std::vector<std::byte> m_vertexData;
+        std::vector<uint32_t> m_indices;
+        std::vector<CookedSubmesh> m_submeshes;
+        std::vector<CookedMaterial> m_materials;
+        std::vector<MeshLod> m_lods;
+        std::string m_strings;
+
+        MeshletData m_meshlets;
+        uint32_t m_maxMeshletVertices{ 0 };
+        uint32_t m_maxMeshletTriangles{ 0 };
+    };
+}
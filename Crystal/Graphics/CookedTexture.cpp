@@ -0,0 +1,219 @@
+#include "CookedTexture.h"
+#include "MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+using namespace Crystal;
+
+static_assert(std::is_trivially_copyable_v<CookedTextureHeader> && sizeof(CookedTextureHeader) % 16 == 0);
+static_assert(std::is_trivially_copyable_v<CookedTextureMip> && sizeof(CookedTextureMip) % 16 == 0);
+
+namespace impl {
+    [[nodiscard]] constexpr uint64_t AlignTextureOffset(uint64_t offset, uint64_t alignment) noexcept {
+        return (offset + alignment - 1) & ~(alignment - 1);
+    }
+
+    [[nodiscard]] constexpr uint32_t GetNumBlocks(uint32_t texels, uint32_t blockSize) noexcept {
+        return (texels + blockSize - 1) / blockSize;
+    }
+
+    [[nodiscard]] constexpr bool IsTextureRangeInFile(uint64_t offset, uint64_t sizeInBytes, uint64_t fileSize) noexcept {
+        return offset <= fileSize && sizeInBytes <= fileSize - offset;
+    }
+}
+
+std::optional<CookedTexture> CookedTexture::Open(std::string_view path) noexcept {
+    auto file = MappedFile::Open(path);
+
+    if (!file || file->GetSize() < sizeof(CookedTextureHeader)) [[unlikely]] {
+        return {};
+    }
+
+    CookedTexture cookedTexture(std::move(*file));
+
+    if (!cookedTexture.Validate()) [[unlikely]] {
+        return {};
+    }
+    return cookedTexture;
+}
+
+CookedTexture::CookedTexture(MappedFile&& file) noexcept
+    :
+    m_file(std::move(file)),
+    m_header(reinterpret_cast<const CookedTextureHeader*>(m_file.GetData().data()))
+{}
+
+//Every mip is checked against the size it must have at its level, so the views handed out later never leave the file
+bool CookedTexture::Validate() const noexcept {
+    const auto& header  = *m_header;
+    const auto fileSize = m_file.GetSize();
+
+    const bool isHeaderValid =
+        header.Magic == CookedTextureFormat::MAGIC &&
+        header.Version == CookedTextureFormat::VERSION &&
+        header.Width > 0 && header.Height > 0 &&
+        header.NumMips > 0 && header.NumMips <= CookedTextureFormat::MAX_MIPS &&
+        header.NumMips <= GetNumMips(header.Width, header.Height) &&
+        header.NumTailMips <= header.NumMips &&
+        header.BlockSize > 0 && header.BytesPerBlock > 0 &&
+        header.MipTableOffset % alignof(CookedTextureMip) == 0 &&
+        impl::IsTextureRangeInFile(header.MipTableOffset, uint64_t{ header.NumMips } * sizeof(CookedTextureMip), fileSize);
+
+    if (!isHeaderValid) {
+        return false;
+    }
+
+    const auto mips = GetMips();
+
+    for (uint32_t mip = 0; mip < header.NumMips; mip++) {
+        const auto& cookedMip = mips[mip];
+
+        const auto width   = std::max(header.Width >> mip, 1u);
+        const auto height  = std::max(header.Height >> mip, 1u);
+        const auto rowSize = uint64_t{ impl::GetNumBlocks(width, header.BlockSize) } * header.BytesPerBlock;
+        const auto numRows = impl::GetNumBlocks(height, header.BlockSize);
+
+        const bool isMipValid =
+            cookedMip.Width == width && cookedMip.Height == height && cookedMip.NumRows == numRows &&
+            cookedMip.RowPitch >= rowSize && cookedMip.RowPitch % CookedTextureFormat::ROW_PITCH_ALIGNMENT == 0 &&
+            cookedMip.Size == uint64_t{ cookedMip.RowPitch } * numRows &&
+            cookedMip.Offset % CookedTextureFormat::MIP_ALIGNMENT == 0 &&
+            impl::IsTextureRangeInFile(cookedMip.Offset, cookedMip.Size, fileSize);
+
+        //Smaller mips come first, GetLoadSize relies on it
+        const bool isOrdered = mip + 1 == header.NumMips || cookedMip.Offset >= mips[mip + 1].Offset + mips[mip + 1].Size;
+
+        if (!isMipValid || !isOrdered) {
+            return false;
+        }
+    }
+
+    if (header.NumTailMips == 0) {
+        return header.TailSize == 0;
+    }
+
+    const auto& firstTailMip = mips[GetFirstTailMip()];
+    return header.TailOffset == mips.back().Offset && header.TailOffset + header.TailSize == firstTailMip.Offset + firstTailMip.Size;
+}
+
+std::span<const CookedTextureMip> CookedTexture::GetMips() const noexcept {
+    return { reinterpret_cast<const CookedTextureMip*>(m_file.GetData().data() + m_header->MipTableOffset), m_header->NumMips };
+}
+
+std::span<const std::byte> CookedTexture::GetMipData(uint32_t mip) const noexcept {
+    const auto& cookedMip = GetMips()[mip];
+    return m_file.GetData().subspan(static_cast<size_t>(cookedMip.Offset), static_cast<size_t>(cookedMip.Size));
+}
+
+uint64_t CookedTexture::GetLoadSize(uint32_t firstMip) const noexcept {
+    const auto& cookedMip = GetMips()[firstMip];
+    return cookedMip.Offset + cookedMip.Size;
+}
+
+CookedTextureWriter::CookedTextureWriter(uint32_t format, uint32_t blockSize, uint32_t bytesPerBlock, bool isSRGB) noexcept
+    :
+    m_format(format),
+    m_blockSize(blockSize),
+    m_bytesPerBlock(bytesPerBlock),
+    m_isSRGB(isSRGB)
+{}
+
+void CookedTextureWriter::AddMip(uint32_t width, uint32_t height, std::span<const uint8_t> blocks) {
+    assert(blocks.size() == size_t{ impl::GetNumBlocks(width, m_blockSize) } * impl::GetNumBlocks(height, m_blockSize) * m_bytesPerBlock);
+    m_mips.push_back({ width, height, { blocks.begin(), blocks.end() } });
+}
+
+void CookedTextureWriter::AddMips(const MipChain& mipChain) {
+    for (uint32_t mip = 0; mip < mipChain.Levels.size(); mip++) {
+        AddMip(mipChain.Levels[mip].Width, mipChain.Levels[mip].Height, mipChain.GetTexels(mip));
+    }
+}
+
+bool CookedTextureWriter::Write(std::string_view path) const {
+    if (m_mips.empty() || m_mips.size() > CookedTextureFormat::MAX_MIPS) [[unlikely]] {
+        return false;
+    }
+
+    const auto numMips = static_cast<uint32_t>(m_mips.size());
+
+    CookedTextureHeader header{
+        .Magic          = CookedTextureFormat::MAGIC,
+        .Version        = CookedTextureFormat::VERSION,
+        .Format         = m_format,
+        .Flags          = m_isSRGB ? CookedTextureFormat::FLAG_SRGB : 0,
+        .Width          = m_mips.front().Width,
+        .Height         = m_mips.front().Height,
+        .NumMips        = numMips,
+        .BlockSize      = m_blockSize,
+        .BytesPerBlock  = m_bytesPerBlock,
+        .MipTableOffset = sizeof(CookedTextureHeader)
+    };
+
+    std::vector<CookedTextureMip> cookedMips(numMips);
+
+    for (uint32_t mip = 0; mip < numMips; mip++) {
+        const auto rowSize = impl::GetNumBlocks(m_mips[mip].Width, m_blockSize) * m_bytesPerBlock;
+
+        auto& cookedMip    = cookedMips[mip];
+        cookedMip.Width    = m_mips[mip].Width;
+        cookedMip.Height   = m_mips[mip].Height;
+        cookedMip.RowPitch = static_cast<uint32_t>(impl::AlignTextureOffset(rowSize, CookedTextureFormat::ROW_PITCH_ALIGNMENT));
+        cookedMip.NumRows  = impl::GetNumBlocks(m_mips[mip].Height, m_blockSize);
+        cookedMip.Size     = uint64_t{ cookedMip.RowPitch } * cookedMip.NumRows;
+    }
+
+    //Sizes only shrink down the chain, so the tail is the run of small mips at its end
+    while (header.NumTailMips < numMips && cookedMips[numMips - 1 - header.NumTailMips].Size < CookedTextureFormat::STREAMING_ALIGNMENT) {
+        header.NumTailMips++;
+    }
+
+    auto offset = impl::AlignTextureOffset(header.MipTableOffset + numMips * sizeof(CookedTextureMip), CookedTextureFormat::MIP_ALIGNMENT);
+    header.TailOffset = offset;
+
+    for (uint32_t mip = numMips; mip-- > 0;) {
+        const bool isTail    = mip >= numMips - header.NumTailMips;
+        const auto alignment = isTail ? CookedTextureFormat::MIP_ALIGNMENT : CookedTextureFormat::STREAMING_ALIGNMENT;
+
+        cookedMips[mip].Offset = impl::AlignTextureOffset(offset, alignment);
+        offset                 = cookedMips[mip].Offset + cookedMips[mip].Size;
+
+        if (isTail) {
+            header.TailSize = offset - header.TailOffset;
+        }
+    }
+
+    std::ofstream file(std::string(path), std::ios::binary | std::ios::trunc);
+
+    if (!file) [[unlikely]] {
+        return false;
+    }
+
+    static constexpr std::array<char, CookedTextureFormat::STREAMING_ALIGNMENT> PADDING{};
+
+    const auto writePadding = [&](uint64_t sizeInBytes) {
+        file.write(PADDING.data(), static_cast<std::streamsize>(sizeInBytes));
+    };
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(cookedMips.data()), static_cast<std::streamsize>(cookedMips.size() * sizeof(CookedTextureMip)));
+
+    //Mips are written in file order, from 1x1 up
+    for (uint32_t mip = numMips; mip-- > 0;) {
+        const auto& cookedMip = cookedMips[mip];
+        const auto rowSize    = impl::GetNumBlocks(cookedMip.Width, m_blockSize) * m_bytesPerBlock;
+        const auto* blocks    = reinterpret_cast<const char*>(m_mips[mip].Blocks.data());
+
+        writePadding(cookedMip.Offset - static_cast<uint64_t>(file.tellp()));
+
+        for (uint32_t row = 0; row < cookedMip.NumRows; row++) {
+            file.write(blocks + size_t{ row } * rowSize, rowSize);
+            writePadding(cookedMip.RowPitch - rowSize);
+        }
+    }
+    return file.good();
+}
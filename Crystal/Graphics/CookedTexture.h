@@ -0,0 +1,120 @@
+#pragma once
+#include "Core/FileSystem/MappedFile.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Crystal {
+    struct MipChain;
+
+    namespace CookedTextureFormat {
+        constexpr uint32_t MAGIC   = 0x58455443; //"CTEX"
+        constexpr uint32_t VERSION = 1;
+
+        //D3D12_TEXTURE_DATA_PITCH_ALIGNMENT and D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, a mip can be copied into upload
+        //memory as it is stored and used as the placed footprint of a texture copy
+        constexpr uint32_t ROW_PITCH_ALIGNMENT = 256;
+        constexpr uint32_t MIP_ALIGNMENT       = 512;
+
+        //Size of a tiled resource tile and the granularity file views are mapped at on Windows. Mips at least this
+        //large start on a boundary of their own so they can be mapped and streamed in one by one, the smaller ones
+        //are packed together into the mip tail at the front of the file and always loaded as a whole.
+        constexpr uint32_t STREAMING_ALIGNMENT = 65536;
+
+        constexpr uint32_t MAX_MIPS = 16;
+
+        //Stored as the DXGI_FORMAT value, sRGB is a flag so the same data can be viewed either way
+        constexpr uint32_t FORMAT_R8G8B8A8_UNORM = 28;
+
+        constexpr uint32_t FLAG_SRGB = 1 << 0;
+    }
+
+    //Offsets are in bytes from the start of the file. The mip table follows the header, then the mip tail
+    //and then the remaining mips from the smallest to the largest, so loading up to a given resolution reads
+    //a single range from the start of the file.
+    struct CookedTextureHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t Format;
+        uint32_t Flags;
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t NumMips;
+
+        //Texels are stored in blocks, 1x1 for plain formats and 4x4 for block compressed ones
+        uint32_t BlockSize;
+        uint32_t BytesPerBlock;
+
+        //The last NumTailMips mips form the tail
+        uint32_t NumTailMips;
+
+        uint64_t MipTableOffset;
+        uint64_t TailOffset;
+        uint64_t TailSize;
+    };
+
+    //Rows of blocks, every row starts on ROW_PITCH_ALIGNMENT
+    struct CookedTextureMip {
+        uint32_t Width;
+        uint32_t Height;
+        uint32_t RowPitch;
+        uint32_t NumRows;
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    //A cooked texture file mapped into memory. Opening only validates the tables, mip data is handed out
+    //as views into the mapping and only paged in once it is read.
+    class CookedTexture {
+    public:
+        [[nodiscard]] static std::optional<CookedTexture> Open(std::string_view path) noexcept;
+
+        [[nodiscard]] const CookedTextureHeader& GetHeader() const noexcept { return *m_header; }
+        [[nodiscard]] bool IsSRGB() const noexcept { return (m_header->Flags & CookedTextureFormat::FLAG_SRGB) != 0; }
+
+        [[nodiscard]] std::span<const CookedTextureMip> GetMips() const noexcept;
+        [[nodiscard]] std::span<const std::byte> GetMipData(uint32_t mip) const noexcept;
+
+        //First mip that is not part of the tail
+        [[nodiscard]] uint32_t GetFirstTailMip() const noexcept { return m_header->NumMips - m_header->NumTailMips; }
+
+        //Bytes from the start of the file that hold every mip from firstMip down to 1x1
+        [[nodiscard]] uint64_t GetLoadSize(uint32_t firstMip) const noexcept;
+    private:
+        explicit CookedTexture(MappedFile&& file) noexcept;
+
+        [[nodiscard]] bool Validate() const noexcept;
+
+        MappedFile m_file;
+        const CookedTextureHeader* m_header{ nullptr };
+    };
+
+    //Collects the mips of a 2D texture, most detailed first, and writes them in the cooked layout
+    class CookedTextureWriter {
+    public:
+        CookedTextureWriter(uint32_t format, uint32_t blockSize, uint32_t bytesPerBlock, bool isSRGB) noexcept;
+
+        //Rows of blocks without any padding between them
+        void AddMip(uint32_t width, uint32_t height, std::span<const uint8_t> blocks);
+
+        //Every mip of an RGBA8 chain
+        void AddMips(const MipChain& mipChain);
+
+        [[nodiscard]] bool Write(std::string_view path) const;
+    private:
+        struct Mip {
+            uint32_t Width;
+            uint32_t Height;
+            std::vector<uint8_t> Blocks;
+        };
+
+        uint32_t m_format;
+        uint32_t m_blockSize;
+        uint32_t m_bytesPerBlock;
+        bool m_isSRGB;
+
+        std::vector<Mip> m_mips;
+    };
+}
@@ -0,0 +1,759 @@
+#include "GlbFile.h"
+#include "Core/Lib/Json.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <ranges>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr size_t GLB_HEADER_SIZE = 12;
+    constexpr size_t GLB_CHUNK_HEADER_SIZE = 8;
+
+    constexpr int64_t MODE_TRIANGLES = 4;
+
+    struct GltfBufferView {
+        std::span<const std::byte> Data;
+        uint32_t Stride{ 0 };
+    };
+
+    [[nodiscard]] uint32_t ReadGlbWord(std::span<const std::byte> data, size_t offset) noexcept {
+        uint32_t word;
+        std::memcpy(&word, data.data() + offset, sizeof(word));
+        return word;
+    }
+
+    //Largest integer a JSON number holds exactly, anything above it is rejected before it is converted
+    constexpr double MAX_GLTF_INTEGER = 9007199254740992.0;
+
+    [[nodiscard]] std::optional<uint64_t> AsGltfUnsigned(const Json::Value& value) noexcept {
+        const auto number = value.IsNumber() ? value.AsNumber() : -1.0;
+
+        if (!(number >= 0.0 && number <= MAX_GLTF_INTEGER) || number != std::floor(number)) {
+            return {};
+        }
+        return static_cast<uint64_t>(number);
+    }
+
+    //Non-negative integer member, the fallback when it is missing
+    [[nodiscard]] std::optional<uint64_t> GetGltfUnsigned(const Json::Value& object, std::string_view key, std::optional<uint64_t> fallback = {}) {
+        const auto* value = object.Find(key);
+        return value ? AsGltfUnsigned(*value) : fallback;
+    }
+
+    template <size_t N>
+    void ReadGltfFloats(const Json::Value& object, std::string_view key, std::array<float, N>& output) {
+        const auto* value = object.Find(key);
+
+        if (!value || value->Size() != N) {
+            return;
+        }
+
+        for (size_t i = 0; i < N; i++) {
+            output[i] = static_cast<float>(value->At(i)->AsNumber(output[i]));
+        }
+    }
+
+    //Local transform of a node, a matrix or translation, rotation and scale. glTF's column major matrices transform
+    //column vectors, read in order they are the matrices of the engine, which transform row vectors.
+    [[nodiscard]] Math::Matrix GetGltfNodeTransform(const Json::Value& node) {
+        if (node.Find("matrix")) {
+            std::array<float, 16> m{ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+            ReadGltfFloats(node, "matrix", m);
+
+            return { m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7], m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15] };
+        }
+
+        std::array<float, 3> translation{ 0.0f, 0.0f, 0.0f };
+        std::array<float, 4> rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+        std::array<float, 3> scale{ 1.0f, 1.0f, 1.0f };
+
+        ReadGltfFloats(node, "translation", translation);
+        ReadGltfFloats(node, "rotation", rotation);
+        ReadGltfFloats(node, "scale", scale);
+
+        return {
+            Math::Vector3(translation[0], translation[1], translation[2]),
+            Math::Quaternion(rotation[0], rotation[1], rotation[2], rotation[3]),
+            Math::Vector3(scale[0], scale[1], scale[2])
+        };
+    }
+
+    //Negative for transforms that mirror the mesh
+    [[nodiscard]] float GetGltfDeterminant(const Math::Matrix& m) noexcept {
+        return m.m00 * (m.m11 * m.m22 - m.m12 * m.m21) - m.m01 * (m.m10 * m.m22 - m.m12 * m.m20) + m.m02 * (m.m10 * m.m21 - m.m11 * m.m20);
+    }
+
+    [[nodiscard]] Math::Vector3 TransformGltfDirection(const Math::Vector3& v, const Math::Matrix& m) noexcept {
+        return {
+            v.x * m.m00 + v.y * m.m10 + v.z * m.m20,
+            v.x * m.m01 + v.y * m.m11 + v.z * m.m21,
+            v.x * m.m02 + v.y * m.m12 + v.z * m.m22
+        };
+    }
+
+    //Node transforms are in glTF's space, mirroring z on both sides applies them to vertices in the engine convention.
+    //Normals use the inverse transpose, which keeps them perpendicular to the surface under non-uniform scale.
+    void TransformGltfVertices(std::span<Vertex> vertices, const Math::Matrix& gltfTransform) noexcept {
+        const auto mirror          = Math::Matrix::CreateScale(1.0f, 1.0f, -1.0f);
+        const auto transform       = mirror * gltfTransform * mirror;
+        const auto normalTransform = Math::Matrix::Transpose(Math::Matrix::Inverse(transform));
+        const auto translation     = transform.GetTranslation();
+
+        //Most nodes only move their mesh, its directions stay as they are
+        const bool isTranslation =
+            transform.m00 == 1.0f && transform.m01 == 0.0f && transform.m02 == 0.0f &&
+            transform.m10 == 0.0f && transform.m11 == 1.0f && transform.m12 == 0.0f &&
+            transform.m20 == 0.0f && transform.m21 == 0.0f && transform.m22 == 1.0f;
+
+        if (isTranslation) {
+            for (auto& vertex : vertices) {
+                vertex.Position = vertex.Position + translation;
+            }
+            return;
+        }
+
+        for (auto& vertex : vertices) {
+            vertex.Position  = TransformGltfDirection(vertex.Position, transform) + translation;
+            vertex.Normal    = TransformGltfDirection(vertex.Normal, normalTransform).Normalized();
+            vertex.Tangent   = TransformGltfDirection(vertex.Tangent, transform).Normalized();
+            vertex.Bitangent = TransformGltfDirection(vertex.Bitangent, transform).Normalized();
+        }
+    }
+
+    [[nodiscard]] uint32_t GetGltfComponentSize(GltfComponentType componentType) noexcept {
+        switch (componentType) {
+            case GltfComponentType::Byte:
+            case GltfComponentType::UnsignedByte:  return 1;
+            case GltfComponentType::Short:
+            case GltfComponentType::UnsignedShort: return 2;
+            default:                               return 4;
+        }
+    }
+
+    [[nodiscard]] uint32_t GetGltfNumComponents(std::string_view type) noexcept {
+        if (type == "SCALAR") return 1;
+        if (type == "VEC2")   return 2;
+        if (type == "VEC3")   return 3;
+        if (type == "VEC4")   return 4;
+        return 0;
+    }
+
+    [[nodiscard]] bool IsGltfComponentType(uint64_t componentType) noexcept {
+        return (componentType >= 5120 && componentType <= 5123) || componentType == 5125 || componentType == 5126;
+    }
+
+    //Relative URIs may escape reserved characters, spaces in file names are the common case
+    [[nodiscard]] std::string DecodeGltfUri(std::string_view uri) {
+        std::string decoded;
+        decoded.reserve(uri.size());
+
+        const auto toDigit = [](char c) -> int {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return -1;
+        };
+
+        for (size_t i = 0; i < uri.size(); i++) {
+            if (uri[i] == '%' && i + 2 < uri.size() && toDigit(uri[i + 1]) >= 0 && toDigit(uri[i + 2]) >= 0) {
+                decoded.push_back(static_cast<char>(toDigit(uri[i + 1]) * 16 + toDigit(uri[i + 2])));
+                i += 2;
+            }
+            else {
+                decoded.push_back(uri[i]);
+            }
+        }
+        return decoded;
+    }
+
+    //Float elements that are packed tightly are read in place, anything else is converted element by element
+    template <size_t N, class Function>
+    void ForEachGltfElement(const GltfAccessor& accessor, Function&& function) {
+        if (accessor.ComponentType == GltfComponentType::Float) {
+            if (const auto elements = accessor.AsSpan<std::array<float, N>>(); !elements.empty()) [[likely]] {
+                for (uint32_t i = 0; i < elements.size(); i++) {
+                    function(i, elements[i]);
+                }
+                return;
+            }
+        }
+
+        std::array<float, N> element{};
+
+        for (uint32_t i = 0; i < accessor.Count; i++) {
+            accessor.ReadFloats(i, element);
+            function(i, element);
+        }
+    }
+
+    //Area weighted, the cross product of two edges is twice the area of the triangle
+    void ComputeGltfNormals(std::span<Vertex> vertices, std::span<const uint32_t> indices) noexcept {
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            auto& v0 = vertices[indices[i]];
+            auto& v1 = vertices[indices[i + 1]];
+            auto& v2 = vertices[indices[i + 2]];
+
+            const auto normal = (v1.Position - v0.Position).Cross(v2.Position - v0.Position);
+
+            v0.Normal = v0.Normal + normal;
+            v1.Normal = v1.Normal + normal;
+            v2.Normal = v2.Normal + normal;
+        }
+
+        for (auto& vertex : vertices) {
+            vertex.Normal.Normalize();
+        }
+    }
+
+    //Texture space of every triangle summed per vertex and made orthogonal to the normal, like assimp's CalcTangentSpace
+    void ComputeGltfTangents(std::span<Vertex> vertices, std::span<const uint32_t> indices) noexcept {
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            auto& v0 = vertices[indices[i]];
+            auto& v1 = vertices[indices[i + 1]];
+            auto& v2 = vertices[indices[i + 2]];
+
+            const auto e1 = v1.Position - v0.Position;
+            const auto e2 = v2.Position - v0.Position;
+            const auto t1 = v1.TexCoord - v0.TexCoord;
+            const auto t2 = v2.TexCoord - v0.TexCoord;
+
+            const auto determinant = t1.x * t2.y - t2.x * t1.y;
+
+            if (determinant == 0.0f) [[unlikely]] {
+                continue;
+            }
+
+            const auto tangent   = (e1 * t2.y - e2 * t1.y) * (1.0f / determinant);
+            const auto bitangent = (e2 * t1.x - e1 * t2.x) * (1.0f / determinant);
+
+            for (auto* vertex : { &v0, &v1, &v2 }) {
+                vertex->Tangent   = vertex->Tangent + tangent;
+                vertex->Bitangent = vertex->Bitangent + bitangent;
+            }
+        }
+
+        for (auto& vertex : vertices) {
+            vertex.Tangent   = (vertex.Tangent - vertex.Normal * vertex.Normal.Dot(vertex.Tangent)).Normalized();
+            vertex.Bitangent = (vertex.Bitangent - vertex.Normal * vertex.Normal.Dot(vertex.Bitangent)).Normalized();
+        }
+    }
+
+    //Walks the default scene depth first, the children of a node follow it in order. Without a scene every node that is
+    //not a child is a root. A node reached twice is either shared or part of a cycle, neither is valid glTF.
+    [[nodiscard]] bool AddGltfMeshInstances(const Json::Value& document, std::span<const std::vector<GltfPrimitive>> meshPrimitives, std::vector<GltfPrimitive>& instances) {
+        const auto* nodes = document.Find("nodes");
+
+        if (!nodes || !nodes->IsArray() || nodes->Size() == 0) {
+            for (const auto& primitives : meshPrimitives) {
+                instances.insert(instances.end(), primitives.begin(), primitives.end());
+            }
+            return true;
+        }
+
+        const auto numNodes = nodes->Size();
+
+        const auto getChildren = [](const Json::Value& node) -> const Json::Value::Array& {
+            static const Json::Value::Array empty;
+            const auto* children = node.Find("children");
+            return children && children->IsArray() ? children->AsArray() : empty;
+        };
+
+        std::vector<uint64_t> roots;
+
+        if (const auto* scenes = document.Find("scenes"); scenes && scenes->IsArray() && scenes->Size() > 0) {
+            const auto scene = GetGltfUnsigned(document, "scene", 0);
+
+            if (!scene || *scene >= scenes->Size()) {
+                return false;
+            }
+
+            if (const auto* sceneNodes = scenes->At(*scene)->Find("nodes"); sceneNodes && sceneNodes->IsArray()) {
+                for (const auto& node : sceneNodes->AsArray()) {
+                    roots.push_back(AsGltfUnsigned(node).value_or(numNodes));
+                }
+            }
+        }
+        else {
+            std::vector<bool> isChild(numNodes, false);
+
+            for (const auto& node : nodes->AsArray()) {
+                for (const auto& child : getChildren(node)) {
+                    if (const auto index = AsGltfUnsigned(child); index && *index < numNodes) {
+                        isChild[*index] = true;
+                    }
+                }
+            }
+
+            for (uint64_t node = 0; node < numNodes; node++) {
+                if (!isChild[node]) {
+                    roots.push_back(node);
+                }
+            }
+        }
+
+        std::vector<bool> isVisited(numNodes, false);
+        std::vector<std::pair<uint64_t, Math::Matrix>> stack;
+
+        for (const auto root : roots | std::views::reverse) {
+            stack.emplace_back(root, Math::Matrix());
+        }
+
+        const Math::Matrix identity;
+
+        while (!stack.empty()) {
+            const auto [index, parentTransform] = stack.back();
+            stack.pop_back();
+
+            if (index >= numNodes || isVisited[index]) {
+                return false;
+            }
+
+            isVisited[index] = true;
+
+            const auto& node     = *nodes->At(index);
+            const auto transform = GetGltfNodeTransform(node) * parentTransform;
+
+            if (node.Find("mesh")) {
+                const auto mesh = GetGltfUnsigned(node, "mesh");
+
+                if (!mesh || *mesh >= meshPrimitives.size()) {
+                    return false;
+                }
+
+                //Compared bit for bit, the engine's matrix comparison has a tolerance
+                const bool isMoved = std::memcmp(transform.Data(), identity.Data(), sizeof(Math::Matrix)) != 0;
+
+                for (auto primitive : meshPrimitives[*mesh]) {
+                    primitive.Transform = isMoved ? std::optional(transform) : std::nullopt;
+                    instances.push_back(std::move(primitive));
+                }
+            }
+
+            const auto& children = getChildren(node);
+
+            for (const auto& child : children | std::views::reverse) {
+                stack.emplace_back(AsGltfUnsigned(child).value_or(numNodes), transform);
+            }
+        }
+        return true;
+    }
+}
+
+uint32_t GltfAccessor::GetElementSize() const noexcept {
+    return impl::GetGltfComponentSize(ComponentType) * NumComponents;
+}
+
+void GltfAccessor::ReadFloats(uint32_t index, std::span<float> output) const noexcept {
+    const auto* element = Data.data() + size_t{ index } * Stride;
+    const auto numComponents = std::min<size_t>(NumComponents, output.size());
+
+    const auto read = [&]<class T>(T, float scale) {
+        for (size_t component = 0; component < numComponents; component++) {
+            T value;
+            std::memcpy(&value, element + component * sizeof(T), sizeof(T));
+
+            //Signed normalized values have two encodings of -1, both map to it
+            output[component] = Normalized ? std::max(static_cast<float>(value) * scale, -1.0f) : static_cast<float>(value);
+        }
+    };
+
+    switch (ComponentType) {
+        case GltfComponentType::Byte:          read(int8_t{},   1.0f / 127.0f);   break;
+        case GltfComponentType::UnsignedByte:  read(uint8_t{},  1.0f / 255.0f);   break;
+        case GltfComponentType::Short:         read(int16_t{},  1.0f / 32767.0f); break;
+        case GltfComponentType::UnsignedShort: read(uint16_t{}, 1.0f / 65535.0f); break;
+        case GltfComponentType::UnsignedInt:   read(uint32_t{}, 1.0f);            break;
+        case GltfComponentType::Float:
+            std::memcpy(output.data(), element, numComponents * sizeof(float));
+            break;
+    }
+}
+
+uint32_t GltfAccessor::ReadIndex(uint32_t index) const noexcept {
+    const auto* element = Data.data() + size_t{ index } * Stride;
+
+    switch (ComponentType) {
+        case GltfComponentType::UnsignedByte:
+            return std::to_integer<uint32_t>(*element);
+        case GltfComponentType::UnsignedShort: {
+            uint16_t value;
+            std::memcpy(&value, element, sizeof(value));
+            return value;
+        }
+        default: {
+            uint32_t value;
+            std::memcpy(&value, element, sizeof(value));
+            return value;
+        }
+    }
+}
+
+std::optional<GlbFile> GlbFile::Open(std::string_view path) {
+    auto file = MappedFile::Open(path);
+
+    if (!file || file->GetSize() < impl::GLB_HEADER_SIZE + impl::GLB_CHUNK_HEADER_SIZE) [[unlikely]] {
+        return {};
+    }
+
+    GlbFile glbFile(std::move(*file));
+
+    if (!glbFile.Parse()) [[unlikely]] {
+        return {};
+    }
+    return glbFile;
+}
+
+GlbFile::GlbFile(MappedFile&& file) noexcept
+    :
+    m_file(std::move(file))
+{}
+
+bool GlbFile::Parse() {
+    const auto data = m_file.GetData();
+
+    const bool isGlb =
+        impl::ReadGlbWord(data, 0) == GltfFormat::MAGIC &&
+        impl::ReadGlbWord(data, 4) == GltfFormat::VERSION &&
+        impl::ReadGlbWord(data, 8) <= data.size() &&
+        impl::ReadGlbWord(data, 8) >= impl::GLB_HEADER_SIZE + impl::GLB_CHUNK_HEADER_SIZE;
+
+    if (!isGlb) {
+        return false;
+    }
+
+    //The JSON chunk comes first, the binary chunk is optional and follows it. Chunks are padded to 4 bytes, so the
+    //binary chunk is aligned for every component type.
+    const auto fileSize   = size_t{ impl::ReadGlbWord(data, 8) };
+    const auto jsonLength = size_t{ impl::ReadGlbWord(data, impl::GLB_HEADER_SIZE) };
+    const auto jsonOffset = impl::GLB_HEADER_SIZE + impl::GLB_CHUNK_HEADER_SIZE;
+
+    if (impl::ReadGlbWord(data, impl::GLB_HEADER_SIZE + 4) != GltfFormat::CHUNK_JSON || jsonLength > fileSize - jsonOffset) {
+        return false;
+    }
+
+    std::span<const std::byte> binaryChunk;
+    const auto binaryOffset = jsonOffset + ((jsonLength + 3) & ~size_t{ 3 });
+
+    if (binaryOffset + impl::GLB_CHUNK_HEADER_SIZE <= fileSize && impl::ReadGlbWord(data, binaryOffset + 4) == GltfFormat::CHUNK_BIN) {
+        const auto binaryLength = size_t{ impl::ReadGlbWord(data, binaryOffset) };
+
+        if (binaryLength > fileSize - binaryOffset - impl::GLB_CHUNK_HEADER_SIZE) {
+            return false;
+        }
+        binaryChunk = data.subspan(binaryOffset + impl::GLB_CHUNK_HEADER_SIZE, binaryLength);
+    }
+
+    const auto document = Json::Parse({ reinterpret_cast<const char*>(data.data() + jsonOffset), jsonLength });
+
+    if (!document || !document->IsObject()) {
+        return false;
+    }
+
+    const auto getArray = [&](std::string_view key) -> const Json::Value::Array& {
+        static const Json::Value::Array empty;
+        const auto* value = document->Find(key);
+        return value && value->IsArray() ? value->AsArray() : empty;
+    };
+
+    //Only the binary chunk is supported as a buffer, views into anything else are left empty and fail when used
+    std::vector<std::optional<impl::GltfBufferView>> bufferViews;
+    const auto& buffers = getArray("buffers");
+
+    for (const auto& view : getArray("bufferViews")) {
+        const auto buffer     = impl::GetGltfUnsigned(view, "buffer");
+        const auto byteOffset = impl::GetGltfUnsigned(view, "byteOffset", 0);
+        const auto byteLength = impl::GetGltfUnsigned(view, "byteLength");
+        const auto byteStride = impl::GetGltfUnsigned(view, "byteStride", 0);
+
+        const bool isInBinaryChunk =
+            buffer == 0 && !buffers.empty() && !buffers[0].Find("uri") &&
+            byteOffset && byteLength && byteStride && *byteStride <= UINT32_MAX &&
+            *byteOffset <= binaryChunk.size() && *byteLength <= binaryChunk.size() - *byteOffset;
+
+        if (isInBinaryChunk) {
+            bufferViews.push_back(impl::GltfBufferView{ binaryChunk.subspan(*byteOffset, *byteLength), static_cast<uint32_t>(*byteStride) });
+        }
+        else {
+            bufferViews.emplace_back();
+        }
+    }
+
+    const auto& accessors = getArray("accessors");
+
+    const auto getAccessor = [&](std::optional<uint64_t> index) -> std::optional<GltfAccessor> {
+        if (!index || *index >= accessors.size() || accessors[*index].Find("sparse")) {
+            return {};
+        }
+
+        const auto& accessor     = accessors[*index];
+        const auto view          = impl::GetGltfUnsigned(accessor, "bufferView");
+        const auto byteOffset    = impl::GetGltfUnsigned(accessor, "byteOffset", 0);
+        const auto count         = impl::GetGltfUnsigned(accessor, "count");
+        const auto componentType = impl::GetGltfUnsigned(accessor, "componentType");
+        const auto* type         = accessor.Find("type");
+
+        if (!view || *view >= bufferViews.size() || !bufferViews[*view] || !byteOffset || !count || *count > UINT32_MAX ||
+            !componentType || !impl::IsGltfComponentType(*componentType) || !type)
+        {
+            return {};
+        }
+
+        GltfAccessor result{
+            .Count         = static_cast<uint32_t>(*count),
+            .ComponentType = static_cast<GltfComponentType>(*componentType),
+            .NumComponents = impl::GetGltfNumComponents(type->AsString()),
+            .Normalized    = accessor.Find("normalized") && accessor.Find("normalized")->AsBool()
+        };
+
+        const auto& [viewData, viewStride] = *bufferViews[*view];
+        const auto elementSize = result.GetElementSize();
+
+        result.Stride = viewStride != 0 ? viewStride : elementSize;
+
+        //Elements have to lie within the view and be aligned to their components
+        const auto size = result.Count == 0 ? 0 : uint64_t{ result.Stride } * (result.Count - 1) + elementSize;
+        const auto componentSize = impl::GetGltfComponentSize(result.ComponentType);
+
+        if (result.NumComponents == 0 || *byteOffset > viewData.size() || size > viewData.size() - *byteOffset ||
+            reinterpret_cast<uintptr_t>(viewData.data() + *byteOffset) % componentSize != 0 || result.Stride % componentSize != 0)
+        {
+            return {};
+        }
+
+        result.Data = viewData.subspan(*byteOffset, size);
+        return result;
+    };
+
+    const auto isFloat = [](const std::optional<GltfAccessor>& accessor, uint32_t numComponents) {
+        return accessor->ComponentType == GltfComponentType::Float && accessor->NumComponents == numComponents;
+    };
+
+    const auto& materials = getArray("materials");
+
+    //Primitives of every mesh, the nodes instance them below
+    std::vector<std::vector<GltfPrimitive>> meshPrimitives;
+
+    for (const auto& mesh : getArray("meshes")) {
+        const auto* primitives = mesh.Find("primitives");
+        auto& primitivesOfMesh = meshPrimitives.emplace_back();
+
+        if (!primitives || !primitives->IsArray()) {
+            return false;
+        }
+
+        for (const auto& primitive : primitives->AsArray()) {
+            const auto mode = impl::GetGltfUnsigned(primitive, "mode", impl::MODE_TRIANGLES);
+
+            //Points and lines are removed by the assimp import as well, strips and fans are left to it
+            if (mode && *mode < impl::MODE_TRIANGLES) {
+                continue;
+            }
+
+            const auto* attributes = primitive.Find("attributes");
+
+            if (mode != impl::MODE_TRIANGLES || !attributes) {
+                return false;
+            }
+
+            //An attribute that is present but cannot be read fails the whole file
+            bool areAttributesValid = true;
+
+            const auto getAttribute = [&](std::string_view name) -> std::optional<GltfAccessor> {
+                if (!attributes->Find(name)) {
+                    return {};
+                }
+
+                auto accessor = getAccessor(impl::GetGltfUnsigned(*attributes, name));
+                areAttributesValid &= accessor.has_value();
+                return accessor;
+            };
+
+            const auto positions = getAttribute("POSITION");
+
+            GltfPrimitive result{
+                .Normals   = getAttribute("NORMAL"),
+                .Tangents  = getAttribute("TANGENT"),
+                .TexCoords = getAttribute("TEXCOORD_0")
+            };
+
+            if (!positions || !areAttributesValid) {
+                return false;
+            }
+
+            result.Positions = *positions;
+
+            const auto numVertices = result.Positions.Count;
+
+            const bool isSupported =
+                isFloat(positions, 3) &&
+                (!result.Normals   || (isFloat(result.Normals, 3) && result.Normals->Count == numVertices)) &&
+                (!result.Tangents  || (isFloat(result.Tangents, 4) && result.Tangents->Count == numVertices)) &&
+                (!result.TexCoords || (result.TexCoords->NumComponents == 2 && result.TexCoords->Count == numVertices));
+
+            if (!isSupported) {
+                return false;
+            }
+
+            if (primitive.Find("indices")) {
+                result.Indices = getAccessor(impl::GetGltfUnsigned(primitive, "indices"));
+
+                const bool isIndexType =
+                    result.Indices && result.Indices->NumComponents == 1 &&
+                    (result.Indices->ComponentType == GltfComponentType::UnsignedByte ||
+                     result.Indices->ComponentType == GltfComponentType::UnsignedShort ||
+                     result.Indices->ComponentType == GltfComponentType::UnsignedInt);
+
+                if (!isIndexType) {
+                    return false;
+                }
+
+                //Checked once here so reading the primitive never has to
+                for (uint32_t i = 0; i < result.Indices->Count; i++) {
+                    if (result.Indices->ReadIndex(i) >= numVertices) {
+                        return false;
+                    }
+                }
+            }
+
+            if (primitive.Find("material")) {
+                const auto material = impl::GetGltfUnsigned(primitive, "material");
+
+                if (!material || *material >= materials.size()) {
+                    return false;
+                }
+                result.Material = static_cast<uint32_t>(*material);
+            }
+
+            primitivesOfMesh.push_back(std::move(result));
+        }
+    }
+
+    if (!impl::AddGltfMeshInstances(*document, meshPrimitives, m_primitives)) {
+        return false;
+    }
+
+    for (const auto& image : getArray("images")) {
+        const auto uri = image.Find("uri") ? image.Find("uri")->AsString() : std::string_view{};
+
+        if (uri.empty() || uri.starts_with("data:")) {
+            m_images.push_back({ .IsEmbedded = true });
+        }
+        else {
+            m_images.push_back({ .Uri = impl::DecodeGltfUri(uri) });
+        }
+    }
+
+    //Materials reference textures, which name the image they sample
+    const auto& textures = getArray("textures");
+
+    const auto getImage = [&](const Json::Value* textureInfo) {
+        const auto texture = textureInfo ? impl::GetGltfUnsigned(*textureInfo, "index") : std::nullopt;
+
+        if (!texture || *texture >= textures.size()) {
+            return GltfFormat::NO_INDEX;
+        }
+
+        const auto image = impl::GetGltfUnsigned(textures[*texture], "source");
+        return image && *image < m_images.size() ? static_cast<uint32_t>(*image) : GltfFormat::NO_INDEX;
+    };
+
+    for (const auto& material : materials) {
+        GltfMaterial result;
+        result.Name = material.Find("name") ? material.Find("name")->AsString() : std::string_view{};
+
+        if (const auto* pbr = material.Find("pbrMetallicRoughness")) {
+            impl::ReadGltfFloats(*pbr, "baseColorFactor", result.BaseColorFactor);
+
+            result.MetallicFactor           = static_cast<float>(pbr->Find("metallicFactor") ? pbr->Find("metallicFactor")->AsNumber(1.0) : 1.0);
+            result.RoughnessFactor          = static_cast<float>(pbr->Find("roughnessFactor") ? pbr->Find("roughnessFactor")->AsNumber(1.0) : 1.0);
+            result.BaseColorTexture         = getImage(pbr->Find("baseColorTexture"));
+            result.MetallicRoughnessTexture = getImage(pbr->Find("metallicRoughnessTexture"));
+        }
+
+        if (const auto* normalTexture = material.Find("normalTexture")) {
+            result.NormalTexture = getImage(normalTexture);
+            result.NormalScale   = static_cast<float>(normalTexture->Find("scale") ? normalTexture->Find("scale")->AsNumber(1.0) : 1.0);
+        }
+
+        impl::ReadGltfFloats(material, "emissiveFactor", result.EmissiveFactor);
+
+        result.OcclusionTexture = getImage(material.Find("occlusionTexture"));
+        result.EmissiveTexture  = getImage(material.Find("emissiveTexture"));
+
+        m_materials.push_back(std::move(result));
+    }
+    return true;
+}
+
+void Crystal::ReadGltfPrimitive(const GltfPrimitive& primitive, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices) {
+    const auto numVertices = primitive.Positions.Count;
+
+    //Triangles are needed first, missing normals and tangents are computed from them
+    if (primitive.Indices) {
+        indices.resize(primitive.Indices->Count - primitive.Indices->Count % 3);
+
+        if (const auto packed = primitive.Indices->AsSpan<uint32_t>(); primitive.Indices->ComponentType == GltfComponentType::UnsignedInt && !packed.empty()) {
+            std::copy_n(packed.begin(), indices.size(), indices.begin());
+        }
+        else {
+            for (uint32_t i = 0; i < indices.size(); i++) {
+                indices[i] = primitive.Indices->ReadIndex(i);
+            }
+        }
+    }
+    else {
+        indices.resize(numVertices - numVertices % 3);
+        std::iota(indices.begin(), indices.end(), 0u);
+    }
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        std::swap(indices[i + 1], indices[i + 2]);
+    }
+
+    vertices.assign(numVertices, Vertex{});
+
+    impl::ForEachGltfElement<3>(primitive.Positions, [&](uint32_t i, const std::array<float, 3>& position) {
+        vertices[i].Position = { position[0], position[1], -position[2] };
+    });
+
+    if (primitive.TexCoords) {
+        impl::ForEachGltfElement<2>(*primitive.TexCoords, [&](uint32_t i, const std::array<float, 2>& texCoord) {
+            vertices[i].TexCoord = { texCoord[0], texCoord[1], 0.0f };
+        });
+    }
+
+    if (primitive.Normals) {
+        impl::ForEachGltfElement<3>(*primitive.Normals, [&](uint32_t i, const std::array<float, 3>& normal) {
+            vertices[i].Normal = { normal[0], normal[1], -normal[2] };
+        });
+    }
+    else {
+        impl::ComputeGltfNormals(vertices, indices);
+    }
+
+    //The bitangent is cross(normal, tangent) * w in glTF, mirroring z negates the cross product of mirrored vectors
+    if (primitive.Tangents) {
+        impl::ForEachGltfElement<4>(*primitive.Tangents, [&](uint32_t i, const std::array<float, 4>& tangent) {
+            vertices[i].Tangent   = { tangent[0], tangent[1], -tangent[2] };
+            vertices[i].Bitangent = vertices[i].Normal.Cross(vertices[i].Tangent) * -tangent[3];
+        });
+    }
+    else if (primitive.TexCoords) {
+        impl::ComputeGltfTangents(vertices, indices);
+    }
+
+    //A mirroring transform turns the triangles inside out, their winding is flipped back
+    if (primitive.Transform) {
+        impl::TransformGltfVertices(vertices, *primitive.Transform);
+
+        if (impl::GetGltfDeterminant(*primitive.Transform) < 0.0f) {
+            for (size_t i = 0; i < indices.size(); i += 3) {
+                std::swap(indices[i + 1], indices[i + 2]);
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+#include "VertexLayouts.h"
+#include "Core/FileSystem/MappedFile.h"
+#include "Core/Math/Matrix.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Crystal {
+    namespace GltfFormat {
+        constexpr uint32_t MAGIC      = 0x46546C67; //"glTF"
+        constexpr uint32_t VERSION    = 2;
+        constexpr uint32_t CHUNK_JSON = 0x4E4F534A; //"JSON"
+        constexpr uint32_t CHUNK_BIN  = 0x004E4942; //"BIN\0"
+
+        constexpr uint32_t NO_INDEX = ~0u;
+    }
+
+    enum class GltfComponentType : uint32_t {
+        Byte          = 5120,
+        UnsignedByte  = 5121,
+        Short         = 5122,
+        UnsignedShort = 5123,
+        UnsignedInt   = 5125,
+        Float         = 5126
+    };
+
+    //Elements of an accessor inside the binary chunk. Data starts at the first element and ends after the last one,
+    //elements are Stride bytes apart.
+    struct GltfAccessor {
+        std::span<const std::byte> Data;
+        uint32_t Count{ 0 };
+        uint32_t Stride{ 0 };
+        GltfComponentType ComponentType{ GltfComponentType::Float };
+        uint32_t NumComponents{ 0 };
+        bool Normalized{ false };
+
+        [[nodiscard]] uint32_t GetElementSize() const noexcept;
+
+        //The elements straight from the buffer view, empty unless they are tightly packed, aligned for T and T is
+        //the size of an element. The component type has to be checked by the caller.
+        template <class T>
+        [[nodiscard]] std::span<const T> AsSpan() const noexcept {
+            const bool isPacked =
+                Stride == sizeof(T) &&
+                GetElementSize() == sizeof(T) &&
+                reinterpret_cast<uintptr_t>(Data.data()) % alignof(T) == 0;
+
+            return isPacked ? std::span(reinterpret_cast<const T*>(Data.data()), Count) : std::span<const T>{};
+        }
+
+        //Up to four components of one element converted to float, normalized integers are mapped to [0, 1] or [-1, 1].
+        //Missing components are left as they are.
+        void ReadFloats(uint32_t index, std::span<float> output) const noexcept;
+
+        [[nodiscard]] uint32_t ReadIndex(uint32_t index) const noexcept;
+    };
+
+    //Triangle list primitive, one submesh of the import. Accessors other than the position are optional.
+    struct GltfPrimitive {
+        GltfAccessor Positions;
+        std::optional<GltfAccessor> Normals;
+        std::optional<GltfAccessor> Tangents;
+        std::optional<GltfAccessor> TexCoords;
+        std::optional<GltfAccessor> Indices;
+        uint32_t Material{ GltfFormat::NO_INDEX };
+
+        //World transform of the node using the mesh in glTF's space, empty when the mesh stays where it is
+        std::optional<Math::Matrix> Transform;
+    };
+
+    //Images embedded in a buffer view or given as a data URI have no path, only files next to the scene can be loaded
+    struct GltfImage {
+        std::string Uri;
+        bool IsEmbedded{ false };
+    };
+
+    //Metallic roughness material, textures index the images of the file
+    struct GltfMaterial {
+        std::string Name;
+
+        std::array<float, 4> BaseColorFactor{ 1.0f, 1.0f, 1.0f, 1.0f };
+        std::array<float, 3> EmissiveFactor { 0.0f, 0.0f, 0.0f };
+        float MetallicFactor { 1.0f };
+        float RoughnessFactor{ 1.0f };
+        float NormalScale    { 1.0f };
+
+        uint32_t BaseColorTexture        { GltfFormat::NO_INDEX };
+        uint32_t MetallicRoughnessTexture{ GltfFormat::NO_INDEX };
+        uint32_t NormalTexture           { GltfFormat::NO_INDEX };
+        uint32_t OcclusionTexture        { GltfFormat::NO_INDEX };
+        uint32_t EmissiveTexture         { GltfFormat::NO_INDEX };
+    };
+
+    //A binary glTF 2.0 file mapped into memory. Opening parses the JSON chunk and checks every accessor and index the
+    //primitives use against the binary chunk, vertex and index data are read from the mapping afterwards. Meshes are
+    //instanced by the nodes of the default scene, files without nodes use every mesh once. Point and line primitives
+    //are skipped. Files that need anything else, external buffers, sparse accessors, strips or fans, fail to open and
+    //are left to the assimp import.
+    class GlbFile {
+    public:
+        [[nodiscard]] static std::optional<GlbFile> Open(std::string_view path);
+
+        //Primitives of every mesh instance, in the order the node hierarchy is walked
+        [[nodiscard]] std::span<const GltfPrimitive> GetPrimitives() const noexcept { return m_primitives; }
+        [[nodiscard]] std::span<const GltfMaterial> GetMaterials() const noexcept { return m_materials; }
+        [[nodiscard]] std::span<const GltfImage> GetImages() const noexcept { return m_images; }
+    private:
+        explicit GlbFile(MappedFile&& file) noexcept;
+
+        [[nodiscard]] bool Parse();
+
+        MappedFile m_file;
+        std::vector<GltfPrimitive> m_primitives;
+        std::vector<GltfMaterial> m_materials;
+        std::vector<GltfImage> m_images;
+    };
+
+    //Vertices and triangles of a primitive in the left handed convention of the engine: z is mirrored and the winding
+    //flipped, the way the assimp import converts them. Missing normals are smoothed over the triangles and missing
+    //tangents derived from the texture coordinates. Primitives without indices are numbered in order. The node transform
+    //is applied last, a mirroring one keeps the triangles facing outwards.
+    void ReadGltfPrimitive(const GltfPrimitive& primitive, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices);
+}
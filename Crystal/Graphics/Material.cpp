@@ -7,7 +7,7 @@ using namespace Crystal::Math;
 
 Material::Material(const MaterialProperties& materialProperties) 
     :
-    m_materialProperties(std::make_unique<MaterialProperties>(materialProperties))
+    m_materialProperties(MakePooled<MaterialProperties>(materialProperties))
 {}
 
 Texture* Material::GetTexture(TextureID id) const noexcept {
@@ -4,7 +4,9 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include "../Core/Lib/StringId.h"
 #include "../Core/Math/Vector4.h"
+#include "../Core/Memory/SlabAllocator.h"
 
 namespace Crystal {
 	struct MaterialProperties {
@@ -78,17 +80,22 @@ namespace Crystal {
 		void SetMaterialProperties(const MaterialProperties& materialProperties) noexcept;
 
 		[[nodiscard]] bool IsTransparent() const noexcept;
+
+		//Name of the source material, set by the scene loader for debugging. Interned names can be printed with GetString.
+		[[nodiscard]] StringId GetName() const noexcept { return m_name; }
+		void SetName(StringId name) noexcept { m_name = name; }
 	private:
-		std::unique_ptr<MaterialProperties> m_materialProperties;
+		StringId m_name;
+		PoolPtr<MaterialProperties> m_materialProperties;
 		std::unordered_map<TextureID, std::unique_ptr<Texture>> m_textures;
 	};
 
 	namespace detail {
-		constexpr std::string TextuserIDToString(Material::TextureID id) noexcept {
-			constexpr std::array TextureIDStrings = {
+		constexpr std::string_view TextuserIDToString(Material::TextureID id) noexcept {
+			constexpr std::array<std::string_view, 8> TextureIDStrings = {
 				"ambient",
 				"emissive",
-				"ambient",
+				"diffuse",
 				"specular",
 				"specularPower",
 				"normal",
@@ -2,6 +2,8 @@
 #include "../RHI/Buffer.h"
 #include "../RHI/CommandContext.h"
 
+#include <algorithm>
+
 using namespace Crystal;
 
 void Mesh::SetPrimitiveTopology(PrimitiveTopology topology) noexcept {
@@ -16,7 +18,16 @@ void Mesh::SetIndexBuffer(std::unique_ptr<Buffer>&& indexBuffer) noexcept {
 	m_indexBuffer = std::move(indexBuffer);
 }
 
-void Mesh::Render(GraphicsContext& ctx, uint32_t instanceCount, uint32_t firstInstance) {
+void Mesh::SetVertexLayout(VertexLayout layout, const PositionDequantization& dequantization) noexcept {
+	m_vertexLayout   = layout;
+	m_dequantization = dequantization;
+}
+
+void Mesh::SetLods(std::vector<MeshLod>&& lods) noexcept {
+	m_lods = std::move(lods);
+}
+
+void Mesh::Render(GraphicsContext& ctx, uint32_t instanceCount, uint32_t firstInstance, uint32_t lod) {
 	if (m_indexBuffer) [[likely]] {
 		ctx.SetPrimitiveTopology(m_topology);
 
@@ -27,7 +38,14 @@ void Mesh::Render(GraphicsContext& ctx, uint32_t instanceCount, uint32_t firstIn
 		const auto indexCount  = m_indexBuffer->Count();
 		const auto vertexCount = m_vertexBuffers.at(0)->Count();
 
-		if (indexCount > 0) {
+		if (!m_lods.empty()) {
+			//Levels past the coarsest one draw the coarsest, the whole buffer would be the most detailed level
+			const auto& level = m_lods[std::min<size_t>(lod, m_lods.size() - 1)];
+
+			ctx.SetIndexBuffer(m_indexBuffer.get());
+			ctx.DrawIndexed(level.NumIndices, instanceCount, level.FirstIndex, 0u, firstInstance);
+		}
+		else if (indexCount > 0) {
 			ctx.SetIndexBuffer(m_indexBuffer.get());
 			ctx.DrawIndexed(indexCount, instanceCount, 0u, 0u, firstInstance);
 		}
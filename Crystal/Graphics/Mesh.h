@@ -2,7 +2,11 @@
 #include <map>
 #include <memory>
 #include <cstdint>
+#include <span>
+#include <vector>
 #include "Types/Types.h"
+#include "MeshSimplifier.h"
+#include "VertexLayouts.h"
 
 namespace Crystal {
 	class Buffer;
@@ -13,11 +17,24 @@ namespace Crystal {
 		void SetVertexBuffer(uint32_t slotID, std::unique_ptr<Buffer>&& vertexBuffer) noexcept;
 		void SetIndexBuffer(std::unique_ptr<Buffer>&& indexBuffer) noexcept;
 
-		void Render(GraphicsContext& ctx, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+		//Pipelines pick the input layout from it, quantized positions are scaled back into object space by the vertex shader
+		void SetVertexLayout(VertexLayout layout, const PositionDequantization& dequantization = {}) noexcept;
+		[[nodiscard]] VertexLayout GetVertexLayout() const noexcept { return m_vertexLayout; }
+		[[nodiscard]] const PositionDequantization& GetPositionDequantization() const noexcept { return m_dequantization; }
+
+		//Index ranges of the levels of detail starting with the full mesh, Render clamps the level to the coarsest one.
+		//Without any the whole index buffer is drawn
+		void SetLods(std::vector<MeshLod>&& lods) noexcept;
+		[[nodiscard]] std::span<const MeshLod> GetLods() const noexcept { return m_lods; }
+
+		void Render(GraphicsContext& ctx, uint32_t instanceCount = 1, uint32_t firstInstance = 0, uint32_t lod = 0);
 	private:
 		std::map<uint32_t, std::unique_ptr<Buffer>> m_vertexBuffers;
 		std::unique_ptr<Buffer> m_indexBuffer{nullptr};
 
 		PrimitiveTopology m_topology{ Topology_t::trianglelist };
+		VertexLayout m_vertexLayout{ VertexLayout::Full };
+		PositionDequantization m_dequantization;
+		std::vector<MeshLod> m_lods;
 	};
 }
@@ -0,0 +1,24 @@
+#include "MeshAdjacency.h"
+
+#include <numeric>
+
+using namespace Crystal;
+
+VertexAdjacency Crystal::BuildVertexAdjacency(std::span<const uint32_t> indices, uint32_t numVertices) {
+    VertexAdjacency adjacency;
+    adjacency.Offsets.assign(size_t{ numVertices } + 1, 0);
+    adjacency.Triangles.resize(indices.size());
+
+    for (const auto index : indices) {
+        adjacency.Offsets[index + 1]++;
+    }
+
+    std::partial_sum(adjacency.Offsets.begin(), adjacency.Offsets.end(), adjacency.Offsets.begin());
+
+    std::vector<uint32_t> cursors(adjacency.Offsets.begin(), adjacency.Offsets.end() - 1);
+
+    for (size_t i = 0; i < indices.size(); i++) {
+        adjacency.Triangles[cursors[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    return adjacency;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    //Triangles around every vertex in CSR layout, a triangle that references a vertex twice is listed twice
+    struct VertexAdjacency {
+        std::vector<uint32_t> Offsets;
+        std::vector<uint32_t> Triangles;
+
+        [[nodiscard]] std::span<const uint32_t> GetTriangles(uint32_t vertex) const noexcept {
+            return std::span(Triangles).subspan(Offsets[vertex], Offsets[vertex + 1] - Offsets[vertex]);
+        }
+
+        [[nodiscard]] uint32_t GetValence(uint32_t vertex) const noexcept { return Offsets[vertex + 1] - Offsets[vertex]; }
+    };
+
+    [[nodiscard]] VertexAdjacency BuildVertexAdjacency(std::span<const uint32_t> indices, uint32_t numVertices);
+
+    //The mesh processing passes take positions from the first three floats of every vertex
+    [[nodiscard]] inline std::array<float, 3> LoadVertexPosition(std::span<const std::byte> vertices, uint32_t vertexStride, uint32_t vertex) noexcept {
+        std::array<float, 3> position;
+        std::memcpy(position.data(), vertices.data() + size_t{ vertex } * vertexStride, sizeof(position));
+        return position;
+    }
+}
@@ -0,0 +1,784 @@
+#include "MeshOptimizer.h"
+#include "MeshAdjacency.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint32_t NO_VERTEX   = ~0u;
+    constexpr uint32_t NO_TRIANGLE = ~0u;
+
+    //Vertex fetch cache the statistics simulate, direct mapped
+    constexpr uint32_t FETCH_CACHE_LINE_SIZE = 64;
+    constexpr uint32_t FETCH_CACHE_LINES     = 256;
+
+    //Forsyth's scoring constants, scores are looked up in tables built from them
+    constexpr uint32_t FORSYTH_CACHE_SIZE    = 32;
+    constexpr uint32_t FORSYTH_MAX_VALENCE   = 32;
+    constexpr float FORSYTH_CACHE_DECAY      = 1.5f;
+    constexpr float FORSYTH_LAST_TRIANGLE    = 0.75f;
+    constexpr float FORSYTH_VALENCE_SCALE    = 2.0f;
+    constexpr float FORSYTH_VALENCE_POWER    = 0.5f;
+
+    //FIFO cache of transformed vertices. Each miss advances the time, a vertex is still cached while fewer than
+    //cacheSize misses happened since it was inserted.
+    class PostTransformCache {
+    public:
+        PostTransformCache(uint32_t numVertices, uint32_t cacheSize)
+            :
+            m_insertTimes(numVertices, 0),
+            m_cacheSize(cacheSize),
+            m_time(cacheSize + 1)
+        {}
+
+        //Returns true on a miss
+        bool Access(uint32_t vertex) noexcept {
+            if (m_time - m_insertTimes[vertex] > m_cacheSize) {
+                m_insertTimes[vertex] = m_time++;
+                return true;
+            }
+            return false;
+        }
+
+        [[nodiscard]] uint32_t GetAge(uint32_t vertex) const noexcept { return m_time - m_insertTimes[vertex]; }
+
+        void Reset() noexcept { m_time += m_cacheSize + 1; }
+    private:
+        std::vector<uint32_t> m_insertTimes;
+        uint32_t m_cacheSize;
+        uint32_t m_time;
+    };
+
+    //Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw. Fans around one vertex at a
+    //time and moves on to the vertex that is still going to be cached once its remaining triangles are emitted.
+    class TipsifyOrdering {
+    public:
+        TipsifyOrdering(std::span<const uint32_t> indices, uint32_t numVertices, uint32_t cacheSize)
+            :
+            m_indices(indices),
+            m_adjacency(BuildVertexAdjacency(indices, numVertices)),
+            m_cache(numVertices, cacheSize),
+            m_liveTriangles(numVertices),
+            m_isEmitted(indices.size() / 3, false),
+            m_cacheSize(cacheSize)
+        {
+            for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+                m_liveTriangles[vertex] = m_adjacency.GetValence(vertex);
+            }
+        }
+
+        [[nodiscard]] std::vector<uint32_t> Run() {
+            std::vector<uint32_t> ordered;
+            ordered.reserve(m_indices.size());
+
+            auto fanningVertex = SkipToLiveVertex();
+
+            while (fanningVertex != NO_VERTEX) {
+                m_candidates.clear();
+
+                for (const auto triangle : m_adjacency.GetTriangles(fanningVertex)) {
+                    if (m_isEmitted[triangle]) {
+                        continue;
+                    }
+
+                    m_isEmitted[triangle] = true;
+
+                    for (uint32_t corner = 0; corner < 3; corner++) {
+                        const auto vertex = m_indices[size_t{ triangle } * 3 + corner];
+
+                        ordered.push_back(vertex);
+                        m_deadEnds.push_back(vertex);
+                        m_candidates.push_back(vertex);
+                        m_liveTriangles[vertex]--;
+                        m_cache.Access(vertex);
+                    }
+                }
+
+                fanningVertex = GetNextFanningVertex();
+            }
+            return ordered;
+        }
+    private:
+        //Prefers the vertex that entered the cache earliest among those that stay cached while their fan is emitted
+        [[nodiscard]] uint32_t GetNextFanningVertex() noexcept {
+            auto nextVertex  = NO_VERTEX;
+            int64_t priority = -1;
+
+            for (const auto vertex : m_candidates) {
+                if (m_liveTriangles[vertex] == 0) {
+                    continue;
+                }
+
+                const auto age             = m_cache.GetAge(vertex);
+                const int64_t newPriority  = age + 2 * m_liveTriangles[vertex] <= m_cacheSize ? age : 0;
+
+                if (newPriority > priority) {
+                    priority   = newPriority;
+                    nextVertex = vertex;
+                }
+            }
+
+            if (nextVertex != NO_VERTEX) {
+                return nextVertex;
+            }
+
+            //Dead end, recently used vertices are the most likely to still be cached
+            while (!m_deadEnds.empty()) {
+                const auto vertex = m_deadEnds.back();
+                m_deadEnds.pop_back();
+
+                if (m_liveTriangles[vertex] > 0) {
+                    return vertex;
+                }
+            }
+            return SkipToLiveVertex();
+        }
+
+        [[nodiscard]] uint32_t SkipToLiveVertex() noexcept {
+            while (m_cursor < m_liveTriangles.size() && m_liveTriangles[m_cursor] == 0) {
+                m_cursor++;
+            }
+            return m_cursor < m_liveTriangles.size() ? m_cursor : NO_VERTEX;
+        }
+
+        std::span<const uint32_t> m_indices;
+        VertexAdjacency m_adjacency;
+        PostTransformCache m_cache;
+
+        std::vector<uint32_t> m_liveTriangles;
+        std::vector<bool> m_isEmitted;
+        std::vector<uint32_t> m_deadEnds;
+        std::vector<uint32_t> m_candidates;
+
+        uint32_t m_cacheSize;
+        uint32_t m_cursor{ 0 };
+    };
+
+    //Forsyth, Linear-Speed Vertex Cache Optimisation. Vertices are scored by their position in a simulated LRU cache
+    //and by how few triangles they have left, the triangle with the highest sum of its vertex scores is emitted next.
+    class ForsythOrdering {
+    public:
+        ForsythOrdering(std::span<const uint32_t> indices, uint32_t numVertices)
+            :
+            m_indices(indices),
+            m_adjacency(BuildVertexAdjacency(indices, numVertices)),
+            m_liveTriangles(numVertices),
+            m_cachePositions(numVertices, -1),
+            m_vertexScores(numVertices),
+            m_triangleScores(indices.size() / 3, 0.0f),
+            m_isEmitted(indices.size() / 3, false)
+        {
+            for (uint32_t position = 0; position < FORSYTH_CACHE_SIZE; position++) {
+                m_cacheScores[position] = position < 3
+                    ? FORSYTH_LAST_TRIANGLE
+                    : std::pow(1.0f - static_cast<float>(position - 3) / (FORSYTH_CACHE_SIZE - 3), FORSYTH_CACHE_DECAY);
+            }
+
+            for (uint32_t valence = 1; valence <= FORSYTH_MAX_VALENCE; valence++) {
+                m_valenceScores[valence] = FORSYTH_VALENCE_SCALE * std::pow(static_cast<float>(valence), -FORSYTH_VALENCE_POWER);
+            }
+
+            for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+                m_liveTriangles[vertex] = m_adjacency.GetValence(vertex);
+                m_vertexScores[vertex]  = GetVertexScore(vertex);
+            }
+
+            for (size_t i = 0; i < indices.size(); i++) {
+                m_triangleScores[i / 3] += m_vertexScores[indices[i]];
+            }
+        }
+
+        [[nodiscard]] std::vector<uint32_t> Run() {
+            const auto numTriangles = static_cast<uint32_t>(m_triangleScores.size());
+
+            std::vector<uint32_t> ordered;
+            ordered.reserve(m_indices.size());
+
+            auto triangle = NO_TRIANGLE;
+
+            for (uint32_t emitted = 0; emitted < numTriangles; emitted++) {
+                //Nothing in the cache has triangles left, continue with the first triangle not emitted yet
+                if (triangle == NO_TRIANGLE) {
+                    while (m_isEmitted[m_cursor]) {
+                        m_cursor++;
+                    }
+                    triangle = m_cursor;
+                }
+
+                m_isEmitted[triangle] = true;
+
+                const auto corners = m_indices.subspan(size_t{ triangle } * 3, 3);
+                ordered.insert(ordered.end(), corners.begin(), corners.end());
+
+                for (const auto vertex : corners) {
+                    m_liveTriangles[vertex]--;
+                }
+
+                UpdateCache(corners);
+                triangle = UpdateScores();
+            }
+            return ordered;
+        }
+    private:
+        [[nodiscard]] float GetVertexScore(uint32_t vertex) const noexcept {
+            const auto liveTriangles = m_liveTriangles[vertex];
+
+            if (liveTriangles == 0) {
+                return -1.0f;
+            }
+
+            const auto position = m_cachePositions[vertex];
+            const auto score    = position >= 0 ? m_cacheScores[position] : 0.0f;
+
+            return score + (liveTriangles <= FORSYTH_MAX_VALENCE
+                ? m_valenceScores[liveTriangles]
+                : FORSYTH_VALENCE_SCALE * std::pow(static_cast<float>(liveTriangles), -FORSYTH_VALENCE_POWER));
+        }
+
+        //Moves the corners to the front of the LRU, vertices pushed out of it are kept past its end to be rescored
+        void UpdateCache(std::span<const uint32_t> corners) noexcept {
+            std::array<uint32_t, FORSYTH_CACHE_SIZE + 3> entries;
+            uint32_t numEntries = 0;
+
+            for (const auto vertex : corners) {
+                if (std::find(entries.begin(), entries.begin() + numEntries, vertex) == entries.begin() + numEntries) {
+                    entries[numEntries++] = vertex;
+                }
+            }
+
+            for (uint32_t entry = 0; entry < m_numCacheEntries; entry++) {
+                const auto vertex = m_cacheEntries[entry];
+
+                if (std::find(entries.begin(), entries.begin() + numEntries, vertex) == entries.begin() + numEntries) {
+                    entries[numEntries++] = vertex;
+                }
+            }
+
+            m_numUpdated = numEntries;
+            m_updated    = entries;
+
+            m_numCacheEntries = std::min(numEntries, FORSYTH_CACHE_SIZE);
+            std::copy_n(entries.begin(), m_numCacheEntries, m_cacheEntries.begin());
+
+            for (uint32_t entry = 0; entry < numEntries; entry++) {
+                m_cachePositions[entries[entry]] = entry < FORSYTH_CACHE_SIZE ? static_cast<int32_t>(entry) : -1;
+            }
+        }
+
+        //Only vertices whose position or valence changed are rescored, the best triangle is searched among theirs
+        [[nodiscard]] uint32_t UpdateScores() noexcept {
+            for (uint32_t entry = 0; entry < m_numUpdated; entry++) {
+                const auto vertex = m_updated[entry];
+                const auto score  = GetVertexScore(vertex);
+                const auto delta  = score - m_vertexScores[vertex];
+
+                m_vertexScores[vertex] = score;
+
+                for (const auto triangle : m_adjacency.GetTriangles(vertex)) {
+                    m_triangleScores[triangle] += delta;
+                }
+            }
+
+            auto bestTriangle = NO_TRIANGLE;
+            float bestScore   = -1.0f;
+
+            for (uint32_t entry = 0; entry < m_numCacheEntries; entry++) {
+                for (const auto triangle : m_adjacency.GetTriangles(m_cacheEntries[entry])) {
+                    if (!m_isEmitted[triangle] && m_triangleScores[triangle] > bestScore) {
+                        bestScore    = m_triangleScores[triangle];
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+            return bestTriangle;
+        }
+
+        std::span<const uint32_t> m_indices;
+        VertexAdjacency m_adjacency;
+
+        std::vector<uint32_t> m_liveTriangles;
+        std::vector<int32_t> m_cachePositions;
+        std::vector<float> m_vertexScores;
+        std::vector<float> m_triangleScores;
+        std::vector<bool> m_isEmitted;
+
+        std::array<float, FORSYTH_CACHE_SIZE> m_cacheScores{};
+        std::array<float, FORSYTH_MAX_VALENCE + 1> m_valenceScores{};
+
+        std::array<uint32_t, FORSYTH_CACHE_SIZE> m_cacheEntries{};
+        uint32_t m_numCacheEntries{ 0 };
+
+        std::array<uint32_t, FORSYTH_CACHE_SIZE + 3> m_updated{};
+        uint32_t m_numUpdated{ 0 };
+
+        uint32_t m_cursor{ 0 };
+    };
+
+    //Triangle ranges [Begin, End) of the overdraw pass
+    struct TriangleCluster {
+        uint32_t Begin;
+        uint32_t End;
+        float SortKey;
+    };
+
+    //Hard boundaries are where the cache optimized order starts over, at triangles none of whose vertices are cached
+    [[nodiscard]] std::vector<uint32_t> FindHardBoundaries(std::span<const uint32_t> indices, uint32_t numVertices, uint32_t cacheSize) {
+        const auto numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+        PostTransformCache cache(numVertices, cacheSize);
+        std::vector<uint32_t> boundaries;
+
+        for (uint32_t triangle = 0; triangle < numTriangles; triangle++) {
+            uint32_t misses = 0;
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                misses += cache.Access(indices[size_t{ triangle } * 3 + corner]);
+            }
+
+            if (triangle == 0 || misses == 3) {
+                boundaries.push_back(triangle);
+            }
+        }
+
+        boundaries.push_back(numTriangles);
+        return boundaries;
+    }
+
+    //Soft boundaries split a hard cluster wherever the part before it, drawn with a cold cache, is already within
+    //threshold of the ACMR of the whole cluster. Every split costs at most that much.
+    void SplitCluster(
+        std::span<const uint32_t> indices,
+        PostTransformCache& cache,
+        uint32_t begin,
+        uint32_t end,
+        float threshold,
+        std::vector<TriangleCluster>& clusters)
+    {
+        const auto countMisses = [&](uint32_t triangle) {
+            uint32_t misses = 0;
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                misses += cache.Access(indices[size_t{ triangle } * 3 + corner]);
+            }
+            return misses;
+        };
+
+        cache.Reset();
+
+        uint32_t clusterMisses = 0;
+
+        for (uint32_t triangle = begin; triangle < end; triangle++) {
+            clusterMisses += countMisses(triangle);
+        }
+
+        const auto targetACMR = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - begin);
+
+        cache.Reset();
+
+        uint32_t clusterBegin = begin;
+        uint32_t misses       = 0;
+
+        for (uint32_t triangle = begin; triangle < end; triangle++) {
+            misses += countMisses(triangle);
+
+            const auto numTriangles = triangle + 1 - clusterBegin;
+
+            if (triangle + 1 < end && static_cast<float>(misses) <= targetACMR * static_cast<float>(numTriangles)) {
+                clusters.push_back({ clusterBegin, triangle + 1, 0.0f });
+
+                clusterBegin = triangle + 1;
+                misses       = 0;
+                cache.Reset();
+            }
+        }
+
+        clusters.push_back({ clusterBegin, end, 0.0f });
+    }
+
+    //Key of the overdraw sort, how far the cluster lies along its own normal from the center of the mesh
+    void ComputeSortKeys(
+        std::span<const uint32_t> indices,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        std::span<TriangleCluster> clusters)
+    {
+        std::vector<std::array<float, 3>> centroids(clusters.size());
+        std::vector<std::array<float, 3>> normals(clusters.size());
+        std::array<double, 3> meshCentroid{};
+        double meshArea = 0.0;
+
+        for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+            std::array<float, 3> centroid{};
+            std::array<float, 3> normal{};
+            float area = 0.0f;
+
+            for (uint32_t triangle = clusters[cluster].Begin; triangle < clusters[cluster].End; triangle++) {
+                const auto p0 = LoadVertexPosition(vertices, vertexStride, indices[size_t{ triangle } * 3 + 0]);
+                const auto p1 = LoadVertexPosition(vertices, vertexStride, indices[size_t{ triangle } * 3 + 1]);
+                const auto p2 = LoadVertexPosition(vertices, vertexStride, indices[size_t{ triangle } * 3 + 2]);
+
+                const std::array<float, 3> e0{ p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+                const std::array<float, 3> e1{ p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+
+                const std::array<float, 3> cross{
+                    e0[1] * e1[2] - e0[2] * e1[1],
+                    e0[2] * e1[0] - e0[0] * e1[2],
+                    e0[0] * e1[1] - e0[1] * e1[0]
+                };
+
+                const auto triangleArea = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+
+                for (size_t axis = 0; axis < 3; axis++) {
+                    centroid[axis] += (p0[axis] + p1[axis] + p2[axis]) * (triangleArea / 3.0f);
+                    normal[axis]   += cross[axis];
+                }
+
+                area += triangleArea;
+            }
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                meshCentroid[axis] += centroid[axis];
+                centroids[cluster][axis] = area > 0.0f ? centroid[axis] / area : 0.0f;
+            }
+
+            normals[cluster] = normal;
+            meshArea        += area;
+        }
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            meshCentroid[axis] = meshArea > 0.0 ? meshCentroid[axis] / meshArea : 0.0;
+        }
+
+        for (size_t cluster = 0; cluster < clusters.size(); cluster++) {
+            const auto& normal = normals[cluster];
+            const auto length  = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            float key = 0.0f;
+
+            for (size_t axis = 0; axis < 3 && length > 0.0f; axis++) {
+                key += (centroids[cluster][axis] - static_cast<float>(meshCentroid[axis])) * normal[axis] / length;
+            }
+
+            clusters[cluster].SortKey = key;
+        }
+    }
+
+    //Open addressing table from a grid cell to the last vertex inserted into it, the others are chained through Next.
+    //Only the hash of a cell is stored, cells whose hashes collide share a chain, which costs a few more comparisons.
+    class WeldGrid {
+    public:
+        using Cell = std::array<int64_t, 3>;
+
+        explicit WeldGrid(uint32_t numVertices)
+            :
+            m_entries(std::bit_ceil(std::max<size_t>(size_t{ numVertices } * 2, 16))),
+            m_next(numVertices, NO_VERTEX)
+        {}
+
+        [[nodiscard]] uint32_t GetFirst(const Cell& cell) const noexcept {
+            return m_entries[FindEntry(HashCell(cell))].Vertex;
+        }
+
+        [[nodiscard]] uint32_t GetNext(uint32_t vertex) const noexcept { return m_next[vertex]; }
+
+        void Insert(const Cell& cell, uint32_t vertex) noexcept {
+            const auto hash = HashCell(cell);
+            auto& entry     = m_entries[FindEntry(hash)];
+
+            m_next[vertex] = entry.Vertex;
+            entry.Hash     = hash;
+            entry.Vertex   = vertex;
+        }
+    private:
+        struct Entry {
+            uint64_t Hash{ 0 };
+            uint32_t Vertex{ NO_VERTEX };
+        };
+
+        [[nodiscard]] static uint64_t HashCell(const Cell& cell) noexcept {
+            auto hash = static_cast<uint64_t>(cell[0]) * 0x9E3779B97F4A7C15ull;
+            hash ^= static_cast<uint64_t>(cell[1]) * 0xC2B2AE3D27D4EB4Full;
+            hash ^= static_cast<uint64_t>(cell[2]) * 0x165667B19E3779F9ull;
+            hash ^= hash >> 32;
+            return hash * 0xD6E8FEB86659FD93ull;
+        }
+
+        //Index of the entry holding the hash, or of the empty one it would be inserted into
+        [[nodiscard]] size_t FindEntry(uint64_t hash) const noexcept {
+            const auto mask = m_entries.size() - 1;
+            auto index      = static_cast<size_t>(hash >> 32) & mask;
+
+            while (m_entries[index].Vertex != NO_VERTEX && m_entries[index].Hash != hash) {
+                index = (index + 1) & mask;
+            }
+            return index;
+        }
+
+        std::vector<Entry> m_entries;
+        std::vector<uint32_t> m_next;
+    };
+}
+
+VertexCacheStatistics Crystal::AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t numVertices, uint32_t vertexStride, uint32_t cacheSize) {
+    assert(indices.size() % 3 == 0);
+
+    VertexCacheStatistics statistics;
+
+    impl::PostTransformCache cache(numVertices, cacheSize);
+    std::vector<bool> isReferenced(numVertices, false);
+    uint32_t numReferenced = 0;
+
+    std::array<uint64_t, impl::FETCH_CACHE_LINES> fetchCache;
+    fetchCache.fill(~0ull);
+
+    for (const auto vertex : indices) {
+        if (!isReferenced[vertex]) {
+            isReferenced[vertex] = true;
+            numReferenced++;
+        }
+
+        if (!cache.Access(vertex)) {
+            continue;
+        }
+
+        statistics.VerticesTransformed++;
+
+        const auto begin = uint64_t{ vertex } * vertexStride;
+
+        for (auto line = begin / impl::FETCH_CACHE_LINE_SIZE; line <= (begin + vertexStride - 1) / impl::FETCH_CACHE_LINE_SIZE; line++) {
+            auto& cachedLine = fetchCache[line % impl::FETCH_CACHE_LINES];
+
+            if (cachedLine != line) {
+                cachedLine               = line;
+                statistics.BytesFetched += impl::FETCH_CACHE_LINE_SIZE;
+            }
+        }
+    }
+
+    if (!indices.empty()) {
+        statistics.ACMR      = static_cast<float>(statistics.VerticesTransformed) / static_cast<float>(indices.size() / 3);
+        statistics.ATVR      = static_cast<float>(statistics.VerticesTransformed) / static_cast<float>(numReferenced);
+        statistics.Overfetch = static_cast<float>(statistics.BytesFetched) / static_cast<float>(uint64_t{ numReferenced } * vertexStride);
+    }
+    return statistics;
+}
+
+std::vector<uint32_t> Crystal::WeldVertices(std::span<const std::byte> vertices, uint32_t vertexStride, float positionTolerance, float attributeTolerance) {
+    assert(vertexStride >= sizeof(float) * 3 && vertexStride % sizeof(float) == 0);
+
+    const auto numVertices = static_cast<uint32_t>(vertices.size() / vertexStride);
+    const auto numFloats   = vertexStride / sizeof(float);
+
+    std::vector<uint32_t> remap(numVertices);
+    std::iota(remap.begin(), remap.end(), 0u);
+
+    if (positionTolerance < 0.0f) {
+        return remap;
+    }
+
+    //Cells are four times the tolerance, a vertex within it lies in the cell of the position or, when the position is
+    //within the tolerance of a side, in the neighbour across it. A tolerance of zero hashes the exact position instead.
+    const bool isExact  = positionTolerance == 0.0f;
+    const auto cellSize = 4.0 * positionTolerance;
+
+    const auto loadFloats = [&](uint32_t vertex, float* floats) {
+        std::memcpy(floats, vertices.data() + size_t{ vertex } * vertexStride, vertexStride);
+    };
+
+    //Returns the number of cells to search along the axis, 1 or 2
+    const auto toCell = [&](float value, std::array<int64_t, 2>& cells) -> uint32_t {
+        if (isExact) {
+            cells[0] = std::bit_cast<uint32_t>(value + 0.0f);
+            return 1;
+        }
+
+        const auto scaled   = value / cellSize;
+        const auto floor    = std::floor(scaled);
+        const auto fraction = scaled - floor;
+
+        cells[0] = static_cast<int64_t>(floor);
+        cells[1] = fraction < 0.25 ? cells[0] - 1 : cells[0] + 1;
+        return fraction < 0.25 || fraction > 0.75 ? 2 : 1;
+    };
+
+    impl::WeldGrid grid(numVertices);
+
+    std::vector<float> floats(numFloats);
+    std::vector<float> candidateFloats(numFloats);
+
+    for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+        loadFloats(vertex, floats.data());
+
+        //Limited to a range that fits the cell coordinates, vertices outside of it are never welded
+        constexpr double MAX_CELL = 1e15;
+
+        if (!std::all_of(floats.begin(), floats.begin() + 3, [&](float value) { return std::abs(value / cellSize) < MAX_CELL || isExact; })) {
+            continue;
+        }
+
+        std::array<std::array<int64_t, 2>, 3> cells;
+        std::array<uint32_t, 3> numCells;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            numCells[axis] = toCell(floats[axis], cells[axis]);
+        }
+
+        const auto isMatch = [&](uint32_t candidate) {
+            loadFloats(candidate, candidateFloats.data());
+
+            for (size_t i = 0; i < numFloats; i++) {
+                const auto tolerance = i < 3 ? positionTolerance : attributeTolerance;
+
+                if (!(std::abs(floats[i] - candidateFloats[i]) <= tolerance)) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        auto weldedTo = impl::NO_VERTEX;
+
+        for (uint32_t neighbour = 0; neighbour < 8 && weldedTo == impl::NO_VERTEX; neighbour++) {
+            const std::array<uint32_t, 3> side{ neighbour & 1, (neighbour >> 1) & 1, (neighbour >> 2) & 1 };
+
+            if (side[0] >= numCells[0] || side[1] >= numCells[1] || side[2] >= numCells[2]) {
+                continue;
+            }
+
+            const impl::WeldGrid::Cell cell{ cells[0][side[0]], cells[1][side[1]], cells[2][side[2]] };
+
+            for (auto candidate = grid.GetFirst(cell); candidate != impl::NO_VERTEX; candidate = grid.GetNext(candidate)) {
+                if (isMatch(candidate)) {
+                    weldedTo = candidate;
+                    break;
+                }
+            }
+        }
+
+        if (weldedTo != impl::NO_VERTEX) {
+            remap[vertex] = weldedTo;
+        }
+        else {
+            grid.Insert({ cells[0][0], cells[1][0], cells[2][0] }, vertex);
+        }
+    }
+    return remap;
+}
+
+void Crystal::OptimizeVertexCache(std::span<uint32_t> indices, uint32_t numVertices, VertexCacheOrdering ordering, uint32_t cacheSize) {
+    assert(indices.size() % 3 == 0);
+
+    if (indices.empty()) {
+        return;
+    }
+
+    const auto ordered = ordering == VertexCacheOrdering::Tipsify
+        ? impl::TipsifyOrdering(indices, numVertices, cacheSize).Run()
+        : impl::ForsythOrdering(indices, numVertices).Run();
+
+    std::ranges::copy(ordered, indices.begin());
+}
+
+void Crystal::OptimizeOverdraw(std::span<uint32_t> indices, std::span<const std::byte> vertices, uint32_t vertexStride, float threshold, uint32_t cacheSize) {
+    assert(indices.size() % 3 == 0);
+
+    if (threshold <= 1.0f || indices.empty()) {
+        return;
+    }
+
+    const auto numVertices = static_cast<uint32_t>(vertices.size() / vertexStride);
+    const auto boundaries  = impl::FindHardBoundaries(indices, numVertices, cacheSize);
+
+    impl::PostTransformCache cache(numVertices, cacheSize);
+    std::vector<impl::TriangleCluster> clusters;
+
+    for (size_t boundary = 0; boundary + 1 < boundaries.size(); boundary++) {
+        impl::SplitCluster(indices, cache, boundaries[boundary], boundaries[boundary + 1], threshold, clusters);
+    }
+
+    impl::ComputeSortKeys(indices, vertices, vertexStride, clusters);
+
+    //Stable, so clusters with the same key keep the order the cache pass gave them
+    std::ranges::stable_sort(clusters, std::ranges::greater{}, &impl::TriangleCluster::SortKey);
+
+    std::vector<uint32_t> ordered;
+    ordered.reserve(indices.size());
+
+    for (const auto& cluster : clusters) {
+        ordered.insert(ordered.end(), indices.begin() + size_t{ cluster.Begin } * 3, indices.begin() + size_t{ cluster.End } * 3);
+    }
+
+    std::ranges::copy(ordered, indices.begin());
+}
+
+uint32_t Crystal::OptimizeVertexFetch(std::span<std::byte> vertices, uint32_t vertexStride, std::span<uint32_t> indices) {
+    const auto numVertices = static_cast<uint32_t>(vertices.size() / vertexStride);
+
+    std::vector<uint32_t> newIndices(numVertices, impl::NO_VERTEX);
+    uint32_t numReferenced = 0;
+
+    for (auto& index : indices) {
+        if (newIndices[index] == impl::NO_VERTEX) {
+            newIndices[index] = numReferenced++;
+        }
+        index = newIndices[index];
+    }
+
+    std::vector<std::byte> ordered(size_t{ numReferenced } * vertexStride);
+
+    for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+        if (newIndices[vertex] != impl::NO_VERTEX) {
+            std::memcpy(ordered.data() + size_t{ newIndices[vertex] } * vertexStride, vertices.data() + size_t{ vertex } * vertexStride, vertexStride);
+        }
+    }
+
+    std::ranges::copy(ordered, vertices.begin());
+    return numReferenced;
+}
+
+MeshOptimizationReport Crystal::OptimizeMesh(std::span<std::byte> vertices, uint32_t vertexStride, std::vector<uint32_t>& indices, const MeshOptimizerSettings& settings) {
+    assert(indices.size() % 3 == 0);
+
+    const auto numVertices = static_cast<uint32_t>(vertices.size() / vertexStride);
+
+    MeshOptimizationReport report{
+        .NumVerticesBefore  = numVertices,
+        .NumTrianglesBefore = static_cast<uint32_t>(indices.size() / 3),
+        .Before             = AnalyzeVertexCache(indices, numVertices, vertexStride, settings.CacheSize)
+    };
+
+    //Welded vertices are left unreferenced and dropped by the vertex fetch pass
+    const auto remap = WeldVertices(vertices, vertexStride, settings.PositionTolerance, settings.AttributeTolerance);
+
+    size_t numIndices = 0;
+
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const auto a = remap[indices[i + 0]];
+        const auto b = remap[indices[i + 1]];
+        const auto c = remap[indices[i + 2]];
+
+        if (a != b && b != c && c != a) {
+            indices[numIndices++] = a;
+            indices[numIndices++] = b;
+            indices[numIndices++] = c;
+        }
+    }
+
+    indices.resize(numIndices);
+
+    OptimizeVertexCache(indices, numVertices, settings.Ordering, settings.CacheSize);
+    OptimizeOverdraw(indices, vertices, vertexStride, settings.OverdrawThreshold, settings.CacheSize);
+
+    report.NumVerticesAfter  = OptimizeVertexFetch(vertices, vertexStride, indices);
+    report.NumTrianglesAfter = static_cast<uint32_t>(indices.size() / 3);
+    report.After             = AnalyzeVertexCache(indices, report.NumVerticesAfter, vertexStride, settings.CacheSize);
+
+    return report;
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    enum class VertexCacheOrdering : uint8_t {
+        //Tipsify, linear time and aware of the cache size, leaves clusters the overdraw pass can reorder
+        Tipsify,
+        //Forsyth's scoring of triangles by the LRU position and remaining valence of their vertices, tuned for a 32 entry
+        //LRU cache rather than the given size
+        Forsyth
+    };
+
+    struct MeshOptimizerSettings {
+        VertexCacheOrdering Ordering{ VertexCacheOrdering::Tipsify };
+
+        //Entries of the FIFO post-transform cache the ordering targets and the statistics simulate
+        uint32_t CacheSize{ 16 };
+
+        //Clusters are sorted front to back, they are cut where their ACMR on a cold cache is within this factor of the
+        //cache optimized order. 1 keeps the order of the vertex cache pass.
+        float OverdrawThreshold{ 1.05f };
+
+        //Vertices are welded when every position component is within PositionTolerance and every other attribute
+        //within AttributeTolerance. A negative tolerance disables welding.
+        float PositionTolerance{ 1e-5f };
+        float AttributeTolerance{ 1e-4f };
+    };
+
+    struct VertexCacheStatistics {
+        uint32_t VerticesTransformed{ 0 };
+        uint64_t BytesFetched{ 0 };
+
+        //Average cache miss ratio, transformed vertices per triangle: 3 without reuse, 0.5 for an ideal regular grid
+        float ACMR{ 0.0f };
+        //Average transform to vertex ratio, transformed vertices per referenced vertex: 1 is ideal
+        float ATVR{ 0.0f };
+        //Bytes read from the vertex buffer per referenced byte, 1 when every cache line is read once
+        float Overfetch{ 0.0f };
+    };
+
+    struct MeshOptimizationReport {
+        uint32_t NumVerticesBefore{ 0 };
+        uint32_t NumVerticesAfter{ 0 };
+        uint32_t NumTrianglesBefore{ 0 };
+        uint32_t NumTrianglesAfter{ 0 };
+
+        VertexCacheStatistics Before;
+        VertexCacheStatistics After;
+    };
+
+    //Simulates a FIFO post-transform cache of cacheSize entries and a 16 KiB vertex fetch cache with 64 byte lines
+    [[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(
+        std::span<const uint32_t> indices,
+        uint32_t numVertices,
+        uint32_t vertexStride,
+        uint32_t cacheSize = 16);
+
+    //Maps every vertex to the first one it is welded to, vertices that are kept map to themselves. Candidates are
+    //found through a hashed grid of cells four times as large as the position tolerance. The first three floats of a vertex have
+    //to be its position and the stride a multiple of 4, every other float is compared as an attribute.
+    [[nodiscard]] std::vector<uint32_t> WeldVertices(
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        float positionTolerance,
+        float attributeTolerance);
+
+    //Reorders the triangles for the post-transform cache, vertices keep their indices
+    void OptimizeVertexCache(std::span<uint32_t> indices, uint32_t numVertices, VertexCacheOrdering ordering, uint32_t cacheSize = 16);
+
+    //Splits a cache optimized index buffer into clusters and draws the ones facing away from the center of the mesh
+    //first, they are the most likely to occlude the rest. Expects the output of OptimizeVertexCache.
+    void OptimizeOverdraw(
+        std::span<uint32_t> indices,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        float threshold,
+        uint32_t cacheSize = 16);
+
+    //Moves vertices into the order the index buffer first references them and remaps the indices. Unreferenced
+    //vertices are dropped, returns the number of vertices left at the front of the buffer.
+    uint32_t OptimizeVertexFetch(std::span<std::byte> vertices, uint32_t vertexStride, std::span<uint32_t> indices);
+
+    //Runs every pass in order: welding followed by removing degenerate triangles, vertex cache ordering,
+    //overdraw and vertex fetch. The vertex buffer is compacted in place, the first NumVerticesAfter vertices are used.
+    MeshOptimizationReport OptimizeMesh(
+        std::span<std::byte> vertices,
+        uint32_t vertexStride,
+        std::vector<uint32_t>& indices,
+        const MeshOptimizerSettings& settings = {});
+}
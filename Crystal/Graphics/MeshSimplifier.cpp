@@ -0,0 +1,547 @@
+#include "MeshSimplifier.h"
+#include "MeshAdjacency.h"
+#include "Core/Math/MathFunctions.h"
+#include "Core/Math/Vector3.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+using namespace Crystal;
+
+namespace impl {
+    //Planes along open borders, weighted against the triangle planes so a border collapse keeps the border's shape
+    constexpr double BORDER_PLANE_WEIGHT = 10.0;
+
+    enum class SimplifierVertexKind : uint8_t {
+        Manifold,
+        //Moves only along open border edges onto other border vertices
+        Border,
+        Locked
+    };
+
+    //Sum of squared distances to a set of weighted planes, evaluated as p^T A p + 2 b^T p + c
+    struct Quadric {
+        double A00{ 0.0 }, A01{ 0.0 }, A02{ 0.0 }, A11{ 0.0 }, A12{ 0.0 }, A22{ 0.0 };
+        double B0{ 0.0 }, B1{ 0.0 }, B2{ 0.0 };
+        double C{ 0.0 };
+        double Weight{ 0.0 };
+
+        void AddPlane(const Math::Vector3& normal, float distance, double weight) noexcept {
+            const double x = normal.x, y = normal.y, z = normal.z, d = distance;
+
+            A00 += weight * x * x; A01 += weight * x * y; A02 += weight * x * z;
+            A11 += weight * y * y; A12 += weight * y * z; A22 += weight * z * z;
+            B0  += weight * x * d; B1  += weight * y * d; B2  += weight * z * d;
+            C   += weight * d * d;
+            Weight += weight;
+        }
+
+        void operator+=(const Quadric& rhs) noexcept {
+            A00 += rhs.A00; A01 += rhs.A01; A02 += rhs.A02;
+            A11 += rhs.A11; A12 += rhs.A12; A22 += rhs.A22;
+            B0  += rhs.B0;  B1  += rhs.B1;  B2  += rhs.B2;
+            C   += rhs.C;
+            Weight += rhs.Weight;
+        }
+
+        [[nodiscard]] double Evaluate(const Math::Vector3& point) const noexcept {
+            const double x = point.x, y = point.y, z = point.z;
+
+            const auto error =
+                A00 * x * x + A11 * y * y + A22 * z * z +
+                2.0 * (A01 * x * y + A02 * x * z + A12 * y * z) +
+                2.0 * (B0 * x + B1 * y + B2 * z) + C;
+
+            return std::max(error, 0.0);
+        }
+    };
+
+    struct SimplifierCollapse {
+        uint32_t From;
+        uint32_t To;
+        float Cost;
+        float ErrorSquared;
+    };
+
+    [[nodiscard]] constexpr uint64_t GetEdgeKey(uint32_t from, uint32_t to) noexcept {
+        return uint64_t{ from } << 32 | to;
+    }
+
+    class MeshSimplifier {
+    public:
+        MeshSimplifier(std::span<const uint32_t> indices, std::span<const std::byte> vertices, uint32_t vertexStride, const MeshSimplifierSettings& settings)
+            :
+            m_indices(indices.begin(), indices.end()),
+            m_numVertices(static_cast<uint32_t>(vertices.size() / vertexStride))
+        {
+            LoadVertices(vertices, vertexStride, settings.AttributeWeights);
+            ClassifyVertices(settings.LockBorder);
+            ComputeQuadrics();
+        }
+
+        //Collapses edges in passes until the triangle count reaches the target or no collapse within the error, relative to
+        //the extent, is left. Returns the geometric error reached so far in object space.
+        float Simplify(uint32_t targetTriangles, float maxError) {
+            const auto maxErrorSquared = maxError * maxError;
+
+            while (GetNumTriangles() > targetTriangles) {
+                if (!CollapsePass(targetTriangles, maxErrorSquared)) {
+                    break;
+                }
+            }
+            return std::sqrt(m_errorSquared) * m_extent;
+        }
+
+        [[nodiscard]] uint32_t GetNumTriangles() const noexcept { return static_cast<uint32_t>(m_indices.size() / 3); }
+        [[nodiscard]] std::span<const uint32_t> GetIndices() const noexcept { return m_indices; }
+    private:
+        //Positions are moved into the unit cube so errors and weights do not depend on the scale of the mesh
+        void LoadVertices(std::span<const std::byte> vertices, uint32_t vertexStride, std::span<const float> attributeWeights) {
+            m_positions.resize(m_numVertices);
+
+            Math::Vector3 minimum(std::numeric_limits<float>::max()), maximum(-std::numeric_limits<float>::max());
+
+            for (uint32_t vertex = 0; vertex < m_numVertices; vertex++) {
+                const auto position = LoadVertexPosition(vertices, vertexStride, vertex);
+
+                m_positions[vertex] = { position[0], position[1], position[2] };
+                minimum = { std::min(minimum.x, position[0]), std::min(minimum.y, position[1]), std::min(minimum.z, position[2]) };
+                maximum = { std::max(maximum.x, position[0]), std::max(maximum.y, position[1]), std::max(maximum.z, position[2]) };
+            }
+
+            const auto extent = maximum - minimum;
+            m_extent          = std::max({ extent.x, extent.y, extent.z, 0.0f });
+
+            const auto scale = m_extent > 0.0f ? 1.0f / m_extent : 1.0f;
+
+            for (auto& position : m_positions) {
+                position = (position - minimum) * scale;
+            }
+
+            //Attributes are stored scaled by the square root of their weight, a squared difference is then their cost
+            const auto numFloats = vertexStride / sizeof(float) - 3;
+
+            for (uint32_t attribute = 0; attribute < std::min<size_t>(numFloats, attributeWeights.size()); attribute++) {
+                if (attributeWeights[attribute] > 0.0f) {
+                    m_attributeOffsets.push_back(static_cast<uint32_t>((attribute + 3) * sizeof(float)));
+                    m_attributeScales.push_back(std::sqrt(attributeWeights[attribute]));
+                }
+            }
+
+            const auto numAttributes = m_attributeOffsets.size();
+            m_attributes.resize(numAttributes * m_numVertices);
+
+            for (uint32_t vertex = 0; vertex < m_numVertices; vertex++) {
+                for (size_t attribute = 0; attribute < numAttributes; attribute++) {
+                    float value;
+                    std::memcpy(&value, vertices.data() + size_t{ vertex } * vertexStride + m_attributeOffsets[attribute], sizeof(value));
+                    m_attributes[vertex * numAttributes + attribute] = value * m_attributeScales[attribute];
+                }
+            }
+        }
+
+        //Vertices sharing a position are seams of the attributes and locked, edges are matched by position so a seam is
+        //not mistaken for a border. Edges used more than once per direction are non-manifold and lock their vertices.
+        void ClassifyVertices(bool lockBorder) {
+            std::vector<uint32_t> order(m_numVertices);
+            std::iota(order.begin(), order.end(), 0u);
+
+            const auto toTuple = [&](uint32_t vertex) {
+                const auto& position = m_positions[vertex];
+                return std::array{ position.x, position.y, position.z };
+            };
+
+            std::ranges::sort(order, {}, toTuple);
+
+            m_positionIds.resize(m_numVertices);
+            std::vector<uint32_t> numSharing;
+
+            for (size_t i = 0; i < order.size(); i++) {
+                if (i == 0 || toTuple(order[i]) != toTuple(order[i - 1])) {
+                    numSharing.push_back(0);
+                }
+
+                m_positionIds[order[i]] = static_cast<uint32_t>(numSharing.size() - 1);
+                numSharing.back()++;
+            }
+
+            m_directedEdges.clear();
+            m_directedEdges.reserve(m_indices.size());
+
+            for (size_t triangle = 0; triangle < m_indices.size(); triangle += 3) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const auto from = m_positionIds[m_indices[triangle + corner]];
+                    const auto to   = m_positionIds[m_indices[triangle + (corner + 1) % 3]];
+                    m_directedEdges.push_back(GetEdgeKey(from, to));
+                }
+            }
+
+            std::ranges::sort(m_directedEdges);
+
+            std::vector<bool> isLocked(numSharing.size(), false), isBorder(numSharing.size(), false);
+
+            for (size_t i = 0; i < m_directedEdges.size(); i++) {
+                const auto key  = m_directedEdges[i];
+                const auto from = static_cast<uint32_t>(key >> 32);
+                const auto to   = static_cast<uint32_t>(key);
+
+                const bool isRepeated = i + 1 < m_directedEdges.size() && m_directedEdges[i + 1] == key;
+                const auto numReverse = CountDirectedEdge(to, from);
+
+                if (isRepeated || numReverse > 1) {
+                    isLocked[from] = isLocked[to] = true;
+                }
+                else if (numReverse == 0) {
+                    isBorder[from] = isBorder[to] = true;
+                }
+            }
+
+            m_kinds.resize(m_numVertices);
+
+            for (uint32_t vertex = 0; vertex < m_numVertices; vertex++) {
+                const auto positionId = m_positionIds[vertex];
+
+                if (isLocked[positionId] || numSharing[positionId] > 1 || (isBorder[positionId] && lockBorder)) {
+                    m_kinds[vertex] = SimplifierVertexKind::Locked;
+                }
+                else {
+                    m_kinds[vertex] = isBorder[positionId] ? SimplifierVertexKind::Border : SimplifierVertexKind::Manifold;
+                }
+            }
+        }
+
+        [[nodiscard]] size_t CountDirectedEdge(uint32_t from, uint32_t to) const noexcept {
+            const auto [first, last] = std::ranges::equal_range(m_directedEdges, GetEdgeKey(from, to));
+            return static_cast<size_t>(last - first);
+        }
+
+        //Only open edges lack the opposite direction, the edge table is from the input mesh
+        [[nodiscard]] bool IsBorderEdge(uint32_t from, uint32_t to) const noexcept {
+            const auto a = m_positionIds[from], b = m_positionIds[to];
+            return CountDirectedEdge(a, b) + CountDirectedEdge(b, a) == 1;
+        }
+
+        //Triangle planes weighted by area, open edges add a plane through the edge perpendicular to the triangle
+        void ComputeQuadrics() {
+            m_quadrics.assign(m_numVertices, {});
+
+            for (size_t triangle = 0; triangle < m_indices.size(); triangle += 3) {
+                const std::array corners{ m_indices[triangle], m_indices[triangle + 1], m_indices[triangle + 2] };
+
+                const auto& p0 = m_positions[corners[0]];
+                const auto cross  = Math::Vector3::Cross(m_positions[corners[1]] - p0, m_positions[corners[2]] - p0);
+                const auto length = std::sqrt(Math::Vector3::Dot(cross, cross));
+
+                if (length <= 0.0f) {
+                    continue;
+                }
+
+                const auto normal = cross / length;
+
+                Quadric quadric;
+                quadric.AddPlane(normal, -Math::Vector3::Dot(normal, p0), length * 0.5);
+
+                for (const auto corner : corners) {
+                    m_quadrics[corner] += quadric;
+                }
+
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const auto from = corners[corner], to = corners[(corner + 1) % 3];
+
+                    if (m_kinds[from] != SimplifierVertexKind::Border || m_kinds[to] != SimplifierVertexKind::Border || !IsBorderEdge(from, to)) {
+                        continue;
+                    }
+
+                    const auto edge          = m_positions[to] - m_positions[from];
+                    const auto edgeNormal    = Math::Vector3::Cross(edge, normal);
+                    const auto normalLength  = std::sqrt(Math::Vector3::Dot(edgeNormal, edgeNormal));
+
+                    if (normalLength <= 0.0f) {
+                        continue;
+                    }
+
+                    const auto planeNormal = edgeNormal / normalLength;
+
+                    Quadric borderQuadric;
+                    borderQuadric.AddPlane(planeNormal, -Math::Vector3::Dot(planeNormal, m_positions[from]), Math::Vector3::Dot(edge, edge) * BORDER_PLANE_WEIGHT);
+
+                    m_quadrics[from] += borderQuadric;
+                    m_quadrics[to]   += borderQuadric;
+                }
+            }
+        }
+
+        [[nodiscard]] float GetAttributeCost(uint32_t from, uint32_t to) const noexcept {
+            const auto numAttributes = m_attributeOffsets.size();
+            float cost = 0.0f;
+
+            for (size_t attribute = 0; attribute < numAttributes; attribute++) {
+                const auto difference = m_attributes[from * numAttributes + attribute] - m_attributes[to * numAttributes + attribute];
+                cost += difference * difference;
+            }
+            return cost;
+        }
+
+        [[nodiscard]] bool CanMove(uint32_t from, uint32_t to) const noexcept {
+            switch (m_kinds[from]) {
+            case SimplifierVertexKind::Manifold:
+                return true;
+            case SimplifierVertexKind::Border:
+                return m_kinds[to] != SimplifierVertexKind::Manifold && IsBorderEdge(from, to);
+            default:
+                return false;
+            }
+        }
+
+        //Squared distance the combined quadric estimates for the vertex kept, normalized by the area it covers
+        [[nodiscard]] SimplifierCollapse EvaluateCollapse(uint32_t from, uint32_t to) const noexcept {
+            auto quadric = m_quadrics[from];
+            quadric += m_quadrics[to];
+
+            const auto errorSquared = static_cast<float>(quadric.Weight > 0.0 ? quadric.Evaluate(m_positions[to]) / quadric.Weight : 0.0);
+            return { from, to, errorSquared + GetAttributeCost(from, to), errorSquared };
+        }
+
+        //Rejects collapses that flip a triangle, join the two sides of a seam or pinch the surface, which happens when
+        //both ends share a neighbour besides the triangles on the edge.
+        [[nodiscard]] bool IsCollapseValid(uint32_t from, uint32_t to) {
+            uint32_t numEdgeTriangles = 0;
+            m_fromNeighbours.clear();
+            m_toNeighbours.clear();
+
+            for (const auto triangle : m_adjacency.GetTriangles(from)) {
+                const auto* corners = &m_indices[size_t{ triangle } * 3];
+
+                for (size_t corner = 0; corner < 3; corner++) {
+                    if (corners[corner] != from && corners[corner] != to) {
+                        m_fromNeighbours.push_back(m_positionIds[corners[corner]]);
+                    }
+                }
+
+                if (corners[0] == to || corners[1] == to || corners[2] == to) {
+                    numEdgeTriangles++;
+                    continue;
+                }
+
+                std::array<Math::Vector3, 3> before, after;
+
+                for (size_t corner = 0; corner < 3; corner++) {
+                    before[corner] = m_positions[corners[corner]];
+                    after[corner]  = corners[corner] == from ? m_positions[to] : before[corner];
+
+                    if (corners[corner] != from && m_positionIds[corners[corner]] == m_positionIds[to]) {
+                        return false;
+                    }
+                }
+
+                const auto normalBefore = Math::Vector3::Cross(before[1] - before[0], before[2] - before[0]);
+                const auto normalAfter  = Math::Vector3::Cross(after[1] - after[0], after[2] - after[0]);
+
+                if (Math::Vector3::Dot(normalBefore, normalAfter) <= 0.0f) {
+                    return false;
+                }
+            }
+
+            for (const auto triangle : m_adjacency.GetTriangles(to)) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const auto vertex = m_indices[size_t{ triangle } * 3 + corner];
+
+                    if (vertex != to && vertex != from) {
+                        m_toNeighbours.push_back(m_positionIds[vertex]);
+                    }
+                }
+            }
+
+            std::ranges::sort(m_fromNeighbours);
+            std::ranges::sort(m_toNeighbours);
+            const auto fromEnd = std::unique(m_fromNeighbours.begin(), m_fromNeighbours.end());
+            const auto toEnd   = std::unique(m_toNeighbours.begin(), m_toNeighbours.end());
+
+            uint32_t numShared = 0;
+
+            for (auto fromIt = m_fromNeighbours.begin(), toIt = m_toNeighbours.begin(); fromIt != fromEnd && toIt != toEnd;) {
+                if (*fromIt == *toIt) {
+                    numShared++;
+                    ++fromIt;
+                    ++toIt;
+                }
+                else if (*fromIt < *toIt) {
+                    ++fromIt;
+                }
+                else {
+                    ++toIt;
+                }
+            }
+
+            //The third vertices of the triangles on the edge are the only neighbours both ends may have in common
+            return numEdgeTriangles > 0 && numShared == numEdgeTriangles;
+        }
+
+        //Collapses the cheapest edges first. A collapse locks the neighbourhood of the moved vertex for the rest of the
+        //pass, so every triangle changes at most once and the validity checks stay exact.
+        bool CollapsePass(uint32_t targetTriangles, float maxErrorSquared) {
+            m_adjacency = BuildVertexAdjacency(m_indices, m_numVertices);
+
+            m_collapses.clear();
+
+            //Interior edges are seen from both of their triangles and taken from the one where they ascend. Open edges
+            //have only one triangle and are taken from it, the duplicates that leaves are rejected as touched.
+            for (size_t triangle = 0; triangle < m_indices.size(); triangle += 3) {
+                for (size_t corner = 0; corner < 3; corner++) {
+                    const auto a = m_indices[triangle + corner], b = m_indices[triangle + (corner + 1) % 3];
+
+                    if (a > b && (m_kinds[a] == SimplifierVertexKind::Manifold || m_kinds[b] == SimplifierVertexKind::Manifold)) {
+                        continue;
+                    }
+
+                    const auto canMoveA = CanMove(a, b);
+                    const auto canMoveB = CanMove(b, a);
+
+                    if (!canMoveA && !canMoveB) {
+                        continue;
+                    }
+
+                    auto collapse = canMoveA ? EvaluateCollapse(a, b) : EvaluateCollapse(b, a);
+
+                    if (canMoveA && canMoveB) {
+                        const auto reverse = EvaluateCollapse(b, a);
+                        collapse = reverse.Cost < collapse.Cost ? reverse : collapse;
+                    }
+
+                    if (collapse.ErrorSquared <= maxErrorSquared) {
+                        m_collapses.push_back(collapse);
+                    }
+                }
+            }
+
+            std::ranges::sort(m_collapses, {}, &SimplifierCollapse::Cost);
+
+            m_isTouched.assign(m_numVertices, false);
+
+            const auto numTriangles = GetNumTriangles();
+            uint32_t numRemoved     = 0;
+            bool hasCollapsed       = false;
+
+            for (const auto& collapse : m_collapses) {
+                if (numTriangles - numRemoved <= targetTriangles) {
+                    break;
+                }
+
+                const auto [from, to, cost, errorSquared] = collapse;
+
+                if (m_isTouched[from] || m_isTouched[to] || !IsCollapseValid(from, to)) {
+                    continue;
+                }
+
+                for (const auto triangle : m_adjacency.GetTriangles(from)) {
+                    auto* corners = &m_indices[size_t{ triangle } * 3];
+                    numRemoved += corners[0] == to || corners[1] == to || corners[2] == to;
+
+                    for (size_t corner = 0; corner < 3; corner++) {
+                        m_isTouched[corners[corner]] = true;
+                        corners[corner] = corners[corner] == from ? to : corners[corner];
+                    }
+                }
+
+                m_quadrics[to] += m_quadrics[from];
+                m_isTouched[to] = true;
+                m_errorSquared  = std::max(m_errorSquared, errorSquared);
+                hasCollapsed    = true;
+            }
+
+            //Triangles on collapsed edges are left with two equal corners
+            size_t numKept = 0;
+
+            for (size_t triangle = 0; triangle < m_indices.size(); triangle += 3) {
+                const auto a = m_indices[triangle], b = m_indices[triangle + 1], c = m_indices[triangle + 2];
+
+                if (a != b && b != c && c != a) {
+                    m_indices[numKept++] = a;
+                    m_indices[numKept++] = b;
+                    m_indices[numKept++] = c;
+                }
+            }
+
+            m_indices.resize(numKept);
+            return hasCollapsed;
+        }
+
+        std::vector<uint32_t> m_indices;
+        uint32_t m_numVertices;
+        float m_extent{ 0.0f };
+        float m_errorSquared{ 0.0f };
+
+        std::vector<Math::Vector3> m_positions;
+        std::vector<uint32_t> m_attributeOffsets;
+        std::vector<float> m_attributeScales;
+        std::vector<float> m_attributes;
+        std::vector<uint32_t> m_positionIds;
+        std::vector<uint64_t> m_directedEdges;
+        std::vector<SimplifierVertexKind> m_kinds;
+        std::vector<Quadric> m_quadrics;
+
+        VertexAdjacency m_adjacency;
+        std::vector<SimplifierCollapse> m_collapses;
+        std::vector<bool> m_isTouched;
+        std::vector<uint32_t> m_fromNeighbours;
+        std::vector<uint32_t> m_toNeighbours;
+    };
+}
+
+LodChain Crystal::GenerateLodChain(std::span<const uint32_t> indices, std::span<const std::byte> vertices, uint32_t vertexStride, const MeshSimplifierSettings& settings) {
+    assert(vertexStride >= sizeof(float) * 3 && vertexStride % sizeof(float) == 0);
+    assert(indices.size() % 3 == 0);
+
+    LodChain chain;
+
+    if (indices.empty() || settings.MaxLevels == 0) {
+        return chain;
+    }
+
+    impl::MeshSimplifier simplifier(indices, vertices, vertexStride, settings);
+
+    auto numTriangles = simplifier.GetNumTriangles();
+    float error       = 0.0f;
+
+    for (uint32_t level = 0; level < settings.MaxLevels; level++) {
+        const auto target = static_cast<uint32_t>(static_cast<float>(numTriangles) * settings.TriangleRatio);
+
+        error = std::max(error, simplifier.Simplify(target, settings.MaxError));
+
+        const auto numSimplified = simplifier.GetNumTriangles();
+
+        if (numSimplified == 0 || static_cast<float>(numSimplified) > static_cast<float>(numTriangles) * settings.MaxTriangleRatio) {
+            break;
+        }
+
+        const auto simplified = simplifier.GetIndices();
+
+        chain.Levels.push_back({ static_cast<uint32_t>(chain.Indices.size()), static_cast<uint32_t>(simplified.size()), error });
+        chain.Indices.insert(chain.Indices.end(), simplified.begin(), simplified.end());
+
+        numTriangles = numSimplified;
+    }
+    return chain;
+}
+
+float Crystal::GetLodErrorScale(float verticalFov, float viewportHeight) noexcept {
+    return viewportHeight / (2.0f * std::tan(Math::ToRadians(verticalFov) * 0.5f));
+}
+
+uint32_t Crystal::SelectLod(std::span<const MeshLod> levels, float distance, float errorScale, float maxPixelError) noexcept {
+    uint32_t selected = 0;
+
+    //Errors grow along the chain, the first level over the limit ends the search
+    for (uint32_t level = 1; level < levels.size(); level++) {
+        if (levels[level].Error * errorScale > maxPixelError * distance) {
+            break;
+        }
+        selected = level;
+    }
+    return selected;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    struct MeshSimplifierSettings {
+        //Levels generated after the full detail mesh
+        uint32_t MaxLevels{ 4 };
+
+        //Triangles every level aims for, relative to the level before it
+        float TriangleRatio{ 0.5f };
+
+        //Levels that keep more of the level before it are dropped and end the chain, they would cost memory without
+        //saving much work
+        float MaxTriangleRatio{ 0.85f };
+
+        //Largest geometric error of any level relative to the largest extent of the mesh, collapses beyond it are skipped
+        float MaxError{ 0.05f };
+
+        //Vertices on open borders keep their place so meshes meeting there do not open cracks. Vertices on attribute
+        //seams and non-manifold edges are always kept.
+        bool LockBorder{ true };
+
+        //Weights of the squared difference of every float after the position, added to the squared error relative to the
+        //extent when ordering collapses. Missing entries are 0, the reported error is geometric only.
+        std::span<const float> AttributeWeights;
+    };
+
+    //Range of a level in the index buffer of its mesh and its geometric error in object space
+    struct MeshLod {
+        uint32_t FirstIndex;
+        uint32_t NumIndices;
+        float Error;
+    };
+
+    struct LodChain {
+        std::vector<uint32_t> Indices;
+        //Levels after the full detail mesh with decreasing triangle counts, ranges are in Indices. Errors never decrease.
+        std::vector<MeshLod> Levels;
+    };
+
+    //Quadric error edge collapses onto existing vertices, every level indexes the vertex buffer of the full detail
+    //mesh. Each level continues from the one before it, so the error accumulates along the chain. The first three
+    //floats of every vertex have to be its position and the stride a multiple of 4.
+    [[nodiscard]] LodChain GenerateLodChain(
+        std::span<const uint32_t> indices,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        const MeshSimplifierSettings& settings = {});
+
+    //Pixels an object space error of 1 covers at a distance of 1, for a vertical field of view in degrees
+    [[nodiscard]] float GetLodErrorScale(float verticalFov, float viewportHeight) noexcept;
+
+    //Coarsest level whose error stays within maxPixelError on screen at the given distance, levels have to start with
+    //the full detail mesh
+    [[nodiscard]] uint32_t SelectLod(std::span<const MeshLod> levels, float distance, float errorScale, float maxPixelError) noexcept;
+}
@@ -0,0 +1,382 @@
+#include "Meshlets.h"
+#include "MeshAdjacency.h"
+#include "Core/Math/Vector3.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint32_t NO_MESHLET            = ~0u;
+    constexpr uint32_t NO_MESHLET_TRIANGLE   = ~0u;
+    constexpr uint32_t MAX_MESHLET_VERTICES  = 256;
+    constexpr uint32_t MAX_MESHLET_TRIANGLES = 256;
+
+    //Cutoff of meshlets whose normals spread over more than a hemisphere, the cone test never passes with it
+    constexpr float NEVER_BACK_FACING = 2.0f;
+
+    //Cost of a candidate at the edge of the meshlet relative to a new vertex
+    constexpr float DISTANCE_WEIGHT = 0.5f;
+
+    [[nodiscard]] Math::Vector3 LoadMeshletPosition(std::span<const std::byte> vertices, uint32_t vertexStride, uint32_t vertex) noexcept {
+        const auto position = LoadVertexPosition(vertices, vertexStride, vertex);
+        return { position[0], position[1], position[2] };
+    }
+
+    //Unit normal following the winding, zero for degenerate triangles
+    [[nodiscard]] Math::Vector3 GetTriangleNormal(const Math::Vector3& v0, const Math::Vector3& v1, const Math::Vector3& v2) noexcept {
+        const auto normal = Math::Vector3::Cross(v1 - v0, v2 - v0);
+        const auto length = std::sqrt(Math::Vector3::Dot(normal, normal));
+        return length > 0.0f ? normal / length : Math::Vector3(0.0f);
+    }
+
+    //Ritter's sphere: starts from the most distant pair of the extreme points along the axes and grows to take in
+    //every point outside. Within a few percent of the minimal sphere for the compact point sets of a meshlet.
+    void ComputeBoundingSphere(std::span<const Math::Vector3> points, MeshletBounds& bounds) noexcept {
+        const auto getCoordinate = [](const Math::Vector3& point, uint32_t axis) {
+            return axis == 0 ? point.x : (axis == 1 ? point.y : point.z);
+        };
+
+        std::array<uint32_t, 3> minPoint{}, maxPoint{};
+
+        for (uint32_t point = 1; point < points.size(); point++) {
+            for (uint32_t axis = 0; axis < 3; axis++) {
+                const auto coordinate = getCoordinate(points[point], axis);
+
+                minPoint[axis] = coordinate < getCoordinate(points[minPoint[axis]], axis) ? point : minPoint[axis];
+                maxPoint[axis] = coordinate > getCoordinate(points[maxPoint[axis]], axis) ? point : maxPoint[axis];
+            }
+        }
+
+        auto center         = points[0];
+        float radiusSquared = 0.0f;
+
+        for (uint32_t axis = 0; axis < 3; axis++) {
+            const auto extent        = points[maxPoint[axis]] - points[minPoint[axis]];
+            const auto extentSquared = Math::Vector3::Dot(extent, extent) * 0.25f;
+
+            if (extentSquared > radiusSquared) {
+                radiusSquared = extentSquared;
+                center        = (points[maxPoint[axis]] + points[minPoint[axis]]) * 0.5f;
+            }
+        }
+
+        auto radius = std::sqrt(radiusSquared);
+
+        for (const auto& point : points) {
+            const auto offset   = point - center;
+            const auto distance = std::sqrt(Math::Vector3::Dot(offset, offset));
+
+            if (distance > radius) {
+                const auto grownRadius = (radius + distance) * 0.5f;
+                center                 = center + offset * ((grownRadius - radius) / distance);
+                radius                 = grownRadius;
+            }
+        }
+
+        bounds.Center = { center.x, center.y, center.z };
+        bounds.Radius = radius;
+    }
+
+    //The axis is the average of the triangle normals, the cutoff the sine of the widest angle between a normal and it
+    void ComputeNormalCone(std::span<const Math::Vector3> normals, MeshletBounds& bounds) noexcept {
+        Math::Vector3 normalSum(0.0f);
+
+        for (const auto& normal : normals) {
+            normalSum = normalSum + normal;
+        }
+
+        const auto length = std::sqrt(Math::Vector3::Dot(normalSum, normalSum));
+
+        bounds.ConeAxis   = { 0.0f, 0.0f, 0.0f };
+        bounds.ConeCutoff = NEVER_BACK_FACING;
+
+        if (length <= 1e-6f) {
+            return;
+        }
+
+        const auto axis = normalSum / length;
+        float minDot = 1.0f;
+
+        for (const auto& normal : normals) {
+            //Degenerate triangles have no facing, they are culled with the rest
+            if (Math::Vector3::Dot(normal, normal) > 0.0f) {
+                minDot = std::min(minDot, Math::Vector3::Dot(normal, axis));
+            }
+        }
+
+        bounds.ConeAxis = { axis.x, axis.y, axis.z };
+
+        if (minDot > 0.0f) {
+            bounds.ConeCutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+    }
+
+    //Positions and normals are gathered into scratch buffers that are reused across meshlets
+    MeshletBounds GatherMeshletBounds(
+        const MeshletData& meshlets,
+        const Meshlet& meshlet,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        std::vector<Math::Vector3>& positions,
+        std::vector<Math::Vector3>& normals)
+    {
+        MeshletBounds bounds{};
+
+        if (meshlet.NumVertices == 0) {
+            bounds.ConeCutoff = NEVER_BACK_FACING;
+            return bounds;
+        }
+
+        positions.clear();
+        normals.clear();
+
+        for (uint32_t vertex = 0; vertex < meshlet.NumVertices; vertex++) {
+            positions.push_back(LoadMeshletPosition(vertices, vertexStride, meshlets.Vertices[meshlet.VertexOffset + vertex]));
+        }
+
+        for (uint32_t triangle = 0; triangle < meshlet.NumTriangles; triangle++) {
+            const auto* local = &meshlets.Triangles[meshlet.TriangleOffset + triangle * 3];
+            normals.push_back(GetTriangleNormal(positions[local[0]], positions[local[1]], positions[local[2]]));
+        }
+
+        ComputeBoundingSphere(positions, bounds);
+        ComputeNormalCone(normals, bounds);
+        return bounds;
+    }
+
+    class MeshletBuilder {
+    public:
+        MeshletBuilder(std::span<const uint32_t> indices, std::span<const std::byte> vertices, uint32_t vertexStride, const MeshletSettings& settings)
+            :
+            m_indices(indices),
+            m_vertices(vertices),
+            m_vertexStride(vertexStride),
+            m_maxVertices(std::clamp(settings.MaxVertices, 3u, MAX_MESHLET_VERTICES)),
+            m_maxTriangles(std::clamp(settings.MaxTriangles, 1u, MAX_MESHLET_TRIANGLES)),
+            m_coneWeight(settings.ConeWeight),
+            m_numTriangles(static_cast<uint32_t>(indices.size() / 3))
+        {
+            const auto numVertices = static_cast<uint32_t>(vertices.size() / vertexStride);
+
+            m_adjacency = BuildVertexAdjacency(indices.first(size_t{ m_numTriangles } * 3), numVertices);
+            m_meshletOfVertex.assign(numVertices, NO_MESHLET);
+            m_localIndex.resize(numVertices);
+            m_meshletOfCandidate.assign(m_numTriangles, NO_MESHLET);
+            m_isEmitted.assign(m_numTriangles, false);
+            m_normals.resize(m_numTriangles);
+            m_centroids.resize(m_numTriangles);
+            m_numLiveTriangles.resize(numVertices);
+
+            for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+                m_numLiveTriangles[vertex] = static_cast<uint32_t>(m_adjacency.GetTriangles(vertex).size());
+            }
+
+            for (uint32_t triangle = 0; triangle < m_numTriangles; triangle++) {
+                const auto v0 = LoadMeshletPosition(vertices, vertexStride, indices[triangle * 3]);
+                const auto v1 = LoadMeshletPosition(vertices, vertexStride, indices[triangle * 3 + 1]);
+                const auto v2 = LoadMeshletPosition(vertices, vertexStride, indices[triangle * 3 + 2]);
+
+                m_normals[triangle]   = GetTriangleNormal(v0, v1, v2);
+                m_centroids[triangle] = (v0 + v1 + v2) / 3.0f;
+            }
+        }
+
+        [[nodiscard]] MeshletData Build() {
+            //Full meshlets of a well connected mesh, the estimate only avoids most of the reallocations
+            const auto expectedMeshlets = m_numTriangles / m_maxTriangles + 1;
+
+            m_data.Meshlets.reserve(expectedMeshlets);
+            m_data.Bounds.reserve(expectedMeshlets);
+            m_data.Vertices.reserve(size_t{ expectedMeshlets } * m_maxVertices);
+            m_data.Triangles.reserve(size_t{ m_numTriangles } * 3);
+
+            for (uint32_t emitted = 0; emitted < m_numTriangles; emitted++) {
+                auto triangle = m_current.NumTriangles < m_maxTriangles ? FindNextTriangle() : NO_MESHLET_TRIANGLE;
+
+                if (triangle == NO_MESHLET_TRIANGLE) {
+                    FinishMeshlet();
+                    triangle = FindSeed();
+                }
+
+                AddTriangle(triangle);
+            }
+
+            FinishMeshlet();
+            return std::move(m_data);
+        }
+    private:
+        [[nodiscard]] uint32_t CountNewVertices(uint32_t triangle) const noexcept {
+            uint32_t numNew = 0;
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                numNew += m_meshletOfVertex[m_indices[triangle * 3 + corner]] != m_meshletIndex;
+            }
+            return numNew;
+        }
+
+        //Vertices whose last remaining triangle this is would otherwise be left for a later meshlet to load again
+        [[nodiscard]] uint32_t CountClosedVertices(uint32_t triangle) const noexcept {
+            uint32_t numClosed = 0;
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                numClosed += m_numLiveTriangles[m_indices[triangle * 3 + corner]] == 1;
+            }
+            return numClosed;
+        }
+
+        //Cheapest triangle next to the meshlet that still fits, emitted ones are dropped from the candidates on the way
+        [[nodiscard]] uint32_t FindNextTriangle() noexcept {
+            const auto length = std::sqrt(Math::Vector3::Dot(m_normalSum, m_normalSum));
+            const auto axis   = length > 0.0f ? m_normalSum / length : Math::Vector3(0.0f);
+            const auto center = m_centroidSum / static_cast<float>(m_current.NumTriangles);
+
+            auto bestTriangle = NO_MESHLET_TRIANGLE;
+            auto bestCost     = std::numeric_limits<float>::max();
+            size_t numLive    = 0;
+
+            for (const auto triangle : m_candidates) {
+                if (m_isEmitted[triangle]) {
+                    continue;
+                }
+
+                m_candidates[numLive++] = triangle;
+
+                const auto numNew = CountNewVertices(triangle);
+
+                if (m_current.NumVertices + numNew > m_maxVertices) {
+                    continue;
+                }
+
+                //Distance keeps the meshlet round instead of growing into a strip along the cheapest edge
+                const auto offset   = m_centroids[triangle] - center;
+                const auto distance = std::sqrt(Math::Vector3::Dot(offset, offset)) / std::max(m_radius, 1e-20f);
+
+                const auto cost =
+                    static_cast<float>(numNew) - 0.5f * static_cast<float>(CountClosedVertices(triangle)) +
+                    m_coneWeight * (1.0f - Math::Vector3::Dot(m_normals[triangle], axis)) +
+                    DISTANCE_WEIGHT * std::min(distance, 2.0f);
+
+                if (cost < bestCost) {
+                    bestCost     = cost;
+                    bestTriangle = triangle;
+                }
+            }
+
+            m_candidates.resize(numLive);
+            return bestTriangle;
+        }
+
+        //Candidates left over from the last meshlet border it, starting there keeps consecutive meshlets close
+        [[nodiscard]] uint32_t FindSeed() noexcept {
+            for (const auto triangle : m_candidates) {
+                if (!m_isEmitted[triangle]) {
+                    m_candidates.clear();
+                    return triangle;
+                }
+            }
+
+            m_candidates.clear();
+
+            while (m_isEmitted[m_seedCursor]) {
+                m_seedCursor++;
+            }
+            return m_seedCursor;
+        }
+
+        void AddTriangle(uint32_t triangle) {
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                const auto vertex = m_indices[triangle * 3 + corner];
+
+                if (m_meshletOfVertex[vertex] != m_meshletIndex) {
+                    m_meshletOfVertex[vertex] = m_meshletIndex;
+                    m_localIndex[vertex]      = static_cast<uint8_t>(m_current.NumVertices++);
+                    m_data.Vertices.push_back(vertex);
+
+                    for (const auto neighbour : m_adjacency.GetTriangles(vertex)) {
+                        if (!m_isEmitted[neighbour] && m_meshletOfCandidate[neighbour] != m_meshletIndex) {
+                            m_meshletOfCandidate[neighbour] = m_meshletIndex;
+                            m_candidates.push_back(neighbour);
+                        }
+                    }
+                }
+
+                m_data.Triangles.push_back(m_localIndex[vertex]);
+            }
+
+            for (uint32_t corner = 0; corner < 3; corner++) {
+                m_numLiveTriangles[m_indices[triangle * 3 + corner]]--;
+            }
+
+            m_isEmitted[triangle] = true;
+            m_normalSum           = m_normalSum + m_normals[triangle];
+            m_centroidSum         = m_centroidSum + m_centroids[triangle];
+            m_current.NumTriangles++;
+
+            //Radius of the centroids added so far, grown only so it never has to be recomputed
+            const auto offset = m_centroids[triangle] - m_centroidSum / static_cast<float>(m_current.NumTriangles);
+            m_radius          = std::max(m_radius, std::sqrt(Math::Vector3::Dot(offset, offset)));
+        }
+
+        void FinishMeshlet() {
+            if (m_current.NumTriangles == 0) {
+                return;
+            }
+
+            m_data.Meshlets.push_back(m_current);
+            m_data.Bounds.push_back(GatherMeshletBounds(m_data, m_current, m_vertices, m_vertexStride, m_scratchPositions, m_scratchNormals));
+
+            m_meshletIndex++;
+            m_current   = { static_cast<uint32_t>(m_data.Vertices.size()), static_cast<uint32_t>(m_data.Triangles.size()), 0, 0 };
+            m_normalSum   = Math::Vector3(0.0f);
+            m_centroidSum = Math::Vector3(0.0f);
+            m_radius      = 0.0f;
+        }
+
+        std::span<const uint32_t> m_indices;
+        std::span<const std::byte> m_vertices;
+        uint32_t m_vertexStride;
+        uint32_t m_maxVertices;
+        uint32_t m_maxTriangles;
+        float m_coneWeight;
+        uint32_t m_numTriangles;
+
+        VertexAdjacency m_adjacency;
+        std::vector<uint32_t> m_meshletOfVertex;
+        std::vector<uint8_t> m_localIndex;
+        std::vector<uint32_t> m_meshletOfCandidate;
+        std::vector<bool> m_isEmitted;
+        std::vector<Math::Vector3> m_normals;
+        std::vector<Math::Vector3> m_centroids;
+        std::vector<uint32_t> m_numLiveTriangles;
+        std::vector<uint32_t> m_candidates;
+        uint32_t m_seedCursor{ 0 };
+
+        MeshletData m_data;
+        Meshlet m_current{ 0, 0, 0, 0 };
+        uint32_t m_meshletIndex{ 0 };
+        Math::Vector3 m_normalSum{ 0.0f };
+        Math::Vector3 m_centroidSum{ 0.0f };
+        float m_radius{ 0.0f };
+
+        std::vector<Math::Vector3> m_scratchPositions;
+        std::vector<Math::Vector3> m_scratchNormals;
+    };
+}
+
+MeshletData Crystal::BuildMeshlets(std::span<const uint32_t> indices, std::span<const std::byte> vertices, uint32_t vertexStride, const MeshletSettings& settings) {
+    assert(vertexStride >= sizeof(float) * 3);
+
+    if (indices.size() < 3) {
+        return {};
+    }
+    return impl::MeshletBuilder(indices, vertices, vertexStride, settings).Build();
+}
+
+MeshletBounds Crystal::ComputeMeshletBounds(const MeshletData& meshlets, const Meshlet& meshlet, std::span<const std::byte> vertices, uint32_t vertexStride) {
+    std::vector<Math::Vector3> positions, normals;
+    return impl::GatherMeshletBounds(meshlets, meshlet, vertices, vertexStride, positions, normals);
+}
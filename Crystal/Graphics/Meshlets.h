@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    struct MeshletSettings {
+        //Outputs of one mesh shader group, D3D12 allows up to 256 of each
+        uint32_t MaxVertices{ 64 };
+        uint32_t MaxTriangles{ 124 };
+
+        //Cost of a triangle facing away from the meshlet's average normal, relative to the cost of a new vertex. The
+        //cost grows linearly to twice the weight for a triangle facing the opposite way, 0 builds meshlets for vertex reuse only.
+        float ConeWeight{ 0.5f };
+    };
+
+    //Ranges in MeshletData, triangles take three bytes of local vertex indices each
+    struct Meshlet {
+        uint32_t VertexOffset;
+        uint32_t TriangleOffset;
+        uint32_t NumVertices;
+        uint32_t NumTriangles;
+    };
+
+    //Bounding sphere and normal cone of a meshlet. Triangle normals follow cross(v1 - v0, v2 - v0) and point towards
+    //the viewer for front faces. ConeCutoff is the sine of the cone's half angle, it is above 1 when the normals
+    //spread too far for the meshlet to ever be back facing as a whole.
+    struct MeshletBounds {
+        std::array<float, 3> Center;
+        float Radius;
+        std::array<float, 3> ConeAxis;
+        float ConeCutoff;
+    };
+
+    struct MeshletData {
+        std::vector<Meshlet> Meshlets;
+        std::vector<MeshletBounds> Bounds;
+        //Indices into the vertex buffer, listed per meshlet in the order its triangles first use them
+        std::vector<uint32_t> Vertices;
+        std::vector<uint8_t> Triangles;
+    };
+
+    //Greedily grows meshlets over the triangle adjacency, adding the triangle that brings the fewest new vertices and
+    //stays closest to the meshlet's normal until a limit is reached. The next meshlet starts next to the last one.
+    //Expects the output of OptimizeMesh, the first three floats of every vertex have to be its position.
+    [[nodiscard]] MeshletData BuildMeshlets(
+        std::span<const uint32_t> indices,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride,
+        const MeshletSettings& settings = {});
+
+    [[nodiscard]] MeshletBounds ComputeMeshletBounds(
+        const MeshletData& meshlets,
+        const Meshlet& meshlet,
+        std::span<const std::byte> vertices,
+        uint32_t vertexStride);
+}
@@ -0,0 +1,541 @@
+#include "MipGenerator.h"
+#include "Core/InstructionSet/Simd.h"
+#include "Core/Lib/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+using namespace Crystal;
+
+namespace impl {
+    constexpr uint32_t NUM_CHANNELS = 4;
+
+    //Kaiser window in destination texels and its shape, the same values most texture tools default to
+    constexpr double KAISER_RADIUS = 3.0;
+    constexpr double KAISER_ALPHA  = 4.0;
+
+    constexpr uint32_t SRGB_BUCKETS = 4096;
+
+    //Destination rows handed to one ParallelFor index
+    constexpr uint32_t ROWS_PER_TASK = 16;
+
+    //Weights of every destination texel along one axis. Every texel reads NumTaps consecutive source texels from
+    //First on, windows that are shorter are padded with zero weights so both code paths run the same loop.
+    struct AxisTaps {
+        uint32_t NumTaps{ 0 };
+        std::vector<uint32_t> First;
+        std::vector<float> Weights;
+    };
+
+    struct ConversionTables {
+        std::array<float, 256> SRGBToLinear;
+        std::array<float, 256> UNORMToLinear;
+
+        //Linear value at which the encoded sRGB value steps from i to i + 1, the last entry is never reached
+        std::array<float, 256> SRGBThresholds;
+
+        //Encoded value at the start of each of the equally sized buckets the linear range is split into.
+        //Buckets are narrow enough to hold at most one threshold, a single compare finishes the encoding.
+        std::array<int32_t, SRGB_BUCKETS> SRGBBuckets;
+    };
+
+    [[nodiscard]] double DecodeSRGB(double value) noexcept {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    const ConversionTables& GetConversionTables() {
+        static const ConversionTables tables = [] {
+            ConversionTables result{};
+
+            for (uint32_t i = 0; i < 256; i++) {
+                result.SRGBToLinear[i]  = static_cast<float>(DecodeSRGB(i / 255.0));
+                result.UNORMToLinear[i] = static_cast<float>(i / 255.0);
+            }
+
+            //Comparing against the decoded midpoints rounds to the nearest sRGB value without evaluating pow per texel
+            for (uint32_t i = 0; i < 255; i++) {
+                result.SRGBThresholds[i] = static_cast<float>(DecodeSRGB((i + 0.5) / 255.0));
+            }
+            result.SRGBThresholds[255] = FLT_MAX;
+
+            for (uint32_t bucket = 0, index = 0; bucket < SRGB_BUCKETS; bucket++) {
+                const auto start = static_cast<float>(bucket) / SRGB_BUCKETS;
+
+                while (start >= result.SRGBThresholds[index]) {
+                    index++;
+                }
+                result.SRGBBuckets[bucket] = static_cast<int32_t>(index);
+                assert(result.SRGBThresholds[std::min(index + 1, 255u)] >= static_cast<float>(bucket + 1) / SRGB_BUCKETS && "Bucket holds more than one threshold");
+            }
+
+            return result;
+        }();
+        return tables;
+    }
+
+    [[nodiscard]] double BesselI0(double x) noexcept {
+        double sum  = 1.0;
+        double term = 1.0;
+
+        for (int k = 1; k < 32; k++) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum  += term;
+        }
+        return sum;
+    }
+
+    [[nodiscard]] double KaiserSinc(double t) noexcept {
+        const auto window = t / KAISER_RADIUS;
+
+        if (std::abs(window) >= 1.0) {
+            return 0.0;
+        }
+
+        const auto sinc = t == 0.0 ? 1.0 : std::sin(std::numbers::pi * t) / (std::numbers::pi * t);
+        return sinc * BesselI0(KAISER_ALPHA * std::sqrt(1.0 - window * window)) / BesselI0(KAISER_ALPHA);
+    }
+
+    //Texels a destination texel was computed from, weights are divided by Sum
+    struct TexelWindow {
+        double Sum{ 0.0 };
+        int64_t First{ INT64_MAX };
+        int64_t End{ 0 };
+
+        void Add(std::vector<double>& weights, int64_t index, double weight) noexcept {
+            index = std::clamp<int64_t>(index, 0, static_cast<int64_t>(weights.size()) - 1);
+
+            weights[index] += weight;
+            Sum            += weight;
+            First           = std::min(First, index);
+            End             = std::max(End, index + 1);
+        }
+    };
+
+    //Linear filtering with clamped addressing, the way the compute shader samples
+    void AddBilinearSample(std::vector<double>& weights, TexelWindow& window, double position, double weight) {
+        const auto floor = std::floor(position);
+        const auto index = static_cast<int64_t>(floor);
+        const auto frac  = position - floor;
+
+        window.Add(weights, index, (1.0 - frac) * weight);
+        window.Add(weights, index + 1, frac * weight);
+    }
+
+    //Texel centers of the destination mapped into the source as in ComputeMipMaps.hlsl: uv * size - 0.5
+    TexelWindow ComputeTexelWeights(std::vector<double>& weights, uint32_t x, double scale, MipFilter filter) {
+        TexelWindow window;
+
+        if (filter == MipFilter::Box) {
+            //An odd source size is more than 2:1, two samples keep the outer texels from being skipped
+            if (weights.size() & 1) {
+                AddBilinearSample(weights, window, (x + 0.25) * scale - 0.5, 0.5);
+                AddBilinearSample(weights, window, (x + 0.75) * scale - 0.5, 0.5);
+            }
+            else {
+                AddBilinearSample(weights, window, (x + 0.5) * scale - 0.5, 1.0);
+            }
+            return window;
+        }
+
+        const auto center  = (x + 0.5) * scale - 0.5;
+        const auto stretch = std::max(scale, 1.0);
+        const auto support = KAISER_RADIUS * stretch;
+
+        for (auto i = static_cast<int64_t>(std::ceil(center - support)); i <= static_cast<int64_t>(std::floor(center + support)); i++) {
+            window.Add(weights, i, KaiserSinc((i - center) / stretch));
+        }
+        return window;
+    }
+
+    AxisTaps ComputeAxisTaps(uint32_t srcSize, uint32_t dstSize, MipFilter filter) {
+        const auto scale = static_cast<double>(srcSize) / dstSize;
+
+        //Windows are cut to the used texels, all of them get the width of the widest one
+        std::vector<std::vector<double>> windows(dstSize);
+        std::vector<uint32_t> firstTexels(dstSize);
+        std::vector<double> weights(srcSize, 0.0);
+
+        AxisTaps taps;
+
+        for (uint32_t x = 0; x < dstSize; x++) {
+            auto window = ComputeTexelWeights(weights, x, scale, filter);
+
+            //Samples landing exactly on a texel leave zero weights at the border
+            while (window.End - window.First > 1 && weights[window.First] == 0.0) {
+                window.First++;
+            }
+
+            while (window.End - window.First > 1 && weights[window.End - 1] == 0.0) {
+                window.End--;
+            }
+
+            firstTexels[x] = static_cast<uint32_t>(window.First);
+            taps.NumTaps   = std::max(taps.NumTaps, static_cast<uint32_t>(window.End - window.First));
+
+            for (auto i = window.First; i < window.End; i++) {
+                windows[x].push_back(weights[i] / window.Sum);
+            }
+            std::fill(weights.begin() + window.First, weights.begin() + window.End, 0.0);
+        }
+
+        taps.First.resize(dstSize);
+        taps.Weights.resize(size_t{ dstSize } * taps.NumTaps, 0.0f);
+
+        for (uint32_t x = 0; x < dstSize; x++) {
+            //Windows at the right edge are moved left, their weights shift along
+            const auto first  = std::min(firstTexels[x], srcSize - taps.NumTaps);
+            const auto offset = firstTexels[x] - first;
+
+            taps.First[x] = first;
+
+            for (size_t tap = 0; tap < windows[x].size(); tap++) {
+                taps.Weights[size_t{ x } * taps.NumTaps + offset + tap] = static_cast<float>(windows[x][tap]);
+            }
+        }
+        return taps;
+    }
+
+    struct MipJob {
+        //The first mip reads the encoded texels through the decode table, saving a full float copy of the source
+        const float* Source;
+        const uint8_t* EncodedSource;
+        const float* DecodeTable;
+        uint32_t SrcWidth;
+        uint32_t SrcHeight;
+
+        float* Destination;
+        uint8_t* Encoded;
+        uint32_t DstWidth;
+        uint32_t DstHeight;
+
+        const AxisTaps* Horizontal;
+        const AxisTaps* Vertical;
+        bool IsSRGB;
+    };
+
+    //Decoded rows of the encoded first mip, consecutive destination rows share most of their taps so every source row
+    //is decoded once per block. Rows live in slot (row % slots), which holds more rows than a window can span.
+    struct DecodedRowCache {
+        std::vector<float> Texels;
+        std::vector<uint32_t> SlotRows;
+    };
+
+    //Source rows read by destination row y
+    void GetSourceRows(const MipJob& job, uint32_t y, DecodedRowCache& cache, std::vector<const float*>& rows) {
+        const auto rowSize = size_t{ job.SrcWidth } * NUM_CHANNELS;
+        const auto first   = job.Vertical->First[y];
+        const auto numTaps = job.Vertical->NumTaps;
+
+        rows.resize(numTaps);
+
+        if (!job.EncodedSource) {
+            for (uint32_t tap = 0; tap < numTaps; tap++) {
+                rows[tap] = job.Source + (first + tap) * rowSize;
+            }
+            return;
+        }
+
+        const auto numSlots = numTaps + 2;
+
+        if (cache.SlotRows.size() != numSlots) {
+            cache.Texels.resize(numSlots * rowSize);
+            cache.SlotRows.assign(numSlots, UINT32_MAX);
+        }
+
+        for (uint32_t tap = 0; tap < numTaps; tap++) {
+            const auto sourceRow = first + tap;
+            const auto slot      = sourceRow % numSlots;
+            const auto decoded   = cache.Texels.data() + slot * rowSize;
+
+            if (cache.SlotRows[slot] != sourceRow) {
+                const auto encoded = job.EncodedSource + size_t{ sourceRow } * rowSize;
+
+                for (size_t i = 0; i < rowSize; i++) {
+                    decoded[i] = job.DecodeTable[(i % NUM_CHANNELS) * 256 + encoded[i]];
+                }
+                cache.SlotRows[slot] = sourceRow;
+            }
+            rows[tap] = decoded;
+        }
+    }
+
+    //Both paths add the taps in the same order with separate multiplies and adds, which keeps them bit identical
+    void FilterColumnsScalar(const MipJob& job, uint32_t y, std::span<const float* const> rows, float* row) {
+        const auto rowSize = size_t{ job.SrcWidth } * NUM_CHANNELS;
+        const auto weights = &job.Vertical->Weights[size_t{ y } * job.Vertical->NumTaps];
+
+        for (size_t i = 0; i < rowSize; i++) {
+            float sum = weights[0] * rows[0][i];
+
+            for (uint32_t tap = 1; tap < rows.size(); tap++) {
+                sum = sum + weights[tap] * rows[tap][i];
+            }
+            row[i] = sum;
+        }
+    }
+
+    void FilterRowScalar(const MipJob& job, const float* row, float* destination) {
+        const auto numTaps = job.Horizontal->NumTaps;
+
+        for (uint32_t x = 0; x < job.DstWidth; x++) {
+            const auto source  = row + size_t{ job.Horizontal->First[x] } * NUM_CHANNELS;
+            const auto weights = &job.Horizontal->Weights[size_t{ x } * numTaps];
+
+            for (uint32_t channel = 0; channel < NUM_CHANNELS; channel++) {
+                float sum = weights[0] * source[channel];
+
+                for (uint32_t tap = 1; tap < numTaps; tap++) {
+                    sum = sum + weights[tap] * source[tap * NUM_CHANNELS + channel];
+                }
+                destination[x * NUM_CHANNELS + channel] = sum;
+            }
+        }
+    }
+
+    [[nodiscard]] uint8_t EncodeUNORM(float value) noexcept {
+        return static_cast<uint8_t>(static_cast<int32_t>(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f));
+    }
+
+    //The vectorized version gathers the same two entries
+    [[nodiscard]] uint8_t EncodeSRGB(float value) noexcept {
+        const auto& tables = GetConversionTables();
+
+        const auto clamped = std::min(std::max(value, 0.0f), 1.0f);
+        const auto bucket  = std::min(static_cast<int32_t>(clamped * static_cast<float>(SRGB_BUCKETS)), static_cast<int32_t>(SRGB_BUCKETS - 1));
+        const auto index   = tables.SRGBBuckets[bucket];
+
+        return static_cast<uint8_t>(index + (clamped >= tables.SRGBThresholds[index] ? 1 : 0));
+    }
+
+    void EncodeRowScalar(const float* texels, uint8_t* encoded, uint32_t width, bool isSRGB) {
+        for (size_t i = 0; i < size_t{ width } * NUM_CHANNELS; i++) {
+            const bool isAlpha = i % NUM_CHANNELS == 3;
+            encoded[i] = isSRGB && !isAlpha ? EncodeSRGB(texels[i]) : EncodeUNORM(texels[i]);
+        }
+    }
+
+#if CRYSTAL_SIMD_X64
+    CRYSTAL_TARGET_AVX2 void FilterColumnsAvx2(const MipJob& job, uint32_t y, std::span<const float* const> rows, float* row) {
+        const auto rowSize = size_t{ job.SrcWidth } * NUM_CHANNELS;
+        const auto weights = &job.Vertical->Weights[size_t{ y } * job.Vertical->NumTaps];
+
+        size_t i = 0;
+
+        for (; i + 8 <= rowSize; i += 8) {
+            auto sum = _mm256_mul_ps(_mm256_set1_ps(weights[0]), _mm256_loadu_ps(rows[0] + i));
+
+            for (uint32_t tap = 1; tap < rows.size(); tap++) {
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(weights[tap]), _mm256_loadu_ps(rows[tap] + i)));
+            }
+            _mm256_storeu_ps(row + i, sum);
+        }
+
+        //A row of a single texel is all that can be left
+        for (; i < rowSize; i += 4) {
+            auto sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(rows[0] + i));
+
+            for (uint32_t tap = 1; tap < rows.size(); tap++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(rows[tap] + i)));
+            }
+            _mm_storeu_ps(row + i, sum);
+        }
+    }
+
+    //Two destination texels per register, one in each half
+    CRYSTAL_TARGET_AVX2 void FilterRowAvx2(const MipJob& job, const float* row, float* destination) {
+        const auto numTaps = job.Horizontal->NumTaps;
+        const auto& first  = job.Horizontal->First;
+
+        uint32_t x = 0;
+
+        for (; x + 2 <= job.DstWidth; x += 2) {
+            const auto source0  = row + size_t{ first[x] } * NUM_CHANNELS;
+            const auto source1  = row + size_t{ first[x + 1] } * NUM_CHANNELS;
+            const auto weights0 = &job.Horizontal->Weights[size_t{ x } * numTaps];
+            const auto weights1 = weights0 + numTaps;
+
+            auto sum = _mm256_mul_ps(
+                _mm256_setr_m128(_mm_set1_ps(weights0[0]), _mm_set1_ps(weights1[0])),
+                _mm256_loadu2_m128(source1, source0));
+
+            for (uint32_t tap = 1; tap < numTaps; tap++) {
+                const auto weights = _mm256_setr_m128(_mm_set1_ps(weights0[tap]), _mm_set1_ps(weights1[tap]));
+                const auto texels  = _mm256_loadu2_m128(source1 + tap * NUM_CHANNELS, source0 + tap * NUM_CHANNELS);
+
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(weights, texels));
+            }
+            _mm256_storeu_ps(destination + size_t{ x } * NUM_CHANNELS, sum);
+        }
+
+        if (x < job.DstWidth) {
+            const auto source  = row + size_t{ first[x] } * NUM_CHANNELS;
+            const auto weights = &job.Horizontal->Weights[size_t{ x } * numTaps];
+
+            auto sum = _mm_mul_ps(_mm_set1_ps(weights[0]), _mm_loadu_ps(source));
+
+            for (uint32_t tap = 1; tap < numTaps; tap++) {
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(weights[tap]), _mm_loadu_ps(source + tap * NUM_CHANNELS)));
+            }
+            _mm_storeu_ps(destination + size_t{ x } * NUM_CHANNELS, sum);
+        }
+    }
+
+    //Two texels per register, the alpha lanes always take the UNORM encoding
+    CRYSTAL_TARGET_AVX2 void EncodeRowAvx2(const float* texels, uint8_t* encoded, uint32_t width, bool isSRGB) {
+        const auto& tables   = GetConversionTables();
+        const auto numValues = size_t{ width } * NUM_CHANNELS;
+
+        const auto zero       = _mm256_setzero_ps();
+        const auto one        = _mm256_set1_ps(1.0f);
+        const auto scale      = _mm256_set1_ps(255.0f);
+        const auto half       = _mm256_set1_ps(0.5f);
+        const auto buckets    = _mm256_set1_ps(static_cast<float>(SRGB_BUCKETS));
+        const auto lastBucket = _mm256_set1_epi32(SRGB_BUCKETS - 1);
+        const auto alphaMask  = _mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1);
+
+        size_t i = 0;
+
+        for (; i + 8 <= numValues; i += 8) {
+            const auto clamped = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(texels + i), zero), one);
+            auto result        = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(clamped, scale), half));
+
+            if (isSRGB) {
+                const auto bucket  = _mm256_min_epi32(_mm256_cvttps_epi32(_mm256_mul_ps(clamped, buckets)), lastBucket);
+                const auto index   = _mm256_i32gather_epi32(tables.SRGBBuckets.data(), bucket, 4);
+
+                const auto threshold = _mm256_i32gather_ps(tables.SRGBThresholds.data(), index, 4);
+                const auto isAbove   = _mm256_castps_si256(_mm256_cmp_ps(clamped, threshold, _CMP_GE_OQ));
+
+                //The mask is -1 where the threshold was reached
+                result = _mm256_blendv_epi8(_mm256_sub_epi32(index, isAbove), result, alphaMask);
+            }
+
+            const auto words = _mm_packus_epi32(_mm256_castsi256_si128(result), _mm256_extracti128_si256(result, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(encoded + i), _mm_packus_epi16(words, words));
+        }
+
+        EncodeRowScalar(texels + i, encoded + i, static_cast<uint32_t>((numValues - i) / NUM_CHANNELS), isSRGB);
+    }
+#endif
+
+    void GenerateRows(const MipJob& job, uint32_t firstRow, uint32_t lastRow, bool useAvx2) {
+        std::vector<float> row(size_t{ job.SrcWidth } * NUM_CHANNELS);
+        DecodedRowCache decodedRows;
+        std::vector<const float*> rows;
+
+        for (uint32_t y = firstRow; y < lastRow; y++) {
+            auto destination = job.Destination + size_t{ y } * job.DstWidth * NUM_CHANNELS;
+            auto encoded     = job.Encoded + size_t{ y } * job.DstWidth * NUM_CHANNELS;
+
+            GetSourceRows(job, y, decodedRows, rows);
+
+#if CRYSTAL_SIMD_X64
+            if (useAvx2) {
+                FilterColumnsAvx2(job, y, rows, row.data());
+                FilterRowAvx2(job, row.data(), destination);
+                EncodeRowAvx2(destination, encoded, job.DstWidth, job.IsSRGB);
+                continue;
+            }
+#endif
+            FilterColumnsScalar(job, y, rows, row.data());
+            FilterRowScalar(job, row.data(), destination);
+            EncodeRowScalar(destination, encoded, job.DstWidth, job.IsSRGB);
+        }
+    }
+}
+
+MipChain Crystal::GenerateMips(
+    std::span<const uint8_t> texels,
+    uint32_t width,
+    uint32_t height,
+    const MipGeneratorSettings& settings,
+    ThreadPool* threadPool)
+{
+    assert(texels.size() >= size_t{ width } * height * impl::NUM_CHANNELS && "Source image is smaller than its size");
+
+    const auto maxMips = GetNumMips(width, height);
+    const auto numMips = settings.NumMips == 0 ? maxMips : std::min(settings.NumMips, maxMips);
+    const bool useAvx2 = settings.AllowSimd && HasAvx2();
+
+    MipChain mipChain;
+    mipChain.Levels.reserve(numMips);
+
+    uint64_t sizeInBytes = 0;
+
+    for (uint32_t mip = 0, mipWidth = width, mipHeight = height; mip < numMips; mip++) {
+        mipChain.Levels.push_back({ mipWidth, mipHeight, sizeInBytes });
+        sizeInBytes += uint64_t{ mipWidth } * mipHeight * impl::NUM_CHANNELS;
+
+        mipWidth  = std::max(mipWidth >> 1, 1u);
+        mipHeight = std::max(mipHeight >> 1, 1u);
+    }
+
+    mipChain.Data.resize(sizeInBytes);
+    std::copy_n(texels.data(), size_t{ width } * height * impl::NUM_CHANNELS, mipChain.Data.data());
+
+    if (numMips == 1) {
+        return mipChain;
+    }
+
+    //Filtering happens on linear floats, only the stored mips are quantized. The source is decoded while the first
+    //mip is filtered, every further mip reads the unquantized floats of the one before.
+    const auto& tables = impl::GetConversionTables();
+
+    const auto& colorTable = settings.IsSRGB ? tables.SRGBToLinear : tables.UNORMToLinear;
+
+    std::array<float, 256 * impl::NUM_CHANNELS> decodeTable;
+    std::ranges::copy(colorTable, decodeTable.begin());
+    std::ranges::copy(colorTable, decodeTable.begin() + 256);
+    std::ranges::copy(colorTable, decodeTable.begin() + 512);
+    std::ranges::copy(tables.UNORMToLinear, decodeTable.begin() + 768);
+
+    std::vector<float> source;
+    std::vector<float> destination;
+
+    for (uint32_t mip = 1; mip < numMips; mip++) {
+        const auto& srcLevel = mipChain.Levels[mip - 1];
+        const auto& dstLevel = mipChain.Levels[mip];
+
+        const auto horizontal = impl::ComputeAxisTaps(srcLevel.Width, dstLevel.Width, settings.Filter);
+        const auto vertical   = impl::ComputeAxisTaps(srcLevel.Height, dstLevel.Height, settings.Filter);
+
+        destination.resize(size_t{ dstLevel.Width } * dstLevel.Height * impl::NUM_CHANNELS);
+
+        const impl::MipJob job{
+            .Source        = source.data(),
+            .EncodedSource = mip == 1 ? texels.data() : nullptr,
+            .DecodeTable   = decodeTable.data(),
+            .SrcWidth      = srcLevel.Width,
+            .SrcHeight     = srcLevel.Height,
+            .Destination   = destination.data(),
+            .Encoded       = mipChain.Data.data() + dstLevel.Offset,
+            .DstWidth      = dstLevel.Width,
+            .DstHeight     = dstLevel.Height,
+            .Horizontal    = &horizontal,
+            .Vertical      = &vertical,
+            .IsSRGB        = settings.IsSRGB
+        };
+
+        const auto numTasks = (dstLevel.Height + impl::ROWS_PER_TASK - 1) / impl::ROWS_PER_TASK;
+
+        //Small mips are not worth waking the workers for
+        if (threadPool && numTasks > 1) {
+            threadPool->ParallelFor(numTasks, [&](size_t task) {
+                const auto firstRow = static_cast<uint32_t>(task) * impl::ROWS_PER_TASK;
+                impl::GenerateRows(job, firstRow, std::min(firstRow + impl::ROWS_PER_TASK, dstLevel.Height), useAvx2);
+            });
+        }
+        else {
+            impl::GenerateRows(job, 0, dstLevel.Height, useAvx2);
+        }
+
+        std::swap(source, destination);
+    }
+    return mipChain;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crystal {
+    class ThreadPool;
+
+    enum class MipFilter : uint8_t {
+        //Same taps as ComputeMipMaps.hlsl: a 2x2 box, odd sizes take two bilinear samples per axis so no texel is skipped
+        Box,
+        //Kaiser windowed sinc over three destination texels, sharper than the box at the cost of slight ringing
+        Kaiser
+    };
+
+    struct MipGeneratorSettings {
+        MipFilter Filter{ MipFilter::Box };
+
+        //Texels are decoded to linear before filtering and encoded again afterwards, alpha is always linear
+        bool IsSRGB{ false };
+
+        //0 generates the full chain down to 1x1
+        uint32_t NumMips{ 0 };
+
+        //Off runs the scalar path, which the vectorized one has to match bit for bit
+        bool AllowSimd{ true };
+    };
+
+    struct MipLevel {
+        uint32_t Width;
+        uint32_t Height;
+
+        //Byte offset into MipChain::Data, rows are tightly packed
+        uint64_t Offset;
+    };
+
+    //RGBA8 texels of every mip, mip 0 is a copy of the source
+    struct MipChain {
+        std::vector<MipLevel> Levels;
+        std::vector<uint8_t> Data;
+
+        [[nodiscard]] std::span<const uint8_t> GetTexels(uint32_t mip) const noexcept {
+            const auto& level = Levels[mip];
+            return { Data.data() + level.Offset, size_t{ level.Width } * level.Height * 4 };
+        }
+    };
+
+    [[nodiscard]] constexpr uint32_t GetNumMips(uint32_t width, uint32_t height) noexcept {
+        uint32_t numMips = 1;
+
+        while (width > 1 || height > 1) {
+            width  = width > 1 ? width >> 1 : 1;
+            height = height > 1 ? height >> 1 : 1;
+            numMips++;
+        }
+        return numMips;
+    }
+
+    //Builds the mip chain of a 2D RGBA8 texture on the CPU, for cooking assets offline and for formats the compute
+    //pass cannot write, such as sRGB. Every mip is filtered from the unquantized previous one, rows are split across
+    //the thread pool when one is given. Uses AVX2 when the processor supports it.
+    [[nodiscard]] MipChain GenerateMips(
+        std::span<const uint8_t> texels,
+        uint32_t width,
+        uint32_t height,
+        const MipGeneratorSettings& settings = {},
+        ThreadPool* threadPool = nullptr);
+}
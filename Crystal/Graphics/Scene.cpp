@@ -1,201 +1,669 @@
 #include "Scene.h"
+#include "CookedMesh.h"
+#include "GlbFile.h"
 #include "Mesh.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "Meshlets.h"
 #include "Core/FileSystem/FileSystem.h"
-#include "assimp/Exporter.hpp"
+#include "Core/FileSystem/ImportCache.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Lib/ThreadPool.h"
+#include "Core/Logging/Logger.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "assimp/DefaultIOSystem.h"
 #include "assimp/Importer.hpp"
 #include "assimp/postprocess.h"
 #include "RHI/RHICore.h"
-#include "RHI/VertexTypes.h"
 #include "RHI/D3D12/Managers/TextureManager.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
+#include <cctype>
+#include <format>
+#include <tuple>
+#include <unordered_set>
 
 using namespace Crystal;
 
-bool Scene::LoadSceneFromFile(CommandContext& ctx, std::string_view fileName) {
+namespace impl {
+    [[nodiscard]] std::array<float, 4> ToCookedColor(const aiColor4D& color) noexcept {
+        return { color.r, color.g, color.b, color.a };
+    }
+
+    [[nodiscard]] Math::Vector4 ToColor(const std::array<float, 4>& color) noexcept {
+        return { color[0], color[1], color[2], color[3] };
+    }
+
+    ThreadPool& GetImportThreadPool() {
+        static ThreadPool threadPool;
+        return threadPool;
+    }
+
+    ImportCache& GetImportCache() {
+        static ImportCache importCache(FileSystem::Append(FileSystem::GetWorkingDirectory(), "Cache/Imports"));
+        return importCache;
+    }
+
+    //Everything that changes the cooked output besides the source files themselves
+    constexpr float SMOOTHING_ANGLE           = 80.0f;
+    constexpr int REMOVED_PRIMITIVES          = aiPrimitiveType_POINT | aiPrimitiveType_LINE;
+    constexpr unsigned int PRE_PROCESS_FLAGS  =
+        aiProcessPreset_TargetRealtime_MaxQuality |
+        aiProcess_OptimizeGraph |
+        aiProcess_ConvertToLeftHanded;
+
+    //Welding on top of assimp's JoinIdenticalVertices merges corners that differ only by rounding
+    constexpr MeshOptimizerSettings MESH_OPTIMIZER_SETTINGS{};
+    constexpr MeshletSettings MESHLET_SETTINGS{};
+
+    //Weights of the floats after the position in Vertex: the normal and texture coordinate, tangents follow the normal
+    constexpr std::array<float, 12> LOD_ATTRIBUTE_WEIGHTS{ 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f };
+    constexpr MeshSimplifierSettings MESH_SIMPLIFIER_SETTINGS{ .AttributeWeights = LOD_ATTRIBUTE_WEIGHTS };
+
+    //Bumped when the binary glTF reader changes its output, scenes it cooked are imported again
+    constexpr uint32_t GLB_READER_VERSION = 2;
+
+    [[nodiscard]] constexpr uint64_t GetImportSettingsHash(VertexLayout layout) noexcept {
+        auto hash = HashCombine(0, PRE_PROCESS_FLAGS);
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(SMOOTHING_ANGLE));
+        hash = HashCombine(hash, static_cast<uint64_t>(REMOVED_PRIMITIVES));
+        hash = HashCombine(hash, static_cast<uint64_t>(MESH_OPTIMIZER_SETTINGS.Ordering));
+        hash = HashCombine(hash, MESH_OPTIMIZER_SETTINGS.CacheSize);
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_OPTIMIZER_SETTINGS.OverdrawThreshold));
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_OPTIMIZER_SETTINGS.PositionTolerance));
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_OPTIMIZER_SETTINGS.AttributeTolerance));
+        hash = HashCombine(hash, MESHLET_SETTINGS.MaxVertices);
+        hash = HashCombine(hash, MESHLET_SETTINGS.MaxTriangles);
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESHLET_SETTINGS.ConeWeight));
+        hash = HashCombine(hash, MESH_SIMPLIFIER_SETTINGS.MaxLevels);
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_SIMPLIFIER_SETTINGS.TriangleRatio));
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_SIMPLIFIER_SETTINGS.MaxTriangleRatio));
+        hash = HashCombine(hash, std::bit_cast<uint32_t>(MESH_SIMPLIFIER_SETTINGS.MaxError));
+        hash = HashCombine(hash, static_cast<uint64_t>(MESH_SIMPLIFIER_SETTINGS.LockBorder));
+
+        for (const auto weight : LOD_ATTRIBUTE_WEIGHTS) {
+            hash = HashCombine(hash, std::bit_cast<uint32_t>(weight));
+        }
+
+        hash = HashCombine(hash, GLB_READER_VERSION);
+        hash = HashCombine(hash, CookedMeshFormat::VERSION);
+        hash = HashCombine(hash, static_cast<uint64_t>(layout));
+        return HashCombine(hash, GetVertexStride(layout));
+    }
+
+    //Records every file assimp reads, e.g. the .mtl next to an .obj, these are dependencies of the import as well
+    class RecordingIOSystem : public Assimp::DefaultIOSystem {
+    public:
+        explicit RecordingIOSystem(std::vector<std::string>& openedFiles)
+            :
+            m_openedFiles(openedFiles)
+        {}
+
+        Assimp::IOStream* Open(const char* file, const char* mode) override {
+            auto* stream = DefaultIOSystem::Open(file, mode);
+
+            if (stream) {
+                m_openedFiles.emplace_back(file);
+            }
+            return stream;
+        }
+    private:
+        std::vector<std::string>& m_openedFiles;
+    };
+
+    struct TextureRequest {
+        StringId FilePath;
+        bool sRGB;
+    };
+
+    void CookVertices(const aiMesh& assimpMesh, std::vector<Vertex>& vertices) {
+        vertices.resize(assimpMesh.mNumVertices);
+
+        if (assimpMesh.HasPositions()) [[likely]] {
+            for (uint32_t i = 0; i < assimpMesh.mNumVertices; i++) {
+                vertices[i].Position = reinterpret_cast<Math::Vector3&>(assimpMesh.mVertices[i]);
+            }
+        }
+
+        if (assimpMesh.HasNormals()) {
+            for (uint32_t i = 0; i < assimpMesh.mNumVertices; i++) {
+                vertices[i].Normal = reinterpret_cast<Math::Vector3&>(assimpMesh.mNormals[i]);
+            }
+        }
+
+        if (assimpMesh.HasTangentsAndBitangents()) {
+            for (uint32_t i = 0; i < assimpMesh.mNumVertices; i++) {
+                vertices[i].Tangent   = reinterpret_cast<Math::Vector3&>(assimpMesh.mTangents[i]);
+                vertices[i].Bitangent = reinterpret_cast<Math::Vector3&>(assimpMesh.mBitangents[i]);
+            }
+        }
+
+        if (assimpMesh.HasTextureCoords(0)) {
+            for (uint32_t i = 0; i < assimpMesh.mNumVertices; i++) {
+                vertices[i].TexCoord = reinterpret_cast<Math::Vector3&>(assimpMesh.mTextureCoords[0][i]);
+            }
+        }
+    }
+
+    void CookIndices(const aiMesh& assimpMesh, std::vector<uint32_t>& indices) {
+        indices.reserve(static_cast<size_t>(assimpMesh.mNumFaces) * 3);
+
+        for (uint32_t i = 0; i < assimpMesh.mNumFaces; i++) {
+            const auto& face = assimpMesh.mFaces[i];
+
+            // Only extract triangular faces
+            if (face.mNumIndices == 3) {
+                indices.emplace_back(face.mIndices[0]);
+                indices.emplace_back(face.mIndices[1]);
+                indices.emplace_back(face.mIndices[2]);
+            }
+        }
+    }
+
+    //Transformed vertices and triangles summed over every mesh of the scene
+    void LogMeshOptimization(std::string_view fileName, std::span<const MeshOptimizationReport> reports) {
+        uint64_t transformedBefore = 0, transformedAfter = 0;
+        uint64_t trianglesBefore   = 0, trianglesAfter   = 0;
+        uint64_t verticesBefore    = 0, verticesAfter    = 0;
+
+        for (const auto& report : reports) {
+            transformedBefore += report.Before.VerticesTransformed;
+            transformedAfter  += report.After.VerticesTransformed;
+            trianglesBefore   += report.NumTrianglesBefore;
+            trianglesAfter    += report.NumTrianglesAfter;
+            verticesBefore    += report.NumVerticesBefore;
+            verticesAfter     += report.NumVerticesAfter;
+        }
+
+        if (trianglesAfter == 0) {
+            return;
+        }
+
+        Logger::Info("Optimized {}: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+            fileName,
+            verticesBefore, verticesAfter,
+            static_cast<double>(transformedBefore) / trianglesBefore, static_cast<double>(transformedAfter) / trianglesAfter,
+            static_cast<double>(transformedBefore) / verticesBefore, static_cast<double>(transformedAfter) / verticesAfter);
+    }
+
+    //Triangles and the largest error per level summed over every mesh, meshes with shorter chains stop contributing
+    void LogLodGeneration(std::string_view fileName, std::span<const MeshOptimizationReport> reports, std::span<const LodChain> lods) {
+        std::vector<uint64_t> triangles{ 0 };
+        std::vector<float> errors{ 0.0f };
+
+        for (size_t mesh = 0; mesh < lods.size(); mesh++) {
+            triangles[0] += reports[mesh].NumTrianglesAfter;
+
+            for (size_t level = 0; level < lods[mesh].Levels.size(); level++) {
+                if (level + 1 == triangles.size()) {
+                    triangles.push_back(0);
+                    errors.push_back(0.0f);
+                }
+
+                triangles[level + 1] += lods[mesh].Levels[level].NumIndices / 3;
+                errors[level + 1]     = std::max(errors[level + 1], lods[mesh].Levels[level].Error);
+            }
+        }
+
+        if (triangles[0] == 0 || triangles.size() == 1) {
+            return;
+        }
+
+        std::string levels;
+
+        for (size_t level = 1; level < triangles.size(); level++) {
+            levels += std::format(", LOD{} {} ({:.1f}%, error {:.2e})",
+                level, triangles[level], 100.0 * static_cast<double>(triangles[level]) / triangles[0], errors[level]);
+        }
+
+        Logger::Info("Simplified {}: LOD0 {} triangles{}", fileName, triangles[0], levels);
+    }
+
+    //Needs both vertices and indices of a mesh, so it runs once every mesh is cooked. Meshlets are built on the
+    //optimized order so they pick up its locality. Levels of detail share the optimized vertices, only their
+    //triangles are ordered for the vertex cache again.
+    void CookSubmeshes(
+        CookedMeshWriter& writer,
+        std::string_view fileName,
+        VertexLayout layout,
+        std::vector<std::vector<Vertex>>& vertices,
+        std::vector<std::vector<uint32_t>>& indices,
+        std::span<const uint32_t> materialIndices)
+    {
+        const auto numMeshes = vertices.size();
+
+        std::vector<MeshOptimizationReport> reports(numMeshes);
+        std::vector<MeshletData> meshlets(numMeshes);
+        std::vector<LodChain> lods(numMeshes);
+
+        GetImportThreadPool().ParallelFor(numMeshes, [&](size_t mesh) {
+            reports[mesh] = OptimizeMesh(std::as_writable_bytes(std::span(vertices[mesh])), sizeof(Vertex), indices[mesh], MESH_OPTIMIZER_SETTINGS);
+            vertices[mesh].resize(reports[mesh].NumVerticesAfter);
+
+            const auto vertexData = std::as_bytes(std::span(vertices[mesh]));
+
+            meshlets[mesh] = BuildMeshlets(indices[mesh], vertexData, sizeof(Vertex), MESHLET_SETTINGS);
+            lods[mesh]     = GenerateLodChain(indices[mesh], vertexData, sizeof(Vertex), MESH_SIMPLIFIER_SETTINGS);
+
+            for (const auto& lod : lods[mesh].Levels) {
+                const auto levelIndices = std::span(lods[mesh].Indices).subspan(lod.FirstIndex, lod.NumIndices);
+                OptimizeVertexCache(levelIndices, static_cast<uint32_t>(vertices[mesh].size()), MESH_OPTIMIZER_SETTINGS.Ordering, MESH_OPTIMIZER_SETTINGS.CacheSize);
+            }
+        });
+
+        LogMeshOptimization(fileName, reports);
+        LogLodGeneration(fileName, reports, lods);
+
+        //Bounds come from the full precision positions, quantized positions are relative to them
+        std::vector<std::byte> convertedVertices;
+
+        for (size_t mesh = 0; mesh < numMeshes; mesh++) {
+            const auto bounds = ComputePositionBounds(vertices[mesh]);
+
+            convertedVertices.resize(vertices[mesh].size() * GetVertexStride(layout));
+            ConvertVertices(vertices[mesh], layout, bounds, convertedVertices);
+
+            writer.AddSubmesh(convertedVertices, indices[mesh], materialIndices[mesh], bounds, meshlets[mesh], lods[mesh]);
+        }
+    }
+
+    [[nodiscard]] bool IsGlbFile(std::string_view fileName) {
+        auto extension = FileSystem::GetExtensionFromFilePath(fileName);
+        std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return extension == ".glb";
+    }
+
+    //Metallic roughness mapped onto the material model the way assimp's glTF importer does it: the base color is the
+    //diffuse color and roughness becomes a specular power
+    [[nodiscard]] CookedMaterial CookGltfMaterial(
+        CookedMeshWriter& writer,
+        const GltfMaterial& gltfMaterial,
+        std::span<const GltfImage> images,
+        std::string_view parentPath,
+        std::vector<std::string>& dependencies)
+    {
+        const auto [r, g, b, a] = gltfMaterial.BaseColorFactor;
+        const auto smoothness   = 1.0f - gltfMaterial.RoughnessFactor;
+
+        CookedMaterial material{
+            .Name          = writer.AddString(gltfMaterial.Name),
+            .Diffuse       = { r, g, b, a },
+            .Emissive      = { gltfMaterial.EmissiveFactor[0], gltfMaterial.EmissiveFactor[1], gltfMaterial.EmissiveFactor[2], 1.0f },
+            .Opacity       = a,
+            .SpecularPower = smoothness * smoothness * 1000.0f,
+            .BumpIntensity = gltfMaterial.NormalScale
+        };
+
+        const std::array<std::tuple<Material::TextureID, uint32_t, bool>, 3> textures{
+            {
+                { Material::TextureID::Diffuse,  gltfMaterial.BaseColorTexture, true  },
+                { Material::TextureID::Emissive, gltfMaterial.EmissiveTexture,  true  },
+                { Material::TextureID::Normal,   gltfMaterial.NormalTexture,    false }
+            }
+        };
+
+        for (const auto [textureId, image, make_sRGB] : textures) {
+            if (image == GltfFormat::NO_INDEX) {
+                continue;
+            }
+
+            //Embedded images have no path, assimp hands them out as "*index" which does not load either
+            if (images[image].IsEmbedded) {
+                Logger::Warning("Skipped embedded image {} of material {}", image, gltfMaterial.Name);
+                continue;
+            }
+
+            const auto slot = static_cast<uint32_t>(textureId);
+
+            material.Textures[slot]  = writer.AddString(images[image].Uri);
+            material.SRGBTextureMask |= static_cast<uint32_t>(make_sRGB) << slot;
+
+            dependencies.push_back(FileSystem::Append(parentPath, images[image].Uri));
+        }
+        return material;
+    }
+}
+
+bool Scene::LoadSceneFromFile(CommandContext& ctx, std::string_view fileName, VertexLayout layout) {
+    ScopedMemoryTag memoryTag(MemoryTag::Scene);
+
     const auto parentPath = FileSystem::HasParentPath(fileName)
         ? FileSystem::GetParentDirectory(fileName)
         : FileSystem::GetWorkingDirectory();
 
-    if (const auto scene = PreProcess(fileName)) {
-        ImportScene(ctx, *scene.value(), parentPath);
+    //Cooked scenes are found by content, a changed source, dependency or import setting leads to a different or invalidated entry
+    auto& importCache = impl::GetImportCache();
+
+    const auto key = importCache.ComputeKey(fileName, impl::GetImportSettingsHash(layout));
+
+    if (!key) [[unlikely]] {
+        return false;
+    }
+
+    std::optional<CookedMesh> cookedMesh;
+
+    if (const auto cookedPath = importCache.Find(*key)) {
+        cookedMesh = CookedMesh::Open(*cookedPath);
+    }
+
+    const auto isLayoutCooked = [&] {
+        const auto& header = cookedMesh->GetHeader();
+        return header.VertexLayout == static_cast<uint32_t>(layout) && header.VertexStride == GetVertexStride(layout);
+    };
+
+    //A missing or truncated cooked file is rebuilt from the source
+    if (!cookedMesh || !isLayoutCooked()) {
+        std::vector<std::string> dependencies;
+
+        //The stale mapping has to be closed before the artifact can be replaced on Windows
+        cookedMesh.reset();
+
+        const auto stagingPath = importCache.GetStagingPath(*key);
+
+        if (!CookScene(fileName, stagingPath, parentPath, layout, dependencies)) {
+            return false;
+        }
+
+        if (const auto cookedPath = importCache.Commit(*key, stagingPath, dependencies)) {
+            cookedMesh = CookedMesh::Open(*cookedPath);
+        }
+    }
+
+    if (cookedMesh) [[likely]] {
+        ImportScene(ctx, *cookedMesh, parentPath);
         return true;
     }
     return false;
 }
 
-void Scene::ImportScene(CommandContext& ctx, const aiScene& scene, std::string_view parentPath) {
+void Scene::ImportScene(CommandContext& ctx, const CookedMesh& cookedMesh, std::string_view parentPath) {
     m_materials.clear();
     m_meshes.clear();
 
-    for (auto i = 0u; i < scene.mNumMaterials; i++) {
-        ImportMaterial(ctx, *(scene.mMaterials[i]), parentPath);
+    //Every texture that is not cached yet is decoded once, listed in the order it is first referenced
+    std::vector<impl::TextureRequest> textureRequests;
+    std::unordered_set<StringId> requestedPaths;
+
+    for (const auto& material : cookedMesh.GetMaterials()) {
+        for (uint32_t slot = 0; slot < CookedMeshFormat::NUM_TEXTURE_SLOTS; slot++) {
+            const auto texturePath = cookedMesh.GetString(material.Textures[slot]);
+
+            if (texturePath.empty()) {
+                continue;
+            }
+
+            const auto filePath = StringId::Intern(FileSystem::Append(parentPath, texturePath));
+
+            if (requestedPaths.insert(filePath).second && !TextureManager::IsCached(filePath)) {
+                textureRequests.push_back({ filePath, static_cast<bool>((material.SRGBTextureMask >> slot) & 1) });
+            }
+        }
+    }
+
+    std::vector<DecodedTexture> decodedTextures(textureRequests.size());
+
+    impl::GetImportThreadPool().ParallelFor(textureRequests.size(), [&](size_t index) {
+        const auto& [filePath, sRGB] = textureRequests[index];
+        decodedTextures[index] = TextureManager::DecodeTextureFromFile(filePath, sRGB);
+    });
+
+    //Single upload stage, recorded in file order so the result does not depend on which thread finished first
+    std::unordered_map<StringId, std::unique_ptr<Texture>> uploadedTextures;
+
+    for (auto& decodedTexture : decodedTextures) {
+        const auto filePath = decodedTexture.FilePath;
+        uploadedTextures.emplace(filePath, TextureManager::UploadTexture(ctx, std::move(decodedTexture)));
+    }
+
+    for (const auto& material : cookedMesh.GetMaterials()) {
+        ImportMaterial(ctx, cookedMesh, material, parentPath, uploadedTextures);
     }
 
-    for (auto i = 0u; i < scene.mNumMeshes; i++) {
-        ImportMesh(ctx, *(scene.mMeshes[i]));
+    for (const auto& submesh : cookedMesh.GetSubmeshes()) {
+        ImportMesh(ctx, cookedMesh, submesh);
     }
 }
 
-void Scene::ImportMesh(CommandContext& ctx, const aiMesh& assimpMesh) {
-    m_meshes.clear();
-    auto mesh = std::make_unique<Mesh>();
+//Vertices and indices are copied from the mapping straight into upload memory
+void Scene::ImportMesh(CommandContext& ctx, const CookedMesh& cookedMesh, const CookedSubmesh& submesh) {
+    auto mesh = MakePooled<Mesh>();
 
-    ProcessVertices(ctx, *mesh, assimpMesh);
-    ProcessIndices(ctx, *mesh, assimpMesh);
+    const auto vertices = cookedMesh.GetVertexData(submesh);
+    const auto indices  = cookedMesh.GetIndices(submesh);
 
-    m_meshes.emplace_back(std::move(mesh));
-}
+    const BufferDescription vbd = {
+        .Count  = submesh.NumVertices,
+        .Stride = cookedMesh.GetHeader().VertexStride
+    };
 
-void Scene::ImportMaterial(CommandContext& ctx, const aiMaterial& aiMat, std::string_view parentPath) noexcept {
-    auto material = std::make_unique<Material>();
+    auto vertexBuffer = std::make_unique<Buffer>(vbd);
+    ctx.CopyBuffer(*vertexBuffer, vertices);
+    mesh->SetVertexBuffer(0, std::move(vertexBuffer));
 
-    SetMaterials(*material, aiMat);
-    LoadTextures(ctx, *material, aiMat, parentPath);
+    const auto layout = static_cast<VertexLayout>(cookedMesh.GetHeader().VertexLayout);
+    mesh->SetVertexLayout(layout, GetPositionDequantization(submesh.Bounds, layout));
 
-    m_materials.emplace_back(std::move(material));
-}
+    const auto lods = cookedMesh.GetLods(submesh);
+    mesh->SetLods({ lods.begin(), lods.end() });
 
-void Scene::SetMaterials(Material& material, const aiMaterial& assimpMaterial) const noexcept {
-    aiColor4D color{};
-    float value{};
+    if (!indices.empty()) [[likely]] {
+        const BufferDescription ibd = {
+            .Count  = submesh.NumIndices,
+            .Stride = sizeof(uint32_t),
+            .Format = IndexFormat_t::uint_32
+        };
 
-    for (const auto& [spec, func] : m_materialFunctionMap) {
-        if (spec.Unit == detail::MaterialUnit::Vec4) {
-            if (assimpMaterial.Get(spec.Key.data(), spec.Type, spec.Id, color) == aiReturn_SUCCESS) {
-                (material.*func.ColorFuncPtr)(reinterpret_cast<Math::Vector4&>(color));
-            }
-        }
-        else if (spec.Unit == detail::MaterialUnit::Float) {
-            if (assimpMaterial.Get(spec.Key.data(), spec.Type, spec.Id, value) == aiReturn_SUCCESS) {
-                //Special case when MaterialType is Reflectivity
-                if (spec.Key.compare("$mat.reflectivity") == 0) [[unlikely]] {
-                    (material.*func.ColorFuncPtr)({ value });
-                }
-                else {
-                    (material.*func.ValueFuncPtr)(value);
-                }
-            }
-        }
+        auto indexBuffer = std::make_unique<Buffer>(ibd);
+        ctx.CopyBuffer(*indexBuffer, std::as_bytes(indices));
+        mesh->SetIndexBuffer(std::move(indexBuffer));
     }
+
+    m_meshes.emplace_back(std::move(mesh));
 }
 
-void Scene::LoadTextures(CommandContext& ctx, Material& material, const aiMaterial& assimpMaterial, std::string_view parentPath) const noexcept {
-    aiString aiTexturePath;
-    aiTextureOp aiBlendOperation;
-    float blendFactor;
-
-    const auto hasTexture = [&](aiTextureType textureType) {
-        return assimpMaterial.GetTextureCount(textureType) > 0 &&
-            assimpMaterial.GetTexture(
-                textureType,
-                0, &aiTexturePath,
-                nullptr, nullptr,
-                &blendFactor, &aiBlendOperation) == aiReturn_SUCCESS;
+void Scene::ImportMaterial(
+    CommandContext& ctx,
+    const CookedMesh& cookedMesh,
+    const CookedMaterial& cookedMaterial,
+    std::string_view parentPath,
+    std::unordered_map<StringId, std::unique_ptr<Texture>>& uploadedTextures)
+{
+    const MaterialProperties properties{
+        .Diffuse           = impl::ToColor(cookedMaterial.Diffuse),
+        .Specular          = impl::ToColor(cookedMaterial.Specular),
+        .Emissive          = impl::ToColor(cookedMaterial.Emissive),
+        .Ambient           = impl::ToColor(cookedMaterial.Ambient),
+        .Reflectance       = impl::ToColor(cookedMaterial.Reflectance),
+        .Opacity           = cookedMaterial.Opacity,
+        .SpecularPower     = cookedMaterial.SpecularPower,
+        .IndexOfRefraction = cookedMaterial.IndexOfRefraction,
+        .BumpIntensity     = cookedMaterial.BumpIntensity
     };
 
-    for (const auto& [textureType, make_sRGB] : AiTextureTypes) {
-        if (hasTexture(textureType)) {
-            const auto filePath = FileSystem::Append(parentPath, aiTexturePath.C_Str());
-            auto texture = TextureManager::LoadTextureFromFile(ctx, filePath, make_sRGB);
-            material.SetTexture(static_cast<Material::TextureID>(textureType), std::move(texture));
+    auto material = MakePooled<Material>(properties);
+    material->SetName(StringId::Intern(cookedMesh.GetString(cookedMaterial.Name)));
+
+    for (uint32_t slot = 0; slot < CookedMeshFormat::NUM_TEXTURE_SLOTS; slot++) {
+        const auto texturePath = cookedMesh.GetString(cookedMaterial.Textures[slot]);
+
+        if (!texturePath.empty()) {
+            //The first material using a texture takes the one just uploaded, every other use is served by the cache
+            const auto filePath = StringId::Intern(FileSystem::Append(parentPath, texturePath));
+            const bool sRGB     = (cookedMaterial.SRGBTextureMask >> slot) & 1;
+
+            auto texture = std::exchange(uploadedTextures[filePath], nullptr);
+
+            if (!texture) {
+                texture = TextureManager::LoadTextureFromFile(ctx, filePath, sRGB);
+            }
+
+            material->SetTexture(static_cast<Material::TextureID>(slot), std::move(texture));
         }
     }
+
+    m_materials.emplace_back(std::move(material));
 }
 
-std::optional<const aiScene*> Scene::PreProcess(std::string_view fileName) noexcept {
-    const auto exportPath = FileSystem::ReplaceExtension(fileName, "assBin");
+bool Scene::CookScene(
+    std::string_view fileName,
+    std::string_view cookedPath,
+    std::string_view parentPath,
+    VertexLayout layout,
+    std::vector<std::string>& dependencies)
+{
+    //Binary glTF is read straight from the mapped file, files using anything the reader does not support go through assimp
+    if (impl::IsGlbFile(fileName)) {
+        if (const auto glbFile = GlbFile::Open(fileName)) {
+            return CookGlbScene(*glbFile, fileName, cookedPath, parentPath, layout, dependencies);
+        }
+    }
 
     Assimp::Importer importer;
 
-    //Check if preprocessed file exists
-    if (FileSystem::IsFile(exportPath)) {
-        if (const auto scene = importer.ReadFile(exportPath, aiProcess_GenBoundingBoxes)) {
-            return scene;
+    //The importer owns and deletes the IO handler
+    importer.SetIOHandler(new impl::RecordingIOSystem(dependencies));
+    importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, impl::SMOOTHING_ANGLE);
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, impl::REMOVED_PRIMITIVES);
+
+    //The scene is owned by the importer, everything is copied into the writer before it goes out of scope
+    const auto scene = importer.ReadFile(std::string(fileName), impl::PRE_PROCESS_FLAGS);
+
+    if (!scene) [[unlikely]] {
+        return false;
+    }
+
+    CookedMeshWriter writer(GetVertexStride(layout), static_cast<uint32_t>(layout));
+
+    for (auto i = 0u; i < scene->mNumMaterials; i++) {
+        CookMaterial(writer, *(scene->mMaterials[i]), parentPath, dependencies);
+    }
+
+    //Vertices and indices of every mesh are processed as separate tasks, the writer is filled in mesh order afterwards
+    const auto numMeshes = static_cast<size_t>(scene->mNumMeshes);
+
+    std::vector<std::vector<Vertex>> vertices(numMeshes);
+    std::vector<std::vector<uint32_t>> indices(numMeshes);
+
+    impl::GetImportThreadPool().ParallelFor(numMeshes * 2, [&](size_t task) {
+        const auto mesh = task / 2;
+
+        if (task % 2 == 0) {
+            impl::CookVertices(*(scene->mMeshes[mesh]), vertices[mesh]);
         }
-        return {};
+        else {
+            impl::CookIndices(*(scene->mMeshes[mesh]), indices[mesh]);
+        }
+    });
+
+    std::vector<uint32_t> materialIndices(numMeshes);
+
+    for (size_t mesh = 0; mesh < numMeshes; mesh++) {
+        materialIndices[mesh] = scene->mMeshes[mesh]->mMaterialIndex;
     }
 
-    //File has not been preprocessed yet. Import and process the file.
-    importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f);
-    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);
+    impl::CookSubmeshes(writer, fileName, layout, vertices, indices, materialIndices);
+    return writer.Write(cookedPath);
+}
 
-    constexpr auto preProcessFlag =
-        aiProcessPreset_TargetRealtime_MaxQuality |
-        aiProcess_OptimizeGraph |
-        aiProcess_ConvertToLeftHanded |
-        aiProcess_GenBoundingBoxes;
+//Primitives of every mesh instance become submeshes with their node transforms baked in, like assimp's graph
+//optimization leaves them. Primitives without a material share a default one appended after the materials of the file.
+bool Scene::CookGlbScene(
+    const GlbFile& glbFile,
+    std::string_view fileName,
+    std::string_view cookedPath,
+    std::string_view parentPath,
+    VertexLayout layout,
+    std::vector<std::string>& dependencies)
+{
+    CookedMeshWriter writer(GetVertexStride(layout), static_cast<uint32_t>(layout));
+
+    for (const auto& material : glbFile.GetMaterials()) {
+        writer.AddMaterial(impl::CookGltfMaterial(writer, material, glbFile.GetImages(), parentPath, dependencies));
+    }
+
+    const auto primitives = glbFile.GetPrimitives();
+    const auto numMeshes  = primitives.size();
+
+    std::vector<std::vector<Vertex>> vertices(numMeshes);
+    std::vector<std::vector<uint32_t>> indices(numMeshes);
+    std::vector<uint32_t> materialIndices(numMeshes);
 
-    if (const auto scene = importer.ReadFile(fileName.data(), preProcessFlag)) {
-        //Export the preprocessed scene file for faster loading next time.
-        Assimp::Exporter{}.Export(scene, "assBin", exportPath, 0);
-        return scene;
+    const auto defaultMaterial = static_cast<uint32_t>(glbFile.GetMaterials().size());
+
+    impl::GetImportThreadPool().ParallelFor(numMeshes, [&](size_t mesh) {
+        ReadGltfPrimitive(primitives[mesh], vertices[mesh], indices[mesh]);
+    });
+
+    for (size_t mesh = 0; mesh < numMeshes; mesh++) {
+        materialIndices[mesh] = primitives[mesh].Material != GltfFormat::NO_INDEX ? primitives[mesh].Material : defaultMaterial;
+    }
+
+    if (std::ranges::contains(materialIndices, defaultMaterial)) {
+        writer.AddMaterial({ .Name = writer.AddString("DefaultMaterial") });
     }
-    return {};
+
+    impl::CookSubmeshes(writer, fileName, layout, vertices, indices, materialIndices);
+    return writer.Write(cookedPath);
 }
 
-void Scene::ProcessVertices(CommandContext& ctx, Mesh& mesh, const aiMesh& aiMesh) const noexcept {
-    std::vector<Vertex> vertices;
-    vertices.reserve(aiMesh.mNumVertices);
+void Scene::CookMaterial(CookedMeshWriter& writer, const aiMaterial& assimpMaterial, std::string_view parentPath, std::vector<std::string>& dependencies) {
+    CookedMaterial material;
+    material.Name = writer.AddString(assimpMaterial.GetName().C_Str());
 
-    assert(aiMesh.mMaterialIndex < m_materials.size());
+    aiColor4D color{};
+    float value{};
 
-    if (aiMesh.HasPositions()) [[likely]] {
-        for (uint32_t i = 0; i < aiMesh.mNumVertices; i++) {
-            vertices[i].Position = reinterpret_cast<Math::Vector3&>(aiMesh.mVertices[i]);
-        }
+    if (assimpMaterial.Get(AI_MATKEY_COLOR_AMBIENT, color) == aiReturn_SUCCESS) {
+        material.Ambient = impl::ToCookedColor(color);
     }
 
-    if (aiMesh.HasNormals()) {
-        for (uint32_t i = 0; i < aiMesh.mNumVertices; i++) {
-                vertices[i].Normal = reinterpret_cast<Math::Vector3&>(aiMesh.mNormals[i]);
-        }
+    if (assimpMaterial.Get(AI_MATKEY_COLOR_EMISSIVE, color) == aiReturn_SUCCESS) {
+        material.Emissive = impl::ToCookedColor(color);
     }
 
-    if (aiMesh.HasTangentsAndBitangents()) {
-        for (uint32_t i = 0; i < aiMesh.mNumVertices; i++) {
-            vertices[i].Tangent = reinterpret_cast<Math::Vector3&>(aiMesh.mTangents[i]);
-            vertices[i].Bitangent = reinterpret_cast<Math::Vector3&>(aiMesh.mBitangents[i]);
-        }
+    if (assimpMaterial.Get(AI_MATKEY_COLOR_DIFFUSE, color) == aiReturn_SUCCESS) {
+        material.Diffuse = impl::ToCookedColor(color);
     }
 
-    if (aiMesh.HasTextureCoords(0)) {
-        for (uint32_t i = 0; i < aiMesh.mNumVertices; i++) {
-            vertices[i].TexCoord = reinterpret_cast<Math::Vector3&>(aiMesh.mTextureCoords[0][i]);
-        }
+    if (assimpMaterial.Get(AI_MATKEY_COLOR_SPECULAR, color) == aiReturn_SUCCESS) {
+        material.Specular = impl::ToCookedColor(color);
     }
 
-    BufferDescription vbd = {
-        .Count = static_cast<uint32_t>(vertices.size()),
-        .Stride = sizeof(std::decay_t<decltype(vertices)>)
-    };
+    if (assimpMaterial.Get(AI_MATKEY_SHININESS, value) == aiReturn_SUCCESS) {
+        material.SpecularPower = value;
+    }
 
-    mesh.SetVertexBuffer(0, std::make_unique<Buffer>(vbd));
-}
+    if (assimpMaterial.Get(AI_MATKEY_OPACITY, value) == aiReturn_SUCCESS) {
+        material.Opacity = value;
+    }
 
-void Scene::ProcessIndices(CommandContext& ctx, Mesh& mesh, const aiMesh& aiMesh) const noexcept {
-    if (aiMesh.HasFaces()) [[likely]] {
-        std::vector<uint32_t> indices;
+    if (assimpMaterial.Get(AI_MATKEY_REFRACTI, value) == aiReturn_SUCCESS) {
+        material.IndexOfRefraction = value;
+    }
 
-        for (uint32_t i = 0; i < aiMesh.mNumFaces; i++) {
-            const auto& face = aiMesh.mFaces[i];
+    //Reflectivity is a single value, it is stored as a grey reflectance
+    if (assimpMaterial.Get(AI_MATKEY_REFLECTIVITY, value) == aiReturn_SUCCESS) {
+        material.Reflectance = { value, value, value, value };
+    }
 
-            // Only extract triangular faces
-            if (face.mNumIndices == 3) {
-                indices.emplace_back(face.mIndices[0]);
-                indices.emplace_back(face.mIndices[1]);
-                indices.emplace_back(face.mIndices[2]);
-            }
-        }
+    if (assimpMaterial.Get(AI_MATKEY_BUMPSCALING, value) == aiReturn_SUCCESS) {
+        material.BumpIntensity = value;
+    }
+
+    aiString aiTexturePath;
 
-        if (!indices.empty()) [[likely]] {
-            BufferDescription ibd = {
-                .Count  = static_cast<uint32_t>(indices.size()),
-                .Stride = sizeof(std::decay_t<decltype(indices)>),
-                .Format = IndexFormat_t::uint_32
-            };
+    for (uint32_t slot = 0; slot < AiTextureTypes.size(); slot++) {
+        const auto [textureType, make_sRGB] = AiTextureTypes[slot];
 
-            mesh.SetIndexBuffer(std::make_unique<Buffer>(ibd));
+        if (assimpMaterial.GetTextureCount(textureType) > 0 && assimpMaterial.GetTexture(textureType, 0, &aiTexturePath) == aiReturn_SUCCESS) {
+            material.Textures[slot]  = writer.AddString(aiTexturePath.C_Str());
+            material.SRGBTextureMask |= static_cast<uint32_t>(make_sRGB) << slot;
+
+            dependencies.push_back(FileSystem::Append(parentPath, aiTexturePath.C_Str()));
         }
     }
-}
 
+    writer.AddMaterial(material);
+}
@@ -1,73 +1,66 @@
 #pragma once
-#include <optional>
+#include <array>
 #include <span>
+#include <string>
 #include <unordered_map>
 #include <vector>
 #include <memory>
 #include "Material.h"
+#include "VertexLayouts.h"
+#include "Core/Memory/SlabAllocator.h"
 #include "assimp/scene.h"
 
-namespace Assimp {
-	class Importer;
-}
-
 namespace Crystal {
-	namespace detail {
-		enum class MaterialUnit { Vec4, Float };
-
-		struct AssimpMaterialSpecification {
-			std::string_view Key;
-			uint32_t Type;
-			uint32_t Id;
-			MaterialUnit Unit;
-		};
-	}
-
 	class CommandContext;
+	class CookedMesh;
+	class CookedMeshWriter;
+	class GlbFile;
 	class Mesh;
+	class Texture;
+	struct CookedMaterial;
+	struct CookedSubmesh;
+
 	class Scene {
 	public:
-		bool LoadSceneFromFile(CommandContext& ctx, std::string_view fileName);
+		//Source files are imported through assimp once and cooked into the import cache, later loads map the cooked file.
+		//Binary glTF files are read directly unless they use something only assimp supports.
+		//Every layout is cooked into its own cache entry.
+		bool LoadSceneFromFile(CommandContext& ctx, std::string_view fileName, VertexLayout layout = VertexLayout::Full);
 	private:
-		void ImportScene(CommandContext& ctx, const aiScene& scene, std::string_view parentPath);
-		void ImportMesh(CommandContext& ctx, const aiMesh& assimpMesh);
-		void ImportMaterial(CommandContext& ctx, const aiMaterial& aiMat, std::string_view parentPath) noexcept;
-
-		void SetMaterials(Material& material, const aiMaterial& assimpMaterial) const noexcept;
-		void LoadTextures(CommandContext& ctx, Material& material, const aiMaterial& assimpMaterial, std::string_view parentPath) const noexcept;
+		//Textures are decoded on the import threads, everything touching the GPU is recorded afterwards on the calling thread
+		void ImportScene(CommandContext& ctx, const CookedMesh& cookedMesh, std::string_view parentPath);
+		void ImportMesh(CommandContext& ctx, const CookedMesh& cookedMesh, const CookedSubmesh& submesh);
+		void ImportMaterial(
+			CommandContext& ctx,
+			const CookedMesh& cookedMesh,
+			const CookedMaterial& cookedMaterial,
+			std::string_view parentPath,
+			std::unordered_map<StringId, std::unique_ptr<Texture>>& uploadedTextures);
 
-		void ProcessVertices(CommandContext& ctx, Mesh& mesh, const aiMesh& aiMesh) const noexcept;
-		void ProcessIndices(CommandContext& ctx, Mesh& mesh, const aiMesh& aiMesh) const noexcept;
+		//Every file the import read or references is added to dependencies
+		[[nodiscard]] static bool CookScene(
+			std::string_view fileName,
+			std::string_view cookedPath,
+			std::string_view parentPath,
+			VertexLayout layout,
+			std::vector<std::string>& dependencies);
+		[[nodiscard]] static bool CookGlbScene(
+			const GlbFile& glbFile,
+			std::string_view fileName,
+			std::string_view cookedPath,
+			std::string_view parentPath,
+			VertexLayout layout,
+			std::vector<std::string>& dependencies);
+		static void CookMaterial(
+			CookedMeshWriter& writer,
+			const aiMaterial& assimpMaterial,
+			std::string_view parentPath,
+			std::vector<std::string>& dependencies);
 
-		static std::optional<const aiScene*> PreProcess(std::string_view fileName) noexcept;
-
-		std::vector<std::unique_ptr<Mesh>> m_meshes;
-		std::vector<std::unique_ptr<Material>> m_materials;
-
-		using MaterialColorFuncPtr = void(Material::*)(const Math::Vector4&);
-		using MaterialValueFuncPtr = void(Material::*)(float);
-
-		union MaterialFunction {
-			MaterialFunction(MaterialColorFuncPtr ptr) : ColorFuncPtr(ptr) {}
-			MaterialFunction(MaterialValueFuncPtr ptr) : ValueFuncPtr(ptr) {}
-
-			MaterialColorFuncPtr ColorFuncPtr;
-			MaterialValueFuncPtr ValueFuncPtr;
-		}; 
-
-		std::unordered_map<detail::AssimpMaterialSpecification, MaterialFunction> m_materialFunctionMap =
-		{
-			{ { AI_MATKEY_COLOR_AMBIENT , detail::MaterialUnit::Vec4  }, &Material::SetAmbientColor      },
-			{ { AI_MATKEY_COLOR_EMISSIVE, detail::MaterialUnit::Vec4  }, &Material::SetEmissiveColor     },
-			{ { AI_MATKEY_COLOR_DIFFUSE , detail::MaterialUnit::Vec4  }, &Material::SetDiffuseColor      },
-			{ { AI_MATKEY_COLOR_SPECULAR, detail::MaterialUnit::Vec4  }, &Material::SetAmbientColor      },
-			{ { AI_MATKEY_SHININESS     , detail::MaterialUnit::Float }, &Material::SetSpecularPower     },
-			{ { AI_MATKEY_OPACITY       , detail::MaterialUnit::Float }, &Material::SetOpacity           },
-			{ { AI_MATKEY_REFRACTI      , detail::MaterialUnit::Float }, &Material::SetIndexOfRefraction },
-			{ { AI_MATKEY_REFLECTIVITY  , detail::MaterialUnit::Float }, &Material::SetReflectance       },
-			{ { AI_MATKEY_BUMPSCALING   , detail::MaterialUnit::Float }, &Material::SetBumpIntensity     }
-		};
+		std::vector<PoolPtr<Mesh>> m_meshes;
+		std::vector<PoolPtr<Material>> m_materials;
 
+		//Assimp texture types in the order of Material::TextureID
 		static constexpr std::array<std::pair<aiTextureType, bool>, 8> AiTextureTypes = {
 			{
 				{ aiTextureType_AMBIENT,   true  },
@@ -75,9 +68,9 @@ namespace Crystal {
 				{ aiTextureType_DIFFUSE,   true  },
 				{ aiTextureType_SPECULAR,  true  },
 				{ aiTextureType_SHININESS, false },
-				{ aiTextureType_OPACITY,   false },
 				{ aiTextureType_NORMALS,   false },
-				{ aiTextureType_HEIGHT,    false }
+				{ aiTextureType_HEIGHT,    false },
+				{ aiTextureType_OPACITY,   false }
 			}
 		};
 	};
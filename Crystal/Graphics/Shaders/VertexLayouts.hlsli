@@ -0,0 +1,53 @@
+//Decoding of the compact vertex layouts, mirrors DecodeVertex in VertexLayouts.cpp
+
+struct CompactVertexInput {
+    float3 Position     : POSITION;
+    float4 TangentFrame : TANGENTFRAME; //R16G16B16A16_SNORM quaternion, the sign of w is the bitangent sign
+    float2 TexCoord     : TEXCOORD;     //R16G16_FLOAT
+};
+
+struct QuantizedVertexInput {
+    float4 Position : POSITION;         //R16G16B16A16_UNORM within the submesh bounds, w is 1 or 0 for the bitangent sign
+    float2 Normal   : NORMAL;           //R16G16_SNORM octahedral
+    float2 Tangent  : TANGENT;          //R16G16_SNORM octahedral
+    float2 TexCoord : TEXCOORD;         //R16G16_FLOAT
+};
+
+struct DecodedTangentFrame {
+    float3 Normal;
+    float3 Tangent;
+    float3 Bitangent;
+};
+
+float3 DecodeOctahedral(float2 encoded) {
+    float3 direction = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+
+    if (direction.z < 0.0f) {
+        direction.xy = (1.0f - abs(direction.yx)) * select(direction.xy >= 0.0f, 1.0f, -1.0f);
+    }
+    return normalize(direction);
+}
+
+DecodedTangentFrame DecodeTangentFrame(float4 packed) {
+    const float4 q    = normalize(packed);
+    const float  sign = packed.w < 0.0f ? -1.0f : 1.0f;
+
+    DecodedTangentFrame frame;
+    frame.Tangent   = float3(1.0f - 2.0f * (q.y * q.y + q.z * q.z), 2.0f * (q.x * q.y + q.w * q.z), 2.0f * (q.x * q.z - q.w * q.y));
+    frame.Normal    = float3(2.0f * (q.x * q.z + q.w * q.y), 2.0f * (q.y * q.z - q.w * q.x), 1.0f - 2.0f * (q.x * q.x + q.y * q.y));
+    frame.Bitangent = cross(frame.Normal, frame.Tangent) * sign;
+    return frame;
+}
+
+DecodedTangentFrame DecodeQuantizedTangentFrame(QuantizedVertexInput input) {
+    DecodedTangentFrame frame;
+    frame.Normal    = DecodeOctahedral(input.Normal);
+    frame.Tangent   = DecodeOctahedral(input.Tangent);
+    frame.Bitangent = cross(frame.Normal, frame.Tangent) * (input.Position.w > 0.5f ? 1.0f : -1.0f);
+    return frame;
+}
+
+//Scale and offset are PositionDequantization of the mesh
+float3 DecodeQuantizedPosition(QuantizedVertexInput input, float3 scale, float3 offset) {
+    return input.Position.xyz * scale + offset;
+}
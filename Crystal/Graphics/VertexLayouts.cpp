@@ -0,0 +1,163 @@
+#include "VertexLayouts.h"
+#include "Core/Math/Packing.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+using namespace Crystal;
+
+static_assert(std::is_trivially_copyable_v<CompactVertex> && std::is_trivially_copyable_v<QuantizedVertex>);
+
+namespace impl {
+    [[nodiscard]] std::array<uint16_t, 2> PackTexCoord(const Math::Vector3& texCoord) noexcept {
+        return { Math::FloatToHalf(texCoord.x), Math::FloatToHalf(texCoord.y) };
+    }
+
+    [[nodiscard]] Math::Vector3 UnpackTexCoord(std::array<uint16_t, 2> texCoord) noexcept {
+        return { Math::HalfToFloat(texCoord[0]), Math::HalfToFloat(texCoord[1]), 0.0f };
+    }
+
+    [[nodiscard]] CompactVertex ToCompactVertex(const Vertex& vertex) noexcept {
+        return {
+            .Position     = { vertex.Position.x, vertex.Position.y, vertex.Position.z },
+            .TangentFrame = Math::PackTangentFrame(vertex.Normal, vertex.Tangent, vertex.Bitangent),
+            .TexCoord     = PackTexCoord(vertex.TexCoord)
+        };
+    }
+
+    [[nodiscard]] QuantizedVertex ToQuantizedVertex(const Vertex& vertex, const CookedBounds& bounds) noexcept {
+        const std::array<float, 3> position{ vertex.Position.x, vertex.Position.y, vertex.Position.z };
+
+        QuantizedVertex quantized;
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            const auto extent = bounds.Max[axis] - bounds.Min[axis];
+            quantized.Position[axis] = extent > 0.0f ? Math::PackUnorm16((position[axis] - bounds.Min[axis]) / extent) : 0;
+        }
+
+        const auto packedNormal = Math::PackOctahedral(vertex.Normal);
+
+        const auto normal  = Math::UnpackOctahedral(packedNormal);
+        const auto tangent = Math::OrthogonalizeTangent(normal, vertex.Tangent);
+
+        //Same reconstruction as the shader: bitangent = cross(normal, tangent) * sign
+        const bool isMirrored = Math::Vector3::Dot(Math::Vector3::Cross(normal, tangent), vertex.Bitangent) < 0.0f;
+
+        quantized.Position[3] = isMirrored ? 0 : std::numeric_limits<uint16_t>::max();
+        quantized.Normal      = packedNormal;
+        quantized.Tangent     = Math::PackOctahedral(tangent);
+        quantized.TexCoord    = PackTexCoord(vertex.TexCoord);
+        return quantized;
+    }
+}
+
+CookedBounds Crystal::ComputePositionBounds(std::span<const Vertex> vertices) noexcept {
+    constexpr auto MAX = std::numeric_limits<float>::max();
+
+    CookedBounds bounds{ { MAX, MAX, MAX }, { -MAX, -MAX, -MAX } };
+
+    for (const auto& vertex : vertices) {
+        const std::array<float, 3> position{ vertex.Position.x, vertex.Position.y, vertex.Position.z };
+
+        for (size_t axis = 0; axis < 3; axis++) {
+            bounds.Min[axis] = std::min(bounds.Min[axis], position[axis]);
+            bounds.Max[axis] = std::max(bounds.Max[axis], position[axis]);
+        }
+    }
+    return bounds;
+}
+
+PositionDequantization Crystal::GetPositionDequantization(const CookedBounds& bounds, VertexLayout layout) noexcept {
+    if (layout != VertexLayout::Quantized) {
+        return {};
+    }
+
+    PositionDequantization dequantization;
+
+    for (size_t axis = 0; axis < 3; axis++) {
+        dequantization.Scale[axis]  = std::max(bounds.Max[axis] - bounds.Min[axis], 0.0f);
+        dequantization.Offset[axis] = bounds.Min[axis];
+    }
+    return dequantization;
+}
+
+void Crystal::ConvertVertices(std::span<const Vertex> vertices, VertexLayout layout, const CookedBounds& bounds, std::span<std::byte> output) noexcept {
+    const auto stride = GetVertexStride(layout);
+    assert(output.size() >= vertices.size() * stride);
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        auto* destination = output.data() + i * stride;
+
+        switch (layout) {
+            case VertexLayout::Compact: {
+                const auto compact = impl::ToCompactVertex(vertices[i]);
+                std::memcpy(destination, &compact, sizeof(compact));
+                break;
+            }
+            case VertexLayout::Quantized: {
+                const auto quantized = impl::ToQuantizedVertex(vertices[i], bounds);
+                std::memcpy(destination, &quantized, sizeof(quantized));
+                break;
+            }
+            default:
+                std::memcpy(destination, &vertices[i], sizeof(Vertex));
+                break;
+        }
+    }
+}
+
+Vertex Crystal::DecodeVertex(std::span<const std::byte> vertex, VertexLayout layout, const PositionDequantization& dequantization) noexcept {
+    assert(vertex.size() >= GetVertexStride(layout));
+
+    Vertex decoded;
+
+    switch (layout) {
+        case VertexLayout::Compact: {
+            CompactVertex compact;
+            std::memcpy(&compact, vertex.data(), sizeof(compact));
+
+            const auto frame = Math::UnpackTangentFrame(compact.TangentFrame);
+
+            decoded.Position  = { compact.Position[0], compact.Position[1], compact.Position[2] };
+            decoded.Normal    = frame.Normal;
+            decoded.Tangent   = frame.Tangent;
+            decoded.Bitangent = frame.Bitangent;
+            decoded.TexCoord  = impl::UnpackTexCoord(compact.TexCoord);
+            break;
+        }
+        case VertexLayout::Quantized: {
+            QuantizedVertex quantized;
+            std::memcpy(&quantized, vertex.data(), sizeof(quantized));
+
+            std::array<float, 3> position;
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                position[axis] = Math::UnpackUnorm16(quantized.Position[axis]) * dequantization.Scale[axis] + dequantization.Offset[axis];
+            }
+
+            const auto sign = Math::UnpackUnorm16(quantized.Position[3]) > 0.5f ? 1.0f : -1.0f;
+
+            decoded.Position  = { position[0], position[1], position[2] };
+            decoded.Normal    = Math::UnpackOctahedral(quantized.Normal);
+            decoded.Tangent   = Math::UnpackOctahedral(quantized.Tangent);
+            decoded.Bitangent = Math::Vector3::Cross(decoded.Normal, decoded.Tangent) * sign;
+            decoded.TexCoord  = impl::UnpackTexCoord(quantized.TexCoord);
+            break;
+        }
+        default: {
+            std::array<float, sizeof(Vertex) / sizeof(float)> attributes;
+            std::memcpy(attributes.data(), vertex.data(), sizeof(attributes));
+
+            decoded.Position  = { attributes[0], attributes[1], attributes[2] };
+            decoded.Normal    = { attributes[3], attributes[4], attributes[5] };
+            decoded.Tangent   = { attributes[6], attributes[7], attributes[8] };
+            decoded.Bitangent = { attributes[9], attributes[10], attributes[11] };
+            decoded.TexCoord  = { attributes[12], attributes[13], attributes[14] };
+            break;
+        }
+    }
+    return decoded;
+}
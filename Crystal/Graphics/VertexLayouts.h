@@ -0,0 +1,67 @@
+#pragma once
+#include "CookedMesh.h"
+#include "Core/Math/Vector3.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Crystal {
+    //Vertex as it is imported and optimized, every layout is converted from it
+    struct Vertex {
+        Math::Vector3 Position{};
+        Math::Vector3 Normal{};
+        Math::Vector3 Tangent{};
+        Math::Vector3 Bitangent{};
+        Math::Vector3 TexCoord{};
+    };
+
+    enum class VertexLayout : uint8_t {
+        //60 bytes, every attribute as float3
+        Full,
+        //24 bytes, float3 position, tangent frame as a snorm16 quaternion and half texture coordinates
+        Compact,
+        //20 bytes, unorm16 position within the submesh bounds, octahedral snorm16 normal and tangent, half texture
+        //coordinates. The fourth position component holds the sign of the bitangent.
+        Quantized
+    };
+
+    struct CompactVertex {
+        std::array<float, 3> Position;
+        std::array<int16_t, 4> TangentFrame;
+        std::array<uint16_t, 2> TexCoord;
+    };
+
+    struct QuantizedVertex {
+        std::array<uint16_t, 4> Position;
+        std::array<int16_t, 2> Normal;
+        std::array<int16_t, 2> Tangent;
+        std::array<uint16_t, 2> TexCoord;
+    };
+
+    static_assert(sizeof(Vertex) == 60 && sizeof(CompactVertex) == 24 && sizeof(QuantizedVertex) == 20);
+
+    [[nodiscard]] constexpr uint32_t GetVertexStride(VertexLayout layout) noexcept {
+        switch (layout) {
+            case VertexLayout::Compact:   return sizeof(CompactVertex);
+            case VertexLayout::Quantized: return sizeof(QuantizedVertex);
+            default:                      return sizeof(Vertex);
+        }
+    }
+
+    //Position = quantized * Scale + Offset, the identity for layouts with float positions
+    struct PositionDequantization {
+        std::array<float, 3> Scale { 1.0f, 1.0f, 1.0f };
+        std::array<float, 3> Offset{ 0.0f, 0.0f, 0.0f };
+    };
+
+    [[nodiscard]] CookedBounds ComputePositionBounds(std::span<const Vertex> vertices) noexcept;
+    [[nodiscard]] PositionDequantization GetPositionDequantization(const CookedBounds& bounds, VertexLayout layout) noexcept;
+
+    //Writes vertices in the given layout to output, which has to hold GetVertexStride(layout) bytes per vertex.
+    //Quantized positions are relative to bounds, the bounds of the vertices or of the submesh they are drawn with.
+    void ConvertVertices(std::span<const Vertex> vertices, VertexLayout layout, const CookedBounds& bounds, std::span<std::byte> output) noexcept;
+
+    //Reads one vertex back the way the input assembler and the vertex shader decode it, the texture coordinate's z is 0
+    [[nodiscard]] Vertex DecodeVertex(std::span<const std::byte> vertex, VertexLayout layout, const PositionDequantization& dequantization) noexcept;
+}
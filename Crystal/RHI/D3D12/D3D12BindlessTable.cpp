@@ -0,0 +1,97 @@
+#include "D3D12BindlessTable.h"
+#include "D3D12CommandQueue.h"
+#include "D3D12Core.h"
+
+#include "Utils/D3D12Exception.h"
+#include "Core/Logging/Logger.h"
+
+using namespace Crystal;
+using namespace Microsoft::WRL;
+
+BindlessDescriptorTable::BindlessDescriptorTable(uint32_t numPersistentDescriptors, uint32_t numDynamicBlocks)
+	:
+	m_numPersistentDescriptors(numPersistentDescriptors),
+	m_persistentIndices(numPersistentDescriptors),
+	m_dynamicBlocks(numDynamicBlocks)
+{
+	auto& device = RHICore::get_device();
+
+	const D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc = {
+		.Type           = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+		.NumDescriptors = numPersistentDescriptors + numDynamicBlocks * DYNAMIC_BLOCK_SIZE,
+		.Flags          = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
+	};
+
+	ThrowIfFailed(device.CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&m_descriptorHeap)));
+	m_descriptorHeap->SetName(L"Bindless Descriptor Table");
+
+	m_cpuHeapStart                  = m_descriptorHeap->GetCPUDescriptorHandleForHeapStart();
+	m_gpuHeapStart                  = m_descriptorHeap->GetGPUDescriptorHandleForHeapStart();
+	m_descriptorHandleIncrementSize = device.GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+GenerationalIndex BindlessDescriptorTable::Register(D3D12_CPU_DESCRIPTOR_HANDLE descriptor) {
+	std::optional<GenerationalIndex> index;
+	{
+		std::scoped_lock lock(m_mutex);
+		index = m_persistentIndices.Allocate();
+	}
+
+	if (!index) [[unlikely]] {
+		Logger::Error("Bindless descriptor table is full, {} descriptors are registered", m_numPersistentDescriptors);
+		return {};
+	}
+
+	RHICore::get_device().CopyDescriptorsSimple(1, GetCPUDescriptorHandle(index->Index), descriptor, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	return *index;
+}
+
+void BindlessDescriptorTable::Unregister(GenerationalIndex index) {
+	if (!index.IsValid()) {
+		return;
+	}
+
+	std::scoped_lock lock(m_mutex);
+
+	//Tagged with the next fence value, the queue may already be past the value of the last submission
+	if (!m_persistentIndices.Free(index, RHICore::get_graphics_queue().GetNextFenceValue())) {
+		Logger::Warning("Bindless descriptor {} is unregistered twice or was never registered", index.Index);
+	}
+}
+
+void BindlessDescriptorTable::ReleaseStaleIndices(uint64_t completedFenceValue) noexcept {
+	std::scoped_lock lock(m_mutex);
+	m_persistentIndices.ReleaseCompleted(completedFenceValue);
+}
+
+bool BindlessDescriptorTable::IsRegistered(GenerationalIndex index) const {
+	std::scoped_lock lock(m_mutex);
+	return m_persistentIndices.IsAlive(index);
+}
+
+std::optional<uint32_t> BindlessDescriptorTable::AllocateDynamicBlock() {
+	std::scoped_lock lock(m_mutex);
+
+	if (const auto block = m_dynamicBlocks.Allocate()) {
+		return m_numPersistentDescriptors + *block * DYNAMIC_BLOCK_SIZE;
+	}
+	return {};
+}
+
+void BindlessDescriptorTable::FreeDynamicBlock(uint32_t firstDescriptor) {
+	std::scoped_lock lock(m_mutex);
+	m_dynamicBlocks.Free((firstDescriptor - m_numPersistentDescriptors) / DYNAMIC_BLOCK_SIZE);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE BindlessDescriptorTable::GetCPUDescriptorHandle(uint32_t index) const noexcept {
+	return { m_cpuHeapStart.ptr + static_cast<size_t>(index) * m_descriptorHandleIncrementSize };
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE BindlessDescriptorTable::GetGPUDescriptorHandle(uint32_t index) const noexcept {
+	return { m_gpuHeapStart.ptr + static_cast<uint64_t>(index) * m_descriptorHandleIncrementSize };
+}
+
+uint32_t BindlessDescriptorTable::GetNumRegisteredDescriptors() const {
+	std::scoped_lock lock(m_mutex);
+	return m_persistentIndices.GetLiveCount();
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <mutex>
+#include <optional>
+
+#include "Core/Memory/BitmapRangeAllocator.h"
+#include "Core/Memory/GenerationalIndexAllocator.h"
+
+namespace Crystal {
+	//The one shader visible CBV/SRV/UAV heap every context binds.
+	//The front of the heap holds persistent descriptors: a view is registered once and shaders reach it through
+	//its index, passed in root constants, instead of it being copied into a table before every draw.
+	//Contexts still have to be told about every texture a draw reaches this way, see CommandContext::UseBindlessTexture.
+	//The back of the heap is split into blocks the dynamic descriptor heaps of the contexts stage their tables in,
+	//so binding a table never has to switch descriptor heaps.
+	class BindlessDescriptorTable {
+	public:
+		static constexpr uint32_t DEFAULT_NUM_PERSISTENT_DESCRIPTORS = 1 << 16;
+		static constexpr uint32_t DEFAULT_NUM_DYNAMIC_BLOCKS         = 64;
+		static constexpr uint32_t DYNAMIC_BLOCK_SIZE                 = 1024;
+
+		explicit BindlessDescriptorTable(
+			uint32_t numPersistentDescriptors = DEFAULT_NUM_PERSISTENT_DESCRIPTORS,
+			uint32_t numDynamicBlocks         = DEFAULT_NUM_DYNAMIC_BLOCKS);
+
+		BindlessDescriptorTable(const BindlessDescriptorTable&)            = delete;
+		BindlessDescriptorTable& operator=(const BindlessDescriptorTable&) = delete;
+
+		//Copies the descriptor into the table, the returned index stays valid until it is unregistered
+		[[nodiscard]] GenerationalIndex Register(D3D12_CPU_DESCRIPTOR_HANDLE descriptor);
+
+		//The index is handed out again once the GPU has finished the work submitted so far
+		void Unregister(GenerationalIndex index);
+		void ReleaseStaleIndices(uint64_t completedFenceValue) noexcept;
+
+		[[nodiscard]] bool IsRegistered(GenerationalIndex index) const;
+
+		//Returns the first descriptor of the block, blocks belong to a context until it gives them back
+		[[nodiscard]] std::optional<uint32_t> AllocateDynamicBlock();
+		void FreeDynamicBlock(uint32_t firstDescriptor);
+
+		[[nodiscard]] ID3D12DescriptorHeap* GetDescriptorHeap() const noexcept { return m_descriptorHeap.Get(); }
+		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetCPUDescriptorHandle(uint32_t index = 0) const noexcept;
+		[[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE GetGPUDescriptorHandle(uint32_t index = 0) const noexcept;
+
+		[[nodiscard]] uint32_t GetNumRegisteredDescriptors() const;
+	private:
+		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_descriptorHeap;
+		D3D12_CPU_DESCRIPTOR_HANDLE m_cpuHeapStart{};
+		D3D12_GPU_DESCRIPTOR_HANDLE m_gpuHeapStart{};
+		uint32_t m_descriptorHandleIncrementSize;
+
+		uint32_t m_numPersistentDescriptors;
+
+		GenerationalIndexAllocator m_persistentIndices;
+		BitmapRangeAllocator m_dynamicBlocks;
+
+		mutable std::mutex m_mutex;
+	};
+}
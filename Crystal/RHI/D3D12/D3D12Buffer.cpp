@@ -12,17 +12,12 @@ Buffer::Buffer(const BufferDescription& desc)
 	:
 	m_bufferDesc(desc)
 {
-	auto& d3d12Device       = RHICore::get_device();
 	const auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(Size());
-	const auto heapProps    = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
 
-	ThrowIfFailed(d3d12Device.CreateCommittedResource(
-		&heapProps,
-		D3D12_HEAP_FLAG_NONE,
-		&resourceDesc,
-		D3D12_RESOURCE_STATE_COMMON,
-		nullptr,
-		IID_PPV_ARGS(&m_resource)));
+	auto [resource, allocation] = RHICore::get_heap_allocator().CreateResource(resourceDesc, D3D12_RESOURCE_STATE_COMMON);
+
+	m_resource   = std::move(resource);
+	m_allocation = allocation;
 
 	ResourceStateTracker::AddGlobalResourceState(m_resource.Get(), D3D12_RESOURCE_STATE_COMMON);
 }
@@ -32,3 +27,9 @@ Buffer::Buffer(const BufferDescription& desc, const Texture* const texture) noex
 	m_bufferDesc(desc),
 	m_resource(texture->GetUnderlyingResource())
 {}
+
+Buffer::~Buffer() {
+	//Release the resource before its memory can be handed to another one
+	m_resource.Reset();
+	RHICore::get_heap_allocator().Free(m_allocation);
+}
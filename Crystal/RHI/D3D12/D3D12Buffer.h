@@ -3,6 +3,7 @@
 #include <wrl.h>
 #include <cstdint>
 #include "Graphics/Types/Types.h"
+#include "D3D12HeapAllocator.h"
 
 namespace Crystal {
     struct BufferDescription {
@@ -16,6 +17,9 @@ namespace Crystal {
     public:
         explicit Buffer(const BufferDescription& desc);
         Buffer(const BufferDescription& desc, const Texture* texture) noexcept;
+        Buffer(const Buffer&)            = delete;
+        Buffer& operator=(const Buffer&) = delete;
+        ~Buffer();
 
         [[nodiscard]] D3D12_GPU_VIRTUAL_ADDRESS BufferLocation() const noexcept { return m_resource->GetGPUVirtualAddress(); };
         [[nodiscard]] uint32_t Count()  const noexcept { return m_bufferDesc.Count; };
@@ -25,6 +29,7 @@ namespace Crystal {
         [[nodiscard]] const BufferDescription& GetDesc() const noexcept { return m_bufferDesc; };
     private:
         Microsoft::WRL::ComPtr<ID3D12Resource> m_resource;
+        HeapAllocation m_allocation;
         BufferDescription m_bufferDesc;
     };
 }
@@ -1,4 +1,5 @@
 #include "D3D12CommandContext.h"
+#include "D3D12BindlessTable.h"
 #include "D3D12Buffer.h"
 #include "D3D12Core.h"
 #include "D3D12DynamicDescriptorHeap.h"
@@ -6,14 +7,17 @@
 #include "D3D12PipelineState.h"
 #include "D3D12RootSignature.h"
 #include "D3D12RenderTarget.h"
-#include "LinearAllocator.h"
+#include "UploadAllocator.h"
+#include "Managers/TextureManager.h"
 
 #include "Utils/D3D12Exception.h"
 #include "Utils/ResourceStateTracker.h"
 
 #include "../../Core/Logging/Logger.h"
+#include "../../Core/Memory/FrameArena.h"
 
 #include <algorithm>
+#include <bit>
 
 using namespace Crystal;
 using namespace Microsoft::WRL;
@@ -30,7 +34,7 @@ CommandContext::CommandContext(CommandListType cmdListType) {
 		nullptr,
 		IID_PPV_ARGS(&m_d3d12CommandList)));
 
-	m_linearAllocator      = std::make_unique<LinearAllocator>();
+	m_uploadAllocator      = std::make_unique<UploadAllocator>();
 	m_resourceStateTracker = std::make_unique<ResourceStateTracker>();
 
 	for (auto i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++) {
@@ -43,6 +47,10 @@ void CommandContext::TransitionResource(
 	const Texture* const resource,
     TransitionBarrierSpecification specification) const noexcept
 {
+	if (resource->ConsumeInitialization()) [[unlikely]] {
+		InitializePlacedTexture(*resource);
+	}
+
 	TransitionResource(resource->GetUnderlyingResource(), specification);
 }
 
@@ -64,36 +72,36 @@ void CommandContext::CopyTextureSubresource(
 	uint32_t firstSubresource,
 	std::span<const D3D12_SUBRESOURCE_DATA> subresourceData)
 {
-	auto& device = RHICore::get_device();
-
 	if(const auto dstResource = texture.GetUnderlyingResource()) {
 		TransitionResource(&texture, { {ResourceState_t::copy_dest} });
 		m_resourceStateTracker->FlushResourceBarriers(this);
 
 		const auto requiredSize = GetRequiredIntermediateSize(dstResource.Get(), firstSubresource, subresourceData.size());
-
-		ComPtr<ID3D12Resource> intermediateResource;
-		const auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-		const auto buffer         = CD3DX12_RESOURCE_DESC::Buffer(requiredSize);
-
-		ThrowIfFailed(device.CreateCommittedResource(
-			&heapProperties,
-			D3D12_HEAP_FLAG_NONE,
-			&buffer,
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			IID_PPV_ARGS(&intermediateResource)));
+		const auto intermediate = m_uploadAllocator->Allocate(requiredSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
 
 		UpdateSubresources(
 			m_d3d12CommandList.Get(),
 			dstResource.Get(),
-			intermediateResource.Get(),
-			0,
+			intermediate.Resource,
+			intermediate.Offset,
 			firstSubresource,
 			subresourceData.size(),
 			subresourceData.data());
 
-		TrackResource(intermediateResource);
+		TrackResource(dstResource);
+	}
+}
+
+void CommandContext::CopyBuffer(const Buffer& buffer, std::span<const std::byte> data) {
+	if (const auto dstResource = buffer.GetResource(); dstResource && !data.empty()) {
+		TransitionResource(dstResource, { { ResourceState_t::copy_dest } });
+		m_resourceStateTracker->FlushResourceBarriers(this);
+
+		const auto intermediate = m_uploadAllocator->Allocate(data.size(), D3D12_STANDARD_MAXIMUM_ELEMENT_ALIGNMENT_BYTE_ALIGNMENT);
+		std::memcpy(intermediate.CPU, data.data(), data.size());
+
+		m_d3d12CommandList->CopyBufferRegion(dstResource.Get(), 0, intermediate.Resource, intermediate.Offset, data.size());
+
 		TrackResource(dstResource);
 	}
 }
@@ -164,15 +172,25 @@ bool CommandContext::Close(const CommandContext* const pendingCmdList) const noe
 	return numPendingBarriers > 0;
 }
 
-void CommandContext::Reset() {
+void CommandContext::OnSubmitted(uint64_t fenceValue) {
+	m_uploadAllocator->Submit(fenceValue);
+}
+
+void CommandContext::Reset(uint64_t completedFenceValue) {
 	ThrowIfFailed(m_commandAllocator->Reset());
 	ThrowIfFailed(m_d3d12CommandList->Reset(m_commandAllocator.Get(), nullptr));
 
-	m_linearAllocator->Reset();
+	m_uploadAllocator->Retire(completedFenceValue);
+	ReleaseTrackedObjects();
 
 	for (uint32_t i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++) {
+		m_dynamicDescriptorHeap[i]->Reset();
 		m_descriptorHeaps[i] = nullptr;
 	}
+
+	//The command list starts without any state, nothing set before the reset may be skipped as already bound
+	m_pipeLineState = nullptr;
+	m_rootSignature = nullptr;
 }
 
 void CommandContext::Close() const noexcept {
@@ -180,10 +198,44 @@ void CommandContext::Close() const noexcept {
 	m_d3d12CommandList->Close();
 }
 
+void CommandContext::BindBindlessDescriptorTables(const RootSignature& rootSignature, bool isCompute) noexcept {
+	const auto& bindlessTable = RHICore::get_bindless_table();
+
+	//Shaders that index the heap directly only need it bound, even without a table in the root signature
+	SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, bindlessTable.GetDescriptorHeap());
+
+	for (auto bitMask = rootSignature.GetBindlessTableBitMask(); bitMask != 0; bitMask &= bitMask - 1) {
+		const auto rootParameterIndex = static_cast<uint32_t>(std::countr_zero(bitMask));
+
+		if (isCompute) {
+			m_d3d12CommandList->SetComputeRootDescriptorTable(rootParameterIndex, bindlessTable.GetGPUDescriptorHandle());
+		}
+		else {
+			m_d3d12CommandList->SetGraphicsRootDescriptorTable(rootParameterIndex, bindlessTable.GetGPUDescriptorHandle());
+		}
+	}
+}
+
 void CommandContext::TrackResource(const ComPtr<ID3D12Object>& object) noexcept {
 	m_trackedObjects.push_back(object);
 }
 
+uint32_t CommandContext::UseBindlessTexture(const Texture& texture, ResourceState_t stateAfter) noexcept {
+	const auto bindlessIndex = texture.GetBindlessIndex();
+
+	if (!bindlessIndex.IsValid()) [[unlikely]] {
+		Logger::Error("Texture has no bindless index, it has no shader resource view");
+	}
+
+	TransitionResource(&texture, { { stateAfter } });
+	TrackResource(texture.GetUnderlyingResource());
+
+	if (texture.GetResidencyHandle().IsValid()) {
+		TextureManager::MarkUsed(texture.GetResidencyHandle());
+	}
+	return bindlessIndex.Index;
+}
+
 void CommandContext::ReleaseTrackedObjects() noexcept {
 	m_trackedObjects.clear();
 }
@@ -207,6 +259,19 @@ void CommandContext::InsertAliasingBarrier(const Texture& before, const Texture&
 	}
 }
 
+//The range may have held another resource, which the aliasing barrier retires. Discarding leaves the compression
+//metadata of the new texture valid, its contents stay undefined until they are rendered or cleared.
+void CommandContext::InitializePlacedTexture(const Texture& texture) const noexcept {
+	const auto resource       = texture.GetUnderlyingResource();
+	const bool isDepthStencil = (texture.GetResourceDesc().Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) != 0;
+
+	m_resourceStateTracker->ResourceBarrier(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource.Get()));
+
+	//Discarding needs the render target or depth write state
+	TransitionResource(resource, { { isDepthStencil ? ResourceState_t::depth_write : ResourceState_t::render_target }, ALL_SUBRESOURCES, true });
+	m_d3d12CommandList->DiscardResource(resource.Get(), nullptr);
+}
+
 void CommandContext::TransitionResource(
 	const ComPtr<ID3D12Resource>& resource,
     TransitionBarrierSpecification specification) const noexcept
@@ -244,6 +309,7 @@ void ComputeContext::SetComputeRootSignature(const RootSignature* const rootSign
 			}
 
 			m_d3d12CommandList->SetComputeRootSignature(m_rootSignature);
+			BindBindlessDescriptorTables(*rootSignature, true);
 
 			TrackResource(m_rootSignature);
 		}
@@ -299,6 +365,7 @@ void GraphicsContext::SetGraphicsRootSignature(const RootSignature* const rootSi
 			}
 
 			m_d3d12CommandList->SetGraphicsRootSignature(m_rootSignature);
+			BindBindlessDescriptorTables(*rootSignature, false);
 
 			TrackResource(m_rootSignature);
 		}
@@ -321,10 +388,10 @@ void GraphicsContext::SetConstantBuffer(
 	size_t sizeInBytes, 
 	const void* bufferData) const noexcept
 {
-	const auto [CPU, GPU] = m_linearAllocator->Allocate(sizeInBytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
-	std::memcpy(CPU, bufferData, sizeInBytes);
+	const auto allocation = m_uploadAllocator->Allocate(sizeInBytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+	std::memcpy(allocation.CPU, bufferData, sizeInBytes);
 
-	m_d3d12CommandList->SetGraphicsRootConstantBufferView(rootParameterIndex, GPU);
+	m_d3d12CommandList->SetGraphicsRootConstantBufferView(rootParameterIndex, allocation.GPU);
 }
 
 void GraphicsContext::SetShaderResourceView(
@@ -346,6 +413,10 @@ void GraphicsContext::SetShaderResourceView(
 
 	TrackResource(texture.GetUnderlyingResource());
 
+	if (texture.GetResidencyHandle().IsValid()) {
+		TextureManager::MarkUsed(texture.GetResidencyHandle());
+	}
+
 	m_dynamicDescriptorHeap[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->StageDescriptors(
 		rootParameterIndex,
 		descriptorOffset,
@@ -396,7 +467,10 @@ void GraphicsContext::SetViewports(std::span<const Viewport> viewports) const no
 void GraphicsContext::SetRenderTarget(const RenderTarget& renderTarget) noexcept {
 	static constexpr size_t MAX_RENDER_TARGETS{ 8 };
 
-	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> renderTargetDescriptors(MAX_RENDER_TARGETS);
+	ScopedArenaMarker scratch;
+
+	FrameVector<D3D12_CPU_DESCRIPTOR_HANDLE> renderTargetDescriptors(scratch.GetResource());
+	renderTargetDescriptors.reserve(MAX_RENDER_TARGETS);
 
 	const auto& textures = renderTarget.GetTextures();
 
@@ -445,7 +519,10 @@ void GraphicsContext::SetVertexBuffer(uint32_t slot, const Buffer* const vertexB
 }
 
 void GraphicsContext::SetVertexBuffers(uint32_t startSlot, const std::vector<const Buffer*>& vertexBuffers) noexcept {
-	std::vector<D3D12_VERTEX_BUFFER_VIEW> vbViews(vertexBuffers.size());
+	ScopedArenaMarker scratch;
+
+	FrameVector<D3D12_VERTEX_BUFFER_VIEW> vbViews(scratch.GetResource());
+	vbViews.reserve(vertexBuffers.size());
 
 	for (const auto vertexBuffer : vertexBuffers) {
 		if (vertexBuffer) {
@@ -460,12 +537,12 @@ void GraphicsContext::SetVertexBuffers(uint32_t startSlot, const std::vector<con
 
 void GraphicsContext::SetDynamicVertexBuffer(uint32_t slot, size_t numVertices, size_t vertexSize, const void* vertexBufferData) const {
 	const size_t bufferSize = numVertices * vertexSize;
-	const auto [CPU, GPU] = m_linearAllocator->Allocate(bufferSize, vertexSize);
+	const auto allocation   = m_uploadAllocator->Allocate(bufferSize, vertexSize);
 
-	std::memcpy(CPU, vertexBufferData, bufferSize);
+	std::memcpy(allocation.CPU, vertexBufferData, bufferSize);
 
 	const D3D12_VERTEX_BUFFER_VIEW vertexBufferView{
-		.BufferLocation = GPU,
+		.BufferLocation = allocation.GPU,
 		.SizeInBytes    = static_cast<uint32_t>(bufferSize),
 		.StrideInBytes  = static_cast<uint32_t>(vertexSize)
 	};
@@ -491,12 +568,12 @@ void GraphicsContext::SetIndexBuffer(const Buffer* const indexBuffer) noexcept {
 void GraphicsContext::SetDynamicIndexBuffer(size_t numIndicies, IndexFormat_t indexFormat, const void* indexBufferData) const {
 	const size_t indexSizeInBytes = indexFormat == IndexFormat_t::uint_16 ? 2 : 4;
 	const size_t bufferSize       = numIndicies * indexSizeInBytes;
-	const auto [CPU, GPU]         = m_linearAllocator->Allocate(bufferSize, indexSizeInBytes);
+	const auto allocation         = m_uploadAllocator->Allocate(bufferSize, indexSizeInBytes);
 
-	std::memcpy(CPU, indexBufferData, bufferSize);
+	std::memcpy(allocation.CPU, indexBufferData, bufferSize);
 
 	const D3D12_INDEX_BUFFER_VIEW indexBufferView{
-		.BufferLocation = GPU,
+		.BufferLocation = allocation.GPU,
 		.SizeInBytes    = static_cast<DWORD>(bufferSize),
 		.Format         = static_cast<DXGI_FORMAT>(indexFormat)
 	};
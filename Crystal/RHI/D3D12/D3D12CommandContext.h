@@ -12,12 +12,12 @@
 namespace Crystal {
 	class Buffer;
 	class DynamicDescriptorHeap;
-	class LinearAllocator;
 	class PipelineState;
 	class ResourceStateTracker;
 	class RootSignature;
 	class RenderTarget;
 	class Texture;
+	class UploadAllocator;
 	class Viewport;
 	class CommandContext {
 	public:
@@ -35,6 +35,9 @@ namespace Crystal {
             TransitionBarrierSpecification specification) const noexcept;
 		void CopyResource(const Texture& source, const Texture& dest) noexcept;
 		void CopyTextureSubresource(const Texture& texture, uint32_t firstSubresource, std::span<const D3D12_SUBRESOURCE_DATA> subresourceData);
+
+		//The data is copied into upload memory right away, it may be released as soon as the call returns
+		void CopyBuffer(const Buffer& buffer, std::span<const std::byte> data);
 		void ResolveSubResource(
 			const Texture* source,
 			const Texture* dest,
@@ -44,13 +47,22 @@ namespace Crystal {
 		[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList6> GetNativeCommandList() const noexcept { return m_d3d12CommandList; }
 
 		void SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, ID3D12DescriptorHeap* heap) noexcept;
+		[[nodiscard]] ID3D12DescriptorHeap* GetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType) const noexcept { return m_descriptorHeaps[heapType]; }
 		void SetPipelineState(const PipelineState* pipelineState) noexcept;
 
 		void Close() const noexcept;
 		bool Close(const CommandContext* pendingCmdList) const noexcept;
-		void Reset();
+
+		//Called by the queue, the upload memory of a submission is reused once its fence value has been reached
+		void OnSubmitted(uint64_t fenceValue);
+		void Reset(uint64_t completedFenceValue);
 
 		void TrackResource(const Microsoft::WRL::ComPtr<ID3D12Object>& object) noexcept;
+
+		//Shaders that read a texture through its bindless index bypass the descriptor tables, so nothing else transitions it,
+		//keeps it alive until the context is reset or reports its use to the residency manager. Every texture a draw or
+		//dispatch reaches that way has to be passed here before the work is recorded. Returns the index to hand to the shader.
+		uint32_t UseBindlessTexture(const Texture& texture, ResourceState_t stateAfter) noexcept;
 		void InsertUAVBarrier(const Texture& resource, bool flushImmediate = false) const noexcept;
 		void InsertAliasingBarrier(const Texture& before, const Texture& after, bool flushImmediate = false) const noexcept;
 
@@ -62,14 +74,19 @@ namespace Crystal {
 
 		void ReleaseTrackedObjects() noexcept;
 
+		//Binds the bindless descriptor heap and points the unbounded tables of the root signature at it
+		void BindBindlessDescriptorTables(const RootSignature& rootSignature, bool isCompute) noexcept;
+
 		void TransitionResource(
 			const Microsoft::WRL::ComPtr<ID3D12Resource>& resource,
 			TransitionBarrierSpecification specification) const noexcept;
 
+		void InitializePlacedTexture(const Texture& texture) const noexcept;
+
 		Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_commandAllocator;
 		Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList6> m_d3d12CommandList;
 
-		std::unique_ptr<LinearAllocator> m_linearAllocator;
+		std::unique_ptr<UploadAllocator> m_uploadAllocator;
 		std::unique_ptr<ResourceStateTracker> m_resourceStateTracker;
 
 		std::array<std::unique_ptr<DynamicDescriptorHeap>, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> m_dynamicDescriptorHeap;
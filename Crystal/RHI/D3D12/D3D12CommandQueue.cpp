@@ -8,6 +8,7 @@
 #include <algorithm>
 
 #include "Core/Logging/Logger.h"
+#include "Core/Memory/FrameArena.h"
 
 using namespace Crystal;
 
@@ -47,21 +48,30 @@ void CommandQueue::Submit(CommandContext* const context) {
 void CommandQueue::Submit(std::span<CommandContext* const> contexts) {
 	namespace rn = std::ranges;
 
-	std::vector<ID3D12CommandList*> commandLists;
+	ScopedArenaMarker scratch;
 
-	//commandLists.emplace_back((* contexts.begin())->GetNativeCommandList().Get());
+	FrameVector<ID3D12CommandList*> commandLists(scratch.GetResource());
+	commandLists.reserve(contexts.size());
 
 	for (const auto ctx : contexts) {
 		ctx->Close();
 		commandLists.emplace_back(ctx->GetNativeCommandList().Get());
 	}
 
-	m_d3d12CommandQueue->ExecuteCommandLists(1, commandLists.data());
+	m_d3d12CommandQueue->ExecuteCommandLists(static_cast<uint32_t>(commandLists.size()), commandLists.data());
 
-	WaitForFenceValue(Signal());
+	const auto fenceValue = Signal();
 
-	for(const auto ctx : contexts) {
-		ctx->Reset();
+	for (const auto ctx : contexts) {
+		ctx->OnSubmitted(fenceValue);
+	}
+
+	WaitForFenceValue(fenceValue);
+
+	const auto completedFenceValue = GetCompletedFenceValue();
+
+	for (const auto ctx : contexts) {
+		ctx->Reset(completedFenceValue);
 	}
 }
 
@@ -87,6 +97,10 @@ bool CommandQueue::IsFenceComplete(uint64_t fenceValue) const noexcept {
 	return m_fence->GetCompletedValue() >= fenceValue;
 }
 
+uint64_t CommandQueue::GetCompletedFenceValue() const noexcept {
+	return m_fence->GetCompletedValue();
+}
+
 void CommandQueue::Wait(const CommandQueue& rhs) const {
 	ThrowIfFailed(m_d3d12CommandQueue->Wait(rhs.m_fence.Get(), rhs.m_fenceValue));
 }
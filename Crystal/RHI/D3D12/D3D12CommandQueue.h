@@ -22,6 +22,11 @@ namespace Crystal {
 		void WaitForFenceValue(uint64_t fenceValue) const;
 
 		[[nodiscard]] bool IsFenceComplete(uint64_t fenceValue) const noexcept;
+		[[nodiscard]] uint64_t GetCompletedFenceValue() const noexcept;
+
+		//Resources released now are no longer used once this value has been signalled and reached,
+		//everything that may still reference them is submitted before or with the next signal
+		[[nodiscard]] uint64_t GetNextFenceValue() const noexcept { return m_fenceValue.load(std::memory_order_acquire) + 1; }
 		void Wait(const CommandQueue& rhs) const;
 
 		[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12CommandQueue> GetNativeCommandQueue() const noexcept { return m_d3d12CommandQueue; }
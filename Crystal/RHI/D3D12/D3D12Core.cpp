@@ -1,7 +1,9 @@
 #include "D3D12Core.h"
+#include "D3D12BindlessTable.h"
 #include "Utils/D3D12Exception.h"
 #include "D3D12CommandQueue.h"
 #include "D3D12CommandContext.h"
+#include "D3D12HeapAllocator.h"
 #include "Graphics/Types/Types.h"
 
 #include <dxgidebug.h>
@@ -18,6 +20,8 @@ namespace impl {
 		D3D_ROOT_SIGNATURE_VERSION HighestRootSignatureVersion;
 
 		std::array<std::unique_ptr<DescriptorAllocator>, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> DescriptorAllocators;
+		std::unique_ptr<BindlessDescriptorTable> BindlessTable;
+		std::unique_ptr<HeapAllocator> ResourceHeapAllocator;
 
 		std::unique_ptr<CommandQueue> GraphicsQueue;
 		std::unique_ptr<CommandQueue> ComputeQueue;
@@ -139,6 +143,15 @@ void RHICore::initialize() {
 	for (uint32_t i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++) {
 		data.DescriptorAllocators[i] = std::make_unique<DescriptorAllocator>(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(i));
 	}
+#if defined(CRYSTAL_BINDLESS_DYNAMIC_BLOCKS)
+	data.BindlessTable = std::make_unique<BindlessDescriptorTable>(
+		BindlessDescriptorTable::DEFAULT_NUM_PERSISTENT_DESCRIPTORS,
+		CRYSTAL_BINDLESS_DYNAMIC_BLOCKS);
+#else
+	data.BindlessTable = std::make_unique<BindlessDescriptorTable>();
+#endif
+
+	data.ResourceHeapAllocator = std::make_unique<HeapAllocator>();
 
 
 	//Acquire highest root signature version
@@ -169,9 +182,20 @@ DescriptorAllocation RHICore::allocate_descriptors(D3D12_DESCRIPTOR_HEAP_TYPE ty
 }
 
 void RHICore::release_stale_descriptors() noexcept {
+	const auto completedFenceValue = data.GraphicsQueue->GetCompletedFenceValue();
+
 	for (uint32_t i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++) {
-		data.DescriptorAllocators[i]->ReleaseStaleDescriptors();
+		data.DescriptorAllocators[i]->ReleaseStaleDescriptors(completedFenceValue);
 	}
+	data.BindlessTable->ReleaseStaleIndices(completedFenceValue);
+}
+
+BindlessDescriptorTable& RHICore::get_bindless_table() noexcept { return *data.BindlessTable.get(); }
+
+HeapAllocator& RHICore::get_heap_allocator() noexcept { return *data.ResourceHeapAllocator.get(); }
+
+void RHICore::release_stale_heap_allocations() noexcept {
+	data.ResourceHeapAllocator->ReleaseStaleAllocations();
 }
 
 CommandQueue& RHICore::get_graphics_queue() noexcept { return *data.GraphicsQueue.get(); }
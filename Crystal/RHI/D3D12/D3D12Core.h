@@ -12,10 +12,12 @@
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "dxguid.lib")
 
-namespace Crystal { class CommandQueue; }
+namespace Crystal { class BindlessDescriptorTable; class CommandQueue; class HeapAllocator; }
 
 namespace Crystal::RHICore {
+	using Crystal::BindlessDescriptorTable;
 	using Crystal::CommandQueue;
+	using Crystal::HeapAllocator;
 
 	void initialize();
 
@@ -27,6 +29,11 @@ namespace Crystal::RHICore {
 	[[nodiscard]] DescriptorAllocation allocate_descriptors(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors = 1) noexcept;
 	void release_stale_descriptors() noexcept;
 
+	[[nodiscard]] BindlessDescriptorTable& get_bindless_table() noexcept;
+
+	[[nodiscard]] HeapAllocator& get_heap_allocator() noexcept;
+	void release_stale_heap_allocations() noexcept;
+
 	[[nodiscard]] CommandQueue& get_graphics_queue() noexcept;
 	[[nodiscard]] CommandQueue& get_compute_queue() noexcept;
 	[[nodiscard]] CommandQueue& get_copy_queue()    noexcept;
@@ -1,8 +1,11 @@
 #include "D3D12DescriptorHeap.h"
 #include "D3D12Core.h"
+#include "D3D12CommandQueue.h"
 #include "Utils/D3D12Exception.h"
+#include "Core/Memory/MemoryTracker.h"
 #include <cassert>
 #include <algorithm>
+#include <array>
 #include <utility>
 
 //Stupid fucking macros.
@@ -20,6 +23,7 @@ using namespace Crystal;
 
 DescriptorAllocatorPage::DescriptorAllocatorPage(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors)
 	:
+	m_allocator(numDescriptors),
 	m_heapType(type),
 	m_numDescriptorsInHeap(numDescriptors)
 {
@@ -36,61 +40,33 @@ DescriptorAllocatorPage::DescriptorAllocatorPage(D3D12_DESCRIPTOR_HEAP_TYPE type
 
 	m_baseDescriptor                = m_d3d12DescriptorHeap->GetCPUDescriptorHandleForHeapStart();
 	m_descriptorHandleIncrementSize = device.GetDescriptorHandleIncrementSize(m_heapType);
-	m_numFreeHandles                = m_numDescriptorsInHeap;
-
-	// Initialize the free lists
-	AddNewBlock(0, m_numFreeHandles);
 }
 
 DescriptorAllocation DescriptorAllocatorPage::Allocate(uint32_t numDescriptors) noexcept {
 	std::scoped_lock lock(m_allocationMutex);
 
-	// If There are less than the requested number of descriptors left in the heap,
-	// return a NULL descriptor and try another heap
-	if (numDescriptors > m_numFreeHandles) {
-		return {};
-	}
-
-	//Get the first block that is large enough to satisfy the request
-	const auto smallestBlockIterator = m_freeListBySize.lower_bound(numDescriptors);
+	//A NULL descriptor tells the caller to try another heap
+	const auto offset = m_allocator.Allocate(numDescriptors);
 
-	if (smallestBlockIterator == m_freeListBySize.end()) {
-		// There was no free block that could satisfy the request
+	if (!offset) {
 		return {};
 	}
 
-	//The size of the smallest block that satisfies the request
-	const auto blockSize        = smallestBlockIterator->first;
-	//The pointer to the same entry in the FreeListByOffset map
-	const auto offsetIterator   = smallestBlockIterator->second;
-	//The offset in the descriptor heap
-	const auto offset           = offsetIterator->first;
-
-	//Remove the existing free block from the free list
-	m_freeListBySize.erase(smallestBlockIterator);
-	m_freeListByOffset.erase(offsetIterator);
-
-	//Compute the new free block that results from splitting this block
-	const auto newOffset = offset + numDescriptors;
-	const auto newSize   = blockSize - numDescriptors;
-
-	if (newSize > 0) {
-		// If the allocation didn't exactly match the requested size,
-		// return the left-over to the free list
-		AddNewBlock(newOffset, newSize);
-	}
-
-	m_numFreeHandles -= numDescriptors;
-
 	return {
-		CD3DX12_CPU_DESCRIPTOR_HANDLE(m_baseDescriptor, offset, m_descriptorHandleIncrementSize),
+		CD3DX12_CPU_DESCRIPTOR_HANDLE(m_baseDescriptor, *offset, m_descriptorHandleIncrementSize),
 		numDescriptors,
 		m_descriptorHandleIncrementSize,
 		shared_from_this() };
 }
 
+//Only a hint, the free descriptors might not be consecutive
 bool DescriptorAllocatorPage::HasSpace(uint32_t numDescriptors) const noexcept {
-	return m_freeListBySize.lower_bound(numDescriptors) != m_freeListBySize.end();
+	return NumFreeHandles() >= numDescriptors;
+}
+
+uint32_t DescriptorAllocatorPage::NumFreeHandles() const noexcept {
+	std::scoped_lock lock(m_allocationMutex);
+	return m_allocator.GetFreeCount();
 }
 
 void Crystal::DescriptorAllocatorPage::Free(DescriptorAllocation&& descriptor) noexcept {
@@ -98,96 +74,24 @@ void Crystal::DescriptorAllocatorPage::Free(DescriptorAllocation&& descriptor) n
 	const auto offset = ComputeOffset(descriptor.GetDescriptorHandle());
 
 	std::scoped_lock lock(m_allocationMutex);
-	//Don't add the block directly to the free list until the frame has completed
-	m_staleDescriptors.emplace(offset, descriptor.GetNumHandles());
-}
+	ScopedMemoryTag memoryTag(MemoryTag::Descriptors);
 
-void Crystal::DescriptorAllocatorPage::ReleaseStaleDescriptors() noexcept {
-	std::scoped_lock lock(m_allocationMutex);
+	//Command lists recorded so far may still reference the descriptors, they are submitted before or with the next signal.
+	//Reading the fence under the lock keeps the deferred ranges ordered by fence value.
+	const auto fenceValue = RHICore::get_graphics_queue().GetNextFenceValue();
 
-	while (!m_staleDescriptors.empty()) {
-		const auto& staleDescriptor = m_staleDescriptors.front();
-
-		const auto offset           = staleDescriptor.Offset;
-		const auto numDescriptors   = staleDescriptor.Size;
+	m_allocator.FreeDeferred(offset, descriptor.GetNumHandles(), fenceValue);
+}
 
-		FreeBlock(offset, numDescriptors);
+void Crystal::DescriptorAllocatorPage::ReleaseStaleDescriptors(uint64_t completedFenceValue) noexcept {
+	std::scoped_lock lock(m_allocationMutex);
 
-		m_staleDescriptors.pop();
-	}
+	m_allocator.ReleaseCompleted(completedFenceValue);
 }
 
 uint32_t Crystal::DescriptorAllocatorPage::ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle) noexcept {
 	return static_cast<uint32_t>(handle.ptr - m_baseDescriptor.ptr) / m_descriptorHandleIncrementSize;
 }
-
-void Crystal::DescriptorAllocatorPage::AddNewBlock(uint32_t offset, uint32_t numDescriptors) noexcept {
-	const auto offsetIterator = m_freeListByOffset.emplace(offset, numDescriptors);
-	const auto sizeIterator   = m_freeListBySize.emplace(numDescriptors, offsetIterator.first);
-
-	offsetIterator.first->second.FreeListBySizeIt = sizeIterator;
-}
-
-void Crystal::DescriptorAllocatorPage::FreeBlock(uint32_t offset, uint32_t numDescriptors) noexcept {
-	//Find the first element whose offset is greater than the specified offset.
-	//This is the block that should appear after the block that is being freed.
-	const auto nextBlockIterator = m_freeListByOffset.upper_bound(offset);
-
-	//Find the block that appears before the block being freed
-	auto prevBlockIterator = nextBlockIterator;
-
-	//If it's not the first block in the list
-	if (prevBlockIterator != m_freeListByOffset.begin()) {
-		//Go to the previous block in the list
-		--prevBlockIterator;
-	}
-	else {
-		//Otherwise, set it to the end of the list to indicate that no
-		//block comes before the one being freed
-		prevBlockIterator = m_freeListByOffset.end();
-	}
-
-	//Add the number of free handles back to the heap.
-	//This needs to be done before merging any blocks since merging
-	//blocks modifies the numDescriptors variable.
-	m_numFreeHandles += numDescriptors;
-
-	if (prevBlockIterator != m_freeListByOffset.end() &&
-		offset == prevBlockIterator->first + prevBlockIterator->second.Size) 
-	{
-		// The previous block is exactly behind the block that is to be freed.
-		//
-		//PrevBlock.Offset           Offset
-		//|                          |
-		//|<-----PrevBlock.Size----->|<------Size------>|
-
-		//Increase the block size by the size of merging with the previous block
-		offset = prevBlockIterator->first;
-		numDescriptors += prevBlockIterator->second.Size;
-
-		//Remove the previous block from the free list
-		m_freeListBySize.erase(prevBlockIterator->second.FreeListBySizeIt);
-		m_freeListByOffset.erase(prevBlockIterator);
-	}
-
-	if (nextBlockIterator != m_freeListByOffset.end() && offset + numDescriptors == nextBlockIterator->first) {
-		// The next block is exactly in front of the block that is to be freed.
-	  //
-	  // Offset               NextBlock.Offset 
-	  // |                    |
-	  // |<------Size-------->|<-----NextBlock.Size----->|
-
-	  //Increase the block size by the size of merging with the next block
-		numDescriptors += nextBlockIterator->second.Size;
-
-		//Remove the next block from the free list
-		m_freeListBySize.erase(nextBlockIterator->second.FreeListBySizeIt);
-		m_freeListByOffset.erase(nextBlockIterator);
-	}
-
-	//Add the freed block to the free list
-	AddNewBlock(offset, numDescriptors);
-}
 #pragma endregion
 
 #pragma region DescriptorAllocation
@@ -262,6 +166,13 @@ void DescriptorAllocation::Free() noexcept {
 		m_page.reset();
 	}
 }
+
+void DescriptorAllocation::Detach() noexcept {
+	m_descriptor.ptr = 0;
+	m_numHandles     = 0;
+	m_descriptorSize = 0;
+	m_page.reset();
+}
 #pragma endregion
 
 #pragma region DescriptorAllocator
@@ -275,7 +186,62 @@ Crystal::DescriptorAllocator::DescriptorAllocator(
 {}
 
 DescriptorAllocation Crystal::DescriptorAllocator::Allocate(uint32_t numDescriptors) noexcept {
+	if (numDescriptors != 1) {
+		return AllocateFromPages(numDescriptors);
+	}
+
+	//Most allocations are single views, handing them out from a thread local cache keeps them off the allocator lock
+	struct ThreadCache {
+		const DescriptorAllocator* Owner{ nullptr };
+		std::vector<DescriptorAllocation> Descriptors;
+	};
+
+	thread_local std::array<ThreadCache, D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES> threadCaches;
+	auto& cache = threadCaches[m_heapType];
+
+	if (cache.Owner != this) {
+		cache.Descriptors.clear();
+		cache.Owner = this;
+	}
+
+	if (cache.Descriptors.empty()) [[unlikely]] {
+		RefillThreadCache(cache.Descriptors);
+
+		if (cache.Descriptors.empty()) {
+			return {};
+		}
+	}
+
+	auto allocation = std::move(cache.Descriptors.back());
+	cache.Descriptors.pop_back();
+
+	return allocation;
+}
+
+void Crystal::DescriptorAllocator::RefillThreadCache(std::vector<DescriptorAllocation>& cache) noexcept {
+	ScopedMemoryTag memoryTag(MemoryTag::Descriptors);
+
+	//One range split into single descriptors, the bitmap lets every one of them be freed on its own
+	auto batch = AllocateFromPages(THREAD_CACHE_BATCH_SIZE);
+
+	if (batch.IsNull()) {
+		cache.emplace_back(AllocateFromPages(1));
+		return;
+	}
+
+	cache.reserve(THREAD_CACHE_BATCH_SIZE);
+
+	//Handed out from the back, so the lowest descriptor goes first
+	for (uint32_t i = THREAD_CACHE_BATCH_SIZE; i-- > 0;) {
+		cache.emplace_back(batch.GetDescriptorHandle(i), 1, batch.m_descriptorSize, batch.m_page);
+	}
+
+	batch.Detach();
+}
+
+DescriptorAllocation Crystal::DescriptorAllocator::AllocateFromPages(uint32_t numDescriptors) noexcept {
 	std::scoped_lock lock(m_allocationMutex);
+	ScopedMemoryTag memoryTag(MemoryTag::Descriptors);
 
 	DescriptorAllocation allocation;
 
@@ -309,13 +275,14 @@ DescriptorAllocation Crystal::DescriptorAllocator::Allocate(uint32_t numDescript
 	return allocation;
 }
 
-void Crystal::DescriptorAllocator::ReleaseStaleDescriptors() noexcept {
+void Crystal::DescriptorAllocator::ReleaseStaleDescriptors(uint64_t completedFenceValue) noexcept {
 	std::scoped_lock lock(m_allocationMutex);
+	ScopedMemoryTag memoryTag(MemoryTag::Descriptors);
 
 	for (size_t i = 0; i < m_heapPool.size(); i++) {
 		auto page = m_heapPool[i];
 
-		page->ReleaseStaleDescriptors();
+		page->ReleaseStaleDescriptors(completedFenceValue);
 
 		if (page->NumFreeHandles() > 0) {
 			m_availableHeaps.insert(i);
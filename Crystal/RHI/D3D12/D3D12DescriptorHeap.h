@@ -1,13 +1,12 @@
 #pragma once
 
-#include <map>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <vector>
 #include <wrl.h>
 #include <set>
 
+#include "Core/Memory/BitmapRangeAllocator.h"
 #include "Utils/d3dx12.h"
 
 namespace Crystal {
@@ -32,8 +31,13 @@ namespace Crystal {
         [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandle(uint32_t offset = 0) const;
         [[nodiscard]] uint32_t GetNumHandles() const noexcept { return m_numHandles; };
     private:
+        friend class DescriptorAllocator;
+
         void Free() noexcept;
 
+        //Gives up ownership without freeing, used when the descriptors have been handed to other allocations
+        void Detach() noexcept;
+
         D3D12_CPU_DESCRIPTOR_HANDLE m_descriptor;
         uint32_t m_numHandles;
         uint32_t m_descriptorSize;
@@ -46,49 +50,15 @@ namespace Crystal {
         ~DescriptorAllocatorPage() = default;
 
         [[nodiscard]] bool HasSpace(uint32_t numDescriptors) const noexcept;
-        [[nodiscard]] uint32_t NumFreeHandles() const noexcept { return m_numFreeHandles; }
+        [[nodiscard]] uint32_t NumFreeHandles() const noexcept;
         [[nodiscard]] DescriptorAllocation Allocate(uint32_t numDescriptors) noexcept;
         [[nodiscard]] uint32_t ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle) noexcept;
 
+        //The descriptors are reused once the graphics queue has passed the fence value it will signal next
         void Free(DescriptorAllocation&& descriptor) noexcept;
-        void ReleaseStaleDescriptors() noexcept;
-        void AddNewBlock(uint32_t offset, uint32_t numDescriptors) noexcept;
-        void FreeBlock(uint32_t offset, uint32_t numDescriptors) noexcept;
+        void ReleaseStaleDescriptors(uint64_t completedFenceValue) noexcept;
     private:
-        struct FreeBlockInfo;
-        using FreeListByOffset = std::map<size_t, FreeBlockInfo>;
-
-        // A map that lists the free blocks by size.
-        // Needs to be a multimap since multiple blocks can have the same size.
-        using FreeListBySize = std::multimap<size_t, FreeListByOffset::iterator>;
-
-        struct FreeBlockInfo {
-            FreeBlockInfo(size_t size)
-                :
-                Size(size)
-            {}
-            size_t Size;
-            FreeListBySize::iterator FreeListBySizeIt;
-        };
-
-        struct StaleDescriptorInfo {
-            StaleDescriptorInfo(size_t offset, size_t size)
-                :
-                Offset(offset),
-                Size(size)
-            {}
-
-            // The offset within the descriptor heap.
-            size_t Offset;
-            // The number of descriptors
-            size_t Size;
-        };
-
-        using StaleDescriptorQueue = std::queue<StaleDescriptorInfo>;
-
-        FreeListByOffset m_freeListByOffset;
-        FreeListBySize m_freeListBySize;
-        StaleDescriptorQueue m_staleDescriptors;
+        BitmapRangeAllocator m_allocator;
 
         Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_d3d12DescriptorHeap;
         D3D12_DESCRIPTOR_HEAP_TYPE m_heapType;
@@ -97,9 +67,8 @@ namespace Crystal {
 
         uint32_t m_descriptorHandleIncrementSize;
         uint32_t m_numDescriptorsInHeap;
-        uint32_t m_numFreeHandles;
 
-        std::mutex m_allocationMutex;
+        mutable std::mutex m_allocationMutex;
     };
 
     class DescriptorAllocator {
@@ -107,9 +76,15 @@ namespace Crystal {
         DescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors = 256) noexcept;
         ~DescriptorAllocator() = default;
 
+        //Single descriptors come from a cache of the calling thread, refilled in batches
         [[nodiscard]] DescriptorAllocation Allocate(uint32_t numDescriptors = 1) noexcept;
-        void ReleaseStaleDescriptors() noexcept;
+        void ReleaseStaleDescriptors(uint64_t completedFenceValue) noexcept;
     private:
+        static constexpr uint32_t THREAD_CACHE_BATCH_SIZE = 16;
+
+        [[nodiscard]] DescriptorAllocation AllocateFromPages(uint32_t numDescriptors) noexcept;
+        void RefillThreadCache(std::vector<DescriptorAllocation>& cache) noexcept;
+
         friend struct std::default_delete<DescriptorAllocator>;
         [[nodiscard]] std::shared_ptr<DescriptorAllocatorPage> CreateAllocatorPage() noexcept;
 
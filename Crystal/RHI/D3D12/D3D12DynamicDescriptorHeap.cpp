@@ -1,10 +1,13 @@
 #include "D3D12DynamicDescriptorHeap.h"
+#include "D3D12BindlessTable.h"
 #include "D3D12Core.h"
 #include "D3D12CommandContext.h"
 #include "D3D12RootSignature.h"
 
 #include "Utils/D3D12Exception.h"
 #include "Core/Logging/Logger.h"
+#include <bit>
+#include <cassert>
 #include <stdexcept>
 
 using namespace Crystal;
@@ -13,7 +16,8 @@ using namespace Microsoft::WRL;
 DynamicDescriptorHeap::DynamicDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t numDescriptorsPerHeap) noexcept
     :
     m_descriptorHeapType(heapType),
-    m_numDescriptorsPerHeap(numDescriptorsPerHeap),
+    //CBV/SRV/UAV descriptors are staged in blocks of the bindless table, which all have the same size
+    m_numDescriptorsPerHeap(heapType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV ? BindlessDescriptorTable::DYNAMIC_BLOCK_SIZE : numDescriptorsPerHeap),
     m_descriptorTableBitMask(0),
     m_currentCPUDescriptorHandle(D3D12_DEFAULT),
     m_currentGPUDescriptorHandle(D3D12_DEFAULT),
@@ -23,6 +27,15 @@ DynamicDescriptorHeap::DynamicDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType
 
     m_descriptorHandleIncrementSize = device.GetDescriptorHandleIncrementSize(heapType);
     m_descriptorHandleCache         = std::make_unique<D3D12_CPU_DESCRIPTOR_HANDLE[]>(m_numDescriptorsPerHeap);
+    m_staleDescriptors.reserve(m_numDescriptorsPerHeap);
+}
+
+DynamicDescriptorHeap::~DynamicDescriptorHeap() {
+    for (const auto& block : m_descriptorBlockPool) {
+        if (block.BindlessOffset) {
+            RHICore::get_bindless_table().FreeDynamicBlock(*block.BindlessOffset);
+        }
+    }
 }
 
 void Crystal::DynamicDescriptorHeap::StageDescriptors(
@@ -73,14 +86,10 @@ D3D12_GPU_DESCRIPTOR_HANDLE DynamicDescriptorHeap::CopyDescriptor(
     D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptor) noexcept
 {
     if (!m_currentDescriptorHeap || m_numFreeHandles < 1) {
-        m_currentDescriptorHeap = RequestDescriptorHeap();
-        m_currentCPUDescriptorHandle = m_currentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-        m_currentGPUDescriptorHandle = m_currentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-        m_numFreeHandles = m_numDescriptorsPerHeap;
-
-        commandList.SetDescriptorHeap(m_descriptorHeapType, m_currentDescriptorHeap.Get());
-
-        m_staleDescriptorTableBitMask = m_descriptorTableBitMask;
+        SetCurrentDescriptorBlock(commandList, RequestDescriptorBlock());
+    }
+    else {
+        BindCurrentDescriptorHeap(commandList);
     }
 
     auto& device = RHICore::get_device();
@@ -145,15 +154,15 @@ void DynamicDescriptorHeap::ParseRootSignature(const RootSignature* const rootSi
        }
     }
 
-    if (currentoffset <= m_numDescriptorsPerHeap) {
+    if (currentoffset > m_numDescriptorsPerHeap) {
         Logger::Warning("The root signature requires more than the maximum number of descriptors per descriptor heap."
             " Consider increasing the maximum number of descriptors per descriptor heap.");
     }
 }
 
 void Crystal::DynamicDescriptorHeap::Reset() noexcept {
-    m_availableDescriptorHeaps    = m_descriptorHeapPool;
-    m_currentDescriptorHeap.Reset();
+    m_numUsedBlocks               = 0;
+    m_currentDescriptorHeap       = nullptr;
     m_currentCPUDescriptorHandle  = CD3DX12_CPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
     m_currentGPUDescriptorHandle  = CD3DX12_GPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
     m_numFreeHandles              = 0;
@@ -169,79 +178,90 @@ void DynamicDescriptorHeap::Bind(
     CommandContext& context,
     SetDescriptorTableCB setDescriptorTable) noexcept
 {
-    const auto numDescriptorsToBind = GetStaleDescriptorCount();
+    auto numDescriptorsToBind = GetStaleDescriptorCount();
 
-    if (numDescriptorsToBind > 0) {
-        auto& device     = RHICore::get_device();
-        auto d3d12commandList = context.GetNativeCommandList().Get();
+    if (numDescriptorsToBind == 0) {
+        return;
+    }
 
-        if (m_currentDescriptorHeap == nullptr || m_numFreeHandles < numDescriptorsToBind) {
-            m_currentDescriptorHeap      = RequestDescriptorHeap();
-            m_currentCPUDescriptorHandle = m_currentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-            m_currentGPUDescriptorHandle = m_currentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-            m_numFreeHandles             = m_numDescriptorsPerHeap;
+    BindCurrentDescriptorHeap(context);
+    numDescriptorsToBind = GetStaleDescriptorCount();
 
-            context.SetDescriptorHeap(m_descriptorHeapType, m_currentDescriptorHeap.Get());
+    if (m_currentDescriptorHeap == nullptr || m_numFreeHandles < numDescriptorsToBind) {
+        SetCurrentDescriptorBlock(context, RequestDescriptorBlock());
 
-            m_staleDescriptorTableBitMask = m_descriptorTableBitMask;
-        }
+        //Switching heaps makes every table stale, not just the ones that were staged
+        numDescriptorsToBind = GetStaleDescriptorCount();
+    }
 
-        static constexpr auto numBits = sizeof(m_staleDescriptorTableBitMask) * 8;
-
-        //Only enter the loop if any of the bits are set
-        if (m_staleDescriptorTableBitMask > 0) [[likely]] {
-            for (int i = 0; i < numBits; i++) {
-                //if no bits are set we exit the loop
-                if (m_staleDescriptorTableBitMask == 0) {
-                    break;
-                }
-                else if ((m_staleDescriptorTableBitMask >> i) & 1) {
-                    uint32_t numDescriptors                            = m_descriptorTableCache[i].NumDescriptors;
-                    D3D12_CPU_DESCRIPTOR_HANDLE* pSrcDescriptorHandles = m_descriptorTableCache[i].BaseDescriptor;
-
-                    std::array destDescriptorRangeStarts = { m_currentCPUDescriptorHandle };
-                    std::array destDescriptorRangeSizes  = { numDescriptors };
-
-                    device.CopyDescriptors(
-                        1,
-                        destDescriptorRangeStarts.data(),
-                        destDescriptorRangeSizes.data(),
-                        numDescriptors,
-                        pSrcDescriptorHandles,
-                        nullptr,
-                        m_descriptorHeapType);
-
-                    setDescriptorTable(d3d12commandList, i, m_currentGPUDescriptorHandle);
-
-                    m_currentCPUDescriptorHandle.Offset(numDescriptors, m_descriptorHandleIncrementSize);
-                    m_currentGPUDescriptorHandle.Offset(numDescriptors, m_descriptorHandleIncrementSize);
-
-                    m_numFreeHandles -= numDescriptors;
-
-                    //Flip the bit in order to reduce the number of iterations.
-                    m_staleDescriptorTableBitMask ^= (1 << i);
-                }
-            }
-        }
+    //The tables are written into the current block, they are only valid while its heap is the bound one
+    assert(context.GetDescriptorHeap(m_descriptorHeapType) == m_currentDescriptorHeap);
+
+    //Gather the descriptors of all stale tables and copy them in one go, they end up next to each other
+    m_staleDescriptors.clear();
+
+    for (auto staleBitMask = m_staleDescriptorTableBitMask; staleBitMask != 0; staleBitMask &= staleBitMask - 1) {
+        const auto& descriptorTableCache = m_descriptorTableCache[std::countr_zero(staleBitMask)];
+
+        m_staleDescriptors.insert(
+            m_staleDescriptors.end(),
+            descriptorTableCache.BaseDescriptor,
+            descriptorTableCache.BaseDescriptor + descriptorTableCache.NumDescriptors);
     }
-}
 
-ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::RequestDescriptorHeap() {
-    ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+    //Source descriptors are single handles from anywhere in the CPU heaps, a null range size array means one each
+    D3D12_CPU_DESCRIPTOR_HANDLE destDescriptorRangeStart = m_currentCPUDescriptorHandle;
+
+    RHICore::get_device().CopyDescriptors(
+        1,
+        &destDescriptorRangeStart,
+        &numDescriptorsToBind,
+        numDescriptorsToBind,
+        m_staleDescriptors.data(),
+        nullptr,
+        m_descriptorHeapType);
+
+    auto d3d12commandList = context.GetNativeCommandList().Get();
+
+    for (; m_staleDescriptorTableBitMask != 0; m_staleDescriptorTableBitMask &= m_staleDescriptorTableBitMask - 1) {
+        const auto rootParameterIndex = static_cast<uint32_t>(std::countr_zero(m_staleDescriptorTableBitMask));
+        const auto numDescriptors     = m_descriptorTableCache[rootParameterIndex].NumDescriptors;
 
-    if (!m_availableDescriptorHeaps.empty()) {
-        descriptorHeap = m_availableDescriptorHeaps.front();
-        m_availableDescriptorHeaps.pop();
+        setDescriptorTable(d3d12commandList, rootParameterIndex, m_currentGPUDescriptorHandle);
+
+        m_currentCPUDescriptorHandle.Offset(numDescriptors, m_descriptorHandleIncrementSize);
+        m_currentGPUDescriptorHandle.Offset(numDescriptors, m_descriptorHandleIncrementSize);
     }
-    else {
-        descriptorHeap = CreateDescriptorHeap();
-        m_descriptorHeapPool.push(descriptorHeap);
+
+    m_numFreeHandles -= numDescriptorsToBind;
+}
+
+DynamicDescriptorHeap::DescriptorBlock DynamicDescriptorHeap::RequestDescriptorBlock() {
+    if (m_numUsedBlocks == m_descriptorBlockPool.size()) {
+        m_descriptorBlockPool.push_back(CreateDescriptorBlock());
     }
 
-    return descriptorHeap;
+    return m_descriptorBlockPool[m_numUsedBlocks++];
 }
 
-ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::CreateDescriptorHeap() {
+DynamicDescriptorHeap::DescriptorBlock DynamicDescriptorHeap::CreateDescriptorBlock() {
+    if (m_descriptorHeapType == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV) {
+        auto& bindlessTable = RHICore::get_bindless_table();
+
+        if (const auto firstDescriptor = bindlessTable.AllocateDynamicBlock()) [[likely]] {
+            return {
+                .Heap           = bindlessTable.GetDescriptorHeap(),
+                .CPU            = bindlessTable.GetCPUDescriptorHandle(*firstDescriptor),
+                .GPU            = bindlessTable.GetGPUDescriptorHandle(*firstDescriptor),
+                .BindlessOffset = firstDescriptor
+            };
+        }
+
+        Logger::Warning("The bindless descriptor table has no dynamic blocks left, descriptor tables are staged in a separate heap."
+            " It replaces the bindless heap whenever staged tables are bound, draws and dispatches that use them can not access"
+            " bindless descriptors.");
+    }
+
     auto& device = RHICore::get_device();
 
     D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesk = {
@@ -253,7 +273,37 @@ ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::CreateDescriptorHeap() {
     ComPtr<ID3D12DescriptorHeap> descriptorHeap;
     ThrowIfFailed(device.CreateDescriptorHeap(&descriptorHeapDesk, IID_PPV_ARGS(&descriptorHeap)));
 
-    return descriptorHeap;
+    m_ownedDescriptorHeaps.push_back(descriptorHeap);
+
+    return {
+        .Heap = descriptorHeap.Get(),
+        .CPU  = descriptorHeap->GetCPUDescriptorHandleForHeapStart(),
+        .GPU  = descriptorHeap->GetGPUDescriptorHandleForHeapStart()
+    };
+}
+
+void DynamicDescriptorHeap::SetCurrentDescriptorBlock(CommandContext& context, const DescriptorBlock& block) noexcept {
+    //Tables bound before still point into their old block, which stays valid until the context is reset
+    if (m_currentDescriptorHeap != block.Heap) {
+        m_staleDescriptorTableBitMask = m_descriptorTableBitMask;
+    }
+
+    m_currentDescriptorHeap      = block.Heap;
+    m_currentCPUDescriptorHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(block.CPU);
+    m_currentGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(block.GPU);
+    m_numFreeHandles             = m_numDescriptorsPerHeap;
+
+    context.SetDescriptorHeap(m_descriptorHeapType, m_currentDescriptorHeap);
+}
+
+void DynamicDescriptorHeap::BindCurrentDescriptorHeap(CommandContext& context) noexcept {
+    //Setting a root signature binds the bindless heap again, which only holds the current block if it is a bindless one
+    if (m_currentDescriptorHeap && context.GetDescriptorHeap(m_descriptorHeapType) != m_currentDescriptorHeap) {
+        context.SetDescriptorHeap(m_descriptorHeapType, m_currentDescriptorHeap);
+
+        //Tables bound while the other heap was set point into it, they have to be copied into the current block again
+        m_staleDescriptorTableBitMask = m_descriptorTableBitMask;
+    }
 }
 
 constexpr uint32_t DynamicDescriptorHeap::GetStaleDescriptorCount() const noexcept {
@@ -2,9 +2,10 @@
 #include "Utils/d3dx12.h"
 #include <wrl.h>
 #include <memory>
-#include <queue>
+#include <optional>
 #include <functional>
 #include <array>
+#include <vector>
 
 namespace Crystal {
 	using SetDescriptorTableCB = std::function<void(ID3D12GraphicsCommandList*, UINT, D3D12_GPU_DESCRIPTOR_HANDLE)>;
@@ -23,9 +24,16 @@ namespace Crystal {
 		D3D12_CPU_DESCRIPTOR_HANDLE* BaseDescriptor{nullptr};
 	};
 
+	//Stages the descriptor tables of the bound root signature and copies the stale ones into a shader visible heap
+	//before a draw or dispatch. CBV/SRV/UAV tables are staged in blocks of the bindless descriptor table,
+	//so they share a heap with the bindless descriptors, samplers get shader visible heaps of their own.
 	class DynamicDescriptorHeap {
 	public:
 		DynamicDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, uint32_t numDescriptorsPerHeap = 1024) noexcept;
+		DynamicDescriptorHeap(const DynamicDescriptorHeap&)            = delete;
+		DynamicDescriptorHeap& operator=(const DynamicDescriptorHeap&) = delete;
+		~DynamicDescriptorHeap();
+
 		void StageDescriptors(
 			uint32_t rootParameterIndex,
 			uint32_t offset,
@@ -46,14 +54,28 @@ namespace Crystal {
 		void ParseRootSignature(const RootSignature* rootSignature) noexcept;
 		void Reset() noexcept;
 	private:
+		//A range of m_numDescriptorsPerHeap descriptors in a shader visible heap
+		struct DescriptorBlock {
+			ID3D12DescriptorHeap* Heap;
+			D3D12_CPU_DESCRIPTOR_HANDLE CPU;
+			D3D12_GPU_DESCRIPTOR_HANDLE GPU;
+
+			//First descriptor in the bindless descriptor table, blocks in a heap of their own have none
+			std::optional<uint32_t> BindlessOffset;
+		};
+
 		//Binds the descriptors to the command list. 
 		void Bind(
 			CommandContext& context,
 			SetDescriptorTableCB setDescriptorTable) noexcept;
-		//Request a descriptor heap if one is available.
-		[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> RequestDescriptorHeap();
-		//Create a new descriptor heap if no descriptor heap is available.
-		[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap();
+		//Request a descriptor block if one is available.
+		[[nodiscard]] DescriptorBlock RequestDescriptorBlock();
+		//Create a new descriptor block if no descriptor block is available.
+		[[nodiscard]] DescriptorBlock CreateDescriptorBlock();
+		//Makes the block the one descriptors are copied into, stages every table again if it lives in another heap.
+		void SetCurrentDescriptorBlock(CommandContext& context, const DescriptorBlock& block) noexcept;
+		//Binds the heap of the current block again if the context bound another one since, the bindless heap after a root signature change.
+		void BindCurrentDescriptorHeap(CommandContext& context) noexcept;
 
 		//Get the number of stale descriptors that need to be copied
 		//to GPU visible descriptor heap.
@@ -79,9 +101,15 @@ namespace Crystal {
 		std::array<DescriptorTableCache, MAX_DESCRIPTOR_TABLES> m_descriptorTableCache;
 		std::unique_ptr<D3D12_CPU_DESCRIPTOR_HANDLE[]> m_descriptorHandleCache;
 
-		Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_currentDescriptorHeap;
-		std::queue<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> m_descriptorHeapPool;
-		std::queue<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> m_availableDescriptorHeaps;
+		//Source descriptors of all stale tables, gathered so they are copied with a single call
+		std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> m_staleDescriptors;
+
+		ID3D12DescriptorHeap* m_currentDescriptorHeap{ nullptr };
+
+		//Blocks are kept for the lifetime of the context, blocks before m_numUsedBlocks are in use since the last reset
+		std::vector<DescriptorBlock> m_descriptorBlockPool;
+		size_t m_numUsedBlocks{ 0 };
+		std::vector<Microsoft::WRL::ComPtr<ID3D12DescriptorHeap>> m_ownedDescriptorHeaps;
 
 		CD3DX12_GPU_DESCRIPTOR_HANDLE m_currentGPUDescriptorHandle;
 		CD3DX12_CPU_DESCRIPTOR_HANDLE m_currentCPUDescriptorHandle;
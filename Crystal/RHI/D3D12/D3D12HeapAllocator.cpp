@@ -0,0 +1,204 @@
+#include "D3D12HeapAllocator.h"
+#include "D3D12Core.h"
+#include "D3D12CommandQueue.h"
+#include "Utils/D3D12Exception.h"
+#include "Utils/d3dx12.h"
+
+#include <algorithm>
+
+using namespace Crystal;
+using namespace Microsoft::WRL;
+
+namespace impl {
+	//Textures are placed at this granularity, buffers and textures that are too large for small placement at 64KB
+	constexpr uint64_t HEAP_GRANULARITY = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+
+	constexpr std::array<D3D12_HEAP_FLAGS, static_cast<size_t>(ResourceHeapClass::Count)> HEAP_FLAGS{
+		D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+		D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+	};
+
+	constexpr std::array<const wchar_t*, static_cast<size_t>(ResourceHeapClass::Count)> HEAP_NAMES{
+		L"Buffer Heap",
+		L"Texture Heap",
+		L"Render Target Heap"
+	};
+}
+
+ResourceHeapClass HeapAllocator::GetHeapClass(const D3D12_RESOURCE_DESC& resourceDesc) noexcept {
+	if (resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+		return ResourceHeapClass::Buffer;
+	}
+
+	if (resourceDesc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+		return ResourceHeapClass::RenderTargetDepthStencil;
+	}
+	return ResourceHeapClass::Texture;
+}
+
+D3D12_RESOURCE_ALLOCATION_INFO HeapAllocator::GetAllocationInfo(D3D12_RESOURCE_DESC& resourceDesc, ResourceHeapClass heapClass) {
+	auto& device = RHICore::get_device();
+
+	//Small textures can be placed at 4KB instead of 64KB, the device tells whether the texture qualifies
+	if (heapClass == ResourceHeapClass::Texture && resourceDesc.SampleDesc.Count == 1) {
+		resourceDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+
+		const auto allocationInfo = device.GetResourceAllocationInfo(0, 1, &resourceDesc);
+
+		if (allocationInfo.Alignment == D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT) {
+			return allocationInfo;
+		}
+	}
+
+	resourceDesc.Alignment = 0;
+	return device.GetResourceAllocationInfo(0, 1, &resourceDesc);
+}
+
+HeapAllocator::Heap HeapAllocator::CreateHeap(ResourceHeapClass heapClass) {
+	const D3D12_HEAP_DESC heapDesc{
+		.SizeInBytes = HEAP_SIZE,
+		.Properties  = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		.Alignment   = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+		.Flags       = impl::HEAP_FLAGS[static_cast<size_t>(heapClass)]
+	};
+
+	ComPtr<ID3D12Heap> d3d12Heap;
+	ThrowIfFailed(RHICore::get_device().CreateHeap(&heapDesc, IID_PPV_ARGS(&d3d12Heap)));
+
+	d3d12Heap->SetName(impl::HEAP_NAMES[static_cast<size_t>(heapClass)]);
+
+	return { .D3d12Heap = std::move(d3d12Heap), .Allocator = TlsfAllocator(HEAP_SIZE, impl::HEAP_GRANULARITY) };
+}
+
+HeapResource HeapAllocator::CreateResource(
+	const D3D12_RESOURCE_DESC& resourceDesc,
+	D3D12_RESOURCE_STATES initialState,
+	const D3D12_CLEAR_VALUE* const clearValue)
+{
+	auto& device         = RHICore::get_device();
+	const auto heapClass = GetHeapClass(resourceDesc);
+
+	auto placedDesc           = resourceDesc;
+	const auto allocationInfo = GetAllocationInfo(placedDesc, heapClass);
+
+	HeapResource heapResource{ .Allocation = { .HeapClass = heapClass } };
+
+	//Multisampled textures need 4MB alignment and huge resources would take up a heap on their own, both are committed
+	if (allocationInfo.SizeInBytes > MAX_PLACED_SIZE || allocationInfo.Alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) {
+		const auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+
+		ThrowIfFailed(device.CreateCommittedResource(
+			&heapProperties,
+			D3D12_HEAP_FLAG_NONE,
+			&resourceDesc,
+			initialState,
+			clearValue,
+			IID_PPV_ARGS(&heapResource.Resource)));
+
+		return heapResource;
+	}
+
+	auto& pool = GetPool(heapClass);
+	std::scoped_lock lock(pool.Mutex);
+
+	ID3D12Heap* d3d12Heap = nullptr;
+
+	for (uint32_t i = 0; i < pool.Heaps.size() && !d3d12Heap; i++) {
+		if (const auto range = pool.Heaps[i].Allocator.Allocate(allocationInfo.SizeInBytes, allocationInfo.Alignment)) {
+			heapResource.Allocation.HeapIndex = i;
+			heapResource.Allocation.Range     = *range;
+			d3d12Heap                         = pool.Heaps[i].D3d12Heap.Get();
+		}
+	}
+
+	if (!d3d12Heap) {
+		auto& heap = pool.Heaps.emplace_back(CreateHeap(heapClass));
+
+		heapResource.Allocation.HeapIndex = static_cast<uint32_t>(pool.Heaps.size() - 1);
+		heapResource.Allocation.Range     = *heap.Allocator.Allocate(allocationInfo.SizeInBytes, allocationInfo.Alignment);
+		d3d12Heap                         = heap.D3d12Heap.Get();
+	}
+
+	const auto hr = device.CreatePlacedResource(
+		d3d12Heap,
+		heapResource.Allocation.Range.Offset,
+		&placedDesc,
+		initialState,
+		clearValue,
+		IID_PPV_ARGS(&heapResource.Resource));
+
+	if (FAILED(hr)) [[unlikely]] {
+		pool.Heaps[heapResource.Allocation.HeapIndex].Allocator.Free(heapResource.Allocation.Range);
+		ThrowIfFailed(hr);
+	}
+
+	heapResource.Allocation.NeedsInitialization = heapClass == ResourceHeapClass::RenderTargetDepthStencil;
+	return heapResource;
+}
+
+void HeapAllocator::Free(const HeapAllocation& allocation) {
+	if (!allocation.IsPlaced()) {
+		return;
+	}
+
+	auto& pool = GetPool(allocation.HeapClass);
+	std::scoped_lock lock(pool.Mutex);
+
+	//Work that still uses the old resource may be in flight, the range is reused after it has completed.
+	//Read under the lock, so the queue stays ordered by fence value for ReleaseStaleAllocations.
+	const auto fenceValue = RHICore::get_graphics_queue().GetNextFenceValue();
+
+	pool.StaleAllocations.push({ allocation, fenceValue });
+}
+
+void HeapAllocator::ReleaseStaleAllocations() noexcept {
+	const auto completedFenceValue = RHICore::get_graphics_queue().GetCompletedFenceValue();
+
+	for (auto& pool : m_pools) {
+		std::scoped_lock lock(pool.Mutex);
+
+		while (!pool.StaleAllocations.empty() && pool.StaleAllocations.front().FenceValue <= completedFenceValue) {
+			const auto& allocation = pool.StaleAllocations.front().Allocation;
+
+			pool.Heaps[allocation.HeapIndex].Allocator.Free(allocation.Range);
+			pool.StaleAllocations.pop();
+		}
+	}
+}
+
+TlsfStatistics HeapAllocator::GetStatistics(ResourceHeapClass heapClass) const {
+	const auto& pool = GetPool(heapClass);
+	std::scoped_lock lock(pool.Mutex);
+
+	TlsfStatistics statistics{};
+
+	for (const auto& heap : pool.Heaps) {
+		const auto heapStatistics = heap.Allocator.GetStatistics();
+
+		statistics.Capacity        += heapStatistics.Capacity;
+		statistics.UsedBytes       += heapStatistics.UsedBytes;
+		statistics.FreeBytes       += heapStatistics.FreeBytes;
+		statistics.Allocations     += heapStatistics.Allocations;
+		statistics.FreeBlocks      += heapStatistics.FreeBlocks;
+		statistics.LargestFreeBlock = std::max(statistics.LargestFreeBlock, heapStatistics.LargestFreeBlock);
+	}
+	return statistics;
+}
+
+std::vector<TlsfDefragmentationHint> HeapAllocator::GetDefragmentationHints(ResourceHeapClass heapClass, uint32_t heapIndex, size_t maxHints) const {
+	const auto& pool = GetPool(heapClass);
+	std::scoped_lock lock(pool.Mutex);
+
+	if (heapIndex >= pool.Heaps.size()) {
+		return {};
+	}
+	return pool.Heaps[heapIndex].Allocator.GetDefragmentationHints(maxHints);
+}
+
+uint32_t HeapAllocator::GetHeapCount(ResourceHeapClass heapClass) const {
+	const auto& pool = GetPool(heapClass);
+	std::scoped_lock lock(pool.Mutex);
+
+	return static_cast<uint32_t>(pool.Heaps.size());
+}
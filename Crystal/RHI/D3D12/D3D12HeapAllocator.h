@@ -0,0 +1,93 @@
+#pragma once
+#include <d3d12.h>
+#include <wrl.h>
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+#include "Core/Memory/MemoryConstants.h"
+#include "Core/Memory/TlsfAllocator.h"
+
+namespace Crystal {
+	//Heaps are split by the kind of resource they hold, resource heap tier 1 hardware can not mix them in one heap
+	enum class ResourceHeapClass : uint8_t {
+		Buffer,
+		Texture,
+		RenderTargetDepthStencil,
+		Count
+	};
+
+	struct HeapAllocation {
+		ResourceHeapClass HeapClass{};
+		uint32_t HeapIndex{};
+		TlsfAllocation Range;
+
+		//Placed render targets and depth stencils start out in memory another resource may have used. They have to be
+		//activated with an aliasing barrier and discarded before anything else uses them.
+		bool NeedsInitialization{ false };
+
+		//Committed resources have no range in one of the pooled heaps
+		[[nodiscard]] bool IsPlaced() const noexcept { return Range.IsValid(); }
+	};
+
+	struct HeapResource {
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+		HeapAllocation Allocation;
+	};
+
+	//Places resources in large heaps instead of giving each one its own committed allocation.
+	//The offsets inside a heap are managed by a TlsfAllocator, which knows nothing about D3D12.
+	class HeapAllocator {
+	public:
+		static constexpr uint64_t HEAP_SIZE = _64MB;
+
+		//Larger resources are committed, placing them would leave most of a heap unusable for anything else
+		static constexpr uint64_t MAX_PLACED_SIZE = _16MB;
+
+		HeapAllocator() = default;
+		HeapAllocator(const HeapAllocator&)            = delete;
+		HeapAllocator& operator=(const HeapAllocator&) = delete;
+
+		[[nodiscard]] HeapResource CreateResource(
+			const D3D12_RESOURCE_DESC& resourceDesc,
+			D3D12_RESOURCE_STATES initialState,
+			const D3D12_CLEAR_VALUE* clearValue = nullptr);
+
+		//The range is not handed out again before the GPU has finished the work submitted so far.
+		//The resource placed in it has to be released by the caller.
+		void Free(const HeapAllocation& allocation);
+		void ReleaseStaleAllocations() noexcept;
+
+		[[nodiscard]] TlsfStatistics GetStatistics(ResourceHeapClass heapClass) const;
+		[[nodiscard]] std::vector<TlsfDefragmentationHint> GetDefragmentationHints(ResourceHeapClass heapClass, uint32_t heapIndex, size_t maxHints) const;
+		[[nodiscard]] uint32_t GetHeapCount(ResourceHeapClass heapClass) const;
+
+		[[nodiscard]] static ResourceHeapClass GetHeapClass(const D3D12_RESOURCE_DESC& resourceDesc) noexcept;
+	private:
+		struct Heap {
+			Microsoft::WRL::ComPtr<ID3D12Heap> D3d12Heap;
+			TlsfAllocator Allocator;
+		};
+
+		struct StaleAllocation {
+			HeapAllocation Allocation;
+			uint64_t FenceValue;
+		};
+
+		struct Pool {
+			mutable std::mutex Mutex;
+			std::vector<Heap> Heaps;
+			std::queue<StaleAllocation> StaleAllocations;
+		};
+
+		[[nodiscard]] Pool& GetPool(ResourceHeapClass heapClass) noexcept { return m_pools[static_cast<size_t>(heapClass)]; }
+		[[nodiscard]] const Pool& GetPool(ResourceHeapClass heapClass) const noexcept { return m_pools[static_cast<size_t>(heapClass)]; }
+
+		[[nodiscard]] static D3D12_RESOURCE_ALLOCATION_INFO GetAllocationInfo(D3D12_RESOURCE_DESC& resourceDesc, ResourceHeapClass heapClass);
+		[[nodiscard]] static Heap CreateHeap(ResourceHeapClass heapClass);
+
+		std::array<Pool, static_cast<size_t>(ResourceHeapClass::Count)> m_pools;
+	};
+}
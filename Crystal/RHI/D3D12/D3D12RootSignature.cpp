@@ -2,6 +2,8 @@
 #include "D3D12Core.h"
 #include "Utils/D3D12Exception.h"
 
+#include <algorithm>
+
 using namespace Crystal;
 using namespace Microsoft::WRL;
 
@@ -33,6 +35,7 @@ void RootSignature::Destroy() {
 	m_rootSignatureDesc.NumStaticSamplers = 0;
 
 	m_descriptorTableBitMask = 0;
+	m_bindlessTableBitMask   = 0;
 	m_samplerBitMask         = 0;
 
 	ZeroMemory(m_numDescriptorsPerTable.data(), sizeof(m_numDescriptorsPerTable));
@@ -82,12 +85,23 @@ void RootSignature::SetRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC1& rootS
 			params[i].DescriptorTable.NumDescriptorRanges = numDescriptorRanges;
 			params[i].DescriptorTable.pDescriptorRanges   = descriptorRanges;
 
+			const bool isUnbounded = std::any_of(descriptorRanges, descriptorRanges + numDescriptorRanges,
+				[](const D3D12_DESCRIPTOR_RANGE1& range) {
+					return range.NumDescriptors == UINT_MAX;
+				}
+			);
+
 			if (numDescriptorRanges > 0) {
 				switch (descriptorRanges[0].RangeType) {
 				case D3D12_DESCRIPTOR_RANGE_TYPE_CBV:
 				case D3D12_DESCRIPTOR_RANGE_TYPE_SRV:
 				case D3D12_DESCRIPTOR_RANGE_TYPE_UAV:
-					m_descriptorTableBitMask |= (1 << i);
+					if (isUnbounded) {
+						m_bindlessTableBitMask |= (1 << i);
+					}
+					else {
+						m_descriptorTableBitMask |= (1 << i);
+					}
 					break;
 				case D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER:
 					m_samplerBitMask |= (1 << i);
@@ -95,7 +109,7 @@ void RootSignature::SetRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC1& rootS
 				}
 			}
 
-			for (uint32_t j = 0; j < numDescriptorRanges; j++) {
+			for (uint32_t j = 0; j < numDescriptorRanges && !isUnbounded; j++) {
 				m_numDescriptorsPerTable[i] += descriptorRanges[j].NumDescriptors;
 			}
 		}
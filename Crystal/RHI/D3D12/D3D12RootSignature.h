@@ -17,6 +17,9 @@ namespace Crystal {
 		[[nodiscard]] D3D12_ROOT_SIGNATURE_DESC1 GetRootSignatureDesc() const noexcept { return m_rootSignatureDesc; }
 		[[nodiscard]] uint32_t GetDescriptorTableBitMask(D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapType) const;
 		[[nodiscard]] uint32_t GetNumDescriptors(uint32_t rootIndex) const noexcept { return m_numDescriptorsPerTable.at(rootIndex); }
+
+		//Tables with an unbounded CBV/SRV/UAV range, they are bound to the bindless descriptor table instead of staged per draw
+		[[nodiscard]] uint32_t GetBindlessTableBitMask() const noexcept { return m_bindlessTableBitMask; }
 	private:
 		void SetRootSignatureDesc(const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc);
 
@@ -26,5 +29,6 @@ namespace Crystal {
 		std::array<uint32_t, 32> m_numDescriptorsPerTable{};
 		int32_t m_samplerBitMask{};
 		uint32_t m_descriptorTableBitMask{};
+		uint32_t m_bindlessTableBitMask{};
 	};
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "D3D12CommandContext.h"
 #include "D3D12RenderTarget.h"
 #include "D3D12Texture.h"
+#include "Managers/TextureManager.h"
 #include "Utils/D3D12Exception.h"
 #include "Utils/ResourceStateTracker.h"
 #include "Core/Math/Rectangle.h"
@@ -109,6 +110,8 @@ uint32_t SwapChain::Present(const Texture* const texture) {
 	m_currentBackbufferIndex = m_dxgiSwapChain->GetCurrentBackBufferIndex();
 
 	RHICore::release_stale_descriptors();
+	RHICore::release_stale_heap_allocations();
+	TextureManager::UpdateResidency();
 
 	return m_currentBackbufferIndex;
 }
@@ -1,6 +1,8 @@
 #include "Platform/Windows/CrystalWindow.h"
 #include "D3D12Texture.h"
+#include "D3D12BindlessTable.h"
 #include "D3D12Core.h"
+#include "Managers/TextureManager.h"
 
 #include "Utils/d3dx12.h"
 #include "Utils/D3D12Exception.h"
@@ -13,21 +15,11 @@ Texture::Texture(const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_CLEAR_VALU
 	:
 	m_resourceDesc(resourceDesc)
 {
-	auto& device = RHICore::get_device();
-
 	if (clearValue) {
 		m_clearValue = std::make_unique<D3D12_CLEAR_VALUE>(*clearValue);
 	}
 
-	const auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-
-	ThrowIfFailed(device.CreateCommittedResource(
-		&heapProperties,
-		D3D12_HEAP_FLAG_NONE,
-		&resourceDesc,
-		D3D12_RESOURCE_STATE_COMMON,
-		m_clearValue.get(),
-		IID_PPV_ARGS(&m_resource)));
+	CreateResource(resourceDesc);
 
 	//Todo: add resourcestate to our resourcestate tracker
 	SetTextureType();
@@ -49,6 +41,37 @@ Texture::Texture(Microsoft::WRL::ComPtr<ID3D12Resource> resource, const D3D12_CL
 	CreateViews();
 }
 
+Texture::~Texture() {
+	ReleaseResource();
+}
+
+void Texture::CreateResource(const D3D12_RESOURCE_DESC& resourceDesc) {
+	auto [resource, allocation] = RHICore::get_heap_allocator().CreateResource(resourceDesc, D3D12_RESOURCE_STATE_COMMON, m_clearValue.get());
+
+	m_resource   = std::move(resource);
+	m_allocation = allocation;
+
+	m_needsInitialization.store(allocation.NeedsInitialization, std::memory_order_relaxed);
+}
+
+//Textures wrapping a resource created elsewhere, e.g. the back buffers, have no allocation to give back
+void Texture::ReleaseResource() {
+	m_resource.Reset();
+
+	RHICore::get_bindless_table().Unregister(m_bindlessIndex);
+	m_bindlessIndex = {};
+
+	if (m_residencyHandle.IsValid()) {
+		TextureManager::ReleaseTexture(m_residencyHandle);
+		m_residencyHandle = {};
+	}
+
+	if (m_allocation.IsPlaced()) {
+		RHICore::get_heap_allocator().Free(m_allocation);
+		m_allocation = {};
+	}
+}
+
 void Texture::Resize(uint32_t width, uint32_t height, uint32_t depthOrArraySize) {
 	if (m_resource) {
 		CD3DX12_RESOURCE_DESC resourceDesc(m_resource->GetDesc());
@@ -58,16 +81,8 @@ void Texture::Resize(uint32_t width, uint32_t height, uint32_t depthOrArraySize)
 		resourceDesc.DepthOrArraySize = depthOrArraySize;
 		resourceDesc.MipLevels        = resourceDesc.SampleDesc.Count > 1 ? 1 : 0;
 
-		auto& device = RHICore::get_device();
-		const auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
-
-		ThrowIfFailed(device.CreateCommittedResource(
-			&heapProps,
-			D3D12_HEAP_FLAG_NONE,
-			&resourceDesc,
-			D3D12_RESOURCE_STATE_COMMON,
-			m_clearValue.get(),
-			IID_PPV_ARGS(&m_resource)));
+		ReleaseResource();
+		CreateResource(resourceDesc);
 
 		m_resource->SetName(m_textureName.c_str());
 
@@ -209,10 +224,15 @@ void Texture::CreateViews() noexcept {
 			device.CreateDepthStencilView(m_resource.Get(), nullptr, m_depthStencilView.GetDescriptorHandle());
 		}
 
-		//SRV
-		if ((resourceDesc.Flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE) != 0 && CheckSRVSupport()) {
+		//SRV, registered once in the bindless table, views created later with a custom description are not
+		if ((resourceDesc.Flags & D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE) == 0 && CheckSRVSupport()) {
 			m_shaderResourceView = RHICore::allocate_descriptors(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 			device.CreateShaderResourceView(m_resource.Get(), nullptr, m_shaderResourceView.GetDescriptorHandle());
+
+			auto& bindlessTable = RHICore::get_bindless_table();
+			bindlessTable.Unregister(m_bindlessIndex);
+
+			m_bindlessIndex = bindlessTable.Register(m_shaderResourceView.GetDescriptorHandle());
 		}
 
 		//Create an UAV for each mip (3D textures not supported)
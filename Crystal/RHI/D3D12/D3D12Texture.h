@@ -1,6 +1,9 @@
 #pragma once
 #include "D3D12DescriptorHeap.h"
+#include "D3D12HeapAllocator.h"
+#include "Core/Memory/GenerationalIndexAllocator.h"
 
+#include <atomic>
 #include <d3d12.h>
 #include <memory>
 #include <string>
@@ -17,6 +20,7 @@ namespace Crystal {
 	public:
 		Texture(const D3D12_RESOURCE_DESC& resourceDesc, const D3D12_CLEAR_VALUE* clearValue = nullptr);
 		Texture(Microsoft::WRL::ComPtr<ID3D12Resource> resource, const D3D12_CLEAR_VALUE* clearValue = nullptr);
+		~Texture();
 
 		void Resize(uint32_t width, uint32_t height, uint32_t depthOrArraySize = 1);
 		[[nodiscard]] uint32_t Width() const noexcept;
@@ -33,6 +37,17 @@ namespace Crystal {
 		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetShaderResourceView() const; 
 		[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE GetUnorderedAccessView(uint32_t mipLevel) const;
 
+		//Index of the default shader resource view in the bindless descriptor table, invalid without one.
+		//Shaders may only use it for work recorded after CommandContext::UseBindlessTexture was called for this texture.
+		[[nodiscard]] GenerationalIndex GetBindlessIndex() const noexcept { return m_bindlessIndex; }
+
+		//Set for textures shared through the texture manager, the reference is given back when the resource is released
+		[[nodiscard]] GenerationalIndex GetResidencyHandle() const noexcept { return m_residencyHandle; }
+		void SetResidencyHandle(GenerationalIndex residencyHandle) noexcept { m_residencyHandle = residencyHandle; }
+
+		//True once for a placed render target or depth stencil, the first command context using it initializes it
+		[[nodiscard]] bool ConsumeInitialization() const noexcept { return m_needsInitialization.exchange(false, std::memory_order_relaxed); }
+
 		void SetName(std::wstring_view name) noexcept;
 		[[nodiscard]] std::wstring GetName() const noexcept;
 
@@ -51,6 +66,8 @@ namespace Crystal {
 		[[nodiscard]] static constexpr DXGI_FORMAT GetSRGBFormat(DXGI_FORMAT format);
 	private:
 		void SetTextureType() noexcept;
+		void CreateResource(const D3D12_RESOURCE_DESC& resourceDesc);
+		void ReleaseResource();
 
 		void CreateViews() noexcept;
 		void CheckFeatureSupport();
@@ -61,6 +78,8 @@ namespace Crystal {
 			uint32_t planeSlice = 0);
 
 		Microsoft::WRL::ComPtr<ID3D12Resource> m_resource{ nullptr };
+		HeapAllocation m_allocation;
+		mutable std::atomic_bool m_needsInitialization{ false };
 		std::wstring m_textureName{};
 		std::unique_ptr<D3D12_CLEAR_VALUE> m_clearValue{ nullptr };
 		D3D12_FEATURE_DATA_FORMAT_SUPPORT m_formatSupport{};
@@ -69,6 +88,8 @@ namespace Crystal {
 		DescriptorAllocation m_depthStencilView;
 		DescriptorAllocation m_shaderResourceView;
 		DescriptorAllocation m_unorderedAccessView;
+		GenerationalIndex m_bindlessIndex;
+		GenerationalIndex m_residencyHandle;
 
 		D3D12_RESOURCE_DESC m_resourceDesc;
 		TextureType m_textureType;
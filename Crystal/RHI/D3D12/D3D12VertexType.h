@@ -1,41 +1,124 @@
 #pragma once
 #include <array>
-#include "../Core/Math/Vector3.h"
+#include <cstddef>
+#include <cstdint>
+#include "Graphics/VertexLayouts.h"
 #include <d3d12.h>
 
 namespace Crystal {
     struct VertexElement {
-		static constexpr auto Position  = "POSITION";
-		static constexpr auto Normal    = "NORMAL";
-		static constexpr auto Tangent   = "TANGENT";
-		static constexpr auto Bitangent = "BITANGENT";
-		static constexpr auto Texcoord  = "TEXCOORD";
+		static constexpr auto Position     = "POSITION";
+		static constexpr auto Normal       = "NORMAL";
+		static constexpr auto Tangent      = "TANGENT";
+		static constexpr auto Bitangent    = "BITANGENT";
+		static constexpr auto Texcoord     = "TEXCOORD";
+		static constexpr auto TangentFrame = "TANGENTFRAME";
     };
 
-	struct VertexAlignment {
-		static constexpr unsigned append = 0xffffffff;
+	struct VertexAttribute {
+		const char* SemanticName;
+		uint32_t SemanticIndex;
+		DXGI_FORMAT Format;
+		uint32_t Offset;
 	};
 
-	struct Vertex {
-		Math::Vector3 Position{};
-		Math::Vector3 Normal{};
-		Math::Vector3 Tangent{};
-		Math::Vector3 Bitangent{};
-		Math::Vector3 TexCoord{};
-
-		static constexpr D3D12_INPUT_LAYOUT_DESC InputLayout = 
-		{
-			std::array<D3D12_INPUT_ELEMENT_DESC, 5>
-			{
-				{
-					{ VertexElement::Position,  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexAlignment::append, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-					{ VertexElement::Normal,    0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexAlignment::append, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-					{ VertexElement::Tangent,   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexAlignment::append, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-					{ VertexElement::Bitangent, 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexAlignment::append, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-					{ VertexElement::Texcoord,  0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexAlignment::append, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-				}
-			}.data(),
-			5
+	//Attributes of every vertex type in the order they are laid out, the input layouts are generated from these
+	template <class T>
+	struct VertexFormat;
+
+	template <>
+	struct VertexFormat<Vertex> {
+		static constexpr std::array Attributes{
+			VertexAttribute{ VertexElement::Position,  0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, Position)  },
+			VertexAttribute{ VertexElement::Normal,    0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, Normal)    },
+			VertexAttribute{ VertexElement::Tangent,   0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, Tangent)   },
+			VertexAttribute{ VertexElement::Bitangent, 0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, Bitangent) },
+			VertexAttribute{ VertexElement::Texcoord,  0, DXGI_FORMAT_R32G32B32_FLOAT, offsetof(Vertex, TexCoord)  }
+		};
+	};
+
+	template <>
+	struct VertexFormat<CompactVertex> {
+		static constexpr std::array Attributes{
+			VertexAttribute{ VertexElement::Position,     0, DXGI_FORMAT_R32G32B32_FLOAT,    offsetof(CompactVertex, Position)     },
+			VertexAttribute{ VertexElement::TangentFrame, 0, DXGI_FORMAT_R16G16B16A16_SNORM, offsetof(CompactVertex, TangentFrame) },
+			VertexAttribute{ VertexElement::Texcoord,     0, DXGI_FORMAT_R16G16_FLOAT,       offsetof(CompactVertex, TexCoord)     }
 		};
 	};
-}
\ No newline at end of file
+
+	template <>
+	struct VertexFormat<QuantizedVertex> {
+		static constexpr std::array Attributes{
+			VertexAttribute{ VertexElement::Position, 0, DXGI_FORMAT_R16G16B16A16_UNORM, offsetof(QuantizedVertex, Position) },
+			VertexAttribute{ VertexElement::Normal,   0, DXGI_FORMAT_R16G16_SNORM,       offsetof(QuantizedVertex, Normal)   },
+			VertexAttribute{ VertexElement::Tangent,  0, DXGI_FORMAT_R16G16_SNORM,       offsetof(QuantizedVertex, Tangent)  },
+			VertexAttribute{ VertexElement::Texcoord, 0, DXGI_FORMAT_R16G16_FLOAT,       offsetof(QuantizedVertex, TexCoord) }
+		};
+	};
+
+	[[nodiscard]] consteval uint32_t GetVertexFormatSize(DXGI_FORMAT format) {
+		switch (format) {
+			case DXGI_FORMAT_R32G32B32A32_FLOAT: return 16;
+			case DXGI_FORMAT_R32G32B32_FLOAT:    return 12;
+			case DXGI_FORMAT_R16G16B16A16_FLOAT:
+			case DXGI_FORMAT_R16G16B16A16_UNORM:
+			case DXGI_FORMAT_R16G16B16A16_SNORM:
+			case DXGI_FORMAT_R32G32_FLOAT:       return 8;
+			case DXGI_FORMAT_R16G16_FLOAT:
+			case DXGI_FORMAT_R16G16_UNORM:
+			case DXGI_FORMAT_R16G16_SNORM:
+			case DXGI_FORMAT_R8G8B8A8_UNORM:
+			case DXGI_FORMAT_R8G8B8A8_SNORM:
+			case DXGI_FORMAT_R10G10B10A2_UNORM:
+			case DXGI_FORMAT_R32_FLOAT:          return 4;
+			default:                             return 0;
+		}
+	}
+
+	//Every attribute has to start where the previous one ends and the last one end at the stride, a format that does
+	//not match the member it reads fails to compile instead of shifting every following attribute
+	template <class T>
+	[[nodiscard]] consteval bool IsVertexFormatPacked() {
+		uint32_t offset = 0;
+
+		for (const auto& attribute : VertexFormat<T>::Attributes) {
+			if (attribute.Offset != offset || GetVertexFormatSize(attribute.Format) == 0) {
+				return false;
+			}
+			offset += GetVertexFormatSize(attribute.Format);
+		}
+		return offset == sizeof(T);
+	}
+
+	template <class T>
+	inline constexpr auto INPUT_ELEMENTS = [] {
+		static_assert(IsVertexFormatPacked<T>(), "Vertex attributes do not cover the vertex type");
+
+		constexpr auto& attributes = VertexFormat<T>::Attributes;
+		std::array<D3D12_INPUT_ELEMENT_DESC, attributes.size()> elements{};
+
+		for (size_t i = 0; i < attributes.size(); i++) {
+			elements[i] = {
+				attributes[i].SemanticName,
+				attributes[i].SemanticIndex,
+				attributes[i].Format,
+				0,
+				attributes[i].Offset,
+				D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
+				0
+			};
+		}
+		return elements;
+	}();
+
+	template <class T>
+	inline constexpr D3D12_INPUT_LAYOUT_DESC INPUT_LAYOUT{ INPUT_ELEMENTS<T>.data(), static_cast<UINT>(INPUT_ELEMENTS<T>.size()) };
+
+	[[nodiscard]] constexpr const D3D12_INPUT_LAYOUT_DESC& GetInputLayout(VertexLayout layout) noexcept {
+		switch (layout) {
+			case VertexLayout::Compact:   return INPUT_LAYOUT<CompactVertex>;
+			case VertexLayout::Quantized: return INPUT_LAYOUT<QuantizedVertex>;
+			default:                      return INPUT_LAYOUT<Vertex>;
+		}
+	}
+}
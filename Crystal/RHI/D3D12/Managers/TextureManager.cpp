@@ -1,13 +1,22 @@
 #include "TextureManager.h"
 #include "Core/FileSystem/FileSystem.h"
+#include "Core/FileSystem/ImportCache.h"
+#include "Core/Lib/ConcurrentCache.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Memory/MemoryTracker.h"
 #include "Core/Utils/StringUtils.h"
 #include "DirectXTex/DirectXTex.h"
+#include "Graphics/BlockCompression.h"
+#include "Graphics/MipGenerator.h"
 #include "RHI/RHICore.h"
 #include "RHI/D3D12/D3D12CommandContext.h"
 #include "RHI/D3D12/Utils/D3D12Exception.h"
 #include "../Utils/ResourceStateTracker.h"
 #include <Crystal/ComputeMipsPass.h>
 #include <range/v3/all.hpp>
+#include <atomic>
+#include <cstring>
 
 using namespace Crystal;
 using namespace DirectX;
@@ -60,8 +69,7 @@ namespace impl {
 	}
 
 	std::vector<D3D12_SUBRESOURCE_DATA> CreateSubResources(const ScratchImage& scratchImage) {
-		std::vector<D3D12_SUBRESOURCE_DATA> subResources;
-		subResources.reserve(scratchImage.GetImageCount());
+		std::vector<D3D12_SUBRESOURCE_DATA> subResources(scratchImage.GetImageCount());
 
 		std::span images{ scratchImage.GetImages(), scratchImage.GetImageCount() };
 
@@ -73,62 +81,451 @@ namespace impl {
 		return subResources;
 	}
 
-	std::unordered_map<std::wstring, ID3D12Resource*> textureCache;
-	std::mutex textureCacheMutex;
-}
+	//Rows are already stored at the pitch the copy expects, the upload reads them straight from the mapping
+	std::vector<D3D12_SUBRESOURCE_DATA> CreateSubResources(const CookedTexture& cookedTexture) {
+		const auto mips = cookedTexture.GetMips();
 
-std::unique_ptr<Texture> TextureManager::LoadTextureFromFile(CommandContext& ctx, std::string_view fileName, bool sRBG) {
-	if (!FileSystem::Exists(fileName)) [[likely]] {
-		throw std::exception("File not found");
+		std::vector<D3D12_SUBRESOURCE_DATA> subResources(mips.size());
+
+		for (uint32_t mip = 0; mip < mips.size(); mip++) {
+			subResources[mip].RowPitch   = mips[mip].RowPitch;
+			subResources[mip].SlicePitch = static_cast<LONG_PTR>(mips[mip].Size);
+			subResources[mip].pData      = cookedTexture.GetMipData(mip).data();
+		}
+		return subResources;
 	}
 
-	const auto wideFileName = StringConverter::To<std::wstring>(fileName);
+	[[nodiscard]] TexMetadata GetMetadata(const CookedTexture& cookedTexture) noexcept {
+		const auto& header = cookedTexture.GetHeader();
 
-	/*std::scoped_lock(impl::textureCacheMutex);*/
+		TexMetadata metadata{};
+		metadata.width     = header.Width;
+		metadata.height    = header.Height;
+		metadata.depth     = 1;
+		metadata.arraySize = 1;
+		metadata.mipLevels = header.NumMips;
+		metadata.format    = static_cast<DXGI_FORMAT>(header.Format);
+		metadata.dimension = TEX_DIMENSION_TEXTURE2D;
 
-	if(impl::textureCache.contains(wideFileName)) {
-		return std::make_unique<Texture>(impl::textureCache[wideFileName]);
+		return metadata;
 	}
 
-	TexMetadata metadata{};
-	ScratchImage scratchImage;
+	//Size of every mip summed over the array slices, mips past MAX_MIPS are folded into the last one
+	std::vector<uint64_t> GetMipSizes(const D3D12_RESOURCE_DESC& resourceDesc) {
+		auto& d3d12Device = RHICore::get_device();
 
-	const auto fileExtensions = FileSystem::GetExtensionFromFilePath(fileName);
+		const auto numMips   = static_cast<uint32_t>(resourceDesc.MipLevels);
+		const auto numSlices = resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1u : resourceDesc.DepthOrArraySize;
+
+		std::vector<uint64_t> mipSizes(std::min(numMips, ResidencyManager::MAX_MIPS), 0);
+
+		for (uint32_t mip = 0; mip < numMips; mip++) {
+			for (uint32_t slice = 0; slice < numSlices; slice++) {
+				uint64_t sizeInBytes = 0;
+				d3d12Device.GetCopyableFootprints(&resourceDesc, mip + slice * numMips, 1, 0, nullptr, nullptr, nullptr, &sizeInBytes);
+
+				mipSizes[std::min(mip, ResidencyManager::MAX_MIPS - 1)] += sizeInBytes;
+			}
+		}
+		return mipSizes;
+	}
+
+	uint64_t GetDefaultTextureBudget() {
+		DXGI_QUERY_VIDEO_MEMORY_INFO memoryInfo{};
+		ThrowIfFailed(RHICore::get_physical_device().QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &memoryInfo));
+
+		return memoryInfo.Budget / 2;
+	}
+
+	struct CachedTexture {
+		ComPtr<ID3D12Resource> Resource;
+		GenerationalIndex ResidencyHandle;
+	};
+
+	//Loads of the same file are deduplicated by the cache, a second request waits for the first upload
+	ConcurrentCache<StringId, CachedTexture> textureCache;
+
+	//Guards the residency manager, residencyKeys and residencyHandles. Taken before a cache shard when both are needed,
+	//never while holding one, the cache only locks its shards around lookups and never around a load.
+	std::vector<StringId> residencyKeys;
+	std::vector<GenerationalIndex> residencyHandles;
+	std::mutex residencyMutex;
+
+	//Frame + 1 a texture was last bound in, 0 if it was not bound since the last update. Binding happens on every
+	//recording thread, so it only stores here and UpdateResidency hands the frames to the residency manager.
+	//A texture that is bound holds a reference, its handle can not be evicted and reused in the meantime.
+	const auto lastUsedFrames = std::make_unique<std::atomic<uint64_t>[]>(ResidencyManager::DEFAULT_CAPACITY);
+
+	ResidencyManager& GetResidencyManager() {
+		static ResidencyManager residencyManager(GetDefaultTextureBudget());
+		return residencyManager;
+	}
+
+	//WIC needs COM on every thread that decodes, import workers never initialize it themselves.
+	//Threads that already joined an apartment keep it, the call then fails harmlessly.
+	void InitializeComForCurrentThread() noexcept {
+		static thread_local const HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+		(void)result;
+	}
+
+	ImportCache& GetCookedTextureCache() {
+		static ImportCache cookedTextureCache(FileSystem::Append(FileSystem::GetWorkingDirectory(), "Cache/Textures"));
+		return cookedTextureCache;
+	}
+
+	//Images whose size is a multiple of the block size are cooked to BC7, D3D12 rejects block compressed textures otherwise
+	constexpr BCEncoderSettings COOKED_TEXTURE_ENCODER{ .Format = BCFormat::BC7, .Quality = BCQuality::Normal };
+
+	//sRGB images are filtered in linear space, so the same file cooks differently depending on how it is sampled
+	[[nodiscard]] constexpr uint64_t GetCookSettingsHash(bool sRGB) noexcept {
+		auto hash = HashCombine(0, CookedTextureFormat::VERSION);
+		hash      = HashCombine(hash, static_cast<uint64_t>(COOKED_TEXTURE_ENCODER.Format));
+		hash      = HashCombine(hash, static_cast<uint64_t>(COOKED_TEXTURE_ENCODER.Quality));
+		return HashCombine(hash, sRGB ? 1 : 0);
+	}
+
+	//Files that are not prepared offline already, DDS and HDR images keep their own formats and mips
+	[[nodiscard]] bool IsCookable(std::string_view fileExtension) noexcept {
+		return fileExtension != ".dds" && fileExtension != ".hdr" && fileExtension != ".ctex";
+	}
+
+	//Images whose mip chain is built on the CPU. This covers sRGB formats as well, which cannot be written
+	//through a UAV and thus never get their mips from the compute pass.
+	[[nodiscard]] bool IsSingleRGBA8Image(const TexMetadata& metadata) noexcept {
+		return metadata.dimension == TEX_DIMENSION_TEXTURE2D
+			&& metadata.mipLevels == 1
+			&& metadata.arraySize == 1
+			&& (metadata.format == DXGI_FORMAT_R8G8B8A8_UNORM || metadata.format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+	}
+
+	void LoadImageFromFile(std::string_view fileName, ScratchImage& scratchImage) {
+		if (!FileSystem::Exists(fileName)) [[unlikely]] {
+			throw std::exception("File not found");
+		}
+
+		const auto wideFileName   = StringConverter::To<std::wstring>(fileName);
+		const auto fileExtensions = FileSystem::GetExtensionFromFilePath(fileName);
+
+		InitializeComForCurrentThread();
+
+		if (fileExtensions == ".dds") {
+			ThrowIfFailed(LoadFromDDSFile(wideFileName.c_str(), DDS_FLAGS_FORCE_RGB, nullptr, scratchImage));
+		}
+		else if (fileExtensions == ".hdr") {
+			ThrowIfFailed(LoadFromHDRFile(wideFileName.c_str(), nullptr, scratchImage));
+		}
+		else if (fileExtensions == ".tga") {
+			ThrowIfFailed(LoadFromTGAFile(wideFileName.c_str(), nullptr, scratchImage));
+		}
+		else {
+			ThrowIfFailed(LoadFromWICFile(wideFileName.c_str(), WIC_FLAGS_FORCE_RGB, nullptr, scratchImage));
+		}
+	}
+
+	[[nodiscard]] MipChain GenerateMipChain(const ScratchImage& scratchImage, bool sRGB) {
+		const auto& metadata = scratchImage.GetMetadata();
+		const auto& image    = *scratchImage.GetImage(0, 0, 0);
+
+		const auto width   = static_cast<uint32_t>(metadata.width);
+		const auto height  = static_cast<uint32_t>(metadata.height);
+		const auto rowSize = size_t{ width } * 4;
+
+		std::vector<uint8_t> texels(rowSize * height);
+
+		for (uint32_t y = 0; y < height; y++) {
+			std::memcpy(texels.data() + y * rowSize, image.pixels + y * image.rowPitch, rowSize);
+		}
+		return GenerateMips(texels, width, height, { .IsSRGB = sRGB });
+	}
+
+	//Uploads the chain from memory when it could not be cooked, the compute pass is skipped then as well
+	void ReplaceWithMipChain(ScratchImage& scratchImage, const MipChain& mipChain) {
+		const auto& metadata = scratchImage.GetMetadata();
+
+		ScratchImage withMips;
+		ThrowIfFailed(withMips.Initialize2D(metadata.format, metadata.width, metadata.height, 1, mipChain.Levels.size()));
+
+		for (uint32_t mip = 0; mip < mipChain.Levels.size(); mip++) {
+			const auto& level     = mipChain.Levels[mip];
+			const auto& mipImage  = *withMips.GetImage(mip, 0, 0);
+			const auto mipTexels  = mipChain.GetTexels(mip);
+			const auto mipRowSize = size_t{ level.Width } * 4;
+
+			for (uint32_t y = 0; y < level.Height; y++) {
+				std::memcpy(mipImage.pixels + y * mipImage.rowPitch, mipTexels.data() + y * mipRowSize, mipRowSize);
+			}
+		}
+
+		scratchImage = std::move(withMips);
+	}
+
+	[[nodiscard]] bool IsBlockCompressible(const MipChain& mipChain) noexcept {
+		const auto& level = mipChain.Levels.front();
+		return level.Width % 4 == 0 && level.Height % 4 == 0;
+	}
+
+	//Textures are decoded on the import threads already, so each one is encoded on the thread that cooks it
+	[[nodiscard]] bool WriteCookedTexture(const MipChain& mipChain, std::string_view cookedPath, bool sRGB) {
+		if (!IsBlockCompressible(mipChain)) {
+			CookedTextureWriter writer(CookedTextureFormat::FORMAT_R8G8B8A8_UNORM, 1, 4, sRGB);
+			writer.AddMips(mipChain);
+			return writer.Write(cookedPath);
+		}
+
+		const auto format = COOKED_TEXTURE_ENCODER.Format;
+		CookedTextureWriter writer(GetDxgiFormat(format), 4, GetBytesPerBlock(format), sRGB);
+
+		for (uint32_t mip = 0; mip < mipChain.Levels.size(); mip++) {
+			const auto& level = mipChain.Levels[mip];
+			writer.AddMip(level.Width, level.Height, EncodeBlocks(mipChain.GetTexels(mip), level.Width, level.Height, COOKED_TEXTURE_ENCODER));
+		}
+		return writer.Write(cookedPath);
+	}
+
+	//Takes another reference on a cached texture, fails if it was evicted after it was looked up.
+	//Textures the residency manager had no room for are shared without being tracked.
+	bool AddReference(const CachedTexture& cachedTexture) {
+		std::scoped_lock lock(residencyMutex);
+
+		auto& residencyManager = GetResidencyManager();
+		const auto handle      = cachedTexture.ResidencyHandle;
+
+		if (!handle.IsValid()) [[unlikely]] {
+			return true;
+		}
+
+		if (!residencyManager.IsRegistered(handle)) [[unlikely]] {
+			return false;
+		}
+
+		residencyManager.AddRef(handle);
+		residencyManager.Touch(handle, FrameArena::GetFrameIndex());
+		return true;
+	}
 
-	if (fileExtensions == ".dds") {
-		ThrowIfFailed(LoadFromDDSFile(wideFileName.c_str(), DDS_FLAGS_FORCE_RGB, &metadata, scratchImage));
+	//Creates the resource and records the upload, the texture holds the reference the residency manager starts with
+	std::unique_ptr<Texture> CreateTexture(CommandContext& ctx, DecodedTexture&& decodedTexture) {
+		const auto filePath = decodedTexture.FilePath;
+		const auto& cooked  = decodedTexture.Cooked;
+
+		auto metadata = cooked ? GetMetadata(*cooked) : decodedTexture.Image->GetMetadata();
+
+		if (decodedTexture.sRGB) {
+			metadata.format = MakeSRGB(metadata.format);
+		}
+
+		const auto d3d12Resource = CreateD3D12Texture(metadata);
+
+		auto texture = std::make_unique<Texture>(d3d12Resource);
+		texture->SetName(StringConverter::To<std::wstring>(filePath.GetString()));
+
+		//Update the global state tracker
+		ResourceStateTracker::AddGlobalResourceState(d3d12Resource.Get(), D3D12_RESOURCE_STATE_COMMON);
+
+		const auto subResources = cooked ? CreateSubResources(*cooked) : CreateSubResources(*decodedTexture.Image);
+		ctx.CopyTextureSubresource(*texture, 0, subResources);
+
+		if (subResources.size() < d3d12Resource->GetDesc().MipLevels) {
+			ComputeMipsPass computeMipsPass(ctx);
+			computeMipsPass.Execute();
+		}
+
+		std::scoped_lock lock(residencyMutex);
+
+		//Committed textures can only be released as a whole, so none of their mips are ever dropped
+		const auto mipSizes        = GetMipSizes(d3d12Resource->GetDesc());
+		const auto residencyHandle = GetResidencyManager().Register(mipSizes, static_cast<uint32_t>(mipSizes.size()), FrameArena::GetFrameIndex());
+
+		if (residencyHandle.IsValid()) [[likely]] {
+			if (residencyKeys.size() <= residencyHandle.Index) {
+				residencyKeys.resize(residencyHandle.Index + 1);
+			}
+
+			if (residencyHandles.size() <= residencyHandle.Index) {
+				residencyHandles.resize(residencyHandle.Index + 1);
+			}
+
+			residencyKeys[residencyHandle.Index]    = filePath;
+			residencyHandles[residencyHandle.Index] = residencyHandle;
+			texture->SetResidencyHandle(residencyHandle);
+		}
+		return texture;
+	}
+
+	//Hands out the cached texture or runs createTexture once, no matter how many threads ask for the file at the same time
+	template<class CreateFunction>
+	std::unique_ptr<Texture> AcquireTexture(StringId filePath, CreateFunction&& createTexture) {
+		while (true) {
+			std::unique_ptr<Texture> createdTexture;
+
+			const auto cachedTexture = textureCache.GetOrLoad(filePath, [&] {
+				createdTexture = createTexture();
+				return CachedTexture{ createdTexture->GetUnderlyingResource(), createdTexture->GetResidencyHandle() };
+			});
+
+			if (createdTexture) {
+				return createdTexture;
+			}
+
+			if (AddReference(cachedTexture)) [[likely]] {
+				auto texture = std::make_unique<Texture>(cachedTexture.Resource);
+				texture->SetResidencyHandle(cachedTexture.ResidencyHandle);
+				return texture;
+			}
+
+			//Evicted in between, UpdateResidency removed it from the cache before the reference could be taken
+		}
 	}
-	else if (fileExtensions == ".hdr") {
-		ThrowIfFailed(LoadFromHDRFile(wideFileName.c_str(), &metadata, scratchImage));
+}
+
+DecodedTexture::DecodedTexture()                                     = default;
+DecodedTexture::DecodedTexture(DecodedTexture&&) noexcept            = default;
+DecodedTexture& DecodedTexture::operator=(DecodedTexture&&) noexcept = default;
+DecodedTexture::~DecodedTexture()                                    = default;
+
+std::unique_ptr<Texture> TextureManager::LoadTextureFromFile(CommandContext& ctx, std::string_view fileName, bool sRBG) {
+	return LoadTextureFromFile(ctx, StringId::Intern(fileName), sRBG);
+}
+
+std::unique_ptr<Texture> TextureManager::LoadTextureFromFile(CommandContext& ctx, StringId filePath, bool sRBG) {
+	ScopedMemoryTag memoryTag(MemoryTag::Textures);
+
+	return impl::AcquireTexture(filePath, [&] {
+		return impl::CreateTexture(ctx, DecodeTextureFromFile(filePath, sRBG));
+	});
+}
+
+bool TextureManager::IsCached(StringId filePath) {
+	return impl::textureCache.Contains(filePath);
+}
+
+DecodedTexture TextureManager::DecodeTextureFromFile(StringId filePath, bool sRBG) {
+	ScopedMemoryTag memoryTag(MemoryTag::Textures);
+
+	const auto fileName       = filePath.GetString();
+	const auto fileExtensions = FileSystem::GetExtensionFromFilePath(fileName);
+
+	DecodedTexture decodedTexture;
+	decodedTexture.FilePath = filePath;
+	decodedTexture.sRGB     = sRBG;
+
+	if (fileExtensions == ".ctex") {
+		decodedTexture.Cooked = CookedTexture::Open(fileName);
+
+		if (!decodedTexture.Cooked) [[unlikely]] {
+			throw std::exception("Invalid cooked texture");
+		}
+		return decodedTexture;
 	}
-	else if (fileExtensions == ".tga") {
-		ThrowIfFailed(LoadFromTGAFile(wideFileName.c_str(), &metadata, scratchImage));
+
+	//A cooked texture is found by the content of its source, a hit skips decoding and mip generation entirely
+	auto& cookedTextureCache = impl::GetCookedTextureCache();
+
+	const auto key = impl::IsCookable(fileExtensions)
+		? cookedTextureCache.ComputeKey(fileName, impl::GetCookSettingsHash(sRBG))
+		: std::nullopt;
+
+	if (key) {
+		if (const auto cookedPath = cookedTextureCache.Find(*key)) {
+			decodedTexture.Cooked = CookedTexture::Open(*cookedPath);
+
+			if (decodedTexture.Cooked) [[likely]] {
+				return decodedTexture;
+			}
+		}
 	}
-	else {
-		ThrowIfFailed(LoadFromWICFile(wideFileName.c_str(), WIC_FLAGS_FORCE_RGB, &metadata, scratchImage));
+
+	decodedTexture.Image = std::make_unique<ScratchImage>();
+
+	auto& scratchImage = *decodedTexture.Image;
+	impl::LoadImageFromFile(fileName, scratchImage);
+
+	if (impl::IsSingleRGBA8Image(scratchImage.GetMetadata())) {
+		const auto mipChain = impl::GenerateMipChain(scratchImage, sRBG);
+
+		if (key) {
+			const auto stagingPath = cookedTextureCache.GetStagingPath(*key);
+
+			if (impl::WriteCookedTexture(mipChain, stagingPath, sRBG)) {
+				if (const auto cookedPath = cookedTextureCache.Commit(*key, stagingPath, {})) {
+					decodedTexture.Cooked = CookedTexture::Open(*cookedPath);
+				}
+			}
+		}
+
+		if (decodedTexture.Cooked) [[likely]] {
+			decodedTexture.Image.reset();
+		}
+		else {
+			impl::ReplaceWithMipChain(scratchImage, mipChain);
+		}
 	}
+	return decodedTexture;
+}
 
-	if (sRBG) {
-		metadata.format = MakeSRGB(metadata.format);
+std::unique_ptr<Texture> TextureManager::UploadTexture(CommandContext& ctx, DecodedTexture&& decodedTexture) {
+	ScopedMemoryTag memoryTag(MemoryTag::Textures);
+
+	//Another load may have uploaded the same file since it was decoded, the decoded image is dropped then
+	const auto filePath = decodedTexture.FilePath;
+
+	return impl::AcquireTexture(filePath, [&] {
+		return impl::CreateTexture(ctx, std::move(decodedTexture));
+	});
+}
+
+bool TextureManager::CookTexture(StringId filePath, std::string_view cookedPath, bool sRBG) {
+	ScopedMemoryTag memoryTag(MemoryTag::Textures);
+
+	ScratchImage scratchImage;
+	impl::LoadImageFromFile(filePath.GetString(), scratchImage);
+
+	if (!impl::IsSingleRGBA8Image(scratchImage.GetMetadata())) [[unlikely]] {
+		return false;
 	}
+	return impl::WriteCookedTexture(impl::GenerateMipChain(scratchImage, sRBG), cookedPath, sRBG);
+}
+
+void TextureManager::ReleaseTexture(GenerationalIndex residencyHandle) noexcept {
+	std::scoped_lock lock(impl::residencyMutex);
+	impl::GetResidencyManager().Release(residencyHandle);
+}
 
-	const auto d3d12Resource = impl::CreateD3D12Texture(metadata);
+void TextureManager::MarkUsed(GenerationalIndex residencyHandle) noexcept {
+	auto& lastUsedFrame = impl::lastUsedFrames[residencyHandle.Index];
+	const auto frame    = FrameArena::GetFrameIndex() + 1;
 
-	auto texture = std::make_unique<Texture>(d3d12Resource);
-	texture->SetName(wideFileName);
+	//Most binds are of textures already bound this frame, skipping the store keeps the cache line shared
+	if (lastUsedFrame.load(std::memory_order_relaxed) != frame) {
+		lastUsedFrame.store(frame, std::memory_order_relaxed);
+	}
+}
 
-	//Update the global state tracker
-	ResourceStateTracker::AddGlobalResourceState(d3d12Resource.Get(), D3D12_RESOURCE_STATE_COMMON);
+void TextureManager::UpdateResidency() {
+	std::scoped_lock lock(impl::residencyMutex);
 
-	const auto subResources = impl::CreateSubResources(scratchImage);
-	ctx.CopyTextureSubresource(*texture, 0, subResources);
+	auto& residencyManager = impl::GetResidencyManager();
 
-	if (subResources.size() < d3d12Resource->GetDesc().MipLevels) {
-		ComputeMipsPass computeMipsPass(ctx);
-		computeMipsPass.Execute();
+	for (uint32_t i = 0; i < impl::residencyHandles.size(); i++) {
+		if (const auto frame = impl::lastUsedFrames[i].exchange(0, std::memory_order_relaxed)) {
+			residencyManager.Touch(impl::residencyHandles[i], frame - 1);
+		}
 	}
 
-	impl::textureCache[wideFileName] = d3d12Resource.Get();
+	for (const auto& action : residencyManager.Update(FrameArena::GetFrameIndex())) {
+		//Only whole textures are tracked, protected frames keep them alive while the GPU may still read them
+		if (action.Type == ResidencyActionType::Evict) {
+			impl::textureCache.Erase(impl::residencyKeys[action.Handle.Index]);
+		}
+	}
+}
+
+void TextureManager::SetBudget(uint64_t budgetInBytes) {
+	std::scoped_lock lock(impl::residencyMutex);
+	impl::GetResidencyManager().SetBudget(budgetInBytes);
+}
 
-	return std::move(texture);
+ResidencyStatistics TextureManager::GetResidencyStatistics() {
+	std::scoped_lock lock(impl::residencyMutex);
+	return impl::GetResidencyManager().GetStatistics();
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "RHI/D3D12/D3D12Texture.h"
+#include "Core/Lib/StringId.h"
+#include "Core/Memory/ResidencyManager.h"
+#include "Graphics/CookedTexture.h"
 
 namespace DirectX {
 	class TexMetadata;
@@ -8,7 +11,50 @@ namespace DirectX {
 }
 namespace  Crystal {
 	class CommandContext;
+
+	//CPU side of a texture load, only needed until it has been uploaded. Holds either a decoded image
+	//or a mapped cooked texture whose mips are uploaded straight from the file.
+	struct DecodedTexture {
+		DecodedTexture();
+		DecodedTexture(DecodedTexture&&) noexcept;
+		DecodedTexture& operator=(DecodedTexture&&) noexcept;
+		~DecodedTexture();
+
+		StringId FilePath;
+		bool sRGB{ false };
+		std::unique_ptr<DirectX::ScratchImage> Image;
+		std::optional<CookedTexture> Cooked;
+	};
+
 	namespace TextureManager {
 		std::unique_ptr<Texture> LoadTextureFromFile(CommandContext& ctx, std::string_view fileName, bool sRBG);
+
+		//The path has to be interned, the cache is keyed on its id
+		std::unique_ptr<Texture> LoadTextureFromFile(CommandContext& ctx, StringId filePath, bool sRBG);
+
+		//Loading split in two for importers that decode on worker threads and upload on the recording thread.
+		//Decoding touches neither the GPU nor the texture cache, a texture that is cached by the time it is uploaded is shared.
+		//Concurrent loads of one file create it once, the other callers wait for it and share the result.
+		//IsCached is also true while another thread is loading the file.
+		[[nodiscard]] bool IsCached(StringId filePath);
+		[[nodiscard]] DecodedTexture DecodeTextureFromFile(StringId filePath, bool sRBG);
+		std::unique_ptr<Texture> UploadTexture(CommandContext& ctx, DecodedTexture&& decodedTexture);
+
+		//RGBA8 images are cooked with their full mip chain the first time they are decoded and mapped from the
+		//texture cache in the working directory afterwards. Images whose size is a multiple of 4 are stored as BC7. This writes the same file to cookedPath for offline
+		//tools, .ctex files load like any other texture. Fails for images that are not a single 2D RGBA8 image.
+		bool CookTexture(StringId filePath, std::string_view cookedPath, bool sRBG);
+
+		//Called by textures handed out by the loader, the cache keeps them alive until the budget runs out
+		void ReleaseTexture(GenerationalIndex residencyHandle) noexcept;
+		//Lock-free, safe to call from every recording thread. The use is reported at the next UpdateResidency.
+		void MarkUsed(GenerationalIndex residencyHandle) noexcept;
+
+		//Evicts unreferenced textures that were not used for a few frames while over budget, called once per frame
+		void UpdateResidency();
+
+		//Defaults to half of the local video memory budget reported by the adapter
+		void SetBudget(uint64_t budgetInBytes);
+		[[nodiscard]] ResidencyStatistics GetResidencyStatistics();
 	};
 }
@@ -0,0 +1,105 @@
+#include "UploadAllocator.h"
+#include "D3D12Core.h"
+
+#include "Utils/d3dx12.h"
+#include "Utils/D3D12Exception.h"
+
+using namespace Crystal;
+using namespace Microsoft::WRL;
+
+namespace impl {
+	ComPtr<ID3D12Resource> CreateUploadBuffer(size_t sizeInBytes, const wchar_t* name) {
+		auto& device = RHICore::get_device();
+
+		const auto heapProps = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+		const auto buffer    = CD3DX12_RESOURCE_DESC::Buffer(sizeInBytes);
+
+		ComPtr<ID3D12Resource> resource;
+
+		ThrowIfFailed(device.CreateCommittedResource(
+			&heapProps,
+			D3D12_HEAP_FLAG_NONE,
+			&buffer,
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(&resource)));
+
+		resource->SetName(name);
+		return resource;
+	}
+}
+
+UploadAllocator::UploadAllocator(size_t capacity)
+	:
+	m_ring(capacity)
+{
+	m_resource = impl::CreateUploadBuffer(capacity, L"Upload Buffer (Ring)");
+	m_gpuPtr   = m_resource->GetGPUVirtualAddress();
+
+	//Upload heaps can stay mapped for their whole lifetime
+	void* cpuPtr = nullptr;
+	ThrowIfFailed(m_resource->Map(0, nullptr, &cpuPtr));
+
+	m_cpuPtr = static_cast<std::byte*>(cpuPtr);
+}
+
+UploadAllocator::~UploadAllocator() {
+	m_resource->Unmap(0, nullptr);
+	m_cpuPtr = nullptr;
+	m_gpuPtr = D3D12_GPU_VIRTUAL_ADDRESS(0);
+}
+
+UploadAllocation UploadAllocator::Allocate(size_t sizeInBytes, size_t alignment) {
+	//Large uploads such as textures would push everything else out of the ring
+	if (sizeInBytes > m_ring.GetCapacity() / 4) {
+		return AllocateDedicated(sizeInBytes);
+	}
+
+	const auto offset = m_ring.Allocate(sizeInBytes, alignment);
+
+	//The ring only fills up within a single recording, nothing would be retired by waiting for the GPU
+	if (!offset) [[unlikely]] {
+		return AllocateDedicated(sizeInBytes);
+	}
+
+	return {
+		.CPU      = m_cpuPtr + *offset,
+		.GPU      = m_gpuPtr + *offset,
+		.Resource = m_resource.Get(),
+		.Offset   = *offset
+	};
+}
+
+UploadAllocation UploadAllocator::AllocateDedicated(size_t sizeInBytes) {
+	auto resource = impl::CreateUploadBuffer(sizeInBytes, L"Upload Buffer (Dedicated)");
+
+	void* cpuPtr = nullptr;
+	ThrowIfFailed(resource->Map(0, nullptr, &cpuPtr));
+
+	const UploadAllocation allocation{
+		.CPU      = cpuPtr,
+		.GPU      = resource->GetGPUVirtualAddress(),
+		.Resource = resource.Get(),
+		.Offset   = 0
+	};
+
+	m_pendingDedicatedBuffers.emplace_back(std::move(resource));
+	return allocation;
+}
+
+void UploadAllocator::Submit(uint64_t fenceValue) {
+	m_ring.Submit(fenceValue);
+
+	for (auto& resource : m_pendingDedicatedBuffers) {
+		m_submittedDedicatedBuffers.push_back({ std::move(resource), fenceValue });
+	}
+	m_pendingDedicatedBuffers.clear();
+}
+
+void UploadAllocator::Retire(uint64_t completedFenceValue) noexcept {
+	m_ring.Retire(completedFenceValue);
+
+	while (!m_submittedDedicatedBuffers.empty() && m_submittedDedicatedBuffers.front().FenceValue <= completedFenceValue) {
+		m_submittedDedicatedBuffers.pop_front();
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "Core/Memory/MemoryConstants.h"
+#include "Core/Memory/RingAllocator.h"
+#include <d3d12.h>
+#include <wrl.h>
+#include <deque>
+#include <vector>
+
+namespace Crystal {
+	struct UploadAllocation {
+		void* CPU;
+		D3D12_GPU_VIRTUAL_ADDRESS GPU;
+
+		//Buffer and offset the range lives in, for copies that take a resource instead of an address
+		ID3D12Resource* Resource;
+		uint64_t Offset;
+	};
+
+	//Upload memory for a command context. Small allocations come from one persistently mapped ring buffer,
+	//ranges are reused once the fence of the submission that used them has completed.
+	//Requests too large for the ring get a dedicated upload buffer, released the same way.
+	class UploadAllocator {
+	public:
+		static constexpr size_t DEFAULT_CAPACITY = Crystal::_8MB;
+
+		explicit UploadAllocator(size_t capacity = DEFAULT_CAPACITY);
+		UploadAllocator(const UploadAllocator& rhs)            = delete;
+		UploadAllocator& operator=(const UploadAllocator& rhs) = delete;
+		~UploadAllocator();
+
+		[[nodiscard]] UploadAllocation Allocate(size_t sizeInBytes, size_t alignment);
+
+		//Everything allocated since the last submission stays alive until the fence value has been reached
+		void Submit(uint64_t fenceValue);
+		void Retire(uint64_t completedFenceValue) noexcept;
+
+		[[nodiscard]] size_t GetCapacity() const noexcept { return m_ring.GetCapacity(); }
+		[[nodiscard]] size_t GetUsedBytes() const noexcept { return m_ring.GetUsedBytes(); }
+	private:
+		[[nodiscard]] UploadAllocation AllocateDedicated(size_t sizeInBytes);
+
+		struct DedicatedBuffer {
+			Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+			uint64_t FenceValue;
+		};
+
+		Microsoft::WRL::ComPtr<ID3D12Resource> m_resource;
+		std::byte* m_cpuPtr{ nullptr };
+		D3D12_GPU_VIRTUAL_ADDRESS m_gpuPtr{ D3D12_GPU_VIRTUAL_ADDRESS(0) };
+
+		RingAllocator m_ring;
+
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> m_pendingDedicatedBuffers;
+		std::deque<DedicatedBuffer> m_submittedDedicatedBuffers;
+	};
+}
@@ -3,6 +3,7 @@
 #include "../D3D12Texture.h"
 
 #include "Core/Logging/Logger.h"
+#include "Core/Memory/FrameArena.h"
 
 using namespace Crystal;
 
@@ -93,7 +94,9 @@ uint32_t ResourceStateTracker::FlushPendingResourceBarriers(const CommandContext
 	// Resolve the pending resource barriers by checking the global state of the 
     // (sub)resources. Add barriers if the pending state and the global state do
     //  not match.
-	std::vector<D3D12_RESOURCE_BARRIER> resourceBarriers;
+	ScopedArenaMarker scratch;
+
+	FrameVector<D3D12_RESOURCE_BARRIER> resourceBarriers(scratch.GetResource());
 	// Reserve enough space (worst-case, all pending barriers).
 	resourceBarriers.reserve(m_pendingResourceBarriers.size());
 
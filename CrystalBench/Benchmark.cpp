@@ -0,0 +1,239 @@
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    std::vector<Benchmark>& GetRegistry() noexcept {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    //Upper bound for the calibration, keeps broken cases from running forever
+    constexpr uint64_t MAX_ITERATIONS = 1'000'000'000;
+
+    State RunOnce(const Benchmark& benchmark, uint64_t iterations, bool readCounters) {
+        State state(iterations, benchmark.Argument, readCounters);
+        benchmark.Function(state);
+
+        return state;
+    }
+
+    //Finds an iteration count for which one repetition takes at least the minimum repetition time
+    std::optional<uint64_t> Calibrate(const Benchmark& benchmark, const Options& options, std::string& error) {
+        uint64_t iterations = 1;
+        const auto minTime  = std::chrono::duration<double, std::nano>(options.MinRepetitionTime).count();
+
+        while (true) {
+            const auto state = RunOnce(benchmark, iterations, false);
+
+            if (state.Failed()) {
+                error = state.GetError();
+                return {};
+            }
+
+            const auto elapsed = static_cast<double>(state.GetElapsed().count());
+
+            if (elapsed >= minTime || iterations >= MAX_ITERATIONS) {
+                return iterations;
+            }
+
+            //Aim a bit past the target, but never grow by more than 10x per step since timings of tiny runs are noisy
+            const auto estimate = elapsed > 0.0 ? static_cast<double>(iterations) * minTime * 1.4 / elapsed : static_cast<double>(iterations) * 10.0;
+            iterations          = std::clamp<uint64_t>(static_cast<uint64_t>(estimate), iterations + 1, std::min(iterations * 10, MAX_ITERATIONS));
+        }
+    }
+}
+
+State::State(uint64_t iterations, std::optional<int64_t> argument, bool readCounters) noexcept
+    :
+    m_iterations(iterations),
+    m_argument(argument),
+    m_readCounters(readCounters)
+{}
+
+State::Iterator State::begin() noexcept {
+    StartTimer();
+    return Iterator(this, m_iterations);
+}
+
+void State::StartTimer() noexcept {
+    m_running = true;
+
+    if (m_readCounters) {
+        m_countersBegin = PerfCounters::ForCurrentThread().Read();
+    }
+
+    //Read the clock last so the counter read is not part of the measurement
+    m_begin = std::chrono::steady_clock::now();
+}
+
+void State::StopTimer() noexcept {
+    if (!m_running) {
+        return;
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    m_elapsed += end - m_begin;
+    m_running  = false;
+
+    if (m_countersBegin) {
+        if (const auto countersEnd = PerfCounters::ForCurrentThread().Read()) {
+            auto delta = *countersEnd - *m_countersBegin;
+
+            if (m_counters) {
+                *m_counters += delta;
+            }
+            else {
+                m_counters = delta;
+            }
+        }
+        m_countersBegin.reset();
+    }
+}
+
+void State::PauseTiming() noexcept {
+    StopTimer();
+}
+
+void State::ResumeTiming() noexcept {
+    StartTimer();
+}
+
+void State::Fail(std::string_view message) {
+    if (m_error.empty()) {
+        m_error = message.empty() ? "Failed" : message;
+    }
+}
+
+bool Bench::RegisterBenchmark(std::string_view name, BenchmarkFunction function, std::vector<int64_t> arguments) {
+    auto& registry = impl::GetRegistry();
+
+    if (arguments.empty()) {
+        registry.emplace_back(Benchmark{ .Name = std::string(name), .Function = function });
+        return true;
+    }
+
+    for (const auto argument : arguments) {
+        registry.emplace_back(Benchmark{ .Name = std::string(name) + "/" + std::to_string(argument), .Function = function, .Argument = argument });
+    }
+    return true;
+}
+
+const std::vector<Benchmark>& Bench::GetBenchmarks() noexcept {
+    auto& registry = impl::GetRegistry();
+
+    //Registration order depends on the link order, sort once so runs are comparable
+    if (!std::ranges::is_sorted(registry, {}, &Benchmark::Name)) {
+        std::ranges::stable_sort(registry, {}, &Benchmark::Name);
+    }
+    return registry;
+}
+
+double Bench::Median(std::vector<double> values) noexcept {
+    if (values.empty()) {
+        return 0.0;
+    }
+
+    const auto middle = values.begin() + values.size() / 2;
+    std::ranges::nth_element(values, middle);
+
+    if (values.size() % 2 != 0) {
+        return *middle;
+    }
+
+    const auto lower = *std::max_element(values.begin(), middle);
+    return (lower + *middle) / 2.0;
+}
+
+double Bench::MedianAbsoluteDeviation(const std::vector<double>& values, double median) noexcept {
+    std::vector<double> deviations;
+    deviations.reserve(values.size());
+
+    for (const auto value : values) {
+        deviations.push_back(std::abs(value - median));
+    }
+    return Median(std::move(deviations));
+}
+
+std::vector<Result> Bench::RunBenchmarks(const Options& options, const std::function<void(const Result&)>& onResult) {
+    std::vector<Result> results;
+
+    for (const auto& benchmark : GetBenchmarks()) {
+        if (!options.Filter.empty() && !benchmark.Name.contains(options.Filter)) {
+            continue;
+        }
+
+        Result result{ .Name = benchmark.Name };
+
+        const auto iterations = impl::Calibrate(benchmark, options, result.Error);
+
+        if (iterations) {
+            result.Iterations = *iterations;
+
+            for (uint32_t i = 0; i < options.WarmupRepetitions; i++) {
+                (void)impl::RunOnce(benchmark, result.Iterations, false);
+            }
+
+            uint64_t itemsPerIteration = 0;
+            uint64_t bytesPerIteration = 0;
+
+            for (uint32_t i = 0; i < options.Repetitions && result.Error.empty(); i++) {
+                const auto state = impl::RunOnce(benchmark, result.Iterations, options.ReadCounters);
+
+                if (state.Failed()) {
+                    result.Error = state.GetError();
+                    break;
+                }
+
+                result.Samples.push_back(static_cast<double>(state.GetElapsed().count()) / static_cast<double>(result.Iterations));
+
+                if (const auto& counters = state.GetCounters()) {
+                    if (result.Counters) {
+                        *result.Counters += *counters;
+                    }
+                    else {
+                        result.Counters = counters;
+                    }
+                }
+
+                itemsPerIteration = state.GetItemsPerIteration();
+                bytesPerIteration = state.GetBytesPerIteration();
+            }
+
+            if (!result.Samples.empty()) {
+                result.Median                  = Median(result.Samples);
+                result.MedianAbsoluteDeviation = MedianAbsoluteDeviation(result.Samples, result.Median);
+                result.Min                     = std::ranges::min(result.Samples);
+                result.Mean                    = std::accumulate(result.Samples.begin(), result.Samples.end(), 0.0) / static_cast<double>(result.Samples.size());
+
+                if (result.Median > 0.0) {
+                    result.ItemsPerSecond = static_cast<double>(itemsPerIteration) * 1e9 / result.Median;
+                    result.BytesPerSecond = static_cast<double>(bytesPerIteration) * 1e9 / result.Median;
+                }
+            }
+
+            //Turn the summed counters into per iteration values
+            if (result.Counters) {
+                const auto totalIterations = result.Iterations * result.Samples.size();
+
+                for (auto& value : result.Counters->Values) {
+                    value = totalIterations > 0 ? value / totalIterations : 0;
+                }
+            }
+        }
+
+        result.Failed = !result.Error.empty();
+
+        if (onResult) {
+            onResult(result);
+        }
+        results.emplace_back(std::move(result));
+    }
+    return results;
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Core/Profiling/PerfCounters.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace Crystal::Bench {
+    //Keeps the compiler from optimizing away a value that is otherwise unused
+    template<class T>
+    inline void DoNotOptimize(const T& value) noexcept {
+#ifdef _MSC_VER
+        static volatile const void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    //Same as above, but the compiler also has to assume the value was modified,
+    //which keeps loop invariant inputs from being hoisted out of the timed loop
+    template<class T>
+    inline void DoNotOptimize(T& value) noexcept {
+#ifdef _MSC_VER
+        static volatile void* sink;
+        sink = &value;
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : "+r,m"(value) : : "memory");
+#endif
+    }
+
+    //Forces pending writes to memory to be treated as observable
+    inline void ClobberMemory() noexcept {
+#ifdef _MSC_VER
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    class State {
+    public:
+        //Not trivial on purpose, compilers do not warn about unused loop variables of such types
+        struct Value {
+            Value() noexcept {}
+            ~Value() noexcept {}
+        };
+
+        class Iterator {
+        public:
+            explicit Iterator(State* state, uint64_t remaining) noexcept : m_state(state), m_remaining(remaining) {}
+
+            [[nodiscard]] Value operator*() const noexcept { return {}; }
+            void operator++() noexcept { m_remaining--; }
+
+            [[nodiscard]] bool operator!=(const Iterator&) noexcept {
+                if (m_remaining > 0) [[likely]] {
+                    return true;
+                }
+                m_state->StopTimer();
+                return false;
+            }
+        private:
+            State* m_state;
+            uint64_t m_remaining;
+        };
+
+        State(uint64_t iterations, std::optional<int64_t> argument, bool readCounters) noexcept;
+
+        //Starts the timed loop, every iteration of `for (auto _ : state)` is measured
+        [[nodiscard]] Iterator begin() noexcept;
+        [[nodiscard]] Iterator end() noexcept { return Iterator(this, 0); }
+
+        //Excludes setup work inside the timed loop from the measurement
+        void PauseTiming() noexcept;
+        void ResumeTiming() noexcept;
+
+        void SetItemsPerIteration(uint64_t items) noexcept { m_itemsPerIteration = items; }
+        void SetBytesPerIteration(uint64_t bytes) noexcept { m_bytesPerIteration = bytes; }
+
+        //Marks the case as failed, e.g. when a validation inside the benchmark does not hold
+        void Fail(std::string_view message);
+
+        [[nodiscard]] uint64_t Iterations() const noexcept { return m_iterations; }
+        [[nodiscard]] int64_t Argument() const noexcept { return m_argument.value_or(0); }
+
+        [[nodiscard]] bool Failed() const noexcept { return !m_error.empty(); }
+        [[nodiscard]] const std::string& GetError() const noexcept { return m_error; }
+        [[nodiscard]] std::chrono::nanoseconds GetElapsed() const noexcept { return m_elapsed; }
+        [[nodiscard]] uint64_t GetItemsPerIteration() const noexcept { return m_itemsPerIteration; }
+        [[nodiscard]] uint64_t GetBytesPerIteration() const noexcept { return m_bytesPerIteration; }
+        [[nodiscard]] const std::optional<PerfCounterValues>& GetCounters() const noexcept { return m_counters; }
+    private:
+        void StartTimer() noexcept;
+        void StopTimer() noexcept;
+
+        uint64_t m_iterations;
+        std::optional<int64_t> m_argument;
+        bool m_readCounters;
+        bool m_running{ false };
+
+        std::chrono::steady_clock::time_point m_begin{};
+        std::chrono::nanoseconds m_elapsed{ 0 };
+
+        std::optional<PerfCounterValues> m_countersBegin;
+        std::optional<PerfCounterValues> m_counters;
+
+        uint64_t m_itemsPerIteration{ 0 };
+        uint64_t m_bytesPerIteration{ 0 };
+        std::string m_error;
+    };
+
+    using BenchmarkFunction = void(*)(State&);
+
+    struct Benchmark {
+        std::string Name;
+        BenchmarkFunction Function;
+        std::optional<int64_t> Argument;
+    };
+
+    struct Options {
+        std::string Filter;
+        uint32_t Repetitions{ 10 };
+        uint32_t WarmupRepetitions{ 2 };
+        std::chrono::milliseconds MinRepetitionTime{ 20 };
+        bool ReadCounters{ false };
+    };
+
+    struct Result {
+        std::string Name;
+        uint64_t Iterations{};
+
+        //Nanoseconds per iteration of every measured repetition
+        std::vector<double> Samples;
+
+        double Median{};
+        double MedianAbsoluteDeviation{};
+        double Min{};
+        double Mean{};
+        double ItemsPerSecond{};
+        double BytesPerSecond{};
+
+        //Hardware counters per iteration, summed over all measured repetitions
+        std::optional<PerfCounterValues> Counters;
+
+        bool Failed{};
+        std::string Error;
+    };
+
+    //Registers a case under the given name, once per argument when arguments are given
+    bool RegisterBenchmark(std::string_view name, BenchmarkFunction function, std::vector<int64_t> arguments = {});
+
+    [[nodiscard]] const std::vector<Benchmark>& GetBenchmarks() noexcept;
+    [[nodiscard]] std::vector<Result> RunBenchmarks(const Options& options, const std::function<void(const Result&)>& onResult = {});
+
+    [[nodiscard]] double Median(std::vector<double> values) noexcept;
+    [[nodiscard]] double MedianAbsoluteDeviation(const std::vector<double>& values, double median) noexcept;
+}
+
+#define CRYSTAL_BENCH_CONCAT_IMPL(a, b) a##b
+#define CRYSTAL_BENCH_CONCAT(a, b) CRYSTAL_BENCH_CONCAT_IMPL(a, b)
+
+//CRYSTAL_BENCHMARK(Function) or CRYSTAL_BENCHMARK(Function, 8, 64, 512) to run the case once per argument
+#define CRYSTAL_BENCHMARK(function, ...) \
+    static const bool CRYSTAL_BENCH_CONCAT(registered_, __LINE__) = ::Crystal::Bench::RegisterBenchmark(#function, function, { __VA_ARGS__ })
@@ -0,0 +1,1697 @@
+#include "../Benchmark.h"
+
+#include "Core/FileSystem/ImportCache.h"
+#include "Core/FileSystem/MappedFile.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Lib/Json.h"
+#include "Core/Lib/ThreadPool.h"
+#include "Core/Math/Matrix.h"
+#include "Graphics/CookedMesh.h"
+#include "Graphics/CookedTexture.h"
+#include "Graphics/GlbFile.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/Meshlets.h"
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    //Same layout as the engine vertex: position, normal, tangent, bitangent and texture coordinate
+    struct BenchVertex {
+        std::array<float, 15> Attributes;
+    };
+
+    constexpr uint32_t NUM_SCENE_SUBMESHES = 64;
+    constexpr uint32_t NUM_VERTEX_STREAMS  = 5;
+
+    struct SceneFiles {
+        std::string CookedPath;
+        std::string StreamedPath;
+        uint64_t UploadSize{ 0 };
+
+        SceneFiles() = default;
+        SceneFiles(const SceneFiles&) = delete;
+
+        ~SceneFiles() {
+            std::error_code error;
+            std::filesystem::remove(CookedPath, error);
+            std::filesystem::remove(StreamedPath, error);
+        }
+    };
+
+    //Writes the same scene as a cooked mesh and in a stream per attribute layout with a record per face, the way the
+    //assBin cache stored it. Loading the latter means reading every stream into its own array and interleaving them.
+    std::unique_ptr<SceneFiles> WriteSceneFiles(uint32_t numVertices) {
+        const auto directory = std::filesystem::temp_directory_path();
+
+        auto files          = std::make_unique<SceneFiles>();
+        files->CookedPath   = (directory / std::format("CrystalBench_Scene_{}.cmesh", numVertices)).string();
+        files->StreamedPath = (directory / std::format("CrystalBench_Scene_{}.stream", numVertices)).string();
+
+        const uint32_t verticesPerSubmesh = numVertices / NUM_SCENE_SUBMESHES;
+        const uint32_t facesPerSubmesh    = verticesPerSubmesh * 2;
+
+        CookedMeshWriter writer(sizeof(BenchVertex));
+        std::ofstream streamed(files->StreamedPath, std::ios::binary | std::ios::trunc);
+
+        std::vector<BenchVertex> vertices(verticesPerSubmesh);
+        std::vector<uint32_t> indices(size_t{ facesPerSubmesh } * 3);
+        std::vector<float> stream(size_t{ verticesPerSubmesh } * 3);
+        uint64_t random = 0x9E3779B97F4A7C15ull;
+
+        for (uint32_t submesh = 0; submesh < NUM_SCENE_SUBMESHES; submesh++) {
+            for (auto& vertex : vertices) {
+                for (auto& attribute : vertex.Attributes) {
+                    random    = random * 6364136223846793005ull + 1442695040888963407ull;
+                    attribute = static_cast<float>(random >> 40) / static_cast<float>(1 << 24);
+                }
+            }
+
+            for (auto& index : indices) {
+                random = random * 6364136223846793005ull + 1442695040888963407ull;
+                index  = static_cast<uint32_t>(random >> 33) % verticesPerSubmesh;
+            }
+
+            writer.AddSubmesh(std::as_bytes(std::span(vertices)), indices, CookedMeshFormat::NO_MATERIAL);
+
+            const std::array counts{ verticesPerSubmesh, facesPerSubmesh };
+            streamed.write(reinterpret_cast<const char*>(counts.data()), sizeof(counts));
+
+            for (uint32_t attribute = 0; attribute < NUM_VERTEX_STREAMS; attribute++) {
+                for (uint32_t vertex = 0; vertex < verticesPerSubmesh; vertex++) {
+                    std::memcpy(&stream[size_t{ vertex } * 3], &vertices[vertex].Attributes[attribute * 3], sizeof(float) * 3);
+                }
+                streamed.write(reinterpret_cast<const char*>(stream.data()), static_cast<std::streamsize>(stream.size() * sizeof(float)));
+            }
+
+            for (uint32_t face = 0; face < facesPerSubmesh; face++) {
+                const std::array record{ 3u, indices[face * 3], indices[face * 3 + 1], indices[face * 3 + 2] };
+                streamed.write(reinterpret_cast<const char*>(record.data()), sizeof(record));
+            }
+
+            files->UploadSize += vertices.size() * sizeof(BenchVertex) + indices.size() * sizeof(uint32_t);
+        }
+
+        if (!writer.Write(files->CookedPath) || !streamed.good()) {
+            return nullptr;
+        }
+        return files;
+    }
+
+    //Flushes the file and drops it from the page cache, the next load has to read it from the disk.
+    //Only implemented on Linux, elsewhere cold loads measure the same as warm ones.
+    void DropFromPageCache(const std::string& path) noexcept {
+#ifdef __linux__
+        if (const auto file = open(path.c_str(), O_RDONLY); file >= 0) {
+            fdatasync(file);
+            posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+            close(file);
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    //Returns the number of bytes written to the upload buffer, 0 if the file could not be loaded
+    uint64_t LoadCookedScene(const std::string& path, std::vector<std::byte>& upload) {
+        const auto cookedMesh = CookedMesh::Open(path);
+
+        if (!cookedMesh) {
+            return 0;
+        }
+
+        uint64_t offset = 0;
+
+        for (const auto& submesh : cookedMesh->GetSubmeshes()) {
+            const auto vertices = cookedMesh->GetVertexData(submesh);
+            const auto indices  = std::as_bytes(cookedMesh->GetIndices(submesh));
+
+            std::memcpy(upload.data() + offset, vertices.data(), vertices.size());
+            offset += vertices.size();
+            std::memcpy(upload.data() + offset, indices.data(), indices.size());
+            offset += indices.size();
+        }
+        return offset;
+    }
+
+    uint64_t LoadStreamedScene(const std::string& path, std::vector<std::byte>& upload) {
+        std::ifstream file(path, std::ios::binary);
+        uint64_t offset = 0;
+
+        std::array<uint32_t, 2> counts{};
+
+        while (file.read(reinterpret_cast<char*>(counts.data()), sizeof(counts))) {
+            const auto [numVertices, numFaces] = counts;
+
+            std::array<std::unique_ptr<float[]>, NUM_VERTEX_STREAMS> streams;
+
+            for (auto& stream : streams) {
+                stream = std::make_unique<float[]>(size_t{ numVertices } * 3);
+                file.read(reinterpret_cast<char*>(stream.get()), static_cast<std::streamsize>(size_t{ numVertices } * 3 * sizeof(float)));
+            }
+
+            std::vector<BenchVertex> vertices(numVertices);
+
+            for (uint32_t attribute = 0; attribute < NUM_VERTEX_STREAMS; attribute++) {
+                for (uint32_t vertex = 0; vertex < numVertices; vertex++) {
+                    std::memcpy(&vertices[vertex].Attributes[attribute * 3], &streams[attribute][size_t{ vertex } * 3], sizeof(float) * 3);
+                }
+            }
+
+            std::vector<uint32_t> indices;
+            indices.reserve(size_t{ numFaces } * 3);
+
+            for (uint32_t face = 0; face < numFaces; face++) {
+                std::array<uint32_t, 4> record{};
+                file.read(reinterpret_cast<char*>(record.data()), sizeof(record));
+
+                if (record[0] == 3) {
+                    indices.insert(indices.end(), record.begin() + 1, record.end());
+                }
+            }
+
+            std::memcpy(upload.data() + offset, vertices.data(), vertices.size() * sizeof(BenchVertex));
+            offset += vertices.size() * sizeof(BenchVertex);
+            std::memcpy(upload.data() + offset, indices.data(), indices.size() * sizeof(uint32_t));
+            offset += indices.size() * sizeof(uint32_t);
+        }
+        return file.eof() ? offset : 0;
+    }
+
+    //A scene import without the GPU: textures are decoded into a full mip chain and meshes are interleaved from separate
+    //attribute streams on the pool, then everything is copied into one upload buffer in order
+    struct ImportWorkload {
+        static constexpr uint32_t NUM_TEXTURES    = 32;
+        static constexpr uint32_t TEXTURE_EXTENT  = 256;
+        static constexpr uint32_t NUM_MESHES      = 64;
+        static constexpr uint32_t MESH_VERTICES   = 8192;
+
+        std::vector<std::vector<uint32_t>> EncodedTextures;
+        std::vector<std::array<std::vector<float>, NUM_VERTEX_STREAMS>> MeshStreams;
+    };
+
+    ImportWorkload MakeImportWorkload() {
+        ImportWorkload workload;
+        uint64_t random = 0xA0761D6478BD642Full;
+
+        const auto next = [&random] {
+            random = random * 6364136223846793005ull + 1442695040888963407ull;
+            return static_cast<uint32_t>(random >> 32);
+        };
+
+        workload.EncodedTextures.resize(ImportWorkload::NUM_TEXTURES);
+
+        for (auto& texture : workload.EncodedTextures) {
+            texture.resize(ImportWorkload::TEXTURE_EXTENT * ImportWorkload::TEXTURE_EXTENT);
+            std::ranges::generate(texture, next);
+        }
+
+        workload.MeshStreams.resize(ImportWorkload::NUM_MESHES);
+
+        for (auto& streams : workload.MeshStreams) {
+            for (auto& stream : streams) {
+                stream.resize(ImportWorkload::MESH_VERTICES * 3);
+                std::ranges::generate(stream, [&] { return static_cast<float>(next() >> 8); });
+            }
+        }
+        return workload;
+    }
+
+    //Box filters RGBA8 texels down to 1x1, the decoded texture holds every mip back to back
+    std::vector<uint32_t> DecodeTexture(const std::vector<uint32_t>& encoded, uint32_t extent) {
+        std::vector<uint32_t> decoded(encoded);
+
+        for (size_t source = 0; extent > 1; extent /= 2) {
+            const auto half = extent / 2;
+
+            for (uint32_t y = 0; y < half; y++) {
+                for (uint32_t x = 0; x < half; x++) {
+                    uint32_t texel = 0;
+
+                    for (uint32_t channel = 0; channel < 32; channel += 8) {
+                        uint32_t sum = 0;
+
+                        for (const auto& [dx, dy] : { std::pair{ 0u, 0u }, { 1u, 0u }, { 0u, 1u }, { 1u, 1u } }) {
+                            sum += (decoded[source + (y * 2 + dy) * extent + x * 2 + dx] >> channel) & 0xFF;
+                        }
+                        texel |= ((sum + 2) / 4) << channel;
+                    }
+                    decoded.push_back(texel);
+                }
+            }
+            source += size_t{ extent } * extent;
+        }
+        return decoded;
+    }
+
+    //Returns a hash of the upload buffer, it has to be the same for every thread count
+    uint64_t ImportScene(const ImportWorkload& workload, ThreadPool& threadPool) {
+        std::vector<std::vector<uint32_t>> textures(ImportWorkload::NUM_TEXTURES);
+        std::vector<std::vector<BenchVertex>> meshes(ImportWorkload::NUM_MESHES);
+
+        threadPool.ParallelFor(ImportWorkload::NUM_TEXTURES + ImportWorkload::NUM_MESHES, [&](size_t task) {
+            if (task < ImportWorkload::NUM_TEXTURES) {
+                textures[task] = DecodeTexture(workload.EncodedTextures[task], ImportWorkload::TEXTURE_EXTENT);
+                return;
+            }
+
+            const auto mesh     = task - ImportWorkload::NUM_TEXTURES;
+            const auto& streams = workload.MeshStreams[mesh];
+            auto& vertices      = meshes[mesh];
+
+            vertices.resize(ImportWorkload::MESH_VERTICES);
+
+            for (uint32_t attribute = 0; attribute < NUM_VERTEX_STREAMS; attribute++) {
+                for (uint32_t vertex = 0; vertex < ImportWorkload::MESH_VERTICES; vertex++) {
+                    std::memcpy(&vertices[vertex].Attributes[attribute * 3], &streams[attribute][size_t{ vertex } * 3], sizeof(float) * 3);
+                }
+            }
+        });
+
+        //Upload stage, only the calling thread records
+        std::vector<std::byte> upload;
+
+        for (const auto& texture : textures) {
+            const auto bytes = std::as_bytes(std::span(texture));
+            upload.insert(upload.end(), bytes.begin(), bytes.end());
+        }
+
+        for (const auto& vertices : meshes) {
+            const auto bytes = std::as_bytes(std::span(vertices));
+            upload.insert(upload.end(), bytes.begin(), bytes.end());
+        }
+
+        uint64_t hash = 0xCBF29CE484222325ull;
+
+        for (const auto byte : upload) {
+            hash = (hash ^ static_cast<uint64_t>(byte)) * 0x100000001B3ull;
+        }
+        return hash;
+    }
+
+    template <bool Cold>
+    void RunSceneLoad(State& state, uint64_t (*load)(const std::string&, std::vector<std::byte>&), bool cooked) {
+        const auto files = WriteSceneFiles(static_cast<uint32_t>(state.Argument()));
+
+        if (!files) {
+            state.Fail("Could not write the scene files");
+            return;
+        }
+
+        const auto& path = cooked ? files->CookedPath : files->StreamedPath;
+        std::vector<std::byte> upload(files->UploadSize);
+
+        if constexpr (Cold) {
+            DropFromPageCache(path);
+        }
+
+        for (auto _ : state) {
+            if constexpr (Cold) {
+                state.PauseTiming();
+                DropFromPageCache(path);
+                state.ResumeTiming();
+            }
+
+            if (load(path, upload) != files->UploadSize) [[unlikely]] {
+                state.Fail("Loaded scene does not match what was written");
+            }
+            DoNotOptimize(upload.data());
+        }
+
+        state.SetBytesPerIteration(files->UploadSize);
+    }
+}
+
+static void SceneLoad_StreamedCold(State& state) {
+    impl::RunSceneLoad<true>(state, impl::LoadStreamedScene, false);
+}
+CRYSTAL_BENCHMARK(SceneLoad_StreamedCold, 1 << 16, 1 << 20);
+
+static void SceneLoad_StreamedWarm(State& state) {
+    impl::RunSceneLoad<false>(state, impl::LoadStreamedScene, false);
+}
+CRYSTAL_BENCHMARK(SceneLoad_StreamedWarm, 1 << 16, 1 << 20);
+
+static void SceneLoad_CookedCold(State& state) {
+    impl::RunSceneLoad<true>(state, impl::LoadCookedScene, true);
+}
+CRYSTAL_BENCHMARK(SceneLoad_CookedCold, 1 << 16, 1 << 20);
+
+static void SceneLoad_CookedWarm(State& state) {
+    impl::RunSceneLoad<false>(state, impl::LoadCookedScene, true);
+}
+CRYSTAL_BENCHMARK(SceneLoad_CookedWarm, 1 << 16, 1 << 20);
+
+//Flipping a byte of every table has to make the cooked file fail validation instead of handing out bad ranges
+static void CookedMesh_RejectsCorruptFiles(State& state) {
+    const auto files = impl::WriteSceneFiles(1 << 12);
+
+    if (!files) {
+        state.Fail("Could not write the scene files");
+        return;
+    }
+
+    if (const auto cookedMesh = CookedMesh::Open(files->CookedPath); !cookedMesh || cookedMesh->GetSubmeshes().size() != impl::NUM_SCENE_SUBMESHES) {
+        state.Fail("Cooked scene could not be opened");
+        return;
+    }
+
+    const auto mappedFile = MappedFile::Open(files->CookedPath);
+    const auto bytes      = mappedFile->GetData();
+    const std::vector original(reinterpret_cast<const char*>(bytes.data()), reinterpret_cast<const char*>(bytes.data() + bytes.size()));
+
+    //Magic, version, stride, submesh count, the vertex blob offset and the last byte of the first index, which moves
+    //it past the vertices of its submesh
+    const auto firstIndexOffset = static_cast<size_t>(reinterpret_cast<const CookedMeshHeader*>(bytes.data())->IndexDataOffset);
+    const std::array<size_t, 6> CORRUPTED_BYTES{ 0, 4, 8, 12, 24, firstIndexOffset };
+
+    for (auto _ : state) {
+        for (const auto offset : CORRUPTED_BYTES) {
+            auto corrupted = original;
+            corrupted[offset + 3] ^= 0x40;
+
+            std::ofstream(files->CookedPath, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+
+            if (CookedMesh::Open(files->CookedPath)) [[unlikely]] {
+                state.Fail(std::format("Corrupted byte {} was not detected", offset + 3));
+            }
+        }
+
+        //A truncated file has to be rejected too
+        std::ofstream(files->CookedPath, std::ios::binary | std::ios::trunc).write(original.data(), static_cast<std::streamsize>(original.size() / 2));
+
+        if (CookedMesh::Open(files->CookedPath)) [[unlikely]] {
+            state.Fail("Truncated file was not detected");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(CookedMesh_RejectsCorruptFiles);
+
+//Meshlets and levels of detail of every submesh come back as written with their offsets moved onto the shared
+//tables, and a meshlet exceeding the limits in the header is rejected
+static void CookedMesh_MeshletsAndLods(State& state) {
+    constexpr uint32_t GRID_SIZE     = 48;
+    constexpr uint32_t NUM_SUBMESHES = 3;
+
+    std::vector<impl::BenchVertex> vertices(GRID_SIZE * GRID_SIZE);
+    std::vector<uint32_t> indices;
+
+    for (uint32_t vertex = 0; vertex < vertices.size(); vertex++) {
+        vertices[vertex].Attributes[0] = static_cast<float>(vertex % GRID_SIZE);
+        vertices[vertex].Attributes[1] = static_cast<float>(vertex / GRID_SIZE);
+    }
+
+    for (uint32_t y = 0; y + 1 < GRID_SIZE; y++) {
+        for (uint32_t x = 0; x + 1 < GRID_SIZE; x++) {
+            const auto i0 = y * GRID_SIZE + x;
+            indices.insert(indices.end(), { i0, i0 + 1, i0 + GRID_SIZE, i0 + GRID_SIZE, i0 + 1, i0 + GRID_SIZE + 1 });
+        }
+    }
+
+    const auto vertexData = std::as_bytes(std::span(vertices));
+    const auto meshlets   = BuildMeshlets(indices, vertexData, sizeof(impl::BenchVertex));
+    const auto lods       = GenerateLodChain(indices, vertexData, sizeof(impl::BenchVertex), { .LockBorder = false });
+    const auto path       = (std::filesystem::temp_directory_path() / "CrystalBench_Meshlets.cmesh").string();
+
+    for (auto _ : state) {
+        CookedMeshWriter writer(sizeof(impl::BenchVertex));
+
+        for (uint32_t submesh = 0; submesh < NUM_SUBMESHES; submesh++) {
+            writer.AddSubmesh(vertexData, indices, CookedMeshFormat::NO_MATERIAL, {}, meshlets, lods);
+        }
+
+        if (!writer.Write(path)) {
+            state.Fail("Could not write the cooked mesh");
+            return;
+        }
+
+        auto cookedMesh = CookedMesh::Open(path);
+
+        if (!cookedMesh) {
+            state.Fail("Cooked mesh with meshlets could not be opened");
+            return;
+        }
+
+        const auto meshletVertices  = cookedMesh->GetMeshletVertices();
+        const auto meshletTriangles = cookedMesh->GetMeshletTriangles();
+
+        for (const auto& submesh : cookedMesh->GetSubmeshes()) {
+            const auto cookedLods    = cookedMesh->GetLods(submesh);
+            const auto cookedIndices = cookedMesh->GetIndices(submesh);
+
+            //The full detail mesh comes first, the simplified levels follow it in the same index range
+            bool areLodsSame = cookedLods.size() == lods.Levels.size() + 1 && cookedLods[0].NumIndices == indices.size() &&
+                std::ranges::equal(cookedIndices.first(indices.size()), indices);
+
+            for (size_t level = 0; areLodsSame && level < lods.Levels.size(); level++) {
+                const auto& lod = lods.Levels[level];
+
+                areLodsSame =
+                    cookedLods[level + 1].Error == lod.Error &&
+                    std::ranges::equal(cookedIndices.subspan(cookedLods[level + 1].FirstIndex, cookedLods[level + 1].NumIndices),
+                        std::span(lods.Indices).subspan(lod.FirstIndex, lod.NumIndices));
+            }
+
+            if (lods.Levels.empty() || !areLodsSame) {
+                state.Fail("Levels of detail do not match what was written");
+                return;
+            }
+
+            const auto cookedMeshlets = cookedMesh->GetMeshlets(submesh);
+            const auto cookedBounds   = cookedMesh->GetMeshletBounds(submesh);
+
+            if (cookedMeshlets.size() != meshlets.Meshlets.size() || cookedBounds.size() != meshlets.Bounds.size()) {
+                state.Fail(std::format("Submesh has {} meshlets instead of {}", cookedMeshlets.size(), meshlets.Meshlets.size()));
+                return;
+            }
+
+            for (size_t i = 0; i < cookedMeshlets.size(); i++) {
+                const auto& cooked   = cookedMeshlets[i];
+                const auto& original = meshlets.Meshlets[i];
+
+                const bool isSame =
+                    cooked.NumVertices == original.NumVertices && cooked.NumTriangles == original.NumTriangles &&
+                    std::ranges::equal(meshletVertices.subspan(cooked.VertexOffset, cooked.NumVertices),
+                        std::span(meshlets.Vertices).subspan(original.VertexOffset, original.NumVertices)) &&
+                    std::ranges::equal(meshletTriangles.subspan(cooked.TriangleOffset, size_t{ cooked.NumTriangles } * 3),
+                        std::span(meshlets.Triangles).subspan(original.TriangleOffset, size_t{ original.NumTriangles } * 3)) &&
+                    std::memcmp(&cookedBounds[i], &meshlets.Bounds[i], sizeof(MeshletBounds)) == 0;
+
+                if (!isSame) [[unlikely]] {
+                    state.Fail(std::format("Meshlet {} does not match what was written", i));
+                    return;
+                }
+            }
+        }
+
+        //Vertex count of the first meshlet raised beyond what any meshlet of the file has, then its first triangle
+        //pointing past its vertices, the mapping is closed first
+        const auto header = cookedMesh->GetHeader();
+        cookedMesh.reset();
+
+        std::ifstream file(path, std::ios::binary);
+        const std::vector bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        file.close();
+
+        auto tooManyVertices = bytes;
+        const auto numVertices = uint32_t{ header.MaxMeshletVertices } + 1;
+        std::memcpy(&tooManyVertices[header.MeshletTableOffset + offsetof(Meshlet, NumVertices)], &numVertices, sizeof(numVertices));
+
+        auto triangleOutOfRange = bytes;
+        triangleOutOfRange[header.MeshletTriangleOffset + meshlets.Meshlets[0].TriangleOffset] = static_cast<char>(meshlets.Meshlets[0].NumVertices);
+
+        const std::array<std::pair<const std::vector<char>*, const char*>, 2> CORRUPTIONS{ {
+            { &tooManyVertices, "Meshlet above the vertex limit was not detected" },
+            { &triangleOutOfRange, "Meshlet triangle past the meshlet's vertices was not detected" },
+        } };
+
+        for (const auto& [corrupted, error] : CORRUPTIONS) {
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupted->data(), static_cast<std::streamsize>(corrupted->size()));
+
+            if (CookedMesh::Open(path)) [[unlikely]] {
+                state.Fail(error);
+                return;
+            }
+        }
+    }
+}
+CRYSTAL_BENCHMARK(CookedMesh_MeshletsAndLods);
+
+namespace impl {
+    //Minimal binary glTF writer, every buffer view lives in the binary chunk
+    class GlbBuilder {
+    public:
+        Json::Value Meshes    = Json::Value::MakeArray();
+        Json::Value Materials = Json::Value::MakeArray();
+        Json::Value Textures  = Json::Value::MakeArray();
+        Json::Value Images    = Json::Value::MakeArray();
+
+        //Written with a default scene holding the root nodes when there are any
+        Json::Value Nodes      = Json::Value::MakeArray();
+        Json::Value SceneNodes = Json::Value::MakeArray();
+
+        uint32_t AddBufferView(std::span<const std::byte> data, uint32_t stride = 0) {
+            m_binary.resize((m_binary.size() + 3) & ~size_t{ 3 });
+
+            auto view = Json::Value::MakeObject();
+            view.Set("buffer", 0);
+            view.Set("byteOffset", m_binary.size());
+            view.Set("byteLength", data.size());
+
+            if (stride != 0) {
+                view.Set("byteStride", stride);
+            }
+
+            m_binary.insert(m_binary.end(), data.begin(), data.end());
+            m_views.PushBack(std::move(view));
+            return static_cast<uint32_t>(m_views.Size() - 1);
+        }
+
+        uint32_t AddAccessor(uint32_t view, GltfComponentType componentType, size_t count, std::string_view type, uint32_t byteOffset = 0, bool normalized = false) {
+            auto accessor = Json::Value::MakeObject();
+            accessor.Set("bufferView", view);
+            accessor.Set("byteOffset", byteOffset);
+            accessor.Set("componentType", static_cast<uint32_t>(componentType));
+            accessor.Set("count", count);
+            accessor.Set("type", type);
+
+            if (normalized) {
+                accessor.Set("normalized", true);
+            }
+
+            m_accessors.PushBack(std::move(accessor));
+            return static_cast<uint32_t>(m_accessors.Size() - 1);
+        }
+
+        template <class T>
+        uint32_t AddAccessor(std::span<const T> data, GltfComponentType componentType, std::string_view type, bool normalized = false) {
+            const auto numComponents = GetNumComponents(type);
+            return AddAccessor(AddBufferView(std::as_bytes(data)), componentType, data.size() / numComponents, type, 0, normalized);
+        }
+
+        [[nodiscard]] std::vector<std::byte> Build() const {
+            auto document = Json::Value::MakeObject();
+            document.Set("asset", Json::Value::Object{ { "version", "2.0" } });
+            document.Set("buffers", Json::Value::Array{ Json::Value::Object{ { "byteLength", m_binary.size() } } });
+            document.Set("bufferViews", m_views);
+            document.Set("accessors", m_accessors);
+            document.Set("meshes", Meshes);
+            document.Set("materials", Materials);
+            document.Set("textures", Textures);
+            document.Set("images", Images);
+
+            if (Nodes.Size() > 0) {
+                document.Set("nodes", Nodes);
+                document.Set("scenes", Json::Value::Array{ Json::Value::Object{ { "nodes", SceneNodes } } });
+                document.Set("scene", 0);
+            }
+
+            auto json = Json::Serialize(document, false);
+            json.resize((json.size() + 3) & ~size_t{ 3 }, ' ');
+
+            const auto binarySize = (m_binary.size() + 3) & ~size_t{ 3 };
+            const auto fileSize   = 12 + 8 + json.size() + 8 + binarySize;
+
+            std::vector<std::byte> file;
+            file.reserve(fileSize);
+
+            const auto append = [&](const void* data, size_t size) {
+                const auto* bytes = static_cast<const std::byte*>(data);
+                file.insert(file.end(), bytes, bytes + size);
+            };
+
+            const std::array<uint32_t, 5> header{ GltfFormat::MAGIC, GltfFormat::VERSION, static_cast<uint32_t>(fileSize), static_cast<uint32_t>(json.size()), GltfFormat::CHUNK_JSON };
+            append(header.data(), sizeof(header));
+            append(json.data(), json.size());
+
+            const std::array<uint32_t, 2> binaryHeader{ static_cast<uint32_t>(binarySize), GltfFormat::CHUNK_BIN };
+            append(binaryHeader.data(), sizeof(binaryHeader));
+            append(m_binary.data(), m_binary.size());
+
+            file.resize(fileSize);
+            return file;
+        }
+    private:
+        [[nodiscard]] static uint32_t GetNumComponents(std::string_view type) noexcept {
+            return type == "VEC4" ? 4 : type == "VEC3" ? 3 : type == "VEC2" ? 2 : 1;
+        }
+
+        std::vector<std::byte> m_binary;
+        Json::Value m_views     = Json::Value::MakeArray();
+        Json::Value m_accessors = Json::Value::MakeArray();
+    };
+
+    bool WriteFile(const std::string& path, std::span<const std::byte> data) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return file.good();
+    }
+
+    constexpr uint32_t NUM_GLB_MESHES    = 64;
+    constexpr uint32_t NUM_GLB_MATERIALS = 4;
+
+    //Wavy grids with a separate buffer view per attribute like exporters write them, every mesh a primitive placed side
+    //by side by its own node, alternately with a translation and a matrix
+    struct GlbScene {
+        std::string Path;
+        uint64_t FileSize{ 0 };
+        uint64_t NumVertices{ 0 };
+
+        GlbScene() = default;
+        GlbScene(const GlbScene&) = delete;
+
+        ~GlbScene() {
+            std::error_code error;
+            std::filesystem::remove(Path, error);
+        }
+    };
+
+    std::unique_ptr<GlbScene> WriteGlbScene(uint32_t numVertices) {
+        const auto gridSize = static_cast<uint32_t>(std::sqrt(static_cast<double>(numVertices / NUM_GLB_MESHES)));
+
+        GlbBuilder builder;
+
+        for (uint32_t mesh = 0; mesh < NUM_GLB_MESHES; mesh++) {
+            std::vector<float> positions, normals, tangents, texCoords;
+            std::vector<uint32_t> indices;
+
+            for (uint32_t y = 0; y < gridSize; y++) {
+                for (uint32_t x = 0; x < gridSize; x++) {
+                    const auto u = static_cast<float>(x) / static_cast<float>(gridSize - 1);
+                    const auto v = static_cast<float>(y) / static_cast<float>(gridSize - 1);
+                    const auto height = 0.1f * std::sin(6.0f * u + static_cast<float>(mesh)) * std::cos(4.0f * v);
+
+                    positions.insert(positions.end(), { u, height, v });
+                    normals.insert(normals.end(), { 0.0f, 1.0f, 0.0f });
+                    tangents.insert(tangents.end(), { 1.0f, 0.0f, 0.0f, 1.0f });
+                    texCoords.insert(texCoords.end(), { u, v });
+                }
+            }
+
+            for (uint32_t y = 0; y + 1 < gridSize; y++) {
+                for (uint32_t x = 0; x + 1 < gridSize; x++) {
+                    const auto i0 = y * gridSize + x;
+                    indices.insert(indices.end(), { i0, i0 + gridSize, i0 + 1, i0 + 1, i0 + gridSize, i0 + gridSize + 1 });
+                }
+            }
+
+            const Json::Value::Object attributes{
+                { "POSITION",   builder.AddAccessor<float>(positions, GltfComponentType::Float, "VEC3") },
+                { "NORMAL",     builder.AddAccessor<float>(normals,   GltfComponentType::Float, "VEC3") },
+                { "TANGENT",    builder.AddAccessor<float>(tangents,  GltfComponentType::Float, "VEC4") },
+                { "TEXCOORD_0", builder.AddAccessor<float>(texCoords, GltfComponentType::Float, "VEC2") }
+            };
+
+            const Json::Value::Object primitive{
+                { "attributes", attributes },
+                { "indices",    builder.AddAccessor<uint32_t>(indices, GltfComponentType::UnsignedInt, "SCALAR") },
+                { "material",   mesh % NUM_GLB_MATERIALS }
+            };
+
+            builder.Meshes.PushBack(Json::Value::Object{ { "primitives", Json::Value::Array{ primitive } } });
+
+            if (mesh % 2 == 0) {
+                builder.Nodes.PushBack(Json::Value::Object{ { "mesh", mesh }, { "translation", Json::Value::Array{ mesh, 0, 0 } } });
+            }
+            else {
+                builder.Nodes.PushBack(Json::Value::Object{
+                    { "mesh", mesh },
+                    { "matrix", Json::Value::Array{ 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, mesh, 0, 0, 1 } }
+                });
+            }
+            builder.SceneNodes.PushBack(mesh);
+        }
+
+        for (uint32_t material = 0; material < NUM_GLB_MATERIALS; material++) {
+            builder.Images.PushBack(Json::Value::Object{ { "uri", std::format("Material{}_BaseColor.png", material) } });
+            builder.Textures.PushBack(Json::Value::Object{ { "source", material } });
+            builder.Materials.PushBack(Json::Value::Object{
+                { "name", std::format("Material{}", material) },
+                { "pbrMetallicRoughness", Json::Value::Object{ { "baseColorTexture", Json::Value::Object{ { "index", material } } } } }
+            });
+        }
+
+        auto scene         = std::make_unique<GlbScene>();
+        scene->Path        = (std::filesystem::temp_directory_path() / std::format("CrystalBench_Scene_{}.glb", numVertices)).string();
+        scene->NumVertices = uint64_t{ gridSize } * gridSize * NUM_GLB_MESHES;
+
+        const auto file = builder.Build();
+        scene->FileSize = file.size();
+
+        return WriteFile(scene->Path, file) ? std::move(scene) : nullptr;
+    }
+
+    //The data flow of the assimp import up to the engine vertices: the binary chunk is read into memory, every accessor
+    //is extracted into its own array of the aiMesh, V is flipped and every face gets its own index array. The left handed
+    //conversion then runs as separate passes over every array, before the meshes are interleaved like CookVertices does.
+    //None of assimp's other post-processing steps are included, the real import only costs more.
+    struct AssimpStyleFace {
+        uint32_t NumIndices{ 0 };
+        std::unique_ptr<uint32_t[]> Indices;
+    };
+
+    struct AssimpStyleMesh {
+        uint32_t NumVertices{ 0 };
+        uint32_t NumFaces{ 0 };
+        std::unique_ptr<Math::Vector3[]> Vertices, Normals, Tangents, Bitangents, TexCoords;
+        std::unique_ptr<AssimpStyleFace[]> Faces;
+    };
+
+    void ImportAssimpStyle(const std::string& path, std::vector<std::vector<Vertex>>& vertices, std::vector<std::vector<uint32_t>>& indices) {
+        std::ifstream file(path, std::ios::binary);
+        std::vector<char> contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        const auto glbFile    = GlbFile::Open(path);
+        const auto primitives = glbFile ? glbFile->GetPrimitives() : std::span<const GltfPrimitive>{};
+
+        std::vector<AssimpStyleMesh> meshes(primitives.size());
+
+        const auto extract = [](const GltfAccessor& accessor, uint32_t numComponents) {
+            auto data = std::make_unique<Math::Vector3[]>(accessor.Count);
+
+            for (uint32_t i = 0; i < accessor.Count; i++) {
+                std::array<float, 3> element{};
+                accessor.ReadFloats(i, std::span(element).first(numComponents));
+                data[i] = { element[0], element[1], element[2] };
+            }
+            return data;
+        };
+
+        for (size_t mesh = 0; mesh < primitives.size(); mesh++) {
+            const auto& primitive = primitives[mesh];
+            auto& aiMesh = meshes[mesh];
+
+            aiMesh.NumVertices = primitive.Positions.Count;
+            aiMesh.Vertices    = extract(primitive.Positions, 3);
+            aiMesh.Normals     = extract(*primitive.Normals, 3);
+            aiMesh.TexCoords   = extract(*primitive.TexCoords, 2);
+            aiMesh.Tangents    = std::make_unique<Math::Vector3[]>(aiMesh.NumVertices);
+            aiMesh.Bitangents  = std::make_unique<Math::Vector3[]>(aiMesh.NumVertices);
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                std::array<float, 4> tangent{};
+                primitive.Tangents->ReadFloats(i, tangent);
+
+                aiMesh.Tangents[i]   = { tangent[0], tangent[1], tangent[2] };
+                aiMesh.Bitangents[i] = aiMesh.Normals[i].Cross(aiMesh.Tangents[i]) * tangent[3];
+                aiMesh.TexCoords[i].y = 1.0f - aiMesh.TexCoords[i].y;
+            }
+
+            aiMesh.NumFaces = primitive.Indices->Count / 3;
+            aiMesh.Faces    = std::make_unique<AssimpStyleFace[]>(aiMesh.NumFaces);
+
+            for (uint32_t face = 0; face < aiMesh.NumFaces; face++) {
+                aiMesh.Faces[face] = { 3, std::make_unique<uint32_t[]>(3) };
+
+                for (uint32_t corner = 0; corner < 3; corner++) {
+                    aiMesh.Faces[face].Indices[corner] = primitive.Indices->ReadIndex(face * 3 + corner);
+                }
+            }
+        }
+
+        //MakeLeftHanded, FlipUVs and FlipWindingOrder
+        for (auto& aiMesh : meshes) {
+            for (auto* stream : { &aiMesh.Vertices, &aiMesh.Normals, &aiMesh.Tangents, &aiMesh.Bitangents }) {
+                for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                    (*stream)[i].z = -(*stream)[i].z;
+                }
+            }
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                aiMesh.TexCoords[i].y = 1.0f - aiMesh.TexCoords[i].y;
+            }
+
+            for (uint32_t face = 0; face < aiMesh.NumFaces; face++) {
+                std::swap(aiMesh.Faces[face].Indices[1], aiMesh.Faces[face].Indices[2]);
+            }
+        }
+
+        //OptimizeGraph bakes the node transforms, which MakeLeftHanded mirrored along with the meshes
+        for (size_t mesh = 0; mesh < meshes.size(); mesh++) {
+            if (!primitives[mesh].Transform) {
+                continue;
+            }
+
+            auto& aiMesh = meshes[mesh];
+
+            const auto mirror          = Math::Matrix::CreateScale(1.0f, 1.0f, -1.0f);
+            const auto transform       = mirror * *primitives[mesh].Transform * mirror;
+            const auto normalTransform = Math::Matrix::Transpose(Math::Matrix::Inverse(transform));
+
+            const auto transformDirection = [](const Math::Matrix& matrix, const Math::Vector3& direction) {
+                const auto transformed = matrix * Math::Vector4(direction.x, direction.y, direction.z, 0.0f);
+                return Math::Vector3(transformed.X, transformed.Y, transformed.Z).Normalized();
+            };
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                aiMesh.Vertices[i]   = transform * aiMesh.Vertices[i];
+                aiMesh.Normals[i]    = transformDirection(normalTransform, aiMesh.Normals[i]);
+                aiMesh.Tangents[i]   = transformDirection(transform, aiMesh.Tangents[i]);
+                aiMesh.Bitangents[i] = transformDirection(transform, aiMesh.Bitangents[i]);
+            }
+        }
+
+        vertices.resize(meshes.size());
+        indices.resize(meshes.size());
+
+        for (size_t mesh = 0; mesh < meshes.size(); mesh++) {
+            const auto& aiMesh = meshes[mesh];
+            vertices[mesh].resize(aiMesh.NumVertices);
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                vertices[mesh][i].Position = aiMesh.Vertices[i];
+            }
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                vertices[mesh][i].Normal = aiMesh.Normals[i];
+            }
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                vertices[mesh][i].Tangent   = aiMesh.Tangents[i];
+                vertices[mesh][i].Bitangent = aiMesh.Bitangents[i];
+            }
+
+            for (uint32_t i = 0; i < aiMesh.NumVertices; i++) {
+                vertices[mesh][i].TexCoord = aiMesh.TexCoords[i];
+            }
+
+            indices[mesh].clear();
+            indices[mesh].reserve(size_t{ aiMesh.NumFaces } * 3);
+
+            for (uint32_t face = 0; face < aiMesh.NumFaces; face++) {
+                indices[mesh].insert(indices[mesh].end(), aiMesh.Faces[face].Indices.get(), aiMesh.Faces[face].Indices.get() + 3);
+            }
+        }
+
+        DoNotOptimize(contents.data());
+    }
+
+    void ImportGlbDirect(const std::string& path, std::vector<std::vector<Vertex>>& vertices, std::vector<std::vector<uint32_t>>& indices) {
+        const auto glbFile    = GlbFile::Open(path);
+        const auto primitives = glbFile ? glbFile->GetPrimitives() : std::span<const GltfPrimitive>{};
+
+        vertices.resize(primitives.size());
+        indices.resize(primitives.size());
+
+        for (size_t mesh = 0; mesh < primitives.size(); mesh++) {
+            ReadGltfPrimitive(primitives[mesh], vertices[mesh], indices[mesh]);
+        }
+    }
+
+    //Both imports have to agree, texture coordinates only up to the rounding of assimp's two V flips
+    [[nodiscard]] bool AreImportsSame(const std::vector<std::vector<Vertex>>& lhs, const std::vector<std::vector<Vertex>>& rhs) noexcept {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+
+        for (size_t mesh = 0; mesh < lhs.size(); mesh++) {
+            const bool isSame = std::ranges::equal(lhs[mesh], rhs[mesh], [](const Vertex& a, const Vertex& b) {
+                return a.Position == b.Position && a.Normal == b.Normal && a.Tangent == b.Tangent && a.Bitangent == b.Bitangent &&
+                    std::abs(a.TexCoord.x - b.TexCoord.x) <= 1e-6f && std::abs(a.TexCoord.y - b.TexCoord.y) <= 1e-6f;
+            });
+
+            if (!isSame) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <bool Direct>
+    void RunGlbImport(State& state) {
+        const auto scene = WriteGlbScene(static_cast<uint32_t>(state.Argument()));
+
+        if (!scene) {
+            state.Fail("Could not write the glTF scene");
+            return;
+        }
+
+        std::vector<std::vector<Vertex>> vertices, expectedVertices;
+        std::vector<std::vector<uint32_t>> indices, expectedIndices;
+
+        ImportAssimpStyle(scene->Path, expectedVertices, expectedIndices);
+
+        for (auto _ : state) {
+            //Every import starts without vectors to reuse like the scene import does
+            state.PauseTiming();
+            vertices.clear();
+            indices.clear();
+            state.ResumeTiming();
+
+            if constexpr (Direct) {
+                ImportGlbDirect(scene->Path, vertices, indices);
+            }
+            else {
+                ImportAssimpStyle(scene->Path, vertices, indices);
+            }
+            ClobberMemory();
+        }
+
+        if (indices != expectedIndices || !AreImportsSame(vertices, expectedVertices) || expectedVertices.size() != NUM_GLB_MESHES) {
+            state.Fail("Direct import does not match the assimp style import");
+        }
+
+        state.SetItemsPerIteration(scene->NumVertices);
+        state.SetBytesPerIteration(scene->FileSize);
+    }
+}
+
+static void GlbImport_Direct(State& state) {
+    impl::RunGlbImport<true>(state);
+}
+CRYSTAL_BENCHMARK(GlbImport_Direct, 1 << 16, 1 << 20);
+
+static void GlbImport_AssimpStyle(State& state) {
+    impl::RunGlbImport<false>(state);
+}
+CRYSTAL_BENCHMARK(GlbImport_AssimpStyle, 1 << 16, 1 << 20);
+
+//Interleaved and normalized accessors, 16 bit indices, generated normals and tangents, skipped line primitives, node
+//transforms and material images come back in the engine convention. Files using what the reader leaves to assimp fail to open.
+static void GlbFile_Primitives(State& state) {
+    struct InterleavedVertex {
+        std::array<float, 3> Position;
+        std::array<uint16_t, 2> TexCoord;
+    };
+
+    const std::array<InterleavedVertex, 4> quad{
+        {
+            { { 0.0f, 0.0f, 0.0f }, { 0,     0     } },
+            { { 1.0f, 0.0f, 0.0f }, { 65535, 0     } },
+            { { 0.0f, 0.0f, 1.0f }, { 0,     65535 } },
+            { { 1.0f, 0.0f, 1.0f }, { 65535, 65535 } }
+        }
+    };
+
+    //Counter-clockwise seen from +y in glTF
+    const std::array<uint16_t, 6> quadIndices{ 0, 2, 1, 1, 2, 3 };
+    const std::array<float, 9> triangle{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f };
+    const std::array<std::byte, 4> image{ std::byte{ 0x89 }, std::byte{ 'P' }, std::byte{ 'N' }, std::byte{ 'G' } };
+
+    const auto build = [&](std::string_view modification) {
+        impl::GlbBuilder builder;
+
+        const auto quadView  = builder.AddBufferView(std::as_bytes(std::span(quad)), sizeof(InterleavedVertex));
+        const auto positions = builder.AddAccessor(quadView, GltfComponentType::Float, quad.size(), "VEC3");
+        const auto texCoords = builder.AddAccessor(quadView, GltfComponentType::UnsignedShort, quad.size(), "VEC2", offsetof(InterleavedVertex, TexCoord), true);
+
+        auto indices = builder.AddAccessor<uint16_t>(quadIndices, GltfComponentType::UnsignedShort, "SCALAR");
+
+        //Index 4 is past the last vertex of the quad
+        if (modification == "index") {
+            const std::array<uint16_t, 3> outOfRange{ 0, 1, 4 };
+            indices = builder.AddAccessor<uint16_t>(outOfRange, GltfComponentType::UnsignedShort, "SCALAR");
+        }
+
+        Json::Value::Object quadPrimitive{
+            { "attributes", Json::Value::Object{ { "POSITION", positions }, { "TEXCOORD_0", texCoords } } },
+            { "indices",    indices },
+            { "material",   0 }
+        };
+
+        if (modification == "strip") {
+            quadPrimitive.emplace_back("mode", 5);
+        }
+
+        //Far beyond what converts to an integer, it has to be rejected as a number first
+        if (modification == "huge index") {
+            std::ranges::find(quadPrimitive, "material", &Json::Value::Object::value_type::first)->second = 1e30;
+        }
+
+        const Json::Value::Object linePrimitive{
+            { "attributes", Json::Value::Object{ { "POSITION", positions } } },
+            { "mode",       1 }
+        };
+
+        const Json::Value::Object trianglePrimitive{
+            { "attributes", Json::Value::Object{ { "POSITION", builder.AddAccessor<float>(triangle, GltfComponentType::Float, "VEC3") } } }
+        };
+
+        builder.Meshes.PushBack(Json::Value::Object{ { "primitives", Json::Value::Array{ quadPrimitive, linePrimitive } } });
+        builder.Meshes.PushBack(Json::Value::Object{ { "primitives", Json::Value::Array{ trianglePrimitive } } });
+
+        //The quad stays in place, the triangle is moved and then used again by a child that turns it a quarter around
+        //y and mirrors it along z
+        Json::Value::Object child{
+            { "mesh",        1 },
+            { "translation", Json::Value::Array{ 0.0, 3.0, 0.0 } },
+            { "rotation",    Json::Value::Array{ 0.0, std::sqrt(0.5), 0.0, std::sqrt(0.5) } },
+            { "scale",       Json::Value::Array{ 1.0, 1.0, -1.0 } }
+        };
+
+        if (modification == "cycle") {
+            child.emplace_back("children", Json::Value::Array{ 0 });
+        }
+
+        builder.Nodes.PushBack(Json::Value::Object{ { "mesh", 1 }, { "translation", Json::Value::Array{ 2.0, 0.0, 0.0 } }, { "children", Json::Value::Array{ 1 } } });
+        builder.Nodes.PushBack(std::move(child));
+        builder.Nodes.PushBack(Json::Value::Object{ { "mesh", 0 } });
+        builder.SceneNodes = Json::Value::Array{ 2, 0 };
+
+        builder.Images.PushBack(Json::Value::Object{ { "uri", "Base%20Color.png" } });
+        builder.Images.PushBack(Json::Value::Object{ { "bufferView", builder.AddBufferView(image) }, { "mimeType", "image/png" } });
+        builder.Textures.PushBack(Json::Value::Object{ { "source", 0 } });
+        builder.Textures.PushBack(Json::Value::Object{ { "source", 1 } });
+
+        builder.Materials.PushBack(Json::Value::Object{
+            { "name", "Painted" },
+            { "pbrMetallicRoughness", Json::Value::Object{
+                { "baseColorFactor", Json::Value::Array{ 0.5, 0.25, 1.0, 0.75 } },
+                { "roughnessFactor", 0.5 },
+                { "baseColorTexture", Json::Value::Object{ { "index", 0 } } } } },
+            { "normalTexture", Json::Value::Object{ { "index", 1 }, { "scale", 2.0 } } }
+        });
+
+        auto file = builder.Build();
+
+        if (modification == "truncated") {
+            file.resize(file.size() - 16);
+        }
+        return file;
+    };
+
+    const auto path = (std::filesystem::temp_directory_path() / "CrystalBench_Primitives.glb").string();
+
+    const auto isNear = [](const Math::Vector3& v, float x, float y, float z) {
+        return std::abs(v.x - x) <= 1e-6f && std::abs(v.y - y) <= 1e-6f && std::abs(v.z - z) <= 1e-6f;
+    };
+
+    for (auto _ : state) {
+        if (!impl::WriteFile(path, build({}))) {
+            state.Fail("Could not write the glTF file");
+            return;
+        }
+
+        const auto glbFile = GlbFile::Open(path);
+
+        if (!glbFile || glbFile->GetPrimitives().size() != 3) {
+            state.Fail("glTF file did not open with three triangle primitives");
+            return;
+        }
+
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;
+
+        //z is mirrored and the winding flipped, the normal still points up and the tangent frame follows the texture
+        ReadGltfPrimitive(glbFile->GetPrimitives()[0], vertices, indices);
+
+        const bool isQuadConverted =
+            indices == std::vector<uint32_t>{ 0, 1, 2, 1, 3, 2 } &&
+            vertices.size() == 4 &&
+            isNear(vertices[2].Position, 0.0f, 0.0f, -1.0f) &&
+            isNear(vertices[3].TexCoord, 1.0f, 1.0f, 0.0f) &&
+            std::ranges::all_of(vertices, [&](const Vertex& vertex) {
+                return isNear(vertex.Normal, 0.0f, 1.0f, 0.0f) && isNear(vertex.Tangent, 1.0f, 0.0f, 0.0f) && isNear(vertex.Bitangent, 0.0f, 0.0f, -1.0f);
+            });
+
+        if (!isQuadConverted) {
+            state.Fail("Interleaved quad was not converted to the engine convention");
+            return;
+        }
+
+        ReadGltfPrimitive(glbFile->GetPrimitives()[1], vertices, indices);
+
+        if (indices != std::vector<uint32_t>{ 0, 2, 1 } || glbFile->GetPrimitives()[1].Material != GltfFormat::NO_INDEX) {
+            state.Fail("Triangle without indices was not numbered in order");
+            return;
+        }
+
+        if (!isNear(vertices[0].Position, 2.0f, 0.0f, 0.0f) || !isNear(vertices[1].Position, 2.0f, 0.0f, -1.0f)) {
+            state.Fail("Triangle was not moved by its node");
+            return;
+        }
+
+        //The mirror keeps the winding, the normal computed from it still points up
+        ReadGltfPrimitive(glbFile->GetPrimitives()[2], vertices, indices);
+
+        const bool isChildPlaced =
+            indices == std::vector<uint32_t>{ 0, 1, 2 } &&
+            isNear(vertices[0].Position, 2.0f, 3.0f, 0.0f) &&
+            isNear(vertices[1].Position, 1.0f, 3.0f, 0.0f) &&
+            isNear(vertices[2].Position, 2.0f, 3.0f, 1.0f) &&
+            std::ranges::all_of(vertices, [&](const Vertex& vertex) { return isNear(vertex.Normal, 0.0f, 1.0f, 0.0f); });
+
+        if (!isChildPlaced) {
+            state.Fail("Triangle of the child node was not transformed by both nodes");
+            return;
+        }
+
+        const auto& material = glbFile->GetMaterials()[0];
+        const auto images    = glbFile->GetImages();
+
+        const bool isMaterialRead =
+            material.Name == "Painted" && material.BaseColorFactor == std::array{ 0.5f, 0.25f, 1.0f, 0.75f } &&
+            material.RoughnessFactor == 0.5f && material.NormalScale == 2.0f &&
+            material.BaseColorTexture == 0 && material.NormalTexture == 1 && material.EmissiveTexture == GltfFormat::NO_INDEX &&
+            images.size() == 2 && images[0].Uri == "Base Color.png" && !images[0].IsEmbedded && images[1].IsEmbedded;
+
+        if (!isMaterialRead) {
+            state.Fail("Material or images do not match what was written");
+            return;
+        }
+
+        for (const auto modification : { "index", "strip", "huge index", "cycle", "truncated" }) {
+            if (!impl::WriteFile(path, build(modification)) || GlbFile::Open(path)) {
+                state.Fail(std::format("glTF file with the {} modification was opened", modification));
+                return;
+            }
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+CRYSTAL_BENCHMARK(GlbFile_Primitives);
+
+namespace impl {
+    struct TextureFiles {
+        std::string SourcePath;
+        std::string CookedPath;
+        uint64_t UploadSize{ 0 };
+
+        TextureFiles() = default;
+        TextureFiles(const TextureFiles&) = delete;
+
+        ~TextureFiles() {
+            std::error_code error;
+            std::filesystem::remove(SourcePath, error);
+            std::filesystem::remove(CookedPath, error);
+        }
+    };
+
+    //Smooth gradients with some noise on top, so filtering actually has to mix different values
+    std::vector<uint8_t> CreateTextureTexels(uint32_t width, uint32_t height) {
+        std::vector<uint8_t> texels(size_t{ width } * height * 4);
+        uint64_t random = 0xD1B54A32D192ED03ull;
+
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                random = random * 6364136223846793005ull + 1442695040888963407ull;
+
+                auto* texel = &texels[(size_t{ y } * width + x) * 4];
+                texel[0] = static_cast<uint8_t>(x * 255 / width);
+                texel[1] = static_cast<uint8_t>(y * 255 / height);
+                texel[2] = static_cast<uint8_t>(random >> 56);
+                texel[3] = static_cast<uint8_t>(255 - ((random >> 48) & 0x3F));
+            }
+        }
+        return texels;
+    }
+
+    //Uncompressed 32 bit TGA, stored bottom up in BGRA order like most tools write it
+    bool WriteTga(const std::string& path, std::span<const uint8_t> texels, uint32_t width, uint32_t height) {
+        std::array<uint8_t, 18> header{};
+        header[2]  = 2;
+        header[12] = static_cast<uint8_t>(width);
+        header[13] = static_cast<uint8_t>(width >> 8);
+        header[14] = static_cast<uint8_t>(height);
+        header[15] = static_cast<uint8_t>(height >> 8);
+        header[16] = 32;
+        header[17] = 8;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+        std::vector<uint8_t> row(size_t{ width } * 4);
+
+        for (uint32_t y = height; y-- > 0;) {
+            for (uint32_t x = 0; x < width; x++) {
+                const auto* texel = &texels[(size_t{ y } * width + x) * 4];
+                row[x * 4 + 0] = texel[2];
+                row[x * 4 + 1] = texel[1];
+                row[x * 4 + 2] = texel[0];
+                row[x * 4 + 3] = texel[3];
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+        }
+        return file.good();
+    }
+
+    //Writes the same sRGB texture as a TGA source and as a cooked texture with its full mip chain
+    std::unique_ptr<TextureFiles> WriteTextureFiles(uint32_t extent) {
+        const auto directory = std::filesystem::temp_directory_path();
+
+        auto files        = std::make_unique<TextureFiles>();
+        files->SourcePath = (directory / std::format("CrystalBench_Texture_{}.tga", extent)).string();
+        files->CookedPath = (directory / std::format("CrystalBench_Texture_{}.ctex", extent)).string();
+
+        const auto texels = CreateTextureTexels(extent, extent);
+
+        CookedTextureWriter writer(CookedTextureFormat::FORMAT_R8G8B8A8_UNORM, 1, 4, true);
+        writer.AddMips(GenerateMips(texels, extent, extent, { .IsSRGB = true }));
+
+        if (!WriteTga(files->SourcePath, texels, extent, extent) || !writer.Write(files->CookedPath)) {
+            return nullptr;
+        }
+
+        const auto cookedTexture = CookedTexture::Open(files->CookedPath);
+
+        if (!cookedTexture) {
+            return nullptr;
+        }
+
+        for (const auto& mip : cookedTexture->GetMips()) {
+            files->UploadSize += mip.Size;
+        }
+        return files;
+    }
+
+    //What the runtime path does for a TGA: read and swizzle the image, build the mip chain and copy every mip
+    //into upload memory row by row at the pitch the GPU copy needs. Returns the number of bytes written.
+    uint64_t LoadSourceTexture(const std::string& path, std::vector<std::byte>& upload) {
+        std::ifstream file(path, std::ios::binary);
+        std::array<uint8_t, 18> header{};
+
+        if (!file.read(reinterpret_cast<char*>(header.data()), header.size())) {
+            return 0;
+        }
+
+        const uint32_t width  = header[12] | (header[13] << 8);
+        const uint32_t height = header[14] | (header[15] << 8);
+
+        std::vector<uint8_t> texels(size_t{ width } * height * 4);
+        std::vector<uint8_t> row(size_t{ width } * 4);
+
+        for (uint32_t y = height; y-- > 0;) {
+            file.read(reinterpret_cast<char*>(row.data()), static_cast<std::streamsize>(row.size()));
+
+            for (uint32_t x = 0; x < width; x++) {
+                auto* texel = &texels[(size_t{ y } * width + x) * 4];
+                texel[0] = row[x * 4 + 2];
+                texel[1] = row[x * 4 + 1];
+                texel[2] = row[x * 4 + 0];
+                texel[3] = row[x * 4 + 3];
+            }
+        }
+
+        if (!file) {
+            return 0;
+        }
+
+        const auto mipChain = GenerateMips(texels, width, height, { .IsSRGB = true });
+        uint64_t offset = 0;
+
+        for (uint32_t mip = 0; mip < mipChain.Levels.size(); mip++) {
+            const auto& level    = mipChain.Levels[mip];
+            const auto mipTexels = mipChain.GetTexels(mip);
+            const auto rowSize   = size_t{ level.Width } * 4;
+            const auto rowPitch  = (rowSize + CookedTextureFormat::ROW_PITCH_ALIGNMENT - 1) & ~size_t{ CookedTextureFormat::ROW_PITCH_ALIGNMENT - 1 };
+
+            for (uint32_t y = 0; y < level.Height; y++) {
+                std::memcpy(upload.data() + offset + y * rowPitch, mipTexels.data() + y * rowSize, rowSize);
+            }
+            offset += rowPitch * level.Height;
+        }
+        return offset;
+    }
+
+    //Mips are stored at the upload pitch already, each one is a single copy out of the mapping
+    uint64_t LoadCookedTexture(const std::string& path, std::vector<std::byte>& upload) {
+        const auto cookedTexture = CookedTexture::Open(path);
+
+        if (!cookedTexture) {
+            return 0;
+        }
+
+        uint64_t offset = 0;
+
+        for (uint32_t mip = 0; mip < cookedTexture->GetHeader().NumMips; mip++) {
+            const auto data = cookedTexture->GetMipData(mip);
+
+            std::memcpy(upload.data() + offset, data.data(), data.size());
+            offset += data.size();
+        }
+        return offset;
+    }
+
+    template <bool Cold>
+    void RunTextureLoad(State& state, uint64_t (*load)(const std::string&, std::vector<std::byte>&), bool cooked) {
+        const auto files = WriteTextureFiles(static_cast<uint32_t>(state.Argument()));
+
+        if (!files) {
+            state.Fail("Could not write the texture files");
+            return;
+        }
+
+        const auto& path = cooked ? files->CookedPath : files->SourcePath;
+        std::vector<std::byte> upload(files->UploadSize);
+
+        for (auto _ : state) {
+            if constexpr (Cold) {
+                state.PauseTiming();
+                DropFromPageCache(path);
+                state.ResumeTiming();
+            }
+
+            if (load(path, upload) != files->UploadSize) [[unlikely]] {
+                state.Fail("Loaded texture does not match what was written");
+            }
+            DoNotOptimize(upload.data());
+        }
+
+        state.SetBytesPerIteration(files->UploadSize);
+    }
+}
+
+static void TextureLoad_SourceCold(State& state) {
+    impl::RunTextureLoad<true>(state, impl::LoadSourceTexture, false);
+}
+CRYSTAL_BENCHMARK(TextureLoad_SourceCold, 512, 2048);
+
+static void TextureLoad_SourceWarm(State& state) {
+    impl::RunTextureLoad<false>(state, impl::LoadSourceTexture, false);
+}
+CRYSTAL_BENCHMARK(TextureLoad_SourceWarm, 512, 2048);
+
+static void TextureLoad_CookedCold(State& state) {
+    impl::RunTextureLoad<true>(state, impl::LoadCookedTexture, true);
+}
+CRYSTAL_BENCHMARK(TextureLoad_CookedCold, 512, 2048);
+
+static void TextureLoad_CookedWarm(State& state) {
+    impl::RunTextureLoad<false>(state, impl::LoadCookedTexture, true);
+}
+CRYSTAL_BENCHMARK(TextureLoad_CookedWarm, 512, 2048);
+
+//Every mip has to come back unchanged at an aligned offset, smaller mips first, and broken files have to be rejected
+static void CookedTexture_Layout(State& state) {
+    constexpr uint32_t WIDTH  = 300;
+    constexpr uint32_t HEIGHT = 1000;
+
+    const auto path     = (std::filesystem::temp_directory_path() / "CrystalBench_Layout.ctex").string();
+    const auto mipChain = GenerateMips(impl::CreateTextureTexels(WIDTH, HEIGHT), WIDTH, HEIGHT);
+
+    CookedTextureWriter writer(CookedTextureFormat::FORMAT_R8G8B8A8_UNORM, 1, 4, false);
+    writer.AddMips(mipChain);
+
+    for (auto _ : state) {
+        if (!writer.Write(path)) {
+            state.Fail("Could not write the cooked texture");
+            return;
+        }
+
+        {
+            const auto cookedTexture = CookedTexture::Open(path);
+
+            if (!cookedTexture || cookedTexture->GetHeader().NumMips != mipChain.Levels.size()) {
+                state.Fail("Cooked texture could not be opened");
+                return;
+            }
+
+            const auto firstTailMip = cookedTexture->GetFirstTailMip();
+
+            for (uint32_t mip = 0; mip < mipChain.Levels.size(); mip++) {
+                const auto& cookedMip = cookedTexture->GetMips()[mip];
+                const auto data       = cookedTexture->GetMipData(mip);
+                const auto texels     = mipChain.GetTexels(mip);
+                const auto rowSize    = size_t{ cookedMip.Width } * 4;
+
+                for (uint32_t y = 0; y < cookedMip.Height; y++) {
+                    if (std::memcmp(data.data() + size_t{ y } * cookedMip.RowPitch, texels.data() + y * rowSize, rowSize) != 0) {
+                        state.Fail(std::format("Row {} of mip {} differs", y, mip));
+                        return;
+                    }
+                }
+
+                const bool isTail = mip >= firstTailMip;
+
+                if (isTail != (cookedMip.Size < CookedTextureFormat::STREAMING_ALIGNMENT)) {
+                    state.Fail(std::format("Mip {} is in the wrong part of the file", mip));
+                }
+
+                if (!isTail && cookedMip.Offset % CookedTextureFormat::STREAMING_ALIGNMENT != 0) {
+                    state.Fail(std::format("Streamed mip {} is not aligned for mapping", mip));
+                }
+
+                if (mip > 0 && cookedTexture->GetLoadSize(mip) >= cookedTexture->GetLoadSize(mip - 1)) {
+                    state.Fail(std::format("Loading up to mip {} reads more than the mip above", mip));
+                }
+            }
+        }
+
+        const auto mappedFile = MappedFile::Open(path);
+        const auto bytes      = mappedFile->GetData();
+        const std::vector original(reinterpret_cast<const char*>(bytes.data()), reinterpret_cast<const char*>(bytes.data() + bytes.size()));
+
+        //Magic, version, width, mip count and the row pitch of the first mip
+        constexpr std::array<size_t, 5> CORRUPTED_BYTES{ 0, 4, 16, 24, sizeof(CookedTextureHeader) + 8 };
+
+        for (const auto offset : CORRUPTED_BYTES) {
+            auto corrupted = original;
+            corrupted[offset] ^= 0x01;
+
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+
+            if (CookedTexture::Open(path)) [[unlikely]] {
+                state.Fail(std::format("Corrupted byte {} was not detected", offset));
+            }
+        }
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(original.data(), static_cast<std::streamsize>(original.size() - 1));
+
+        if (CookedTexture::Open(path)) [[unlikely]] {
+            state.Fail("Truncated file was not detected");
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove(path, error);
+}
+CRYSTAL_BENCHMARK(CookedTexture_Layout);
+
+//Argument is the number of threads taking part, including the calling one
+static void SceneImport_ThreadScaling(State& state) {
+    const auto workload = impl::MakeImportWorkload();
+
+    ThreadPool serialPool(0);
+    const auto expectedHash = impl::ImportScene(workload, serialPool);
+
+    ThreadPool threadPool(static_cast<uint32_t>(state.Argument()) - 1);
+
+    for (auto _ : state) {
+        if (impl::ImportScene(workload, threadPool) != expectedHash) [[unlikely]] {
+            state.Fail("Import result depends on the thread count");
+        }
+    }
+    state.SetItemsPerIteration(impl::ImportWorkload::NUM_TEXTURES + impl::ImportWorkload::NUM_MESHES);
+}
+CRYSTAL_BENCHMARK(SceneImport_ThreadScaling, 1, 2, 4, 8);
+
+namespace impl {
+    //Removes the directory of a throwaway import cache together with its sources
+    struct CacheDirectory {
+        std::filesystem::path Path;
+
+        explicit CacheDirectory(std::string_view name)
+            :
+            Path(std::filesystem::temp_directory_path() / name)
+        {
+            std::error_code error;
+            std::filesystem::remove_all(Path, error);
+            std::filesystem::create_directories(Path / "Sources", error);
+        }
+
+        CacheDirectory(const CacheDirectory&) = delete;
+
+        ~CacheDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(Path, error);
+        }
+
+        [[nodiscard]] std::string GetCachePath() const {
+            return (Path / "Cache").string();
+        }
+
+        std::string WriteSource(std::string_view name, std::string_view content) const {
+            const auto path = (Path / "Sources" / name).string();
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(content.data(), static_cast<std::streamsize>(content.size()));
+            return path;
+        }
+    };
+
+    //Stands in for a cooked scene, the cache only moves the staged file
+    bool StageAndCommit(ImportCache& importCache, uint64_t key, size_t sizeInBytes, std::span<const std::string> dependencies) {
+        const auto stagingPath = importCache.GetStagingPath(key);
+        const std::string content(sizeInBytes, 'c');
+
+        if (!std::ofstream(stagingPath, std::ios::binary | std::ios::trunc).write(content.data(), static_cast<std::streamsize>(content.size()))) {
+            return false;
+        }
+        return importCache.Commit(key, stagingPath, dependencies).has_value();
+    }
+
+    constexpr uint64_t IMPORT_SETTINGS_HASH = 0x5EED;
+}
+
+//Argument is the number of cached imports, a hit has to cost the same regardless of it
+static void ImportCache_Lookup(State& state) {
+    const impl::CacheDirectory directory("CrystalBench_ImportCache_Lookup");
+    ImportCache importCache(directory.GetCachePath());
+
+    const auto numEntries = static_cast<uint32_t>(state.Argument());
+    std::vector<std::string> sources;
+
+    for (uint32_t i = 0; i < numEntries; i++) {
+        const auto source     = directory.WriteSource(std::format("Scene{}.obj", i), std::format("o Scene{}", i));
+        const auto dependency = directory.WriteSource(std::format("Scene{}.mtl", i), std::format("newmtl Material{}", i));
+        const auto key        = importCache.ComputeKey(source, impl::IMPORT_SETTINGS_HASH);
+
+        const std::array dependencies{ source, dependency };
+
+        if (!key || !impl::StageAndCommit(importCache, *key, 256, dependencies)) {
+            state.Fail("Could not fill the import cache");
+            return;
+        }
+        sources.push_back(source);
+    }
+
+    size_t next = 0;
+
+    for (auto _ : state) {
+        const auto key = importCache.ComputeKey(sources[next], impl::IMPORT_SETTINGS_HASH);
+        auto artifact  = importCache.Find(*key);
+
+        if (!artifact) [[unlikely]] {
+            state.Fail("Cached import was not found");
+        }
+
+        DoNotOptimize(artifact);
+        next = (next + 1) % sources.size();
+    }
+    state.SetItemsPerIteration(1);
+}
+CRYSTAL_BENCHMARK(ImportCache_Lookup, 16, 256);
+
+//Every change that alters the import result has to miss, everything else has to hit, also after reopening the cache
+static void ImportCache_Invalidation(State& state) {
+    const impl::CacheDirectory directory("CrystalBench_ImportCache_Invalidation");
+
+    for (auto _ : state) {
+        const auto source     = directory.WriteSource("Scene.obj", "o Scene");
+        const auto dependency = directory.WriteSource("Scene.mtl", "newmtl Material");
+        const std::array dependencies{ source, dependency };
+
+        uint64_t key = 0;
+        {
+            ImportCache importCache(directory.GetCachePath());
+            key = importCache.ComputeKey(source, impl::IMPORT_SETTINGS_HASH).value_or(0);
+
+            if (importCache.Find(key) || !impl::StageAndCommit(importCache, key, 256, dependencies)) {
+                state.Fail("Could not commit the first import");
+                break;
+            }
+        }
+
+        //The index is written atomically and reloaded by the next session
+        ImportCache importCache(directory.GetCachePath());
+
+        if (!importCache.Find(key)) [[unlikely]] {
+            state.Fail("Unchanged import missed after reopening the cache");
+        }
+
+        if (importCache.ComputeKey(source, impl::IMPORT_SETTINGS_HASH + 1) == key) [[unlikely]] {
+            state.Fail("Changed import settings kept the key");
+        }
+
+        //Importers cooking the same asset at once each stage into their own file
+        if (importCache.GetStagingPath(key) == importCache.GetStagingPath(key)) [[unlikely]] {
+            state.Fail("Staging path was handed out twice");
+        }
+
+        //Same size on purpose, the content hash has to catch it even if the timestamp resolution does not
+        directory.WriteSource("Scene.mtl", "newmtl Materiak");
+
+        if (importCache.Find(key)) [[unlikely]] {
+            state.Fail("Changed dependency was not detected");
+        }
+
+        directory.WriteSource("Scene.obj", "o Scene2");
+
+        if (importCache.ComputeKey(source, impl::IMPORT_SETTINGS_HASH) == key) [[unlikely]] {
+            state.Fail("Changed source kept the key");
+        }
+
+        const auto statistics = importCache.GetStatistics();
+
+        if (statistics.NumEntries != 0 || statistics.NumInvalidated != 1 || statistics.NumHits != 1) [[unlikely]] {
+            state.Fail("Unexpected import cache statistics");
+        }
+
+        //Identical sources in two directories read the dependencies next to them, they must not share an entry
+        std::error_code error;
+        std::filesystem::create_directories(directory.Path / "Sources" / "A", error);
+        std::filesystem::create_directories(directory.Path / "Sources" / "B", error);
+
+        const auto sourceA = directory.WriteSource("A/Scene.obj", "o Scene");
+        const auto sourceB = directory.WriteSource("B/Scene.obj", "o Scene");
+        const std::array dependenciesA{ sourceA, directory.WriteSource("A/Scene.mtl", "newmtl Red") };
+        directory.WriteSource("B/Scene.mtl", "newmtl Blue");
+
+        const auto keyA = importCache.ComputeKey(sourceA, impl::IMPORT_SETTINGS_HASH).value_or(0);
+        const auto keyB = importCache.ComputeKey(sourceB, impl::IMPORT_SETTINGS_HASH).value_or(0);
+
+        if (!impl::StageAndCommit(importCache, keyA, 256, dependenciesA) || keyA == keyB || importCache.Find(keyB)) [[unlikely]] {
+            state.Fail("Identical sources in different directories share an import");
+        }
+
+        std::filesystem::remove_all(directory.GetCachePath(), error);
+    }
+}
+CRYSTAL_BENCHMARK(ImportCache_Invalidation);
+
+//Least recently used artifacts are dropped once the cache grows beyond its limit
+static void ImportCache_Eviction(State& state) {
+    const impl::CacheDirectory directory("CrystalBench_ImportCache_Eviction");
+
+    constexpr uint32_t NUM_IMPORTS   = 32;
+    constexpr uint64_t ARTIFACT_SIZE = KB(4);
+    constexpr uint64_t MAX_SIZE      = ARTIFACT_SIZE * 8;
+
+    for (auto _ : state) {
+        ImportCache importCache(directory.GetCachePath(), MAX_SIZE);
+        std::vector<uint64_t> keys;
+
+        for (uint32_t i = 0; i < NUM_IMPORTS; i++) {
+            const auto source = directory.WriteSource(std::format("Scene{}.obj", i), std::format("o Scene{}", i));
+            const auto key    = importCache.ComputeKey(source, impl::IMPORT_SETTINGS_HASH).value_or(0);
+
+            const std::array dependencies{ source };
+
+            if (!impl::StageAndCommit(importCache, key, ARTIFACT_SIZE, dependencies)) [[unlikely]] {
+                state.Fail("Could not commit an import");
+                break;
+            }
+
+            //The first import stays in use and has to survive every eviction
+            if (!importCache.Find(keys.empty() ? key : keys.front())) [[unlikely]] {
+                state.Fail("Recently used import was evicted");
+            }
+            keys.push_back(key);
+        }
+
+        const auto statistics = importCache.GetStatistics();
+
+        if (statistics.SizeInBytes > MAX_SIZE || statistics.NumEvicted != NUM_IMPORTS - MAX_SIZE / ARTIFACT_SIZE) [[unlikely]] {
+            state.Fail(std::format("Cache holds {} bytes after evicting {} imports", statistics.SizeInBytes, statistics.NumEvicted));
+        }
+
+        std::error_code error;
+        std::filesystem::remove_all(directory.GetCachePath(), error);
+    }
+    state.SetItemsPerIteration(NUM_IMPORTS);
+}
+CRYSTAL_BENCHMARK(ImportCache_Eviction);
+
+//Argument is the size of the hashed file in bytes
+static void HashBytes_Throughput(State& state) {
+    std::vector<std::byte> data(static_cast<size_t>(state.Argument()));
+
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<std::byte>(i * 131);
+    }
+
+    for (auto _ : state) {
+        DoNotOptimize(HashBytes(data));
+    }
+    state.SetBytesPerIteration(data.size());
+}
+CRYSTAL_BENCHMARK(HashBytes_Throughput, 1 << 10, 1 << 24);
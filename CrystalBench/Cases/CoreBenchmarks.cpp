@@ -0,0 +1,576 @@
+#include "../Benchmark.h"
+
+#include "Core/ECS/Entity.h"
+#include "Core/FileSystem/FileSystem.h"
+#include "Core/Lib/ConcurrentCache.h"
+#include "Core/Lib/StringId.h"
+#include "Core/Lib/ThreadPool.h"
+#include "Core/Lib/ThreadSafeQueue.h"
+#include "Core/Logging/Logger.h"
+#include "Core/Math/Transform.h"
+#include "Core/Time/FrameStatistics.h"
+
+#include <atomic>
+#include <format>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    //Discards every message so the logger cases measure formatting and dispatch only
+    class NullSink final : public ISink {
+    public:
+        void Emit(std::string_view message, LogLevel, const std::source_location&) noexcept override {
+            DoNotOptimize(message.size());
+        }
+    };
+
+    template<int N>
+    class TestComponent final : public AComponent {
+    public:
+        void Update() noexcept override { Value++; }
+        int Value{ N };
+    };
+
+    //Texture paths the way a scene import produces them
+    std::vector<std::string> MakeResourcePaths(size_t count) {
+        std::vector<std::string> paths;
+        paths.reserve(count);
+
+        for (size_t i = 0; i < count; i++) {
+            paths.push_back(std::format("Assets/Models/Sponza/textures/sponza_material_{}_diffuse.png", i));
+        }
+        return paths;
+    }
+
+    void AddNullSink() {
+        static const bool added = [] {
+            Logger::AddSink<NullSink>();
+            return true;
+        }();
+        (void)added;
+    }
+}
+
+static void ThreadSafeQueue_PushPop(State& state) {
+    ThreadSafeQueue<uint64_t> queue;
+    const auto batchSize = static_cast<uint64_t>(state.Argument());
+
+    for (auto _ : state) {
+        for (uint64_t i = 0; i < batchSize; i++) {
+            queue.Push(i);
+        }
+
+        uint64_t value = 0;
+        while (queue.TryPop(value)) {
+            DoNotOptimize(value);
+        }
+    }
+    state.SetItemsPerIteration(batchSize);
+}
+CRYSTAL_BENCHMARK(ThreadSafeQueue_PushPop, 1, 64, 1024);
+
+static void ThreadSafeQueue_Contended(State& state) {
+    ThreadSafeQueue<uint64_t> queue;
+    constexpr uint64_t batchSize = 1024;
+
+    for (auto _ : state) {
+        std::jthread producer([&queue] {
+            for (uint64_t i = 0; i < batchSize; i++) {
+                queue.Push(i);
+            }
+        });
+
+        uint64_t popped = 0;
+        uint64_t value  = 0;
+
+        while (popped < batchSize) {
+            if (queue.TryPop(value)) {
+                popped++;
+            }
+        }
+    }
+    state.SetItemsPerIteration(batchSize);
+}
+CRYSTAL_BENCHMARK(ThreadSafeQueue_Contended);
+
+static void Logger_Format(State& state) {
+    impl::AddNullSink();
+
+    int frame = 0;
+
+    for (auto _ : state) {
+        Logger::Info("Frame {} took {} ms on {}", frame++, 16.6, "RenderThread");
+    }
+}
+CRYSTAL_BENCHMARK(Logger_Format);
+
+static void Logger_Message(State& state) {
+    impl::AddNullSink();
+
+    for (auto _ : state) {
+        Logger::Warning("Descriptor heap is running out of space");
+    }
+}
+CRYSTAL_BENCHMARK(Logger_Message);
+
+static void Entity_GetComponent(State& state) {
+    Entity entity;
+    entity.AddComponent<impl::TestComponent<0>>();
+    entity.AddComponent<impl::TestComponent<1>>();
+    entity.AddComponent<impl::TestComponent<2>>();
+    entity.AddComponent<impl::TestComponent<3>>();
+    entity.AddComponent<Transform>();
+
+    for (auto _ : state) {
+        DoNotOptimize(entity.GetComponent<Transform>());
+        DoNotOptimize(entity.GetComponent<impl::TestComponent<1>>());
+    }
+
+    if (entity.GetComponent<impl::TestComponent<2>>()->Value != 2) {
+        state.Fail("Entity returned the wrong component");
+    }
+    state.SetItemsPerIteration(2);
+}
+CRYSTAL_BENCHMARK(Entity_GetComponent);
+
+static void Entity_AddRemoveComponent(State& state) {
+    Entity entity;
+    entity.AddComponent<impl::TestComponent<0>>();
+
+    for (auto _ : state) {
+        entity.AddComponent<Transform>();
+        entity.RemoveComponent<Transform>();
+    }
+}
+CRYSTAL_BENCHMARK(Entity_AddRemoveComponent);
+
+static void FileSystem_PathDecomposition(State& state) {
+    constexpr std::string_view path = "Assets/Models/Sponza/textures/sponza_column_a_diff.png";
+
+    for (auto _ : state) {
+        DoNotOptimize(FileSystem::GetDirectoryFromFilePath(path));
+        DoNotOptimize(FileSystem::GetFileNameFromFilePath(path));
+        DoNotOptimize(FileSystem::GetExtensionFromFilePath(path));
+        DoNotOptimize(FileSystem::GetParentDirectory(path));
+    }
+    state.SetItemsPerIteration(4);
+}
+CRYSTAL_BENCHMARK(FileSystem_PathDecomposition);
+
+static void FileSystem_ReplaceExtension(State& state) {
+    for (auto _ : state) {
+        DoNotOptimize(FileSystem::ReplaceExtension("Assets/Models/Sponza/sponza.gltf", ".cmesh"));
+    }
+}
+CRYSTAL_BENCHMARK(FileSystem_ReplaceExtension);
+
+static void FileSystem_Append(State& state) {
+    for (auto _ : state) {
+        DoNotOptimize(FileSystem::Append("Assets/Models", "Sponza/sponza.gltf"));
+    }
+}
+CRYSTAL_BENCHMARK(FileSystem_Append);
+
+//Cache lookups the way the texture cache did them, building a string key from the path every time
+static void StringKey_MapLookup(State& state) {
+    const auto paths = impl::MakeResourcePaths(1024);
+    std::unordered_map<std::string, size_t> cache;
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        cache.emplace(paths[i], i);
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        const std::string key(paths[index++ & 1023]);
+        DoNotOptimize(cache.find(key)->second);
+    }
+}
+CRYSTAL_BENCHMARK(StringKey_MapLookup);
+
+static void StringId_MapLookup(State& state) {
+    const auto paths = impl::MakeResourcePaths(1024);
+    std::vector<StringId> ids;
+    std::unordered_map<StringId, size_t> cache;
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        ids.push_back(StringId::Intern(paths[i]));
+        cache.emplace(ids.back(), i);
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        DoNotOptimize(cache.find(ids[index++ & 1023])->second);
+    }
+}
+CRYSTAL_BENCHMARK(StringId_MapLookup);
+
+//Interning a string that is already in the table, the path every repeated load takes
+static void StringId_InternExisting(State& state) {
+    const auto paths = impl::MakeResourcePaths(1024);
+
+    for (const auto& path : paths) {
+        (void)StringId::Intern(path);
+    }
+
+    size_t index = 0;
+    for (auto _ : state) {
+        DoNotOptimize(StringId::Intern(paths[index++ & 1023]));
+    }
+}
+CRYSTAL_BENCHMARK(StringId_InternExisting);
+
+//Threads interning overlapping names while others read them back, every id has to resolve to its own string
+static void StringId_ConcurrentIntern(State& state) {
+    using namespace Literals;
+    constexpr size_t NUM_THREADS = 4;
+    constexpr size_t NUM_NAMES   = 2048;
+
+    static_assert("Assets/Shaders/ComputeMipMaps.hlsl"_sid == StringId("Assets/Shaders/ComputeMipMaps.hlsl"));
+
+    std::vector<std::string> names;
+    uint32_t round = 0;
+
+    for (auto _ : state) {
+        //Fresh names every round so the table keeps growing while it is read
+        names.clear();
+        for (size_t i = 0; i < NUM_NAMES; i++) {
+            names.push_back(std::format("Round{}/Material{}", round, i));
+        }
+        round++;
+
+        std::atomic<bool> failed{ false };
+        std::vector<std::thread> threads;
+
+        for (size_t thread = 0; thread < NUM_THREADS; thread++) {
+            threads.emplace_back([&, thread] {
+                for (size_t i = 0; i < NUM_NAMES; i++) {
+                    const auto& name = names[(i * (thread + 1)) % NUM_NAMES];
+                    const auto id    = StringId::Intern(name);
+
+                    if (id.GetString() != name || id != StringId(name)) {
+                        failed = true;
+                    }
+                }
+            });
+        }
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (failed) {
+            state.Fail("An interned id resolved to a different string");
+        }
+    }
+
+    if (GetStringTableStatistics().NumCollisions != 0) {
+        state.Fail("The string table reported a hash collision");
+    }
+    state.SetItemsPerIteration(NUM_THREADS * NUM_NAMES);
+}
+CRYSTAL_BENCHMARK(StringId_ConcurrentIntern);
+
+//Cost of fanning out and joining, every index is visited exactly once and exceptions reach the caller
+static void ThreadPool_ParallelFor(State& state) {
+    const auto count = static_cast<size_t>(state.Argument());
+
+    ThreadPool threadPool(3);
+    std::vector<std::atomic<uint32_t>> visits(count);
+
+    for (auto _ : state) {
+        threadPool.ParallelFor(count, [&visits](size_t index) {
+            visits[index].fetch_add(1, std::memory_order_relaxed);
+        });
+    }
+
+    for (const auto& visit : visits) {
+        if (visit.load() != state.Iterations()) {
+            state.Fail("An index was skipped or visited twice");
+            break;
+        }
+    }
+
+    try {
+        threadPool.ParallelFor(count, [](size_t index) {
+            if (index == 7) {
+                throw std::runtime_error("Import failed");
+            }
+        });
+        state.Fail("Exception thrown by the body was swallowed");
+    }
+    catch (const std::runtime_error&) {}
+
+    state.SetItemsPerIteration(count);
+}
+CRYSTAL_BENCHMARK(ThreadPool_ParallelFor, 64, 4096);
+
+namespace impl {
+    //Stands in for a decoded and uploaded texture, the cache hands out shared handles to it
+    struct LoadedTexture {
+        StringId FilePath;
+        uint32_t LoadIndex;
+    };
+
+    using TextureHandle = std::shared_ptr<const LoadedTexture>;
+}
+
+//Argument is the number of threads loading overlapping texture sets at the same time. Every file has to be loaded
+//exactly once and everyone has to get the same handle for it, a failed load has to reach every waiter and be retried.
+static void ConcurrentCache_OverlappingLoads(State& state) {
+    constexpr size_t NUM_FILES        = 256;
+    constexpr size_t FILES_PER_THREAD = 128;
+
+    const auto numThreads = static_cast<size_t>(state.Argument());
+
+    std::vector<StringId> filePaths;
+
+    for (size_t i = 0; i < NUM_FILES; i++) {
+        filePaths.push_back(StringId::Intern(std::format("Textures/Material{}/Albedo.png", i)));
+    }
+
+    for (auto _ : state) {
+        ConcurrentCache<StringId, impl::TextureHandle> cache;
+
+        std::vector<std::atomic<uint32_t>> numLoads(NUM_FILES);
+        std::vector<impl::TextureHandle> handles(numThreads * FILES_PER_THREAD);
+        std::atomic<uint32_t> numFailures{ 0 };
+        std::atomic<bool> isStarted{ false };
+
+        std::vector<std::thread> threads;
+
+        for (size_t thread = 0; thread < numThreads; thread++) {
+            threads.emplace_back([&, thread] {
+                while (!isStarted.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                //Neighbouring threads share half of their files, in a different order
+                for (size_t i = 0; i < FILES_PER_THREAD; i++) {
+                    const auto file = (thread * FILES_PER_THREAD / 2 + (i * 7 + thread) % FILES_PER_THREAD) % NUM_FILES;
+
+                    try {
+                        handles[thread * FILES_PER_THREAD + i] = cache.GetOrLoad(filePaths[file], [&] {
+                            const auto loadIndex = numLoads[file].fetch_add(1, std::memory_order_relaxed);
+
+                            //The first load of every 16th file fails, its waiters see the error and the next caller retries
+                            if (file % 16 == 0 && loadIndex == 0) {
+                                std::this_thread::yield();
+                                throw std::runtime_error("Decoding failed");
+                            }
+
+                            std::this_thread::yield();
+                            return std::make_shared<const impl::LoadedTexture>(filePaths[file], loadIndex);
+                        });
+                    }
+                    catch (const std::runtime_error&) {
+                        numFailures.fetch_add(1, std::memory_order_relaxed);
+                        handles[thread * FILES_PER_THREAD + i] = cache.GetOrLoad(filePaths[file], [&] {
+                            return std::make_shared<const impl::LoadedTexture>(filePaths[file], numLoads[file].fetch_add(1, std::memory_order_relaxed));
+                        });
+                    }
+                }
+            });
+        }
+
+        isStarted.store(true, std::memory_order_release);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t file = 0; file < NUM_FILES; file++) {
+            const auto cached = cache.Find(filePaths[file]);
+
+            if (!cached) {
+                continue;
+            }
+
+            const auto expectedLoads = file % 16 == 0 ? 2u : 1u;
+
+            if (numLoads[file].load() != expectedLoads || (*cached)->LoadIndex != expectedLoads - 1) [[unlikely]] {
+                state.Fail(std::format("File {} was loaded {} times", file, numLoads[file].load()));
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < handles.size(); i++) {
+            const auto& handle = handles[i];
+            const auto cached  = handle ? cache.Find(handle->FilePath) : std::nullopt;
+
+            if (!cached || *cached != handle) [[unlikely]] {
+                state.Fail("Two requests for one file got different textures");
+                break;
+            }
+        }
+
+        if (numFailures.load() == 0) [[unlikely]] {
+            state.Fail("No failed load reached a caller");
+        }
+    }
+    state.SetItemsPerIteration(numThreads * FILES_PER_THREAD);
+}
+CRYSTAL_BENCHMARK(ConcurrentCache_OverlappingLoads, 2, 8, 32);
+
+//A load that fails after its key was erased and loaded again must not remove the newer entry
+static void ConcurrentCache_FailedLoadAfterErase(State& state) {
+    const auto filePath = StringId::Intern("Textures/Reloaded.png");
+
+    for (auto _ : state) {
+        ConcurrentCache<StringId, impl::TextureHandle> cache;
+
+        std::atomic<bool> isLoading{ false };
+        std::atomic<bool> isReloaded{ false };
+
+        std::jthread failingLoad([&] {
+            try {
+                DoNotOptimize(cache.GetOrLoad(filePath, [&]() -> impl::TextureHandle {
+                    isLoading.store(true, std::memory_order_release);
+
+                    while (!isReloaded.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    throw std::runtime_error("Decode failed");
+                }));
+            }
+            catch (const std::runtime_error&) {}
+        });
+
+        while (!isLoading.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        const bool isErased = cache.Erase(filePath);
+        const auto reloaded = cache.GetOrLoad(filePath, [&] {
+            return std::make_shared<const impl::LoadedTexture>(filePath, 1u);
+        });
+
+        isReloaded.store(true, std::memory_order_release);
+        failingLoad.join();
+
+        const auto cached = cache.Find(filePath);
+
+        if (!isErased || !cached || *cached != reloaded) [[unlikely]] {
+            state.Fail("The failed load removed the entry of a later load");
+            break;
+        }
+    }
+}
+CRYSTAL_BENCHMARK(ConcurrentCache_FailedLoadAfterErase);
+
+//Lookups of cached entries from several threads, sharding keeps them from queueing on a single lock
+static void ConcurrentCache_Hits(State& state) {
+    constexpr size_t NUM_KEYS = 1024;
+
+    ConcurrentCache<uint64_t, impl::TextureHandle> cache;
+
+    for (uint64_t key = 0; key < NUM_KEYS; key++) {
+        DoNotOptimize(cache.GetOrLoad(key, [key] {
+            return std::make_shared<const impl::LoadedTexture>(StringId{}, static_cast<uint32_t>(key));
+        }));
+    }
+
+    ThreadPool threadPool(3);
+
+    for (auto _ : state) {
+        threadPool.ParallelFor(NUM_KEYS, [&cache](size_t key) {
+            DoNotOptimize(cache.GetOrLoad(key, []() -> impl::TextureHandle {
+                throw std::logic_error("Cached key was loaded again");
+            }));
+        });
+    }
+    state.SetItemsPerIteration(NUM_KEYS);
+}
+CRYSTAL_BENCHMARK(ConcurrentCache_Hits);
+
+//The frame thread keeps overwriting the ring while another thread copies it. Every copied frame has to carry the stage
+//time that was recorded for its own index, a torn record would mix two frames.
+static void FrameStatistics_RecentFramesWhileWriting(State& state) {
+    constexpr uint64_t NUM_FRAMES = 1 << 14;
+
+    auto& frameStatistics = FrameStatistics::Get();
+    const auto stageId    = frameStatistics.RegisterStage("Bench");
+
+    if (!stageId) {
+        state.Fail("Could not register the stage");
+        return;
+    }
+
+    const auto stageMicroseconds = [](uint64_t frameIndex) { return frameIndex * 7 % 1000 + 1; };
+
+    for (auto _ : state) {
+        frameStatistics.Reset();
+
+        std::atomic<bool> isDone{ false };
+        uint64_t numCopied = 0;
+
+        std::jthread writer([&] {
+            for (uint64_t frame = 0; frame < NUM_FRAMES; frame++) {
+                frameStatistics.RecordStage(*stageId, std::chrono::microseconds(stageMicroseconds(frame)));
+                frameStatistics.EndFrame();
+            }
+            isDone.store(true, std::memory_order_release);
+        });
+
+        while (!isDone.load(std::memory_order_acquire)) {
+            const auto frames = frameStatistics.GetRecentFrames();
+
+            for (size_t i = 0; i < frames.size(); i++) {
+                const bool isValid =
+                    frames[i].StageMicroseconds[*stageId] == stageMicroseconds(frames[i].FrameIndex) &&
+                    (i == 0 || frames[i - 1].FrameIndex < frames[i].FrameIndex);
+
+                if (!isValid) [[unlikely]] {
+                    state.Fail(std::format("Frame {} was torn or out of order", frames[i].FrameIndex));
+                    break;
+                }
+            }
+            numCopied += frames.size();
+        }
+
+        DoNotOptimize(numCopied);
+    }
+
+    frameStatistics.Reset();
+    state.SetItemsPerIteration(NUM_FRAMES);
+}
+CRYSTAL_BENCHMARK(FrameStatistics_RecentFramesWhileWriting);
+
+//Stage names are stored truncated, registering a name longer than that again has to find the stage instead of using
+//up another one each time
+static void FrameStatistics_LongStageName(State& state) {
+    constexpr std::string_view LONG_NAME = "Bench stage with a name longer than a stage name can hold";
+    static_assert(LONG_NAME.size() >= FrameStatistics::MAX_NAME_LENGTH);
+
+    auto& frameStatistics = FrameStatistics::Get();
+    const auto stageId    = frameStatistics.RegisterStage(LONG_NAME);
+
+    if (!stageId) {
+        state.Fail("Could not register the stage");
+        return;
+    }
+
+    const auto stageCount = frameStatistics.GetStageCount();
+
+    for (auto _ : state) {
+        const auto registeredId = frameStatistics.RegisterStage(LONG_NAME);
+
+        if (registeredId != stageId || frameStatistics.FindStage(LONG_NAME) != stageId) [[unlikely]] {
+            state.Fail("A long stage name did not find the stage it registered");
+            break;
+        }
+        DoNotOptimize(registeredId);
+    }
+
+    if (frameStatistics.GetStageCount() != stageCount) {
+        state.Fail(std::format("Registering a long name again added {} stages", frameStatistics.GetStageCount() - stageCount));
+    }
+}
+CRYSTAL_BENCHMARK(FrameStatistics_LongStageName);
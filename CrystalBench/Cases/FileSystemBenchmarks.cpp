@@ -0,0 +1,511 @@
+#include "../Benchmark.h"
+
+#include "Core/FileSystem/PakFile.h"
+#include "Core/FileSystem/VirtualFileSystem.h"
+#include "Core/Lib/Compression.h"
+#include "Core/Lib/Hash.h"
+#include "Core/Lib/ThreadPool.h"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    constexpr size_t SMALL_FILE_SIZE = 4096;
+
+    //Text that compresses about as well as exported scene and material files, numbers on a coarse grid
+    std::vector<std::byte> MakeAssetData(size_t size, uint64_t seed) {
+        std::vector<std::byte> data;
+        data.reserve(size + 64);
+
+        uint64_t random = seed * 0x9E3779B97F4A7C15ull + 1;
+        std::array<char, 64> line{};
+
+        while (data.size() < size) {
+            auto* end = line.data();
+            *end++    = 'v';
+
+            for (int axis = 0; axis < 3; axis++) {
+                random = random * 6364136223846793005ull + 1442695040888963407ull;
+                *end++ = ' ';
+                end    = std::to_chars(end, line.data() + line.size(), static_cast<int32_t>(random >> 54) - 512).ptr;
+            }
+            *end++ = '\n';
+
+            const auto bytes = std::as_bytes(std::span(line.data(), end));
+            data.insert(data.end(), bytes.begin(), bytes.end());
+        }
+
+        data.resize(size);
+        return data;
+    }
+
+    bool WriteVfsFile(const std::filesystem::path& path, std::span<const std::byte> data) {
+        std::error_code error;
+        std::filesystem::create_directories(path.parent_path(), error);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        return file.good();
+    }
+
+    //Same as the scene loads, only implemented on Linux
+    void EvictFromPageCache(const std::string& path) noexcept {
+#ifdef __linux__
+        if (const auto file = open(path.c_str(), O_RDONLY); file >= 0) {
+            fdatasync(file);
+            posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+            close(file);
+        }
+#else
+        (void)path;
+#endif
+    }
+
+    //The same files loose in a directory, in a compressed archive and in an uncompressed one
+    struct VfsFiles {
+        std::filesystem::path Directory;
+        std::string LooseDirectory;
+        std::string EmptyDirectory;
+        std::string CompressedPakPath;
+        std::string StoredPakPath;
+        std::vector<std::string> Paths;
+        uint64_t SizeInBytes{ 0 };
+
+        VfsFiles() = default;
+        VfsFiles(const VfsFiles&) = delete;
+
+        ~VfsFiles() {
+            std::error_code error;
+            std::filesystem::remove_all(Directory, error);
+        }
+    };
+
+    std::unique_ptr<VfsFiles> WriteVfsFiles(std::string_view name, uint32_t numFiles, size_t fileSize) {
+        auto files       = std::make_unique<VfsFiles>();
+        files->Directory = std::filesystem::temp_directory_path() / std::format("CrystalBench_{}", name);
+
+        std::error_code error;
+        std::filesystem::remove_all(files->Directory, error);
+
+        files->LooseDirectory    = (files->Directory / "Loose").string();
+        files->EmptyDirectory    = (files->Directory / "Empty").string();
+        files->CompressedPakPath = (files->Directory / "Compressed.pak").string();
+        files->StoredPakPath     = (files->Directory / "Stored.pak").string();
+
+        std::filesystem::create_directories(files->EmptyDirectory, error);
+
+        PakWriter compressedWriter;
+        PakWriter storedWriter;
+
+        for (uint32_t i = 0; i < numFiles; i++) {
+            const auto path       = std::format("models/group{}/asset{}.txt", i % 32, i);
+            const auto sourcePath = (std::filesystem::path(files->LooseDirectory) / path).string();
+
+            if (!WriteVfsFile(sourcePath, MakeAssetData(fileSize, i))) {
+                return nullptr;
+            }
+
+            compressedWriter.AddLooseFile(path, sourcePath, true);
+            storedWriter.AddLooseFile(path, sourcePath, false);
+
+            files->Paths.push_back(path);
+            files->SizeInBytes += fileSize;
+        }
+
+        if (!compressedWriter.Write(files->CompressedPakPath) || !storedWriter.Write(files->StoredPakPath)) {
+            return nullptr;
+        }
+        return files;
+    }
+
+    enum class VfsSource {
+        Loose,
+        LooseOverridingPak,
+        StoredPak,
+        CompressedPak
+    };
+
+    //Loose files are looked up in the written directory. With overrides every open probes an empty directory first,
+    //the cost development builds pay for files that are only in an archive.
+    std::unique_ptr<VirtualFileSystem> CreateVfs(const VfsFiles& files, VfsSource source, ThreadPool* threadPool = nullptr) {
+        switch (source) {
+        case VfsSource::Loose:
+            return std::make_unique<VirtualFileSystem>(files.LooseDirectory, false, threadPool);
+        case VfsSource::LooseOverridingPak:
+            return std::make_unique<VirtualFileSystem>(files.EmptyDirectory, true, threadPool);
+        default:
+            return std::make_unique<VirtualFileSystem>("", false, threadPool);
+        }
+    }
+
+    [[nodiscard]] const std::string& GetPakPath(const VfsFiles& files, VfsSource source) noexcept {
+        return source == VfsSource::StoredPak ? files.StoredPakPath : files.CompressedPakPath;
+    }
+
+    void RunVfsOpen(State& state, VfsSource source) {
+        const auto files = WriteVfsFiles("VfsOpen", static_cast<uint32_t>(state.Argument()), SMALL_FILE_SIZE);
+
+        if (!files) {
+            state.Fail("Could not write the files");
+            return;
+        }
+
+        const auto vfs = CreateVfs(*files, source);
+
+        if (source != VfsSource::Loose && !vfs->Mount(GetPakPath(*files, source))) {
+            state.Fail("Could not mount the archive");
+            return;
+        }
+
+        for (auto _ : state) {
+            for (const auto& path : files->Paths) {
+                const auto file = vfs->Open(path);
+
+                if (!file || file->GetSize() != SMALL_FILE_SIZE) [[unlikely]] {
+                    state.Fail(std::format("Could not open {}", path));
+                    return;
+                }
+                DoNotOptimize(file->GetData()[SMALL_FILE_SIZE - 1]);
+            }
+        }
+
+        state.SetItemsPerIteration(files->Paths.size());
+    }
+
+    //Opens one large file and hashes it, mapped files are only read from the disk while they are hashed
+    template<bool Cold>
+    void RunVfsRead(State& state, VfsSource source) {
+        const auto files = WriteVfsFiles("VfsRead", 1, static_cast<size_t>(state.Argument()));
+
+        if (!files) {
+            state.Fail("Could not write the files");
+            return;
+        }
+
+        ThreadPool threadPool;
+
+        const auto vfs       = CreateVfs(*files, source, &threadPool);
+        const auto& path     = files->Paths.front();
+        const auto diskPath  = source == VfsSource::Loose ? (std::filesystem::path(files->LooseDirectory) / path).string() : GetPakPath(*files, source);
+
+        const auto expectedHash = HashBytes(MakeAssetData(files->SizeInBytes, 0));
+
+        for (auto _ : state) {
+            //A mounted archive stays mapped and in the page cache, so cold runs mount it again after dropping it
+            if constexpr (Cold) {
+                state.PauseTiming();
+                vfs->Unmount(diskPath);
+                EvictFromPageCache(diskPath);
+                state.ResumeTiming();
+            }
+
+            if (source != VfsSource::Loose && vfs->GetNumMounts() == 0 && !vfs->Mount(diskPath)) [[unlikely]] {
+                state.Fail("Could not mount the archive");
+                return;
+            }
+
+            const auto file = vfs->Open(path);
+
+            if (!file || HashBytes(file->GetData()) != expectedHash) [[unlikely]] {
+                state.Fail("Read file does not match what was written");
+                return;
+            }
+        }
+
+        state.SetBytesPerIteration(files->SizeInBytes);
+    }
+}
+
+static void VirtualFileSystem_OpenLoose(State& state) {
+    impl::RunVfsOpen(state, impl::VfsSource::Loose);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_OpenLoose, 1024);
+
+static void VirtualFileSystem_OpenStoredPak(State& state) {
+    impl::RunVfsOpen(state, impl::VfsSource::StoredPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_OpenStoredPak, 1024);
+
+static void VirtualFileSystem_OpenCompressedPak(State& state) {
+    impl::RunVfsOpen(state, impl::VfsSource::CompressedPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_OpenCompressedPak, 1024);
+
+static void VirtualFileSystem_OpenPakWithOverrides(State& state) {
+    impl::RunVfsOpen(state, impl::VfsSource::LooseOverridingPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_OpenPakWithOverrides, 1024);
+
+static void VirtualFileSystem_ReadLooseCold(State& state) {
+    impl::RunVfsRead<true>(state, impl::VfsSource::Loose);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadLooseCold, 1 << 24);
+
+static void VirtualFileSystem_ReadLooseWarm(State& state) {
+    impl::RunVfsRead<false>(state, impl::VfsSource::Loose);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadLooseWarm, 1 << 24);
+
+static void VirtualFileSystem_ReadStoredPakCold(State& state) {
+    impl::RunVfsRead<true>(state, impl::VfsSource::StoredPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadStoredPakCold, 1 << 24);
+
+static void VirtualFileSystem_ReadStoredPakWarm(State& state) {
+    impl::RunVfsRead<false>(state, impl::VfsSource::StoredPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadStoredPakWarm, 1 << 24);
+
+static void VirtualFileSystem_ReadCompressedPakCold(State& state) {
+    impl::RunVfsRead<true>(state, impl::VfsSource::CompressedPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadCompressedPakCold, 1 << 24);
+
+static void VirtualFileSystem_ReadCompressedPakWarm(State& state) {
+    impl::RunVfsRead<false>(state, impl::VfsSource::CompressedPak);
+}
+CRYSTAL_BENCHMARK(VirtualFileSystem_ReadCompressedPakWarm, 1 << 24);
+
+static void Compression_Encode(State& state) {
+    const auto input = impl::MakeAssetData(PakFormat::DEFAULT_BLOCK_SIZE, 1);
+    std::vector<std::byte> output(GetMaxCompressedSize(input.size()));
+
+    for (auto _ : state) {
+        if (CompressBlock(input, output) == 0) [[unlikely]] {
+            state.Fail("Block did not fit into the maximum compressed size");
+        }
+        ClobberMemory();
+    }
+
+    state.SetBytesPerIteration(input.size());
+}
+CRYSTAL_BENCHMARK(Compression_Encode);
+
+static void Compression_Decode(State& state) {
+    const auto input = impl::MakeAssetData(PakFormat::DEFAULT_BLOCK_SIZE, 1);
+    std::vector<std::byte> compressed(GetMaxCompressedSize(input.size()));
+    std::vector<std::byte> output(input.size());
+
+    compressed.resize(CompressBlock(input, compressed));
+
+    for (auto _ : state) {
+        if (!DecompressBlock(compressed, output)) [[unlikely]] {
+            state.Fail("Block could not be decompressed");
+        }
+        ClobberMemory();
+    }
+
+    if (output != input) {
+        state.Fail("Decompressed block does not match the input");
+    }
+
+    state.SetBytesPerIteration(input.size());
+}
+CRYSTAL_BENCHMARK(Compression_Decode);
+
+//Round trips through the codec, the archive and the virtual file system, including the cases that have to fail
+static void PakFile_RoundTrip(State& state) {
+    const auto directory      = std::filesystem::temp_directory_path() / "CrystalBench_PakRoundTrip";
+    const auto looseDirectory = (directory / "Loose").string();
+    const auto pakPath        = (directory / "Base.pak").string();
+    const auto patchPath      = (directory / "Patch.pak").string();
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    std::filesystem::create_directories(looseDirectory, error);
+
+    constexpr uint32_t BLOCK_SIZE = 4096;
+
+    std::vector<std::byte> noise(3 * BLOCK_SIZE + 123);
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+
+    for (auto& byte : noise) {
+        random = random * 6364136223846793005ull + 1442695040888963407ull;
+        byte   = static_cast<std::byte>(random >> 56);
+    }
+
+    const auto text      = impl::MakeAssetData(5 * BLOCK_SIZE + 17, 7);
+    const auto replaced  = impl::MakeAssetData(100, 8);
+    const auto patched   = impl::MakeAssetData(200, 9);
+    const auto loose     = impl::MakeAssetData(300, 10);
+    const auto looseOnly = impl::MakeAssetData(400, 11);
+
+    PakWriter writer(BLOCK_SIZE);
+    writer.AddFile("Models\\Scene.TXT", impl::MakeAssetData(50, 12));
+    writer.AddFile("./models/scene.txt", text);
+    writer.AddFile("/textures/noise.bin", noise);
+    writer.AddFile("materials/empty.json", {});
+    writer.AddFile("materials/replaced.json", replaced);
+    writer.AddFile("materials/overridden.json", replaced);
+
+    PakWriter patchWriter(BLOCK_SIZE);
+    patchWriter.AddFile("materials/replaced.json", patched);
+
+    PakWriterStatistics statistics;
+    ThreadPool threadPool;
+
+    if (!writer.Write(pakPath, &threadPool, &statistics) || !patchWriter.Write(patchPath) ||
+        !impl::WriteVfsFile(std::filesystem::path(looseDirectory) / "materials/overridden.json", loose) ||
+        !impl::WriteVfsFile(std::filesystem::path(looseDirectory) / "materials/loose.json", looseOnly))
+    {
+        state.Fail("Could not write the archives");
+        return;
+    }
+
+    std::vector<char> original(std::filesystem::file_size(pakPath, error));
+    std::ifstream(pakPath, std::ios::binary).read(original.data(), static_cast<std::streamsize>(original.size()));
+
+    for (auto _ : state) {
+        //Codec edge cases: empty and tiny blocks, runs that overlap their offset, data that does not shrink
+        for (const auto size : { size_t{ 0 }, size_t{ 1 }, size_t{ 11 }, size_t{ 13 }, size_t{ 70000 } }) {
+            std::vector<std::byte> input(size, std::byte{ 'a' });
+            std::vector<std::byte> compressed(GetMaxCompressedSize(size));
+            std::vector<std::byte> output(size);
+
+            compressed.resize(CompressBlock(input, compressed));
+
+            if (compressed.empty() || !DecompressBlock(compressed, output) || output != input) [[unlikely]] {
+                state.Fail(std::format("Run of {} bytes did not round trip", size));
+            }
+
+            if (size > 0 && DecompressBlock(std::span(compressed).first(compressed.size() - 1), output)) [[unlikely]] {
+                state.Fail(std::format("Truncated run of {} bytes was decompressed", size));
+            }
+        }
+
+        std::vector<std::byte> compressed(GetMaxCompressedSize(noise.size()));
+        std::vector<std::byte> output(noise.size());
+
+        if (CompressBlock(noise, std::span(compressed).first(noise.size() - 1)) != 0) [[unlikely]] {
+            state.Fail("Noise was compressed");
+        }
+
+        compressed.resize(CompressBlock(noise, compressed));
+
+        if (!DecompressBlock(compressed, output) || output != noise) [[unlikely]] {
+            state.Fail("Noise did not round trip");
+        }
+
+        //Corrupt input has to fail or decode into the output, never read or write past it
+        for (size_t i = 0; i < compressed.size(); i += 97) {
+            auto corrupted = compressed;
+            corrupted[i] ^= std::byte{ 0x5A };
+            DoNotOptimize(DecompressBlock(corrupted, output));
+        }
+
+        const auto pak = PakFile::Open(pakPath);
+
+        if (!pak || pak->GetEntries().size() != 5 || statistics.NumEntries != 5) [[unlikely]] {
+            state.Fail("Archive could not be opened");
+            return;
+        }
+
+        const auto read = [&](const PakFile& pakFile, std::string_view path) -> std::optional<std::vector<std::byte>> {
+            const auto* entry = pakFile.Find(NormalizePakPath(path));
+
+            if (!entry) {
+                return {};
+            }
+
+            if (!PakFile::IsCompressed(*entry)) {
+                const auto data = pakFile.GetData(*entry);
+                return std::vector(data.begin(), data.end());
+            }
+
+            std::vector<std::byte> data(entry->Size);
+
+            if (!pakFile.Decompress(*entry, data, &threadPool)) {
+                return {};
+            }
+            return data;
+        };
+
+        const auto* textEntry  = pak->Find("models/scene.txt");
+        const auto* noiseEntry = pak->Find("textures/noise.bin");
+
+        if (!textEntry || textEntry->NumBlocks != 6 || !noiseEntry || PakFile::IsCompressed(*noiseEntry)) [[unlikely]] {
+            state.Fail("Entries are not compressed as expected");
+        }
+
+        if (read(*pak, "MODELS/Scene.txt") != text || read(*pak, "textures\\noise.bin") != noise ||
+            read(*pak, "materials/empty.json") != std::vector<std::byte>{} || pak->Find("models/missing.txt"))
+        {
+            state.Fail("Archive entries do not match what was written");
+        }
+
+        //Later mounts win over earlier ones, loose files only win when overrides are on
+        for (const bool looseOverrides : { true, false }) {
+            VirtualFileSystem vfs(looseDirectory, looseOverrides, &threadPool);
+
+            if (!vfs.Mount(pakPath) || !vfs.Mount(patchPath)) [[unlikely]] {
+                state.Fail("Archives were not mounted as expected");
+                return;
+            }
+
+            const auto overridden  = vfs.Open("materials/overridden.json");
+            const auto patchedFile = vfs.Open("Materials/Replaced.json");
+            const auto looseFile   = vfs.Open("materials/loose.json");
+            const auto textFile    = vfs.Open("models/scene.txt");
+
+            const bool isValid =
+                overridden && std::ranges::equal(overridden->GetData(), looseOverrides ? loose : replaced) &&
+                overridden->GetSource() == (looseOverrides ? VirtualFileSource::Loose : VirtualFileSource::Archive) &&
+                patchedFile && std::ranges::equal(patchedFile->GetData(), patched) &&
+                looseFile && std::ranges::equal(looseFile->GetData(), looseOnly) &&
+                vfs.Exists("textures/noise.bin") && !vfs.Exists("textures/missing.bin");
+
+            if (!isValid) [[unlikely]] {
+                state.Fail(std::format("Files resolved wrongly with loose overrides {}", looseOverrides ? "on" : "off"));
+            }
+
+            //Opened files keep their archive alive
+            if (!vfs.Unmount(pakPath) || !vfs.Unmount(patchPath) || vfs.Open("models/scene.txt") || !textFile || !std::ranges::equal(textFile->GetData(), text)) [[unlikely]] {
+                state.Fail("Unmounting did not behave as expected");
+            }
+        }
+
+        //Magic, version and the size of the compressed entry have to be rejected, also a size close to 2^64
+        const auto textEntryOffset = pak->GetHeader().EntryTableOffset + static_cast<size_t>(textEntry - pak->GetEntries().data()) * sizeof(PakEntry);
+        const std::array<size_t, 4> CORRUPTED_BYTES{ 0, 4, textEntryOffset + offsetof(PakEntry, Size) + 2, textEntryOffset + offsetof(PakEntry, Size) + 7 };
+
+        for (const auto offset : CORRUPTED_BYTES) {
+            auto corrupted = original;
+            corrupted[offset] ^= 0x40;
+
+            std::ofstream(pakPath, std::ios::binary | std::ios::trunc).write(corrupted.data(), static_cast<std::streamsize>(corrupted.size()));
+
+            if (PakFile::Open(pakPath)) [[unlikely]] {
+                state.Fail(std::format("Corrupted byte {} was not detected", offset));
+            }
+        }
+
+        std::ofstream(pakPath, std::ios::binary | std::ios::trunc).write(original.data(), static_cast<std::streamsize>(original.size() - 1));
+
+        if (PakFile::Open(pakPath)) [[unlikely]] {
+            state.Fail("Truncated archive was not detected");
+        }
+
+        std::ofstream(pakPath, std::ios::binary | std::ios::trunc).write(original.data(), static_cast<std::streamsize>(original.size()));
+    }
+
+    std::filesystem::remove_all(directory, error);
+}
+CRYSTAL_BENCHMARK(PakFile_RoundTrip);
@@ -0,0 +1,216 @@
+#include "../Benchmark.h"
+
+#include "Core/Math/Common.h"
+#include "Core/Math/Packing.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <numbers>
+#include <vector>
+
+using namespace Crystal;
+using namespace Crystal::Math;
+using namespace Crystal::Bench;
+
+namespace impl {
+    constexpr size_t NUM_VECTORS = 1024;
+
+    std::array<Vector3, NUM_VECTORS> CreateVectors() noexcept {
+        std::array<Vector3, NUM_VECTORS> vectors;
+
+        for (size_t i = 0; i < vectors.size(); i++) {
+            const auto f = static_cast<float>(i);
+            vectors[i]   = Vector3(f * 0.25f + 1.0f, f * -0.5f, f * 0.125f + 2.0f);
+        }
+        return vectors;
+    }
+
+    //Exact cases of the half conversion: rounding to nearest even, the largest half, overflow and denormals
+    static_assert(FloatToHalf(1.0f) == 0x3C00 && FloatToHalf(-2.0f) == 0xC000 && FloatToHalf(65504.0f) == 0x7BFF);
+    static_assert(FloatToHalf(1.0f + 0x1p-11f) == 0x3C00 && FloatToHalf(1.0f + 0x3p-11f) == 0x3C02);
+    static_assert(FloatToHalf(65519.0f) == 0x7BFF && FloatToHalf(65520.0f) == 0x7C00 && FloatToHalf(1e10f) == 0x7C00);
+    static_assert(FloatToHalf(0x1p-24f) == 0x0001 && FloatToHalf(0x1p-25f) == 0x0000 && FloatToHalf(0x3p-26f) == 0x0001);
+    static_assert(FloatToHalf(0x1p-14f) == 0x0400 && FloatToHalf(0x1.ff8p-15f) == 0x03FF && HalfToFloat(0x03FF) == 0x1.ff8p-15f);
+    static_assert(PackSnorm16(1.0f) == 32767 && PackSnorm16(-1.0f) == -32767 && UnpackSnorm16(-32768) == -1.0f);
+    static_assert(PackUnorm16(1.0f) == 65535 && PackUnorm16(-0.5f) == 0 && PackUnorm16(0.5f) == 32768);
+
+    //Snorm16 steps are 2^-15, decoded directions and frames have to be within a few of them
+    constexpr float MAX_OCTAHEDRAL_ERROR    = 5e-5f;
+    constexpr float MAX_TANGENT_FRAME_ERROR = 2e-4f;
+
+    constexpr size_t NUM_DIRECTIONS = 4096;
+
+    //Fibonacci sphere with the axes added, they sit on the folds and corners of the octahedron
+    std::vector<Vector3> CreateDirections() {
+        std::vector<Vector3> directions{
+            { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+            { 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }
+        };
+
+        const auto goldenAngle = std::numbers::pi_v<float> * (3.0f - std::sqrt(5.0f));
+
+        for (size_t i = 0; i < NUM_DIRECTIONS; i++) {
+            const auto z      = 1.0f - 2.0f * (static_cast<float>(i) + 0.5f) / NUM_DIRECTIONS;
+            const auto radius = std::sqrt(1.0f - z * z);
+            const auto angle  = goldenAngle * static_cast<float>(i);
+
+            directions.emplace_back(radius * std::cos(angle), radius * std::sin(angle), z);
+        }
+        return directions;
+    }
+
+    [[nodiscard]] float GetDistance(const Vector3& lhs, const Vector3& rhs) noexcept {
+        const auto difference = lhs - rhs;
+        return std::sqrt(Vector3::Dot(difference, difference));
+    }
+}
+
+static void Vector3_DotCross(State& state) {
+    const auto vectors = impl::CreateVectors();
+
+    for (auto _ : state) {
+        Vector3 accumulated;
+
+        for (size_t i = 0; i + 1 < vectors.size(); i++) {
+            const auto cross = Vector3::Cross(vectors[i], vectors[i + 1]);
+            accumulated      = accumulated + cross * Vector3::Dot(vectors[i], vectors[i + 1]);
+        }
+        DoNotOptimize(accumulated);
+    }
+    state.SetItemsPerIteration(vectors.size() - 1);
+}
+CRYSTAL_BENCHMARK(Vector3_DotCross);
+
+static void Vector3_Normalize(State& state) {
+    auto vectors = impl::CreateVectors();
+
+    for (auto _ : state) {
+        for (auto& vector : vectors) {
+            DoNotOptimize(vector.Normalized());
+        }
+        ClobberMemory();
+    }
+    state.SetItemsPerIteration(vectors.size());
+}
+CRYSTAL_BENCHMARK(Vector3_Normalize);
+
+static void Matrix_Multiply(State& state) {
+    const auto rotation    = Matrix::CreateRotation(Quaternion::FromPitchYawRoll(0.3f, 0.7f, 0.1f));
+    const auto translation = Matrix::CreateTranslation(Vector3(1.0f, 2.0f, 3.0f));
+    const auto scale       = Matrix::CreateScale(2.0f);
+
+    for (auto _ : state) {
+        auto world = scale * rotation * translation;
+        DoNotOptimize(world);
+    }
+    state.SetItemsPerIteration(2);
+}
+CRYSTAL_BENCHMARK(Matrix_Multiply);
+
+static void Matrix_Inverse(State& state) {
+    auto view = Matrix::CreateLookAtLH(Vector3(0.0f, 2.0f, -5.0f), Vector3(0.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f));
+
+    for (auto _ : state) {
+        //Hide the input from the optimizer, the inverse would be hoisted out of the loop otherwise
+        DoNotOptimize(view);
+        auto inverse = Matrix::Inverse(view);
+        DoNotOptimize(inverse);
+    }
+}
+CRYSTAL_BENCHMARK(Matrix_Inverse);
+
+static void Matrix_TransformPoints(State& state) {
+    const auto vectors = impl::CreateVectors();
+    const auto world   = Matrix::CreateRotation(Quaternion::FromAngleAxis(0.5f, Vector3(0.0f, 1.0f, 0.0f))) * Matrix::CreateTranslation(Vector3(4.0f, 0.0f, 1.0f));
+
+    for (auto _ : state) {
+        for (const auto& vector : vectors) {
+            DoNotOptimize(world * vector);
+        }
+    }
+    state.SetItemsPerIteration(vectors.size());
+}
+CRYSTAL_BENCHMARK(Matrix_TransformPoints);
+
+static void Quaternion_FromPitchYawRoll(State& state) {
+    float angle = 0.0f;
+
+    for (auto _ : state) {
+        auto rotation = Quaternion::FromPitchYawRoll(angle, angle * 0.5f, angle * 0.25f);
+        DoNotOptimize(rotation);
+        angle += 0.001f;
+    }
+}
+CRYSTAL_BENCHMARK(Quaternion_FromPitchYawRoll);
+
+static void Packing_Quality(State& state) {
+    const auto directions = impl::CreateDirections();
+
+    for (auto _ : state) {
+        //Every finite half survives the round trip through float
+        for (uint32_t half = 0; half <= 0xFFFF; half++) {
+            const auto bits = static_cast<uint16_t>(half);
+
+            if ((bits & 0x7C00) == 0x7C00 && (bits & 0x3FF) != 0) {
+                continue;
+            }
+
+            if (FloatToHalf(HalfToFloat(bits)) != bits) {
+                state.Fail(std::format("Half {:#06x} does not survive the round trip", half));
+                break;
+            }
+        }
+
+        float maxOctahedralError = 0.0f, maxFrameError = 0.0f;
+
+        for (size_t i = 0; i < directions.size(); i++) {
+            const auto& normal = directions[i];
+
+            maxOctahedralError = std::max(maxOctahedralError, impl::GetDistance(UnpackOctahedral(PackOctahedral(normal)), normal));
+
+            //Frames with either handedness, the tangent is taken from another direction of the set
+            const auto tangent   = OrthogonalizeTangent(normal, directions[(i * 7 + 3) % directions.size()]);
+            const auto bitangent = Vector3::Cross(normal, tangent) * (i % 2 == 0 ? 1.0f : -1.0f);
+            const auto frame     = UnpackTangentFrame(PackTangentFrame(normal, tangent, bitangent));
+
+            maxFrameError = std::max({
+                maxFrameError,
+                impl::GetDistance(frame.Normal, normal),
+                impl::GetDistance(frame.Tangent, tangent),
+                impl::GetDistance(frame.Bitangent, bitangent)
+            });
+        }
+
+        if (maxOctahedralError > impl::MAX_OCTAHEDRAL_ERROR) {
+            state.Fail(std::format("Octahedral directions are off by up to {:.2e}", maxOctahedralError));
+        }
+
+        if (maxFrameError > impl::MAX_TANGENT_FRAME_ERROR) {
+            state.Fail(std::format("Tangent frames are off by up to {:.2e}", maxFrameError));
+        }
+
+        //Without a tangent the frame still has to be orthonormal around the normal
+        const Vector3 up(0.0f, 1.0f, 0.0f);
+        const auto madeUp = UnpackTangentFrame(PackTangentFrame(up, Vector3(0.0f), Vector3(0.0f)));
+
+        if (std::abs(Vector3::Dot(madeUp.Normal, madeUp.Tangent)) > impl::MAX_TANGENT_FRAME_ERROR || impl::GetDistance(madeUp.Normal, up) > impl::MAX_TANGENT_FRAME_ERROR) {
+            state.Fail("Tangent frames without a tangent are not orthonormal");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(Packing_Quality);
+
+static void Packing_TangentFrame(State& state) {
+    const auto directions = impl::CreateDirections();
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < directions.size(); i++) {
+            DoNotOptimize(PackTangentFrame(directions[i], directions[(i * 7 + 3) % directions.size()], directions[(i * 13 + 5) % directions.size()]));
+        }
+    }
+    state.SetItemsPerIteration(directions.size());
+}
+CRYSTAL_BENCHMARK(Packing_TangentFrame);
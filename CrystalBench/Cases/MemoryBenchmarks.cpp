@@ -0,0 +1,789 @@
+#include "../Benchmark.h"
+
+#include "Core/Memory/BitmapRangeAllocator.h"
+#include "Core/Memory/FrameArena.h"
+#include "Core/Memory/GenerationalIndexAllocator.h"
+#include "Core/Memory/MemoryTracker.h"
+#include "Core/Memory/ResidencyManager.h"
+#include "Core/Memory/RingAllocator.h"
+#include "Core/Memory/SlabAllocator.h"
+#include "Core/Memory/TlsfAllocator.h"
+#include "Core/Time/FrameStatistics.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    //Roughly the size of a component with a transform
+    struct PooledObject {
+        float Position[4]{};
+        float Rotation[4]{};
+        float Scale[4]{ 1.0f, 1.0f, 1.0f, 1.0f };
+        uint64_t Flags{};
+    };
+
+    template<class Pointer>
+    Pointer Create(uint64_t value) {
+        if constexpr (std::is_same_v<Pointer, PoolPtr<PooledObject>>) {
+            auto object   = MakePooled<PooledObject>();
+            object->Flags = value;
+            return object;
+        }
+        else {
+            auto object   = std::make_unique<PooledObject>();
+            object->Flags = value;
+            return object;
+        }
+    }
+
+    //Creates and destroys objects in a shuffled order, as entities coming and going during gameplay do
+    template<class Pointer>
+    void Churn(State& state) {
+        constexpr size_t NUM_OBJECTS = 4096;
+
+        std::vector<Pointer> objects(NUM_OBJECTS);
+        uint64_t random = 0x9E3779B97F4A7C15ull;
+
+        for (auto _ : state) {
+            for (size_t i = 0; i < NUM_OBJECTS; i++) {
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+
+                auto& slot = objects[random % NUM_OBJECTS];
+                slot       = Create<Pointer>(i);
+            }
+            DoNotOptimize(objects.data());
+        }
+        state.SetItemsPerIteration(NUM_OBJECTS);
+    }
+
+    [[nodiscard]] uint64_t NextRandom(uint64_t& state) noexcept {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    //The free lists the descriptor heap pages used before, blocks by offset and by size, merged on free
+    class MapRangeAllocator {
+    public:
+        explicit MapRangeAllocator(uint32_t capacity) { AddBlock(0, capacity); }
+
+        std::optional<uint32_t> Allocate(uint32_t count) {
+            const auto bySize = m_bySize.lower_bound(count);
+
+            if (bySize == m_bySize.end()) {
+                return {};
+            }
+
+            const auto [size, byOffset] = *bySize;
+            const auto offset           = byOffset->first;
+
+            m_bySize.erase(bySize);
+            m_byOffset.erase(byOffset);
+
+            if (size > count) {
+                AddBlock(offset + count, size - count);
+            }
+            return offset;
+        }
+
+        void Free(uint32_t offset, uint32_t count) {
+            auto next = m_byOffset.upper_bound(offset);
+
+            if (next != m_byOffset.begin()) {
+                if (auto previous = std::prev(next); previous->first + previous->second.Size == offset) {
+                    offset  = previous->first;
+                    count  += previous->second.Size;
+
+                    m_bySize.erase(previous->second.SizeEntry);
+                    m_byOffset.erase(previous);
+                }
+            }
+
+            if (next != m_byOffset.end() && offset + count == next->first) {
+                count += next->second.Size;
+
+                m_bySize.erase(next->second.SizeEntry);
+                m_byOffset.erase(next);
+            }
+            AddBlock(offset, count);
+        }
+    private:
+        struct Block;
+        using ByOffset = std::map<uint32_t, Block>;
+        using BySize   = std::multimap<uint32_t, ByOffset::iterator>;
+
+        struct Block {
+            uint32_t Size;
+            BySize::iterator SizeEntry;
+        };
+
+        void AddBlock(uint32_t offset, uint32_t count) {
+            const auto byOffset     = m_byOffset.emplace(offset, Block{ count, {} }).first;
+            byOffset->second.SizeEntry = m_bySize.emplace(count, byOffset);
+        }
+
+        ByOffset m_byOffset;
+        BySize m_bySize;
+    };
+
+    //Mostly single views with the occasional descriptor table, freed in random order
+    template<class Allocator>
+    void DescriptorChurn(State& state) {
+        constexpr uint32_t CAPACITY  = 4096;
+        constexpr size_t NUM_SLOTS   = 1024;
+
+        Allocator allocator(CAPACITY);
+        std::vector<std::pair<std::optional<uint32_t>, uint32_t>> slots(NUM_SLOTS);
+        uint64_t random = 0x9E3779B97F4A7C15ull;
+
+        for (auto _ : state) {
+            for (size_t i = 0; i < NUM_SLOTS; i++) {
+                auto& [offset, count] = slots[NextRandom(random) % NUM_SLOTS];
+
+                if (offset) {
+                    allocator.Free(*offset, count);
+                    offset.reset();
+                }
+                else {
+                    count  = NextRandom(random) % 8 == 0 ? 8 : 1;
+                    offset = allocator.Allocate(count);
+                }
+            }
+        }
+        state.SetItemsPerIteration(NUM_SLOTS);
+    }
+
+    //Sums over objects that were created in between unrelated allocations of varying size
+    template<class Pointer>
+    void Iterate(State& state) {
+        constexpr size_t NUM_OBJECTS = 16384;
+
+        std::vector<Pointer> objects;
+        std::vector<std::unique_ptr<std::byte[]>> unrelated;
+
+        objects.reserve(NUM_OBJECTS);
+        unrelated.reserve(NUM_OBJECTS);
+
+        for (size_t i = 0; i < NUM_OBJECTS; i++) {
+            objects.emplace_back(Create<Pointer>(i));
+            unrelated.emplace_back(std::make_unique<std::byte[]>(16 + (i * 37) % 200));
+        }
+
+        for (auto _ : state) {
+            uint64_t sum = 0;
+
+            for (const auto& object : objects) {
+                sum += object->Flags;
+            }
+            DoNotOptimize(sum);
+        }
+        state.SetItemsPerIteration(NUM_OBJECTS);
+    }
+}
+
+//The bookkeeping every tracked allocation pays for when CRYSTAL_MEMORY_TRACKING is enabled
+static void MemoryTracker_AllocationBookkeeping(State& state) {
+    auto& tracker = MemoryTracker::Get();
+
+    const void* callSite = reinterpret_cast<const void*>(&MemoryTracker_AllocationBookkeeping);
+    size_t size          = 16;
+
+    for (auto _ : state) {
+        const auto slot = tracker.OnAllocation(size, MemoryTag::Scene, callSite);
+        tracker.OnDeallocation(size, MemoryTag::Scene, slot);
+
+        size = size < 4096 ? size * 2 : 16;
+    }
+
+    tracker.OnFrameEnd();
+}
+CRYSTAL_BENCHMARK(MemoryTracker_AllocationBookkeeping);
+
+static void MemoryTracker_ScopedTag(State& state) {
+    for (auto _ : state) {
+        ScopedMemoryTag tag(MemoryTag::Textures);
+        DoNotOptimize(ScopedMemoryTag::Current());
+    }
+}
+CRYSTAL_BENCHMARK(MemoryTracker_ScopedTag);
+
+static void FrameTimeHistogram_Record(State& state) {
+    auto histogram = std::make_unique<FrameTimeHistogram>();
+    uint64_t value = 1;
+
+    for (auto _ : state) {
+        histogram->Record(value);
+
+        //Cheap xorshift so the values spread over many buckets
+        value ^= value << 13;
+        value ^= value >> 7;
+        value ^= value << 17;
+        value &= 0xFFFFF;
+        value |= 1;
+    }
+    DoNotOptimize(histogram->Percentile(99.0));
+}
+CRYSTAL_BENCHMARK(FrameTimeHistogram_Record);
+
+static void FrameTimeHistogram_Percentile(State& state) {
+    auto histogram = std::make_unique<FrameTimeHistogram>();
+
+    for (uint64_t i = 1; i < 100'000; i++) {
+        histogram->Record(i * 7 % 50'000);
+    }
+
+    for (auto _ : state) {
+        DoNotOptimize(histogram->Percentile(50.0));
+        DoNotOptimize(histogram->Percentile(99.0));
+    }
+    state.SetItemsPerIteration(2);
+}
+CRYSTAL_BENCHMARK(FrameTimeHistogram_Percentile);
+
+//General purpose heap baseline the engine's own allocators are measured against
+static void Heap_AllocateFree(State& state) {
+    const auto size = static_cast<size_t>(state.Argument());
+    std::array<void*, 64> blocks{};
+
+    for (auto _ : state) {
+        for (auto& block : blocks) {
+            block = ::operator new(size);
+            DoNotOptimize(block);
+        }
+        for (auto block : blocks) {
+            ::operator delete(block);
+        }
+    }
+    state.SetItemsPerIteration(blocks.size());
+}
+CRYSTAL_BENCHMARK(Heap_AllocateFree, 16, 256, 4096);
+
+static void FrameArena_Allocate(State& state) {
+    const auto size = static_cast<size_t>(state.Argument());
+    FrameArena arena;
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < 64; i++) {
+            DoNotOptimize(arena.Allocate(size, 16));
+        }
+        arena.Reset();
+    }
+    state.SetItemsPerIteration(64);
+}
+CRYSTAL_BENCHMARK(FrameArena_Allocate, 16, 256, 4096);
+
+//The containers of a frame as the renderer builds them, on the global heap and on the frame arena
+template<class Vector>
+static void SimulateFrame(Vector& barriers, Vector& commandLists) {
+    for (uint64_t i = 0; i < 48; i++) {
+        barriers.push_back(i);
+    }
+    for (uint64_t i = 0; i < 4; i++) {
+        commandLists.push_back(i);
+    }
+    DoNotOptimize(barriers.data());
+    DoNotOptimize(commandLists.data());
+}
+
+static void FrameContainers_Heap(State& state) {
+    for (auto _ : state) {
+        std::vector<uint64_t> barriers;
+        std::vector<uint64_t> commandLists;
+
+        SimulateFrame(barriers, commandLists);
+    }
+}
+CRYSTAL_BENCHMARK(FrameContainers_Heap);
+
+static void FrameContainers_FrameArena(State& state) {
+    auto& arena = FrameArena::ForCurrentThread();
+
+    //Warm up once so the arena has settled on its final block before the steady state is checked
+    {
+        ScopedArenaMarker scratch(arena);
+        FrameVector<uint64_t> barriers(scratch.GetResource());
+        FrameVector<uint64_t> commandLists(scratch.GetResource());
+
+        SimulateFrame(barriers, commandLists);
+    }
+    const auto blockAllocations = arena.GetBlockAllocationCount();
+
+    for (auto _ : state) {
+        ScopedArenaMarker scratch(arena);
+        FrameVector<uint64_t> barriers(scratch.GetResource());
+        FrameVector<uint64_t> commandLists(scratch.GetResource());
+
+        SimulateFrame(barriers, commandLists);
+    }
+
+    if (arena.GetBlockAllocationCount() != blockAllocations) {
+        state.Fail("Frame arena allocated from the heap in steady state");
+    }
+}
+CRYSTAL_BENCHMARK(FrameContainers_FrameArena);
+
+//Overflowing frames have to settle on a single block after one reset
+static void FrameArena_OverflowCoalescing(State& state) {
+    FrameArena arena(FrameArena::DEFAULT_BLOCK_SIZE);
+
+    const auto allocateFrame = [&arena] {
+        for (size_t i = 0; i < 16; i++) {
+            DoNotOptimize(arena.Allocate(64 * 1024));
+        }
+        arena.Reset();
+    };
+
+    allocateFrame();
+    const auto blockAllocations = arena.GetBlockAllocationCount();
+
+    for (auto _ : state) {
+        allocateFrame();
+    }
+
+    if (arena.GetBlockAllocationCount() != blockAllocations) {
+        state.Fail("Overflow blocks were not coalesced");
+    }
+    state.SetItemsPerIteration(16);
+}
+CRYSTAL_BENCHMARK(FrameArena_OverflowCoalescing);
+
+static void ObjectChurn_MakeUnique(State& state) {
+    impl::Churn<std::unique_ptr<impl::PooledObject>>(state);
+}
+CRYSTAL_BENCHMARK(ObjectChurn_MakeUnique);
+
+static void ObjectChurn_MakePooled(State& state) {
+    impl::Churn<PoolPtr<impl::PooledObject>>(state);
+}
+CRYSTAL_BENCHMARK(ObjectChurn_MakePooled);
+
+static void ObjectIteration_MakeUnique(State& state) {
+    impl::Iterate<std::unique_ptr<impl::PooledObject>>(state);
+}
+CRYSTAL_BENCHMARK(ObjectIteration_MakeUnique);
+
+static void ObjectIteration_MakePooled(State& state) {
+    impl::Iterate<PoolPtr<impl::PooledObject>>(state);
+}
+CRYSTAL_BENCHMARK(ObjectIteration_MakePooled);
+
+//Blocks freed on one thread have to be reusable by another one
+static void SlabAllocator_CrossThreadFree(State& state) {
+    constexpr size_t NUM_OBJECTS = 1024;
+    std::vector<PoolPtr<impl::PooledObject>> objects(NUM_OBJECTS);
+
+    for (auto _ : state) {
+        for (auto& object : objects) {
+            object = MakePooled<impl::PooledObject>();
+        }
+
+        std::jthread consumer([&objects] {
+            for (auto& object : objects) {
+                object.reset();
+            }
+        });
+    }
+
+    const auto sizeClass  = SlabAllocator::GetSizeClass(sizeof(impl::PooledObject));
+    const auto statistics = SlabAllocator::Get().GetStatistics()[sizeClass];
+
+    //Everything freed by the consumer threads has to be back on the shared list once they exited
+    if (statistics.BlocksOutstanding > 2 * SlabAllocator::BATCH_SIZE + NUM_OBJECTS) {
+        state.Fail("Blocks freed on other threads were not returned");
+    }
+    state.SetItemsPerIteration(NUM_OBJECTS);
+}
+CRYSTAL_BENCHMARK(SlabAllocator_CrossThreadFree);
+
+//Resource sized ranges coming and going in a 64MB heap, as textures and buffers do while streaming
+static void TlsfAllocator_Churn(State& state) {
+    constexpr size_t NUM_SLOTS = 512;
+    const auto alignment       = static_cast<uint64_t>(state.Argument());
+
+    TlsfAllocator allocator(_64MB, KB(4));
+    std::vector<std::optional<TlsfAllocation>> slots(NUM_SLOTS);
+    uint64_t random = 0x9E3779B97F4A7C15ull;
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < NUM_SLOTS; i++) {
+            auto& slot = slots[impl::NextRandom(random) % NUM_SLOTS];
+
+            if (slot) {
+                allocator.Free(*slot);
+                slot.reset();
+            }
+            else {
+                //4KB to 256KB, most of them small
+                const auto size = KB(4) << (impl::NextRandom(random) % 7);
+                slot            = allocator.Allocate(size, alignment);
+            }
+        }
+    }
+
+    if (!allocator.Validate()) {
+        state.Fail("Allocator invariants do not hold after churn");
+    }
+    state.SetItemsPerIteration(NUM_SLOTS);
+}
+CRYSTAL_BENCHMARK(TlsfAllocator_Churn, 4096, 65536);
+
+//Freeing every other allocation has to show up in the statistics, freeing the rest has to merge everything again
+static void TlsfAllocator_FragmentationStatistics(State& state) {
+    constexpr uint64_t BLOCK_SIZE = _64KB;
+    constexpr uint64_t CAPACITY   = _16MB;
+
+    TlsfAllocator allocator(CAPACITY, KB(4));
+    std::vector<TlsfAllocation> allocations;
+
+    for (auto _ : state) {
+        allocations.clear();
+
+        while (const auto allocation = allocator.Allocate(BLOCK_SIZE)) {
+            allocations.push_back(*allocation);
+        }
+
+        for (size_t i = 0; i < allocations.size(); i += 2) {
+            allocator.Free(allocations[i]);
+        }
+
+        const auto fragmented = allocator.GetStatistics();
+        const auto hints      = allocator.GetDefragmentationHints(4);
+
+        if (fragmented.LargestFreeBlock != BLOCK_SIZE || fragmented.FreeBytes != CAPACITY / 2 || hints.size() != 4) {
+            state.Fail("Fragmentation statistics do not match the allocation pattern");
+        }
+
+        for (size_t i = 1; i < allocations.size(); i += 2) {
+            allocator.Free(allocations[i]);
+        }
+
+        const auto merged = allocator.GetStatistics();
+
+        if (merged.FreeBlocks != 1 || merged.Fragmentation() != 0.0 || !allocator.Validate()) {
+            state.Fail("Free blocks were not merged");
+        }
+    }
+    state.SetItemsPerIteration(CAPACITY / BLOCK_SIZE);
+}
+CRYSTAL_BENCHMARK(TlsfAllocator_FragmentationStatistics);
+
+//Constant buffer sized uploads with the GPU trailing a number of frames behind, the fence is just a frame counter
+static void RingAllocator_FramesInFlight(State& state) {
+    constexpr uint64_t UPLOADS_PER_FRAME = 256;
+    constexpr uint64_t UPLOAD_SIZE       = 320;
+    const auto framesInFlight            = static_cast<uint64_t>(state.Argument());
+
+    //Room for exactly the frames in flight plus the one being recorded, including the worst case alignment padding
+    RingAllocator ring((framesInFlight + 1) * UPLOADS_PER_FRAME * 512);
+
+    uint64_t frame     = 0;
+    uint64_t failures  = 0;
+    uint64_t highWater = 0;
+
+    for (auto _ : state) {
+        for (uint64_t i = 0; i < UPLOADS_PER_FRAME; i++) {
+            const auto offset = ring.Allocate(UPLOAD_SIZE, 256);
+
+            failures += !offset;
+            DoNotOptimize(offset);
+        }
+
+        ring.Submit(++frame);
+        highWater = std::max(highWater, ring.GetUsedBytes());
+
+        if (frame > framesInFlight) {
+            ring.Retire(frame - framesInFlight);
+        }
+    }
+
+    if (failures > 0) {
+        state.Fail("Ring ran out of space although retired frames should have made room");
+    }
+
+    if (ring.GetSubmissionsInFlight() > framesInFlight || highWater > ring.GetCapacity()) {
+        state.Fail("Submissions were not retired by their fence values");
+    }
+    state.SetItemsPerIteration(UPLOADS_PER_FRAME);
+}
+CRYSTAL_BENCHMARK(RingAllocator_FramesInFlight, 2, 3, 8);
+
+static void DescriptorChurn_MapFreeList(State& state) {
+    impl::DescriptorChurn<impl::MapRangeAllocator>(state);
+}
+CRYSTAL_BENCHMARK(DescriptorChurn_MapFreeList);
+
+static void DescriptorChurn_Bitmap(State& state) {
+    impl::DescriptorChurn<BitmapRangeAllocator>(state);
+}
+CRYSTAL_BENCHMARK(DescriptorChurn_Bitmap);
+
+//Random allocations, immediate and fenced frees checked against a plain array of slot states
+static void BitmapRangeAllocator_Fuzz(State& state) {
+    constexpr uint32_t CAPACITY = 1000;
+
+    struct Range {
+        uint32_t Offset;
+        uint32_t Count;
+        uint64_t FenceValue;
+    };
+
+    BitmapRangeAllocator allocator(CAPACITY);
+    std::vector<bool> used(CAPACITY, false);
+    std::vector<Range> live;
+    std::deque<Range> deferred;
+    uint64_t random = 0x2545F4914F6CDD1Dull;
+    uint64_t fence  = 0;
+
+    for (auto _ : state) {
+        for (uint32_t step = 0; step < 256 && !state.Failed(); step++) {
+            const auto operation = impl::NextRandom(random) % 8;
+
+            if (operation < 4 || live.empty()) {
+                const auto count = static_cast<uint32_t>(1 + impl::NextRandom(random) % 100);
+
+                if (const auto offset = allocator.Allocate(count)) {
+                    for (uint32_t i = *offset; i < *offset + count; i++) {
+                        if (i >= CAPACITY || used[i]) {
+                            state.Fail("Allocated a slot that is out of bounds, in use or not yet released");
+                            break;
+                        }
+                        used[i] = true;
+                    }
+                    live.push_back({ .Offset = *offset, .Count = count, .FenceValue = 0 });
+                }
+            }
+            else {
+                const auto index = impl::NextRandom(random) % live.size();
+                auto range       = live[index];
+
+                live[index] = live.back();
+                live.pop_back();
+
+                if (operation < 6) {
+                    allocator.Free(range.Offset, range.Count);
+                    std::fill_n(used.begin() + range.Offset, range.Count, false);
+                }
+                else {
+                    //Slots stay in use until the fence after the next one has been reached
+                    range.FenceValue = fence + 2;
+                    allocator.FreeDeferred(range.Offset, range.Count, range.FenceValue);
+                    deferred.push_back(range);
+                }
+            }
+
+            if (impl::NextRandom(random) % 16 == 0) {
+                allocator.ReleaseCompleted(++fence);
+
+                while (!deferred.empty() && deferred.front().FenceValue <= fence) {
+                    std::fill_n(used.begin() + deferred.front().Offset, deferred.front().Count, false);
+                    deferred.pop_front();
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < CAPACITY && !state.Failed(); i++) {
+            if (used[i] == allocator.IsFree(i)) {
+                state.Fail("Slot state does not match the reference");
+            }
+        }
+
+        if (!allocator.Validate()) {
+            state.Fail("Bitmap summary or free count is inconsistent");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(BitmapRangeAllocator_Fuzz);
+
+//Textures streaming in and out of the bindless table, one fence per frame with three frames in flight
+static void GenerationalIndexAllocator_RegisterChurn(State& state) {
+    constexpr uint32_t CAPACITY         = 1 << 16;
+    constexpr size_t NUM_HANDLES        = 4096;
+    constexpr size_t CHANGES_PER_FRAME  = 256;
+    constexpr uint64_t FRAMES_IN_FLIGHT = 3;
+
+    GenerationalIndexAllocator allocator(CAPACITY);
+    std::vector<GenerationalIndex> handles(NUM_HANDLES);
+    uint64_t random = 0xD1B54A32D192ED03ull;
+    uint64_t frame  = 0;
+
+    for (auto _ : state) {
+        frame++;
+
+        for (size_t i = 0; i < CHANGES_PER_FRAME; i++) {
+            auto& handle = handles[impl::NextRandom(random) % NUM_HANDLES];
+
+            if (handle.IsValid()) {
+                const auto stale = handle;
+
+                allocator.Free(handle, frame);
+                handle = {};
+
+                if (allocator.IsAlive(stale) || allocator.Free(stale, frame)) [[unlikely]] {
+                    state.Fail("Handle is still alive after it was freed");
+                }
+            }
+            else if (const auto index = allocator.Allocate()) {
+                handle = *index;
+            }
+        }
+
+        if (frame > FRAMES_IN_FLIGHT) {
+            allocator.ReleaseCompleted(frame - FRAMES_IN_FLIGHT);
+        }
+
+        DoNotOptimize(handles.data());
+    }
+
+    if (allocator.GetLiveCount() + allocator.GetPendingCount() > CAPACITY) {
+        state.Fail("More indices are in use than the allocator holds");
+    }
+    state.SetItemsPerIteration(CHANGES_PER_FRAME);
+}
+CRYSTAL_BENCHMARK(GenerationalIndexAllocator_RegisterChurn);
+
+//A camera sweeping over a large texture set: visible textures are referenced and touched, every eighth texture is held by
+//something off screen and can only lose mips. Validates that protected textures are never trimmed, evicted handles die
+//and the manager never stays over budget while it still had something to trim.
+static void ResidencyManager_SimulatedStreaming(State& state) {
+    constexpr uint32_t NUM_TEXTURES     = 2048;
+    constexpr uint32_t NUM_VISIBLE      = 256;
+    constexpr uint32_t PROTECTED_FRAMES = 3;
+    constexpr uint32_t VALIDATE_PERIOD  = 16;
+
+    struct SimulatedTexture {
+        std::vector<uint64_t> MipSizes;
+        GenerationalIndex Handle;
+        uint64_t LastTouchedFrame{ 0 };
+        bool Held{ false };
+        bool Pinned{ false };
+    };
+
+    uint64_t random = 0x2545F4914F6CDD1Dull;
+    uint64_t totalBytes = 0;
+
+    std::vector<SimulatedTexture> textures(NUM_TEXTURES);
+
+    for (uint32_t slot = 0; slot < NUM_TEXTURES; slot++) {
+        auto& texture  = textures[slot];
+        texture.Pinned = slot % 8 == 0;
+
+        //Square RGBA8 textures from 64x64 to 2048x2048 with a full mip chain
+        for (auto extent = uint64_t{ 64 } << (impl::NextRandom(random) % 6); extent > 0; extent /= 2) {
+            texture.MipSizes.push_back(extent * extent * 4);
+            totalBytes += texture.MipSizes.back();
+        }
+    }
+
+    ResidencyManager manager(totalBytes / 4, NUM_TEXTURES);
+    manager.SetProtectedFrames(PROTECTED_FRAMES);
+
+    std::vector<uint32_t> slotOfIndex(NUM_TEXTURES);
+    uint64_t frame = 0;
+
+    const auto isProtected = [&](const SimulatedTexture& texture) {
+        return texture.LastTouchedFrame + PROTECTED_FRAMES > frame;
+    };
+
+    for (auto _ : state) {
+        frame++;
+
+        const auto firstVisible = static_cast<uint32_t>(frame * 3 % NUM_TEXTURES);
+
+        for (uint32_t slot = 0; slot < NUM_TEXTURES; slot++) {
+            auto& texture        = textures[slot];
+            const auto distance  = (slot + NUM_TEXTURES - firstVisible) % NUM_TEXTURES;
+            const bool isVisible = distance < NUM_VISIBLE;
+            const bool wantsHeld = isVisible || texture.Pinned;
+
+            if (!manager.IsRegistered(texture.Handle)) {
+                texture.Held = false;
+
+                if (!wantsHeld) {
+                    continue;
+                }
+
+                texture.Handle = manager.Register(texture.MipSizes, 1, frame);
+                texture.Held   = true;
+
+                if (!texture.Handle.IsValid()) [[unlikely]] {
+                    state.Fail("Registering failed although the capacity covers every texture");
+                    return;
+                }
+                slotOfIndex[texture.Handle.Index] = slot;
+            }
+            else if (wantsHeld && !texture.Held) {
+                manager.AddRef(texture.Handle);
+                texture.Held = true;
+            }
+            else if (!wantsHeld && texture.Held) {
+                manager.Release(texture.Handle);
+                texture.Held = false;
+            }
+
+            //Closer textures ask for more detail
+            if (isVisible) {
+                manager.Touch(texture.Handle, frame, distance * 4 / NUM_VISIBLE);
+                texture.LastTouchedFrame = frame;
+            }
+        }
+
+        const auto actions = manager.Update(frame);
+
+        for (const auto& action : actions) {
+            auto& texture = textures[slotOfIndex[action.Handle.Index]];
+
+            if (action.Type != ResidencyActionType::RestoreMips && isProtected(texture)) [[unlikely]] {
+                state.Fail("A texture used within the protected frames was trimmed");
+            }
+
+            if (action.Type == ResidencyActionType::Evict && (texture.Held || manager.IsRegistered(action.Handle))) [[unlikely]] {
+                state.Fail("An evicted texture is still referenced or registered");
+            }
+        }
+
+        if (frame % VALIDATE_PERIOD == 0) {
+            const auto statistics = manager.GetStatistics();
+            uint64_t residentBytes = 0;
+            bool canTrim           = false;
+
+            for (const auto& texture : textures) {
+                if (!manager.IsRegistered(texture.Handle)) {
+                    continue;
+                }
+
+                const auto firstMip = manager.GetFirstResidentMip(texture.Handle);
+
+                for (auto mip = firstMip; mip < texture.MipSizes.size(); mip++) {
+                    residentBytes += texture.MipSizes[mip];
+                }
+
+                canTrim |= !isProtected(texture) && (!texture.Held || firstMip + 1 < texture.MipSizes.size());
+            }
+
+            if (residentBytes != statistics.ResidentBytes) [[unlikely]] {
+                state.Fail("Resident bytes do not match the registered textures");
+            }
+
+            if (statistics.ResidentBytes > statistics.BudgetInBytes && canTrim) [[unlikely]] {
+                state.Fail("Over budget although unprotected textures could still be trimmed");
+            }
+        }
+
+        DoNotOptimize(actions.data());
+    }
+    state.SetItemsPerIteration(NUM_TEXTURES);
+}
+CRYSTAL_BENCHMARK(ResidencyManager_SimulatedStreaming);
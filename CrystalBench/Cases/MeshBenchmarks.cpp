@@ -0,0 +1,886 @@
+#include "../Benchmark.h"
+
+#include "Graphics/ClusterCulling.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/MeshSimplifier.h"
+#include "Graphics/Meshlets.h"
+#include "Graphics/VertexLayouts.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <numbers>
+#include <numeric>
+#include <ranges>
+#include <vector>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    //Same layout as the engine vertex: position, normal, tangent, bitangent and texture coordinate
+    struct MeshVertex {
+        std::array<float, 15> Attributes;
+    };
+
+    struct TestMesh {
+        uint32_t Segments;
+        uint32_t Rings;
+        std::vector<MeshVertex> Vertices;
+        std::vector<uint32_t> Indices;
+
+        [[nodiscard]] uint32_t GetNumVertices() const noexcept { return static_cast<uint32_t>(Vertices.size()); }
+        [[nodiscard]] std::span<std::byte> GetVertexData() noexcept { return std::as_writable_bytes(std::span(Vertices)); }
+        [[nodiscard]] std::span<const std::byte> GetVertexData() const noexcept { return std::as_bytes(std::span(Vertices)); }
+    };
+
+    //Closed torus with a shared vertex per grid point, its texture coordinate identifies the point
+    TestMesh CreateTorus(uint32_t segments, uint32_t rings) {
+        constexpr float MAJOR_RADIUS = 1.0f;
+        constexpr float MINOR_RADIUS = 0.35f;
+        constexpr auto TWO_PI        = 2.0f * std::numbers::pi_v<float>;
+
+        TestMesh mesh{ segments, rings };
+        mesh.Vertices.reserve(size_t{ segments } * rings);
+
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const auto u = static_cast<float>(segment) / segments;
+                const auto v = static_cast<float>(ring) / rings;
+
+                const auto cu = std::cos(u * TWO_PI), su = std::sin(u * TWO_PI);
+                const auto cv = std::cos(v * TWO_PI), sv = std::sin(v * TWO_PI);
+
+                const auto radius = MAJOR_RADIUS + MINOR_RADIUS * cv;
+
+                mesh.Vertices.push_back({ {
+                    radius * cu, radius * su, MINOR_RADIUS * sv,
+                    cv * cu, cv * su, sv,
+                    -su, cu, 0.0f,
+                    -sv * cu, -sv * su, cv,
+                    u, v, 0.0f
+                } });
+            }
+        }
+
+        for (uint32_t ring = 0; ring < rings; ring++) {
+            for (uint32_t segment = 0; segment < segments; segment++) {
+                const auto i0 = ring * segments + segment;
+                const auto i1 = ring * segments + (segment + 1) % segments;
+                const auto i2 = (ring + 1) % rings * segments + segment;
+                const auto i3 = (ring + 1) % rings * segments + (segment + 1) % segments;
+
+                mesh.Indices.insert(mesh.Indices.end(), { i0, i1, i2, i2, i1, i3 });
+            }
+        }
+        return mesh;
+    }
+
+    //Triangles in random order, the way a careless exporter or a merge of many parts leaves them
+    void ShuffleTriangles(std::vector<uint32_t>& indices, uint32_t seed) {
+        uint32_t random = seed * 0x9E3779B9u + 1;
+
+        for (size_t triangle = indices.size() / 3; triangle > 1; triangle--) {
+            random = random * 1664525u + 1013904223u;
+
+            const auto other = static_cast<size_t>((uint64_t{ random } * triangle) >> 32);
+            std::swap_ranges(indices.begin() + (triangle - 1) * 3, indices.begin() + triangle * 3, indices.begin() + other * 3);
+        }
+    }
+
+    //Every corner gets its own vertex, with positions moved by less than the weld tolerance
+    TestMesh CreateTriangleSoup(const TestMesh& mesh, uint32_t seed) {
+        TestMesh soup{ mesh.Segments, mesh.Rings };
+        soup.Vertices.reserve(mesh.Indices.size());
+        soup.Indices.reserve(mesh.Indices.size());
+
+        auto indices = mesh.Indices;
+        ShuffleTriangles(indices, seed);
+
+        uint32_t random = seed;
+
+        for (const auto index : indices) {
+            auto vertex = mesh.Vertices[index];
+
+            for (size_t axis = 0; axis < 3; axis++) {
+                random = random * 1664525u + 1013904223u;
+                vertex.Attributes[axis] += (static_cast<float>(random >> 8) / (1 << 24) - 0.5f) * 4e-6f;
+            }
+
+            soup.Indices.push_back(static_cast<uint32_t>(soup.Vertices.size()));
+            soup.Vertices.push_back(vertex);
+        }
+        return soup;
+    }
+
+    [[nodiscard]] uint32_t GetGridPoint(const TestMesh& mesh, uint32_t vertex) noexcept {
+        const auto& attributes = mesh.Vertices[vertex].Attributes;
+
+        const auto segment = static_cast<uint32_t>(std::lround(attributes[12] * mesh.Segments));
+        const auto ring    = static_cast<uint32_t>(std::lround(attributes[13] * mesh.Rings));
+        return ring * mesh.Segments + segment;
+    }
+
+    //Triangles as grid points, rotated to start at the smallest one so the winding is kept, and sorted
+    [[nodiscard]] std::vector<std::array<uint32_t, 3>> GetTriangleSet(const TestMesh& mesh, std::span<const uint32_t> indices) {
+        std::vector<std::array<uint32_t, 3>> triangles;
+        triangles.reserve(indices.size() / 3);
+
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            std::array<uint32_t, 3> triangle{ GetGridPoint(mesh, indices[i]), GetGridPoint(mesh, indices[i + 1]), GetGridPoint(mesh, indices[i + 2]) };
+            std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+            triangles.push_back(triangle);
+        }
+
+        std::ranges::sort(triangles);
+        return triangles;
+    }
+
+    //Vertices in random order, remapping the indices so the triangles stay the same
+    void ShuffleVertices(TestMesh& mesh, uint32_t seed) {
+        std::vector<uint32_t> newIndices(mesh.Vertices.size());
+        std::iota(newIndices.begin(), newIndices.end(), 0u);
+
+        uint32_t random = seed * 0x9E3779B9u + 1;
+
+        for (size_t vertex = newIndices.size(); vertex > 1; vertex--) {
+            random = random * 1664525u + 1013904223u;
+            std::swap(newIndices[vertex - 1], newIndices[static_cast<size_t>((uint64_t{ random } * vertex) >> 32)]);
+        }
+
+        auto vertices = mesh.Vertices;
+
+        for (size_t vertex = 0; vertex < vertices.size(); vertex++) {
+            mesh.Vertices[newIndices[vertex]] = vertices[vertex];
+        }
+
+        for (auto& index : mesh.Indices) {
+            index = newIndices[index];
+        }
+    }
+
+    //Every vertex has to be referenced for the first time right after the previous one
+    [[nodiscard]] bool IsInFetchOrder(std::span<const uint32_t> indices) noexcept {
+        uint32_t numReferenced = 0;
+
+        for (const auto index : indices) {
+            if (index > numReferenced) {
+                return false;
+            }
+            numReferenced += index == numReferenced;
+        }
+        return true;
+    }
+
+    constexpr uint32_t QUALITY_SEGMENTS = 192;
+    constexpr uint32_t QUALITY_RINGS    = 96;
+
+    //Simulated FIFO cache hit rates the orderings have to reach on the torus
+    constexpr float MAX_OPTIMIZED_ACMR = 0.8f;
+    constexpr float MAX_OPTIMIZED_ATVR = 1.6f;
+
+    //The overdraw threshold is estimated per cluster on a cold cache, sorting also loses what was cached across clusters
+    constexpr float MAX_OVERDRAW_ACMR_INCREASE = 1.1f;
+
+    //Shuffled torus with welded vertices, the input of the individual passes
+    TestMesh CreateShuffledTorus(uint32_t segments) {
+        auto mesh = CreateTorus(segments, segments / 2);
+        ShuffleTriangles(mesh.Indices, segments);
+        return mesh;
+    }
+
+    [[nodiscard]] std::vector<Vertex> ToVertices(const TestMesh& mesh) {
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.Vertices.size());
+
+        for (const auto& [attributes] : mesh.Vertices) {
+            vertices.push_back({
+                .Position  = { attributes[0], attributes[1], attributes[2] },
+                .Normal    = { attributes[3], attributes[4], attributes[5] },
+                .Tangent   = { attributes[6], attributes[7], attributes[8] },
+                .Bitangent = { attributes[9], attributes[10], attributes[11] },
+                .TexCoord  = { attributes[12], attributes[13], attributes[14] }
+            });
+        }
+        return vertices;
+    }
+
+    [[nodiscard]] float GetAttributeError(const Math::Vector3& lhs, const Math::Vector3& rhs) noexcept {
+        const auto difference = lhs - rhs;
+        return std::sqrt(Math::Vector3::Dot(difference, difference));
+    }
+
+    constexpr std::array VERTEX_LAYOUTS{ VertexLayout::Full, VertexLayout::Compact, VertexLayout::Quantized };
+    constexpr std::array VERTEX_LAYOUT_NAMES{ "Full", "Compact", "Quantized" };
+
+    //Directions go through snorm16, texture coordinates in [0, 1] through half with its 2^-11 relative step
+    constexpr float MAX_DIRECTION_ERROR = 2e-4f;
+    constexpr float MAX_TEXCOORD_ERROR  = 0x1p-12f;
+
+    //Torus in the order the importer leaves it before meshlets are built
+    TestMesh CreateOptimizedTorus(uint32_t segments) {
+        auto mesh = CreateShuffledTorus(segments);
+        OptimizeVertexCache(mesh.Indices, mesh.GetNumVertices(), VertexCacheOrdering::Tipsify);
+        OptimizeVertexFetch(mesh.GetVertexData(), sizeof(MeshVertex), mesh.Indices);
+        return mesh;
+    }
+
+    [[nodiscard]] Math::Vector3 GetPosition(const TestMesh& mesh, uint32_t vertex) noexcept {
+        const auto& attributes = mesh.Vertices[vertex].Attributes;
+        return { attributes[0], attributes[1], attributes[2] };
+    }
+
+    //Triangles of a meshlet as indices into the vertex buffer
+    [[nodiscard]] std::vector<uint32_t> GetMeshletIndices(const MeshletData& meshlets, const Meshlet& meshlet) {
+        std::vector<uint32_t> indices;
+        indices.reserve(size_t{ meshlet.NumTriangles } * 3);
+
+        for (uint32_t corner = 0; corner < meshlet.NumTriangles * 3; corner++) {
+            indices.push_back(meshlets.Vertices[meshlet.VertexOffset + meshlets.Triangles[meshlet.TriangleOffset + corner]]);
+        }
+        return indices;
+    }
+
+    //Camera outside the torus looking at part of it, so some meshlets are off screen and the far side faces away
+    [[nodiscard]] CullingFrustum CreateTestFrustum(Math::Vector3& cameraPosition) {
+        cameraPosition = { 2.4f, -0.6f, 1.4f };
+
+        const auto view       = Math::Matrix::CreateLookAtLH(cameraPosition, { 0.6f, 0.3f, 0.0f }, { 0.0f, 0.0f, 1.0f });
+        const auto projection = Math::Matrix::CreatePerspectiveFieldOfViewLH(std::numbers::pi_v<float> / 8.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+        return CreateCullingFrustum(view * projection, cameraPosition);
+    }
+
+    //Distance of a point to the surface of the torus CreateTorus samples
+    [[nodiscard]] float GetTorusDistance(const Math::Vector3& point) noexcept {
+        const auto ringDistance = std::sqrt(point.x * point.x + point.y * point.y) - 1.0f;
+        return std::abs(std::sqrt(ringDistance * ringDistance + point.z * point.z) - 0.35f);
+    }
+
+    //Open height field with a seam down the middle: the columns there exist twice with different texture coordinates,
+    //the way a UV island boundary is cut
+    TestMesh CreateSeamedGrid(uint32_t size) {
+        TestMesh mesh{ size, size };
+        const auto half = size / 2;
+
+        const auto addVertex = [&](uint32_t x, uint32_t y, float u) {
+            const auto px = static_cast<float>(x) / (size - 1), py = static_cast<float>(y) / (size - 1);
+            const auto height = 0.1f * std::sin(px * 6.0f) * std::cos(py * 5.0f);
+
+            mesh.Vertices.push_back({ { px, py, height, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, u, py, 0.0f } });
+            return static_cast<uint32_t>(mesh.Vertices.size() - 1);
+        };
+
+        std::vector<uint32_t> left(size_t{ size } * size), right(size_t{ size } * size);
+
+        for (uint32_t y = 0; y < size; y++) {
+            for (uint32_t x = 0; x < size; x++) {
+                const auto u = static_cast<float>(x) / (size - 1);
+
+                if (x <= half) {
+                    left[y * size + x] = addVertex(x, y, u * 0.5f);
+                }
+                if (x >= half) {
+                    right[y * size + x] = addVertex(x, y, 0.5f + u * 0.5f);
+                }
+            }
+        }
+
+        for (uint32_t y = 0; y + 1 < size; y++) {
+            for (uint32_t x = 0; x + 1 < size; x++) {
+                const auto& side = x < half ? left : right;
+                const auto i0 = side[y * size + x], i1 = side[y * size + x + 1];
+                const auto i2 = side[(y + 1) * size + x], i3 = side[(y + 1) * size + x + 1];
+
+                mesh.Indices.insert(mesh.Indices.end(), { i0, i1, i2, i2, i1, i3 });
+            }
+        }
+        return mesh;
+    }
+
+    //Engine vertex weights: normal and texture coordinate, tangents follow the normal
+    constexpr std::array<float, 12> SIMPLIFIER_ATTRIBUTE_WEIGHTS{ 0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f };
+
+    //Levels the torus has to reach with the default settings, before the error limit ends the chain
+    constexpr size_t MIN_TORUS_LOD_LEVELS = 4;
+
+    //The quadric error is an area weighted estimate of the distance, the furthest point of a level can exceed it
+    constexpr float MAX_LOD_ERROR_UNDERESTIMATE = 2.0f;
+
+    //Average triangles per meshlet the builder has to reach on the torus. The 64 vertex limit binds first, a square
+    //patch of 8 by 8 grid points holds 98 triangles.
+    constexpr float MIN_MESHLET_FILL = 85.0f;
+}
+
+static void MeshOptimizer_Quality(State& state) {
+    constexpr auto STRIDE = static_cast<uint32_t>(sizeof(impl::MeshVertex));
+
+    const auto torus     = impl::CreateTorus(impl::QUALITY_SEGMENTS, impl::QUALITY_RINGS);
+    const auto reference = impl::GetTriangleSet(torus, torus.Indices);
+    const auto soup      = impl::CreateTriangleSoup(torus, 7);
+
+    for (auto _ : state) {
+        for (const auto ordering : { VertexCacheOrdering::Tipsify, VertexCacheOrdering::Forsyth }) {
+            const auto name = ordering == VertexCacheOrdering::Tipsify ? "Tipsify" : "Forsyth";
+
+            MeshOptimizerSettings settings{ .Ordering = ordering };
+
+            auto mesh         = soup;
+            const auto report = OptimizeMesh(mesh.GetVertexData(), STRIDE, mesh.Indices, settings);
+            mesh.Vertices.resize(report.NumVerticesAfter);
+
+            if (report.NumVerticesAfter != torus.GetNumVertices() || report.NumTrianglesAfter != torus.Indices.size() / 3) {
+                state.Fail(std::format("{} kept {} vertices and {} triangles", name, report.NumVerticesAfter, report.NumTrianglesAfter));
+            }
+
+            if (impl::GetTriangleSet(mesh, mesh.Indices) != reference) {
+                state.Fail(std::format("{} changed the triangles of the mesh", name));
+            }
+
+            if (!impl::IsInFetchOrder(mesh.Indices)) {
+                state.Fail(std::format("{} vertices are not in the order they are fetched", name));
+            }
+
+            if (report.After.ACMR > impl::MAX_OPTIMIZED_ACMR || report.After.ATVR > impl::MAX_OPTIMIZED_ATVR) {
+                state.Fail(std::format("{} reaches an ACMR of {:.3f} and ATVR of {:.3f}", name, report.After.ACMR, report.After.ATVR));
+            }
+
+            //Sorting for overdraw may only cost as much cache efficiency as the threshold allows
+            settings.OverdrawThreshold = 1.0f;
+
+            auto cacheOnly             = soup;
+            const auto cacheOnlyReport = OptimizeMesh(cacheOnly.GetVertexData(), STRIDE, cacheOnly.Indices, settings);
+
+            if (report.After.ACMR > cacheOnlyReport.After.ACMR * impl::MAX_OVERDRAW_ACMR_INCREASE) {
+                state.Fail(std::format("{} overdraw ordering raises the ACMR from {:.3f} to {:.3f}", name, cacheOnlyReport.After.ACMR, report.After.ACMR));
+            }
+        }
+
+        //Vertices fetched in random order have to be brought back into the order the triangles use them
+        auto scattered = impl::CreateShuffledTorus(impl::QUALITY_SEGMENTS);
+        impl::ShuffleVertices(scattered, 11);
+        OptimizeVertexCache(scattered.Indices, scattered.GetNumVertices(), VertexCacheOrdering::Tipsify);
+
+        const auto scatteredFetch = AnalyzeVertexCache(scattered.Indices, scattered.GetNumVertices(), STRIDE);
+        OptimizeVertexFetch(scattered.GetVertexData(), STRIDE, scattered.Indices);
+        const auto orderedFetch   = AnalyzeVertexCache(scattered.Indices, scattered.GetNumVertices(), STRIDE);
+
+        if (orderedFetch.ACMR != scatteredFetch.ACMR || orderedFetch.Overfetch >= scatteredFetch.Overfetch) {
+            state.Fail(std::format("Vertex fetch ordering changes the overfetch from {:.3f} to {:.3f}", scatteredFetch.Overfetch, orderedFetch.Overfetch));
+        }
+
+        //Without welding every corner is kept, at zero tolerance only identical vertices are merged
+        auto unwelded     = soup;
+        const auto report = OptimizeMesh(unwelded.GetVertexData(), STRIDE, unwelded.Indices, { .PositionTolerance = -1.0f });
+
+        if (report.NumVerticesAfter != soup.GetNumVertices()) {
+            state.Fail("Vertices were welded with welding disabled");
+        }
+
+        const auto exact = WeldVertices(torus.GetVertexData(), STRIDE, 0.0f, 0.0f);
+
+        if (!std::ranges::equal(exact, std::views::iota(0u, torus.GetNumVertices()))) {
+            state.Fail("Distinct vertices were welded at zero tolerance");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Quality);
+
+//Argument is the number of segments of the torus, which has half as many rings and two triangles per quad
+static void MeshOptimizer_Weld(State& state) {
+    const auto soup = impl::CreateTriangleSoup(impl::CreateTorus(static_cast<uint32_t>(state.Argument()), static_cast<uint32_t>(state.Argument() / 2)), 3);
+
+    for (auto _ : state) {
+        auto remap = WeldVertices(soup.GetVertexData(), sizeof(impl::MeshVertex), 1e-5f, 1e-4f);
+        DoNotOptimize(remap);
+    }
+
+    state.SetItemsPerIteration(soup.Vertices.size());
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Weld, 128, 512);
+
+template <VertexCacheOrdering Ordering>
+static void MeshOptimizer_VertexCache(State& state) {
+    const auto mesh = impl::CreateShuffledTorus(static_cast<uint32_t>(state.Argument()));
+    auto indices    = mesh.Indices;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::ranges::copy(mesh.Indices, indices.begin());
+        state.ResumeTiming();
+
+        OptimizeVertexCache(indices, mesh.GetNumVertices(), Ordering);
+        DoNotOptimize(indices);
+    }
+
+    state.SetItemsPerIteration(indices.size() / 3);
+}
+
+static void MeshOptimizer_Tipsify(State& state) {
+    MeshOptimizer_VertexCache<VertexCacheOrdering::Tipsify>(state);
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Tipsify, 128, 512);
+
+static void MeshOptimizer_Forsyth(State& state) {
+    MeshOptimizer_VertexCache<VertexCacheOrdering::Forsyth>(state);
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Forsyth, 128, 512);
+
+static void MeshOptimizer_Overdraw(State& state) {
+    auto mesh = impl::CreateShuffledTorus(static_cast<uint32_t>(state.Argument()));
+    OptimizeVertexCache(mesh.Indices, mesh.GetNumVertices(), VertexCacheOrdering::Tipsify);
+
+    auto indices = mesh.Indices;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::ranges::copy(mesh.Indices, indices.begin());
+        state.ResumeTiming();
+
+        OptimizeOverdraw(indices, mesh.GetVertexData(), sizeof(impl::MeshVertex), MeshOptimizerSettings{}.OverdrawThreshold);
+        DoNotOptimize(indices);
+    }
+
+    state.SetItemsPerIteration(indices.size() / 3);
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Overdraw, 128, 512);
+
+static void MeshOptimizer_VertexFetch(State& state) {
+    auto mesh = impl::CreateShuffledTorus(static_cast<uint32_t>(state.Argument()));
+    OptimizeVertexCache(mesh.Indices, mesh.GetNumVertices(), VertexCacheOrdering::Tipsify);
+
+    auto optimized = mesh;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::ranges::copy(mesh.Vertices, optimized.Vertices.begin());
+        std::ranges::copy(mesh.Indices, optimized.Indices.begin());
+        state.ResumeTiming();
+
+        DoNotOptimize(OptimizeVertexFetch(optimized.GetVertexData(), sizeof(impl::MeshVertex), optimized.Indices));
+    }
+
+    state.SetBytesPerIteration(mesh.Vertices.size() * sizeof(impl::MeshVertex));
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_VertexFetch, 128, 512);
+
+static void MeshOptimizer_Analyze(State& state) {
+    const auto mesh = impl::CreateShuffledTorus(static_cast<uint32_t>(state.Argument()));
+
+    for (auto _ : state) {
+        DoNotOptimize(AnalyzeVertexCache(mesh.Indices, mesh.GetNumVertices(), sizeof(impl::MeshVertex)));
+    }
+
+    state.SetItemsPerIteration(mesh.Indices.size() / 3);
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Analyze, 128, 512);
+
+//Every pass as the importer runs them, starting from a shuffled triangle soup
+static void MeshOptimizer_Full(State& state) {
+    const auto soup = impl::CreateTriangleSoup(impl::CreateTorus(static_cast<uint32_t>(state.Argument()), static_cast<uint32_t>(state.Argument() / 2)), 5);
+    auto mesh       = soup;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        mesh = soup;
+        state.ResumeTiming();
+
+        DoNotOptimize(OptimizeMesh(mesh.GetVertexData(), sizeof(impl::MeshVertex), mesh.Indices));
+    }
+
+    state.SetItemsPerIteration(soup.Indices.size() / 3);
+}
+CRYSTAL_BENCHMARK(MeshOptimizer_Full, 128, 512);
+
+//Every layout has to decode to the torus within the precision of its formats, the bitangent keeps its side
+static void VertexLayout_Quality(State& state) {
+    auto torus = impl::CreateTorus(impl::QUALITY_SEGMENTS, impl::QUALITY_RINGS);
+
+    //Half of the vertices get a mirrored bitangent, the way mirrored UV islands have them
+    for (size_t vertex = 0; vertex < torus.Vertices.size(); vertex += 2) {
+        for (size_t component = 9; component < 12; component++) {
+            torus.Vertices[vertex].Attributes[component] *= -1.0f;
+        }
+    }
+
+    const auto vertices = impl::ToVertices(torus);
+    const auto bounds   = ComputePositionBounds(vertices);
+
+    std::vector<std::byte> converted(vertices.size() * sizeof(Vertex));
+
+    for (auto _ : state) {
+        for (size_t i = 0; i < impl::VERTEX_LAYOUTS.size(); i++) {
+            const auto layout         = impl::VERTEX_LAYOUTS[i];
+            const auto stride         = GetVertexStride(layout);
+            const auto dequantization = GetPositionDequantization(bounds, layout);
+
+            ConvertVertices(vertices, layout, bounds, converted);
+
+            //Half a quantization step of the largest extent, with some room for the float math
+            float maxPositionError = 0.0f;
+
+            if (layout == VertexLayout::Quantized) {
+                for (size_t axis = 0; axis < 3; axis++) {
+                    maxPositionError = std::max(maxPositionError, (bounds.Max[axis] - bounds.Min[axis]) / 65535.0f);
+                }
+            }
+
+            float positionError = 0.0f, directionError = 0.0f, texCoordError = 0.0f;
+            bool isHandednessKept = true;
+
+            for (size_t vertex = 0; vertex < vertices.size(); vertex++) {
+                const auto& original = vertices[vertex];
+                const auto decoded   = DecodeVertex(std::span(converted).subspan(vertex * stride, stride), layout, dequantization);
+
+                positionError  = std::max(positionError, impl::GetAttributeError(decoded.Position, original.Position));
+                texCoordError  = std::max({ texCoordError, std::abs(decoded.TexCoord.x - original.TexCoord.x), std::abs(decoded.TexCoord.y - original.TexCoord.y) });
+                directionError = std::max({
+                    directionError,
+                    impl::GetAttributeError(decoded.Normal, original.Normal),
+                    impl::GetAttributeError(decoded.Tangent, original.Tangent),
+                    impl::GetAttributeError(decoded.Bitangent, original.Bitangent)
+                });
+
+                isHandednessKept &= Math::Vector3::Dot(decoded.Bitangent, original.Bitangent) > 0.0f;
+            }
+
+            const auto name = impl::VERTEX_LAYOUT_NAMES[i];
+
+            if (positionError > maxPositionError) {
+                state.Fail(std::format("{} positions are off by {:.2e}, allowed are {:.2e}", name, positionError, maxPositionError));
+            }
+
+            if (directionError > impl::MAX_DIRECTION_ERROR || texCoordError > impl::MAX_TEXCOORD_ERROR) {
+                state.Fail(std::format("{} directions are off by {:.2e} and texture coordinates by {:.2e}", name, directionError, texCoordError));
+            }
+
+            if (!isHandednessKept) {
+                state.Fail(std::format("{} flips the bitangent of mirrored vertices", name));
+            }
+        }
+    }
+}
+CRYSTAL_BENCHMARK(VertexLayout_Quality);
+
+//Argument is the VertexLayout, converting the vertices of a 512 segment torus as the importer does
+static void VertexLayout_Convert(State& state) {
+    const auto layout   = static_cast<VertexLayout>(state.Argument());
+    const auto vertices = impl::ToVertices(impl::CreateTorus(512, 256));
+    const auto bounds   = ComputePositionBounds(vertices);
+
+    std::vector<std::byte> converted(vertices.size() * GetVertexStride(layout));
+
+    for (auto _ : state) {
+        ConvertVertices(vertices, layout, bounds, converted);
+        DoNotOptimize(converted.data());
+        ClobberMemory();
+    }
+
+    state.SetItemsPerIteration(vertices.size());
+}
+CRYSTAL_BENCHMARK(VertexLayout_Convert, 0, 1, 2);
+
+//Argument is the VertexLayout. Vertices are decoded in index order after optimization, the bytes are what the
+//simulated vertex fetch cache reads from the vertex buffer for the same draw.
+static void VertexLayout_Fetch(State& state) {
+    const auto layout = static_cast<VertexLayout>(state.Argument());
+    const auto stride = GetVertexStride(layout);
+
+    auto mesh = impl::CreateShuffledTorus(512);
+    OptimizeVertexCache(mesh.Indices, mesh.GetNumVertices(), VertexCacheOrdering::Tipsify);
+    OptimizeVertexFetch(mesh.GetVertexData(), sizeof(impl::MeshVertex), mesh.Indices);
+
+    const auto vertices       = impl::ToVertices(mesh);
+    const auto bounds         = ComputePositionBounds(vertices);
+    const auto dequantization = GetPositionDequantization(bounds, layout);
+
+    std::vector<std::byte> converted(vertices.size() * stride);
+    ConvertVertices(vertices, layout, bounds, converted);
+
+    const auto statistics = AnalyzeVertexCache(mesh.Indices, mesh.GetNumVertices(), stride);
+
+    for (auto _ : state) {
+        Math::Vector3 accumulated;
+
+        for (const auto index : mesh.Indices) {
+            const auto vertex = DecodeVertex(std::span(converted).subspan(size_t{ index } * stride, stride), layout, dequantization);
+            accumulated       = accumulated + vertex.Position + vertex.Normal;
+        }
+        DoNotOptimize(accumulated);
+    }
+
+    state.SetBytesPerIteration(statistics.BytesFetched);
+}
+CRYSTAL_BENCHMARK(VertexLayout_Fetch, 0, 1, 2);
+
+//Every triangle ends up in exactly one meshlet within the limits, and the bounds hold what they describe. Culled
+//meshlets are checked against their triangles: outside one plane with every vertex, or facing away with every triangle.
+static void Meshlet_Quality(State& state) {
+    const auto torus     = impl::CreateOptimizedTorus(impl::QUALITY_SEGMENTS);
+    const auto reference = impl::GetTriangleSet(torus, torus.Indices);
+    const MeshletSettings settings{};
+
+    Math::Vector3 cameraPosition;
+    const auto frustum = impl::CreateTestFrustum(cameraPosition);
+
+    for (auto _ : state) {
+        const auto meshlets = BuildMeshlets(torus.Indices, torus.GetVertexData(), sizeof(impl::MeshVertex), settings);
+
+        std::vector<uint32_t> indices;
+        bool areBoundsValid = true;
+
+        for (size_t i = 0; i < meshlets.Meshlets.size(); i++) {
+            const auto& meshlet = meshlets.Meshlets[i];
+            const auto& bounds  = meshlets.Bounds[i];
+
+            if (meshlet.NumVertices > settings.MaxVertices || meshlet.NumTriangles > settings.MaxTriangles || meshlet.NumTriangles == 0) {
+                state.Fail(std::format("Meshlet {} has {} vertices and {} triangles", i, meshlet.NumVertices, meshlet.NumTriangles));
+            }
+
+            const auto meshletIndices = impl::GetMeshletIndices(meshlets, meshlet);
+            indices.insert(indices.end(), meshletIndices.begin(), meshletIndices.end());
+
+            const Math::Vector3 center{ bounds.Center[0], bounds.Center[1], bounds.Center[2] };
+            const Math::Vector3 axis{ bounds.ConeAxis[0], bounds.ConeAxis[1], bounds.ConeAxis[2] };
+
+            //Normals may not be further from the axis than the cone's half angle
+            const auto minDot = bounds.ConeCutoff <= 1.0f ? std::sqrt(1.0f - bounds.ConeCutoff * bounds.ConeCutoff) : -1.0f;
+
+            for (size_t corner = 0; corner < meshletIndices.size(); corner += 3) {
+                const auto p0 = impl::GetPosition(torus, meshletIndices[corner]);
+                const auto p1 = impl::GetPosition(torus, meshletIndices[corner + 1]);
+                const auto p2 = impl::GetPosition(torus, meshletIndices[corner + 2]);
+
+                for (const auto& position : { p0, p1, p2 }) {
+                    areBoundsValid &= impl::GetAttributeError(position, center) <= bounds.Radius * 1.0001f;
+                }
+
+                const auto normal = Math::Vector3::Normalize(Math::Vector3::Cross(p1 - p0, p2 - p0));
+                areBoundsValid &= Math::Vector3::Dot(normal, axis) >= minDot - 1e-4f;
+            }
+        }
+
+        if (impl::GetTriangleSet(torus, indices) != reference) {
+            state.Fail("Meshlets do not cover every triangle exactly once");
+        }
+
+        if (!areBoundsValid) {
+            state.Fail("Meshlet bounds do not contain their vertices or normals");
+        }
+
+        const auto fill = static_cast<float>(torus.Indices.size() / 3) / meshlets.Meshlets.size();
+
+        if (fill < impl::MIN_MESHLET_FILL) {
+            state.Fail(std::format("Meshlets hold {:.1f} triangles on average", fill));
+        }
+
+        std::vector<uint32_t> visible;
+        const auto statistics = CullMeshlets(meshlets.Bounds, frustum, visible);
+
+        if (statistics.NumOutsideFrustum == 0 || statistics.NumBackFacing == 0) {
+            state.Fail(std::format("Culled {} meshlets by the frustum and {} as back facing", statistics.NumOutsideFrustum, statistics.NumBackFacing));
+        }
+
+        if (statistics.NumVisible + statistics.NumOutsideFrustum + statistics.NumBackFacing != meshlets.Meshlets.size()) {
+            state.Fail("Culling statistics do not add up to the number of meshlets");
+        }
+
+        //Culling has to be conservative, brute forced over the vertices and triangles of the meshlets
+        bool isConservative = true;
+
+        for (size_t i = 0; i < meshlets.Meshlets.size(); i++) {
+            const auto meshletIndices = impl::GetMeshletIndices(meshlets, meshlets.Meshlets[i]);
+
+            if (IsOutsideFrustum(meshlets.Bounds[i], frustum)) {
+                isConservative &= std::ranges::any_of(frustum.Planes, [&](const auto& plane) {
+                    return std::ranges::all_of(meshletIndices, [&](uint32_t index) {
+                        const auto position = impl::GetPosition(torus, index);
+                        return plane[0] * position.x + plane[1] * position.y + plane[2] * position.z + plane[3] < 0.0f;
+                    });
+                });
+            }
+            else if (IsBackFacing(meshlets.Bounds[i], frustum.CameraPosition)) {
+                for (size_t corner = 0; corner < meshletIndices.size(); corner += 3) {
+                    const auto p0 = impl::GetPosition(torus, meshletIndices[corner]);
+                    const auto p1 = impl::GetPosition(torus, meshletIndices[corner + 1]);
+                    const auto p2 = impl::GetPosition(torus, meshletIndices[corner + 2]);
+
+                    isConservative &= Math::Vector3::Dot(Math::Vector3::Cross(p1 - p0, p2 - p0), p0 - cameraPosition) >= 0.0f;
+                }
+            }
+        }
+
+        if (!isConservative) {
+            state.Fail("Culled meshlets that have visible triangles");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(Meshlet_Quality);
+
+//Argument is the number of segments of the torus
+static void Meshlet_Build(State& state) {
+    const auto mesh = impl::CreateOptimizedTorus(static_cast<uint32_t>(state.Argument()));
+
+    for (auto _ : state) {
+        auto meshlets = BuildMeshlets(mesh.Indices, mesh.GetVertexData(), sizeof(impl::MeshVertex));
+        DoNotOptimize(meshlets);
+    }
+
+    state.SetItemsPerIteration(mesh.Indices.size() / 3);
+}
+CRYSTAL_BENCHMARK(Meshlet_Build, 128, 512);
+
+//Meshlets of a 512 segment torus against the view of the quality case, as a per frame CPU pass would run it
+static void ClusterCulling_Cull(State& state) {
+    const auto mesh     = impl::CreateOptimizedTorus(512);
+    const auto meshlets = BuildMeshlets(mesh.Indices, mesh.GetVertexData(), sizeof(impl::MeshVertex));
+
+    Math::Vector3 cameraPosition;
+    const auto frustum = impl::CreateTestFrustum(cameraPosition);
+
+    std::vector<uint32_t> visible;
+
+    for (auto _ : state) {
+        DoNotOptimize(CullMeshlets(meshlets.Bounds, frustum, visible));
+        ClobberMemory();
+    }
+
+    state.SetItemsPerIteration(meshlets.Bounds.size());
+}
+CRYSTAL_BENCHMARK(ClusterCulling_Cull);
+
+//Every level of the chain has to reduce the triangles and report an error that never decreases and stays close to
+//the real distance from the torus. Locked borders and seams keep every one of their vertices, unlocked borders
+//keep their corners. Selection has to move to coarser levels with distance.
+static void MeshSimplifier_Quality(State& state) {
+    const auto torus = impl::CreateOptimizedTorus(impl::QUALITY_SEGMENTS);
+    const auto grid  = impl::CreateSeamedGrid(64);
+
+    const MeshSimplifierSettings settings{ .AttributeWeights = impl::SIMPLIFIER_ATTRIBUTE_WEIGHTS };
+    const MeshSimplifierSettings unlockedSettings{ .LockBorder = false, .AttributeWeights = impl::SIMPLIFIER_ATTRIBUTE_WEIGHTS };
+
+    std::vector<uint32_t> seamVertices, borderVertices, cornerVertices;
+
+    for (uint32_t vertex = 0; vertex < grid.GetNumVertices(); vertex++) {
+        const auto& attributes = grid.Vertices[vertex].Attributes;
+
+        const bool isBorderX = attributes[0] == 0.0f || attributes[0] == 1.0f;
+        const bool isBorderY = attributes[1] == 0.0f || attributes[1] == 1.0f;
+
+        if (std::abs(attributes[0] - 0.5f) < 1e-3f) {
+            seamVertices.push_back(vertex);
+        }
+        if (isBorderX || isBorderY) {
+            borderVertices.push_back(vertex);
+        }
+        if (isBorderX && isBorderY) {
+            cornerVertices.push_back(vertex);
+        }
+    }
+
+    //Whether every vertex of the list is referenced by every level of the chain
+    const auto isKept = [](const LodChain& chain, std::span<const uint32_t> vertices) {
+        return std::ranges::all_of(chain.Levels, [&](const MeshLod& lod) {
+            std::vector<uint32_t> referenced(chain.Indices.begin() + lod.FirstIndex, chain.Indices.begin() + lod.FirstIndex + lod.NumIndices);
+            std::ranges::sort(referenced);
+
+            return std::ranges::all_of(vertices, [&](uint32_t vertex) { return std::ranges::binary_search(referenced, vertex); });
+        });
+    };
+
+    for (auto _ : state) {
+        const auto chain = GenerateLodChain(torus.Indices, torus.GetVertexData(), sizeof(impl::MeshVertex), settings);
+
+        if (chain.Levels.size() < impl::MIN_TORUS_LOD_LEVELS) {
+            state.Fail(std::format("Chain has {} levels", chain.Levels.size()));
+        }
+
+        auto previousTriangles = static_cast<uint32_t>(torus.Indices.size() / 3);
+        float previousError    = 0.0f;
+
+        for (size_t level = 0; level < chain.Levels.size(); level++) {
+            const auto& lod      = chain.Levels[level];
+            const auto indices   = std::span(chain.Indices).subspan(lod.FirstIndex, lod.NumIndices);
+            const auto triangles = lod.NumIndices / 3;
+
+            //Centroids and edge midpoints are where a flattened surface leaves the torus the furthest
+            float distance = 0.0f;
+
+            for (size_t corner = 0; corner < indices.size(); corner += 3) {
+                const auto p0 = impl::GetPosition(torus, indices[corner]);
+                const auto p1 = impl::GetPosition(torus, indices[corner + 1]);
+                const auto p2 = impl::GetPosition(torus, indices[corner + 2]);
+
+                distance = std::max({
+                    distance,
+                    impl::GetTorusDistance((p0 + p1 + p2) / 3.0f),
+                    impl::GetTorusDistance((p0 + p1) * 0.5f),
+                    impl::GetTorusDistance((p1 + p2) * 0.5f),
+                    impl::GetTorusDistance((p2 + p0) * 0.5f)
+                });
+            }
+
+            if (static_cast<float>(triangles) > previousTriangles * settings.MaxTriangleRatio || lod.Error < previousError) {
+                state.Fail(std::format("Level {} has {} triangles and an error of {:.2e} after {} and {:.2e}", level, triangles, lod.Error, previousTriangles, previousError));
+            }
+
+            if (distance > lod.Error * impl::MAX_LOD_ERROR_UNDERESTIMATE) {
+                state.Fail(std::format("Level {} reports an error of {:.2e} but is {:.2e} from the torus", level, lod.Error, distance));
+            }
+
+            previousTriangles = triangles;
+            previousError     = lod.Error;
+        }
+
+        const auto lockedChain   = GenerateLodChain(grid.Indices, grid.GetVertexData(), sizeof(impl::MeshVertex), settings);
+        const auto unlockedChain = GenerateLodChain(grid.Indices, grid.GetVertexData(), sizeof(impl::MeshVertex), unlockedSettings);
+
+        if (lockedChain.Levels.empty() || unlockedChain.Levels.empty()) {
+            state.Fail("Grid could not be simplified");
+        }
+
+        if (!isKept(lockedChain, borderVertices) || !isKept(lockedChain, seamVertices)) {
+            state.Fail("Locked border or seam vertices were collapsed");
+        }
+
+        if (!isKept(unlockedChain, cornerVertices) || !isKept(unlockedChain, seamVertices)) {
+            state.Fail("Corners or seam vertices were collapsed with unlocked borders");
+        }
+
+        //With the full detail mesh in front, as the importer hands the levels to the renderer
+        std::vector<MeshLod> levels{ { 0, static_cast<uint32_t>(torus.Indices.size()), 0.0f } };
+        levels.insert(levels.end(), chain.Levels.begin(), chain.Levels.end());
+
+        const auto errorScale = GetLodErrorScale(45.0f, 1080.0f);
+        uint32_t previousLod  = 0;
+
+        for (float distance = 0.0f; distance < 1000.0f; distance = distance * 1.5f + 0.1f) {
+            const auto lod = SelectLod(levels, distance, errorScale, 1.0f);
+
+            if (lod < previousLod) {
+                state.Fail(std::format("Level {} was selected at a distance of {:.1f} after level {}", lod, distance, previousLod));
+            }
+            previousLod = lod;
+        }
+
+        if (SelectLod(levels, 0.0f, errorScale, 1.0f) != 0 || previousLod != levels.size() - 1) {
+            state.Fail("Selection does not span the chain from the full detail mesh to the coarsest level");
+        }
+    }
+}
+CRYSTAL_BENCHMARK(MeshSimplifier_Quality);
+
+//Argument is the number of segments of the torus, every level is generated as the importer does
+static void MeshSimplifier_LodChain(State& state) {
+    const auto mesh = impl::CreateOptimizedTorus(static_cast<uint32_t>(state.Argument()));
+    const MeshSimplifierSettings settings{ .AttributeWeights = impl::SIMPLIFIER_ATTRIBUTE_WEIGHTS };
+
+    for (auto _ : state) {
+        auto chain = GenerateLodChain(mesh.Indices, mesh.GetVertexData(), sizeof(impl::MeshVertex), settings);
+        DoNotOptimize(chain);
+    }
+
+    state.SetItemsPerIteration(mesh.Indices.size() / 3);
+}
+CRYSTAL_BENCHMARK(MeshSimplifier_LodChain, 128, 512);
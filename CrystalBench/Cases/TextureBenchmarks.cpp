@@ -0,0 +1,360 @@
+#include "../Benchmark.h"
+
+#include "Core/InstructionSet/Simd.h"
+#include "Core/Lib/ThreadPool.h"
+#include "Graphics/BlockCompression.h"
+#include "Graphics/MipGenerator.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <format>
+#include <memory>
+#include <vector>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    //Smooth gradients with noise on top, so both flat areas and edges are filtered
+    std::vector<uint8_t> CreateTestImage(uint32_t width, uint32_t height, uint32_t seed = 1) {
+        std::vector<uint8_t> texels(size_t{ width } * height * 4);
+        uint32_t random = seed * 0x9E3779B9u;
+
+        for (uint32_t y = 0; y < height; y++) {
+            for (uint32_t x = 0; x < width; x++) {
+                for (uint32_t channel = 0; channel < 4; channel++) {
+                    random = random * 1664525u + 1013904223u;
+
+                    const auto gradient = (x * (channel + 1) * 255 / std::max(width, 1u) + y * 255 / std::max(height, 1u)) / 2;
+                    texels[(size_t{ y } * width + x) * 4 + channel] = static_cast<uint8_t>(std::min(255u, gradient + (random >> 28)));
+                }
+            }
+        }
+        return texels;
+    }
+
+    struct ImageSize {
+        uint32_t Width;
+        uint32_t Height;
+    };
+
+    //Every combination of odd and even sizes, including rows and columns of a single texel
+    constexpr std::array<ImageSize, 8> TEST_SIZES{ {
+        { 64, 64 }, { 65, 64 }, { 64, 33 }, { 127, 65 }, { 1, 37 }, { 63, 1 }, { 5, 3 }, { 1, 1 }
+    } };
+
+    [[nodiscard]] double ConvertToLinear(double value) noexcept {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    [[nodiscard]] double ConvertToSRGB(double value) noexcept {
+        return value < 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    struct ReferenceImage {
+        uint32_t Width;
+        uint32_t Height;
+        std::vector<double> Texels;
+
+        //SampleLevel with a linear clamp sampler
+        [[nodiscard]] double Sample(double u, double v, uint32_t channel) const noexcept {
+            const auto x = u * Width - 0.5;
+            const auto y = v * Height - 0.5;
+
+            const auto x0 = std::floor(x);
+            const auto y0 = std::floor(y);
+            const auto fx = x - x0;
+            const auto fy = y - y0;
+
+            const auto load = [&](double tx, double ty) {
+                const auto cx = static_cast<uint32_t>(std::clamp(tx, 0.0, Width - 1.0));
+                const auto cy = static_cast<uint32_t>(std::clamp(ty, 0.0, Height - 1.0));
+                return Texels[(size_t{ cy } * Width + cx) * 4 + channel];
+            };
+
+            return (load(x0, y0) * (1.0 - fx) + load(x0 + 1, y0) * fx) * (1.0 - fy)
+                + (load(x0, y0 + 1) * (1.0 - fx) + load(x0 + 1, y0 + 1) * fx) * fy;
+        }
+    };
+
+    //Straight port of ComputeMipMaps.hlsl for a single destination texel, in double precision
+    [[nodiscard]] double SampleLikeShader(const ReferenceImage& source, uint32_t x, uint32_t y, uint32_t dstWidth, uint32_t dstHeight, uint32_t channel) {
+        const auto texelU = 1.0 / dstWidth;
+        const auto texelV = 1.0 / dstHeight;
+
+        switch ((source.Height & 1) << 1 | (source.Width & 1)) {
+        case 0:
+            return source.Sample(texelU * (x + 0.5), texelV * (y + 0.5), channel);
+        case 1:
+            return 0.5 * (source.Sample(texelU * (x + 0.25), texelV * (y + 0.5), channel)
+                + source.Sample(texelU * (x + 0.75), texelV * (y + 0.5), channel));
+        case 2:
+            return 0.5 * (source.Sample(texelU * (x + 0.5), texelV * (y + 0.25), channel)
+                + source.Sample(texelU * (x + 0.5), texelV * (y + 0.75), channel));
+        default:
+            return 0.25 * (source.Sample(texelU * (x + 0.25), texelV * (y + 0.25), channel)
+                + source.Sample(texelU * (x + 0.75), texelV * (y + 0.25), channel)
+                + source.Sample(texelU * (x + 0.25), texelV * (y + 0.75), channel)
+                + source.Sample(texelU * (x + 0.75), texelV * (y + 0.75), channel));
+        }
+    }
+
+    //Largest difference of any stored texel to the shader port, which carries the unquantized mips forward as well
+    [[nodiscard]] int32_t CompareWithShader(const MipChain& mipChain, std::span<const uint8_t> texels, bool isSRGB) {
+        const auto& top = mipChain.Levels.front();
+
+        ReferenceImage source{ top.Width, top.Height, std::vector<double>(texels.size()) };
+
+        for (size_t i = 0; i < texels.size(); i++) {
+            source.Texels[i] = isSRGB && i % 4 != 3 ? ConvertToLinear(texels[i] / 255.0) : texels[i] / 255.0;
+        }
+
+        int32_t maxDifference = 0;
+
+        for (uint32_t mip = 1; mip < mipChain.Levels.size(); mip++) {
+            const auto& level  = mipChain.Levels[mip];
+            const auto encoded = mipChain.GetTexels(mip);
+
+            ReferenceImage destination{ level.Width, level.Height, std::vector<double>(size_t{ level.Width } * level.Height * 4) };
+
+            for (uint32_t y = 0; y < level.Height; y++) {
+                for (uint32_t x = 0; x < level.Width; x++) {
+                    for (uint32_t channel = 0; channel < 4; channel++) {
+                        const auto index = (size_t{ y } * level.Width + x) * 4 + channel;
+                        const auto value = SampleLikeShader(source, x, y, level.Width, level.Height, channel);
+
+                        destination.Texels[index] = value;
+
+                        const auto stored   = std::clamp(isSRGB && channel != 3 ? ConvertToSRGB(value) : value, 0.0, 1.0);
+                        const auto expected = static_cast<int32_t>(std::lround(stored * 255.0));
+
+                        maxDifference = std::max(maxDifference, std::abs(expected - static_cast<int32_t>(encoded[index])));
+                    }
+                }
+            }
+            source = std::move(destination);
+        }
+        return maxDifference;
+    }
+}
+
+//The box filter has to reproduce the compute shader for every combination of odd and even sizes,
+//off by at most one step from rounding the float math differently
+static void MipGenerator_MatchesShader(State& state) {
+    for (auto _ : state) {
+        for (const auto [width, height] : impl::TEST_SIZES) {
+            const auto texels = impl::CreateTestImage(width, height);
+
+            for (const bool isSRGB : { false, true }) {
+                const auto mipChain      = GenerateMips(texels, width, height, { .IsSRGB = isSRGB });
+                const auto maxDifference = impl::CompareWithShader(mipChain, texels, isSRGB);
+
+                if (mipChain.Levels.size() != GetNumMips(width, height) || maxDifference > 1) [[unlikely]] {
+                    state.Fail(std::format("{}x{} {} is off by {} from the shader", width, height, isSRGB ? "sRGB" : "UNORM", maxDifference));
+                }
+            }
+        }
+    }
+}
+CRYSTAL_BENCHMARK(MipGenerator_MatchesShader);
+
+//The vectorized path has to produce exactly the bytes of the scalar one, with and without threads
+static void MipGenerator_MatchesScalar(State& state) {
+    if (!HasAvx2()) {
+        state.Fail("AVX2 is not supported, the vectorized path cannot be checked");
+        return;
+    }
+
+    ThreadPool threadPool(3);
+
+    for (auto _ : state) {
+        for (const auto [width, height] : impl::TEST_SIZES) {
+            const auto texels = impl::CreateTestImage(width, height, width * 31 + height);
+
+            for (const auto filter : { MipFilter::Box, MipFilter::Kaiser }) {
+                for (const bool isSRGB : { false, true }) {
+                    const MipGeneratorSettings scalar{ .Filter = filter, .IsSRGB = isSRGB, .AllowSimd = false };
+                    const MipGeneratorSettings simd{ .Filter = filter, .IsSRGB = isSRGB, .AllowSimd = true };
+
+                    const auto expected = GenerateMips(texels, width, height, scalar);
+
+                    if (GenerateMips(texels, width, height, simd).Data != expected.Data || GenerateMips(texels, width, height, simd, &threadPool).Data != expected.Data) [[unlikely]] {
+                        state.Fail(std::format("{}x{} {} {} differs from the scalar path", width, height, filter == MipFilter::Box ? "box" : "Kaiser", isSRGB ? "sRGB" : "UNORM"));
+                    }
+                }
+            }
+        }
+    }
+}
+CRYSTAL_BENCHMARK(MipGenerator_MatchesScalar);
+
+namespace impl {
+    void GenerateMipChain(State& state, const MipGeneratorSettings& settings, uint32_t numThreads = 0) {
+        const auto size   = static_cast<uint32_t>(state.Argument());
+        const auto texels = CreateTestImage(size, size);
+
+        ThreadPool threadPool(numThreads);
+
+        for (auto _ : state) {
+            DoNotOptimize(GenerateMips(texels, size, size, settings, numThreads > 0 ? &threadPool : nullptr));
+        }
+        state.SetBytesPerIteration(texels.size());
+    }
+}
+
+//Argument is the width and height of the sRGB source
+static void MipGenerator_BoxScalar(State& state) {
+    impl::GenerateMipChain(state, { .IsSRGB = true, .AllowSimd = false });
+}
+CRYSTAL_BENCHMARK(MipGenerator_BoxScalar, 256, 2048);
+
+static void MipGenerator_BoxAvx2(State& state) {
+    impl::GenerateMipChain(state, { .IsSRGB = true });
+}
+CRYSTAL_BENCHMARK(MipGenerator_BoxAvx2, 256, 2048);
+
+static void MipGenerator_KaiserAvx2(State& state) {
+    impl::GenerateMipChain(state, { .Filter = MipFilter::Kaiser, .IsSRGB = true });
+}
+CRYSTAL_BENCHMARK(MipGenerator_KaiserAvx2, 256, 2048);
+
+//Rows of a 2048x2048 source split across three workers and the caller
+static void MipGenerator_BoxAvx2Threaded(State& state) {
+    impl::GenerateMipChain(state, { .IsSRGB = true }, 3);
+}
+CRYSTAL_BENCHMARK(MipGenerator_BoxAvx2Threaded, 2048);
+
+namespace impl {
+    struct CompressionCase {
+        BCFormat Format;
+        const char* Name;
+
+        //Lowest PSNR accepted on the test image at the Fast preset
+        double MinPSNR;
+    };
+
+    constexpr std::array<CompressionCase, 5> COMPRESSION_CASES{ {
+        { BCFormat::BC1, "BC1", 37.0 },
+        { BCFormat::BC3, "BC3", 38.0 },
+        { BCFormat::BC4, "BC4", 50.0 },
+        { BCFormat::BC5, "BC5", 50.0 },
+        { BCFormat::BC7, "BC7", 38.0 }
+    } };
+
+    constexpr std::array<BCQuality, 3> QUALITY_PRESETS{ BCQuality::Fast, BCQuality::Normal, BCQuality::High };
+
+    constexpr uint32_t COMPRESSION_EXTENT = 512;
+
+    void EncodeTestImage(State& state, const BCEncoderSettings& settings, uint32_t numThreads = 0) {
+        const auto texels = CreateTestImage(COMPRESSION_EXTENT, COMPRESSION_EXTENT);
+
+        std::unique_ptr<ThreadPool> threadPool;
+
+        if (numThreads > 0) {
+            threadPool = std::make_unique<ThreadPool>(numThreads);
+        }
+
+        for (auto _ : state) {
+            auto blocks = EncodeBlocks(texels, COMPRESSION_EXTENT, COMPRESSION_EXTENT, settings, threadPool.get());
+            DoNotOptimize(blocks.data());
+        }
+
+        state.SetItemsPerIteration((COMPRESSION_EXTENT / 4) * (COMPRESSION_EXTENT / 4));
+        state.SetBytesPerIteration(texels.size());
+    }
+}
+
+//Every format and preset has to reach its PSNR, improve on the preset below and produce the same blocks on every path
+static void BlockCompression_Quality(State& state) {
+    const bool hasAvx2 = HasAvx2();
+    ThreadPool threadPool(2);
+
+    for (auto _ : state) {
+        for (const auto& [format, name, minPSNR] : impl::COMPRESSION_CASES) {
+            double previousPSNR = 0.0;
+
+            for (const auto quality : impl::QUALITY_PRESETS) {
+                const BCEncoderSettings settings{ .Format = format, .Quality = quality, .AllowSimd = false };
+
+                for (const auto& [width, height] : impl::TEST_SIZES) {
+                    const auto texels = impl::CreateTestImage(width, height, width * 31 + height);
+                    const auto scalar = EncodeBlocks(texels, width, height, settings);
+
+                    if (hasAvx2 && EncodeBlocks(texels, width, height, { format, quality, true }) != scalar) {
+                        state.Fail(std::format("{} AVX2 blocks differ from scalar at {}x{}", name, width, height));
+                    }
+
+                    if (EncodeBlocks(texels, width, height, settings, &threadPool) != scalar) {
+                        state.Fail(std::format("{} threaded blocks differ at {}x{}", name, width, height));
+                    }
+                }
+
+                constexpr uint32_t EXTENT = 128;
+
+                const auto texels  = impl::CreateTestImage(EXTENT, EXTENT);
+                const auto decoded = DecodeBlocks(EncodeBlocks(texels, EXTENT, EXTENT, settings, &threadPool), EXTENT, EXTENT, format);
+                const auto psnr    = ComputePSNR(texels, decoded, format);
+
+                if (psnr < minPSNR || psnr < previousPSNR) {
+                    state.Fail(std::format("{} preset {} reaches {:.2f} dB, expected at least {:.2f} dB", name, static_cast<int>(quality), psnr, std::max(minPSNR, previousPSNR)));
+                }
+                previousPSNR = psnr;
+            }
+        }
+
+        //A single colour has to come back exactly where the format can represent it
+        std::vector<uint8_t> solid(16 * 16 * 4);
+
+        for (size_t texel = 0; texel < solid.size(); texel += 4) {
+            solid[texel + 0] = 200;
+            solid[texel + 1] = 17;
+            solid[texel + 2] = 96;
+            solid[texel + 3] = 255;
+        }
+
+        for (const auto format : { BCFormat::BC4, BCFormat::BC5 }) {
+            if (ComputePSNR(solid, DecodeBlocks(EncodeBlocks(solid, 16, 16, { .Format = format }), 16, 16, format), format) != INFINITY) {
+                state.Fail("Single colour block was not encoded exactly");
+            }
+        }
+    }
+}
+CRYSTAL_BENCHMARK(BlockCompression_Quality);
+
+//Argument is the preset: 0 Fast, 1 Normal, 2 High
+static void BlockCompression_BC1(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC1, static_cast<BCQuality>(state.Argument()) });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC1, 0, 1, 2);
+
+static void BlockCompression_BC3(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC3, static_cast<BCQuality>(state.Argument()) });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC3, 0, 1, 2);
+
+static void BlockCompression_BC4(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC4, static_cast<BCQuality>(state.Argument()) });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC4, 0, 1, 2);
+
+static void BlockCompression_BC5(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC5, static_cast<BCQuality>(state.Argument()) });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC5, 0, 1, 2);
+
+static void BlockCompression_BC7(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC7, static_cast<BCQuality>(state.Argument()) });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC7, 0, 1, 2);
+
+static void BlockCompression_BC7Scalar(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC7, static_cast<BCQuality>(state.Argument()), false });
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC7Scalar, 0, 1, 2);
+
+static void BlockCompression_BC7Threaded(State& state) {
+    impl::EncodeTestImage(state, { BCFormat::BC7, BCQuality::Normal }, ThreadPool::GetDefaultThreadCount());
+}
+CRYSTAL_BENCHMARK(BlockCompression_BC7Threaded);
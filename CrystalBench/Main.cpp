@@ -0,0 +1,182 @@
+#include "Benchmark.h"
+#include "Report.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <format>
+#include <string_view>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    struct Arguments {
+        Options RunOptions;
+        std::string JsonPath;
+        std::string BaselinePath;
+        double Threshold{ 0.05 };
+        bool List{ false };
+    };
+
+    void PrintUsage() {
+        std::fputs(
+            "Usage: CrystalBench [options]\n"
+            "  --filter <text>       Only run cases whose name contains <text>\n"
+            "  --repetitions <n>     Measured repetitions per case (default 10)\n"
+            "  --warmup <n>          Unmeasured warm-up repetitions per case (default 2)\n"
+            "  --min-time <ms>       Minimum duration of one repetition (default 20)\n"
+            "  --perf                Read hardware counters per case (Linux perf_event)\n"
+            "  --json <path>         Write the results as JSON\n"
+            "  --baseline <path>     Compare against a JSON report, exits with 1 on regressions\n"
+            "  --threshold <ratio>   Allowed slowdown before a case counts as regressed (default 0.05)\n"
+            "  --list                List all cases\n",
+            stdout);
+    }
+
+    template<class T>
+    bool ParseNumber(std::string_view text, T& value) {
+        const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+    }
+
+    std::optional<Arguments> ParseArguments(int argc, char** argv) {
+        Arguments arguments;
+
+        for (int i = 1; i < argc; i++) {
+            const std::string_view argument = argv[i];
+
+            const auto next = [&]() -> std::optional<std::string_view> {
+                if (i + 1 >= argc) {
+                    std::fputs(std::format("Missing value for {}\n", argument).c_str(), stderr);
+                    return {};
+                }
+                return argv[++i];
+            };
+
+            bool valid = true;
+
+            if (argument == "--filter") {
+                const auto value = next();
+                valid            = value.has_value();
+                arguments.RunOptions.Filter = value.value_or("");
+            }
+            else if (argument == "--repetitions") {
+                const auto value = next();
+                valid            = value && ParseNumber(*value, arguments.RunOptions.Repetitions) && arguments.RunOptions.Repetitions > 0;
+            }
+            else if (argument == "--warmup") {
+                const auto value = next();
+                valid            = value && ParseNumber(*value, arguments.RunOptions.WarmupRepetitions);
+            }
+            else if (argument == "--min-time") {
+                const auto value = next();
+                int64_t milliseconds{};
+                valid = value && ParseNumber(*value, milliseconds) && milliseconds > 0;
+                arguments.RunOptions.MinRepetitionTime = std::chrono::milliseconds(milliseconds);
+            }
+            else if (argument == "--threshold") {
+                const auto value = next();
+                valid            = value && ParseNumber(*value, arguments.Threshold) && arguments.Threshold >= 0.0;
+            }
+            else if (argument == "--json") {
+                const auto value = next();
+                valid            = value.has_value();
+                arguments.JsonPath = value.value_or("");
+            }
+            else if (argument == "--baseline") {
+                const auto value = next();
+                valid            = value.has_value();
+                arguments.BaselinePath = value.value_or("");
+            }
+            else if (argument == "--perf") {
+                arguments.RunOptions.ReadCounters = true;
+            }
+            else if (argument == "--list") {
+                arguments.List = true;
+            }
+            else if (argument == "--help" || argument == "-h") {
+                PrintUsage();
+                std::exit(0);
+            }
+            else {
+                std::fputs(std::format("Unknown argument {}\n", argument).c_str(), stderr);
+                valid = false;
+            }
+
+            if (!valid) {
+                PrintUsage();
+                return {};
+            }
+        }
+        return arguments;
+    }
+}
+
+int main(int argc, char** argv) {
+    const auto arguments = impl::ParseArguments(argc, argv);
+
+    if (!arguments) {
+        return 2;
+    }
+
+    if (arguments->List) {
+        for (const auto& benchmark : GetBenchmarks()) {
+            std::fputs(std::format("{}\n", benchmark.Name).c_str(), stdout);
+        }
+        return 0;
+    }
+
+    if (arguments->RunOptions.ReadCounters) {
+        PerfCounters::SetEnabled(true);
+
+        if (const auto& counters = PerfCounters::ForCurrentThread(); !counters.IsAvailable()) {
+            std::fputs(std::format("Hardware counters unavailable: {}\n", counters.GetUnavailableReason()).c_str(), stderr);
+        }
+    }
+
+    std::optional<Json::Value> baseline;
+
+    //Read the baseline up front so a bad path does not only show up after the whole run
+    if (!arguments->BaselinePath.empty()) {
+        baseline = ReadJsonReport(arguments->BaselinePath);
+
+        if (!baseline) {
+            std::fputs(std::format("Failed to read baseline {}\n", arguments->BaselinePath).c_str(), stderr);
+            return 2;
+        }
+    }
+
+    std::fputs(std::format("{}\n", CreateCpuReportHeader()).c_str(), stdout);
+
+    const auto results = RunBenchmarks(arguments->RunOptions, [](const Result& result) {
+        std::fputs(std::format("{}\n", FormatResult(result)).c_str(), stdout);
+        std::fflush(stdout);
+    });
+
+    bool failed = std::ranges::any_of(results, &Result::Failed);
+
+    if (!arguments->JsonPath.empty() && !WriteJsonReport(arguments->JsonPath, CreateJsonReport(results, arguments->RunOptions))) {
+        std::fputs(std::format("Failed to write {}\n", arguments->JsonPath).c_str(), stderr);
+        failed = true;
+    }
+
+    if (baseline) {
+        const auto comparisons = CompareToBaseline(results, *baseline, arguments->Threshold);
+
+        std::fputs(std::format("\nCompared to {} (threshold {:.1f}%)\n", arguments->BaselinePath, arguments->Threshold * 100.0).c_str(), stdout);
+
+        uint32_t regressions = 0;
+
+        for (const auto& comparison : comparisons) {
+            std::fputs(std::format("{}\n", FormatComparison(comparison)).c_str(), stdout);
+            regressions += comparison.Regressed ? 1 : 0;
+        }
+
+        if (regressions > 0) {
+            std::fputs(std::format("{} case(s) regressed\n", regressions).c_str(), stdout);
+            failed = true;
+        }
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,245 @@
+#include "Report.h"
+
+#include "Core/InstructionSet/CpuInfo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+using namespace Crystal;
+using namespace Crystal::Bench;
+
+namespace impl {
+    constexpr int REPORT_VERSION = 1;
+
+    Json::Value CreateContext(const Options& options) {
+        const CpuInfo cpuInfo;
+
+        auto context = Json::Value::MakeObject();
+
+        context.Set("cpu", cpuInfo.Info.BrandString);
+        context.Set("vendor", cpuInfo.Info.Vendor);
+        context.Set("architecture", cpuInfo.Info.Architecture);
+        context.Set("cores", cpuInfo.Info.NumCores);
+        context.Set("logicalProcessors", cpuInfo.Info.NumLogicalProcessors);
+        context.Set("timestamp", std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+        context.Set("repetitions", options.Repetitions);
+        context.Set("warmupRepetitions", options.WarmupRepetitions);
+        context.Set("minRepetitionTimeMs", options.MinRepetitionTime.count());
+#ifdef NDEBUG
+        context.Set("buildType", "Release");
+#else
+        context.Set("buildType", "Debug");
+#endif
+        return context;
+    }
+
+    std::string FormatTime(double nanoseconds) {
+        if (nanoseconds >= 1e6) {
+            return std::format("{:.3f} ms", nanoseconds / 1e6);
+        }
+        if (nanoseconds >= 1e3) {
+            return std::format("{:.3f} us", nanoseconds / 1e3);
+        }
+        return std::format("{:.2f} ns", nanoseconds);
+    }
+
+    std::string FormatRate(double itemsPerSecond) {
+        if (itemsPerSecond >= 1e9) {
+            return std::format("{:.2f}G/s", itemsPerSecond / 1e9);
+        }
+        if (itemsPerSecond >= 1e6) {
+            return std::format("{:.2f}M/s", itemsPerSecond / 1e6);
+        }
+        if (itemsPerSecond >= 1e3) {
+            return std::format("{:.2f}k/s", itemsPerSecond / 1e3);
+        }
+        return std::format("{:.2f}/s", itemsPerSecond);
+    }
+}
+
+Json::Value Bench::CreateJsonReport(const std::vector<Result>& results, const Options& options) {
+    auto report     = Json::Value::MakeObject();
+    auto benchmarks = Json::Value::MakeArray();
+
+    for (const auto& result : results) {
+        auto entry = Json::Value::MakeObject();
+
+        entry.Set("name", result.Name);
+
+        if (result.Failed) {
+            entry.Set("error", result.Error);
+            benchmarks.PushBack(std::move(entry));
+            continue;
+        }
+
+        entry.Set("iterations", result.Iterations);
+        entry.Set("medianNs", result.Median);
+        entry.Set("madNs", result.MedianAbsoluteDeviation);
+        entry.Set("minNs", result.Min);
+        entry.Set("meanNs", result.Mean);
+
+        if (result.ItemsPerSecond > 0.0) {
+            entry.Set("itemsPerSecond", result.ItemsPerSecond);
+        }
+        if (result.BytesPerSecond > 0.0) {
+            entry.Set("bytesPerSecond", result.BytesPerSecond);
+        }
+
+        auto samples = Json::Value::MakeArray();
+        for (const auto sample : result.Samples) {
+            samples.PushBack(sample);
+        }
+        entry.Set("samplesNs", std::move(samples));
+
+        if (result.Counters) {
+            auto counters = Json::Value::MakeObject();
+
+            for (uint32_t i = 0; i < PerfCounterValues::NUM_COUNTERS; i++) {
+                const auto counter = static_cast<PerfCounter>(i);
+
+                if (result.Counters->Has(counter)) {
+                    counters.Set(ToString(counter), (*result.Counters)[counter]);
+                }
+            }
+            counters.Set("ipc", result.Counters->InstructionsPerCycle());
+            entry.Set("counters", std::move(counters));
+        }
+
+        benchmarks.PushBack(std::move(entry));
+    }
+
+    report.Set("version", impl::REPORT_VERSION);
+    report.Set("context", impl::CreateContext(options));
+    report.Set("benchmarks", std::move(benchmarks));
+
+    return report;
+}
+
+bool Bench::WriteJsonReport(std::string_view path, const Json::Value& report) {
+    std::ofstream file{ std::string(path), std::ios::binary | std::ios::trunc };
+
+    if (!file) {
+        return false;
+    }
+
+    file << Json::Serialize(report) << '\n';
+    return static_cast<bool>(file);
+}
+
+std::optional<Json::Value> Bench::ReadJsonReport(std::string_view path) {
+    std::ifstream file{ std::string(path), std::ios::binary };
+
+    if (!file) {
+        return {};
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    Json::ParseError error;
+    auto report = Json::Parse(buffer.str(), &error);
+
+    if (!report) {
+        std::fputs(std::format("Failed to parse {} at offset {}: {}\n", path, error.Offset, error.Message).c_str(), stderr);
+    }
+    return report;
+}
+
+std::vector<Comparison> Bench::CompareToBaseline(const std::vector<Result>& results, const Json::Value& baseline, double threshold) {
+    std::vector<Comparison> comparisons;
+
+    const auto* baselineBenchmarks = baseline.Find("benchmarks");
+
+    if (!baselineBenchmarks || !baselineBenchmarks->IsArray()) {
+        return comparisons;
+    }
+
+    for (const auto& result : results) {
+        if (result.Failed) {
+            continue;
+        }
+
+        const auto& entries = baselineBenchmarks->AsArray();
+        const auto iter     = std::ranges::find_if(entries, [&result](const Json::Value& entry) {
+            const auto* name = entry.Find("name");
+            return name && name->AsString() == result.Name;
+        });
+
+        if (iter == entries.end() || !iter->Find("medianNs")) {
+            continue;
+        }
+
+        Comparison comparison{
+            .Name           = result.Name,
+            .BaselineMedian = iter->Find("medianNs")->AsNumber(),
+            .Median         = result.Median
+        };
+
+        if (comparison.BaselineMedian <= 0.0) {
+            continue;
+        }
+
+        const auto* baselineMad = iter->Find("madNs");
+        const auto noise        = 3.0 * std::max(result.MedianAbsoluteDeviation, baselineMad ? baselineMad->AsNumber() : 0.0);
+        const auto delta        = comparison.Median - comparison.BaselineMedian;
+
+        comparison.Change    = delta / comparison.BaselineMedian;
+        comparison.Regressed = comparison.Change > threshold && delta > noise;
+        comparison.Improved  = comparison.Change < -threshold && -delta > noise;
+
+        comparisons.emplace_back(std::move(comparison));
+    }
+    return comparisons;
+}
+
+std::string Bench::FormatResult(const Result& result) {
+    if (result.Failed) {
+        return std::format("{:<48} FAILED: {}", result.Name, result.Error);
+    }
+
+    const auto madPercent = result.Median > 0.0 ? result.MedianAbsoluteDeviation / result.Median * 100.0 : 0.0;
+
+    auto line = std::format("{:<48} {:>14} +-{:>5.1f}%  min {:>14}  {:>12} iters",
+        result.Name,
+        impl::FormatTime(result.Median),
+        madPercent,
+        impl::FormatTime(result.Min),
+        result.Iterations);
+
+    if (result.ItemsPerSecond > 0.0) {
+        line += std::format("  {:>10}", impl::FormatRate(result.ItemsPerSecond));
+    }
+
+    if (result.Counters) {
+        const auto& counters = *result.Counters;
+
+        if (counters.Has(PerfCounter::Cycles)) {
+            line += std::format("  {} cyc", counters[PerfCounter::Cycles]);
+        }
+        if (counters.Has(PerfCounter::Instructions)) {
+            line += std::format("  {:.2f} ipc", counters.InstructionsPerCycle());
+        }
+        if (counters.Has(PerfCounter::CacheMisses)) {
+            line += std::format("  {} llc-miss", counters[PerfCounter::CacheMisses]);
+        }
+        if (counters.Has(PerfCounter::BranchMisses)) {
+            line += std::format("  {} br-miss", counters[PerfCounter::BranchMisses]);
+        }
+    }
+    return line;
+}
+
+std::string Bench::FormatComparison(const Comparison& comparison) {
+    const auto status = comparison.Regressed ? "REGRESSED" : comparison.Improved ? "improved" : "";
+
+    return std::format("{:<48} {:>14} -> {:>14}  {:>+7.1f}%  {}",
+        comparison.Name,
+        impl::FormatTime(comparison.BaselineMedian),
+        impl::FormatTime(comparison.Median),
+        comparison.Change * 100.0,
+        status);
+}
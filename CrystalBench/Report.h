@@ -0,0 +1,34 @@
+#pragma once
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Benchmark.h"
+#include "Core/Lib/Json.h"
+
+namespace Crystal::Bench {
+    struct Comparison {
+        std::string Name;
+        double BaselineMedian{};
+        double Median{};
+
+        //Relative change of the median, positive means slower
+        double Change{};
+        bool Regressed{};
+        bool Improved{};
+    };
+
+    //Serializes the results together with the machine they were measured on
+    [[nodiscard]] Json::Value CreateJsonReport(const std::vector<Result>& results, const Options& options);
+
+    [[nodiscard]] bool WriteJsonReport(std::string_view path, const Json::Value& report);
+    [[nodiscard]] std::optional<Json::Value> ReadJsonReport(std::string_view path);
+
+    //A case only counts as regressed when its median is slower than the threshold allows
+    //and the difference is larger than the noise of both runs, measured as three median absolute deviations
+    [[nodiscard]] std::vector<Comparison> CompareToBaseline(const std::vector<Result>& results, const Json::Value& baseline, double threshold);
+
+    [[nodiscard]] std::string FormatResult(const Result& result);
+    [[nodiscard]] std::string FormatComparison(const Comparison& comparison);
+}
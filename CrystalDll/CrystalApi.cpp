@@ -3,6 +3,7 @@
 #include "Core/Application.h"
 #include "Platform/Windows/MessageBox.h"
 #include "Core/Exceptions/CrystalException.h"
+#include "Core/Time/FrameStatistics.h"
 #include <vector>
 
 using namespace Crystal;
@@ -18,6 +19,23 @@ struct {
 	const char* Architecture;
 } cpuInfo;
 
+struct FrameStageStatistics_t {
+	const char* Name;
+	uint64_t Count;
+	double Mean;
+	uint64_t P50;
+	uint64_t P95;
+	uint64_t P99;
+	uint64_t Max;
+};
+
+struct {
+	uint64_t FrameCount;
+	uint32_t NumSpikes;
+	uint32_t NumStages;
+	FrameStageStatistics_t Stages[FrameStatistics::MAX_STAGES];
+} frameStatistics;
+
 
 CRYSTAL_API void create_render_surface(HWND parent, const uint32_t width, const uint32_t height) noexcept {
 	try
@@ -64,6 +82,31 @@ CRYSTAL_API void* get_cpu_information() noexcept {
 	return &cpuInfo;
 }
 
+CRYSTAL_API void* get_frame_statistics() noexcept {
+	auto& statistics = FrameStatistics::Get();
+
+	//Stage names live as long as the statistics service, so handing out raw pointers is fine
+	frameStatistics.FrameCount = statistics.GetFrameCount();
+	frameStatistics.NumSpikes  = static_cast<uint32_t>(statistics.GetSpikes().size());
+	frameStatistics.NumStages  = statistics.GetStageCount();
+
+	for (uint32_t i = 0; i < frameStatistics.NumStages; i++) {
+		const auto stage = statistics.GetStageStatistics(i);
+
+		frameStatistics.Stages[i] = FrameStageStatistics_t{
+			.Name  = stage->Name.data(),
+			.Count = stage->Count,
+			.Mean  = stage->Mean,
+			.P50   = stage->P50,
+			.P95   = stage->P95,
+			.P99   = stage->P99,
+			.Max   = stage->Max
+		};
+	}
+
+	return &frameStatistics;
+}
+
 CRYSTAL_API void message_proc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept {
 	//application->GetWindow().MsgProc(hWnd, msg, wParam, lParam);
 }
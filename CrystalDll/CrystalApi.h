@@ -17,4 +17,5 @@ CRYSTAL_API void create_render_surface(HWND parent, uint32_t width, uint32_t hei
 CRYSTAL_API void destroy_render_surface() noexcept;
 CRYSTAL_API HWND get_window_handle() noexcept;
 CRYSTAL_API void* get_cpu_information() noexcept;
+CRYSTAL_API void* get_frame_statistics() noexcept;
 CRYSTAL_API void message_proc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) noexcept;
\ No newline at end of file
@@ -26,6 +26,9 @@ namespace CrystalEditor.API
 
         [DllImport(path)]
         private static extern IntPtr get_cpu_information();
+
+        [DllImport(path)]
+        private static extern IntPtr get_frame_statistics();
         #endregion
     }
 }
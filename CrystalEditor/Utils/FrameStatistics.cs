@@ -0,0 +1,82 @@
+﻿using CrystalEditor.API;
+using System;
+using System.Collections.Generic;
+using System.Reflection;
+using System.Runtime.InteropServices;
+
+namespace CrystalEditor.Utils
+{
+    public class FrameStageStatistics
+    {
+        public string Name { get; init; }
+        public ulong Count { get; init; }
+        public double Mean { get; init; }
+        public ulong P50 { get; init; }
+        public ulong P95 { get; init; }
+        public ulong P99 { get; init; }
+        public ulong Max { get; init; }
+    }
+
+    public class FrameStatistics
+    {
+        //Must match FrameStatistics::MAX_STAGES on the engine side
+        private const int MaxStages = 16;
+
+#pragma warning disable 0649
+        private struct FrameStageStatistics_t
+        {
+            public string Name;
+            public ulong Count;
+            public double Mean;
+            public ulong P50;
+            public ulong P95;
+            public ulong P99;
+            public ulong Max;
+        }
+
+        private struct FrameStatistics_t
+        {
+            public ulong FrameCount;
+            public uint NumSpikes;
+            public uint NumStages;
+            [MarshalAs(UnmanagedType.ByValArray, SizeConst = MaxStages)]
+            public FrameStageStatistics_t[] Stages;
+        }
+#pragma warning restore 0649
+
+        private readonly List<FrameStageStatistics> stages = new();
+
+        public ulong FrameCount { get; }
+        public uint NumSpikes { get; }
+        public IReadOnlyList<FrameStageStatistics> Stages => stages;
+
+        public FrameStatistics()
+        {
+            const BindingFlags bindingFlags = BindingFlags.NonPublic | BindingFlags.Static;
+            const string methodName = "get_frame_statistics";
+
+            //Same deal as CpuInfo, a snapshot is only obtainable by creating an instance of this class.
+            var ptr = (IntPtr)typeof(EngineApi).GetMethod(methodName, bindingFlags).Invoke(null, null);
+            var frameStatistics = Marshal.PtrToStructure<FrameStatistics_t>(ptr);
+
+            FrameCount = frameStatistics.FrameCount;
+            NumSpikes = frameStatistics.NumSpikes;
+
+            for (int i = 0; i < frameStatistics.NumStages; i++)
+            {
+                var stage = frameStatistics.Stages[i];
+
+                stages.Add(new FrameStageStatistics
+                {
+                    Name = stage.Name,
+                    Count = stage.Count,
+                    Mean = stage.Mean,
+                    P50 = stage.P50,
+                    P95 = stage.P95,
+                    P99 = stage.P99,
+                    Max = stage.Max
+                });
+            }
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#include "Core/FileSystem/PakFile.h"
+#include "Core/Lib/ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using namespace Crystal;
+
+namespace impl {
+    struct Arguments {
+        std::string InputDirectory;
+        std::string OutputPath;
+        uint32_t BlockSize{ PakFormat::DEFAULT_BLOCK_SIZE };
+        bool Compress{ true };
+    };
+
+    void PrintUsage() {
+        std::fputs(
+            "Usage: CrystalPak <input directory> <output pak> [options]\n"
+            "  --block-size <KiB>    Size of the independently decoded blocks (default 256)\n"
+            "  --no-compression      Store every file uncompressed\n",
+            stdout);
+    }
+
+    std::optional<Arguments> ParseArguments(int argc, char** argv) {
+        Arguments arguments;
+        std::vector<std::string_view> positional;
+
+        for (int i = 1; i < argc; i++) {
+            const std::string_view argument = argv[i];
+
+            bool valid = true;
+
+            if (argument == "--block-size") {
+                uint32_t kiloBytes{};
+                const std::string_view value = i + 1 < argc ? argv[++i] : "";
+                const auto result = std::from_chars(value.data(), value.data() + value.size(), kiloBytes);
+
+                valid = result.ec == std::errc{} && result.ptr == value.data() + value.size() && kiloBytes > 0 && kiloBytes <= 1u << 20;
+                arguments.BlockSize = kiloBytes * 1024;
+            }
+            else if (argument == "--no-compression") {
+                arguments.Compress = false;
+            }
+            else if (argument == "--help" || argument == "-h") {
+                PrintUsage();
+                std::exit(0);
+            }
+            else if (argument.starts_with("--")) {
+                std::fputs(std::format("Unknown argument {}\n", argument).c_str(), stderr);
+                valid = false;
+            }
+            else {
+                positional.push_back(argument);
+            }
+
+            if (!valid) {
+                PrintUsage();
+                return {};
+            }
+        }
+
+        if (positional.size() != 2) {
+            PrintUsage();
+            return {};
+        }
+
+        arguments.InputDirectory = positional[0];
+        arguments.OutputPath     = positional[1];
+        return arguments;
+    }
+}
+
+int main(int argc, char** argv) {
+    const auto arguments = impl::ParseArguments(argc, argv);
+
+    if (!arguments) {
+        return 2;
+    }
+
+    std::error_code error;
+    std::vector<std::filesystem::path> files;
+
+    for (std::filesystem::recursive_directory_iterator it(arguments->InputDirectory, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file(error)) {
+            files.push_back(it->path());
+        }
+    }
+
+    if (error) {
+        std::fputs(std::format("Failed to read {}: {}\n", arguments->InputDirectory, error.message()).c_str(), stderr);
+        return 1;
+    }
+
+    //A pak inside the input directory would otherwise end up in itself when it is rebuilt
+    const auto outputPath = std::filesystem::weakly_canonical(arguments->OutputPath, error);
+    std::erase_if(files, [&](const std::filesystem::path& file) { return std::filesystem::weakly_canonical(file, error) == outputPath; });
+
+    PakWriter writer(arguments->BlockSize);
+
+    for (const auto& file : files) {
+        const auto path = std::filesystem::relative(file, arguments->InputDirectory, error).generic_string();
+        writer.AddLooseFile(path, file.string(), arguments->Compress);
+    }
+
+    ThreadPool threadPool;
+    PakWriterStatistics statistics;
+
+    if (!writer.Write(arguments->OutputPath, &threadPool, &statistics)) {
+        std::fputs(std::format("Failed to write {}\n", arguments->OutputPath).c_str(), stderr);
+        return 1;
+    }
+
+    const auto ratio = statistics.Size > 0 ? static_cast<double>(statistics.StoredSize) / static_cast<double>(statistics.Size) : 1.0;
+
+    std::fputs(std::format("{}: {} files, {} compressed, {:.2f} MiB -> {:.2f} MiB ({:.1f}%)\n",
+        arguments->OutputPath, statistics.NumEntries, statistics.NumCompressed,
+        static_cast<double>(statistics.Size) / (1024.0 * 1024.0), static_cast<double>(statistics.StoredSize) / (1024.0 * 1024.0),
+        ratio * 100.0).c_str(), stdout);
+    return 0;
+}
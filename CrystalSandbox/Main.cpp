@@ -6,6 +6,7 @@
 #include "Core/CLI/Console.h"
 #include "Core/Logging/Logger.h"
 #include "Core/Logging/ConsoleSink.h"
+#include "Core/Memory/MemoryTracker.h"
 
 using namespace Crystal;
 int main() {
@@ -15,9 +16,14 @@ int main() {
 
         Logger::AddSink<ConsoleSink>();
 
-         return Application{
-             ApplicationCreateInfo{}
-         }.Run();
+        const auto exitCode = Application{
+            ApplicationCreateInfo{}
+        }.Run();
+
+        if constexpr (MemoryTracker::IsEnabled()) {
+            MemoryTracker::Get().ReportLeaks();
+        }
+        return exitCode;
     }
     catch(const CrystalException e) {
         MessageBox::Show(